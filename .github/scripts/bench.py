@@ -0,0 +1,288 @@
+#!/usr/bin/env python3
+"""
+Build optimized copies of the benchmarked exercises, run their benchmark
+modes and write every number as JSON and CSV, tagged with the git revision
+
+Each exercise is copied to BUILD_DIR/PROFILE and built there, program and
+bench both, so the objects of the normal -O0 builds in the tree are never
+touched. The profiles keep the exercise flags and add:
+  release  -O2
+  native   -O2 -march=native
+  lto      -O2 -flto
+  pgo      -O2, built once with -fprofile-generate, trained on the --quick
+           bench workload, then rebuilt with -fprofile-use (GCC)
+
+Usage: python3 .github/scripts/bench.py [--profile release|native|lto|pgo]
+                                        [--quick] [--targets btc,RPN,...]
+                                        [--cxxflags FLAGS] [--build-only]
+                                        [--out PREFIX] [--history FILE.csv]
+Example: python3 .github/scripts/bench.py --quick --history bench_history.csv
+"""
+
+import argparse
+import csv
+import datetime
+import json
+import os
+import re
+import shutil
+import subprocess
+import sys
+import time
+from pathlib import Path
+
+ROOT = Path(__file__).resolve().parents[2]
+BASE_FLAGS = "-Wall -Wextra -Werror -std=c++98"
+PROFILES = {
+    "release": "-O2",
+    "native": "-O2 -march=native",
+    "lto": "-O2 -flto",
+    "pgo": "-O2",
+}
+
+
+def grouped(pattern, metrics, group_pattern):
+    """Parser for benches that print one result per line under headings:
+    pattern matches a result, its first group being the name and the rest
+    the values of metrics (name, unit) in order; group_pattern matches a
+    heading, whose first group names the results below it"""
+    row = re.compile(pattern)
+    heading = re.compile(group_pattern)
+
+    def parse(text):
+        results = []
+        group = ""
+        for line in text.splitlines():
+            match = row.match(line)
+            if match:
+                name = match.group(1).strip()
+                for (metric, unit), value in zip(metrics, match.groups()[1:]):
+                    results.append((group, name, metric, float(value), unit))
+                continue
+            match = heading.match(line)
+            if match:
+                group = match.group(1).strip()
+        return results
+
+    return parse
+
+
+# Per-line formats of the bench programs
+parse_btc = grouped(
+    r"^(\S.*?)\s{2,}([\d.]+) ms\s+([\d.]+) lines/s\s+(\d+) KiB peak$",
+    [("time", "ms"), ("throughput", "lines/s"), ("peak", "KiB")],
+    r"^-- (.*)$")
+parse_rpn = grouped(
+    r"^(\S.*?)\s{2,}([\d.]+) (?:expr|row)/s\s+([\d.]+) ns/token$",
+    [("throughput", "items/s"), ("per token", "ns")],
+    r"^-- (.*)$")
+parse_rows = grouped(
+    r"^  (\S.*?)\s{2,}([\d.]+) ms\s+([\d.]+) \w+/s$",
+    [("time", "ms"), ("throughput", "items/s")],
+    r"^(\S.*)$")
+parse_scalar = grouped(
+    r"^(char|int|float|double|pseudo|malformed)\s+(\d+)\s+(\d+)$",
+    [("parse", "literals/s"), ("parse+text", "literals/s")],
+    r"^(?!)")
+parse_pmergeme = grouped(
+    r"^(.+?)\s+min\s+([\d.]+) med\s+([\d.]+) p99\s+([\d.]+) us\s+(\d+) cmp\s+(\d+) allocs$",
+    [("min", "us"), ("median", "us"), ("p99", "us"), ("comparisons", "count"),
+     ("allocations", "count")],
+    r"^(?!)")
+
+
+# name, directory, make target, program, arguments, --quick arguments, parser
+TARGETS = [
+    ("btc", "cpp09/ex00", "bench", "btc_bench", [], ["100000", "100000"], parse_btc),
+    ("RPN", "cpp09/ex01", "bench", "RPN_bench", [], ["2000"], parse_rpn),
+    ("PmergeMe", "cpp09/ex02", "bench", "PmergeMe_bench", [], ["3000", "5"], parse_pmergeme),
+    ("Span", "cpp08/ex01", "bench", "span_bench", [], ["5", "20"], parse_rows),
+    ("easyfind", "cpp08/ex00", "bench", "easyfind_bench", [], ["20000", "100"], parse_rows),
+    ("Array", "cpp07/ex02", "bench", "array_bench", [], ["1000000", "10000"], parse_rows),
+    ("ScalarConverter", "cpp06/ex00", "bench", "scalar_bench", [], ["20000"],
+     parse_scalar),
+    ("replace", "cpp01/ex04", "all", "replace", None, None, None),
+]
+
+
+def git(*args):
+    """Output of a git command run at the root of the tree, or "" on failure"""
+    try:
+        result = subprocess.run(["git", "-C", str(ROOT)] + list(args),
+                                capture_output=True, text=True, check=True)
+        return result.stdout.strip()
+    except (subprocess.CalledProcessError, FileNotFoundError):
+        return ""
+
+
+def make(work, make_target, cxxflags):
+    targets = ["all", make_target] if make_target != "all" else ["all"]
+    subprocess.run(["make", "-s"] + targets + [f"CXXFLAGS={BASE_FLAGS} {cxxflags}"],
+                   cwd=work, check=True, stdout=subprocess.DEVNULL)
+
+
+def build(directory, make_target, build_root, cxxflags):
+    """Copy one exercise into the build directory and make it there"""
+    source = ROOT / directory
+    work = build_root / directory
+    if work.exists():
+        shutil.rmtree(work)
+    shutil.copytree(source, work)
+    make(work, make_target, cxxflags)
+    return work
+
+
+def build_pgo(target, build_root, cxxflags):
+    """Build with instrumentation, train on the quick workload, then rebuild
+    from the profile it left; the profile is kept in .pgo in the copy"""
+    name, directory, make_target = target[:3]
+    work = build_root / directory
+    data = work / ".pgo"
+    build(directory, make_target, build_root, f"{cxxflags} -fprofile-generate={data}")
+    print(f"{name}: training", file=sys.stderr)
+    run_target(target, work, True)
+    subprocess.run(["make", "-s", "fclean"], cwd=work, check=True, stdout=subprocess.DEVNULL)
+    # Sources with no run in the training (the program's own main, for one)
+    # have no profile, which is expected
+    make(work, make_target,
+         f"{cxxflags} -fprofile-use={data} -fprofile-correction -Wno-missing-profile")
+    return work
+
+
+def run_target(target, work, quick):
+    """Run one target's benchmark and parse what it prints"""
+    name, directory, make_target, program, full, quick_args, parse = target
+    if parse is None:
+        return run_replace(work, quick)
+    output = subprocess.run(["./" + program] + (quick_args if quick else full),
+                            cwd=work, capture_output=True, text=True, check=True)
+    results = parse(output.stdout)
+    if not results:
+        raise RuntimeError(f"no results found in the output of {program}")
+    return results
+
+
+def run_replace(work, quick):
+    """replace has no bench mode: time the program itself on a generated
+    file, best of 5 runs for each pattern"""
+    megabytes = 8 if quick else 64
+    line = b"the quick brown fox jumps over the lazy dog, said the fox\n"
+    path = work / "bench_input.txt"
+    with open(path, "wb") as out:
+        out.write(line * (megabytes * 1024 * 1024 // len(line)))
+    size = path.stat().st_size
+    results = []
+    for needle, replacement in (("fox", "wolf"), ("the lazy dog", "X")):
+        best = None
+        for _ in range(5):
+            start = time.perf_counter()
+            subprocess.run(["./replace", path.name, needle, replacement], cwd=work,
+                           check=True, stdout=subprocess.DEVNULL)
+            elapsed = time.perf_counter() - start
+            best = elapsed if best is None else min(best, elapsed)
+        name = f"{needle} -> {replacement}"
+        results.append(("file", name, "time", best * 1e3, "ms"))
+        results.append(("file", name, "throughput", size / best / 1e6, "MB/s"))
+    return results
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.strip().split("\n")[0])
+    parser.add_argument("--profile", default="release", choices=sorted(PROFILES),
+                        help="build profile (default: release)")
+    parser.add_argument("--build-only", action="store_true",
+                        help="only build the binaries, in BUILD_DIR/PROFILE")
+    parser.add_argument("--quick", action="store_true",
+                        help="small inputs, for a run of seconds instead of minutes")
+    parser.add_argument("--targets", default="",
+                        help="comma-separated names, default all: "
+                        + ",".join(t[0] for t in TARGETS))
+    parser.add_argument("--cxxflags", default="",
+                        help="added to the flags of the profile")
+    parser.add_argument("--build-dir", default=str(ROOT / "_bench_build"))
+    parser.add_argument("--out", default=None,
+                        help="write PREFIX.json and PREFIX.csv "
+                        "(default: BUILD_DIR/results-REVISION-PROFILE)")
+    parser.add_argument("--history", default=None,
+                        help="also append the rows to this CSV, to follow a number across revisions")
+    args = parser.parse_args()
+
+    wanted = set(filter(None, args.targets.split(",")))
+    unknown = wanted - set(t[0] for t in TARGETS)
+    if unknown:
+        print(f"Error: unknown target(s): {', '.join(sorted(unknown))}", file=sys.stderr)
+        return 1
+
+    revision = git("rev-parse", "HEAD") or "unknown"
+    dirty = bool(git("status", "--porcelain", "--untracked-files=no"))
+    cxxflags = f"{PROFILES[args.profile]} {args.cxxflags}".strip()
+    compiler = subprocess.run(["c++", "--version"], capture_output=True,
+                              text=True).stdout.split("\n")[0]
+    run = {
+        "revision": revision,
+        "dirty": dirty,
+        "date": datetime.datetime.now(datetime.timezone.utc).isoformat(timespec="seconds"),
+        "host": os.uname().nodename,
+        "compiler": compiler,
+        "profile": args.profile,
+        "cxxflags": f"{BASE_FLAGS} {cxxflags}",
+        "quick": args.quick,
+        "results": [],
+    }
+
+    build_root = Path(args.build_dir) / args.profile
+    status = 0
+    for target in TARGETS:
+        name, directory, program = target[0], target[1], target[3]
+        if wanted and name not in wanted:
+            continue
+        print(f"{name}: building {directory}", file=sys.stderr)
+        try:
+            if args.profile == "pgo":
+                work = build_pgo(target, build_root, cxxflags)
+            else:
+                work = build(directory, target[2], build_root, cxxflags)
+            if args.build_only:
+                continue
+            print(f"{name}: running {program}", file=sys.stderr)
+            results = run_target(target, work, args.quick)
+        except (subprocess.CalledProcessError, RuntimeError) as e:
+            print(f"{name}: failed: {e}", file=sys.stderr)
+            status = 1
+            continue
+        for group, benchmark, metric, value, unit in results:
+            run["results"].append({"target": name, "group": group, "benchmark": benchmark,
+                                   "metric": metric, "value": value, "unit": unit})
+
+    if args.build_only:
+        print(f"binaries in {build_root}", file=sys.stderr)
+        return status
+
+    prefix = Path(args.out) if args.out else \
+        Path(args.build_dir) / f"results-{revision[:12]}-{args.profile}"
+    prefix.parent.mkdir(parents=True, exist_ok=True)
+    with open(str(prefix) + ".json", "w") as out:
+        json.dump(run, out, indent=2)
+        out.write("\n")
+
+    columns = ["revision", "dirty", "date", "profile", "cxxflags", "target", "group", "benchmark",
+               "metric", "value", "unit"]
+    rows = [dict(run, **r) for r in run["results"]]
+    with open(str(prefix) + ".csv", "w", newline="") as out:
+        writer = csv.DictWriter(out, columns, extrasaction="ignore")
+        writer.writeheader()
+        writer.writerows(rows)
+    if args.history:
+        new = not os.path.exists(args.history)
+        with open(args.history, "a", newline="") as out:
+            writer = csv.DictWriter(out, columns, extrasaction="ignore")
+            if new:
+                writer.writeheader()
+            writer.writerows(rows)
+
+    print(f"{len(rows)} results in {prefix}.json and {prefix}.csv", file=sys.stderr)
+    return status
+
+
+if __name__ == "__main__":
+    sys.exit(main())
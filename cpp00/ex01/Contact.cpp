@@ -15,6 +15,57 @@ void Contact::setContact() {
     std::getline(std::cin, darkestSecret);
 }
 
+void Contact::setContact(const std::string& firstName, const std::string& lastName,
+                         const std::string& nickname, const std::string& phoneNumber,
+                         const std::string& darkestSecret) {
+    this->firstName = firstName;
+    this->lastName = lastName;
+    this->nickname = nickname;
+    this->phoneNumber = phoneNumber;
+    this->darkestSecret = darkestSecret;
+}
+
+// Assigning into the existing strings reuses their buffers, so filling
+// the same contact again allocates nothing once they are large enough
+bool Contact::tryParse(const std::string& line) {
+    size_t tabs[4];
+    size_t position = 0;
+    for (int i = 0; i < 4; i++) {
+        tabs[i] = line.find('\t', position);
+        if (tabs[i] == std::string::npos)
+            return false;
+        position = tabs[i] + 1;
+    }
+    if (line.find('\t', position) != std::string::npos)
+        return false;
+    firstName.assign(line, 0, tabs[0]);
+    lastName.assign(line, tabs[0] + 1, tabs[1] - tabs[0] - 1);
+    nickname.assign(line, tabs[1] + 1, tabs[2] - tabs[1] - 1);
+    phoneNumber.assign(line, tabs[2] + 1, tabs[3] - tabs[2] - 1);
+    darkestSecret.assign(line, tabs[3] + 1, std::string::npos);
+    return true;
+}
+
+const std::string& Contact::getFirstName() const {
+    return firstName;
+}
+
+const std::string& Contact::getLastName() const {
+    return lastName;
+}
+
+const std::string& Contact::getNickname() const {
+    return nickname;
+}
+
+const std::string& Contact::getPhoneNumber() const {
+    return phoneNumber;
+}
+
+const std::string& Contact::getDarkestSecret() const {
+    return darkestSecret;
+}
+
 void Contact::displayContact(int index) const {
     std::cout << std::setw(10) << index << "|";
     printField(firstName);
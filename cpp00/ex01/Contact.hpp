@@ -13,6 +13,18 @@ private:
 
 public:
     void setContact();
+    void setContact(const std::string& firstName, const std::string& lastName,
+                    const std::string& nickname, const std::string& phoneNumber,
+                    const std::string& darkestSecret);
+    // Fill the contact from one line of five tab-separated fields, in
+    // the order setContact asks for them. A line with another number of
+    // fields leaves the contact as it was
+    bool tryParse(const std::string& line);
+    const std::string& getFirstName() const;
+    const std::string& getLastName() const;
+    const std::string& getNickname() const;
+    const std::string& getPhoneNumber() const;
+    const std::string& getDarkestSecret() const;
     void displayContact(int index) const;
     void displayFullContact() const;
     
@@ -0,0 +1,138 @@
+#include "ContactStore.hpp"
+#include <cstring>
+#include <iostream>
+#include <iomanip>
+
+std::string ContactStore::View::str() const {
+    return std::string(data, length);
+}
+
+int ContactStore::View::compare(const View& other) const {
+    size_t n = length < other.length ? length : other.length;
+    int order = n ? std::memcmp(data, other.data, n) : 0;
+    if (order)
+        return order;
+    return length < other.length ? -1 : (length > other.length ? 1 : 0);
+}
+
+int ContactStore::View::compare(size_t n, const std::string& text) const {
+    View own = { data, length < n ? length : n };
+    View that = { text.data(), text.size() };
+    return own.compare(that);
+}
+
+ContactStore::ContactStore() {}
+
+void ContactStore::append(const char* const* fields, const size_t* lengths) {
+    HotRow hotRow;
+    hotRow.offset = hot.size();
+    for (int i = 0; i < HOT_COLUMNS; i++) {
+        hot.append(fields[i], lengths[i]);
+        hotRow.length[i] = static_cast<unsigned int>(lengths[i]);
+    }
+    ColdRow coldRow;
+    coldRow.offset = cold.size();
+    for (int i = HOT_COLUMNS; i < COLUMN_COUNT; i++) {
+        cold.append(fields[i], lengths[i]);
+        coldRow.length[i - HOT_COLUMNS] = static_cast<unsigned int>(lengths[i]);
+    }
+    hotRows.push_back(hotRow);
+    coldRows.push_back(coldRow);
+}
+
+size_t ContactStore::add(const Contact& contact) {
+    const std::string* values[COLUMN_COUNT] = {
+        &contact.getFirstName(), &contact.getLastName(), &contact.getNickname(),
+        &contact.getPhoneNumber(), &contact.getDarkestSecret()
+    };
+    const char* fields[COLUMN_COUNT];
+    size_t lengths[COLUMN_COUNT];
+    for (int i = 0; i < COLUMN_COUNT; i++) {
+        fields[i] = values[i]->data();
+        lengths[i] = values[i]->size();
+    }
+    append(fields, lengths);
+    return hotRows.size() - 1;
+}
+
+bool ContactStore::tryParse(const std::string& line) {
+    const char* fields[COLUMN_COUNT];
+    size_t lengths[COLUMN_COUNT];
+    size_t position = 0;
+    for (int i = 0; i < COLUMN_COUNT; i++) {
+        size_t tab = line.find('\t', position);
+        if ((tab == std::string::npos) != (i == COLUMN_COUNT - 1))
+            return false;
+        if (tab == std::string::npos)
+            tab = line.size();
+        fields[i] = line.data() + position;
+        lengths[i] = tab - position;
+        position = tab + 1;
+    }
+    append(fields, lengths);
+    return true;
+}
+
+size_t ContactStore::size() const {
+    return hotRows.size();
+}
+
+ContactStore::View ContactStore::get(size_t id, Column column) const {
+    const unsigned int* length;
+    size_t offset;
+    const std::string* arena;
+    int first;
+    if (column < HOT_COLUMNS) {
+        length = hotRows[id].length;
+        offset = hotRows[id].offset;
+        arena = &hot;
+        first = 0;
+    } else {
+        length = coldRows[id].length;
+        offset = coldRows[id].offset;
+        arena = &cold;
+        first = HOT_COLUMNS;
+    }
+    for (int i = first; i < column; i++)
+        offset += length[i - first];
+    View view = { arena->data() + offset, length[column - first] };
+    return view;
+}
+
+Contact ContactStore::contact(size_t id) const {
+    Contact contact;
+    contact.setContact(get(id, FIRST_NAME).str(), get(id, LAST_NAME).str(),
+                       get(id, NICKNAME).str(), get(id, PHONE_NUMBER).str(),
+                       get(id, DARKEST_SECRET).str());
+    return contact;
+}
+
+void ContactStore::printField(const View& field) {
+    if (field.length > 10)
+        std::cout.write(field.data, 9) << ".";
+    else
+        std::cout.write("          ", 10 - field.length).write(field.data, field.length);
+}
+
+void ContactStore::displayContact(size_t id, int index) const {
+    std::cout << std::setw(10) << index << "|";
+    printField(get(id, FIRST_NAME));
+    std::cout << "|";
+    printField(get(id, LAST_NAME));
+    std::cout << "|";
+    printField(get(id, NICKNAME));
+    std::cout << std::endl;
+}
+
+void ContactStore::displayFullContact(size_t id) const {
+    std::cout << "First name: " << get(id, FIRST_NAME).str() << std::endl;
+    std::cout << "Last name: " << get(id, LAST_NAME).str() << std::endl;
+    std::cout << "Nickname: " << get(id, NICKNAME).str() << std::endl;
+    std::cout << "Phone number: " << get(id, PHONE_NUMBER).str() << std::endl;
+    std::cout << "Darkest secret: " << get(id, DARKEST_SECRET).str() << std::endl;
+}
+
+size_t ContactStore::getMemoryUsage() const {
+    return hot.capacity() + cold.capacity()
+        + hotRows.capacity() * sizeof(HotRow) + coldRows.capacity() * sizeof(ColdRow);
+}
@@ -0,0 +1,76 @@
+#ifndef CONTACTSTORE_HPP
+#define CONTACTSTORE_HPP
+
+#include "Contact.hpp"
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// Contacts stored by column instead of as Contact objects. The names shown
+// in the search table are kept together in one hot arena, and the phone
+// number and darkest secret, read only for the details of one contact,
+// in a separate cold arena: printing a table reads only hot data, and a
+// contact costs no allocation of its own
+class ContactStore {
+public:
+    enum Column {
+        FIRST_NAME,
+        LAST_NAME,
+        NICKNAME,
+        PHONE_NUMBER,
+        DARKEST_SECRET,
+        COLUMN_COUNT
+    };
+
+    static const int HOT_COLUMNS = 3;
+
+    // One field, in place in its arena: valid until the next add
+    struct View {
+        const char* data;
+        size_t length;
+
+        std::string str() const;
+        // As std::string::compare; the second compares only the first n
+        // characters of the field
+        int compare(const View& other) const;
+        int compare(size_t n, const std::string& text) const;
+    };
+
+    ContactStore();
+
+    size_t add(const Contact& contact);
+    // Add a contact from a line that Contact::tryParse would accept
+    bool tryParse(const std::string& line);
+    size_t size() const;
+
+    View get(size_t id, Column column) const;
+    Contact contact(size_t id) const;
+
+    // As Contact::displayContact and Contact::displayFullContact
+    void displayContact(size_t id, int index) const;
+    void displayFullContact(size_t id) const;
+
+    size_t getMemoryUsage() const;
+
+private:
+    // Where a contact's fields are in an arena: field i starts at
+    // offset plus the lengths of the fields before it
+    template <int N>
+    struct Row {
+        size_t offset;
+        unsigned int length[N];
+    };
+
+    typedef Row<HOT_COLUMNS> HotRow;
+    typedef Row<COLUMN_COUNT - HOT_COLUMNS> ColdRow;
+
+    std::string hot;
+    std::string cold;
+    std::vector<HotRow> hotRows;
+    std::vector<ColdRow> coldRows;
+
+    void append(const char* const* fields, const size_t* lengths);
+    static void printField(const View& field);
+};
+
+#endif
@@ -0,0 +1,136 @@
+#include "Directory.hpp"
+#include <algorithm>
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+
+namespace {
+
+struct ByField {
+    const ContactStore* contacts;
+    Directory::Field field;
+    ContactStore::View key(size_t id) const {
+        return contacts->get(id, static_cast<ContactStore::Column>(field));
+    }
+    bool operator()(size_t a, size_t b) const {
+        int order = key(a).compare(key(b));
+        return order < 0 || (order == 0 && a < b);
+    }
+    // Only the first prefix.size() characters take part, so every key
+    // that starts with prefix compares equal to it
+    bool operator()(size_t a, const std::string& prefix) const {
+        return key(a).compare(prefix.size(), prefix) < 0;
+    }
+    bool operator()(const std::string& prefix, size_t b) const {
+        return key(b).compare(prefix.size(), prefix) > 0;
+    }
+};
+
+}
+
+Directory::Directory() {
+    for (int f = 0; f < FIELD_COUNT; f++)
+        sorted[f] = 0;
+}
+
+size_t Directory::add(const Contact& contact) {
+    size_t id = contacts.add(contact);
+    for (int f = 0; f < FIELD_COUNT; f++)
+        index[f].push_back(id);
+    return id;
+}
+
+void Directory::addContact() {
+    Contact contact;
+    contact.setContact();
+    add(contact);
+}
+
+// Each line is parsed straight into the store, with no Contact made
+size_t Directory::importContacts(std::istream& in) {
+    size_t count = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (contacts.tryParse(line)) {
+            size_t id = contacts.size() - 1;
+            for (int f = 0; f < FIELD_COUNT; f++)
+                index[f].push_back(id);
+            count++;
+        }
+    }
+    return count;
+}
+
+size_t Directory::size() const {
+    return contacts.size();
+}
+
+Contact Directory::operator[](size_t id) const {
+    return contacts.contact(id);
+}
+
+const ContactStore& Directory::getStore() const {
+    return contacts;
+}
+
+// Sort the ids added since the last query and merge them into the rest
+void Directory::update(Field field) const {
+    std::vector<size_t>& ids = index[field];
+    if (sorted[field] == ids.size())
+        return;
+    ByField order = { &contacts, field };
+    std::vector<size_t>::iterator middle = ids.begin() + sorted[field];
+    std::sort(middle, ids.end(), order);
+    std::inplace_merge(ids.begin(), middle, ids.end(), order);
+    sorted[field] = ids.size();
+}
+
+void Directory::find(Field field, const std::string& prefix, std::vector<size_t>& ids) const {
+    update(field);
+    ByField order = { &contacts, field };
+    std::pair<std::vector<size_t>::const_iterator, std::vector<size_t>::const_iterator> range
+        = std::equal_range(index[field].begin(), index[field].end(), prefix, order);
+    ids.insert(ids.end(), range.first, range.second);
+}
+
+void Directory::findAny(const std::string& prefix, std::vector<size_t>& ids) const {
+    size_t start = ids.size();
+    for (int f = 0; f < FIELD_COUNT; f++)
+        find(static_cast<Field>(f), prefix, ids);
+    std::vector<size_t>::iterator first = ids.begin() + start;
+    std::sort(first, ids.end());
+    ids.erase(std::unique(first, ids.end()), ids.end());
+}
+
+void Directory::printTable(const std::vector<size_t>& ids) const {
+    std::cout << std::setw(10) << "Index" << "|"
+              << std::setw(10) << "First Name" << "|"
+              << std::setw(10) << "Last Name" << "|"
+              << std::setw(10) << "Nickname" << std::endl;
+
+    for (size_t i = 0; i < ids.size(); i++) {
+        contacts.displayContact(ids[i], static_cast<int>(i));
+    }
+}
+
+void Directory::searchContacts() const {
+    std::cout << "Enter name prefix: ";
+    std::string prefix;
+    std::getline(std::cin, prefix);
+
+    std::vector<size_t> ids;
+    findAny(prefix, ids);
+    printTable(ids);
+
+    std::cout << "Enter index to view details: ";
+    std::string input;
+    std::getline(std::cin, input);
+
+    std::istringstream iss(input);
+    size_t index;
+    if (iss >> index && index < ids.size()) {
+        contacts.displayFullContact(ids[index]);
+    } else {
+        std::cout << "Invalid index!" << std::endl;
+    }
+}
@@ -0,0 +1,55 @@
+#ifndef DIRECTORY_HPP
+#define DIRECTORY_HPP
+
+#include "ContactStore.hpp"
+#include <string>
+#include <istream>
+#include <vector>
+#include <cstddef>
+
+// A phone book with no size limit, for when 8 contacts are not enough.
+// Contacts are found by a prefix of their first name, last name or
+// nickname in O(log n + matches): each of those fields has an index of
+// contact ids sorted by the field. New contacts are appended to the end
+// of each index and merged in on the next query, so a run of adds costs
+// one sort rather than one insertion each. The contacts themselves are a
+// ContactStore, so the index and the search table read only the names
+class Directory {
+public:
+    enum Field {
+        FIRST_NAME = ContactStore::FIRST_NAME,
+        LAST_NAME = ContactStore::LAST_NAME,
+        NICKNAME = ContactStore::NICKNAME,
+        FIELD_COUNT = ContactStore::HOT_COLUMNS
+    };
+
+    Directory();
+
+    size_t add(const Contact& contact);
+    void addContact();
+    // As PhoneBook::importContacts
+    size_t importContacts(std::istream& in);
+    size_t size() const;
+    Contact operator[](size_t id) const;
+    const ContactStore& getStore() const;
+
+    // Append to ids those of the contacts whose field starts with prefix,
+    // in the order of that field. findAny searches all three fields and
+    // lists a contact matching in several of them once, in id order
+    void find(Field field, const std::string& prefix, std::vector<size_t>& ids) const;
+    void findAny(const std::string& prefix, std::vector<size_t>& ids) const;
+
+    // The search table of the given contacts, then the details of the one
+    // whose row the user picks
+    void printTable(const std::vector<size_t>& ids) const;
+    void searchContacts() const;
+
+private:
+    ContactStore contacts;
+    mutable std::vector<size_t> index[FIELD_COUNT];
+    mutable size_t sorted[FIELD_COUNT];     // length of the sorted head
+
+    void update(Field field) const;
+};
+
+#endif
@@ -3,13 +3,50 @@
 #include <iomanip>
 #include <sstream>
 
-PhoneBook::PhoneBook() : contactCount(0) {}
+PhoneBook::PhoneBook() : head(0), contactCount(0) {}
+
+// The slot the next contact goes to: after the newest, or the oldest
+// when the book is full
+Contact& PhoneBook::next() {
+    return contacts[(head + contactCount) % CAPACITY];
+}
+
+// Count the contact just written to next()
+void PhoneBook::push() {
+    if (contactCount == CAPACITY)
+        head = (head + 1) % CAPACITY;
+    else
+        contactCount++;
+}
 
 void PhoneBook::addContact() {
-    if (contactCount == 8)
-        contactCount = 0;
-    contacts[contactCount].setContact();
-    contactCount++;
+    next().setContact();
+    push();
+}
+
+void PhoneBook::addContact(const Contact& contact) {
+    next() = contact;
+    push();
+}
+
+size_t PhoneBook::importContacts(std::istream& in) {
+    size_t count = 0;
+    std::string line;
+    while (std::getline(in, line)) {
+        if (next().tryParse(line)) {
+            push();
+            count++;
+        }
+    }
+    return count;
+}
+
+int PhoneBook::size() const {
+    return contactCount;
+}
+
+const Contact& PhoneBook::operator[](int index) const {
+    return contacts[(head + index) % CAPACITY];
 }
 
 void PhoneBook::searchContacts() const {
@@ -19,7 +56,7 @@ void PhoneBook::searchContacts() const {
               << std::setw(10) << "Nickname" << std::endl;
 
     for (int i = 0; i < contactCount; i++) {
-        contacts[i].displayContact(i);
+        (*this)[i].displayContact(i);
     }
 
     std::cout << "Enter index to view details: ";
@@ -28,10 +65,9 @@ void PhoneBook::searchContacts() const {
     
     std::istringstream iss(input);
     int index;
-    iss >> index;
 
-    if (index >= 0 && index < contactCount) {
-        contacts[index].displayFullContact();
+    if (iss >> index && index >= 0 && index < contactCount) {
+        (*this)[index].displayFullContact();
     } else {
         std::cout << "Invalid index!" << std::endl;
     }
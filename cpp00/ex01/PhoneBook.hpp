@@ -2,15 +2,33 @@
 #define PHONEBOOK_HPP
 
 #include "Contact.hpp"
+#include <istream>
+#include <cstddef>
 
+// The last 8 contacts, as a ring: head is the oldest, which the next
+// contact replaces once the book is full
 class PhoneBook {
+public:
+    static const int CAPACITY = 8;
+
 private:
-    Contact contacts[8];
+    Contact contacts[CAPACITY];
+    int head;
     int contactCount;
 
+    Contact& next();
+    void push();
+
 public:
     PhoneBook();
     void addContact();
+    void addContact(const Contact& contact);
+    // Add a contact for each line of in, as Contact::tryParse reads them,
+    // with no prompt; returns how many were added
+    size_t importContacts(std::istream& in);
+    int size() const;
+    // The index-th oldest contact
+    const Contact& operator[](int index) const;
     void searchContacts() const;
 };
 
@@ -1,21 +1,55 @@
 #include "PhoneBook.hpp"
+#include "Directory.hpp"
 #include <iostream>
+#include <fstream>
+
+// The same commands on either book: the 8-contact PhoneBook, or with -d
+// a Directory, whose SEARCH asks for a name prefix first. A file given
+// after the options is imported before the first prompt, one contact
+// per line as five tab-separated fields
+template <typename Book>
+static int run(Book& book, const char* path) {
+    if (path) {
+        std::ifstream file(path);
+        if (!file) {
+            std::cerr << "Error: cannot open " << path << std::endl;
+            return 1;
+        }
+        std::cout << book.importContacts(file) << " contacts imported" << std::endl;
+    }
 
-int main() {
-    PhoneBook phonebook;
     std::string command;
 
     while (true) {
         std::cout << "Enter command (ADD, SEARCH, EXIT): ";
-        std::getline(std::cin, command);
+        if (!std::getline(std::cin, command))
+            break;
 
         if (command == "ADD") {
-            phonebook.addContact();
+            book.addContact();
         } else if (command == "SEARCH") {
-            phonebook.searchContacts();
+            book.searchContacts();
         } else if (command == "EXIT") {
             break;
         }
     }
     return 0;
 }
+
+int main(int argc, char** argv) {
+    int arg = 1;
+    bool scalable = arg < argc && std::string(argv[arg]) == "-d";
+    if (scalable)
+        arg++;
+    if (argc > arg + 1) {
+        std::cerr << "Usage: " << argv[0] << " [-d] [contacts file]" << std::endl;
+        return 1;
+    }
+    const char* path = arg < argc ? argv[arg] : 0;
+    if (scalable) {
+        Directory directory;
+        return run(directory, path);
+    }
+    PhoneBook phonebook;
+    return run(phonebook, path);
+}
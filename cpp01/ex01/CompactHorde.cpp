@@ -0,0 +1,104 @@
+#include "CompactHorde.hpp"
+#include "HordeSink.hpp"
+#include <iostream>
+
+static const size_t LINE_BUFFER_SIZE = 64 * 1024;
+
+CompactHorde::CompactHorde(unsigned int N, const std::string& name) : name(name), suffixes(N) {
+    for (unsigned int i = 0; i < N; i++)
+        suffixes[i] = i;
+}
+
+CompactHorde::CompactHorde(const CompactHorde& other) {
+    (void)other;
+}
+
+CompactHorde& CompactHorde::operator=(const CompactHorde& other) {
+    (void)other;
+    return *this;
+}
+
+// A Zombie with an empty name says nothing, and neither does one here
+CompactHorde::~CompactHorde() {
+    if (name.empty())
+        return;
+    StreamSink sink(std::cout);
+    writeLines(sink, " has been destroyed.\n", true);
+    std::cout.flush();
+}
+
+void CompactHorde::appendName(std::string& out, size_t index) const {
+    char digits[16];
+    size_t length = 0;
+    unsigned int n = suffixes[index];
+    do {
+        digits[sizeof(digits) - ++length] = static_cast<char>('0' + n % 10);
+        n /= 10;
+    } while (n);
+    out += name;
+    out += ' ';
+    out.append(digits + sizeof(digits) - length, length);
+}
+
+// Every zombie's name followed by line, front to back or back to front,
+// gathered in one buffer written whenever it fills
+template <typename Sink>
+bool CompactHorde::writeLines(Sink& sink, const char* line, bool reverse) const {
+    std::string buffer;
+    buffer.reserve(LINE_BUFFER_SIZE + name.size() + 64);
+    for (size_t k = 0; k < suffixes.size(); k++) {
+        appendName(buffer, reverse ? suffixes.size() - 1 - k : k);
+        buffer += line;
+        if (buffer.size() >= LINE_BUFFER_SIZE) {
+            if (!sink.write(buffer))
+                return false;
+            buffer.clear();
+        }
+    }
+    return buffer.empty() || sink.write(buffer);
+}
+
+size_t CompactHorde::size() const {
+    return suffixes.size();
+}
+
+const std::string& CompactHorde::getBaseName() const {
+    return name;
+}
+
+unsigned int CompactHorde::getSuffix(size_t index) const {
+    return suffixes[index];
+}
+
+void CompactHorde::setSuffix(size_t index, unsigned int suffix) {
+    suffixes[index] = suffix;
+}
+
+std::string CompactHorde::getName(size_t index) const {
+    std::string out;
+    appendName(out, index);
+    return out;
+}
+
+void CompactHorde::announce(size_t index) const {
+    if (name.empty())
+        return;
+    std::string line;
+    appendName(line, index);
+    std::cout << line << ": BraiiiiinnnzzzZ..." << std::endl;
+}
+
+void CompactHorde::announceAll() const {
+    if (name.empty())
+        return;
+    StreamSink sink(std::cout);
+    writeLines(sink, ": BraiiiiinnnzzzZ...\n", false);
+    std::cout.flush();
+}
+
+bool CompactHorde::announceAll(int fd) const {
+    if (name.empty())
+        return true;
+    FdSink sink(fd);
+    return writeLines(sink, ": BraiiiiinnnzzzZ...\n", false);
+}
\ No newline at end of file
@@ -0,0 +1,49 @@
+#ifndef COMPACTHORDE_HPP
+#define COMPACTHORDE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// A horde that keeps what tells its zombies apart and nothing else: the
+// base name once, and one unsigned int suffix per zombie, so zombie i
+// is "<name> <suffix i>". Names are formatted only when announce or the
+// destructor needs them. Building N zombies allocates their suffixes in
+// one block and nothing per zombie: 4 bytes a zombie, where a Zombie is
+// a std::string (32 bytes with libstdc++, plus a heap block for names
+// too long to fit in it). Like ZombieHorde, the suffixes start 0 to N-1,
+// and the zombies say they are destroyed with the horde, last first
+class CompactHorde {
+private:
+    std::string name;
+    std::vector<unsigned int> suffixes;
+
+    void appendName(std::string& out, size_t index) const;
+    template <typename Sink>
+    bool writeLines(Sink& sink, const char* line, bool reverse) const;
+
+    CompactHorde(const CompactHorde& other);
+    CompactHorde& operator=(const CompactHorde& other);
+
+public:
+    CompactHorde(unsigned int N, const std::string& name);
+    ~CompactHorde();
+
+    size_t size() const;
+    const std::string& getBaseName() const;
+    unsigned int getSuffix(size_t index) const;
+    void setSuffix(size_t index, unsigned int suffix);
+
+    // The full name of zombie index, built on demand
+    std::string getName(size_t index) const;
+
+    // Zombie index announces itself, as Zombie::announce
+    void announce(size_t index) const;
+
+    // Every zombie announces itself through one 64 KiB buffer, as
+    // ZombieHorde::announceAll
+    void announceAll() const;
+    bool announceAll(int fd) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef HORDESINK_HPP
+#define HORDESINK_HPP
+
+#include <string>
+#include <ostream>
+#include <cerrno>
+#include <unistd.h>
+
+// Where a horde sends its buffered lines: write returns false once the
+// destination has failed
+struct StreamSink {
+    std::ostream& out;
+
+    StreamSink(std::ostream& out) : out(out) {}
+
+    bool write(const std::string& data) {
+        out.write(data.data(), data.size());
+        return !out.fail();
+    }
+};
+
+struct FdSink {
+    int fd;
+
+    FdSink(int fd) : fd(fd) {}
+
+    bool write(const std::string& data) {
+        const char* p = data.data();
+        size_t left = data.size();
+        while (left) {
+            ssize_t written = ::write(fd, p, left);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return false;
+            p += written;
+            left -= written;
+        }
+        return true;
+    }
+};
+
+#endif
\ No newline at end of file
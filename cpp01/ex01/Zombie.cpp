@@ -3,7 +3,7 @@
 
 Zombie::Zombie() : name("") {}
 
-Zombie::Zombie(std::string name) : name(name) {}
+Zombie::Zombie(const std::string& name) : name(name) {}
 
 Zombie::~Zombie() {
     if (!name.empty()) {
@@ -17,6 +17,13 @@ void Zombie::announce(void) {
     }
 }
 
+void Zombie::announceInto(std::string& out) const {
+    if (!name.empty()) {
+        out += name;
+        out += ": BraiiiiinnnzzzZ...\n";
+    }
+}
+
 void Zombie::setName(std::string name) {
     this->name = name;
 }
\ No newline at end of file
@@ -8,9 +8,11 @@ private:
     std::string name;
 public:
     Zombie();
-    Zombie(std::string name);
+    Zombie(const std::string& name);
     ~Zombie();
     void announce(void);
+    // The line announce prints, appended to out with its newline
+    void announceInto(std::string& out) const;
     void setName(std::string name);
 };
 
@@ -0,0 +1,94 @@
+#include "ZombieHorde.hpp"
+#include "HordeSink.hpp"
+#include <new>
+#include <iostream>
+
+static const size_t ANNOUNCE_BUFFER_SIZE = 64 * 1024;
+
+ZombieHorde::ZombieHorde(size_t N, const std::string& name) : zombies(0), count(0) {
+    if (N == 0)
+        return;
+    zombies = static_cast<Zombie*>(::operator new(N * sizeof(Zombie)));
+    std::string buffer(name);
+    buffer += ' ';
+    size_t prefix = buffer.size();
+    char digits[24];
+    try {
+        for (; count < N; count++) {
+            size_t i = count;
+            size_t length = 0;
+            do {
+                digits[sizeof(digits) - ++length] = static_cast<char>('0' + i % 10);
+                i /= 10;
+            } while (i);
+            buffer.resize(prefix);
+            buffer.append(digits + sizeof(digits) - length, length);
+            new (zombies + count) Zombie(buffer);
+        }
+    } catch (...) {
+        destroy();
+        throw;
+    }
+}
+
+ZombieHorde::ZombieHorde(const ZombieHorde& other) : zombies(0), count(0) {
+    (void)other;
+}
+
+ZombieHorde& ZombieHorde::operator=(const ZombieHorde& other) {
+    (void)other;
+    return *this;
+}
+
+ZombieHorde::~ZombieHorde() {
+    destroy();
+}
+
+void ZombieHorde::destroy() {
+    while (count)
+        zombies[--count].~Zombie();
+    ::operator delete(zombies);
+    zombies = 0;
+}
+
+size_t ZombieHorde::size() const {
+    return count;
+}
+
+Zombie& ZombieHorde::operator[](size_t index) {
+    return zombies[index];
+}
+
+Zombie* ZombieHorde::begin() {
+    return zombies;
+}
+
+Zombie* ZombieHorde::end() {
+    return zombies + count;
+}
+
+template <typename Sink>
+bool ZombieHorde::announceTo(Sink& sink) {
+    std::string buffer;
+    buffer.reserve(ANNOUNCE_BUFFER_SIZE + 256);
+    for (size_t i = 0; i < count; i++) {
+        zombies[i].announceInto(buffer);
+        if (buffer.size() >= ANNOUNCE_BUFFER_SIZE) {
+            if (!sink.write(buffer))
+                return false;
+            buffer.clear();
+        }
+    }
+    return buffer.empty() || sink.write(buffer);
+}
+
+void ZombieHorde::announceAll() {
+    StreamSink sink(std::cout);
+    announceTo(sink);
+    std::cout.flush();
+}
+
+bool ZombieHorde::announceAll(int fd) {
+    FdSink sink(fd);
+    return announceTo(sink);
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef ZOMBIEHORDE_HPP
+#define ZOMBIEHORDE_HPP
+
+#include "Zombie.hpp"
+#include <string>
+#include <cstddef>
+
+// N zombies named "<name> 0" to "<name> N-1", as zombieHorde makes them,
+// but built for big hordes: the storage is allocated once, uninitialized,
+// and each Zombie is constructed in it with its final name, formatted in
+// one buffer reused for every name, so there is no default construction,
+// no setName and no stringstream. The zombies are destroyed with the
+// horde, last first, as delete[] would
+class ZombieHorde {
+private:
+    Zombie* zombies;
+    size_t count;
+
+    void destroy();
+    template <typename Sink>
+    bool announceTo(Sink& sink);
+
+    ZombieHorde(const ZombieHorde& other);
+    ZombieHorde& operator=(const ZombieHorde& other);
+
+public:
+    ZombieHorde(size_t N, const std::string& name);
+    ~ZombieHorde();
+
+    size_t size() const;
+    Zombie& operator[](size_t index);
+    Zombie* begin();
+    Zombie* end();
+
+    // Every zombie announces itself, the lines gathered in a buffer of
+    // about 64 KiB written in one call whenever it fills: to std::cout,
+    // flushed once at the end, or straight to a file descriptor. The fd
+    // version returns false if a write fails
+    void announceAll();
+    bool announceAll(int fd);
+};
+
+#endif
\ No newline at end of file
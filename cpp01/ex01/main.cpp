@@ -1,4 +1,6 @@
 #include "Zombie.hpp"
+#include "ZombieHorde.hpp"
+#include "CompactHorde.hpp"
 #include <iostream>
 
 int main() {
@@ -10,5 +12,18 @@ int main() {
     }
     
     delete[] horde;
+
+    {
+        ZombieHorde built(3, "BuiltZombie");
+        built.announceAll();
+        built.announceAll(1);
+    }
+
+    {
+        CompactHorde compact(3, "CompactZombie");
+        compact.announce(0);
+        compact.announceAll();
+        std::cout << "Zombie 2 is " << compact.getName(2) << std::endl;
+    }
     return 0;
 }
\ No newline at end of file
@@ -1,7 +1,7 @@
 #include "HumanA.hpp"
 #include <iostream>
 
-HumanA::HumanA(std::string name, Weapon& weapon) : name(name), weapon(weapon) {}
+HumanA::HumanA(const std::string& name, Weapon& weapon) : name(name), weapon(weapon) {}
 
 void HumanA::attack() {
     std::cout << name << " attacks with their " << weapon.getType() << std::endl;
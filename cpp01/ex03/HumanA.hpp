@@ -9,7 +9,7 @@ private:
     std::string name;
     Weapon& weapon;
 public:
-    HumanA(std::string name, Weapon& weapon);
+    HumanA(const std::string& name, Weapon& weapon);
     void attack();
 };
 
@@ -1,7 +1,7 @@
 #include "HumanB.hpp"
 #include <iostream>
 
-HumanB::HumanB(std::string name) : name(name), weapon(0) {}
+HumanB::HumanB(const std::string& name) : name(name), weapon(0) {}
 
 void HumanB::setWeapon(Weapon& weapon) {
     this->weapon = &weapon;
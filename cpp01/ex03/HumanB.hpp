@@ -9,7 +9,7 @@ private:
     std::string name;
     Weapon* weapon;
 public:
-    HumanB(std::string name);
+    HumanB(const std::string& name);
     void setWeapon(Weapon& weapon);
     void attack();
 };
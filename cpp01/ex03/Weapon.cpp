@@ -1,11 +1,21 @@
 #include "Weapon.hpp"
 
-Weapon::Weapon(std::string type) : type(type) {}
+Weapon::Weapon(const std::string& type) : typeId(WeaponRegistry::intern(type)) {}
+
+Weapon::Weapon(WeaponRegistry::Id typeId) : typeId(typeId) {}
 
 const std::string& Weapon::getType() const {
-    return type;
+    return WeaponRegistry::name(typeId);
+}
+
+WeaponRegistry::Id Weapon::getTypeId() const {
+    return typeId;
+}
+
+void Weapon::setType(const std::string& type) {
+    typeId = WeaponRegistry::intern(type);
 }
 
-void Weapon::setType(std::string type) {
-    this->type = type;
+void Weapon::setTypeId(WeaponRegistry::Id typeId) {
+    this->typeId = typeId;
 }
\ No newline at end of file
@@ -1,15 +1,20 @@
 #ifndef WEAPON_HPP
 #define WEAPON_HPP
 
+#include "WeaponRegistry.hpp"
 #include <string>
 
+// The type is kept as its WeaponRegistry id
 class Weapon {
 private:
-    std::string type;
+    WeaponRegistry::Id typeId;
 public:
-    Weapon(std::string type);
+    Weapon(const std::string& type);
+    explicit Weapon(WeaponRegistry::Id typeId);
     const std::string& getType() const;
-    void setType(std::string type);
+    WeaponRegistry::Id getTypeId() const;
+    void setType(const std::string& type);
+    void setTypeId(WeaponRegistry::Id typeId);
 };
 
 #endif
\ No newline at end of file
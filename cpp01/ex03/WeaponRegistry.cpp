@@ -0,0 +1,46 @@
+#include "WeaponRegistry.hpp"
+#include <deque>
+#include <map>
+
+// A deque does not move its elements when it grows, so the references
+// name returns stay valid
+static std::deque<std::string>& names() {
+    static std::deque<std::string> table;
+    return table;
+}
+
+static std::map<std::string, WeaponRegistry::Id>& index() {
+    static std::map<std::string, WeaponRegistry::Id> table;
+    return table;
+}
+
+WeaponRegistry::WeaponRegistry() {}
+
+WeaponRegistry::WeaponRegistry(const WeaponRegistry& other) {
+    (void)other;
+}
+
+WeaponRegistry& WeaponRegistry::operator=(const WeaponRegistry& other) {
+    (void)other;
+    return *this;
+}
+
+WeaponRegistry::~WeaponRegistry() {}
+
+WeaponRegistry::Id WeaponRegistry::intern(const std::string& type) {
+    std::map<std::string, Id>::iterator it = index().find(type);
+    if (it != index().end())
+        return it->second;
+    Id id = static_cast<Id>(names().size());
+    names().push_back(type);
+    index().insert(std::make_pair(type, id));
+    return id;
+}
+
+const std::string& WeaponRegistry::name(Id id) {
+    return names()[id];
+}
+
+size_t WeaponRegistry::size() {
+    return names().size();
+}
\ No newline at end of file
@@ -0,0 +1,27 @@
+#ifndef WEAPONREGISTRY_HPP
+#define WEAPONREGISTRY_HPP
+
+#include <string>
+#include <cstddef>
+
+// Every weapon type in use, each stored once: a type is interned on
+// first use and known by its id from then on, so a Weapon is a single
+// id however long its type, and retyping to a known type copies nothing.
+// Types are never removed, and the name of an id stays at the same
+// address for the whole run
+class WeaponRegistry {
+private:
+    WeaponRegistry();
+    WeaponRegistry(const WeaponRegistry& other);
+    WeaponRegistry& operator=(const WeaponRegistry& other);
+    ~WeaponRegistry();
+
+public:
+    typedef unsigned int Id;
+
+    static Id intern(const std::string& type);
+    static const std::string& name(Id id);
+    static size_t size();
+};
+
+#endif
\ No newline at end of file
@@ -1,6 +1,7 @@
 #include "HumanA.hpp"
 #include "HumanB.hpp"
 #include "Weapon.hpp"
+#include <iostream>
 
 int main() {
     {
@@ -18,5 +19,16 @@ int main() {
         club.setType("some other type of club");
         jim.attack();
     }
+    {
+        WeaponRegistry::Id club = WeaponRegistry::intern("crude spiked club");
+        Weapon first(club);
+        Weapon second(club);
+        HumanA ann("Ann", first);
+        HumanB ben("Ben");
+        ben.setWeapon(second);
+        ann.attack();
+        ben.attack();
+        std::cout << WeaponRegistry::size() << " weapon types, " << sizeof(Weapon) << " bytes per weapon" << std::endl;
+    }
     return 0;
 }
\ No newline at end of file
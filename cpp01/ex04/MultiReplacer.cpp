@@ -0,0 +1,171 @@
+#include "MultiReplacer.hpp"
+#include <cstring>
+#include <queue>
+
+MultiReplacer::MultiReplacer() {
+}
+
+MultiReplacer::MultiReplacer(const MultiReplacer& other)
+    : patterns(other.patterns), replacements(other.replacements), next(other.next), depth(other.depth),
+      longest(other.longest) {
+}
+
+MultiReplacer::~MultiReplacer() {
+}
+
+MultiReplacer& MultiReplacer::operator=(const MultiReplacer& other) {
+    if (this != &other) {
+        patterns = other.patterns;
+        replacements = other.replacements;
+        next = other.next;
+        depth = other.depth;
+        longest = other.longest;
+    }
+    return *this;
+}
+
+bool MultiReplacer::addRule(const std::string& s1, const std::string& s2) {
+    for (size_t i = 0; i < patterns.size(); i++) {
+        if (patterns[i] == s1)
+            return false;
+    }
+    patterns.push_back(s1);
+    replacements.push_back(s2);
+    return true;
+}
+
+size_t MultiReplacer::getRuleCount() const {
+    return patterns.size();
+}
+
+int MultiReplacer::addState(int length) {
+    next.resize(next.size() + 256, -1);
+    depth.push_back(length);
+    longest.push_back(-1);
+    return static_cast<int>(depth.size()) - 1;
+}
+
+// The trie of the patterns first, then, breadth first, each missing
+// transition is the one of the failure state, the longest proper suffix
+// that is also in the trie, and a state without a rule of its own takes
+// the longest rule of its failure state
+void MultiReplacer::compile() {
+    next.clear();
+    depth.clear();
+    longest.clear();
+    addState(0);
+    for (size_t r = 0; r < patterns.size(); r++) {
+        int state = 0;
+        for (size_t i = 0; i < patterns[r].size(); i++) {
+            unsigned char c = static_cast<unsigned char>(patterns[r][i]);
+            if (next[state * 256 + c] < 0) {
+                int created = addState(static_cast<int>(i) + 1);
+                next[state * 256 + c] = created;
+            }
+            state = next[state * 256 + c];
+        }
+        longest[state] = static_cast<int>(r);
+    }
+    std::vector<int> fail(depth.size(), 0);
+    std::queue<int> pending;
+    for (int c = 0; c < 256; c++) {
+        int child = next[c];
+        if (child < 0) {
+            next[c] = 0;
+        } else {
+            fail[child] = 0;
+            pending.push(child);
+        }
+    }
+    while (!pending.empty()) {
+        int state = pending.front();
+        pending.pop();
+        if (longest[state] < 0)
+            longest[state] = longest[fail[state]];
+        for (int c = 0; c < 256; c++) {
+            int child = next[state * 256 + c];
+            int fallback = next[fail[state] * 256 + c];
+            if (child < 0) {
+                next[state * 256 + c] = fallback;
+            } else {
+                fail[child] = fallback;
+                pending.push(child);
+            }
+        }
+    }
+}
+
+// The state stands for the bytes from i - depth to i, the earliest point
+// where a match can still start. Once that is past the start of the best
+// match so far, no earlier or longer match can come, so it is replaced
+// and the scan starts again from the root right after it
+size_t MultiReplacer::scan(const char* buffer, size_t size, bool final, std::ostream& out) const {
+    size_t emitted = 0;
+    size_t i = 0;
+    int state = 0;
+    bool found = false;
+    size_t matchStart = 0;
+    size_t matchEnd = 0;
+    int rule = -1;
+    for (;;) {
+        if (i == size) {
+            if (!found || !final)
+                break;
+        } else {
+            state = next[state * 256 + static_cast<unsigned char>(buffer[i])];
+            i++;
+            size_t stateStart = i - depth[state];
+            if (!found || stateStart <= matchStart) {
+                int r = longest[state];
+                if (r >= 0) {
+                    size_t start = i - patterns[r].size();
+                    if (!found || start < matchStart || (start == matchStart && i > matchEnd)) {
+                        found = true;
+                        matchStart = start;
+                        matchEnd = i;
+                        rule = r;
+                    }
+                }
+                continue;
+            }
+        }
+        out.write(buffer + emitted, matchStart - emitted);
+        out.write(replacements[rule].data(), replacements[rule].size());
+        emitted = i = matchEnd;
+        state = 0;
+        found = false;
+    }
+    size_t keep = i - depth[state];
+    if (found && matchStart < keep)
+        keep = matchStart;
+    if (final)
+        keep = size;
+    out.write(buffer + emitted, keep - emitted);
+    return size - keep;
+}
+
+bool MultiReplacer::run(std::istream& in, std::ostream& out) const {
+    size_t longestPattern = 0;
+    for (size_t r = 0; r < patterns.size(); r++) {
+        if (patterns[r].size() > longestPattern)
+            longestPattern = patterns[r].size();
+    }
+    std::vector<char> buffer(BLOCK_SIZE + 2 * longestPattern + 1);
+    size_t kept = 0;
+    bool more = true;
+    while (more) {
+        in.read(&buffer[kept], BLOCK_SIZE);
+        size_t size = kept + static_cast<size_t>(in.gcount());
+        more = !in.eof();
+        if (in.bad() || (in.fail() && more))
+            return false;
+        kept = patterns.empty() ? 0 : scan(&buffer[0], size, !more, out);
+        if (patterns.empty())
+            out.write(&buffer[0], size);
+        std::memmove(&buffer[0], &buffer[size - kept], kept);
+        if (!out)
+            return false;
+    }
+    out.flush();
+    return static_cast<bool>(out);
+}
\ No newline at end of file
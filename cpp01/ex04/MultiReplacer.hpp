@@ -0,0 +1,48 @@
+#ifndef MULTIREPLACER_HPP
+#define MULTIREPLACER_HPP
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstddef>
+
+// Replaces many patterns in one pass: every rule s1 -> s2 is compiled into
+// one Aho-Corasick automaton, as a full table of transitions, and the
+// input is streamed through it once. Matches are chosen leftmost first,
+// then longest, and do not overlap: of the patterns found at the earliest
+// position the longest is replaced, and the search resumes after it. The
+// input is read in blocks of BLOCK_SIZE; the bytes that may still belong
+// to an undecided match, at most twice the longest pattern, are carried
+// over to the next block
+class MultiReplacer {
+private:
+    std::vector<std::string> patterns;
+    std::vector<std::string> replacements;
+    std::vector<int> next;        // 256 transitions per state
+    std::vector<int> depth;       // length of the prefix a state stands for
+    std::vector<int> longest;     // longest rule ending in a state, or -1
+
+    int addState(int length);
+    // Run the automaton over buffer[0..size), writing all that is decided
+    // to out; returns the number of bytes to carry into the next block
+    size_t scan(const char* buffer, size_t size, bool final, std::ostream& out) const;
+
+public:
+    static const size_t BLOCK_SIZE = 1 << 20;
+
+    MultiReplacer();
+    MultiReplacer(const MultiReplacer& other);
+    ~MultiReplacer();
+    MultiReplacer& operator=(const MultiReplacer& other);
+
+    // s1 must not be empty; false for a pattern already added, which
+    // keeps its first replacement
+    bool addRule(const std::string& s1, const std::string& s2);
+    size_t getRuleCount() const;
+    // Build the automaton, after the last addRule and before run
+    void compile();
+    bool run(std::istream& in, std::ostream& out) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "Replacer.hpp"
+#include "ThreadPool.hpp"
+#include <cstring>
+#include <vector>
+#include <cerrno>
+#include <climits>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/uio.h>
+
+#ifndef IOV_MAX
+# define IOV_MAX 1024
+#endif
+
+Replacer::Replacer(const std::string& s1, const std::string& s2) : pattern(s1), replacement(s2) {
+    size_t m = pattern.size();
+    for (size_t c = 0; c < 256; c++)
+        skip[c] = m;
+    for (size_t i = 0; i + 1 < m; i++)
+        skip[static_cast<unsigned char>(pattern[i])] = m - 1 - i;
+}
+
+Replacer::Replacer(const Replacer& other) : pattern(other.pattern), replacement(other.replacement) {
+    std::memcpy(skip, other.skip, sizeof(skip));
+}
+
+Replacer::~Replacer() {
+}
+
+Replacer& Replacer::operator=(const Replacer& other) {
+    if (this != &other) {
+        pattern = other.pattern;
+        replacement = other.replacement;
+        std::memcpy(skip, other.skip, sizeof(skip));
+    }
+    return *this;
+}
+
+// The byte under the end of the pattern decides how far it can move
+size_t Replacer::find(const char* text, size_t length, size_t from) const {
+    size_t m = pattern.size();
+    const char* p = pattern.data();
+    unsigned char last = static_cast<unsigned char>(p[m - 1]);
+    size_t i = from;
+    while (i + m <= length) {
+        unsigned char c = static_cast<unsigned char>(text[i + m - 1]);
+        if (c == last && std::memcmp(text + i, p, m - 1) == 0)
+            return i;
+        i += skip[c];
+    }
+    return length;
+}
+
+bool Replacer::run(std::istream& in, std::ostream& out) const {
+    size_t m = pattern.size();
+    std::vector<char> buffer(BLOCK_SIZE + m);
+    size_t kept = 0;
+    bool more = true;
+    while (more) {
+        in.read(&buffer[kept], BLOCK_SIZE);
+        size_t size = kept + static_cast<size_t>(in.gcount());
+        more = !in.eof();
+        if (in.bad() || (in.fail() && more))
+            return false;
+        const char* text = &buffer[0];
+        size_t pos = 0;
+        for (size_t found = find(text, size, 0); found < size; found = find(text, size, pos)) {
+            out.write(text + pos, found - pos);
+            out.write(replacement.data(), replacement.size());
+            pos = found + m;
+        }
+        // A match can still start in the last m - 1 bytes
+        size_t end = size;
+        if (more && size - pos >= m)
+            end = size - (m - 1);
+        else if (more)
+            end = pos;
+        out.write(text + pos, end - pos);
+        kept = size - end;
+        std::memmove(&buffer[0], text + end, kept);
+        if (!out)
+            return false;
+    }
+    out.flush();
+    return static_cast<bool>(out);
+}
+
+// writev until every byte of the iovecs is out, moving past the ones a
+// short write finished
+static bool writeAll(int fd, struct iovec* iov, int count) {
+    while (count > 0) {
+        ssize_t written = writev(fd, iov, count);
+        if (written < 0 && errno == EINTR)
+            continue;
+        if (written < 0)
+            return false;
+        size_t done = static_cast<size_t>(written);
+        while (count > 0 && done >= iov->iov_len) {
+            done -= iov->iov_len;
+            iov++;
+            count--;
+        }
+        if (count > 0) {
+            iov->iov_base = static_cast<char*>(iov->iov_base) + done;
+            iov->iov_len -= done;
+        }
+    }
+    return true;
+}
+
+size_t Replacer::findMapped(const char* text, size_t size, size_t from, size_t stop) const {
+    size_t m = pattern.size();
+    if (size < m)
+        return stop;
+    size_t limit = size - m + 1 < stop ? size - m + 1 : stop;
+    while (from < limit) {
+        const void* hit = std::memchr(text + from, pattern[0], limit - from);
+        if (!hit)
+            break;
+        size_t found = static_cast<const char*>(hit) - text;
+        if (std::memcmp(text + found + 1, pattern.data() + 1, m - 1) == 0)
+            return found;
+        from = found + 1;
+    }
+    return stop;
+}
+
+// Chunks of a window, their matches kept as offsets from the chunk
+struct Replacer::ChunkJob {
+    const Replacer* replacer;
+    const char* text;
+    size_t size;
+    size_t base;
+    std::vector<std::vector<unsigned int> >* matches;
+
+    void operator()(size_t first, size_t last) const {
+        size_t m = replacer->pattern.size();
+        for (size_t c = first; c < last; c++) {
+            size_t begin = base + c * CHUNK_SIZE;
+            size_t end = size - begin < CHUNK_SIZE ? size : begin + CHUNK_SIZE;
+            std::vector<unsigned int>& list = (*matches)[c];
+            list.clear();
+            for (size_t found = replacer->findMapped(text, size, begin, end); found < end;
+                 found = replacer->findMapped(text, size, found + m, end))
+                list.push_back(static_cast<unsigned int>(found - begin));
+        }
+    }
+};
+
+// Queue the span up to a match at found and the replacement, writing the
+// queue out when it is full
+static bool addMatch(int out, std::vector<struct iovec>& iov, const char* text, size_t& pos, size_t found,
+                     const std::string& pattern, const std::string& replacement) {
+    struct iovec span = { const_cast<char*>(text + pos), found - pos };
+    struct iovec with = { const_cast<char*>(replacement.data()), replacement.size() };
+    iov.push_back(span);
+    iov.push_back(with);
+    pos = found + pattern.size();
+    if (iov.size() + 2 <= IOV_MAX)
+        return true;
+    bool ok = writeAll(out, &iov[0], static_cast<int>(iov.size()));
+    iov.clear();
+    return ok;
+}
+
+bool Replacer::runMapped(int in, size_t size, int out) const {
+    if (size == 0)
+        return true;
+    void* mapping = mmap(NULL, size, PROT_READ, MAP_PRIVATE, in, 0);
+    if (mapping == MAP_FAILED)
+        return false;
+    madvise(mapping, size, MADV_SEQUENTIAL);
+    const char* text = static_cast<const char*>(mapping);
+    ThreadPool& pool = ThreadPool::shared();
+    size_t perWindow = 2 * (pool.size() ? pool.size() : 1);
+    std::vector<std::vector<unsigned int> > matches(perWindow);
+    std::vector<struct iovec> iov;
+    iov.reserve(IOV_MAX);
+    bool ok = true;
+    size_t pos = 0;    // the end of the last match
+    for (size_t base = 0; ok && base < size; base += perWindow * CHUNK_SIZE) {
+        size_t left = size - base;
+        size_t chunks = left / CHUNK_SIZE < perWindow ? (left - 1) / CHUNK_SIZE + 1 : perWindow;
+        ChunkJob job = { this, text, size, base, &matches };
+        pool.parallelFor(0, chunks, 1, job);
+        for (size_t c = 0; ok && c < chunks; c++) {
+            size_t begin = base + c * CHUNK_SIZE;
+            size_t end = size - begin < CHUNK_SIZE ? size : begin + CHUNK_SIZE;
+            const std::vector<unsigned int>& list = matches[c];
+            size_t i = 0;
+            // The last match ran into this chunk; once the search from its
+            // end finds one of the chunk's matches, the rest agree too
+            while (ok && pos > begin) {
+                size_t found = findMapped(text, size, pos, end);
+                while (i < list.size() && begin + list[i] < found)
+                    i++;
+                if (found == end) {
+                    i = list.size();
+                    break;
+                }
+                if (i < list.size() && begin + list[i] == found)
+                    break;
+                ok = addMatch(out, iov, text, pos, found, pattern, replacement);
+            }
+            for (; ok && i < list.size(); i++)
+                ok = addMatch(out, iov, text, pos, begin + list[i], pattern, replacement);
+        }
+    }
+    struct iovec rest = { const_cast<char*>(text + pos), size - pos };
+    iov.push_back(rest);
+    if (ok)
+        ok = writeAll(out, &iov[0], static_cast<int>(iov.size()));
+    munmap(mapping, size);
+    return ok;
+}
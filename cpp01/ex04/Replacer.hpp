@@ -0,0 +1,59 @@
+#ifndef REPLACER_HPP
+#define REPLACER_HPP
+
+#include <string>
+#include <istream>
+#include <ostream>
+#include <cstddef>
+
+// Replaces every occurrence of s1 with s2 in a stream, left to right and
+// without overlaps, as std::string::find would find them. The input is
+// read in blocks of BLOCK_SIZE and searched with Boyer-Moore-Horspool; the
+// last s1.size() - 1 bytes of a block that could start a match are kept
+// for the next one, so a match across two blocks, or across a line break,
+// is found, and the bytes between matches are written as they are, in
+// spans as large as the block
+class Replacer {
+private:
+    std::string pattern;
+    std::string replacement;
+    size_t skip[256];
+
+    // Finds the matches of one chunk of a mapped file, on a pool thread
+    struct ChunkJob;
+
+    Replacer();
+
+    // The first match starting in text[from..stop) of a text of size
+    // bytes, where it may end past stop, or stop if there is none
+    size_t findMapped(const char* text, size_t size, size_t from, size_t stop) const;
+
+public:
+    static const size_t BLOCK_SIZE = 1 << 20;
+    static const size_t CHUNK_SIZE = 1 << 20;
+
+    // s1 must not be empty
+    Replacer(const std::string& s1, const std::string& s2);
+    Replacer(const Replacer& other);
+    ~Replacer();
+    Replacer& operator=(const Replacer& other);
+
+    // The first match in text[from..length), or length if there is none
+    size_t find(const char* text, size_t length, size_t from) const;
+    // Copy in to out with the replacements; false on a read or write error
+    bool run(std::istream& in, std::ostream& out) const;
+    // The same for size bytes of a regular file, mapped into memory
+    // instead of read: candidates are found with memchr on the first byte
+    // of s1, then checked, and the output is sent with writev as the spans
+    // of the mapping between matches and the replacement, so the file is
+    // never copied into a buffer of ours.
+    // The search runs on ThreadPool::shared(), a window of two chunks of
+    // CHUNK_SIZE per thread at a time, each chunk searched on its own from
+    // its first byte; a match may run past the end of its chunk. Where the
+    // last match of a chunk ends inside the next one, the next chunk is
+    // searched again from there until it meets one of its own matches, so
+    // the matches are the ones a single search from the start would find
+    bool runMapped(int in, size_t size, int out) const;
+};
+
+#endif
\ No newline at end of file
@@ -1,43 +1,103 @@
 #include <iostream>
 #include <fstream>
 #include <string>
+#include "Replacer.hpp"
+#include "MultiReplacer.hpp"
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
 
+// A regular file is mapped and written with writev; anything else, such
+// as a pipe, is streamed
 void replaceInFile(const std::string& filename, const std::string& s1, const std::string& s2) {
-    std::ifstream input(filename.c_str());
+    Replacer replacer(s1, s2);
+    struct stat st;
+    int fd = -1;
+    if (stat(filename.c_str(), &st) == 0 && S_ISREG(st.st_mode))
+        fd = open(filename.c_str(), O_RDONLY);
+    if (fd >= 0 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode)) {
+        int out = open((filename + ".replace").c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (out < 0)
+            std::cerr << "Error: could not create output file" << std::endl;
+        else if (!replacer.runMapped(fd, static_cast<size_t>(st.st_size), out))
+            std::cerr << "Error: could not copy the file" << std::endl;
+        if (out >= 0)
+            close(out);
+        close(fd);
+        return;
+    }
+    if (fd >= 0)
+        close(fd);
+
+    std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
     if (!input) {
         std::cerr << "Error: could not open input file" << std::endl;
         return;
     }
 
-    std::ofstream output((filename + ".replace").c_str());
+    std::ofstream output((filename + ".replace").c_str(), std::ios::out | std::ios::binary);
     if (!output) {
         std::cerr << "Error: could not create output file" << std::endl;
         return;
     }
 
+    if (!replacer.run(input, output))
+        std::cerr << "Error: could not copy the file" << std::endl;
+}
+
+// One rule per line, s1 and s2 separated by a tab; empty lines are
+// skipped
+bool loadRules(const std::string& path, MultiReplacer& replacer) {
+    std::ifstream rules(path.c_str());
+    if (!rules) {
+        std::cerr << "Error: could not open rules file" << std::endl;
+        return false;
+    }
     std::string line;
-    while (std::getline(input, line)) {
-        std::string newline;
-        size_t pos = 0;
-        while (pos < line.length()) {
-            size_t found = line.find(s1, pos);
-            if (found == std::string::npos) {
-                newline += line.substr(pos);
-                break;
-            }
-            newline += line.substr(pos, found - pos);
-            newline += s2;
-            pos = found + s1.length();
+    for (size_t number = 1; std::getline(rules, line); number++) {
+        if (line.empty())
+            continue;
+        size_t tab = line.find('\t');
+        if (tab == std::string::npos || tab == 0) {
+            std::cerr << "Error: rules file line " << number << ": expected <s1><tab><s2>" << std::endl;
+            return false;
         }
-        output << newline << std::endl;
+        replacer.addRule(line.substr(0, tab), line.substr(tab + 1));
     }
+    replacer.compile();
+    return true;
+}
+
+void replaceAllInFile(const std::string& filename, const MultiReplacer& replacer) {
+    std::ifstream input(filename.c_str(), std::ios::in | std::ios::binary);
+    if (!input) {
+        std::cerr << "Error: could not open input file" << std::endl;
+        return;
+    }
+
+    std::ofstream output((filename + ".replace").c_str(), std::ios::out | std::ios::binary);
+    if (!output) {
+        std::cerr << "Error: could not create output file" << std::endl;
+        return;
+    }
+
+    if (!replacer.run(input, output))
+        std::cerr << "Error: could not copy the file" << std::endl;
 }
 
 int main(int argc, char* argv[]) {
     if (argc != 4) {
         std::cerr << "Usage: " << argv[0] << " <filename> <s1> <s2>" << std::endl;
+        std::cerr << "       " << argv[0] << " -f <rules> <filename>" << std::endl;
         return 1;
     }
+    if (std::string(argv[1]) == "-f") {
+        MultiReplacer replacer;
+        if (!loadRules(argv[2], replacer))
+            return 1;
+        replaceAllInFile(argv[3], replacer);
+        return 0;
+    }
     if (std::string(argv[2]).empty()) {
         std::cerr << "Error: s1 must not be empty" << std::endl;
         return 1;
@@ -1,31 +1,103 @@
 #include "Harl.hpp"
+#include "HarlBuffer.hpp"
 #include <iostream>
 
+const char* const Harl::_messages[LEVEL_INVALID] = {
+    "[ DEBUG ]\nI love having extra bacon for my TXL-double-cheese-triple-pickle-special-ketchup burger. I really do!\n",
+    "[ INFO ]\nI cannot believe adding extra bacon costs more money. You didn't put enough bacon in my burger! If you did, I wouldn't be asking for more!\n",
+    "[ WARNING ]\nI think I deserve to have some extra bacon for free. I've been coming for years, whereas you started working here just last month.\n",
+    "[ ERROR ]\nThis is unacceptable! I want to speak to the manager now.\n"
+};
+
 void Harl::debug() {
-    std::cout << "[ DEBUG ]\nI love having extra bacon for my TXL-double-cheese-triple-pickle-special-ketchup burger. I really do!\n" << std::endl;
+    std::cout << _messages[LEVEL_DEBUG] << std::endl;
 }
 
 void Harl::info() {
-    std::cout << "[ INFO ]\nI cannot believe adding extra bacon costs more money. You didn't put enough bacon in my burger! If you did, I wouldn't be asking for more!\n" << std::endl;
+    std::cout << _messages[LEVEL_INFO] << std::endl;
 }
 
 void Harl::warning() {
-    std::cout << "[ WARNING ]\nI think I deserve to have some extra bacon for free. I've been coming for years, whereas you started working here just last month.\n" << std::endl;
+    std::cout << _messages[LEVEL_WARNING] << std::endl;
 }
 
 void Harl::error() {
-    std::cout << "[ ERROR ]\nThis is unacceptable! I want to speak to the manager now.\n" << std::endl;
+    std::cout << _messages[LEVEL_ERROR] << std::endl;
+}
+
+void Harl::insignificant() {
+    std::cout << "[ Probably complaining about insignificant problems ]" << std::endl;
+}
+
+void (Harl::* const Harl::_complaints[LEVEL_INVALID])() = {
+    &Harl::debug, &Harl::info, &Harl::warning, &Harl::error
+};
+
+Harl::Harl(Level threshold) : _threshold(threshold), _buffer(NULL) {}
+
+void Harl::setThreshold(Level threshold) {
+    _threshold = threshold;
+}
+
+Harl::Level Harl::getThreshold() const {
+    return _threshold;
+}
+
+void Harl::setBuffer(HarlBuffer* buffer) {
+    _buffer = buffer;
+}
+
+const char* Harl::message(Level level) {
+    return level < LEVEL_INVALID ? _messages[level] : "";
+}
+
+Harl::Level Harl::parseLevel(const std::string& level) {
+    switch (level.size()) {
+        case 4:
+            return level == "INFO" ? LEVEL_INFO : LEVEL_INVALID;
+        case 5:
+            if (level[0] == 'D')
+                return level == "DEBUG" ? LEVEL_DEBUG : LEVEL_INVALID;
+            return level == "ERROR" ? LEVEL_ERROR : LEVEL_INVALID;
+        case 7:
+            return level == "WARNING" ? LEVEL_WARNING : LEVEL_INVALID;
+        default:
+            return LEVEL_INVALID;
+    }
+}
+
+const char* Harl::levelName(Level level) {
+    static const char* const names[LEVEL_INVALID + 1] = {"DEBUG", "INFO", "WARNING", "ERROR", "INVALID"};
+    return names[level < LEVEL_INVALID ? level : LEVEL_INVALID];
 }
 
 void Harl::complain(std::string level) {
-    void (Harl::*funcs[4])() = {&Harl::debug, &Harl::info, &Harl::warning, &Harl::error};
-    std::string levels[4] = {"DEBUG", "INFO", "WARNING", "ERROR"};
-    
-    for (int i = 0; i < 4; i++) {
-        if (level == levels[i]) {
-            (this->*funcs[i])();
-            return;
-        }
+    Level parsed = parseLevel(level);
+    if (parsed == LEVEL_INVALID) {
+        insignificant();
+        return;
     }
-    std::cout << "[ Probably complaining about insignificant problems ]" << std::endl;
+    complain(parsed);
+}
+
+void Harl::complain(Level level) {
+    if (level < _threshold)
+        return;
+    if (level >= LEVEL_INVALID) {
+        insignificant();
+        return;
+    }
+    dispatch(level);
+}
+
+void Harl::dispatch(Level level) {
+    if (_buffer)
+        _buffer->push(level);
+    else
+        (this->*_complaints[level])();
+}
+
+void Harl::complainFrom(Level level) {
+    for (int i = level; i < LEVEL_INVALID; i++)
+        complain(static_cast<Level>(i));
 }
\ No newline at end of file
@@ -3,14 +3,62 @@
 
 #include <string>
 
+class HarlBuffer;
+
 class Harl {
+public:
+    enum Level {
+        LEVEL_DEBUG,
+        LEVEL_INFO,
+        LEVEL_WARNING,
+        LEVEL_ERROR,
+        LEVEL_INVALID
+    };
+
 private:
+    Level _threshold;
+    HarlBuffer* _buffer;
+
+    // The complaint of each level, in the order of Level
+    static void (Harl::* const _complaints[LEVEL_INVALID])();
+    static const char* const _messages[LEVEL_INVALID];
+
     void debug();
     void info();
     void warning();
     void error();
+    void insignificant();
+    void dispatch(Level level);
 public:
+    // Complaints below threshold are not made; by default none is dropped
+    Harl(Level threshold = LEVEL_DEBUG);
+
+    void setThreshold(Level threshold);
+    Level getThreshold() const;
+
+    // Parsed once per call into a Level: a name with a different length or
+    // first letter is rejected without comparing the rest
+    static Level parseLevel(const std::string& level);
+    static const char* levelName(Level level);
+    // What the complaint of a level prints, before its final newline
+    static const char* message(Level level);
+
+    // While a buffer is set, complaints are queued in it as records and
+    // only printed when it is flushed; NULL, the default, prints them
+    void setBuffer(HarlBuffer* buffer);
+
     void complain(std::string level);
+    // The same with the level already parsed: below the threshold, the
+    // call is one comparison
+    void complain(Level level);
+    // For a level known when compiling: complain<Harl::LEVEL_ERROR>()
+    template <Level L>
+    void complain() {
+        if (L >= _threshold)
+            dispatch(L);
+    }
+    // The complaint of level and of every level above it
+    void complainFrom(Level level);
 };
 
 #endif
\ No newline at end of file
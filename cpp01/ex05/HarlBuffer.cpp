@@ -0,0 +1,110 @@
+#include "HarlBuffer.hpp"
+#include "HarlWriter.hpp"
+#include <ctime>
+#include <sched.h>
+
+static unsigned long long now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<unsigned long long>(ts.tv_sec) * 1000000000ULL + ts.tv_nsec;
+}
+
+HarlBuffer::HarlBuffer(size_t capacity, std::ostream& out) : mask(0), head(0), tail(0), out(&out), writer(NULL) {
+    init(capacity);
+}
+
+HarlBuffer::HarlBuffer(size_t capacity, HarlWriter& writer)
+    : mask(0), head(0), tail(0), out(NULL), writer(&writer) {
+    init(capacity);
+    writer.attach(this);
+}
+
+HarlBuffer::HarlBuffer(const HarlBuffer& other) : mask(0), head(0), tail(0), out(other.out), writer(NULL) {
+}
+
+HarlBuffer& HarlBuffer::operator=(const HarlBuffer& other) {
+    (void)other;
+    return *this;
+}
+
+HarlBuffer::~HarlBuffer() {
+    flush();
+    if (writer)
+        writer->detach(this);
+}
+
+void HarlBuffer::init(size_t capacity) {
+    size_t size = 1;
+    while (size < capacity)
+        size <<= 1;
+    records.resize(size);
+    mask = size - 1;
+}
+
+// head and tail are each written by one thread and read by the other, so
+// every access to them is atomic
+size_t HarlBuffer::load(const volatile size_t& n) {
+    return __sync_fetch_and_add(const_cast<volatile size_t*>(&n), 0);
+}
+
+void HarlBuffer::push(Harl::Level level) {
+    if (size() == records.size()) {
+        if (!writer)
+            flush();
+        else {
+            writer->signal();
+            while (size() == records.size())
+                sched_yield();
+        }
+    }
+    Record& record = records[load(tail) & mask];
+    record.timestamp = now();
+    record.messageId = static_cast<unsigned int>(level);
+    record.level = level;
+    __sync_fetch_and_add(&tail, 1);
+}
+
+// Each complaint prints its message and a newline, as Harl does
+size_t HarlBuffer::format(std::string& text) const {
+    size_t first = load(head);
+    size_t last = load(tail);
+    for (size_t i = first; i != last; i++) {
+        text += Harl::message(records[i & mask].level);
+        text += '\n';
+    }
+    return last - first;
+}
+
+void HarlBuffer::release(size_t count) {
+    __sync_fetch_and_add(&head, count);
+}
+
+size_t HarlBuffer::flush() {
+    size_t count = size();
+    if (count == 0)
+        return 0;
+    if (writer) {
+        writer->signal();
+        while (size() != 0)
+            sched_yield();
+        return count;
+    }
+    std::string text;
+    format(text);
+    out->write(text.data(), text.size());
+    out->flush();
+    release(count);
+    return count;
+}
+
+size_t HarlBuffer::size() const {
+    return load(tail) - load(head);
+}
+
+size_t HarlBuffer::capacity() const {
+    return records.size();
+}
+
+const HarlBuffer::Record& HarlBuffer::operator[](size_t i) const {
+    return records[(load(head) + i) & mask];
+}
@@ -0,0 +1,67 @@
+#ifndef HARLBUFFER_HPP
+#define HARLBUFFER_HPP
+
+#include "Harl.hpp"
+#include <vector>
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+class HarlWriter;
+
+// A ring of complaint records that a Harl queues into instead of printing:
+// pushing stores the level, its message id and a monotonic timestamp, a
+// few words and no formatting, and the records are later formatted into
+// one buffer and written to the stream in one call.
+// A buffer made with a stream is flushed by its owner; a full ring is
+// flushed before the next push, and whatever is left is flushed when the
+// buffer is destroyed. A buffer made with a HarlWriter is drained by the
+// writer's thread instead: it is a single-producer ring, so one thread
+// pushes into it with no lock, and a push into a full ring waits for the
+// writer to catch up. Give each logging thread its own buffer
+class HarlBuffer {
+public:
+    struct Record {
+        unsigned long long timestamp;   // nanoseconds, CLOCK_MONOTONIC
+        unsigned int messageId;
+        Harl::Level level;
+    };
+
+private:
+    std::vector<Record> records;
+    size_t mask;
+    volatile size_t head;   // next record to flush
+    volatile size_t tail;   // next free slot; head == tail when empty
+    std::ostream* out;
+    HarlWriter* writer;
+
+    HarlBuffer(const HarlBuffer& other);
+    HarlBuffer& operator=(const HarlBuffer& other);
+
+    void init(size_t capacity);
+    static size_t load(const volatile size_t& n);
+
+    // The consumer side: append the queued records to text and return how
+    // many, then free that many once they are written
+    friend class HarlWriter;
+    size_t format(std::string& text) const;
+    void release(size_t count);
+
+public:
+    // capacity is rounded up to a power of two
+    HarlBuffer(size_t capacity, std::ostream& out);
+    HarlBuffer(size_t capacity, HarlWriter& writer);
+    ~HarlBuffer();
+
+    void push(Harl::Level level);
+    // Write the queued complaints, oldest first; returns how many. With a
+    // writer, returns once its thread has written them
+    size_t flush();
+
+    size_t size() const;
+    size_t capacity() const;
+    // The i-th queued record, oldest first; without a writer only
+    const Record& operator[](size_t i) const;
+};
+
+#endif
@@ -0,0 +1,107 @@
+#include "HarlWriter.hpp"
+#include "HarlBuffer.hpp"
+#include <string>
+#include <ctime>
+#include <sys/time.h>
+
+HarlWriter::HarlWriter(std::ostream& out) : out(out), stop(false), started(false) {
+    pthread_mutex_init(&lock, NULL);
+    pthread_cond_init(&wake, NULL);
+    started = pthread_create(&thread, NULL, main, this) == 0;
+}
+
+HarlWriter::HarlWriter(const HarlWriter& other) : out(other.out), stop(false), started(false) {
+}
+
+HarlWriter& HarlWriter::operator=(const HarlWriter& other) {
+    (void)other;
+    return *this;
+}
+
+HarlWriter::~HarlWriter() {
+    pthread_mutex_lock(&lock);
+    stop = true;
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&lock);
+    if (started)
+        pthread_join(thread, NULL);
+    drain();
+    pthread_cond_destroy(&wake);
+    pthread_mutex_destroy(&lock);
+}
+
+bool HarlWriter::isRunning() const {
+    return started;
+}
+
+// Sleep a millisecond between batches unless woken or stopped
+void* HarlWriter::main(void* arg) {
+    HarlWriter* self = static_cast<HarlWriter*>(arg);
+    for (;;) {
+        self->drain();
+        pthread_mutex_lock(&self->lock);
+        if (self->stop) {
+            pthread_mutex_unlock(&self->lock);
+            return NULL;
+        }
+        struct timeval tv;
+        gettimeofday(&tv, NULL);
+        struct timespec until;
+        until.tv_sec = tv.tv_sec;
+        until.tv_nsec = tv.tv_usec * 1000L + 1000000L;
+        if (until.tv_nsec >= 1000000000L) {
+            until.tv_sec++;
+            until.tv_nsec -= 1000000000L;
+        }
+        pthread_cond_timedwait(&self->wake, &self->lock, &until);
+        pthread_mutex_unlock(&self->lock);
+    }
+}
+
+// The records are released to their producers only once written, so a
+// buffer whose queue is empty has reached the stream
+size_t HarlWriter::drain() {
+    pthread_mutex_lock(&lock);
+    std::string text;
+    std::vector<size_t> taken(buffers.size());
+    size_t total = 0;
+    for (size_t b = 0; b < buffers.size(); b++) {
+        taken[b] = buffers[b]->format(text);
+        total += taken[b];
+    }
+    if (total) {
+        out.write(text.data(), text.size());
+        out.flush();
+        for (size_t b = 0; b < buffers.size(); b++)
+            buffers[b]->release(taken[b]);
+    }
+    pthread_mutex_unlock(&lock);
+    return total;
+}
+
+void HarlWriter::attach(HarlBuffer* buffer) {
+    pthread_mutex_lock(&lock);
+    buffers.push_back(buffer);
+    pthread_mutex_unlock(&lock);
+}
+
+void HarlWriter::detach(HarlBuffer* buffer) {
+    pthread_mutex_lock(&lock);
+    for (size_t b = 0; b < buffers.size(); b++) {
+        if (buffers[b] == buffer) {
+            buffers.erase(buffers.begin() + b);
+            break;
+        }
+    }
+    pthread_mutex_unlock(&lock);
+}
+
+void HarlWriter::signal() {
+    if (!started) {
+        drain();
+        return;
+    }
+    pthread_mutex_lock(&lock);
+    pthread_cond_signal(&wake);
+    pthread_mutex_unlock(&lock);
+}
@@ -0,0 +1,50 @@
+#ifndef HARLWRITER_HPP
+#define HARLWRITER_HPP
+
+#include <vector>
+#include <ostream>
+#include <pthread.h>
+
+class HarlBuffer;
+
+// The background thread of HarlBuffers that are attached to it: every
+// millisecond, or at once when a buffer asks, it takes the records
+// queued in each buffer, formats them all into one string and writes it
+// to the stream in one call. Each buffer has a single producer thread
+// and this one consumer, so pushing takes no lock; the lock here only
+// guards the list of buffers. Nothing else may write to the stream while
+// the writer runs, and its buffers must be destroyed before it. The
+// destructor writes what is still queued
+class HarlWriter {
+private:
+    std::vector<HarlBuffer*> buffers;
+    std::ostream& out;
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    bool stop;
+    bool started;
+    pthread_t thread;
+
+    HarlWriter();
+    HarlWriter(const HarlWriter& other);
+    HarlWriter& operator=(const HarlWriter& other);
+
+    static void* main(void* arg);
+    // Write what every buffer holds; returns how many records
+    size_t drain();
+
+    friend class HarlBuffer;
+    void attach(HarlBuffer* buffer);
+    void detach(HarlBuffer* buffer);
+    void signal();
+
+public:
+    explicit HarlWriter(std::ostream& out);
+    ~HarlWriter();
+
+    // Whether the thread runs; if it could not be started, buffers drain
+    // on the thread that flushes them
+    bool isRunning() const;
+};
+
+#endif
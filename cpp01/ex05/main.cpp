@@ -1,4 +1,20 @@
 #include "Harl.hpp"
+#include "HarlBuffer.hpp"
+#include "HarlWriter.hpp"
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// A logging thread: its own Harl and its own buffer on the shared writer
+static void* complainOften(void* arg) {
+    HarlWriter* writer = static_cast<HarlWriter*>(arg);
+    HarlBuffer buffer(256, *writer);
+    Harl harl(Harl::LEVEL_INFO);
+    harl.setBuffer(&buffer);
+    for (int i = 0; i < 1000; i++)
+        harl.complain(static_cast<Harl::Level>(i % Harl::LEVEL_INVALID));
+    return NULL;
+}
 
 int main() {
     Harl harl;
@@ -9,5 +25,35 @@ int main() {
     harl.complain("ERROR");
     harl.complain("UNKNOWN");
     
+    Harl filtered(Harl::LEVEL_WARNING);
+    filtered.complain<Harl::LEVEL_DEBUG>();
+    filtered.complain<Harl::LEVEL_ERROR>();
+    filtered.setThreshold(Harl::LEVEL_DEBUG);
+    filtered.complainFrom(Harl::parseLevel("WARNING"));
+    
+    HarlBuffer buffer(64, std::cout);
+    filtered.setBuffer(&buffer);
+    filtered.complain("INFO");
+    filtered.complain<Harl::LEVEL_ERROR>();
+    std::cout << "--- " << buffer.size() << " complaints queued, flushing ---" << std::endl;
+    buffer.flush();
+    filtered.setBuffer(NULL);
+    
+    std::ostringstream log;
+    {
+        HarlWriter writer(log);
+        pthread_t threads[4];
+        for (int t = 0; t < 4; t++)
+            pthread_create(&threads[t], NULL, complainOften, &writer);
+        for (int t = 0; t < 4; t++)
+            pthread_join(threads[t], NULL);
+    }
+    std::string text = log.str();
+    size_t errors = 0;
+    for (size_t at = text.find("[ ERROR ]"); at != std::string::npos; at = text.find("[ ERROR ]", at + 1))
+        errors++;
+    std::cout << "--- 4 threads through the writer: " << text.size() << " bytes, " << errors
+              << " errors ---" << std::endl;
+    
     return 0;
 }
\ No newline at end of file
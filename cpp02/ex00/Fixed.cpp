@@ -1,29 +1,30 @@
 #include "Fixed.hpp"
+#include "Log.hpp"
 #include <iostream>
 
 Fixed::Fixed() : _value(0) {
-    std::cout << "Default constructor called" << std::endl;
+    LOG_LIFECYCLE("Default constructor called");
 }
 
 Fixed::Fixed(const Fixed& other) {
-    std::cout << "Copy constructor called" << std::endl;
+    LOG_LIFECYCLE("Copy constructor called");
     *this = other;
 }
 
 Fixed& Fixed::operator=(const Fixed& other) {
-    std::cout << "Copy assignment operator called" << std::endl;
+    LOG_LIFECYCLE("Copy assignment operator called");
     if (this != &other) {
-        this->_value = other.getRawBits();
+        this->_value = other._value;
     }
     return *this;
 }
 
 Fixed::~Fixed() {
-    std::cout << "Destructor called" << std::endl;
+    LOG_LIFECYCLE("Destructor called");
 }
 
 int Fixed::getRawBits(void) const {
-    std::cout << "getRawBits member function called" << std::endl;
+    LOG_LIFECYCLE("getRawBits member function called");
     return this->_value;
 }
 
@@ -1,34 +1,35 @@
 #include "Fixed.hpp"
+#include "Log.hpp"
 #include <cmath>
 #include <iostream>
 
 Fixed::Fixed() : _value(0) {
-    std::cout << "Default constructor called" << std::endl;
+    LOG_LIFECYCLE("Default constructor called");
 }
 
 Fixed::Fixed(const int value) : _value(value << _fractionalBits) {
-    std::cout << "Int constructor called" << std::endl;
+    LOG_LIFECYCLE("Int constructor called");
 }
 
 Fixed::Fixed(const float value) : _value(roundf(value * (1 << _fractionalBits))) {
-    std::cout << "Float constructor called" << std::endl;
+    LOG_LIFECYCLE("Float constructor called");
 }
 
 Fixed::Fixed(const Fixed& other) {
-    std::cout << "Copy constructor called" << std::endl;
+    LOG_LIFECYCLE("Copy constructor called");
     *this = other;
 }
 
 Fixed& Fixed::operator=(const Fixed& other) {
-    std::cout << "Copy assignment operator called" << std::endl;
+    LOG_LIFECYCLE("Copy assignment operator called");
     if (this != &other) {
-        this->_value = other.getRawBits();
+        this->_value = other._value;
     }
     return *this;
 }
 
 Fixed::~Fixed() {
-    std::cout << "Destructor called" << std::endl;
+    LOG_LIFECYCLE("Destructor called");
 }
 
 int Fixed::getRawBits(void) const {
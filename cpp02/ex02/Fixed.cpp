@@ -1,31 +1,33 @@
 #include "Fixed.hpp"
+#include "Log.hpp"
 #include <cmath>
+#include <climits>
 #include <iostream>
 
 
 Fixed::Fixed() : _value(0) {
-    std::cout << "Default constructor called" << std::endl;
+    LOG_LIFECYCLE("Default constructor called");
 }
 
 Fixed::Fixed(const Fixed& other) {
-    std::cout << "Copy constructor called" << std::endl;
+    LOG_LIFECYCLE("Copy constructor called");
     *this = other;
 }
 
 Fixed& Fixed::operator=(const Fixed& other) {
-    std::cout << "Copy assignment operator called" << std::endl;
+    LOG_LIFECYCLE("Copy assignment operator called");
     if (this != &other) {
-        this->_value = other.getRawBits();
+        this->_value = other._value;
     }
     return *this;
 }
 
 Fixed::~Fixed() {
-    std::cout << "Destructor called" << std::endl;
+    LOG_LIFECYCLE("Destructor called");
 }
 
 int Fixed::getRawBits(void) const {
-    std::cout << "getRawBits member function called" << std::endl;
+    LOG_LIFECYCLE("getRawBits member function called");
     return this->_value;
 }
 
@@ -50,6 +52,80 @@ int Fixed::toInt(void) const {
     return this->_value >> _fractionalBits;
 }
 
+// 1 / 256 is 390625 / 10^8, so the fraction of a Fixed is its low bits
+// times 390625, as exactly 8 decimal digits
+size_t Fixed::format(char* buffer) const {
+    char* p = buffer;
+    long long magnitude = _value;
+    if (magnitude < 0) {
+        *p++ = '-';
+        magnitude = -magnitude;
+    }
+    unsigned int whole = static_cast<unsigned int>(magnitude >> _fractionalBits);
+    unsigned int fraction = static_cast<unsigned int>(magnitude & ((1 << _fractionalBits) - 1)) * 390625u;
+    char digits[10];
+    int count = 0;
+    do {
+        digits[count++] = static_cast<char>('0' + whole % 10);
+        whole /= 10;
+    } while (whole);
+    while (count)
+        *p++ = digits[--count];
+    if (fraction) {
+        *p++ = '.';
+        for (unsigned int scale = 10000000u; fraction; scale /= 10) {
+            *p++ = static_cast<char>('0' + fraction / scale);
+            fraction %= scale;
+        }
+    }
+    *p = '\0';
+    return p - buffer;
+}
+
+std::string Fixed::toString(void) const {
+    char buffer[FORMAT_SIZE];
+    return std::string(buffer, format(buffer));
+}
+
+// Only the first 9 fractional digits are needed: rounding x * 256 half
+// up lands on the same integer for any digits after them, as the value
+// of 9 digits times 256, plus one half, is a multiple of 256 / 10^9
+bool Fixed::tryParse(const char* text, size_t length, Fixed& result) {
+    size_t i = 0;
+    bool negative = false;
+    if (i < length && (text[i] == '-' || text[i] == '+'))
+        negative = text[i++] == '-';
+    long long whole = 0;
+    size_t digits = 0;
+    for (; i < length && text[i] >= '0' && text[i] <= '9'; i++, digits++) {
+        whole = whole * 10 + (text[i] - '0');
+        if (whole > (1LL << (31 - _fractionalBits)))
+            return false;
+    }
+    long long fraction = 0;
+    long long scale = 1;
+    if (i < length && text[i] == '.') {
+        for (i++; i < length && text[i] >= '0' && text[i] <= '9'; i++, digits++) {
+            if (scale < 1000000000LL) {
+                fraction = fraction * 10 + (text[i] - '0');
+                scale *= 10;
+            }
+        }
+    }
+    if (i != length || digits == 0)
+        return false;
+    long long magnitude = (whole << _fractionalBits)
+        + ((fraction << _fractionalBits) + scale / 2) / scale;
+    if (magnitude > (negative ? -static_cast<long long>(INT_MIN) : INT_MAX))
+        return false;
+    result._value = static_cast<int>(negative ? -magnitude : magnitude);
+    return true;
+}
+
+bool Fixed::tryParse(const std::string& text, Fixed& result) {
+    return tryParse(text.data(), text.size(), result);
+}
+
 std::ostream& operator<<(std::ostream& out, const Fixed& fixed) {
     out << fixed.toFloat();
     return out;
@@ -98,6 +174,64 @@ Fixed Fixed::operator/(const Fixed& other) const {
 }
 
 
+// The helpers below use conditional expressions on plain integers, which
+// compile to conditional moves rather than branches
+
+static long long roundedProduct(int a, int b, int fractionalBits) {
+    long long product = static_cast<long long>(a) * b;
+    return (product + (1LL << (fractionalBits - 1))) >> fractionalBits;
+}
+
+static long long truncatedQuotient(int a, int b, int fractionalBits) {
+    long long divisor = b ? b : 1;
+    return (static_cast<long long>(a) * (1LL << fractionalBits)) / divisor;
+}
+
+static int clampToInt(long long value) {
+    value = value > INT_MAX ? INT_MAX : value;
+    value = value < INT_MIN ? INT_MIN : value;
+    return static_cast<int>(value);
+}
+
+static bool fitsInt(long long value) {
+    return (value >= INT_MIN) & (value <= INT_MAX);
+}
+
+Fixed Fixed::mulSaturated(const Fixed& other) const {
+    Fixed result;
+    result._value = clampToInt(roundedProduct(_value, other._value, _fractionalBits));
+    return result;
+}
+
+Fixed Fixed::divSaturated(const Fixed& other) const {
+    long long quotient = truncatedQuotient(_value, other._value, _fractionalBits);
+    long long overflow = _value > 0 ? INT_MAX : (_value < 0 ? INT_MIN : 0);
+    Fixed result;
+    result._value = clampToInt(other._value ? quotient : overflow);
+    return result;
+}
+
+bool Fixed::tryMul(const Fixed& other, Fixed& result) const {
+    long long product = roundedProduct(_value, other._value, _fractionalBits);
+    if (!fitsInt(product))
+        return false;
+    result._value = static_cast<int>(product);
+    return true;
+}
+
+bool Fixed::tryDiv(const Fixed& other, Fixed& result) const {
+    long long quotient = truncatedQuotient(_value, other._value, _fractionalBits);
+    if (!other._value || !fitsInt(quotient))
+        return false;
+    result._value = static_cast<int>(quotient);
+    return true;
+}
+
+long long Fixed::mulWide(const Fixed& other) const {
+    return static_cast<long long>(_value) * other._value;
+}
+
+
 Fixed& Fixed::operator++() {
     this->_value += 1;
     return *this;
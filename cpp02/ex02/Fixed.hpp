@@ -2,12 +2,16 @@
 #define FIXED_HPP
 
 #include <iostream>
+#include <string>
+#include <cstddef>
 
 class Fixed {
 private:
     int _value;
     static const int _fractionalBits = 8;
 
+    friend class FixedBatch;
+
 public:
     Fixed();
     Fixed(const int value);
@@ -22,6 +26,19 @@ public:
     float toFloat(void) const;
     int toInt(void) const;
 
+    // Decimal text, with integers only: a Fixed is always an exact
+    // decimal of at most 8 fractional digits, which format writes in full,
+    // with no trailing zero and no locale, into a buffer of FORMAT_SIZE.
+    // tryParse reads an optional sign, digits and an optional fraction,
+    // rounding to the nearest Fixed, half away from zero as the float
+    // constructor does; false, with result untouched, for anything else
+    // or a value out of range
+    static const size_t FORMAT_SIZE = 18;
+    size_t format(char* buffer) const;
+    std::string toString(void) const;
+    static bool tryParse(const char* text, size_t length, Fixed& result);
+    static bool tryParse(const std::string& text, Fixed& result);
+
     bool operator>(const Fixed& other) const;
     bool operator<(const Fixed& other) const;
     bool operator>=(const Fixed& other) const;
@@ -34,6 +51,19 @@ public:
     Fixed operator*(const Fixed& other) const;
     Fixed operator/(const Fixed& other) const;
 
+    // Products and quotients computed in 64 bits from the raw values,
+    // with no float: the saturated ones clamp to the largest or smallest
+    // Fixed, the try ones give false and leave result alone when the
+    // exact value does not fit, and mulWide is the whole product with 16
+    // fractional bits. Products round to the nearest value, half up, and
+    // quotients truncate toward zero. Dividing by zero saturates to the
+    // sign of the dividend, or gives 0 for 0, and fails for tryDiv
+    Fixed mulSaturated(const Fixed& other) const;
+    Fixed divSaturated(const Fixed& other) const;
+    bool tryMul(const Fixed& other, Fixed& result) const;
+    bool tryDiv(const Fixed& other, Fixed& result) const;
+    long long mulWide(const Fixed& other) const;
+
     Fixed& operator++();
     Fixed operator++(int);
     Fixed& operator--();
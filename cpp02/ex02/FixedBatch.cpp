@@ -0,0 +1,55 @@
+#include "FixedBatch.hpp"
+
+FixedBatch::FixedBatch() {
+}
+
+FixedBatch::FixedBatch(const FixedBatch& other) {
+    (void)other;
+}
+
+FixedBatch& FixedBatch::operator=(const FixedBatch& other) {
+    (void)other;
+    return *this;
+}
+
+FixedBatch::~FixedBatch() {
+}
+
+void FixedBatch::add(const Fixed* a, const Fixed* b, Fixed* out, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i]._value = a[i]._value + b[i]._value;
+}
+
+void FixedBatch::sub(const Fixed* a, const Fixed* b, Fixed* out, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i]._value = a[i]._value - b[i]._value;
+}
+
+void FixedBatch::mul(const Fixed* a, const Fixed* b, Fixed* out, size_t n) {
+    const long long half = 1LL << (Fixed::_fractionalBits - 1);
+    for (size_t i = 0; i < n; i++) {
+        long long product = static_cast<long long>(a[i]._value) * b[i]._value;
+        out[i]._value = static_cast<int>((product + half) >> Fixed::_fractionalBits);
+    }
+}
+
+Fixed FixedBatch::dot(const Fixed* a, const Fixed* b, size_t n) {
+    long long sum = 0;
+    for (size_t i = 0; i < n; i++)
+        sum += static_cast<long long>(a[i]._value) * b[i]._value;
+    Fixed result;
+    result._value = static_cast<int>((sum + (1LL << (Fixed::_fractionalBits - 1))) >> Fixed::_fractionalBits);
+    return result;
+}
+
+// As Fixed::min and Fixed::max, b is chosen when the values are equal,
+// which for plain ints is the same value
+void FixedBatch::min(const Fixed* a, const Fixed* b, Fixed* out, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i]._value = a[i]._value < b[i]._value ? a[i]._value : b[i]._value;
+}
+
+void FixedBatch::max(const Fixed* a, const Fixed* b, Fixed* out, size_t n) {
+    for (size_t i = 0; i < n; i++)
+        out[i]._value = a[i]._value > b[i]._value ? a[i]._value : b[i]._value;
+}
\ No newline at end of file
@@ -0,0 +1,32 @@
+#ifndef FIXEDBATCH_HPP
+#define FIXEDBATCH_HPP
+
+#include "Fixed.hpp"
+#include <cstddef>
+
+// Arithmetic on whole arrays of Fixed, working on the raw bits: each
+// kernel is one loop of integer operations over contiguous values, with
+// no temporary Fixed, no float and no branch per element, which the
+// compiler turns into SSE, AVX2 or NEON instructions at -O3. On x86,
+// mul and dot need 64-bit products, so they are only vectorized from
+// SSE4.1 on: build with -march=native, or -mavx2. out may be the same
+// array as a or b. mul rounds to the nearest value, half up, in 64 bits, and dot
+// sums the exact products and rounds once at the end
+class FixedBatch {
+private:
+    FixedBatch();
+    FixedBatch(const FixedBatch& other);
+    FixedBatch& operator=(const FixedBatch& other);
+    ~FixedBatch();
+
+public:
+    static void add(const Fixed* a, const Fixed* b, Fixed* out, size_t n);
+    static void sub(const Fixed* a, const Fixed* b, Fixed* out, size_t n);
+    static void mul(const Fixed* a, const Fixed* b, Fixed* out, size_t n);
+    static Fixed dot(const Fixed* a, const Fixed* b, size_t n);
+    // Element by element, as Fixed::min and Fixed::max
+    static void min(const Fixed* a, const Fixed* b, Fixed* out, size_t n);
+    static void max(const Fixed* a, const Fixed* b, Fixed* out, size_t n);
+};
+
+#endif
\ No newline at end of file
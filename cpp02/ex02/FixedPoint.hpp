@@ -0,0 +1,201 @@
+#ifndef FIXEDPOINT_HPP
+#define FIXEDPOINT_HPP
+
+#include <iostream>
+#include <cmath>
+
+// The type a product or a quotient of two Storage values is computed in,
+// wide enough that neither overflows before it is shifted back
+template <typename Storage>
+struct FixedWide;
+
+template <>
+struct FixedWide<short> {
+    typedef int type;
+};
+
+template <>
+struct FixedWide<int> {
+    typedef long long type;
+};
+
+#ifdef __SIZEOF_INT128__
+template <>
+struct FixedWide<long long> {
+    __extension__ typedef __int128 type;
+};
+#endif
+
+// Fixed with the number of fractional bits and the storage type as
+// parameters: FixedPoint<8, int> has the layout of Fixed, Q16_16 and
+// Q32_32 are the DSP formats. Everything is inline in this header and
+// the scale is a compile-time constant, so an operation compiles to the
+// integer instructions it needs and nothing else; C++98 has no constexpr,
+// so the operations are not usable in constant expressions themselves.
+// Products and quotients are computed in FixedWide<Storage>::type: a
+// product is rounded to the nearest value, half up, and a quotient is
+// truncated toward zero. Results that do not fit in Storage wrap
+template <int FracBits, typename Storage = int>
+class FixedPoint {
+public:
+    typedef Storage storage_type;
+    typedef typename FixedWide<Storage>::type wide_type;
+
+    static const int FRACTIONAL_BITS = FracBits;
+    static const Storage ONE = static_cast<Storage>(static_cast<Storage>(1) << FracBits);
+
+private:
+    Storage _value;
+
+public:
+    FixedPoint() : _value(0) {
+    }
+
+    FixedPoint(const int value) : _value(static_cast<Storage>(static_cast<Storage>(value) * ONE)) {
+    }
+
+    FixedPoint(const float value) : _value(static_cast<Storage>(std::floor(static_cast<double>(value) * ONE + 0.5))) {
+    }
+
+    FixedPoint(const double value) : _value(static_cast<Storage>(std::floor(value * ONE + 0.5))) {
+    }
+
+    FixedPoint(const FixedPoint& other) : _value(other._value) {
+    }
+
+    FixedPoint& operator=(const FixedPoint& other) {
+        _value = other._value;
+        return *this;
+    }
+
+    ~FixedPoint() {
+    }
+
+    static FixedPoint fromRawBits(Storage raw) {
+        FixedPoint result;
+        result._value = raw;
+        return result;
+    }
+
+    Storage getRawBits(void) const {
+        return _value;
+    }
+
+    void setRawBits(Storage const raw) {
+        _value = raw;
+    }
+
+    float toFloat(void) const {
+        return static_cast<float>(toDouble());
+    }
+
+    double toDouble(void) const {
+        return static_cast<double>(_value) / ONE;
+    }
+
+    int toInt(void) const {
+        return static_cast<int>(_value >> FracBits);
+    }
+
+    bool operator>(const FixedPoint& other) const {
+        return _value > other._value;
+    }
+
+    bool operator<(const FixedPoint& other) const {
+        return _value < other._value;
+    }
+
+    bool operator>=(const FixedPoint& other) const {
+        return _value >= other._value;
+    }
+
+    bool operator<=(const FixedPoint& other) const {
+        return _value <= other._value;
+    }
+
+    bool operator==(const FixedPoint& other) const {
+        return _value == other._value;
+    }
+
+    bool operator!=(const FixedPoint& other) const {
+        return _value != other._value;
+    }
+
+    FixedPoint operator+(const FixedPoint& other) const {
+        return fromRawBits(static_cast<Storage>(_value + other._value));
+    }
+
+    FixedPoint operator-(const FixedPoint& other) const {
+        return fromRawBits(static_cast<Storage>(_value - other._value));
+    }
+
+    FixedPoint operator*(const FixedPoint& other) const {
+        wide_type product = static_cast<wide_type>(_value) * other._value;
+        if (FracBits > 0)
+            product += static_cast<wide_type>(1) << (FracBits > 0 ? FracBits - 1 : 0);
+        return fromRawBits(static_cast<Storage>(product >> FracBits));
+    }
+
+    // other must not be zero
+    FixedPoint operator/(const FixedPoint& other) const {
+        wide_type dividend = static_cast<wide_type>(_value) * ONE;
+        return fromRawBits(static_cast<Storage>(dividend / other._value));
+    }
+
+    FixedPoint& operator++() {
+        _value += 1;
+        return *this;
+    }
+
+    FixedPoint operator++(int) {
+        FixedPoint tmp(*this);
+        _value += 1;
+        return tmp;
+    }
+
+    FixedPoint& operator--() {
+        _value -= 1;
+        return *this;
+    }
+
+    FixedPoint operator--(int) {
+        FixedPoint tmp(*this);
+        _value -= 1;
+        return tmp;
+    }
+
+    static FixedPoint& min(FixedPoint& a, FixedPoint& b) {
+        return (a < b) ? a : b;
+    }
+
+    static const FixedPoint& min(const FixedPoint& a, const FixedPoint& b) {
+        return (a < b) ? a : b;
+    }
+
+    static FixedPoint& max(FixedPoint& a, FixedPoint& b) {
+        return (a > b) ? a : b;
+    }
+
+    static const FixedPoint& max(const FixedPoint& a, const FixedPoint& b) {
+        return (a > b) ? a : b;
+    }
+};
+
+template <int FracBits, typename Storage>
+const int FixedPoint<FracBits, Storage>::FRACTIONAL_BITS;
+
+template <int FracBits, typename Storage>
+const Storage FixedPoint<FracBits, Storage>::ONE;
+
+template <int FracBits, typename Storage>
+std::ostream& operator<<(std::ostream& out, const FixedPoint<FracBits, Storage>& fixed) {
+    out << fixed.toDouble();
+    return out;
+}
+
+typedef FixedPoint<16, int> Q16_16;
+#ifdef __SIZEOF_INT128__
+typedef FixedPoint<32, long long> Q32_32;
+#endif
+
+#endif
\ No newline at end of file
@@ -1,4 +1,6 @@
 #include "Fixed.hpp"
+#include "FixedPoint.hpp"
+#include "FixedBatch.hpp"
 #include <iostream>
 
 int main(void) {
@@ -15,5 +17,35 @@ int main(void) {
     
     std::cout << Fixed::max(a, b) << std::endl;
     
+    Q16_16 gain(1.5f);
+    Q16_16 sample(-3.25f);
+    std::cout << "Q16.16: " << gain << " * " << sample << " = " << gain * sample
+              << ", / = " << sample / gain << std::endl;
+    Q32_32 fine(1.0 / 3.0);
+    std::cout << "Q32.32: " << fine << " * 3 = " << fine * Q32_32(3) << std::endl;
+    
+    Fixed taps[4];
+    Fixed window[4];
+    Fixed filtered[4];
+    for (int k = 0; k < 4; ++k) {
+        taps[k].setRawBits(64);                  // 0.25
+        window[k].setRawBits((k + 1) * 256);     // 1, 2, 3, 4
+    }
+    FixedBatch::mul(taps, window, filtered, 4);
+    Fixed sum = FixedBatch::dot(taps, window, 4);
+    std::cout << "batch mul: " << filtered[0] << " " << filtered[1] << " " << filtered[2] << " " << filtered[3]
+              << ", dot: " << sum << std::endl;
+    
+    Fixed big(10000);
+    Fixed product;
+    Fixed saturated = big.mulSaturated(big);
+    bool fits = big.tryMul(big, product);
+    std::cout << "10000 * 10000: saturated to " << saturated << ", fits: " << (fits ? "yes" : "no")
+              << ", wide raw product: " << big.mulWide(big) << std::endl;
+    
+    Fixed price;
+    if (Fixed::tryParse("47115.93", price))
+        std::cout << "parsed 47115.93 as " << price.toString() << ", b is exactly " << b.toString() << std::endl;
+    
     return 0;
 }
\ No newline at end of file
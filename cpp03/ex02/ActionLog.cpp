@@ -0,0 +1,96 @@
+#include "ActionLog.hpp"
+
+ActionLog::ActionLog() : enabled(true) {
+}
+
+ActionLog::ActionLog(const ActionLog& other)
+    : names(other.names), nameIndex(other.nameIndex), records(other.records), enabled(other.enabled) {
+}
+
+ActionLog::~ActionLog() {
+}
+
+ActionLog& ActionLog::operator=(const ActionLog& other) {
+    if (this != &other) {
+        names = other.names;
+        nameIndex = other.nameIndex;
+        records = other.records;
+        enabled = other.enabled;
+    }
+    return *this;
+}
+
+unsigned int ActionLog::intern(const std::string& name) {
+    std::map<std::string, unsigned int>::iterator it = nameIndex.find(name);
+    if (it != nameIndex.end())
+        return it->second;
+    unsigned int id = static_cast<unsigned int>(names.size());
+    names.push_back(name);
+    nameIndex.insert(std::make_pair(name, id));
+    return id;
+}
+
+const std::string& ActionLog::getName(unsigned int id) const {
+    return names[id];
+}
+
+void ActionLog::record(unsigned int actor, Action action, unsigned int amount, unsigned int hitPoints,
+                       unsigned int target) {
+    if (!enabled)
+        return;
+    Record r;
+    r.actor = actor;
+    r.target = target;
+    r.amount = amount;
+    r.hitPoints = hitPoints;
+    r.action = action;
+    records.push_back(r);
+}
+
+void ActionLog::setEnabled(bool on) {
+    enabled = on;
+}
+
+bool ActionLog::isEnabled() const {
+    return enabled;
+}
+
+const std::vector<ActionLog::Record>& ActionLog::getRecords() const {
+    return records;
+}
+
+size_t ActionLog::size() const {
+    return records.size();
+}
+
+void ActionLog::clear() {
+    records.clear();
+}
+
+void ActionLog::write(std::ostream& out) const {
+    for (size_t i = 0; i < records.size(); i++) {
+        const Record& r = records[i];
+        const std::string& name = names[r.actor];
+        switch (r.action) {
+            case ACTION_ATTACK:
+                out << "ClapTrap " << name << " attacks " << names[r.target]
+                    << ", causing " << r.amount << " points of damage!\n";
+                break;
+            case ACTION_NO_ATTACK:
+                out << "ClapTrap " << name << " can't attack - no energy or hit points left!\n";
+                break;
+            case ACTION_DAMAGE:
+                out << "ClapTrap " << name << " takes " << r.amount
+                    << " points of damage! (" << r.hitPoints << " HP remaining)\n";
+                break;
+            case ACTION_REPAIR:
+                out << "ClapTrap " << name << " repairs itself for " << r.amount
+                    << " hit points! (" << r.hitPoints << " HP now)\n";
+                break;
+            default:
+                out << "ClapTrap " << name << " can't repair - no energy or hit points left!\n";
+                break;
+        }
+    }
+    out.flush();
+}
\ No newline at end of file
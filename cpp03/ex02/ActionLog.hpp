@@ -0,0 +1,64 @@
+#ifndef ACTIONLOG_HPP
+#define ACTIONLOG_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <ostream>
+
+// The actions of ClapTraps as small records, queued instead of printed:
+// who acted, what it did, the amount and the hit points it was left with.
+// Names are interned, so a record is five words whatever the names. The
+// messages are only formatted when write is called, and a disabled log
+// drops records without looking at them, so the actions cost their
+// arithmetic and an early return
+class ActionLog {
+public:
+    enum Action {
+        ACTION_ATTACK,
+        ACTION_NO_ATTACK,
+        ACTION_DAMAGE,
+        ACTION_REPAIR,
+        ACTION_NO_REPAIR
+    };
+
+    struct Record {
+        unsigned int actor;
+        unsigned int target;      // for an attack, the name attacked
+        unsigned int amount;
+        unsigned int hitPoints;   // of the actor, after the action
+        unsigned int action;
+    };
+
+private:
+    std::vector<std::string> names;
+    std::map<std::string, unsigned int> nameIndex;
+    std::vector<Record> records;
+    bool enabled;
+
+public:
+    ActionLog();
+    ActionLog(const ActionLog& other);
+    ~ActionLog();
+    
+    ActionLog& operator=(const ActionLog& other);
+    
+    // The id of a name, the same every time it is given
+    unsigned int intern(const std::string& name);
+    const std::string& getName(unsigned int id) const;
+    
+    void record(unsigned int actor, Action action, unsigned int amount, unsigned int hitPoints,
+                unsigned int target = 0);
+    
+    // Whether records are kept; on by default
+    void setEnabled(bool on);
+    bool isEnabled() const;
+    
+    const std::vector<Record>& getRecords() const;
+    size_t size() const;
+    void clear();
+    // Print the records in order, with the messages ClapTrap prints
+    void write(std::ostream& out) const;
+};
+
+#endif
\ No newline at end of file
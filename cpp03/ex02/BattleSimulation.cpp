@@ -0,0 +1,180 @@
+#include "BattleSimulation.hpp"
+
+BattleSimulation::BattleSimulation(ClapTrapFleet& fleet, size_t partitionSize)
+    : fleet(fleet), partitionSize(partitionSize ? partitionSize : 1), ticks(0),
+      parallel(false) {
+}
+
+BattleSimulation::BattleSimulation(const BattleSimulation& other)
+    : fleet(other.fleet), targets(other.targets), hits(other.hits), damage(other.damage),
+      partitionSize(other.partitionSize), ticks(other.ticks), parallel(other.parallel) {
+}
+
+BattleSimulation& BattleSimulation::operator=(const BattleSimulation& other) {
+    (void)other;
+    return *this;
+}
+
+BattleSimulation::~BattleSimulation() {
+}
+
+void BattleSimulation::setTarget(size_t unit, size_t target) {
+    if (targets.size() < fleet.size())
+        targets.resize(fleet.size(), NO_TARGET);
+    targets[unit] = static_cast<unsigned int>(target);
+}
+
+void BattleSimulation::clearTarget(size_t unit) {
+    if (unit < targets.size())
+        targets[unit] = NO_TARGET;
+}
+
+unsigned int BattleSimulation::getTarget(size_t unit) const {
+    return unit < targets.size() ? targets[unit] : NO_TARGET;
+}
+
+size_t BattleSimulation::getPartitionCount() const {
+    return (fleet.size() + partitionSize - 1) / partitionSize;
+}
+
+size_t BattleSimulation::prepare() {
+    if (targets.size() < fleet.size())
+        targets.resize(fleet.size(), NO_TARGET);
+    size_t partitions = getPartitionCount();
+    if (hits.size() < partitions)
+        hits.resize(partitions);
+    return partitions;
+}
+
+// A target out of the fleet, NO_TARGET included, is no attack
+void BattleSimulation::plan(size_t partition) {
+    size_t first = partition * partitionSize;
+    size_t last = first + partitionSize;
+    if (last > fleet.size())
+        last = fleet.size();
+    unsigned int count = static_cast<unsigned int>(fleet.size());
+    std::vector<Hit>& list = hits[partition];
+    list.clear();
+    for (size_t u = first; u < last; u++) {
+        unsigned int target = targets[u];
+        unsigned int able = (target < count) & (fleet.energyPoints[u] != 0) & (fleet.hitPoints[u] != 0);
+        fleet.energyPoints[u] -= able;
+        if (able) {
+            Hit hit = { static_cast<unsigned int>(u), target, fleet.attackDamage[u] };
+            list.push_back(hit);
+        }
+    }
+}
+
+// Saturating add that other threads may be doing to the same slot
+static void addSaturated(unsigned int* slot, unsigned int amount) {
+    unsigned int seen = __sync_fetch_and_add(slot, 0);
+    for (;;) {
+        unsigned int sum = seen + amount;
+        sum |= 0u - (sum < amount);
+        unsigned int now = __sync_val_compare_and_swap(slot, seen, sum);
+        if (now == seen)
+            return;
+        seen = now;
+    }
+}
+
+void BattleSimulation::addHits(size_t partition, bool atomic) {
+    const std::vector<Hit>& list = hits[partition];
+    for (size_t i = 0; i < list.size(); i++) {
+        const Hit& hit = list[i];
+        if (atomic) {
+            addSaturated(&damage[hit.target], hit.damage);
+        } else {
+            unsigned int sum = damage[hit.target] + hit.damage;
+            damage[hit.target] = sum | (0u - (sum < hit.damage));
+        }
+    }
+}
+
+void BattleSimulation::applyDamage(size_t partition) {
+    size_t first = partition * partitionSize;
+    size_t last = first + partitionSize;
+    if (last > fleet.size())
+        last = fleet.size();
+    for (size_t u = first; u < last; u++) {
+        unsigned int hp = fleet.hitPoints[u];
+        fleet.hitPoints[u] = hp - (hp < damage[u] ? hp : damage[u]);
+    }
+}
+
+void BattleSimulation::PlanJob::operator()(size_t first, size_t last) const {
+    for (size_t p = first; p < last; p++)
+        sim->plan(p);
+}
+
+void BattleSimulation::DamageJob::operator()(size_t first, size_t last) const {
+    for (size_t p = first; p < last; p++)
+        sim->addHits(p, true);
+}
+
+void BattleSimulation::ApplyJob::operator()(size_t first, size_t last) const {
+    for (size_t p = first; p < last; p++)
+        sim->applyDamage(p);
+}
+
+// Attack events are recorded before any damage is applied, as they carry
+// the attacker's hit points from before the tick
+void BattleSimulation::resolve() {
+    size_t n = fleet.size();
+    size_t partitions = getPartitionCount();
+    damage.assign(n, 0);
+    if (parallel) {
+        DamageJob sum = { this };
+        ThreadPool::shared().parallelFor(0, hits.size(), 1, sum);
+    } else {
+        for (size_t p = 0; p < hits.size(); p++)
+            addHits(p, false);
+    }
+    for (size_t p = 0; p < hits.size(); p++) {
+        const std::vector<Hit>& list = hits[p];
+        if (fleet.logging) {
+            for (size_t i = 0; i < list.size(); i++)
+                fleet.record(list[i].attacker, ClapTrapFleet::ACTION_ATTACK, list[i].damage, list[i].target);
+        }
+        hits[p].clear();
+    }
+    if (parallel) {
+        ApplyJob apply = { this };
+        ThreadPool::shared().parallelFor(0, partitions, 1, apply);
+    } else {
+        for (size_t p = 0; p < partitions; p++)
+            applyDamage(p);
+    }
+    if (fleet.logging) {
+        for (size_t u = 0; u < n; u++) {
+            if (damage[u])
+                fleet.record(u, ClapTrapFleet::ACTION_DAMAGE, damage[u]);
+        }
+    }
+    ticks++;
+}
+
+void BattleSimulation::tick() {
+    size_t partitions = prepare();
+    if (parallel) {
+        PlanJob job = { this };
+        ThreadPool::shared().parallelFor(0, partitions, 1, job);
+    } else {
+        for (size_t p = 0; p < partitions; p++)
+            plan(p);
+    }
+    resolve();
+}
+
+void BattleSimulation::setParallel(bool enabled) {
+    parallel = enabled;
+}
+
+bool BattleSimulation::isParallel() const {
+    return parallel;
+}
+
+unsigned long BattleSimulation::getTickCount() const {
+    return ticks;
+}
\ No newline at end of file
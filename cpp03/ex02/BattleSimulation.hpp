@@ -0,0 +1,92 @@
+#ifndef BATTLESIMULATION_HPP
+#define BATTLESIMULATION_HPP
+
+#include "ClapTrapFleet.hpp"
+#include "ThreadPool.hpp"
+#include <vector>
+#include <cstddef>
+
+// Ticks of a battle between the units of a ClapTrapFleet, where each unit
+// attacks the unit whose index it targets. A tick has two phases: in the
+// intent phase every unit able to attack spends one energy point and
+// notes the damage it deals, reading only the state from before the tick,
+// and in the resolve phase the damage is summed per target and applied,
+// so a unit defeated during a tick still attacks in it.
+// The units are split into partitions of partitionSize. Planning a
+// partition writes only its own units and its own list of hits, so
+// partitions can be planned in any order, or at the same time, without a
+// lock; resolve then reads the lists in partition order, which makes the
+// result and the events the same however the planning was done.
+// In parallel mode tick() does exactly that on ThreadPool::shared(): the
+// partitions are planned on its threads, the hits of each partition are
+// added to their targets with a lock-free saturating add, which gives the
+// same sums in any order, and the damage is applied to the units one
+// partition per task. Events are still recorded in partition order on the
+// calling thread, so the result is the same in either mode
+class BattleSimulation {
+public:
+    static const unsigned int NO_TARGET = 0xFFFFFFFFu;
+
+private:
+    struct Hit {
+        unsigned int attacker;
+        unsigned int target;
+        unsigned int damage;
+    };
+
+    ClapTrapFleet& fleet;
+    std::vector<unsigned int> targets;
+    std::vector<std::vector<Hit> > hits;      // one list per partition
+    std::vector<unsigned int> damage;         // per unit, while resolving
+    size_t partitionSize;
+    unsigned long ticks;
+    bool parallel;
+
+    // The pieces of a parallel tick, each over a range of partitions
+    struct PlanJob {
+        BattleSimulation* sim;
+        void operator()(size_t first, size_t last) const;
+    };
+    struct DamageJob {
+        BattleSimulation* sim;
+        void operator()(size_t first, size_t last) const;
+    };
+    struct ApplyJob {
+        BattleSimulation* sim;
+        void operator()(size_t first, size_t last) const;
+    };
+
+    void addHits(size_t partition, bool atomic);
+    void applyDamage(size_t partition);
+
+    BattleSimulation();
+    BattleSimulation(const BattleSimulation& other);
+    BattleSimulation& operator=(const BattleSimulation& other);
+
+public:
+    BattleSimulation(ClapTrapFleet& fleet, size_t partitionSize = 4096);
+    ~BattleSimulation();
+    
+    // The unit that unit attacks each tick; units added to the fleet
+    // later start with NO_TARGET
+    void setTarget(size_t unit, size_t target);
+    void clearTarget(size_t unit);
+    unsigned int getTarget(size_t unit) const;
+    
+    size_t getPartitionCount() const;
+    // Size the state for the fleet as it is now, and return the number of
+    // partitions to plan; the fleet must not grow until resolve
+    size_t prepare();
+    // The intent phase for the units of one partition
+    void plan(size_t partition);
+    // The resolve phase, once every partition has been planned
+    void resolve();
+    // prepare, plan each partition, then resolve
+    void tick();
+    // Whether tick() runs its phases on the thread pool; off by default
+    void setParallel(bool enabled);
+    bool isParallel() const;
+    unsigned long getTickCount() const;
+};
+
+#endif
\ No newline at end of file
@@ -1,15 +1,19 @@
 #include "ClapTrap.hpp"
+#include "ActionLog.hpp"
 #include <iostream>
 
-ClapTrap::ClapTrap() : _name(""), _hitPoints(10), _energyPoints(10), _attackDamage(0) {
+ActionLog* ClapTrap::_log = NULL;
+unsigned int ClapTrap::_logSerial = 0;
+
+ClapTrap::ClapTrap() : _name(""), _hitPoints(10), _energyPoints(10), _attackDamage(0), _actorSerial(0), _actorId(0) {
     std::cout << "ClapTrap default constructor called" << std::endl;
 }
 
-ClapTrap::ClapTrap(const std::string& name) : _name(name), _hitPoints(10), _energyPoints(10), _attackDamage(0) {
+ClapTrap::ClapTrap(const std::string& name) : _name(name), _hitPoints(10), _energyPoints(10), _attackDamage(0), _actorSerial(0), _actorId(0) {
     std::cout << "ClapTrap " << _name << " constructor called" << std::endl;
 }
 
-ClapTrap::ClapTrap(const ClapTrap& other) {
+ClapTrap::ClapTrap(const ClapTrap& other) : _actorSerial(0), _actorId(0) {
     *this = other;
     std::cout << "ClapTrap copy constructor called" << std::endl;
 }
@@ -24,17 +28,45 @@ ClapTrap& ClapTrap::operator=(const ClapTrap& other) {
         _hitPoints = other._hitPoints;
         _energyPoints = other._energyPoints;
         _attackDamage = other._attackDamage;
+        _actorSerial = 0;
     }
     std::cout << "ClapTrap assignment operator called" << std::endl;
     return *this;
 }
 
+unsigned int ClapTrap::actorId() {
+    if (_actorSerial != _logSerial) {
+        _actorId = _log->intern(_name);
+        _actorSerial = _logSerial;
+    }
+    return _actorId;
+}
+
+void ClapTrap::setActionLog(ActionLog* log) {
+    _log = log;
+    _logSerial++;
+}
+
+ActionLog* ClapTrap::getActionLog() {
+    return _log;
+}
+
 void ClapTrap::attack(const std::string& target) {
     if (_energyPoints == 0 || _hitPoints == 0) {
+        if (_log) {
+            if (_log->isEnabled())
+                _log->record(actorId(), ActionLog::ACTION_NO_ATTACK, 0, _hitPoints);
+            return;
+        }
         std::cout << "ClapTrap " << _name << " can't attack - no energy or hit points left!" << std::endl;
         return;
     }
     _energyPoints--;
+    if (_log) {
+        if (_log->isEnabled())
+            _log->record(actorId(), ActionLog::ACTION_ATTACK, _attackDamage, _hitPoints, _log->intern(target));
+        return;
+    }
     std::cout << "ClapTrap " << _name << " attacks " << target 
               << ", causing " << _attackDamage << " points of damage!" << std::endl;
 }
@@ -45,17 +77,32 @@ void ClapTrap::takeDamage(unsigned int amount) {
     } else {
         _hitPoints -= amount;
     }
+    if (_log) {
+        if (_log->isEnabled())
+            _log->record(actorId(), ActionLog::ACTION_DAMAGE, amount, _hitPoints);
+        return;
+    }
     std::cout << "ClapTrap " << _name << " takes " << amount 
               << " points of damage! (" << _hitPoints << " HP remaining)" << std::endl;
 }
 
 void ClapTrap::beRepaired(unsigned int amount) {
     if (_energyPoints == 0 || _hitPoints == 0) {
+        if (_log) {
+            if (_log->isEnabled())
+                _log->record(actorId(), ActionLog::ACTION_NO_REPAIR, amount, _hitPoints);
+            return;
+        }
         std::cout << "ClapTrap " << _name << " can't repair - no energy or hit points left!" << std::endl;
         return;
     }
     _energyPoints--;
     _hitPoints += amount;
+    if (_log) {
+        if (_log->isEnabled())
+            _log->record(actorId(), ActionLog::ACTION_REPAIR, amount, _hitPoints);
+        return;
+    }
     std::cout << "ClapTrap " << _name << " repairs itself for " << amount 
               << " hit points! (" << _hitPoints << " HP now)" << std::endl;
 }
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <string>
 
+class ActionLog;
+
 class ClapTrap {
 protected:
     std::string _name;
@@ -10,6 +12,15 @@ protected:
     unsigned int _energyPoints;
     unsigned int _attackDamage;
 
+    // While an ActionLog is set, actions are recorded in it instead of
+    // printed; the id of _name in it is looked up once per log set
+    static ActionLog* _log;
+    static unsigned int _logSerial;
+    unsigned int _actorSerial;
+    unsigned int _actorId;
+
+    unsigned int actorId();
+
 public:
     ClapTrap();
     ClapTrap(const std::string& name);
@@ -21,6 +32,11 @@ public:
     void attack(const std::string& target);
     void takeDamage(unsigned int amount);
     void beRepaired(unsigned int amount);
+    
+    // The log every ClapTrap records its actions in, or NULL to print
+    // them as they happen, as by default
+    static void setActionLog(ActionLog* log);
+    static ActionLog* getActionLog();
 };
 
 #endif
\ No newline at end of file
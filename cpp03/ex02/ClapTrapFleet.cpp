@@ -0,0 +1,337 @@
+#include "ClapTrapFleet.hpp"
+#include <cstring>
+
+ClapTrapFleet::ClapTrapFleet() : logging(true) {
+}
+
+ClapTrapFleet::ClapTrapFleet(const ClapTrapFleet& other)
+    : names(other.names), nameIndex(other.nameIndex), nameIds(other.nameIds), hitPoints(other.hitPoints), energyPoints(other.energyPoints),
+      attackDamage(other.attackDamage), types(other.types), events(other.events), logging(other.logging) {
+}
+
+ClapTrapFleet::~ClapTrapFleet() {
+}
+
+ClapTrapFleet& ClapTrapFleet::operator=(const ClapTrapFleet& other) {
+    if (this != &other) {
+        names = other.names;
+        nameIndex = other.nameIndex;
+        nameIds = other.nameIds;
+        hitPoints = other.hitPoints;
+        energyPoints = other.energyPoints;
+        attackDamage = other.attackDamage;
+        types = other.types;
+        events = other.events;
+        logging = other.logging;
+    }
+    return *this;
+}
+
+size_t ClapTrapFleet::add(const std::string& name) {
+    return add(name, TrapType::CLAPTRAP);
+}
+
+size_t ClapTrapFleet::add(const std::string& name, TrapType::Id type) {
+    const TrapType& stats = TrapType::get(type);
+    return add(name, stats.hitPoints, stats.energyPoints, stats.attackDamage, type);
+}
+
+size_t ClapTrapFleet::add(const std::string& name, unsigned int hp, unsigned int energy, unsigned int damage,
+                          TrapType::Id type) {
+    nameIds.push_back(intern(name));
+    hitPoints.push_back(hp);
+    energyPoints.push_back(energy);
+    attackDamage.push_back(damage);
+    types.push_back(static_cast<unsigned char>(type));
+    return nameIds.size() - 1;
+}
+
+void ClapTrapFleet::reserve(size_t count) {
+    nameIds.reserve(count);
+    hitPoints.reserve(count);
+    energyPoints.reserve(count);
+    attackDamage.reserve(count);
+    types.reserve(count);
+}
+
+size_t ClapTrapFleet::size() const {
+    return nameIds.size();
+}
+
+const std::string& ClapTrapFleet::getName(size_t unit) const {
+    return names[nameIds[unit]];
+}
+
+unsigned int ClapTrapFleet::getHitPoints(size_t unit) const {
+    return hitPoints[unit];
+}
+
+unsigned int ClapTrapFleet::getEnergyPoints(size_t unit) const {
+    return energyPoints[unit];
+}
+
+unsigned int ClapTrapFleet::getAttackDamage(size_t unit) const {
+    return attackDamage[unit];
+}
+
+unsigned int ClapTrapFleet::intern(const std::string& name) {
+    std::map<std::string, unsigned int>::iterator it = nameIndex.find(name);
+    if (it != nameIndex.end())
+        return it->second;
+    unsigned int id = static_cast<unsigned int>(names.size());
+    names.push_back(name);
+    nameIndex.insert(std::make_pair(name, id));
+    return id;
+}
+
+TrapType::Id ClapTrapFleet::getType(size_t unit) const {
+    return static_cast<TrapType::Id>(types[unit]);
+}
+
+void ClapTrapFleet::record(size_t unit, Action action, unsigned int amount, size_t target) {
+    Event event;
+    event.unit = static_cast<unsigned int>(unit);
+    event.target = static_cast<unsigned int>(target);
+    event.amount = amount;
+    event.hitPoints = hitPoints[unit];
+    event.action = static_cast<unsigned char>(action);
+    events.push_back(event);
+}
+
+// The arithmetic below uses masks instead of branches: able is 1 when a
+// unit has energy and hit points left, and 0u - able is all ones or zero
+
+void ClapTrapFleet::attack(const size_t* units, size_t count, size_t target) {
+    for (size_t i = 0; i < count; i++) {
+        size_t u = units[i];
+        unsigned int able = (energyPoints[u] != 0) & (hitPoints[u] != 0);
+        energyPoints[u] -= able;
+        if (logging)
+            record(u, able ? ACTION_ATTACK : ACTION_NO_ATTACK, attackDamage[u], target);
+    }
+}
+
+void ClapTrapFleet::takeDamage(const size_t* units, size_t count, unsigned int amount) {
+    for (size_t i = 0; i < count; i++) {
+        size_t u = units[i];
+        unsigned int hp = hitPoints[u];
+        hitPoints[u] = hp - (hp < amount ? hp : amount);
+        if (logging)
+            record(u, ACTION_DAMAGE, amount);
+    }
+}
+
+void ClapTrapFleet::beRepaired(const size_t* units, size_t count, unsigned int amount) {
+    for (size_t i = 0; i < count; i++) {
+        size_t u = units[i];
+        unsigned int hp = hitPoints[u];
+        unsigned int able = (energyPoints[u] != 0) & (hp != 0);
+        unsigned int sum = hp + (amount & (0u - able));
+        energyPoints[u] -= able;
+        hitPoints[u] = sum | (0u - (sum < hp));
+        if (logging)
+            record(u, able ? ACTION_REPAIR : ACTION_NO_REPAIR, amount);
+    }
+}
+
+void ClapTrapFleet::useAbility(const size_t* units, size_t count, TrapType::Ability ability, Action action) {
+    if (!logging)
+        return;
+    for (size_t i = 0; i < count; i++) {
+        if (TrapType::get(types[units[i]]).abilities & ability)
+            record(units[i], action, 0);
+    }
+}
+
+void ClapTrapFleet::guardGate(const size_t* units, size_t count) {
+    useAbility(units, count, TrapType::ABILITY_GUARD_GATE, ACTION_GUARD_GATE);
+}
+
+void ClapTrapFleet::highFivesGuys(const size_t* units, size_t count) {
+    useAbility(units, count, TrapType::ABILITY_HIGH_FIVES, ACTION_HIGH_FIVES);
+}
+
+// Whole-fleet batches: the arithmetic runs first as one loop over plain
+// arrays, then the events are recorded in a second pass
+
+void ClapTrapFleet::takeDamageAll(unsigned int amount) {
+    unsigned int* hp = hitPoints.empty() ? 0 : &hitPoints[0];
+    size_t n = hitPoints.size();
+    for (size_t i = 0; i < n; i++)
+        hp[i] -= hp[i] < amount ? hp[i] : amount;
+    if (logging) {
+        for (size_t i = 0; i < n; i++)
+            record(i, ACTION_DAMAGE, amount);
+    }
+}
+
+void ClapTrapFleet::beRepairedAll(unsigned int amount) {
+    size_t n = hitPoints.size();
+    size_t logged = events.size();
+    if (logging) {
+        // Whether each unit could repair is only known before the loop
+        for (size_t i = 0; i < n; i++)
+            record(i, (energyPoints[i] != 0 && hitPoints[i] != 0) ? ACTION_REPAIR : ACTION_NO_REPAIR, amount);
+    }
+    unsigned int* hp = hitPoints.empty() ? 0 : &hitPoints[0];
+    unsigned int* energy = energyPoints.empty() ? 0 : &energyPoints[0];
+    for (size_t i = 0; i < n; i++) {
+        unsigned int able = (energy[i] != 0) & (hp[i] != 0);
+        unsigned int sum = hp[i] + (amount & (0u - able));
+        energy[i] -= able;
+        hp[i] = sum | (0u - (sum < hp[i]));
+    }
+    if (logging) {
+        for (size_t i = 0; i < n; i++)
+            events[logged + i].hitPoints = hp[i];
+    }
+}
+
+// Layout: unit count, name count and name bytes as 32-bit words, then
+// every name followed by a zero byte, then hit points, energy points,
+// attack damage and name ids as arrays of 32-bit words, then the type ids
+
+static void putWord(unsigned char*& p, unsigned int word) {
+    std::memcpy(p, &word, sizeof(word));
+    p += sizeof(word);
+}
+
+static unsigned int getWord(const unsigned char*& p) {
+    unsigned int word;
+    std::memcpy(&word, p, sizeof(word));
+    p += sizeof(word);
+    return word;
+}
+
+static void putArray(unsigned char*& p, const std::vector<unsigned int>& words) {
+    if (!words.empty())
+        std::memcpy(p, &words[0], words.size() * sizeof(unsigned int));
+    p += words.size() * sizeof(unsigned int);
+}
+
+static void getArray(const unsigned char*& p, std::vector<unsigned int>& words, size_t count) {
+    words.resize(count);
+    if (count)
+        std::memcpy(&words[0], p, count * sizeof(unsigned int));
+    p += count * sizeof(unsigned int);
+}
+
+static size_t nameBytes(const std::vector<std::string>& names) {
+    size_t bytes = 0;
+    for (size_t i = 0; i < names.size(); i++)
+        bytes += names[i].size() + 1;
+    return bytes;
+}
+
+size_t ClapTrapFleet::getSnapshotSize() const {
+    return 3 * sizeof(unsigned int) + nameBytes(names) + size() * (4 * sizeof(unsigned int) + 1);
+}
+
+void ClapTrapFleet::saveSnapshot(std::vector<unsigned char>& out) const {
+    size_t n = size();
+    out.resize(getSnapshotSize());
+    unsigned char* p = &out[0];
+    putWord(p, static_cast<unsigned int>(n));
+    putWord(p, static_cast<unsigned int>(names.size()));
+    putWord(p, static_cast<unsigned int>(nameBytes(names)));
+    for (size_t i = 0; i < names.size(); i++) {
+        std::memcpy(p, names[i].c_str(), names[i].size() + 1);
+        p += names[i].size() + 1;
+    }
+    putArray(p, hitPoints);
+    putArray(p, energyPoints);
+    putArray(p, attackDamage);
+    putArray(p, nameIds);
+    if (n)
+        std::memcpy(p, &types[0], n);
+}
+
+bool ClapTrapFleet::restoreSnapshot(const unsigned char* data, size_t size) {
+    if (size < 3 * sizeof(unsigned int))
+        return false;
+    const unsigned char* p = data;
+    size_t n = getWord(p);
+    size_t nameCount = getWord(p);
+    size_t bytes = getWord(p);
+    if (size != 3 * sizeof(unsigned int) + bytes + n * (4 * sizeof(unsigned int) + 1))
+        return false;
+    std::vector<std::string> restoredNames;
+    restoredNames.reserve(nameCount);
+    const unsigned char* end = p + bytes;
+    while (p < end) {
+        const unsigned char* zero = static_cast<const unsigned char*>(std::memchr(p, 0, end - p));
+        if (!zero)
+            return false;
+        restoredNames.push_back(std::string(reinterpret_cast<const char*>(p), zero - p));
+        p = zero + 1;
+    }
+    if (restoredNames.size() != nameCount)
+        return false;
+    const unsigned char* ids = p + 3 * n * sizeof(unsigned int);
+    for (size_t i = 0; i < n; i++) {
+        const unsigned char* q = ids + i * sizeof(unsigned int);
+        if (getWord(q) >= nameCount || ids[n * sizeof(unsigned int) + i] >= TrapType::COUNT)
+            return false;
+    }
+    names.swap(restoredNames);
+    nameIndex.clear();
+    for (size_t i = 0; i < names.size(); i++)
+        nameIndex.insert(std::make_pair(names[i], static_cast<unsigned int>(i)));
+    getArray(p, hitPoints, n);
+    getArray(p, energyPoints, n);
+    getArray(p, attackDamage, n);
+    getArray(p, nameIds, n);
+    types.assign(p, p + n);
+    return true;
+}
+
+void ClapTrapFleet::setLogging(bool enabled) {
+    logging = enabled;
+}
+
+bool ClapTrapFleet::isLogging() const {
+    return logging;
+}
+
+const std::vector<ClapTrapFleet::Event>& ClapTrapFleet::getEvents() const {
+    return events;
+}
+
+void ClapTrapFleet::clearEvents() {
+    events.clear();
+}
+
+void ClapTrapFleet::writeEvents(std::ostream& out) const {
+    for (size_t i = 0; i < events.size(); i++) {
+        const Event& e = events[i];
+        const std::string& name = names[nameIds[e.unit]];
+        const TrapType& type = TrapType::get(types[e.unit]);
+        switch (e.action) {
+            case ACTION_ATTACK:
+                out << type.attackName << " " << name << " attacks " << names[nameIds[e.target]]
+                    << ", causing " << e.amount << " points of damage!\n";
+                break;
+            case ACTION_NO_ATTACK:
+                out << type.attackName << " " << name << " can't attack - no energy or hit points left!\n";
+                break;
+            case ACTION_DAMAGE:
+                out << "ClapTrap " << name << " takes " << e.amount
+                    << " points of damage! (" << e.hitPoints << " HP remaining)\n";
+                break;
+            case ACTION_REPAIR:
+                out << "ClapTrap " << name << " repairs itself for " << e.amount
+                    << " hit points! (" << e.hitPoints << " HP now)\n";
+                break;
+            case ACTION_NO_REPAIR:
+                out << "ClapTrap " << name << " can't repair - no energy or hit points left!\n";
+                break;
+            case ACTION_GUARD_GATE:
+                out << type.name << " " << name << " is now in Gate keeper mode!\n";
+                break;
+            default:
+                out << type.name << " " << name << " requests a positive high five!\n";
+                break;
+        }
+    }
+    out.flush();
+}
\ No newline at end of file
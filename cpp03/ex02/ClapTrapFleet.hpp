@@ -0,0 +1,113 @@
+#ifndef CLAPTRAPFLEET_HPP
+#define CLAPTRAPFLEET_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstddef>
+#include <map>
+#include "TrapType.hpp"
+
+// Many ClapTraps, ScavTraps and FragTraps as parallel arrays, one per
+// field, with the TrapType id of each unit in place of its class, acted
+// on in batches:
+// a batch of damage or repair runs one loop without branches over the
+// units it names, or over the whole fleet, which the compiler can
+// vectorize. Damage clamps hit points to zero as takeDamage does, and
+// repair saturates instead of wrapping around. Each action is recorded as
+// a small Event instead of being printed; writeEvents prints them later
+// with the messages each unit's class would have printed.
+// Names are interned: each distinct name is stored once and units keep
+// its index. saveSnapshot copies the state of every unit into one block
+// of bytes, each field with a single memcpy, and restoreSnapshot copies
+// it back in O(n), constructing no ClapTrap at all
+class ClapTrapFleet {
+public:
+    enum Action {
+        ACTION_ATTACK,
+        ACTION_NO_ATTACK,
+        ACTION_DAMAGE,
+        ACTION_REPAIR,
+        ACTION_NO_REPAIR,
+        ACTION_GUARD_GATE,
+        ACTION_HIGH_FIVES
+    };
+
+    struct Event {
+        unsigned int unit;
+        unsigned int target;      // for an attack, the unit attacked
+        unsigned int amount;
+        unsigned int hitPoints;   // of unit, after the action
+        unsigned char action;
+    };
+
+private:
+    std::vector<std::string> names;           // distinct names
+    std::map<std::string, unsigned int> nameIndex;
+    std::vector<unsigned int> nameIds;
+    std::vector<unsigned int> hitPoints;
+    std::vector<unsigned int> energyPoints;
+    std::vector<unsigned int> attackDamage;
+    std::vector<unsigned char> types;
+    std::vector<Event> events;
+    bool logging;
+
+    unsigned int intern(const std::string& name);
+    void record(size_t unit, Action action, unsigned int amount, size_t target = 0);
+    void useAbility(const size_t* units, size_t count, TrapType::Ability ability, Action action);
+
+    friend class BattleSimulation;
+
+public:
+    ClapTrapFleet();
+    ClapTrapFleet(const ClapTrapFleet& other);
+    ~ClapTrapFleet();
+    
+    ClapTrapFleet& operator=(const ClapTrapFleet& other);
+    
+    // A new unit with the stats of a ClapTrap, of its type, or the ones
+    // given; returns its index
+    size_t add(const std::string& name);
+    size_t add(const std::string& name, TrapType::Id type);
+    size_t add(const std::string& name, unsigned int hp, unsigned int energy, unsigned int damage,
+               TrapType::Id type = TrapType::CLAPTRAP);
+    void reserve(size_t count);
+    size_t size() const;
+    
+    const std::string& getName(size_t unit) const;
+    unsigned int getHitPoints(size_t unit) const;
+    unsigned int getEnergyPoints(size_t unit) const;
+    unsigned int getAttackDamage(size_t unit) const;
+    TrapType::Id getType(size_t unit) const;
+    
+    // Each of units[0..count) acts as ClapTrap::attack, takeDamage or
+    // beRepaired would; a unit may be named more than once
+    void attack(const size_t* units, size_t count, size_t target);
+    void takeDamage(const size_t* units, size_t count, unsigned int amount);
+    void beRepaired(const size_t* units, size_t count, unsigned int amount);
+    // Each unit whose type has the ability uses it, as ScavTrap::guardGate
+    // or FragTrap::highFivesGuys would; the others do nothing
+    void guardGate(const size_t* units, size_t count);
+    void highFivesGuys(const size_t* units, size_t count);
+    // The same for every unit
+    void takeDamageAll(unsigned int amount);
+    void beRepairedAll(unsigned int amount);
+    
+    // The units as bytes: their count, the names, then each field as an
+    // array. For this machine only, as the fields are copied as they are
+    size_t getSnapshotSize() const;
+    void saveSnapshot(std::vector<unsigned char>& out) const;
+    // Replace every unit with those of a snapshot; the events are kept.
+    // False, with the fleet unchanged, when the bytes are not a snapshot
+    bool restoreSnapshot(const unsigned char* data, size_t size);
+    
+    // Whether actions are recorded; on by default
+    void setLogging(bool enabled);
+    bool isLogging() const;
+    const std::vector<Event>& getEvents() const;
+    void clearEvents();
+    // Print the recorded events in order, one line each
+    void writeEvents(std::ostream& out) const;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,370 @@
+#ifndef THREADPOOL_HPP
+#define THREADPOOL_HPP
+
+#include <vector>
+#include <deque>
+#include <cstddef>
+#include <cstdlib>
+#include <pthread.h>
+#include <unistd.h>
+
+// Worker threads with one task deque each, work-stealing: a worker runs
+// its newest task first and, once its deque is empty, steals the oldest
+// task of another, so a task that splits itself further keeps the pieces
+// near the thread that made them. Tasks submitted from outside the pool
+// are dealt round the deques. A thread waiting on a TaskGroup runs queued
+// tasks while it waits, so groups nest, and a pool whose threads could not
+// be started still finishes every task on the waiting thread.
+// shared() is the pool of the program, one worker per CPU unless the
+// THREADPOOL_SIZE environment variable says otherwise; every module
+// that runs work in parallel submits to it, so the program never starts
+// more threads than that however many modules are busy. Tasks must not
+// throw. The same header is copied into each exercise that uses it
+class ThreadPool
+{
+	public:
+		// A unit of work; the caller owns it and keeps it alive until the
+		// group it was run in has been waited for
+		class Task
+		{
+			public:
+				virtual ~Task(void)
+				{
+				}
+				
+				virtual void run(void) = 0;
+		};
+		
+		// Tasks waited for together
+		class TaskGroup
+		{
+			private:
+				ThreadPool &_pool;
+				size_t _pending;
+				pthread_mutex_t _lock;
+				pthread_cond_t _done;
+				
+				// Called by the pool when a task of the group returns
+				void _finish(void)
+				{
+					pthread_mutex_lock(&_lock);
+					if (--_pending == 0)
+						pthread_cond_broadcast(&_done);
+					pthread_mutex_unlock(&_lock);
+				}
+				
+				TaskGroup(const TaskGroup &other);
+				TaskGroup &operator=(const TaskGroup &other);
+				
+				friend class ThreadPool;
+				
+			public:
+				explicit TaskGroup(ThreadPool &pool = ThreadPool::shared()) : _pool(pool), _pending(0)
+				{
+					pthread_mutex_init(&_lock, NULL);
+					pthread_cond_init(&_done, NULL);
+				}
+				
+				// Destructor (waits for the tasks still running)
+				~TaskGroup(void)
+				{
+					wait();
+					pthread_cond_destroy(&_done);
+					pthread_mutex_destroy(&_lock);
+				}
+				
+				// Queue task on the pool
+				void run(Task &task)
+				{
+					pthread_mutex_lock(&_lock);
+					_pending++;
+					pthread_mutex_unlock(&_lock);
+					_pool._submit(task, *this);
+				}
+				
+				// Return once every task run in the group has finished,
+				// running queued tasks of any group in the meantime
+				void wait(void)
+				{
+					for (;;)
+					{
+						pthread_mutex_lock(&_lock);
+						bool done = _pending == 0;
+						pthread_mutex_unlock(&_lock);
+						if (done)
+							return;
+						
+						Entry entry;
+						if (_pool._take(entry, false))
+						{
+							_pool._execute(entry);
+							continue;
+						}
+						
+						// Nothing queued: the rest is running somewhere
+						pthread_mutex_lock(&_lock);
+						while (_pending > 0)
+							pthread_cond_wait(&_done, &_lock);
+						pthread_mutex_unlock(&_lock);
+					}
+				}
+		};
+		
+	private:
+		struct Entry
+		{
+			Task *task;
+			TaskGroup *group;
+		};
+		
+		struct Queue
+		{
+			pthread_mutex_t lock;
+			std::deque<Entry> entries;
+		};
+		
+		struct Worker
+		{
+			ThreadPool *pool;
+			size_t index;
+			pthread_t thread;
+		};
+		
+		std::vector<Queue> _queues;
+		std::vector<Worker> _workers;
+		pthread_key_t _self;			// the Worker of the calling thread
+		
+		// Entries queued and not yet taken, and the workers sleeping on it
+		pthread_mutex_t _lock;
+		pthread_cond_t _wake;
+		size_t _queued;
+		size_t _next;					// deque of the next outside submit
+		bool _stop;
+		
+		// A pool owns its threads: no copies
+		ThreadPool(const ThreadPool &other);
+		ThreadPool &operator=(const ThreadPool &other);
+		
+		static void *_main(void *arg)
+		{
+			Worker *self = static_cast<Worker *>(arg);
+			pthread_setspecific(self->pool->_self, self);
+			Entry entry;
+			while (self->pool->_take(entry, true))
+				self->pool->_execute(entry);
+			return NULL;
+		}
+		
+		// Deque of the calling worker, or the next one in turn for others
+		size_t _home(bool &own)
+		{
+			Worker *self = static_cast<Worker *>(pthread_getspecific(_self));
+			own = self != NULL;
+			if (own)
+				return self->index;
+			pthread_mutex_lock(&_lock);
+			size_t index = _next++ % _queues.size();
+			pthread_mutex_unlock(&_lock);
+			return index;
+		}
+		
+		void _submit(Task &task, TaskGroup &group)
+		{
+			Entry entry;
+			entry.task = &task;
+			entry.group = &group;
+			bool own;
+			Queue &queue = _queues[_home(own)];
+			pthread_mutex_lock(&queue.lock);
+			queue.entries.push_back(entry);
+			pthread_mutex_unlock(&queue.lock);
+			
+			pthread_mutex_lock(&_lock);
+			_queued++;
+			pthread_cond_signal(&_wake);
+			pthread_mutex_unlock(&_lock);
+		}
+		
+		// Claim one queued entry, sleeping for one if block is set; false
+		// when nothing is queued (or, blocking, when the pool is stopping).
+		// A claim is counted before the deques are searched, so the search
+		// always finds an entry
+		bool _take(Entry &entry, bool block)
+		{
+			pthread_mutex_lock(&_lock);
+			while (_queued == 0)
+			{
+				if (!block || _stop)
+				{
+					pthread_mutex_unlock(&_lock);
+					return false;
+				}
+				pthread_cond_wait(&_wake, &_lock);
+			}
+			_queued--;
+			pthread_mutex_unlock(&_lock);
+			
+			bool own;
+			size_t home = _home(own);
+			for (size_t i = 0; ; i++)
+			{
+				size_t index = (home + i) % _queues.size();
+				Queue &queue = _queues[index];
+				pthread_mutex_lock(&queue.lock);
+				bool found = !queue.entries.empty();
+				if (found && own && index == home)
+				{
+					entry = queue.entries.back();
+					queue.entries.pop_back();
+				}
+				else if (found)
+				{
+					entry = queue.entries.front();
+					queue.entries.pop_front();
+				}
+				pthread_mutex_unlock(&queue.lock);
+				if (found)
+					return true;
+			}
+		}
+		
+		void _execute(const Entry &entry)
+		{
+			entry.task->run();
+			entry.group->_finish();
+		}
+		
+		template <typename Body>
+		class _RangeTask : public Task
+		{
+			private:
+				Body *_body;
+				size_t _begin;
+				size_t _end;
+				
+			public:
+				_RangeTask(void) : _body(NULL), _begin(0), _end(0)
+				{
+				}
+				
+				void set(Body &body, size_t begin, size_t end)
+				{
+					_body = &body;
+					_begin = begin;
+					_end = end;
+				}
+				
+				void run(void)
+				{
+					(*_body)(_begin, _end);
+				}
+		};
+		
+		static ThreadPool *&_instance(void)
+		{
+			static ThreadPool *pool = NULL;
+			return pool;
+		}
+		
+		// One worker per CPU, or THREADPOOL_SIZE of them when that is set
+		// to a number from 1 to 1024, to share a machine with other jobs
+		static void _createShared(void)
+		{
+			long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+			const char *size = getenv("THREADPOOL_SIZE");
+			if (size)
+			{
+				char *end;
+				long wanted = strtol(size, &end, 10);
+				if (*size && !*end && wanted >= 1 && wanted <= 1024)
+					cpus = wanted;
+			}
+			_instance() = new ThreadPool(cpus > 0 ? static_cast<size_t>(cpus) : 1);
+		}
+		
+	public:
+		// Start up to workers threads; fewer if the system refuses some
+		explicit ThreadPool(size_t workers) : _queued(0), _next(0), _stop(false)
+		{
+			pthread_mutex_init(&_lock, NULL);
+			pthread_cond_init(&_wake, NULL);
+			pthread_key_create(&_self, NULL);
+			_queues.resize(workers > 0 ? workers : 1);
+			for (size_t i = 0; i < _queues.size(); i++)
+				pthread_mutex_init(&_queues[i].lock, NULL);
+			
+			// Filled before any thread starts: each keeps a pointer to its slot
+			_workers.resize(workers);
+			size_t started = 0;
+			for (size_t i = 0; i < workers; i++)
+			{
+				_workers[started].pool = this;
+				_workers[started].index = started;
+				if (pthread_create(&_workers[started].thread, NULL, _main, &_workers[started]) == 0)
+					started++;
+			}
+			_workers.resize(started);
+		}
+		
+		// Destructor: runs what is still queued, then joins the threads
+		~ThreadPool(void)
+		{
+			pthread_mutex_lock(&_lock);
+			_stop = true;
+			pthread_cond_broadcast(&_wake);
+			pthread_mutex_unlock(&_lock);
+			for (size_t i = 0; i < _workers.size(); i++)
+				pthread_join(_workers[i].thread, NULL);
+			for (size_t i = 0; i < _queues.size(); i++)
+				pthread_mutex_destroy(&_queues[i].lock);
+			pthread_key_delete(_self);
+			pthread_cond_destroy(&_wake);
+			pthread_mutex_destroy(&_lock);
+		}
+		
+		// The pool of the program, started on first use and never stopped
+		static ThreadPool &shared(void)
+		{
+			static pthread_once_t once = PTHREAD_ONCE_INIT;
+			pthread_once(&once, _createShared);
+			return *_instance();
+		}
+		
+		// Threads running
+		size_t size(void) const
+		{
+			return _workers.size();
+		}
+		
+		// body(first, last) for consecutive pieces of [begin, end) of grain
+		// elements each (the last one shorter), in parallel; returns once
+		// all are done. A range of one piece runs on the calling thread.
+		// Pieces overlap nothing, but body itself must be safe to call from
+		// several threads at once
+		template <typename Body>
+		void parallelFor(size_t begin, size_t end, size_t grain, Body &body)
+		{
+			if (grain == 0)
+				grain = 1;
+			if (end <= begin)
+				return;
+			if (end - begin <= grain)
+			{
+				body(begin, end);
+				return;
+			}
+			
+			size_t pieces = (end - begin - 1) / grain + 1;
+			std::vector<_RangeTask<Body> > tasks(pieces);
+			TaskGroup group(*this);
+			for (size_t i = 0; i < pieces; i++)
+			{
+				size_t first = begin + i * grain;
+				tasks[i].set(body, first, end - first < grain ? end : first + grain);
+				group.run(tasks[i]);
+			}
+			group.wait();
+		}
+};
+
+#endif
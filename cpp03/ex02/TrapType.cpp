@@ -0,0 +1,16 @@
+#include "TrapType.hpp"
+
+// In the order of TrapType::Id; FragTrap does not override attack
+static const TrapType TYPES[TrapType::COUNT] = {
+    { "ClapTrap", "ClapTrap", 10, 10, 0, 0 },
+    { "ScavTrap", "ScavTrap", 100, 50, 20, TrapType::ABILITY_GUARD_GATE },
+    { "FragTrap", "ClapTrap", 100, 100, 30, TrapType::ABILITY_HIGH_FIVES }
+};
+
+const TrapType& TrapType::get(Id id) {
+    return TYPES[id];
+}
+
+const TrapType& TrapType::get(unsigned int id) {
+    return TYPES[id];
+}
\ No newline at end of file
@@ -0,0 +1,33 @@
+#ifndef TRAPTYPE_HPP
+#define TRAPTYPE_HPP
+
+// What sets ClapTrap, ScavTrap and FragTrap apart, as data: the stats
+// each starts with, the abilities it has and the names its messages use.
+// A unit keeps only the id of its type, so units of every type can share
+// one array and be processed by the same loop, looking up whatever
+// depends on the type instead of branching on it
+struct TrapType {
+    enum Id {
+        CLAPTRAP,
+        SCAVTRAP,
+        FRAGTRAP,
+        COUNT
+    };
+
+    enum Ability {
+        ABILITY_GUARD_GATE = 1,
+        ABILITY_HIGH_FIVES = 2
+    };
+
+    const char* name;
+    const char* attackName;   // the class whose attack it uses
+    unsigned int hitPoints;
+    unsigned int energyPoints;
+    unsigned int attackDamage;
+    unsigned int abilities;
+
+    static const TrapType& get(Id id);
+    static const TrapType& get(unsigned int id);
+};
+
+#endif
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "ClapTrap.hpp"
 #include "FragTrap.hpp"
+#include "ClapTrapFleet.hpp"
+#include "BattleSimulation.hpp"
+#include "ActionLog.hpp"
 #include <iostream>
 
 int main() {
@@ -16,6 +19,100 @@ int main() {
     frag.beRepaired(10);
     frag.highFivesGuys();
 
+    std::cout << "\n===== FLEET TESTS =====" << std::endl;
+    ClapTrapFleet fleet;
+    size_t alpha = fleet.add("CL4P-A");
+    size_t beta = fleet.add("CL4P-B");
+    fleet.add("CL4P-C");
+    size_t both[] = {alpha, beta};
+    fleet.attack(both, 2, 2);
+    fleet.takeDamage(both, 2, 5);
+    fleet.takeDamage(&beta, 1, 50);
+    fleet.beRepaired(both, 2, 3);
+    fleet.takeDamageAll(1);
+    fleet.writeEvents(std::cout);
+    std::cout << fleet.getEvents().size() << " events recorded" << std::endl;
+
+    std::cout << "\n===== MIXED FLEET TESTS =====" << std::endl;
+    ClapTrapFleet mixed;
+    mixed.add("CL4P-D");
+    mixed.add("SC4V-A", TrapType::SCAVTRAP);
+    mixed.add("FR4G-A", TrapType::FRAGTRAP);
+    size_t all[] = {0, 1, 2};
+    mixed.attack(all + 1, 2, 0);
+    mixed.guardGate(all, 3);
+    mixed.highFivesGuys(all, 3);
+    mixed.takeDamageAll(40);
+    mixed.writeEvents(std::cout);
+
+    std::cout << "\n===== BATTLE SIMULATION TESTS =====" << std::endl;
+    ClapTrapFleet arena;
+    size_t scavUnit = arena.add("SC4V-B", TrapType::SCAVTRAP);
+    size_t fragUnit = arena.add("FR4G-B", TrapType::FRAGTRAP);
+    size_t clapUnit = arena.add("CL4P-E");
+    BattleSimulation battle(arena, 2);
+    battle.setTarget(scavUnit, fragUnit);
+    battle.setTarget(fragUnit, scavUnit);
+    battle.setTarget(clapUnit, fragUnit);
+    for (int t = 0; t < 3; ++t)
+        battle.tick();
+    arena.writeEvents(std::cout);
+    std::cout << "After " << battle.getTickCount() << " ticks: " << arena.getName(scavUnit) << " has "
+              << arena.getHitPoints(scavUnit) << " HP, " << arena.getName(fragUnit) << " has "
+              << arena.getHitPoints(fragUnit) << " HP" << std::endl;
+
+    std::cout << "\n===== PARALLEL BATTLE TESTS =====" << std::endl;
+    ClapTrapFleet serialArmy;
+    serialArmy.setLogging(false);
+    for (unsigned int i = 0; i < 20000; ++i)
+        serialArmy.add("CL4P-R", 10 + i % 50, 5 + i % 7, i % 4);
+    ClapTrapFleet parallelArmy(serialArmy);
+    BattleSimulation serialBattle(serialArmy, 1024);
+    BattleSimulation parallelBattle(parallelArmy, 1024);
+    parallelBattle.setParallel(true);
+    for (size_t u = 0; u < serialArmy.size(); ++u) {
+        size_t target = (u * 7919 + 13) % serialArmy.size();
+        serialBattle.setTarget(u, target);
+        parallelBattle.setTarget(u, target);
+    }
+    for (int t = 0; t < 8; ++t) {
+        serialBattle.tick();
+        parallelBattle.tick();
+    }
+    unsigned long serialTotal = 0;
+    size_t differ = 0;
+    for (size_t u = 0; u < serialArmy.size(); ++u) {
+        serialTotal += serialArmy.getHitPoints(u);
+        if (serialArmy.getHitPoints(u) != parallelArmy.getHitPoints(u)
+            || serialArmy.getEnergyPoints(u) != parallelArmy.getEnergyPoints(u))
+            ++differ;
+    }
+    std::cout << serialArmy.size() << " units after 8 ticks: " << serialTotal << " HP in total, "
+              << differ << " units differ in parallel mode" << std::endl;
+
+    std::cout << "\n===== SNAPSHOT TESTS =====" << std::endl;
+    std::vector<unsigned char> checkpoint;
+    arena.saveSnapshot(checkpoint);
+    std::cout << "Snapshot of " << arena.size() << " units: " << checkpoint.size() << " bytes" << std::endl;
+    battle.tick();
+    std::cout << arena.getName(scavUnit) << " after one more tick: " << arena.getHitPoints(scavUnit) << " HP" << std::endl;
+    arena.restoreSnapshot(&checkpoint[0], checkpoint.size());
+    std::cout << arena.getName(scavUnit) << " after rollback: " << arena.getHitPoints(scavUnit) << " HP" << std::endl;
+
+    std::cout << "\n===== ACTION LOG TESTS =====" << std::endl;
+    ActionLog log;
+    ClapTrap::setActionLog(&log);
+    clap.attack("Bandit");
+    frag.takeDamage(200);
+    frag.beRepaired(10);
+    std::cout << log.size() << " actions queued, nothing printed yet" << std::endl;
+    log.write(std::cout);
+    log.clear();
+    log.setEnabled(false);
+    clap.beRepaired(1);
+    std::cout << log.size() << " actions queued while disabled" << std::endl;
+    ClapTrap::setActionLog(NULL);
+
     std::cout << "\n===== DESTRUCTORS =====" << std::endl;
     return 0;
 }
\ No newline at end of file
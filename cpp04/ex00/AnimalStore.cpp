@@ -0,0 +1,74 @@
+#include "AnimalStore.hpp"
+
+AnimalStore::AnimalStore() {
+}
+
+AnimalStore::AnimalStore(const AnimalStore& other) : dogs(other.dogs), cats(other.cats) {
+}
+
+AnimalStore::~AnimalStore() {
+}
+
+AnimalStore& AnimalStore::operator=(const AnimalStore& other) {
+    if (this != &other) {
+        dogs = other.dogs;
+        cats = other.cats;
+    }
+    return *this;
+}
+
+Dog& AnimalStore::addDog() {
+    dogs.push_back(Dog());
+    return dogs.back();
+}
+
+Cat& AnimalStore::addCat() {
+    cats.push_back(Cat());
+    return cats.back();
+}
+
+void AnimalStore::removeDog(size_t index) {
+    if (index >= dogs.size())
+        return;
+    if (index != dogs.size() - 1)
+        dogs[index] = dogs.back();
+    dogs.pop_back();
+}
+
+void AnimalStore::removeCat(size_t index) {
+    if (index >= cats.size())
+        return;
+    if (index != cats.size() - 1)
+        cats[index] = cats.back();
+    cats.pop_back();
+}
+
+void AnimalStore::reserve(size_t dogCount, size_t catCount) {
+    dogs.reserve(dogCount);
+    cats.reserve(catCount);
+}
+
+size_t AnimalStore::getDogCount() const {
+    return dogs.size();
+}
+
+size_t AnimalStore::getCatCount() const {
+    return cats.size();
+}
+
+Dog& AnimalStore::getDog(size_t index) {
+    return dogs[index];
+}
+
+Cat& AnimalStore::getCat(size_t index) {
+    return cats[index];
+}
+
+// Qualified calls are bound at compile time: the array holds exactly
+// Dogs, or exactly Cats, so there is nothing for a virtual call to decide
+void AnimalStore::makeSounds() const {
+    for (size_t i = 0; i < dogs.size(); i++)
+        dogs[i].Dog::makeSound();
+    for (size_t i = 0; i < cats.size(); i++)
+        cats[i].Cat::makeSound();
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#ifndef ANIMALSTORE_HPP
+#define ANIMALSTORE_HPP
+
+#include "Dog.hpp"
+#include "Cat.hpp"
+#include <vector>
+
+// Dogs and Cats by value, each kind in its own contiguous array, for
+// loops over many animals: a batch works through one array at a time and
+// calls the exact class's functions, with no virtual call per animal and
+// no pointer to follow. Removing an animal moves the last of its kind
+// into its place, so indexes are not stable across removals
+class AnimalStore {
+private:
+    std::vector<Dog> dogs;
+    std::vector<Cat> cats;
+
+public:
+    AnimalStore();
+    AnimalStore(const AnimalStore& other);
+    ~AnimalStore();
+    AnimalStore& operator=(const AnimalStore& other);
+
+    Dog& addDog();
+    Cat& addCat();
+    void removeDog(size_t index);
+    void removeCat(size_t index);
+    void reserve(size_t dogCount, size_t catCount);
+
+    size_t getDogCount() const;
+    size_t getCatCount() const;
+    Dog& getDog(size_t index);
+    Cat& getCat(size_t index);
+
+    // Every dog, then every cat, makes its sound
+    void makeSounds() const;
+
+    // Call update(dog) for every dog, or update(cat) for every cat
+    template <typename Function>
+    void updateDogs(Function& update) {
+        for (size_t i = 0; i < dogs.size(); i++)
+            update(dogs[i]);
+    }
+
+    template <typename Function>
+    void updateCats(Function& update) {
+        for (size_t i = 0; i < cats.size(); i++)
+            update(cats[i]);
+    }
+};
+
+#endif
\ No newline at end of file
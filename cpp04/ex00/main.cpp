@@ -3,8 +3,22 @@
 #include "Cat.hpp"
 #include "WrongAnimal.hpp"
 #include "WrongCat.hpp"
+#include "AnimalStore.hpp"
 #include <iostream>
 
+// Update for AnimalStore: counts the animals it is given
+struct AnimalCounter {
+    size_t count;
+
+    AnimalCounter() : count(0) {
+    }
+
+    void operator()(const Animal& animal) {
+        if (!animal.getType().empty())
+            count++;
+    }
+};
+
 int main()
 {
     const Animal* meta = new Animal();
@@ -56,5 +70,17 @@ int main()
     Animal animalCat = Cat();
     animalCat.makeSound();
 
+    std::cout << "\n=== Flat Storage Test ===" << std::endl;
+    AnimalStore store;
+    store.reserve(2, 1);
+    store.addDog();
+    store.addDog();
+    store.addCat();
+    store.makeSounds();
+    AnimalCounter counter;
+    store.updateDogs(counter);
+    store.updateCats(counter);
+    std::cout << "Animals visited: " << counter.count << std::endl;
+
     return 0;
 }
\ No newline at end of file
@@ -1,35 +1,128 @@
 #include "Brain.hpp"
 #include <iostream>
+#include <cstring>
 
-Brain::Brain() {
+std::string Brain::IdeaView::str() const {
+    return std::string(data, length);
+}
+
+Brain::Brain() : shared(new Ideas()) {
     std::cout << "Brain constructor called" << std::endl;
 }
 
-Brain::Brain(const Brain& other) {
-    *this = other;
+Brain::Brain(const Brain& other) : shared(other.shared) {
+    shared->refs++;
     std::cout << "Brain copy constructor called" << std::endl;
 }
 
 Brain::~Brain() {
+    release();
     std::cout << "Brain destructor called" << std::endl;
 }
 
 Brain& Brain::operator=(const Brain& other) {
     if (this != &other) {
-        for (int i = 0; i < 100; i++) {
-            ideas[i] = other.ideas[i];
-        }
+        other.shared->refs++;
+        release();
+        shared = other.shared;
     }
     return *this;
 }
 
+void Brain::release() {
+    if (--shared->refs == 0)
+        delete shared;
+}
+
+// A private copy of shared ideas, packed on the way
+void Brain::detach() {
+    if (shared->refs == 1)
+        return;
+    Ideas* own = new Ideas();
+    own->arena.reserve(shared->arena.size() - shared->unused);
+    own->spans.resize(shared->spans.size());
+    for (size_t i = 0; i < shared->spans.size(); i++) {
+        const Span& span = shared->spans[i];
+        own->spans[i].offset = static_cast<unsigned int>(own->arena.size());
+        own->spans[i].length = span.length;
+        own->arena.append(shared->arena, span.offset, span.length);
+    }
+    release();
+    shared = own;
+}
+
+// Rebuild the arena with only the bytes the ideas still use
+void Brain::compact() {
+    std::string packed;
+    packed.reserve(shared->arena.size() - shared->unused);
+    for (size_t i = 0; i < shared->spans.size(); i++) {
+        Span& span = shared->spans[i];
+        unsigned int offset = static_cast<unsigned int>(packed.size());
+        packed.append(shared->arena, span.offset, span.length);
+        span.offset = offset;
+    }
+    shared->arena.swap(packed);
+    shared->unused = 0;
+}
+
+// A new idea no longer than the old one is written over it; a longer one
+// is added at the end, and the arena is packed once over half of it is
+// unused
 void Brain::setIdea(int index, const std::string& idea) {
-    if (index >= 0 && index < 100)
-        ideas[index] = idea;
+    if (index < 0 || index >= 100)
+        return;
+    detach();
+    std::vector<Span>& spans = shared->spans;
+    if (static_cast<size_t>(index) >= spans.size()) {
+        Span empty = {0, 0};
+        spans.resize(index + 1, empty);
+    }
+    Span& span = spans[index];
+    if (idea.size() <= span.length) {
+        if (!idea.empty())
+            std::memcpy(&shared->arena[span.offset], idea.data(), idea.size());
+        shared->unused += span.length - idea.size();
+    } else {
+        shared->unused += span.length;
+        span.offset = static_cast<unsigned int>(shared->arena.size());
+        shared->arena.append(idea);
+    }
+    span.length = static_cast<unsigned int>(idea.size());
+    if (shared->unused > 64 && shared->unused * 2 > shared->arena.size())
+        compact();
 }
 
 std::string Brain::getIdea(int index) const {
-    if (index >= 0 && index < 100)
-        return ideas[index];
-    return "";
+    return getIdeaView(index).str();
+}
+
+Brain::IdeaView Brain::getIdeaView(int index) const {
+    IdeaView view = {"", 0};
+    if (index >= 0 && static_cast<size_t>(index) < shared->spans.size()) {
+        const Span& span = shared->spans[index];
+        if (span.length)
+            view.data = shared->arena.data() + span.offset;
+        view.length = span.length;
+    }
+    return view;
+}
+
+void Brain::clear() {
+    if (shared->refs > 1) {
+        release();
+        shared = new Ideas();
+        return;
+    }
+    shared->arena.clear();
+    shared->spans.clear();
+    shared->unused = 0;
+}
+
+bool Brain::isShared() const {
+    return shared->refs > 1;
+}
+
+size_t Brain::getMemoryUsage() const {
+    return sizeof(Brain) + sizeof(Ideas) + shared->arena.capacity()
+        + shared->spans.capacity() * sizeof(Span);
 }
\ No newline at end of file
@@ -2,10 +2,46 @@
 #define BRAIN_HPP
 
 #include <string>
+#include <vector>
+#include <cstddef>
 
+// Up to 100 ideas, stored as the bytes of each in one arena buffer with
+// an offset and a length for every index up to the last one set, so a
+// Brain takes memory for what it holds rather than for 100 strings.
+// Copies of a Brain share its ideas until one of them calls setIdea,
+// which gives that Brain a copy of its own first, so copying a Brain, and
+// with it a Dog or a Cat, costs no string copies until the copy changes
 class Brain {
+public:
+    // An idea in place: valid until the next setIdea on this Brain
+    struct IdeaView {
+        const char* data;
+        size_t length;
+
+        std::string str() const;
+    };
+
 private:
-    std::string ideas[100];
+    struct Span {
+        unsigned int offset;
+        unsigned int length;
+    };
+
+    struct Ideas {
+        std::string arena;
+        std::vector<Span> spans;
+        size_t unused;    // bytes of the arena no idea uses any more
+        unsigned int refs;
+
+        Ideas() : unused(0), refs(1) {
+        }
+    };
+
+    Ideas* shared;
+
+    void release();
+    void detach();
+    void compact();
 
 public:
     Brain();
@@ -14,6 +50,14 @@ public:
     Brain& operator=(const Brain& other);
     void setIdea(int index, const std::string& idea);
     std::string getIdea(int index) const;
+    // The idea without copying it; empty for an unset index
+    IdeaView getIdeaView(int index) const;
+    // Forget every idea, keeping the arena for the next ones when not shared
+    void clear();
+    // True while another Brain shares these ideas
+    bool isShared() const;
+    // Bytes used by the ideas and their offsets
+    size_t getMemoryUsage() const;
 };
 
 #endif
\ No newline at end of file
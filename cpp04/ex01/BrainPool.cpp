@@ -0,0 +1,62 @@
+#include "BrainPool.hpp"
+
+BrainPool::BrainPool() : created(0) {
+}
+
+BrainPool::BrainPool(const BrainPool& other) : created(other.created) {
+}
+
+BrainPool& BrainPool::operator=(const BrainPool& other) {
+    (void)other;
+    return *this;
+}
+
+BrainPool::~BrainPool() {
+    trim();
+}
+
+BrainPool& BrainPool::getInstance() {
+    static BrainPool pool;
+    return pool;
+}
+
+Brain* BrainPool::acquire() {
+    if (freeBrains.empty()) {
+        created++;
+        return new Brain();
+    }
+    Brain* brain = freeBrains.back();
+    freeBrains.pop_back();
+    return brain;
+}
+
+Brain* BrainPool::acquire(const Brain& other) {
+    Brain* brain = acquire();
+    *brain = other;
+    return brain;
+}
+
+void BrainPool::release(Brain* brain) {
+    if (!brain)
+        return;
+    if (freeBrains.size() >= MAX_FREE) {
+        delete brain;
+        return;
+    }
+    brain->clear();
+    freeBrains.push_back(brain);
+}
+
+void BrainPool::trim() {
+    for (size_t i = 0; i < freeBrains.size(); i++)
+        delete freeBrains[i];
+    freeBrains.clear();
+}
+
+size_t BrainPool::getFreeCount() const {
+    return freeBrains.size();
+}
+
+size_t BrainPool::getCreatedCount() const {
+    return created;
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#ifndef BRAINPOOL_HPP
+#define BRAINPOOL_HPP
+
+#include "Brain.hpp"
+#include <vector>
+#include <cstddef>
+
+// Brains that Dogs and Cats handed back, kept for the next ones instead of
+// being deleted: acquire takes a free Brain when there is one and only
+// allocates when there is none, and release clears the Brain and keeps it,
+// arena included, up to MAX_FREE of them. A reused Brain is not
+// constructed again, so it prints no constructor message
+class BrainPool {
+private:
+    std::vector<Brain*> freeBrains;
+    size_t created;
+
+    BrainPool();
+    BrainPool(const BrainPool& other);
+    BrainPool& operator=(const BrainPool& other);
+
+public:
+    static const size_t MAX_FREE = 1024;
+
+    ~BrainPool();
+
+    // The pool Dog and Cat use
+    static BrainPool& getInstance();
+
+    // An empty Brain, or one sharing the ideas of other
+    Brain* acquire();
+    Brain* acquire(const Brain& other);
+    // Give back a Brain from acquire; it must not be used after
+    void release(Brain* brain);
+    // Delete the free Brains
+    void trim();
+
+    size_t getFreeCount() const;
+    // Brains the pool has allocated so far
+    size_t getCreatedCount() const;
+};
+
+#endif
\ No newline at end of file
@@ -1,27 +1,26 @@
 #include "Cat.hpp"
+#include "BrainPool.hpp"
 
 Cat::Cat() : Animal() {
     type = "Cat";
-    brain = new Brain();
+    brain = BrainPool::getInstance().acquire();
     std::cout << "Cat constructor called" << std::endl;
 }
 
 Cat::Cat(const Cat& other) : Animal(other) {
-    brain = new Brain(*other.brain);
+    brain = BrainPool::getInstance().acquire(*other.brain);
     std::cout << "Cat copy constructor called" << std::endl;
 }
 
 Cat::~Cat() {
-    delete brain;
+    BrainPool::getInstance().release(brain);
     std::cout << "Cat destructor called" << std::endl;
 }
 
 Cat& Cat::operator=(const Cat& other) {
     if (this != &other) {
         Animal::operator=(other);
-        if (brain)
-            delete brain;
-        brain = new Brain(*other.brain);
+        *brain = *other.brain;
     }
     return *this;
 }
@@ -1,27 +1,26 @@
 #include "Dog.hpp"
+#include "BrainPool.hpp"
 
 Dog::Dog() : Animal() {
     type = "Dog";
-    brain = new Brain();
+    brain = BrainPool::getInstance().acquire();
     std::cout << "Dog constructor called" << std::endl;
 }
 
 Dog::Dog(const Dog& other) : Animal(other) {
-    brain = new Brain(*other.brain);
+    brain = BrainPool::getInstance().acquire(*other.brain);
     std::cout << "Dog copy constructor called" << std::endl;
 }
 
 Dog::~Dog() {
-    delete brain;
+    BrainPool::getInstance().release(brain);
     std::cout << "Dog destructor called" << std::endl;
 }
 
 Dog& Dog::operator=(const Dog& other) {
     if (this != &other) {
         Animal::operator=(other);
-        if (brain)
-            delete brain;
-        brain = new Brain(*other.brain);
+        *brain = *other.brain;
     }
     return *this;
 }
@@ -1,5 +1,6 @@
 #include "Dog.hpp"
 #include "Cat.hpp"
+#include "BrainPool.hpp"
 #include <iostream>
 
 int main() {
@@ -20,16 +21,40 @@ int main() {
     std::cout << "\n===== DEEP COPY TEST =====" << std::endl;
     Dog originalDog;
     originalDog.getBrain()->setIdea(0, "Chase the cat!");
-    Dog copiedDog = originalDog; // Deep copy
+    Dog copiedDog = originalDog; // Shares the ideas until one changes
+    std::cout << "Brains shared after copy: " << (copiedDog.getBrain()->isShared() ? "yes" : "no") << std::endl;
 
     std::cout << "Original Dog's idea: " << originalDog.getBrain()->getIdea(0) << std::endl;
     std::cout << "Copied Dog's idea: " << copiedDog.getBrain()->getIdea(0) << std::endl;
 
     copiedDog.getBrain()->setIdea(0, "Squirrel?");
+    std::cout << "Brains shared after setIdea: " << (copiedDog.getBrain()->isShared() ? "yes" : "no") << std::endl;
     std::cout << "After modification:" << std::endl;
     std::cout << "Original Dog's idea: " << originalDog.getBrain()->getIdea(0) << std::endl;
     std::cout << "Copied Dog's idea: " << copiedDog.getBrain()->getIdea(0) << std::endl;
 
+    std::cout << "\n===== COMPACT BRAIN TEST =====" << std::endl;
+    Cat thinker;
+    thinker.getBrain()->setIdea(0, "Nap in the sun");
+    thinker.getBrain()->setIdea(3, "Knock the glass off the table");
+    Brain::IdeaView view = thinker.getBrain()->getIdeaView(3);
+    std::cout << "Idea 3 in place: ";
+    std::cout.write(view.data, view.length);
+    std::cout << std::endl;
+    std::cout << "Idea 1 (unset): \"" << thinker.getBrain()->getIdea(1) << "\"" << std::endl;
+    std::cout << "Brain memory: " << thinker.getBrain()->getMemoryUsage() << " bytes, instead of "
+              << sizeof(Brain*) + 100 * sizeof(std::string) << std::endl;
+    std::cout << "\n===== BRAIN POOL TEST =====" << std::endl;
+    BrainPool& pool = BrainPool::getInstance();
+    size_t createdBefore = pool.getCreatedCount();
+    for (int round = 0; round < 3; ++round) {
+        Animal* pack[4];
+        for (int k = 0; k < 4; ++k) pack[k] = (k % 2) ? static_cast<Animal*>(new Cat()) : new Dog();
+        for (int k = 0; k < 4; ++k) delete pack[k];
+    }
+    std::cout << "Brains allocated for 3 rounds of 4 animals: " << pool.getCreatedCount() - createdBefore << std::endl;
+    Dog reused;
+    std::cout << "Reused brain starts empty: " << (reused.getBrain()->getIdea(0).empty() ? "yes" : "no") << std::endl;
     std::cout << "\n===== END OF TESTS =====" << std::endl;
     return 0;
 }
\ No newline at end of file
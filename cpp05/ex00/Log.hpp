@@ -0,0 +1,20 @@
+#ifndef LOG_HPP
+#define LOG_HPP
+
+#include <iostream>
+
+// Messages compiled in: LOG_LEVEL 0 for none, 1, the default, for the
+// constructor, copy, assignment and destructor messages of the demo.
+// make re LOG_LEVEL=0 builds without them, so creating and destroying
+// objects costs no output and the strings are not even in the binary
+#ifndef LOG_LEVEL
+# define LOG_LEVEL 1
+#endif
+
+#if LOG_LEVEL >= 1
+# define LOG_LIFECYCLE(message) (std::cout << message << std::endl)
+#else
+# define LOG_LIFECYCLE(message) ((void)0)
+#endif
+
+#endif
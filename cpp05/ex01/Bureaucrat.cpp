@@ -1,15 +1,16 @@
 #include "Bureaucrat.hpp"
+#include "Log.hpp"
 #include "Form.hpp"
 
 // Orthodox Canonical Form
 Bureaucrat::Bureaucrat() : _name("Default"), _grade(150)
 {
-	std::cout << "Bureaucrat default constructor called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat default constructor called");
 }
 
 Bureaucrat::Bureaucrat(const std::string& name, int grade) : _name(name)
 {
-	std::cout << "Bureaucrat parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat parametric constructor called");
 	if (grade < 1)
 		throw GradeTooHighException();
 	if (grade > 150)
@@ -19,12 +20,12 @@ Bureaucrat::Bureaucrat(const std::string& name, int grade) : _name(name)
 
 Bureaucrat::Bureaucrat(const Bureaucrat& other) : _name(other._name), _grade(other._grade)
 {
-	std::cout << "Bureaucrat copy constructor called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat copy constructor called");
 }
 
 Bureaucrat& Bureaucrat::operator=(const Bureaucrat& other)
 {
-	std::cout << "Bureaucrat assignment operator called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat assignment operator called");
 	if (this != &other)
 	{
 		// Note: _name is const, so we can't assign it
@@ -36,7 +37,7 @@ Bureaucrat& Bureaucrat::operator=(const Bureaucrat& other)
 
 Bureaucrat::~Bureaucrat()
 {
-	std::cout << "Bureaucrat destructor called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat destructor called");
 }
 
 // Getters
@@ -1,16 +1,17 @@
 #include "Form.hpp"
+#include "Log.hpp"
 #include "Bureaucrat.hpp"
 
 // Orthodox Canonical Form
 Form::Form() : _name("Default Form"), _signed(false), _gradeToSign(150), _gradeToExecute(150)
 {
-	std::cout << "Form default constructor called" << std::endl;
+	LOG_LIFECYCLE("Form default constructor called");
 }
 
 Form::Form(const std::string& name, int gradeToSign, int gradeToExecute) 
 	: _name(name), _signed(false), _gradeToSign(gradeToSign), _gradeToExecute(gradeToExecute)
 {
-	std::cout << "Form parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("Form parametric constructor called");
 	if (gradeToSign < 1 || gradeToExecute < 1)
 		throw GradeTooHighException();
 	if (gradeToSign > 150 || gradeToExecute > 150)
@@ -21,12 +22,12 @@ Form::Form(const Form& other)
 	: _name(other._name), _signed(other._signed), 
 	  _gradeToSign(other._gradeToSign), _gradeToExecute(other._gradeToExecute)
 {
-	std::cout << "Form copy constructor called" << std::endl;
+	LOG_LIFECYCLE("Form copy constructor called");
 }
 
 Form& Form::operator=(const Form& other)
 {
-	std::cout << "Form assignment operator called" << std::endl;
+	LOG_LIFECYCLE("Form assignment operator called");
 	if (this != &other)
 	{
 		// Note: _name, _gradeToSign, and _gradeToExecute are const, so we can't assign them
@@ -38,7 +39,7 @@ Form& Form::operator=(const Form& other)
 
 Form::~Form()
 {
-	std::cout << "Form destructor called" << std::endl;
+	LOG_LIFECYCLE("Form destructor called");
 }
 
 // Getters
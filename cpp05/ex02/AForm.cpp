@@ -1,16 +1,17 @@
 #include "AForm.hpp"
+#include "Log.hpp"
 #include "Bureaucrat.hpp"
 
 // Orthodox Canonical Form
 AForm::AForm() : _name("Default AForm"), _signed(false), _gradeToSign(150), _gradeToExecute(150)
 {
-	std::cout << "AForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("AForm default constructor called");
 }
 
 AForm::AForm(const std::string& name, int gradeToSign, int gradeToExecute) 
 	: _name(name), _signed(false), _gradeToSign(gradeToSign), _gradeToExecute(gradeToExecute)
 {
-	std::cout << "AForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("AForm parametric constructor called");
 	if (gradeToSign < 1 || gradeToExecute < 1)
 		throw GradeTooHighException();
 	if (gradeToSign > 150 || gradeToExecute > 150)
@@ -21,12 +22,12 @@ AForm::AForm(const AForm& other)
 	: _name(other._name), _signed(other._signed), 
 	  _gradeToSign(other._gradeToSign), _gradeToExecute(other._gradeToExecute)
 {
-	std::cout << "AForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("AForm copy constructor called");
 }
 
 AForm& AForm::operator=(const AForm& other)
 {
-	std::cout << "AForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("AForm assignment operator called");
 	if (this != &other)
 	{
 		// Note: _name, _gradeToSign, and _gradeToExecute are const, so we can't assign them
@@ -38,7 +39,7 @@ AForm& AForm::operator=(const AForm& other)
 
 AForm::~AForm()
 {
-	std::cout << "AForm destructor called" << std::endl;
+	LOG_LIFECYCLE("AForm destructor called");
 }
 
 // Getters
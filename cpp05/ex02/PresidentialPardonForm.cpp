@@ -1,26 +1,27 @@
 #include "PresidentialPardonForm.hpp"
+#include "Log.hpp"
 
 // Orthodox Canonical Form
 PresidentialPardonForm::PresidentialPardonForm() : AForm("Presidential Pardon Form", 25, 5), _target("default")
 {
-	std::cout << "PresidentialPardonForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm default constructor called");
 }
 
 PresidentialPardonForm::PresidentialPardonForm(const std::string& target) 
 	: AForm("Presidential Pardon Form", 25, 5), _target(target)
 {
-	std::cout << "PresidentialPardonForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm parametric constructor called");
 }
 
 PresidentialPardonForm::PresidentialPardonForm(const PresidentialPardonForm& other)
 	: AForm(other), _target(other._target)
 {
-	std::cout << "PresidentialPardonForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm copy constructor called");
 }
 
 PresidentialPardonForm& PresidentialPardonForm::operator=(const PresidentialPardonForm& other)
 {
-	std::cout << "PresidentialPardonForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm assignment operator called");
 	if (this != &other)
 	{
 		AForm::operator=(other);
@@ -31,7 +32,7 @@ PresidentialPardonForm& PresidentialPardonForm::operator=(const PresidentialPard
 
 PresidentialPardonForm::~PresidentialPardonForm()
 {
-	std::cout << "PresidentialPardonForm destructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm destructor called");
 }
 
 // Getter
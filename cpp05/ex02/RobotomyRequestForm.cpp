@@ -1,26 +1,27 @@
 #include "RobotomyRequestForm.hpp"
+#include "Log.hpp"
 
 // Orthodox Canonical Form
 RobotomyRequestForm::RobotomyRequestForm() : AForm("Robotomy Request Form", 72, 45), _target("default")
 {
-	std::cout << "RobotomyRequestForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm default constructor called");
 }
 
 RobotomyRequestForm::RobotomyRequestForm(const std::string& target) 
 	: AForm("Robotomy Request Form", 72, 45), _target(target)
 {
-	std::cout << "RobotomyRequestForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm parametric constructor called");
 }
 
 RobotomyRequestForm::RobotomyRequestForm(const RobotomyRequestForm& other)
 	: AForm(other), _target(other._target)
 {
-	std::cout << "RobotomyRequestForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm copy constructor called");
 }
 
 RobotomyRequestForm& RobotomyRequestForm::operator=(const RobotomyRequestForm& other)
 {
-	std::cout << "RobotomyRequestForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm assignment operator called");
 	if (this != &other)
 	{
 		AForm::operator=(other);
@@ -31,7 +32,7 @@ RobotomyRequestForm& RobotomyRequestForm::operator=(const RobotomyRequestForm& o
 
 RobotomyRequestForm::~RobotomyRequestForm()
 {
-	std::cout << "RobotomyRequestForm destructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm destructor called");
 }
 
 // Getter
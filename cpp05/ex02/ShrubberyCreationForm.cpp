@@ -1,26 +1,27 @@
 #include "ShrubberyCreationForm.hpp"
+#include "Log.hpp"
 
 // Orthodox Canonical Form
 ShrubberyCreationForm::ShrubberyCreationForm() : AForm("Shrubbery Creation Form", 145, 137), _target("default")
 {
-	std::cout << "ShrubberyCreationForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm default constructor called");
 }
 
 ShrubberyCreationForm::ShrubberyCreationForm(const std::string& target) 
 	: AForm("Shrubbery Creation Form", 145, 137), _target(target)
 {
-	std::cout << "ShrubberyCreationForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm parametric constructor called");
 }
 
 ShrubberyCreationForm::ShrubberyCreationForm(const ShrubberyCreationForm& other)
 	: AForm(other), _target(other._target)
 {
-	std::cout << "ShrubberyCreationForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm copy constructor called");
 }
 
 ShrubberyCreationForm& ShrubberyCreationForm::operator=(const ShrubberyCreationForm& other)
 {
-	std::cout << "ShrubberyCreationForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm assignment operator called");
 	if (this != &other)
 	{
 		AForm::operator=(other);
@@ -31,7 +32,7 @@ ShrubberyCreationForm& ShrubberyCreationForm::operator=(const ShrubberyCreationF
 
 ShrubberyCreationForm::~ShrubberyCreationForm()
 {
-	std::cout << "ShrubberyCreationForm destructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm destructor called");
 }
 
 // Getter
@@ -1,16 +1,27 @@
 #include "AForm.hpp"
+#include "Log.hpp"
 #include "Bureaucrat.hpp"
 
 // Orthodox Canonical Form
-AForm::AForm() : _name("Default AForm"), _signed(false), _gradeToSign(150), _gradeToExecute(150)
+AForm::AForm() : _name(intern("Default AForm")), _signed(false), _gradeToSign(150), _gradeToExecute(150)
 {
-	std::cout << "AForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("AForm default constructor called");
 }
 
 AForm::AForm(const std::string& name, int gradeToSign, int gradeToExecute) 
+	: _name(intern(name)), _signed(false), _gradeToSign(gradeToSign), _gradeToExecute(gradeToExecute)
+{
+	LOG_LIFECYCLE("AForm parametric constructor called");
+	if (gradeToSign < 1 || gradeToExecute < 1)
+		throw GradeTooHighException();
+	if (gradeToSign > 150 || gradeToExecute > 150)
+		throw GradeTooLowException();
+}
+
+AForm::AForm(const std::string* name, int gradeToSign, int gradeToExecute) 
 	: _name(name), _signed(false), _gradeToSign(gradeToSign), _gradeToExecute(gradeToExecute)
 {
-	std::cout << "AForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("AForm parametric constructor called");
 	if (gradeToSign < 1 || gradeToExecute < 1)
 		throw GradeTooHighException();
 	if (gradeToSign > 150 || gradeToExecute > 150)
@@ -21,12 +32,12 @@ AForm::AForm(const AForm& other)
 	: _name(other._name), _signed(other._signed), 
 	  _gradeToSign(other._gradeToSign), _gradeToExecute(other._gradeToExecute)
 {
-	std::cout << "AForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("AForm copy constructor called");
 }
 
 AForm& AForm::operator=(const AForm& other)
 {
-	std::cout << "AForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("AForm assignment operator called");
 	if (this != &other)
 	{
 		// Note: _name, _gradeToSign, and _gradeToExecute are const, so we can't assign them
@@ -38,13 +49,32 @@ AForm& AForm::operator=(const AForm& other)
 
 AForm::~AForm()
 {
-	std::cout << "AForm destructor called" << std::endl;
+	LOG_LIFECYCLE("AForm destructor called");
+}
+
+// The output of the calling thread, NULL for std::cout
+static __thread std::ostream* threadOutput = NULL;
+
+std::ostream& AForm::out()
+{
+	return threadOutput ? *threadOutput : std::cout;
+}
+
+void AForm::setOutput(std::ostream* stream)
+{
+	threadOutput = stream;
 }
 
 // Getters
+const std::string* AForm::intern(const std::string& name)
+{
+	static std::set<std::string> names;
+	return &*names.insert(name).first;
+}
+
 const std::string& AForm::getName() const
 {
-	return _name;
+	return *_name;
 }
 
 bool AForm::getSigned() const
@@ -64,19 +94,39 @@ int AForm::getGradeToExecute() const
 
 // Member functions
 void AForm::beSigned(const Bureaucrat& bureaucrat)
+{
+	throwFor(trySign(bureaucrat));
+}
+
+void AForm::execute(const Bureaucrat& executor) const
+{
+	throwFor(tryExecute(executor));
+}
+
+AForm::FormStatus AForm::trySign(const Bureaucrat& bureaucrat)
 {
 	if (bureaucrat.getGrade() > _gradeToSign)
-		throw GradeTooLowException();
+		return FORM_GRADE_TOO_LOW;
 	_signed = true;
+	return FORM_OK;
 }
 
-void AForm::execute(const Bureaucrat& executor) const
+AForm::FormStatus AForm::tryExecute(const Bureaucrat& executor) const
 {
 	if (!_signed)
-		throw FormNotSignedException();
+		return FORM_NOT_SIGNED;
 	if (executor.getGrade() > _gradeToExecute)
-		throw GradeTooLowException();
+		return FORM_GRADE_TOO_LOW;
 	executeAction();
+	return FORM_OK;
+}
+
+void AForm::throwFor(FormStatus status)
+{
+	if (status == FORM_GRADE_TOO_LOW)
+		throw GradeTooLowException();
+	if (status == FORM_NOT_SIGNED)
+		throw FormNotSignedException();
 }
 
 // Exception classes implementation
@@ -4,13 +4,14 @@
 #include <iostream>
 #include <string>
 #include <exception>
+#include <set>
 
 class Bureaucrat; // Forward declaration
 
 class AForm
 {
 private:
-	const std::string	_name;
+	const std::string*	_name;	// interned, shared by every form of the name
 	bool				_signed;
 	const int			_gradeToSign;
 	const int			_gradeToExecute;
@@ -19,23 +20,52 @@ public:
 	// Orthodox Canonical Form
 	AForm();
 	AForm(const std::string& name, int gradeToSign, int gradeToExecute);
+	// For names already interned, as the form classes keep theirs: no
+	// lookup and no string copy
+	AForm(const std::string* name, int gradeToSign, int gradeToExecute);
 	AForm(const AForm& other);
 	AForm& operator=(const AForm& other);
 	virtual ~AForm();
 
+	// The one stored copy of name, added the first time it is asked for;
+	// interned names live until the program ends
+	static const std::string*	intern(const std::string& name);
+
 	// Getters
 	const std::string&	getName() const;
 	bool				getSigned() const;
 	int					getGradeToSign() const;
 	int					getGradeToExecute() const;
 
+	// Why trySign or tryExecute turned a bureaucrat down, if it did
+	enum FormStatus
+	{
+		FORM_OK,
+		FORM_GRADE_TOO_LOW,
+		FORM_NOT_SIGNED
+	};
+
 	// Member functions
 	void				beSigned(const Bureaucrat& bureaucrat);
 	void				execute(const Bureaucrat& executor) const;
 
+	// The same without exceptions, for callers expecting many refusals:
+	// sign or execute and return FORM_OK, or change nothing and return the
+	// reason. beSigned and execute throw for the reasons these return
+	FormStatus			trySign(const Bureaucrat& bureaucrat);
+	FormStatus			tryExecute(const Bureaucrat& executor) const;
+	// Throw the exception for a reason other than FORM_OK
+	static void			throwFor(FormStatus status);
+
 	// Pure virtual function - makes this class abstract
 	virtual void		executeAction() const = 0;
 
+	// Where actions print: std::cout, unless the calling thread gave
+	// setOutput another stream (NULL restores std::cout). FormBatch gives
+	// each action it runs on its pool a stream of its own
+	static std::ostream&	out();
+	static void				setOutput(std::ostream* stream);
+
 	// Exception classes
 	class GradeTooHighException : public std::exception
 	{
@@ -1,42 +1,58 @@
 #include "Bureaucrat.hpp"
+#include "Log.hpp"
 #include "AForm.hpp"
+#include "BureaucratIndex.hpp"
 
 // Orthodox Canonical Form
-Bureaucrat::Bureaucrat() : _name("Default"), _grade(150)
+Bureaucrat::Bureaucrat() : _name("Default"), _grade(150), _index(NULL), _indexPosition(0)
 {
-	std::cout << "Bureaucrat default constructor called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat default constructor called");
 }
 
-Bureaucrat::Bureaucrat(const std::string& name, int grade) : _name(name)
+Bureaucrat::Bureaucrat(const std::string& name, int grade) : _name(name), _grade(150), _index(NULL), _indexPosition(0)
 {
-	std::cout << "Bureaucrat parametric constructor called" << std::endl;
-	if (grade < 1)
+	LOG_LIFECYCLE("Bureaucrat parametric constructor called");
+	GradeStatus status = checkGrade(grade);
+	if (status == GRADE_TOO_HIGH)
 		throw GradeTooHighException();
-	if (grade > 150)
+	if (status == GRADE_TOO_LOW)
 		throw GradeTooLowException();
 	_grade = grade;
 }
 
-Bureaucrat::Bureaucrat(const Bureaucrat& other) : _name(other._name), _grade(other._grade)
+// A copy is in no index, whatever the original is in
+Bureaucrat::Bureaucrat(const Bureaucrat& other) : _name(other._name), _grade(other._grade), _index(NULL),
+	_indexPosition(0)
 {
-	std::cout << "Bureaucrat copy constructor called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat copy constructor called");
 }
 
 Bureaucrat& Bureaucrat::operator=(const Bureaucrat& other)
 {
-	std::cout << "Bureaucrat assignment operator called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat assignment operator called");
 	if (this != &other)
 	{
 		// Note: _name is const, so we can't assign it
 		// In a real scenario, we might need to handle this differently
-		_grade = other._grade;
+		setGrade(other._grade);
 	}
 	return *this;
 }
 
 Bureaucrat::~Bureaucrat()
 {
-	std::cout << "Bureaucrat destructor called" << std::endl;
+	LOG_LIFECYCLE("Bureaucrat destructor called");
+	if (_index)
+		_index->remove(*this);
+}
+
+// Every grade change goes through here, to keep the index in step
+void Bureaucrat::setGrade(int grade)
+{
+	if (_index)
+		_index->regrade(*this, grade);
+	else
+		_grade = grade;
 }
 
 // Getters
@@ -53,37 +69,64 @@ int Bureaucrat::getGrade() const
 // Member functions
 void Bureaucrat::incrementGrade()
 {
-	if (_grade <= 1)
+	if (tryIncrementGrade() != GRADE_OK)
 		throw GradeTooHighException();
-	_grade--;
 }
 
 void Bureaucrat::decrementGrade()
 {
-	if (_grade >= 150)
+	if (tryDecrementGrade() != GRADE_OK)
 		throw GradeTooLowException();
-	_grade++;
+}
+
+Bureaucrat::GradeStatus Bureaucrat::tryIncrementGrade()
+{
+	if (_grade <= 1)
+		return GRADE_TOO_HIGH;
+	setGrade(_grade - 1);
+	return GRADE_OK;
+}
+
+Bureaucrat::GradeStatus Bureaucrat::tryDecrementGrade()
+{
+	if (_grade >= 150)
+		return GRADE_TOO_LOW;
+	setGrade(_grade + 1);
+	return GRADE_OK;
+}
+
+Bureaucrat::GradeStatus Bureaucrat::checkGrade(int grade)
+{
+	if (grade < 1)
+		return GRADE_TOO_HIGH;
+	if (grade > 150)
+		return GRADE_TOO_LOW;
+	return GRADE_OK;
 }
 
 void Bureaucrat::signForm(AForm& form)
 {
-	try
-	{
-		form.beSigned(*this);
+	if (form.trySign(*this) == AForm::FORM_OK)
 		std::cout << _name << " signed " << form.getName() << std::endl;
-	}
-	catch (std::exception& e)
-	{
-		std::cout << _name << " couldn't sign " << form.getName() << " because " << e.what() << std::endl;
-	}
+	else
+		std::cout << _name << " couldn't sign " << form.getName() << " because "
+			<< AForm::GradeTooLowException().what() << std::endl;
 }
 
 void Bureaucrat::executeForm(const AForm& form) const
 {
+	// Refusals come back as a status; only the action itself may throw
 	try
 	{
-		form.execute(*this);
-		std::cout << _name << " executed " << form.getName() << std::endl;
+		AForm::FormStatus status = form.tryExecute(*this);
+		if (status == AForm::FORM_OK)
+			std::cout << _name << " executed " << form.getName() << std::endl;
+		else if (status == AForm::FORM_NOT_SIGNED)
+			std::cout << _name << " couldn't execute " << form.getName() << " because "
+				<< AForm::FormNotSignedException().what() << std::endl;
+		else
+			std::cout << _name << " couldn't execute " << form.getName() << " because "
+				<< AForm::GradeTooLowException().what() << std::endl;
 	}
 	catch (std::exception& e)
 	{
@@ -6,6 +6,7 @@
 #include <exception>
 
 class AForm; // Forward declaration
+class BureaucratIndex;
 
 class Bureaucrat
 {
@@ -13,6 +14,14 @@ private:
 	const std::string	_name;
 	int					_grade;
 
+	// The index this bureaucrat is in, if any, and where in it
+	BureaucratIndex*	_index;
+	size_t				_indexPosition;
+
+	friend class BureaucratIndex;
+
+	void				setGrade(int grade);
+
 public:
 	// Orthodox Canonical Form
 	Bureaucrat();
@@ -25,9 +34,24 @@ public:
 	const std::string&	getName() const;
 	int					getGrade() const;
 
+	// Why a grade change was refused, if it was
+	enum GradeStatus
+	{
+		GRADE_OK,
+		GRADE_TOO_HIGH,
+		GRADE_TOO_LOW
+	};
+
 	// Member functions
 	void				incrementGrade();
 	void				decrementGrade();
+
+	// The same without exceptions: change the grade and return GRADE_OK,
+	// or leave it and return the reason
+	GradeStatus			tryIncrementGrade();
+	GradeStatus			tryDecrementGrade();
+	// Whether grade is in [1, 150]
+	static GradeStatus	checkGrade(int grade);
 	void				signForm(AForm& form);
 	void				executeForm(const AForm& form) const;
 
@@ -0,0 +1,136 @@
+#include "BureaucratIndex.hpp"
+#include "AForm.hpp"
+
+BureaucratIndex::BureaucratIndex()
+{
+	for (int g = 0; g < LAST + 2; g++)
+		_start[g] = 0;
+}
+
+BureaucratIndex::BureaucratIndex(const BureaucratIndex& other)
+{
+	(void)other;
+	for (int g = 0; g < LAST + 2; g++)
+		_start[g] = 0;
+}
+
+BureaucratIndex& BureaucratIndex::operator=(const BureaucratIndex& other)
+{
+	(void)other;
+	return *this;
+}
+
+BureaucratIndex::~BureaucratIndex()
+{
+	for (size_t i = 0; i < _order.size(); i++)
+		_order[i]->_index = NULL;
+}
+
+void BureaucratIndex::_swap(size_t a, size_t b)
+{
+	Bureaucrat* first = _order[a];
+	_order[a] = _order[b];
+	_order[b] = first;
+	_order[a]->_indexPosition = a;
+	_order[b]->_indexPosition = b;
+}
+
+// One grade better: trade places with the first of the current grade,
+// which then starts one later; the bureaucrat ends the grade above
+void BureaucratIndex::_up(Bureaucrat& bureaucrat)
+{
+	int g = bureaucrat._grade;
+	_swap(bureaucrat._indexPosition, _start[g]);
+	_start[g]++;
+	bureaucrat._grade = g - 1;
+}
+
+// One grade worse: trade places with the last of the current grade,
+// which then ends one earlier; the bureaucrat starts the grade below
+void BureaucratIndex::_down(Bureaucrat& bureaucrat)
+{
+	int g = bureaucrat._grade;
+	_swap(bureaucrat._indexPosition, _start[g + 1] - 1);
+	_start[g + 1]--;
+	bureaucrat._grade = g + 1;
+}
+
+void BureaucratIndex::_move(Bureaucrat& bureaucrat, int grade)
+{
+	while (bureaucrat._grade > grade)
+		_up(bureaucrat);
+	while (bureaucrat._grade < grade)
+		_down(bureaucrat);
+}
+
+void BureaucratIndex::regrade(Bureaucrat& bureaucrat, int grade)
+{
+	_move(bureaucrat, grade);
+}
+
+// Enter at the end, in the extra grade past the last, and rise to the
+// real grade
+void BureaucratIndex::add(Bureaucrat& bureaucrat)
+{
+	if (bureaucrat._index == this)
+		return;
+	if (bureaucrat._index)
+		bureaucrat._index->remove(bureaucrat);
+	
+	int grade = bureaucrat._grade;
+	bureaucrat._index = this;
+	bureaucrat._indexPosition = _order.size();
+	bureaucrat._grade = LAST;
+	_order.push_back(&bureaucrat);
+	_start[LAST + 1]++;
+	_move(bureaucrat, grade);
+}
+
+void BureaucratIndex::remove(Bureaucrat& bureaucrat)
+{
+	if (bureaucrat._index != this)
+		return;
+	
+	int grade = bureaucrat._grade;
+	_move(bureaucrat, LAST);
+	_order.pop_back();
+	_start[LAST + 1]--;
+	bureaucrat._grade = grade;
+	bureaucrat._index = NULL;
+}
+
+size_t BureaucratIndex::size() const
+{
+	return _order.size();
+}
+
+size_t BureaucratIndex::countAtMost(int grade) const
+{
+	if (grade < 1)
+		return 0;
+	if (grade >= LAST)
+		return _order.size();
+	return _start[grade + 1];
+}
+
+size_t BureaucratIndex::countWithGrade(int grade) const
+{
+	if (grade < 1 || grade >= LAST)
+		return 0;
+	return _start[grade + 1] - _start[grade];
+}
+
+Bureaucrat& BureaucratIndex::operator[](size_t i) const
+{
+	return *_order[i];
+}
+
+size_t BureaucratIndex::canSign(const AForm& form) const
+{
+	return countAtMost(form.getGradeToSign());
+}
+
+size_t BureaucratIndex::canExecute(const AForm& form) const
+{
+	return countAtMost(form.getGradeToExecute());
+}
@@ -0,0 +1,59 @@
+#ifndef BUREAUCRATINDEX_HPP
+#define BUREAUCRATINDEX_HPP
+
+#include "Bureaucrat.hpp"
+#include <vector>
+#include <cstddef>
+
+// Bureaucrats kept in grade order, as after a counting sort: one array
+// holding grade 1 first, then grade 2, and so on, with the start of each
+// grade recorded. "Everyone with grade <= k" is then the first
+// countAtMost(k) entries, found in O(1), and a promotion or demotion by
+// one grade swaps the bureaucrat with the edge of its grade, also O(1).
+// Bureaucrats in an index update it themselves when their grade changes
+// and leave it when destroyed; the index does not own them
+class BureaucratIndex
+{
+private:
+	// Grades 1 to 150, and 151 as a place for bureaucrats entering or
+	// leaving: bucket g is [_start[g], _start[g + 1])
+	static const int	LAST = 151;
+
+	std::vector<Bureaucrat*>	_order;
+	size_t						_start[LAST + 2];
+
+	void	_swap(size_t a, size_t b);
+	void	_up(Bureaucrat& bureaucrat);
+	void	_down(Bureaucrat& bureaucrat);
+	void	_move(Bureaucrat& bureaucrat, int grade);
+
+	// The bureaucrats point back at the index: no copies
+	BureaucratIndex(const BureaucratIndex& other);
+	BureaucratIndex& operator=(const BureaucratIndex& other);
+
+	friend class Bureaucrat;
+
+	void	regrade(Bureaucrat& bureaucrat, int grade);
+
+public:
+	BureaucratIndex();
+	~BureaucratIndex();
+
+	// Add a bureaucrat, leaving any index it was in; O(grade)
+	void	add(Bureaucrat& bureaucrat);
+	// Take a bureaucrat out; O(150 - grade)
+	void	remove(Bureaucrat& bureaucrat);
+
+	size_t	size() const;
+	// How many have grade <= grade; they are entries [0, count)
+	size_t	countAtMost(int grade) const;
+	size_t	countWithGrade(int grade) const;
+	// Entry i, in grade order
+	Bureaucrat&	operator[](size_t i) const;
+
+	// Who may sign or execute form: entries [0, count)
+	size_t	canSign(const AForm& form) const;
+	size_t	canExecute(const AForm& form) const;
+};
+
+#endif
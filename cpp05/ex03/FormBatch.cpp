@@ -0,0 +1,238 @@
+#include "FormBatch.hpp"
+#include "PresidentialPardonForm.hpp"
+#include "RobotomyRequestForm.hpp"
+#include "ShrubberyCreationForm.hpp"
+#include "ThreadPool.hpp"
+#include <typeinfo>
+#include <sstream>
+
+FormBatch::FormBatch()
+{
+}
+
+FormBatch::FormBatch(const FormBatch& other)
+{
+	(void)other;
+}
+
+FormBatch& FormBatch::operator=(const FormBatch& other)
+{
+	(void)other;
+	return *this;
+}
+
+FormBatch::~FormBatch()
+{
+}
+
+// The actions of a batch, forms[which[k]] for each k, each printing
+// into output[which[k]]
+class BatchActions
+{
+public:
+	const std::vector<AForm*>*	forms;
+	FormBatch::Result*			results;	// results[i] belongs to (*forms)[i]
+	const size_t*				which;
+	std::string*				output;
+
+	void operator()(size_t first, size_t last)
+	{
+		for (size_t k = first; k < last; k++)
+			runOne(which[k]);
+	}
+
+	void runOne(size_t i)
+	{
+		std::ostringstream buffer;
+		AForm::setOutput(&buffer);
+		try
+		{
+			(*forms)[i]->executeAction();
+		}
+		catch (std::exception&)
+		{
+			results[i].status = FormBatch::ACTION_FAILED;
+		}
+		AForm::setOutput(NULL);
+		output[i] = buffer.str();
+	}
+};
+
+// Whether the action of form may run on the pool: those of the three
+// form classes keep no state but the locked or per-thread kind. A class
+// registered from outside may not, so it runs on the calling thread
+static bool runsInParallel(const AForm* form)
+{
+	const std::type_info& type = typeid(*form);
+	return type == typeid(PresidentialPardonForm) || type == typeid(RobotomyRequestForm)
+		|| type == typeid(ShrubberyCreationForm);
+}
+
+// The grade the best bureaucrat holds decides every form: whatever some
+// bureaucrat may sign or execute, the best may too. With the checks done
+// here, trySign and tryExecute cannot refuse, so the actions of the
+// forms that pass are called directly, in parallel on the shared pool.
+// Each prints into a buffer of its own, and the buffers are written out
+// in queue order once all are done, so the output reads as if the forms
+// had run one after the other
+void FormBatch::run(const std::vector<AForm*>& forms, const std::vector<Bureaucrat>& bureaucrats,
+	std::vector<Result>& results)
+{
+	const Bureaucrat* best = NULL;
+	for (size_t i = 0; i < bureaucrats.size(); i++)
+	{
+		if (!best || bureaucrats[i].getGrade() < best->getGrade())
+			best = &bureaucrats[i];
+	}
+	int grade = best ? best->getGrade() : 151;
+
+	size_t first = results.size();
+	results.reserve(first + forms.size());
+	std::vector<size_t> parallel;
+	std::vector<size_t> serial;
+	for (size_t i = 0; i < forms.size(); i++)
+	{
+		AForm* form = forms[i];
+		Result result;
+		result.form = form;
+		result.bureaucrat = NULL;
+		if (!form->getSigned() && grade > form->getGradeToSign())
+			result.status = CANNOT_SIGN;
+		else
+		{
+			if (!form->getSigned())
+				form->trySign(*best);
+			result.bureaucrat = best;
+			result.status = grade > form->getGradeToExecute() ? CANNOT_EXECUTE : EXECUTED;
+			if (result.status == EXECUTED)
+				(runsInParallel(form) ? parallel : serial).push_back(i);
+		}
+		results.push_back(result);
+	}
+	if (parallel.empty() && serial.empty())
+		return;
+
+	std::vector<std::string> output(forms.size());
+	BatchActions actions;
+	actions.forms = &forms;
+	actions.results = &results[first];
+	actions.which = NULL;
+	actions.output = &output[0];
+	if (!parallel.empty())
+	{
+		actions.which = &parallel[0];
+		ThreadPool::shared().parallelFor(0, parallel.size(), 1, actions);
+	}
+	for (size_t k = 0; k < serial.size(); k++)
+		actions.runOne(serial[k]);
+
+	std::ostream& out = AForm::out();
+	for (size_t i = 0; i < output.size(); i++)
+		out << output[i];
+	out.flush();
+}
+
+// The action of a form whose exact class is Form: the qualified call
+// names it directly, so the compiler can inline it
+template <typename Form>
+static void runAction(const AForm* form)
+{
+	static_cast<const Form*>(form)->Form::executeAction();
+}
+
+// Forms of any other class go through the virtual call
+template <>
+void runAction<AForm>(const AForm* form)
+{
+	form->executeAction();
+}
+
+// Run the action of each form of group whose check passed; results[i]
+// belongs to forms[i]
+template <typename Form>
+static void executeGroup(const std::vector<AForm*>& forms, const std::vector<size_t>& group,
+	FormBatch::Result* results)
+{
+	for (size_t k = 0; k < group.size(); k++)
+	{
+		size_t i = group[k];
+		if (results[i].status != FormBatch::EXECUTED)
+			continue;
+		try
+		{
+			runAction<Form>(forms[i]);
+		}
+		catch (std::exception&)
+		{
+			results[i].status = FormBatch::ACTION_FAILED;
+		}
+	}
+}
+
+void FormBatch::executeGrouped(const std::vector<AForm*>& forms, const Bureaucrat& executor,
+	std::vector<Result>& results)
+{
+	enum Group
+	{
+		PARDON,
+		ROBOTOMY,
+		SHRUBBERY,
+		OTHER,
+		GROUP_COUNT
+	};
+
+	// One pass through the forms gathers what the checks read, and the
+	// class of each, into plain arrays
+	size_t n = forms.size();
+	std::vector<unsigned char> isSigned(n);
+	std::vector<int> gradeToExecute(n);
+	std::vector<size_t> groups[GROUP_COUNT];
+	for (size_t i = 0; i < n; i++)
+	{
+		const AForm& form = *forms[i];
+		isSigned[i] = form.getSigned();
+		gradeToExecute[i] = form.getGradeToExecute();
+		const std::type_info& type = typeid(form);
+		if (type == typeid(PresidentialPardonForm))
+			groups[PARDON].push_back(i);
+		else if (type == typeid(RobotomyRequestForm))
+			groups[ROBOTOMY].push_back(i);
+		else if (type == typeid(ShrubberyCreationForm))
+			groups[SHRUBBERY].push_back(i);
+		else
+			groups[OTHER].push_back(i);
+	}
+
+	// The checks themselves, branch-free over the arrays
+	int grade = executor.getGrade();
+	std::vector<unsigned char> status(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		unsigned char tooLow = grade > gradeToExecute[i];
+		status[i] = isSigned[i] ? tooLow * CANNOT_EXECUTE : static_cast<unsigned char>(NOT_SIGNED);
+	}
+
+	size_t first = results.size();
+	results.reserve(first + n);
+	for (size_t i = 0; i < n; i++)
+	{
+		Result result;
+		result.form = forms[i];
+		result.bureaucrat = &executor;
+		result.status = static_cast<Status>(status[i]);
+		results.push_back(result);
+	}
+
+	if (n == 0)
+		return;
+	executeGroup<PresidentialPardonForm>(forms, groups[PARDON], &results[first]);
+	executeGroup<RobotomyRequestForm>(forms, groups[ROBOTOMY], &results[first]);
+	executeGroup<ShrubberyCreationForm>(forms, groups[SHRUBBERY], &results[first]);
+	executeGroup<AForm>(forms, groups[OTHER], &results[first]);
+}
+
+const char* FormBatch::statusName(Status status)
+{
+	static const char* const names[] = {"executed", "cannot sign", "cannot execute", "action failed", "not signed"};
+	return names[status];
+}
@@ -0,0 +1,56 @@
+#ifndef FORMBATCH_HPP
+#define FORMBATCH_HPP
+
+#include "AForm.hpp"
+#include "Bureaucrat.hpp"
+#include <vector>
+
+// Signs and executes a queue of forms with a pool of bureaucrats. Grades
+// are checked up front against every form, so a form nobody may sign or
+// execute is reported in its result instead of through an exception and
+// a line of output; only the actions of the forms print
+class FormBatch
+{
+public:
+	enum Status
+	{
+		EXECUTED,			// signed and executed
+		CANNOT_SIGN,		// no bureaucrat has the grade to sign it
+		CANNOT_EXECUTE,		// signed, but no bureaucrat may execute it
+		ACTION_FAILED,		// its action threw
+		NOT_SIGNED			// executeGrouped only: nobody signed it
+	};
+
+	struct Result
+	{
+		const AForm*		form;
+		const Bureaucrat*	bureaucrat;	// who signed and executed it, or NULL
+		Status				status;
+	};
+
+	// Append one result per form, in queue order. The actions run on the
+	// shared ThreadPool, those of form classes from outside this exercise
+	// on the calling thread, and their output is printed in queue order
+	// once all are done
+	static void		run(const std::vector<AForm*>& forms, const std::vector<Bureaucrat>& bureaucrats,
+						std::vector<Result>& results);
+
+	// Execute forms that are already signed with one executor, one result
+	// per form in queue order. The signed and grade checks run first over
+	// a compact copy of those fields, then the forms run class by class,
+	// the three form classes through a direct, non-virtual call of their
+	// action; so actions print grouped by class, not in queue order.
+	// Forms of any other class run last, through the virtual call
+	static void		executeGrouped(const std::vector<AForm*>& forms, const Bureaucrat& executor,
+						std::vector<Result>& results);
+
+	static const char*	statusName(Status status);
+
+private:
+	FormBatch();
+	FormBatch(const FormBatch& other);
+	FormBatch& operator=(const FormBatch& other);
+	~FormBatch();
+};
+
+#endif
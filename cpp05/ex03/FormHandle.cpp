@@ -0,0 +1,57 @@
+#include "FormHandle.hpp"
+
+FormHandle::FormHandle(AForm* form) : _form(form)
+{
+}
+
+FormHandle::FormHandle(const FormHandle& other) : _form(other._form)
+{
+	other._form = NULL;
+}
+
+FormHandle& FormHandle::operator=(const FormHandle& other)
+{
+	if (this != &other)
+	{
+		AForm* form = other._form;
+		other._form = NULL;
+		reset(form);
+	}
+	return *this;
+}
+
+FormHandle::~FormHandle()
+{
+	delete _form;
+}
+
+AForm& FormHandle::operator*() const
+{
+	return *_form;
+}
+
+AForm* FormHandle::operator->() const
+{
+	return _form;
+}
+
+AForm* FormHandle::get() const
+{
+	return _form;
+}
+
+AForm* FormHandle::release()
+{
+	AForm* form = _form;
+	_form = NULL;
+	return form;
+}
+
+void FormHandle::reset(AForm* form)
+{
+	if (form != _form)
+	{
+		delete _form;
+		_form = form;
+	}
+}
@@ -0,0 +1,31 @@
+#ifndef FORMHANDLE_HPP
+#define FORMHANDLE_HPP
+
+#include "AForm.hpp"
+
+// Owner of one form, as made by Intern::makeForm: deletes it, which puts
+// its memory back in the pool of its class, when the handle goes out of
+// scope. As with std::auto_ptr, copying a handle moves the form to the
+// copy and leaves the source empty, so a handle can be returned by value
+class FormHandle
+{
+private:
+	mutable AForm*	_form;
+
+public:
+	explicit FormHandle(AForm* form = NULL);
+	FormHandle(const FormHandle& other);
+	FormHandle& operator=(const FormHandle& other);
+	~FormHandle();
+
+	AForm&	operator*() const;
+	AForm*	operator->() const;
+	AForm*	get() const;
+
+	// Give up the form without deleting it
+	AForm*	release();
+	// Delete the form held, and hold form instead
+	void	reset(AForm* form = NULL);
+};
+
+#endif
@@ -0,0 +1,77 @@
+#include "FormPool.hpp"
+#include <new>
+
+static const size_t CHUNK_SLOTS = 64;
+
+// Slots are rounded so that every one is aligned for any member of a form
+static const size_t ALIGN = 16;
+
+static size_t roundUp(size_t size)
+{
+	return (size + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+FormPool::FormPool(size_t slotSize) : _slotSize(roundUp(slotSize)), _free(NULL), _live(0)
+{
+}
+
+FormPool::FormPool(const FormPool& other) : _slotSize(other._slotSize), _free(NULL), _live(0)
+{
+}
+
+FormPool& FormPool::operator=(const FormPool& other)
+{
+	(void)other;
+	return *this;
+}
+
+FormPool::~FormPool()
+{
+	for (size_t i = 0; i < _chunks.size(); i++)
+		::operator delete(_chunks[i]);
+}
+
+void* FormPool::allocate(size_t size)
+{
+	if (roundUp(size) != _slotSize)
+		return ::operator new(size);
+	if (!_free)
+	{
+		char* chunk = static_cast<char*>(::operator new(CHUNK_SLOTS * _slotSize));
+		_chunks.push_back(chunk);
+		for (size_t i = CHUNK_SLOTS; i > 0; i--)
+		{
+			void* slot = chunk + (i - 1) * _slotSize;
+			*static_cast<void**>(slot) = _free;
+			_free = slot;
+		}
+	}
+	void* slot = _free;
+	_free = *static_cast<void**>(slot);
+	_live++;
+	return slot;
+}
+
+void FormPool::deallocate(void* p, size_t size)
+{
+	if (!p)
+		return;
+	if (roundUp(size) != _slotSize)
+	{
+		::operator delete(p);
+		return;
+	}
+	*static_cast<void**>(p) = _free;
+	_free = p;
+	_live--;
+}
+
+size_t FormPool::live() const
+{
+	return _live;
+}
+
+size_t FormPool::capacity() const
+{
+	return _chunks.size() * CHUNK_SLOTS;
+}
@@ -0,0 +1,45 @@
+#ifndef FORMPOOL_HPP
+#define FORMPOOL_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Fixed-size slots for one form class, carved from chunks of 64 and
+// recycled through a free list, so that making and deleting forms of that
+// class stops calling the global allocator once the pool is warm. The
+// form classes take their memory from FormPool::of<T>() in their own
+// operator new and operator delete, so new and delete use it unchanged.
+// Requests of another size, as from a class derived from a form, go to
+// the global allocator
+class FormPool
+{
+private:
+	size_t				_slotSize;
+	std::vector<void*>	_chunks;
+	void*				_free;
+	size_t				_live;
+
+	// A pool owns its chunks: no copies
+	FormPool(const FormPool& other);
+	FormPool& operator=(const FormPool& other);
+
+public:
+	explicit FormPool(size_t slotSize);
+	~FormPool();
+
+	void*	allocate(size_t size);
+	void	deallocate(void* p, size_t size);
+
+	size_t	live() const;		// slots in use
+	size_t	capacity() const;	// slots in the chunks
+
+	// The pool of class T, made on first use
+	template <typename T>
+	static FormPool& of()
+	{
+		static FormPool pool(sizeof(T));
+		return pool;
+	}
+};
+
+#endif
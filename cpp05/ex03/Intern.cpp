@@ -1,4 +1,5 @@
 #include "Intern.hpp"
+#include "Log.hpp"
 #include "ShrubberyCreationForm.hpp"
 #include "RobotomyRequestForm.hpp"
 #include "PresidentialPardonForm.hpp"
@@ -6,25 +7,25 @@
 
 Intern::Intern()
 {
-	std::cout << "Intern default constructor called" << std::endl;
+	LOG_LIFECYCLE("Intern default constructor called");
 }
 
 Intern::Intern(const Intern& other)
 {
-	std::cout << "Intern copy constructor called" << std::endl;
+	LOG_LIFECYCLE("Intern copy constructor called");
 	*this = other;
 }
 
 Intern& Intern::operator=(const Intern& other)
 {
-	std::cout << "Intern copy assignment operator called" << std::endl;
+	LOG_LIFECYCLE("Intern copy assignment operator called");
 	(void)other;
 	return *this;
 }
 
 Intern::~Intern()
 {
-	std::cout << "Intern destructor called" << std::endl;
+	LOG_LIFECYCLE("Intern destructor called");
 }
 
 AForm* Intern::createShrubberyCreationForm(const std::string& target)
@@ -42,27 +43,34 @@ AForm* Intern::createPresidentialPardonForm(const std::string& target)
 	return new PresidentialPardonForm(target);
 }
 
-AForm* Intern::makeForm(const std::string& formName, const std::string& target)
+// The names and their creators, filled the first time any intern needs
+// them instead of on every call of makeForm
+Intern::Registry& Intern::registry()
 {
-	const std::string formNames[3] = {
-		"shrubbery creation",
-		"robotomy request", 
-		"presidential pardon"
-	};
+	static Registry forms;
+	if (forms.empty())
+	{
+		forms["shrubbery creation"] = &Intern::createShrubberyCreationForm;
+		forms["robotomy request"] = &Intern::createRobotomyRequestForm;
+		forms["presidential pardon"] = &Intern::createPresidentialPardonForm;
+	}
+	return forms;
+}
 
-	AForm* (Intern::*formCreators[3])(const std::string&) = {
-		&Intern::createShrubberyCreationForm,
-		&Intern::createRobotomyRequestForm,
-		&Intern::createPresidentialPardonForm
-	};
+void Intern::registerForm(const std::string& formName, Creator creator)
+{
+	registry()[formName] = creator;
+}
+
+AForm* Intern::makeForm(const std::string& formName, const std::string& target)
+{
+	Registry& forms = registry();
+	Registry::const_iterator it = forms.find(formName);
 
-	for (int i = 0; i < 3; i++)
+	if (it != forms.end())
 	{
-		if (formName == formNames[i])
-		{
-			std::cout << "Intern creates " << formName << std::endl;
-			return (this->*formCreators[i])(target);
-		}
+		std::cout << "Intern creates " << formName << std::endl;
+		return it->second(target);
 	}
 
 	std::cout << "Error: Form \"" << formName << "\" does not exist" << std::endl;
@@ -3,13 +3,21 @@
 
 #include "AForm.hpp"
 #include <string>
+#include <map>
 
 class Intern
 {
+public:
+	// Builds a form of one type for a target
+	typedef AForm*	(*Creator)(const std::string& target);
+
 private:
-	AForm*	createShrubberyCreationForm(const std::string& target);
-	AForm*	createRobotomyRequestForm(const std::string& target);
-	AForm*	createPresidentialPardonForm(const std::string& target);
+	typedef std::map<std::string, Creator>	Registry;
+
+	static AForm*		createShrubberyCreationForm(const std::string& target);
+	static AForm*		createRobotomyRequestForm(const std::string& target);
+	static AForm*		createPresidentialPardonForm(const std::string& target);
+	static Registry&	registry();
 
 public:
 	Intern();
@@ -19,6 +27,10 @@ public:
 
 	AForm*	makeForm(const std::string& formName, const std::string& target);
 
+	// Add a form type, or replace the creator of a name, for every intern;
+	// the three forms of the subject are registered from the start
+	static void	registerForm(const std::string& formName, Creator creator);
+
 	class FormNotFoundException : public std::exception
 	{
 	public:
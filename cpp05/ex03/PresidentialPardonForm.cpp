@@ -1,26 +1,35 @@
 #include "PresidentialPardonForm.hpp"
+#include "Log.hpp"
+#include "FormPool.hpp"
+
+// The name of every form of this class, interned once
+static const std::string* formName()
+{
+	static const std::string* name = AForm::intern("Presidential Pardon Form");
+	return name;
+}
 
 // Orthodox Canonical Form
-PresidentialPardonForm::PresidentialPardonForm() : AForm("Presidential Pardon Form", 25, 5), _target("default")
+PresidentialPardonForm::PresidentialPardonForm() : AForm(formName(), 25, 5), _target("default")
 {
-	std::cout << "PresidentialPardonForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm default constructor called");
 }
 
 PresidentialPardonForm::PresidentialPardonForm(const std::string& target) 
-	: AForm("Presidential Pardon Form", 25, 5), _target(target)
+	: AForm(formName(), 25, 5), _target(target)
 {
-	std::cout << "PresidentialPardonForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm parametric constructor called");
 }
 
 PresidentialPardonForm::PresidentialPardonForm(const PresidentialPardonForm& other)
 	: AForm(other), _target(other._target)
 {
-	std::cout << "PresidentialPardonForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm copy constructor called");
 }
 
 PresidentialPardonForm& PresidentialPardonForm::operator=(const PresidentialPardonForm& other)
 {
-	std::cout << "PresidentialPardonForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm assignment operator called");
 	if (this != &other)
 	{
 		AForm::operator=(other);
@@ -31,7 +40,17 @@ PresidentialPardonForm& PresidentialPardonForm::operator=(const PresidentialPard
 
 PresidentialPardonForm::~PresidentialPardonForm()
 {
-	std::cout << "PresidentialPardonForm destructor called" << std::endl;
+	LOG_LIFECYCLE("PresidentialPardonForm destructor called");
+}
+
+void* PresidentialPardonForm::operator new(size_t size)
+{
+	return FormPool::of<PresidentialPardonForm>().allocate(size);
+}
+
+void PresidentialPardonForm::operator delete(void* p, size_t size)
+{
+	FormPool::of<PresidentialPardonForm>().deallocate(p, size);
 }
 
 // Getter
@@ -43,5 +62,5 @@ const std::string& PresidentialPardonForm::getTarget() const
 // Virtual function implementation
 void PresidentialPardonForm::executeAction() const
 {
-	std::cout << _target << " has been pardoned by Zaphod Beeblebrox." << std::endl;
+	AForm::out() << _target << " has been pardoned by Zaphod Beeblebrox." << std::endl;
 }
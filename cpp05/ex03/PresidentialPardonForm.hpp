@@ -16,6 +16,10 @@ public:
 	PresidentialPardonForm& operator=(const PresidentialPardonForm& other);
 	virtual ~PresidentialPardonForm();
 
+	// Memory comes from FormPool::of<PresidentialPardonForm>()
+	static void*	operator new(size_t size);
+	static void		operator delete(void* p, size_t size);
+
 	// Getter
 	const std::string& getTarget() const;
 
@@ -1,26 +1,35 @@
 #include "RobotomyRequestForm.hpp"
+#include "Log.hpp"
+#include "FormPool.hpp"
+
+// The name of every form of this class, interned once
+static const std::string* formName()
+{
+	static const std::string* name = AForm::intern("Robotomy Request Form");
+	return name;
+}
 
 // Orthodox Canonical Form
-RobotomyRequestForm::RobotomyRequestForm() : AForm("Robotomy Request Form", 72, 45), _target("default")
+RobotomyRequestForm::RobotomyRequestForm() : AForm(formName(), 72, 45), _target("default")
 {
-	std::cout << "RobotomyRequestForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm default constructor called");
 }
 
 RobotomyRequestForm::RobotomyRequestForm(const std::string& target) 
-	: AForm("Robotomy Request Form", 72, 45), _target(target)
+	: AForm(formName(), 72, 45), _target(target)
 {
-	std::cout << "RobotomyRequestForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm parametric constructor called");
 }
 
 RobotomyRequestForm::RobotomyRequestForm(const RobotomyRequestForm& other)
 	: AForm(other), _target(other._target)
 {
-	std::cout << "RobotomyRequestForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm copy constructor called");
 }
 
 RobotomyRequestForm& RobotomyRequestForm::operator=(const RobotomyRequestForm& other)
 {
-	std::cout << "RobotomyRequestForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm assignment operator called");
 	if (this != &other)
 	{
 		AForm::operator=(other);
@@ -31,7 +40,17 @@ RobotomyRequestForm& RobotomyRequestForm::operator=(const RobotomyRequestForm& o
 
 RobotomyRequestForm::~RobotomyRequestForm()
 {
-	std::cout << "RobotomyRequestForm destructor called" << std::endl;
+	LOG_LIFECYCLE("RobotomyRequestForm destructor called");
+}
+
+void* RobotomyRequestForm::operator new(size_t size)
+{
+	return FormPool::of<RobotomyRequestForm>().allocate(size);
+}
+
+void RobotomyRequestForm::operator delete(void* p, size_t size)
+{
+	FormPool::of<RobotomyRequestForm>().deallocate(p, size);
 }
 
 // Getter
@@ -40,21 +59,41 @@ const std::string& RobotomyRequestForm::getTarget() const
 	return _target;
 }
 
+// 0 until the thread's first robotomy, which seeds it from the clock
+__thread uint64_t RobotomyRequestForm::_random = 0;
+
+void RobotomyRequestForm::seed(uint64_t seed)
+{
+	// xorshift never leaves an all-zero state
+	_random = seed ? seed : 0x9E3779B97F4A7C15ull;
+}
+
+// xorshift64*: a few operations per draw and, unlike rand() reseeded
+// with time() on each call, a fresh outcome for every robotomy. The top
+// bit is the best of the output, so it decides
+bool RobotomyRequestForm::coinFlip()
+{
+	if (_random == 0)
+		seed((static_cast<uint64_t>(time(NULL)) ^ reinterpret_cast<uintptr_t>(&_random)) * 0x2545F4914F6CDD1Dull);
+	_random ^= _random >> 12;
+	_random ^= _random << 25;
+	_random ^= _random >> 27;
+	return ((_random * 0x2545F4914F6CDD1Dull) >> 63) != 0;
+}
+
 // Virtual function implementation
 void RobotomyRequestForm::executeAction() const
 {
-	std::cout << "* DRILLING NOISES * BZZZZZZT * WHIRRRRR * CLANK *" << std::endl;
-	
-	// Seed the random number generator with current time
-	srand(static_cast<unsigned int>(time(NULL)));
+	std::ostream& out = AForm::out();
+	out << "* DRILLING NOISES * BZZZZZZT * WHIRRRRR * CLANK *" << std::endl;
 	
 	// 50% chance of success
-	if (rand() % 2 == 0)
+	if (coinFlip())
 	{
-		std::cout << _target << " has been robotomized successfully!" << std::endl;
+		out << _target << " has been robotomized successfully!" << std::endl;
 	}
 	else
 	{
-		std::cout << "Robotomy of " << _target << " has failed!" << std::endl;
+		out << "Robotomy of " << _target << " has failed!" << std::endl;
 	}
 }
@@ -4,12 +4,20 @@
 #include "AForm.hpp"
 #include <cstdlib>
 #include <ctime>
+#include <stdint.h>
 
 class RobotomyRequestForm : public AForm
 {
 private:
 	std::string _target;
 
+	// State of the generator deciding robotomies, one per thread and
+	// shared by all forms, so forms executed on several threads at once
+	// each draw from their own
+	static __thread uint64_t	_random;
+
+	static bool	coinFlip();
+
 public:
 	// Orthodox Canonical Form
 	RobotomyRequestForm();
@@ -18,11 +26,21 @@ public:
 	RobotomyRequestForm& operator=(const RobotomyRequestForm& other);
 	virtual ~RobotomyRequestForm();
 
+	// Memory comes from FormPool::of<RobotomyRequestForm>()
+	static void*	operator new(size_t size);
+	static void		operator delete(void* p, size_t size);
+
 	// Getter
 	const std::string& getTarget() const;
 
 	// Virtual function implementation
 	virtual void executeAction() const;
+
+	// Restart the robotomy outcomes of the calling thread from seed, so
+	// that a test sees the same sequence every run; otherwise each
+	// thread's generator is seeded once from the clock and its own
+	// address, so threads started together still draw apart
+	static void	seed(uint64_t seed);
 };
 
 #endif
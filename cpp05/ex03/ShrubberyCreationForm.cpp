@@ -1,26 +1,37 @@
 #include "ShrubberyCreationForm.hpp"
+#include "Log.hpp"
+#include "FormPool.hpp"
+#include <deque>
+#include <pthread.h>
+
+// The name of every form of this class, interned once
+static const std::string* formName()
+{
+	static const std::string* name = AForm::intern("Shrubbery Creation Form");
+	return name;
+}
 
 // Orthodox Canonical Form
-ShrubberyCreationForm::ShrubberyCreationForm() : AForm("Shrubbery Creation Form", 145, 137), _target("default")
+ShrubberyCreationForm::ShrubberyCreationForm() : AForm(formName(), 145, 137), _target("default")
 {
-	std::cout << "ShrubberyCreationForm default constructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm default constructor called");
 }
 
 ShrubberyCreationForm::ShrubberyCreationForm(const std::string& target) 
-	: AForm("Shrubbery Creation Form", 145, 137), _target(target)
+	: AForm(formName(), 145, 137), _target(target)
 {
-	std::cout << "ShrubberyCreationForm parametric constructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm parametric constructor called");
 }
 
 ShrubberyCreationForm::ShrubberyCreationForm(const ShrubberyCreationForm& other)
 	: AForm(other), _target(other._target)
 {
-	std::cout << "ShrubberyCreationForm copy constructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm copy constructor called");
 }
 
 ShrubberyCreationForm& ShrubberyCreationForm::operator=(const ShrubberyCreationForm& other)
 {
-	std::cout << "ShrubberyCreationForm assignment operator called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm assignment operator called");
 	if (this != &other)
 	{
 		AForm::operator=(other);
@@ -31,7 +42,17 @@ ShrubberyCreationForm& ShrubberyCreationForm::operator=(const ShrubberyCreationF
 
 ShrubberyCreationForm::~ShrubberyCreationForm()
 {
-	std::cout << "ShrubberyCreationForm destructor called" << std::endl;
+	LOG_LIFECYCLE("ShrubberyCreationForm destructor called");
+}
+
+void* ShrubberyCreationForm::operator new(size_t size)
+{
+	return FormPool::of<ShrubberyCreationForm>().allocate(size);
+}
+
+void ShrubberyCreationForm::operator delete(void* p, size_t size)
+{
+	FormPool::of<ShrubberyCreationForm>().deallocate(p, size);
 }
 
 // Getter
@@ -40,43 +61,258 @@ const std::string& ShrubberyCreationForm::getTarget() const
 	return _target;
 }
 
+// The whole drawing, written with one call instead of a flush per line
+static const char TREE[] =
+	"       ^\n"
+	"      ^^^\n"
+	"     ^^^^^\n"
+	"    ^^^^^^^\n"
+	"   ^^^^^^^^^\n"
+	"  ^^^^^^^^^^^\n"
+	" ^^^^^^^^^^^^^\n"
+	"^^^^^^^^^^^^^^^\n"
+	"       |||\n"
+	"       |||\n"
+	"\n"
+	"      /\\\n"
+	"     /  \\\n"
+	"    /____\\\n"
+	"   /      \\\n"
+	"  /        \\\n"
+	" /__________\\\n"
+	"      ||\n"
+	"      ||\n"
+	"\n"
+	"    🌲🌳🌲\n"
+	"   🌳🌲🌳🌲\n"
+	"  🌲🌳🌲🌳🌲\n"
+	"     |||\n";
+
+bool ShrubberyCreationForm::_deferred = false;
+
+std::vector<std::string> ShrubberyCreationForm::_pending;
+
+// Held around _pending, which forms executed on FormBatch's pool fill
+// from several threads at once
+static pthread_mutex_t pendingLock = PTHREAD_MUTEX_INITIALIZER;
+
+bool ShrubberyCreationForm::_background = false;
+
+// Write the drawing to filename; false if the file cannot be created or
+// written
+static bool writeTree(const std::string& filename)
+{
+	std::ofstream file(filename.c_str());
+	
+	if (!file.is_open())
+		return false;
+	file.write(TREE, sizeof(TREE) - 1);
+	file.close();
+	return !file.fail();
+}
+
+// Write the drawing to filename; false, with a message, if it cannot
+bool ShrubberyCreationForm::plant(const std::string& filename)
+{
+	if (writeTree(filename))
+		return true;
+	AForm::out() << "Error: Could not create file " << filename << std::endl;
+	return false;
+}
+
+// The I/O thread of background mode and the files queued for it. The
+// thread starts with the first file queued; at exit the destructor lets
+// it finish the queue and joins it
+class ShrubberyWriter
+{
+private:
+	pthread_mutex_t			_lock;
+	pthread_cond_t			_wake;		// a file was queued, or _stop was set
+	pthread_cond_t			_idle;		// the last queued file was written
+	std::deque<std::string>	_queue;
+	size_t					_busy;		// files taken off the queue, not yet written
+	size_t					_written;
+	size_t					_failed;
+	bool					_started;
+	bool					_stop;
+	pthread_t				_thread;
+
+	ShrubberyWriter(const ShrubberyWriter& other);
+	ShrubberyWriter& operator=(const ShrubberyWriter& other);
+
+	static void* main(void* arg)
+	{
+		ShrubberyWriter* self = static_cast<ShrubberyWriter*>(arg);
+		pthread_mutex_lock(&self->_lock);
+		for (;;)
+		{
+			while (self->_queue.empty() && !self->_stop)
+				pthread_cond_wait(&self->_wake, &self->_lock);
+			if (self->_queue.empty())
+				break;
+			std::string filename = self->_queue.front();
+			self->_queue.pop_front();
+			self->_busy++;
+			pthread_mutex_unlock(&self->_lock);
+			bool ok = writeTree(filename);
+			pthread_mutex_lock(&self->_lock);
+			self->_busy--;
+			if (ok)
+				self->_written++;
+			else
+				self->_failed++;
+			if (self->_queue.empty() && self->_busy == 0)
+				pthread_cond_broadcast(&self->_idle);
+		}
+		pthread_mutex_unlock(&self->_lock);
+		return NULL;
+	}
+
+public:
+	ShrubberyWriter() : _busy(0), _written(0), _failed(0), _started(false), _stop(false)
+	{
+		pthread_mutex_init(&_lock, NULL);
+		pthread_cond_init(&_wake, NULL);
+		pthread_cond_init(&_idle, NULL);
+	}
+
+	~ShrubberyWriter()
+	{
+		pthread_mutex_lock(&_lock);
+		_stop = true;
+		pthread_cond_signal(&_wake);
+		pthread_mutex_unlock(&_lock);
+		if (_started)
+			pthread_join(_thread, NULL);
+		pthread_cond_destroy(&_idle);
+		pthread_cond_destroy(&_wake);
+		pthread_mutex_destroy(&_lock);
+	}
+
+	// Queue filename; if the thread cannot be started, write it here
+	void post(const std::string& filename)
+	{
+		pthread_mutex_lock(&_lock);
+		if (!_started)
+			_started = pthread_create(&_thread, NULL, main, this) == 0;
+		if (_started)
+		{
+			_queue.push_back(filename);
+			pthread_cond_signal(&_wake);
+			pthread_mutex_unlock(&_lock);
+			return;
+		}
+		pthread_mutex_unlock(&_lock);
+		bool ok = writeTree(filename);
+		pthread_mutex_lock(&_lock);
+		if (ok)
+			_written++;
+		else
+			_failed++;
+		pthread_mutex_unlock(&_lock);
+	}
+
+	size_t wait(size_t* failed)
+	{
+		pthread_mutex_lock(&_lock);
+		while (!_queue.empty() || _busy > 0)
+			pthread_cond_wait(&_idle, &_lock);
+		size_t written = _written;
+		if (failed)
+			*failed += _failed;
+		_written = 0;
+		_failed = 0;
+		pthread_mutex_unlock(&_lock);
+		return written;
+	}
+
+	size_t pending()
+	{
+		pthread_mutex_lock(&_lock);
+		size_t count = _queue.size() + _busy;
+		pthread_mutex_unlock(&_lock);
+		return count;
+	}
+};
+
+static ShrubberyWriter& writer()
+{
+	static ShrubberyWriter instance;
+	return instance;
+}
+
+void ShrubberyCreationForm::setDeferred(bool deferred)
+{
+	_deferred = deferred;
+}
+
+bool ShrubberyCreationForm::isDeferred()
+{
+	return _deferred;
+}
+
+size_t ShrubberyCreationForm::flushPending()
+{
+	std::vector<std::string> files;
+	pthread_mutex_lock(&pendingLock);
+	files.swap(_pending);
+	pthread_mutex_unlock(&pendingLock);
+	size_t written = 0;
+	for (size_t i = 0; i < files.size(); i++)
+	{
+		if (plant(files[i]))
+			written++;
+	}
+	return written;
+}
+
+size_t ShrubberyCreationForm::pendingCount()
+{
+	pthread_mutex_lock(&pendingLock);
+	size_t count = _pending.size();
+	pthread_mutex_unlock(&pendingLock);
+	return count;
+}
+
+void ShrubberyCreationForm::setBackground(bool background)
+{
+	_background = background;
+}
+
+bool ShrubberyCreationForm::isBackground()
+{
+	return _background;
+}
+
+size_t ShrubberyCreationForm::waitWritten(size_t* failed)
+{
+	return writer().wait(failed);
+}
+
+size_t ShrubberyCreationForm::backgroundPending()
+{
+	return writer().pending();
+}
+
 // Virtual function implementation
 void ShrubberyCreationForm::executeAction() const
 {
 	std::string filename = _target + "_shrubbery";
-	std::ofstream file(filename.c_str());
 	
-	if (!file.is_open())
+	if (_deferred)
 	{
-		std::cout << "Error: Could not create file " << filename << std::endl;
+		pthread_mutex_lock(&pendingLock);
+		_pending.push_back(filename);
+		pthread_mutex_unlock(&pendingLock);
+		AForm::out() << "Shrubbery will be planted at " << _target << std::endl;
 		return;
 	}
-	
-	file << "       ^" << std::endl;
-	file << "      ^^^" << std::endl;
-	file << "     ^^^^^" << std::endl;
-	file << "    ^^^^^^^" << std::endl;
-	file << "   ^^^^^^^^^" << std::endl;
-	file << "  ^^^^^^^^^^^" << std::endl;
-	file << " ^^^^^^^^^^^^^" << std::endl;
-	file << "^^^^^^^^^^^^^^^" << std::endl;
-	file << "       |||" << std::endl;
-	file << "       |||" << std::endl;
-	file << std::endl;
-	file << "      /\\" << std::endl;
-	file << "     /  \\" << std::endl;
-	file << "    /____\\" << std::endl;
-	file << "   /      \\" << std::endl;
-	file << "  /        \\" << std::endl;
-	file << " /__________\\" << std::endl;
-	file << "      ||" << std::endl;
-	file << "      ||" << std::endl;
-	file << std::endl;
-	file << "    🌲🌳🌲" << std::endl;
-	file << "   🌳🌲🌳🌲" << std::endl;
-	file << "  🌲🌳🌲🌳🌲" << std::endl;
-	file << "     |||" << std::endl;
-	
-	file.close();
-	std::cout << "Shrubbery has been planted at " << _target << std::endl;
+	if (_background)
+	{
+		writer().post(filename);
+		AForm::out() << "Shrubbery is being planted at " << _target << std::endl;
+		return;
+	}
+	if (plant(filename))
+		AForm::out() << "Shrubbery has been planted at " << _target << std::endl;
 }
@@ -3,12 +3,19 @@
 
 #include "AForm.hpp"
 #include <fstream>
+#include <vector>
 
 class ShrubberyCreationForm : public AForm
 {
 private:
 	std::string _target;
 
+	static bool						_deferred;
+	static std::vector<std::string>	_pending;
+	static bool						_background;
+
+	static bool	plant(const std::string& filename);
+
 public:
 	// Orthodox Canonical Form
 	ShrubberyCreationForm();
@@ -17,11 +24,35 @@ public:
 	ShrubberyCreationForm& operator=(const ShrubberyCreationForm& other);
 	virtual ~ShrubberyCreationForm();
 
+	// Memory comes from FormPool::of<ShrubberyCreationForm>()
+	static void*	operator new(size_t size);
+	static void		operator delete(void* p, size_t size);
+
 	// Getter
 	const std::string& getTarget() const;
 
 	// Virtual function implementation
 	virtual void executeAction() const;
+
+	// Deferred mode: executing only queues the file, and flushPending
+	// writes every queued file at once, returning how many were written,
+	// so that the writes of many forms are done together at a chosen time
+	static void		setDeferred(bool deferred);
+	static bool		isDeferred();
+	static size_t	flushPending();
+	static size_t	pendingCount();
+
+	// Background mode: executing hands the file to an I/O thread, which
+	// writes the queued files in order while the caller goes on.
+	// waitWritten blocks until it has written all of them and returns how
+	// many succeeded since the last call, adding the failures to *failed
+	// if given; a failure is counted there instead of printed. Deferred
+	// mode, when also set, takes precedence. Files still queued at exit
+	// are written before the program ends
+	static void		setBackground(bool background);
+	static bool		isBackground();
+	static size_t	waitWritten(size_t* failed = NULL);
+	static size_t	backgroundPending();
 };
 
 #endif
@@ -4,6 +4,16 @@
 #include "RobotomyRequestForm.hpp"
 #include "PresidentialPardonForm.hpp"
 #include "Intern.hpp"
+#include "FormHandle.hpp"
+#include "FormPool.hpp"
+#include "FormBatch.hpp"
+#include "BureaucratIndex.hpp"
+
+// A creator registered under a name of our own
+static AForm* createPardon(const std::string& target)
+{
+	return new PresidentialPardonForm(target);
+}
 
 int main()
 {
@@ -143,6 +153,188 @@ int main()
 		std::cout << "Exception caught: " << e.what() << std::endl;
 	}
 
+	// Test 7: Registering a new form name
+	std::cout << "\n--- Test 7: Registering a new form name ---" << std::endl;
+	try
+	{
+		Intern intern;
+		Intern::registerForm("pardon", &createPardon);
+		AForm* pardon = intern.makeForm("pardon", "Zaphod");
+		std::cout << *pardon << std::endl;
+		delete pardon;
+	}
+	catch (std::exception& e)
+	{
+		std::cout << "Exception caught: " << e.what() << std::endl;
+	}
+
+	// Test 8: Pooled forms behind handles
+	std::cout << "\n--- Test 8: Pooled forms behind handles ---" << std::endl;
+	try
+	{
+		Intern intern;
+		Bureaucrat clerk("Clerk", 1);
+		for (int round = 0; round < 2; round++)
+		{
+			FormHandle form(intern.makeForm("presidential pardon", "Marvin"));
+			clerk.signForm(*form);
+			std::cout << "Pardon forms alive: " << FormPool::of<PresidentialPardonForm>().live()
+					  << ", pooled slots: " << FormPool::of<PresidentialPardonForm>().capacity() << std::endl;
+		}
+		std::cout << "Pardon forms alive after both rounds: " << FormPool::of<PresidentialPardonForm>().live() << std::endl;
+	}
+	catch (std::exception& e)
+	{
+		std::cout << "Exception caught: " << e.what() << std::endl;
+	}
+
+	// Test 9: Batch signing and execution
+	std::cout << "\n--- Test 9: Batch signing and execution ---" << std::endl;
+	try
+	{
+		Intern intern;
+		std::vector<Bureaucrat> staff;
+		staff.push_back(Bureaucrat("Junior", 140));
+		staff.push_back(Bureaucrat("Senior", 30));
+		
+		std::vector<AForm*> queue;
+		queue.push_back(intern.makeForm("shrubbery creation", "batch"));
+		queue.push_back(intern.makeForm("robotomy request", "Bender"));
+		queue.push_back(intern.makeForm("presidential pardon", "Trillian"));
+		
+		std::vector<FormBatch::Result> results;
+		FormBatch::run(queue, staff, results);
+		for (size_t i = 0; i < results.size(); i++)
+		{
+			std::cout << results[i].form->getName() << ": " << FormBatch::statusName(results[i].status);
+			if (results[i].bureaucrat)
+				std::cout << " by " << results[i].bureaucrat->getName();
+			std::cout << std::endl;
+		}
+		for (size_t i = 0; i < queue.size(); i++)
+			delete queue[i];
+	}
+	catch (std::exception& e)
+	{
+		std::cout << "Exception caught: " << e.what() << std::endl;
+	}
+
+	// Test 10: Refusals as status codes
+	std::cout << "\n--- Test 10: Refusals as status codes ---" << std::endl;
+	{
+		Bureaucrat top("Top", 1);
+		Bureaucrat intern("Intern", 150);
+		PresidentialPardonForm pardon("Slartibartfast");
+		std::cout << "Execute unsigned: " << (pardon.tryExecute(top) == AForm::FORM_NOT_SIGNED ? "FORM_NOT_SIGNED" : "?") << std::endl;
+		std::cout << "Sign with grade 150: " << (pardon.trySign(intern) == AForm::FORM_GRADE_TOO_LOW ? "FORM_GRADE_TOO_LOW" : "?") << std::endl;
+		std::cout << "Promote grade 1: " << (top.tryIncrementGrade() == Bureaucrat::GRADE_TOO_HIGH ? "GRADE_TOO_HIGH" : "?") << std::endl;
+		std::cout << "Demote grade 150: " << (intern.tryDecrementGrade() == Bureaucrat::GRADE_TOO_LOW ? "GRADE_TOO_LOW" : "?") << std::endl;
+	}
+
+	// Test 11: Deferred shrubbery files
+	std::cout << "\n--- Test 11: Deferred shrubbery files ---" << std::endl;
+	{
+		Bureaucrat gardener("Gardener", 1);
+		ShrubberyCreationForm north("north");
+		ShrubberyCreationForm south("south");
+		ShrubberyCreationForm::setDeferred(true);
+		gardener.signForm(north);
+		gardener.signForm(south);
+		gardener.executeForm(north);
+		gardener.executeForm(south);
+		std::cout << "Files queued: " << ShrubberyCreationForm::pendingCount() << std::endl;
+		std::cout << "Files written: " << ShrubberyCreationForm::flushPending() << std::endl;
+		ShrubberyCreationForm::setDeferred(false);
+	}
+
+	// Test 12: Robotomy odds
+	std::cout << "\n--- Test 12: Robotomy odds ---" << std::endl;
+	{
+		Bureaucrat surgeon("Surgeon", 1);
+		RobotomyRequestForm robotomy("Marvin");
+		surgeon.signForm(robotomy);
+		RobotomyRequestForm::seed(42);
+		for (int i = 0; i < 4; i++)
+			robotomy.execute(surgeon);
+	}
+
+	// Test 13: Grade index
+	std::cout << "\n--- Test 13: Grade index ---" << std::endl;
+	{
+		Bureaucrat alice("Alice", 30);
+		Bureaucrat bob("Bob", 5);
+		Bureaucrat carol("Carol", 100);
+		BureaucratIndex index;
+		index.add(alice);
+		index.add(bob);
+		index.add(carol);
+		PresidentialPardonForm pardon("Arthur");
+		std::cout << "May sign a pardon: " << index.canSign(pardon) << std::endl;
+		for (int i = 0; i < 6; i++)
+			alice.tryIncrementGrade();
+		std::cout << "After promoting Alice: " << index.canSign(pardon) << " -";
+		for (size_t i = 0; i < index.canSign(pardon); i++)
+			std::cout << " " << index[i];
+		std::cout << std::endl;
+	}
+
+	// Test 14: Executing a batch class by class
+	std::cout << "\n--- Test 14: Grouped execution ---" << std::endl;
+	{
+		Bureaucrat boss("Boss", 1);
+		Bureaucrat clerk("Clerk", 50);
+		std::vector<AForm*> queue;
+		queue.push_back(new PresidentialPardonForm("Ford"));
+		queue.push_back(new RobotomyRequestForm("Marvin"));
+		queue.push_back(new PresidentialPardonForm("Zaphod"));
+		queue.push_back(new PresidentialPardonForm("Unsigned"));
+		for (size_t i = 0; i + 1 < queue.size(); i++)
+			queue[i]->trySign(boss);
+		std::vector<FormBatch::Result> results;
+		FormBatch::executeGrouped(queue, clerk, results);
+		FormBatch::executeGrouped(queue, boss, results);
+		for (size_t i = 0; i < results.size(); i++)
+			std::cout << results[i].form->getName() << ": " << FormBatch::statusName(results[i].status)
+				<< " by " << results[i].bureaucrat->getName() << std::endl;
+		for (size_t i = 0; i < queue.size(); i++)
+			delete queue[i];
+	}
+
+	// Test 15: Shrubbery files written by the background thread
+	std::cout << "\n--- Test 15: Background shrubbery files ---" << std::endl;
+	{
+		Bureaucrat gardener("Gardener", 1);
+		ShrubberyCreationForm east("east");
+		ShrubberyCreationForm lost("no_such_dir/lost");
+		ShrubberyCreationForm::setBackground(true);
+		gardener.signForm(east);
+		gardener.signForm(lost);
+		gardener.executeForm(east);
+		gardener.executeForm(lost);
+		size_t failed = 0;
+		std::cout << "Files written: " << ShrubberyCreationForm::waitWritten(&failed) << ", failed: " << failed
+			<< ", still queued: " << ShrubberyCreationForm::backgroundPending() << std::endl;
+		ShrubberyCreationForm::setBackground(false);
+	}
+
+	// Test 16: A batch whose actions run on the pool
+	std::cout << "\n--- Test 16: Batch on the thread pool ---" << std::endl;
+	{
+		const char* targets[] = {"Arthur", "Ford", "Zaphod", "Trillian", "Marvin", "Slartibartfast"};
+		std::vector<Bureaucrat> staff(1, Bureaucrat("President", 1));
+		std::vector<AForm*> queue;
+		for (size_t i = 0; i < 6; i++)
+			queue.push_back(new PresidentialPardonForm(targets[i]));
+		std::vector<FormBatch::Result> results;
+		FormBatch::run(queue, staff, results);
+		size_t executed = 0;
+		for (size_t i = 0; i < results.size(); i++)
+			executed += results[i].status == FormBatch::EXECUTED;
+		std::cout << "Executed " << executed << " of " << results.size() << std::endl;
+		for (size_t i = 0; i < queue.size(); i++)
+			delete queue[i];
+	}
+
 	std::cout << "\n=== END OF TESTS ===" << std::endl;
 	return 0;
 }
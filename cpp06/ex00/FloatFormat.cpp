@@ -0,0 +1,394 @@
+#include "FloatFormat.hpp"
+#include <cstring>
+#include <cstdlib>
+#include <cmath>
+
+// Shortest round-trip formatting with Grisu2 (Florian Loitsch, "Printing
+// Floating-Point Numbers Quickly and Accurately with Integers", 2010):
+// the value and the halfway points to its neighbours are scaled by a
+// cached power of ten into 64-bit fixed point, and digits are produced
+// until they fall strictly between the two halfway points
+
+typedef unsigned long long	uint64;
+typedef unsigned int		uint32;
+
+// A number f * 2^e
+struct DiyFp
+{
+	uint64	f;
+	int		e;
+	
+	DiyFp() : f(0), e(0) {}
+	DiyFp(uint64 significand, int exponent) : f(significand), e(exponent) {}
+};
+
+// Upper 64 bits of the 128-bit product, rounded
+static DiyFp multiply(const DiyFp& x, const DiyFp& y)
+{
+	const uint64 mask = 0xFFFFFFFFULL;
+	uint64 a = x.f >> 32;
+	uint64 b = x.f & mask;
+	uint64 c = y.f >> 32;
+	uint64 d = y.f & mask;
+	uint64 ac = a * c;
+	uint64 bc = b * c;
+	uint64 ad = a * d;
+	uint64 bd = b * d;
+	uint64 middle = (bd >> 32) + (ad & mask) + (bc & mask) + (1ULL << 31);
+	
+	return DiyFp(ac + (ad >> 32) + (bc >> 32) + (middle >> 32), x.e + y.e + 64);
+}
+
+static DiyFp normalize(DiyFp x)
+{
+	while (!(x.f & (1ULL << 63)))
+	{
+		x.f <<= 1;
+		x.e--;
+	}
+	return x;
+}
+
+// Halfway points to the neighbours of v, both with the exponent of the
+// normalized upper one; hidden is the implicit leading bit of the type
+static void boundaries(const DiyFp& v, uint64 hidden, DiyFp& minus, DiyFp& plus)
+{
+	plus = normalize(DiyFp((v.f << 1) + 1, v.e - 1));
+	// Below a power of two the gap to the lower neighbour is half as wide
+	if (v.f == hidden)
+		minus = DiyFp((v.f << 2) - 1, v.e - 2);
+	else
+		minus = DiyFp((v.f << 1) - 1, v.e - 1);
+	minus.f <<= minus.e - plus.e;
+	minus.e = plus.e;
+}
+
+// 10^k for k = -348, -340, ..., 340, normalized to 64 bits
+static const struct
+{
+	uint64	f;
+	int		e;
+} cachedPowers[] =
+{
+	{0xfa8fd5a0081c0288ULL, -1220}, {0xbaaee17fa23ebf76ULL, -1193}, {0x8b16fb203055ac76ULL, -1166},
+	{0xcf42894a5dce35eaULL, -1140}, {0x9a6bb0aa55653b2dULL, -1113}, {0xe61acf033d1a45dfULL, -1087},
+	{0xab70fe17c79ac6caULL, -1060}, {0xff77b1fcbebcdc4fULL, -1034}, {0xbe5691ef416bd60cULL, -1007},
+	{0x8dd01fad907ffc3cULL, -980}, {0xd3515c2831559a83ULL, -954}, {0x9d71ac8fada6c9b5ULL, -927},
+	{0xea9c227723ee8bcbULL, -901}, {0xaecc49914078536dULL, -874}, {0x823c12795db6ce57ULL, -847},
+	{0xc21094364dfb5637ULL, -821}, {0x9096ea6f3848984fULL, -794}, {0xd77485cb25823ac7ULL, -768},
+	{0xa086cfcd97bf97f4ULL, -741}, {0xef340a98172aace5ULL, -715}, {0xb23867fb2a35b28eULL, -688},
+	{0x84c8d4dfd2c63f3bULL, -661}, {0xc5dd44271ad3cdbaULL, -635}, {0x936b9fcebb25c996ULL, -608},
+	{0xdbac6c247d62a584ULL, -582}, {0xa3ab66580d5fdaf6ULL, -555}, {0xf3e2f893dec3f126ULL, -529},
+	{0xb5b5ada8aaff80b8ULL, -502}, {0x87625f056c7c4a8bULL, -475}, {0xc9bcff6034c13053ULL, -449},
+	{0x964e858c91ba2655ULL, -422}, {0xdff9772470297ebdULL, -396}, {0xa6dfbd9fb8e5b88fULL, -369},
+	{0xf8a95fcf88747d94ULL, -343}, {0xb94470938fa89bcfULL, -316}, {0x8a08f0f8bf0f156bULL, -289},
+	{0xcdb02555653131b6ULL, -263}, {0x993fe2c6d07b7facULL, -236}, {0xe45c10c42a2b3b06ULL, -210},
+	{0xaa242499697392d3ULL, -183}, {0xfd87b5f28300ca0eULL, -157}, {0xbce5086492111aebULL, -130},
+	{0x8cbccc096f5088ccULL, -103}, {0xd1b71758e219652cULL, -77}, {0x9c40000000000000ULL, -50},
+	{0xe8d4a51000000000ULL, -24}, {0xad78ebc5ac620000ULL, 3}, {0x813f3978f8940984ULL, 30},
+	{0xc097ce7bc90715b3ULL, 56}, {0x8f7e32ce7bea5c70ULL, 83}, {0xd5d238a4abe98068ULL, 109},
+	{0x9f4f2726179a2245ULL, 136}, {0xed63a231d4c4fb27ULL, 162}, {0xb0de65388cc8ada8ULL, 189},
+	{0x83c7088e1aab65dbULL, 216}, {0xc45d1df942711d9aULL, 242}, {0x924d692ca61be758ULL, 269},
+	{0xda01ee641a708deaULL, 295}, {0xa26da3999aef774aULL, 322}, {0xf209787bb47d6b85ULL, 348},
+	{0xb454e4a179dd1877ULL, 375}, {0x865b86925b9bc5c2ULL, 402}, {0xc83553c5c8965d3dULL, 428},
+	{0x952ab45cfa97a0b3ULL, 455}, {0xde469fbd99a05fe3ULL, 481}, {0xa59bc234db398c25ULL, 508},
+	{0xf6c69a72a3989f5cULL, 534}, {0xb7dcbf5354e9beceULL, 561}, {0x88fcf317f22241e2ULL, 588},
+	{0xcc20ce9bd35c78a5ULL, 614}, {0x98165af37b2153dfULL, 641}, {0xe2a0b5dc971f303aULL, 667},
+	{0xa8d9d1535ce3b396ULL, 694}, {0xfb9b7cd9a4a7443cULL, 720}, {0xbb764c4ca7a44410ULL, 747},
+	{0x8bab8eefb6409c1aULL, 774}, {0xd01fef10a657842cULL, 800}, {0x9b10a4e5e9913129ULL, 827},
+	{0xe7109bfba19c0c9dULL, 853}, {0xac2820d9623bf429ULL, 880}, {0x80444b5e7aa7cf85ULL, 907},
+	{0xbf21e44003acdd2dULL, 933}, {0x8e679c2f5e44ff8fULL, 960}, {0xd433179d9c8cb841ULL, 986},
+	{0x9e19db92b4e31ba9ULL, 1013}, {0xeb96bf6ebadf77d9ULL, 1039}, {0xaf87023b9bf0ee6bULL, 1066},
+};
+
+// A cached power that brings a number with binary exponent e into the
+// range the digit generation needs; k is set to minus its decimal exponent
+static DiyFp cachedPower(int e, int& k)
+{
+	double dk = (-61 - e) * 0.30102999566398114 + 347;
+	int rounded = static_cast<int>(dk);
+	
+	if (dk - rounded > 0.0)
+		rounded++;
+	unsigned int index = static_cast<unsigned int>((rounded >> 3) + 1);
+	k = -(-348 + static_cast<int>(index) * 8);
+	return DiyFp(cachedPowers[index].f, cachedPowers[index].e);
+}
+
+static const uint32 powersOf10[] =
+{
+	1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000
+};
+
+// Move the last digit towards the value while that stays in range
+static void round(char* buffer, int length, uint64 delta, uint64 rest, uint64 tenKappa, uint64 distance)
+{
+	while (rest < distance && delta - rest >= tenKappa &&
+		(rest + tenKappa < distance || distance - rest > rest + tenKappa - distance))
+	{
+		buffer[length - 1]--;
+		rest += tenKappa;
+	}
+}
+
+static int countDigits(uint32 n)
+{
+	int digits = 1;
+	
+	while (digits < 10 && n >= powersOf10[digits])
+		digits++;
+	return digits;
+}
+
+// Digits of w, as few as keep the result within delta below high; k is
+// adjusted to the decimal exponent of the last digit
+static void generateDigits(const DiyFp& w, const DiyFp& high, uint64 delta, char* buffer, int& length, int& k)
+{
+	const DiyFp one(1ULL << -high.e, high.e);
+	const uint64 distance = high.f - w.f;
+	uint32 integral = static_cast<uint32>(high.f >> -one.e);
+	uint64 fraction = high.f & (one.f - 1);
+	int kappa = countDigits(integral);
+	
+	length = 0;
+	while (kappa > 0)
+	{
+		uint32 digit = integral / powersOf10[kappa - 1];
+		integral %= powersOf10[kappa - 1];
+		if (digit || length)
+			buffer[length++] = static_cast<char>('0' + digit);
+		kappa--;
+		uint64 rest = (static_cast<uint64>(integral) << -one.e) + fraction;
+		if (rest <= delta)
+		{
+			k += kappa;
+			round(buffer, length, delta, rest, static_cast<uint64>(powersOf10[kappa]) << -one.e, distance);
+			return;
+		}
+	}
+	for (;;)
+	{
+		fraction *= 10;
+		delta *= 10;
+		char digit = static_cast<char>(fraction >> -one.e);
+		if (digit || length)
+			buffer[length++] = static_cast<char>('0' + digit);
+		fraction &= one.f - 1;
+		kappa--;
+		if (fraction < delta)
+		{
+			k += kappa;
+			round(buffer, length, delta, fraction, one.f, -kappa < 10 ? distance * powersOf10[-kappa] : 0);
+			return;
+		}
+	}
+}
+
+// Shortest digits of v (f * 2^e, its type's hidden bit given), such that
+// v reads back as digits * 10^k
+static void grisu2(const DiyFp& v, uint64 hidden, char* digits, int& length, int& k)
+{
+	DiyFp minus;
+	DiyFp plus;
+	
+	boundaries(v, hidden, minus, plus);
+	DiyFp power = cachedPower(plus.e, k);
+	DiyFp w = multiply(normalize(v), power);
+	DiyFp high = multiply(plus, power);
+	DiyFp low = multiply(minus, power);
+	// Stay strictly inside, out of reach of the rounding of the products
+	low.f++;
+	high.f--;
+	generateDigits(w, high, high.f - low.f, digits, length, k);
+}
+
+static size_t writeExponent(char* out, int exponent)
+{
+	size_t n = 0;
+	
+	out[n++] = 'e';
+	out[n++] = exponent < 0 ? '-' : '+';
+	if (exponent < 0)
+		exponent = -exponent;
+	if (exponent >= 100)
+		out[n++] = static_cast<char>('0' + exponent / 100);
+	out[n++] = static_cast<char>('0' + exponent / 10 % 10);
+	out[n++] = static_cast<char>('0' + exponent % 10);
+	return n;
+}
+
+// Lay out length digits worth digits * 10^k after the sign
+static size_t layout(char* buffer, bool negative, const char* digits, int length, int k)
+{
+	size_t n = 0;
+	int exponent = length + k - 1;
+	
+	if (negative)
+		buffer[n++] = '-';
+	if (exponent < -4 || exponent >= 16)
+	{
+		buffer[n++] = digits[0];
+		if (length > 1)
+		{
+			buffer[n++] = '.';
+			std::memcpy(buffer + n, digits + 1, length - 1);
+			n += length - 1;
+		}
+		n += writeExponent(buffer + n, exponent);
+	}
+	else if (k >= 0)
+	{
+		// Whole: the digits, the zeros after them, and ".0"
+		std::memcpy(buffer + n, digits, length);
+		n += length;
+		std::memset(buffer + n, '0', k);
+		n += k;
+		buffer[n++] = '.';
+		buffer[n++] = '0';
+	}
+	else if (exponent >= 0)
+	{
+		std::memcpy(buffer + n, digits, exponent + 1);
+		n += exponent + 1;
+		buffer[n++] = '.';
+		std::memcpy(buffer + n, digits + exponent + 1, length - exponent - 1);
+		n += length - exponent - 1;
+	}
+	else
+	{
+		buffer[n++] = '0';
+		buffer[n++] = '.';
+		std::memset(buffer + n, '0', -exponent - 1);
+		n += -exponent - 1;
+		std::memcpy(buffer + n, digits, length);
+		n += length;
+	}
+	buffer[n] = '\0';
+	return n;
+}
+
+// Whole numbers below 10^16 are written exactly, as an integer would be:
+// the shortest digits of 2^31 as a float are 21474836, which would lay
+// out as 2147483600.0
+static size_t formatWhole(double magnitude, bool negative, char* buffer)
+{
+	char digits[20];
+	int length = 0;
+	uint64 n = static_cast<uint64>(magnitude);
+	
+	do
+	{
+		digits[length++] = static_cast<char>('0' + n % 10);
+		n /= 10;
+	} while (n);
+	size_t written = 0;
+	if (negative)
+		buffer[written++] = '-';
+	while (length > 0)
+		buffer[written++] = digits[--length];
+	buffer[written++] = '.';
+	buffer[written++] = '0';
+	buffer[written] = '\0';
+	return written;
+}
+
+// Grisu2 is sometimes a digit longer than needed, as for 1e23, which it
+// gives as 9.999999999999999e22. For a long double result, try one digit
+// less, rounded, and keep it if it still reads back as value
+static void shorten(double value, char* digits, int& length, int& k)
+{
+	if (length < 16)
+		return;
+	char candidate[20];
+	int n = length - 1;
+	int scale = k + 1;
+	std::memcpy(candidate, digits, n);
+	if (digits[n] >= '5')
+	{
+		int i = n - 1;
+		while (i >= 0 && candidate[i] == '9')
+			candidate[i--] = '0';
+		// All nines round up to a power of ten, one place higher
+		if (i < 0)
+		{
+			candidate[0] = '1';
+			scale++;
+		}
+		else
+			candidate[i]++;
+	}
+	// Read back as "0.<digits>e<exponent>"
+	char text[FLOAT_FORMAT_SIZE + 8];
+	int size = 0;
+	text[size++] = '0';
+	text[size++] = '.';
+	std::memcpy(text + size, candidate, n);
+	size += n;
+	size += static_cast<int>(writeExponent(text + size, n + scale));
+	text[size] = '\0';
+	if (std::strtod(text, NULL) != std::fabs(value))
+		return;
+	std::memcpy(digits, candidate, n);
+	length = n;
+	k = scale;
+	while (length > 1 && digits[length - 1] == '0')
+	{
+		length--;
+		k++;
+	}
+}
+
+// Shared by both types: v is the significand and exponent of value
+static size_t format(double value, bool negative, const DiyFp& v, uint64 hidden, bool special, bool nan,
+	char* buffer)
+{
+	const char* text = NULL;
+	
+	if (nan)
+		text = "nan";
+	else if (special)
+		text = negative ? "-inf" : "inf";
+	else if (v.f == 0)
+		text = negative ? "-0.0" : "0.0";
+	if (text)
+	{
+		std::strcpy(buffer, text);
+		return std::strlen(text);
+	}
+	double magnitude = std::fabs(value);
+	if (magnitude < 1e16 && std::floor(magnitude) == magnitude)
+		return formatWhole(magnitude, negative, buffer);
+	
+	char digits[20];
+	int length;
+	int k;
+	
+	grisu2(v, hidden, digits, length, k);
+	if (hidden == 1ULL << 52)
+		shorten(value, digits, length, k);
+	return layout(buffer, negative, digits, length, k);
+}
+
+size_t formatDouble(double value, char* buffer)
+{
+	const uint64 hidden = 1ULL << 52;
+	uint64 bits;
+	
+	std::memcpy(&bits, &value, sizeof(bits));
+	int biased = static_cast<int>((bits >> 52) & 0x7FF);
+	uint64 significand = bits & (hidden - 1);
+	DiyFp v = biased ? DiyFp(significand + hidden, biased - 1075) : DiyFp(significand, -1074);
+	return format(value, bits >> 63, v, hidden, biased == 0x7FF, biased == 0x7FF && significand, buffer);
+}
+
+size_t formatFloat(float value, char* buffer)
+{
+	const uint64 hidden = 1ULL << 23;
+	uint32 bits;
+	
+	std::memcpy(&bits, &value, sizeof(bits));
+	int biased = static_cast<int>((bits >> 23) & 0xFF);
+	uint64 significand = bits & (hidden - 1);
+	DiyFp v = biased ? DiyFp(significand + hidden, biased - 150) : DiyFp(significand, -149);
+	return format(value, bits >> 31, v, hidden, biased == 0xFF, biased == 0xFF && significand, buffer);
+}
@@ -0,0 +1,17 @@
+#ifndef FLOATFORMAT_HPP
+#define FLOATFORMAT_HPP
+
+#include <cstddef>
+
+// Room for any formatted float or double, with the terminating NUL
+#define FLOAT_FORMAT_SIZE 32
+
+// Write the shortest decimal form of value that reads back as the same
+// value into buffer, which must hold FLOAT_FORMAT_SIZE chars, and return
+// its length. Numbers from 1e-4 up to 1e16 are written out in full, with
+// ".0" when they are whole, and others as "1.5e+20"; nan and inf come out
+// as "nan", "inf" and "-inf"
+size_t	formatDouble(double value, char* buffer);
+size_t	formatFloat(float value, char* buffer);
+
+#endif
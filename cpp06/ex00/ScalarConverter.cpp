@@ -1,4 +1,5 @@
 #include "ScalarConverter.hpp"
+#include "DigitScan.hpp"
 
 // Private constructor (prevents instantiation)
 ScalarConverter::ScalarConverter() {}
@@ -7,247 +8,380 @@ ScalarConverter& ScalarConverter::operator=(const ScalarConverter& other) { (voi
 ScalarConverter::~ScalarConverter() {}
 
 // Type detection methods
-bool ScalarConverter::isChar(const std::string& input)
+
+// Character classes for the number scanner, and a flag for the bytes
+// that print as themselves
+enum CharClass
 {
-	return (input.length() == 3 && input[0] == '\'' && input[2] == '\'' && 
-			input[1] >= 32 && input[1] <= 126);
-}
+	CLASS_OTHER,
+	CLASS_DIGIT,
+	CLASS_SIGN,
+	CLASS_DOT,
+	CLASS_SUFFIX,
+	CLASS_COUNT,
+	CLASS_MASK = 0x0F,
+	CHAR_PRINTABLE = 0x10
+};
 
-bool ScalarConverter::isInt(const std::string& input)
+// Scanner states: what the characters so far can still be
+enum ScanState
 {
-	if (input.empty())
-		return false;
-	
-	size_t start = 0;
-	if (input[0] == '+' || input[0] == '-')
-		start = 1;
-	
-	if (start >= input.length())
-		return false;
-	
-	for (size_t i = start; i < input.length(); i++)
-	{
-		if (!std::isdigit(input[i]))
-			return false;
-	}
-	
-	// Check for integer overflow
-	char* endptr;
-	long value = std::strtol(input.c_str(), &endptr, 10);
-	if (*endptr != '\0')
-		return false;
-	
-	return (value >= std::numeric_limits<int>::min() && 
-			value <= std::numeric_limits<int>::max());
+	SCAN_START,		// nothing yet
+	SCAN_SIGN,		// a sign
+	SCAN_INT,		// digits, after an optional sign
+	SCAN_DOT,		// a dot with no digit yet
+	SCAN_FRACTION,	// digits and one dot
+	SCAN_FLOAT,		// a number followed by 'f'
+	SCAN_REJECT,
+	SCAN_COUNT
+};
+
+// Class and flags of every byte, one indexed load for the scanner and
+// for char output alike
+#define _ CLASS_OTHER
+#define P (CLASS_OTHER | CHAR_PRINTABLE)
+#define D (CLASS_DIGIT | CHAR_PRINTABLE)
+#define S (CLASS_SIGN | CHAR_PRINTABLE)
+#define T (CLASS_DOT | CHAR_PRINTABLE)
+#define F (CLASS_SUFFIX | CHAR_PRINTABLE)
+
+static const unsigned char charTable[256] =
+{
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0x00
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0x10
+	P, P, P, P, P, P, P, P, P, P, P, S, P, S, T, P,	// 0x20
+	D, D, D, D, D, D, D, D, D, D, P, P, P, P, P, P,	// 0x30
+	P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,	// 0x40
+	P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, P,	// 0x50
+	P, P, P, P, P, P, F, P, P, P, P, P, P, P, P, P,	// 0x60
+	P, P, P, P, P, P, P, P, P, P, P, P, P, P, P, _,	// 0x70
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0x80
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0x90
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0xA0
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0xB0
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0xC0
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0xD0
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0xE0
+	_, _, _, _, _, _, _, _, _, _, _, _, _, _, _, _,	// 0xF0
+};
+
+#undef _
+#undef P
+#undef D
+#undef S
+#undef T
+#undef F
+
+// Whether a value shown as a char is impossible, not displayable, or
+// neither; NaN fails both comparisons and an infinity one of them
+static int charStatus(double value)
+{
+	if (!(value >= 0 && value <= 127))
+		return ScalarConverter::STATUS_CHAR_IMPOSSIBLE;
+	if (!(charTable[static_cast<int>(value)] & CHAR_PRINTABLE))
+		return ScalarConverter::STATUS_CHAR_NON_DISPLAYABLE;
+	return 0;
 }
 
-bool ScalarConverter::isFloat(const std::string& input)
+// Next state for each state and character class
+static const unsigned char transitions[SCAN_COUNT][CLASS_COUNT] =
 {
-	if (input.length() < 2 || input[input.length() - 1] != 'f')
-		return false;
-	
-	std::string withoutF = input.substr(0, input.length() - 1);
-	
-	if (withoutF.empty())
-		return false;
+	//				other			digit			sign			dot				'f'
+	/* start */		{SCAN_REJECT,	SCAN_INT,		SCAN_SIGN,		SCAN_DOT,		SCAN_REJECT},
+	/* sign */		{SCAN_REJECT,	SCAN_INT,		SCAN_REJECT,	SCAN_DOT,		SCAN_REJECT},
+	/* int */		{SCAN_REJECT,	SCAN_INT,		SCAN_REJECT,	SCAN_FRACTION,	SCAN_FLOAT},
+	/* dot */		{SCAN_REJECT,	SCAN_FRACTION,	SCAN_REJECT,	SCAN_REJECT,	SCAN_REJECT},
+	/* fraction */	{SCAN_REJECT,	SCAN_FRACTION,	SCAN_REJECT,	SCAN_REJECT,	SCAN_FLOAT},
+	/* float */		{SCAN_REJECT,	SCAN_REJECT,	SCAN_REJECT,	SCAN_REJECT,	SCAN_REJECT},
+	/* reject */	{SCAN_REJECT,	SCAN_REJECT,	SCAN_REJECT,	SCAN_REJECT,	SCAN_REJECT}
+};
+
+// One pass over the input: a table-driven scanner finds the kind of
+// number along with its sign, digit count, dot and suffix, and the value
+// of an int as it goes
+ScalarConverter::Literal ScalarConverter::classify(const std::string& input)
+{
+	Literal literal;
+	literal.type = TYPE_INVALID;
+	literal.negative = false;
+	literal.digits = 0;
+	literal.dot = std::string::npos;
+	literal.suffix = false;
+	literal.intValue = 0;
+	literal.pseudo = PSEUDO_NONE;
+	literal.mantissa = 0;
+	literal.scale = 0;
+	literal.truncated = false;
 	
-	size_t start = 0;
-	if (withoutF[0] == '+' || withoutF[0] == '-')
-		start = 1;
+	if (input.length() == 3 && input[0] == '\'' && input[2] == '\'' &&
+		(charTable[static_cast<unsigned char>(input[1])] & CHAR_PRINTABLE))
+	{
+		literal.type = TYPE_CHAR;
+		return literal;
+	}
+	literal.pseudo = pseudoLiteral(input);
+	if (literal.pseudo != PSEUDO_NONE)
+	{
+		literal.type = TYPE_PSEUDO;
+		return literal;
+	}
 	
-	bool hasDot = false;
-	bool hasDigit = false;
+	const unsigned long limit = static_cast<unsigned long>(std::numeric_limits<int>::max()) + 1;
+	unsigned long magnitude = 0;
+	int significant = 0;
+	int state = SCAN_START;
 	
-	for (size_t i = start; i < withoutF.length(); i++)
+	for (size_t i = 0; i < input.length() && state != SCAN_REJECT; i++)
 	{
-		if (withoutF[i] == '.')
+		unsigned char c = static_cast<unsigned char>(input[i]);
+		int cls = charTable[c] & CLASS_MASK;
+		if (cls == CLASS_DIGIT && (state == SCAN_START || state == SCAN_SIGN))
 		{
-			if (hasDot)
-				return false;
-			hasDot = true;
+			// The integer part in one go, eight digits at a time; one of
+			// more than 11 digits, rare, is redone digit by digit below
+			const char *begin = input.data() + i;
+			const char *p = begin;
+			unsigned long long value;
+			if (DigitScan::parse(p, input.data() + input.length(), 99999999999ULL, value))
+			{
+				literal.digits = p - begin;
+				magnitude = value > limit ? limit + 1 : static_cast<unsigned long>(value);
+				literal.mantissa = value;
+				for (; value > 0; value /= 10)
+					significant++;
+				i += literal.digits - 1;
+				state = SCAN_INT;
+				continue;
+			}
 		}
-		else if (std::isdigit(withoutF[i]))
+		if (cls == CLASS_DIGIT)
 		{
-			hasDigit = true;
+			literal.digits++;
+			if (literal.dot == std::string::npos && magnitude <= limit)
+				magnitude = magnitude * 10 + (c - '0');
+			if (significant == 19)
+				literal.truncated = true;
+			else
+			{
+				// Leading zeros are not significant, but count in the scale
+				significant += literal.mantissa > 0 || c != '0';
+				literal.mantissa = literal.mantissa * 10 + (c - '0');
+				literal.scale += literal.dot != std::string::npos;
+			}
 		}
-		else
+		else if (cls == CLASS_DOT)
+			literal.dot = i;
+		else if (cls == CLASS_SIGN && state == SCAN_START)
+			literal.negative = c == '-';
+		state = transitions[state][cls];
+	}
+	
+	if (state == SCAN_INT)
+	{
+		// Out of int range, it is still a valid double
+		if (magnitude < limit || (literal.negative && magnitude == limit))
 		{
-			return false;
+			literal.type = TYPE_INT;
+			literal.intValue = literal.negative ? static_cast<int>(-static_cast<long>(magnitude))
+				: static_cast<int>(magnitude);
 		}
+		else
+			literal.type = TYPE_DOUBLE;
 	}
-	
-	return hasDigit;
+	else if (state == SCAN_FRACTION)
+		literal.type = TYPE_DOUBLE;
+	else if (state == SCAN_FLOAT)
+	{
+		literal.type = TYPE_FLOAT;
+		literal.suffix = true;
+	}
+	return literal;
 }
 
-bool ScalarConverter::isDouble(const std::string& input)
+// Decimal value of a float or double literal. When the digits fit in
+// the 53 bits of a double and at most 22 follow the dot, mantissa and
+// 10^scale are both exact doubles, so one division gives the correctly
+// rounded result, the one strtod gives. Other literals, rare in practice,
+// go to strtod
+double ScalarConverter::parseDecimal(const std::string& input, const Literal& literal)
 {
-	if (input.empty())
-		return false;
-	
-	size_t start = 0;
-	if (input[0] == '+' || input[0] == '-')
-		start = 1;
-	
-	bool hasDot = false;
-	bool hasDigit = false;
+	static const double powers[] =
+	{
+		1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+		1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+	};
+	const unsigned long long exactLimit = 1ULL << 53;
 	
-	for (size_t i = start; i < input.length(); i++)
+	if (literal.truncated || literal.mantissa > exactLimit || literal.scale > 22)
+		return std::strtod(input.c_str(), NULL);
+	double value = static_cast<double>(literal.mantissa) / powers[literal.scale];
+	return literal.negative ? -value : value;
+}
+
+// The pseudo-literals, what convert prints for each, and their values
+static const char* const pseudoNames[] = {"-inff", "+inff", "nanf", "-inf", "+inf", "nan"};
+static const char minusInfText[] = "char: impossible\nint: impossible\nfloat: -inff\ndouble: -inf\n";
+static const char plusInfText[] = "char: impossible\nint: impossible\nfloat: +inff\ndouble: +inf\n";
+static const char nanText[] = "char: impossible\nint: impossible\nfloat: nanf\ndouble: nan\n";
+static const char* const pseudoText[] = {minusInfText, plusInfText, nanText};
+static const std::streamsize pseudoTextLength[] =
+{
+	sizeof(minusInfText) - 1,
+	sizeof(plusInfText) - 1,
+	sizeof(nanText) - 1
+};
+
+// Length and first byte leave at most one candidate, confirmed with one
+// compare of the whole string
+ScalarConverter::Pseudo ScalarConverter::pseudoLiteral(const std::string& input)
+{
+	int name;
+	Pseudo pseudo;
+	size_t length = input.length();
+	if (length < 3 || length > 5)
+		return PSEUDO_NONE;
+	switch (input[0])
 	{
-		if (input[i] == '.')
-		{
-			if (hasDot)
-				return false;
-			hasDot = true;
-		}
-		else if (std::isdigit(input[i]))
-		{
-			hasDigit = true;
-		}
-		else
-		{
-			return false;
-		}
+		case '-':
+			pseudo = PSEUDO_MINUS_INF;
+			name = length == 5 ? 0 : 3;
+			break;
+		case '+':
+			pseudo = PSEUDO_PLUS_INF;
+			name = length == 5 ? 1 : 4;
+			break;
+		case 'n':
+			pseudo = PSEUDO_NAN;
+			name = length == 4 ? 2 : 5;
+			break;
+		default:
+			return PSEUDO_NONE;
 	}
-	
-	return hasDigit;
+	return input.compare(pseudoNames[name]) == 0 ? pseudo : PSEUDO_NONE;
 }
 
-bool ScalarConverter::isPseudoLiteral(const std::string& input)
+// The pseudo-literal a NaN or infinite value prints as
+ScalarConverter::Pseudo ScalarConverter::pseudoOf(double value)
 {
-	return (input == "-inff" || input == "+inff" || input == "nanf" ||
-			input == "-inf" || input == "+inf" || input == "nan");
+	if (std::isnan(value))
+		return PSEUDO_NAN;
+	return value < 0 ? PSEUDO_MINUS_INF : PSEUDO_PLUS_INF;
 }
 
 // Conversion methods
-void ScalarConverter::convertFromChar(char c)
+void ScalarConverter::convertFromChar(std::ostream& out, char c)
 {
-	std::cout << "char: '" << c << "'" << std::endl;
-	std::cout << "int: " << static_cast<int>(c) << std::endl;
-	std::cout << "float: " << std::fixed << std::setprecision(1) << static_cast<float>(c) << "f" << std::endl;
-	std::cout << "double: " << std::fixed << std::setprecision(1) << static_cast<double>(c) << std::endl;
+	out << "char: '" << c << "'" << '\n';
+	out << "int: " << static_cast<int>(c) << '\n';
+	printFloat(out, static_cast<double>(c));
+	printDouble(out, static_cast<double>(c));
 }
 
-void ScalarConverter::convertFromInt(int value)
+void ScalarConverter::convertFromInt(std::ostream& out, int value)
 {
-	printChar(static_cast<double>(value));
-	std::cout << "int: " << value << std::endl;
-	std::cout << "float: " << std::fixed << std::setprecision(1) << static_cast<float>(value) << "f" << std::endl;
-	std::cout << "double: " << std::fixed << std::setprecision(1) << static_cast<double>(value) << std::endl;
+	printChar(out, static_cast<double>(value));
+	out << "int: " << value << '\n';
+	printFloat(out, static_cast<double>(value));
+	printDouble(out, static_cast<double>(value));
 }
 
-void ScalarConverter::convertFromFloat(float value)
+void ScalarConverter::convertFromFloat(std::ostream& out, float value)
 {
-	printChar(static_cast<double>(value));
-	printInt(static_cast<double>(value));
-	printFloat(static_cast<double>(value));
-	printDouble(static_cast<double>(value));
+	printChar(out, static_cast<double>(value));
+	printInt(out, static_cast<double>(value));
+	printFloat(out, static_cast<double>(value));
+	printDouble(out, static_cast<double>(value));
 }
 
-void ScalarConverter::convertFromDouble(double value)
+void ScalarConverter::convertFromDouble(std::ostream& out, double value)
 {
-	printChar(value);
-	printInt(value);
-	printFloat(value);
-	printDouble(value);
+	printChar(out, value);
+	printInt(out, value);
+	printFloat(out, value);
+	printDouble(out, value);
 }
 
-void ScalarConverter::handlePseudoLiteral(const std::string& input)
+// All four lines are one precomputed string
+void ScalarConverter::handlePseudoLiteral(std::ostream& out, Pseudo pseudo)
 {
-	std::cout << "char: impossible" << std::endl;
-	std::cout << "int: impossible" << std::endl;
-	
-	if (input == "-inff" || input == "-inf")
-	{
-		std::cout << "float: -inff" << std::endl;
-		std::cout << "double: -inf" << std::endl;
-	}
-	else if (input == "+inff" || input == "+inf")
-	{
-		std::cout << "float: +inff" << std::endl;
-		std::cout << "double: +inf" << std::endl;
-	}
-	else // nanf or nan
-	{
-		std::cout << "float: nanf" << std::endl;
-		std::cout << "double: nan" << std::endl;
-	}
+	out.write(pseudoText[pseudo], pseudoTextLength[pseudo]);
 }
 
 // Display helper methods
-void ScalarConverter::printChar(double value, bool impossible)
+void ScalarConverter::printChar(std::ostream& out, double value, bool impossible)
 {
-	if (impossible || std::isnan(value) || std::isinf(value) || 
-		value < 0 || value > 127 || (value >= 0 && value <= 31) || value == 127)
-	{
-		if (impossible || std::isnan(value) || std::isinf(value) || value < 0 || value > 127)
-			std::cout << "char: impossible" << std::endl;
-		else
-			std::cout << "char: Non displayable" << std::endl;
-	}
+	int status = impossible ? STATUS_CHAR_IMPOSSIBLE : charStatus(value);
+
+	if (status == STATUS_CHAR_IMPOSSIBLE)
+		out << "char: impossible" << '\n';
+	else if (status == STATUS_CHAR_NON_DISPLAYABLE)
+		out << "char: Non displayable" << '\n';
 	else
 	{
-		std::cout << "char: '" << static_cast<char>(value) << "'" << std::endl;
+		out << "char: '" << static_cast<char>(value) << "'" << '\n';
 	}
 }
 
-void ScalarConverter::printInt(double value, bool impossible)
+void ScalarConverter::printInt(std::ostream& out, double value, bool impossible)
 {
 	if (impossible || std::isnan(value) || std::isinf(value) || 
 		value < std::numeric_limits<int>::min() || 
 		value > std::numeric_limits<int>::max())
 	{
-		std::cout << "int: impossible" << std::endl;
+		out << "int: impossible" << '\n';
 	}
 	else
 	{
-		std::cout << "int: " << static_cast<int>(value) << std::endl;
+		out << "int: " << static_cast<int>(value) << '\n';
 	}
 }
 
-void ScalarConverter::printFloat(double value, bool isPseudo)
+void ScalarConverter::printFloat(std::ostream& out, double value, bool isPseudo)
 {
 	if (isPseudo)
 		return; // Already handled in handlePseudoLiteral
 	
-	if (std::isnan(value))
-		std::cout << "float: nanf" << std::endl;
-	else if (std::isinf(value))
+	// A double too large for a float becomes an infinity too
+	float f = static_cast<float>(value);
+	if (std::isnan(f))
+		out << "float: nanf" << '\n';
+	else if (std::isinf(f))
 	{
-		if (value < 0)
-			std::cout << "float: -inff" << std::endl;
+		if (f < 0)
+			out << "float: -inff" << '\n';
 		else
-			std::cout << "float: +inff" << std::endl;
+			out << "float: +inff" << '\n';
 	}
 	else
 	{
-		float f = static_cast<float>(value);
-		if (f == static_cast<int>(f))
-			std::cout << "float: " << std::fixed << std::setprecision(1) << f << "f" << std::endl;
-		else
-			std::cout << "float: " << f << "f" << std::endl;
+		// Shortest digits that read back as f
+		char buffer[FLOAT_FORMAT_SIZE];
+		out << "float: ";
+		out.write(buffer, formatFloat(f, buffer));
+		out << "f" << '\n';
 	}
 }
 
-void ScalarConverter::printDouble(double value, bool isPseudo)
+void ScalarConverter::printDouble(std::ostream& out, double value, bool isPseudo)
 {
 	if (isPseudo)
 		return; // Already handled in handlePseudoLiteral
 	
 	if (std::isnan(value))
-		std::cout << "double: nan" << std::endl;
+		out << "double: nan" << '\n';
 	else if (std::isinf(value))
 	{
 		if (value < 0)
-			std::cout << "double: -inf" << std::endl;
+			out << "double: -inf" << '\n';
 		else
-			std::cout << "double: +inf" << std::endl;
+			out << "double: +inf" << '\n';
 	}
 	else
 	{
-		if (value == static_cast<int>(value))
-			std::cout << "double: " << std::fixed << std::setprecision(1) << value << std::endl;
-		else
-			std::cout << "double: " << value << std::endl;
+		char buffer[FLOAT_FORMAT_SIZE];
+		out << "double: ";
+		out.write(buffer, formatDouble(value, buffer));
+		out << '\n';
 	}
 }
 
@@ -260,46 +394,133 @@ void ScalarConverter::convert(const std::string& input)
 		return;
 	}
 	
-	// Check for pseudo-literals first
-	if (isPseudoLiteral(input))
-	{
-		handlePseudoLiteral(input);
-		return;
-	}
+	Literal literal = classify(input);
 	
-	// Check for char literal
-	if (isChar(input))
-	{
-		char c = input[1];
-		convertFromChar(c);
-		return;
-	}
+	if (literal.type == TYPE_PSEUDO)
+		handlePseudoLiteral(std::cout, literal.pseudo);
+	else if (literal.type == TYPE_CHAR)
+		convertFromChar(std::cout, input[1]);
+	else if (literal.type == TYPE_INT)
+		convertFromInt(std::cout, literal.intValue);
+	// parseDecimal stops at a float's 'f', so no copy without it is needed
+	else if (literal.type == TYPE_FLOAT)
+		convertFromFloat(std::cout, static_cast<float>(parseDecimal(input, literal)));
+	else if (literal.type == TYPE_DOUBLE)
+		convertFromDouble(std::cout, parseDecimal(input, literal));
+	else
+		std::cout << "Error: Invalid input format" << '\n';
+	std::cout << std::flush;
+}
+
+// Batch methods
+size_t ScalarConverter::Batch::size() const
+{
+	return types.size();
+}
+
+void ScalarConverter::Batch::clear()
+{
+	chars.clear();
+	ints.clear();
+	floats.clear();
+	doubles.clear();
+	status.clear();
+	types.clear();
+}
+
+// Append one literal to batch, with the values and statuses convert
+// would print for it
+void ScalarConverter::convertInto(const std::string& input, Batch& batch)
+{
+	Literal literal = classify(input);
+	double value = 0.0;
+	unsigned char status = 0;
 	
-	// Check for int literal
-	if (isInt(input))
-	{
-		int value = std::atoi(input.c_str());
-		convertFromInt(value);
-		return;
-	}
+	if (input.empty())
+		status = STATUS_EMPTY | STATUS_INVALID;
+	else if (literal.type == TYPE_INVALID)
+		status = STATUS_INVALID;
+	else if (literal.type == TYPE_CHAR)
+		value = input[1];
+	else if (literal.type == TYPE_INT)
+		value = literal.intValue;
+	else if (literal.type == TYPE_FLOAT)
+		value = static_cast<float>(parseDecimal(input, literal));
+	else if (literal.type == TYPE_DOUBLE)
+		value = parseDecimal(input, literal);
+	else if (literal.pseudo == PSEUDO_NAN)
+		value = std::numeric_limits<double>::quiet_NaN();
+	else
+		value = literal.pseudo == PSEUDO_MINUS_INF ? -std::numeric_limits<double>::infinity()
+			: std::numeric_limits<double>::infinity();
 	
-	// Check for float literal
-	if (isFloat(input))
+	if (status == 0)
 	{
-		std::string withoutF = input.substr(0, input.length() - 1);
-		float value = static_cast<float>(std::atof(withoutF.c_str()));
-		convertFromFloat(value);
-		return;
+		// The same tests as printChar and printInt
+		status |= charStatus(value);
+		if (std::isnan(value) || std::isinf(value) ||
+			value < std::numeric_limits<int>::min() ||
+			value > std::numeric_limits<int>::max())
+			status |= STATUS_INT_IMPOSSIBLE;
 	}
+	literal.type = status & STATUS_INVALID ? TYPE_INVALID : literal.type;
+	
+	batch.chars.push_back(status & (STATUS_CHAR_IMPOSSIBLE | STATUS_CHAR_NON_DISPLAYABLE | STATUS_INVALID) ? 0
+		: static_cast<char>(value));
+	batch.ints.push_back(status & (STATUS_INT_IMPOSSIBLE | STATUS_INVALID) ? 0 : static_cast<int>(value));
+	batch.floats.push_back(status & STATUS_INVALID ? 0.0f : static_cast<float>(value));
+	batch.doubles.push_back(value);
+	batch.status.push_back(status);
+	batch.types.push_back(static_cast<unsigned char>(literal.type));
+}
+
+void ScalarConverter::convertBatch(const std::vector<std::string>& inputs, Batch& batch)
+{
+	for (size_t i = 0; i < inputs.size(); i++)
+		convertInto(inputs[i], batch);
+}
+
+void ScalarConverter::convertBatch(std::istream& in, Batch& batch)
+{
+	std::string line;
 	
-	// Check for double literal
-	if (isDouble(input))
+	while (std::getline(in, line))
+		convertInto(line, batch);
+}
+
+// Text goes to a string buffer that is handed to out in large pieces.
+// Each literal starts from the default format state, as it would in a
+// program that converts just that one
+void ScalarConverter::writeBatch(std::ostream& out, const Batch& batch)
+{
+	const std::streamoff chunk = 64 * 1024;
+	std::ostringstream buffer;
+	const std::ios_base::fmtflags flags = buffer.flags();
+	const std::streamsize precision = buffer.precision();
+	
+	for (size_t i = 0; i < batch.size(); i++)
 	{
-		double value = std::atof(input.c_str());
-		convertFromDouble(value);
-		return;
+		buffer.flags(flags);
+		buffer.precision(precision);
+		if (batch.status[i] & STATUS_EMPTY)
+			buffer << "Error: Empty input" << '\n';
+		else if (batch.status[i] & STATUS_INVALID)
+			buffer << "Error: Invalid input format" << '\n';
+		else if (batch.types[i] == TYPE_CHAR)
+			convertFromChar(buffer, batch.chars[i]);
+		else if (batch.types[i] == TYPE_INT)
+			convertFromInt(buffer, batch.ints[i]);
+		else if (batch.types[i] == TYPE_FLOAT)
+			convertFromFloat(buffer, batch.floats[i]);
+		else if (batch.types[i] == TYPE_PSEUDO)
+			handlePseudoLiteral(buffer, pseudoOf(batch.doubles[i]));
+		else
+			convertFromDouble(buffer, batch.doubles[i]);
+		if (buffer.tellp() >= chunk)
+		{
+			out << buffer.str();
+			buffer.str("");
+		}
 	}
-	
-	// If none of the above, it's an invalid input
-	std::cout << "Error: Invalid input format" << std::endl;
+	out << buffer.str() << std::flush;
 }
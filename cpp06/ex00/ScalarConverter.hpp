@@ -2,11 +2,14 @@
 #define SCALARCONVERTER_HPP
 
 #include <string>
+#include <vector>
 #include <iostream>
 #include <iomanip>
 #include <limits>
 #include <cstdlib>
 #include <cmath>
+#include <sstream>
+#include "FloatFormat.hpp"
 
 class ScalarConverter
 {
@@ -17,28 +20,107 @@ private:
 	ScalarConverter& operator=(const ScalarConverter& other);
 	~ScalarConverter();
 
+	// Kinds of literal
+	enum Type
+	{
+		TYPE_INVALID,
+		TYPE_CHAR,
+		TYPE_INT,
+		TYPE_FLOAT,
+		TYPE_DOUBLE,
+		TYPE_PSEUDO
+	};
+
+	// The pseudo-literals, by value: "-inff" and "-inf" are both
+	// PSEUDO_MINUS_INF
+	enum Pseudo
+	{
+		PSEUDO_NONE = -1,
+		PSEUDO_MINUS_INF,
+		PSEUDO_PLUS_INF,
+		PSEUDO_NAN
+	};
+
+	// What one scan of a literal found
+	struct Literal
+	{
+		Type	type;
+		bool	negative;
+		size_t	digits;		// number of digits
+		size_t	dot;		// position of the dot, or std::string::npos
+		bool	suffix;		// ends in 'f'
+		int		intValue;	// the value, for TYPE_INT
+		Pseudo	pseudo;		// which one, for TYPE_PSEUDO
+
+		// The digits as an integer and how many of them follow the dot;
+		// truncated when there were too many significant digits for it
+		unsigned long long	mantissa;
+		int					scale;
+		bool				truncated;
+	};
+
 	// Helper methods for type detection
-	static bool	isChar(const std::string& input);
-	static bool	isInt(const std::string& input);
-	static bool	isFloat(const std::string& input);
-	static bool	isDouble(const std::string& input);
-	static bool	isPseudoLiteral(const std::string& input);
+	static Literal	classify(const std::string& input);
+	static Pseudo	pseudoLiteral(const std::string& input);
+	static Pseudo	pseudoOf(double value);
+
+	// Helper method for parsing
+	static double	parseDecimal(const std::string& input, const Literal& literal);
 
 	// Helper methods for conversion
-	static void	convertFromChar(char c);
-	static void	convertFromInt(int value);
-	static void	convertFromFloat(float value);
-	static void	convertFromDouble(double value);
-	static void	handlePseudoLiteral(const std::string& input);
+	static void	convertFromChar(std::ostream& out, char c);
+	static void	convertFromInt(std::ostream& out, int value);
+	static void	convertFromFloat(std::ostream& out, float value);
+	static void	convertFromDouble(std::ostream& out, double value);
+	static void	handlePseudoLiteral(std::ostream& out, Pseudo pseudo);
 
 	// Helper methods for display
-	static void	printChar(double value, bool impossible = false);
-	static void	printInt(double value, bool impossible = false);
-	static void	printFloat(double value, bool isPseudo = false);
-	static void	printDouble(double value, bool isPseudo = false);
+	static void	printChar(std::ostream& out, double value, bool impossible = false);
+	static void	printInt(std::ostream& out, double value, bool impossible = false);
+	static void	printFloat(std::ostream& out, double value, bool isPseudo = false);
+	static void	printDouble(std::ostream& out, double value, bool isPseudo = false);
 
 public:
+	// Status flags of each literal in a Batch
+	enum Status
+	{
+		STATUS_CHAR_IMPOSSIBLE = 1,
+		STATUS_CHAR_NON_DISPLAYABLE = 2,
+		STATUS_INT_IMPOSSIBLE = 4,
+		STATUS_INVALID = 8,
+		STATUS_EMPTY = 16
+	};
+
+	// Conversions of a column of literals, as one array per type: entry i
+	// of each is literal i. A value its status marks impossible or invalid
+	// is 0
+	struct Batch
+	{
+		std::vector<char>			chars;
+		std::vector<int>			ints;
+		std::vector<float>			floats;
+		std::vector<double>			doubles;
+		std::vector<unsigned char>	status;
+		std::vector<unsigned char>	types;	// kind of each literal, for writeBatch
+
+		size_t	size() const;
+		void	clear();
+	};
+
 	static void	convert(const std::string& input);
+
+	// Convert many literals at once, appending to batch: a list, or a
+	// stream with one literal per line
+	static void	convertBatch(const std::vector<std::string>& inputs, Batch& batch);
+	static void	convertBatch(std::istream& in, Batch& batch);
+
+	// Write a batch as convert would print each literal, buffered and
+	// with no flush per line
+	static void	writeBatch(std::ostream& out, const Batch& batch);
+
+private:
+	// Helper method for batches
+	static void	convertInto(const std::string& input, Batch& batch);
 };
 
 #endif
@@ -0,0 +1,219 @@
+#include "ScalarConverter.hpp"
+#include <fstream>
+#include <sstream>
+#include <cstdio>
+#include <cstring>
+#include <sys/time.h>
+
+// Benchmark and regression check for ScalarConverter. Times batch
+// parsing and output over generated columns of each kind of literal,
+// then runs the literals of bench_corpus.txt, together with random ones,
+// through both convert and the batch path, and compares the text with
+// bench_expected.txt and between the paths.
+// Usage: ./scalar_bench [literals per kind=200000] [--record]
+// --record rewrites bench_expected.txt from the current output instead
+// of comparing; do that only after checking an intended change
+
+static unsigned int g_seed = 42;
+
+static unsigned int nextRandom(void)
+{
+	g_seed = g_seed * 1103515245u + 12345u;
+	return (g_seed >> 8) & 0xffffff;
+}
+
+// Wall clock in milliseconds
+static double nowMs(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+static std::string digits(int count)
+{
+	std::string s;
+	for (int i = 0; i < count; i++)
+		s += static_cast<char>('0' + nextRandom() % 10);
+	return s;
+}
+
+static std::string sign(void)
+{
+	unsigned int r = nextRandom() % 4;
+	return r == 0 ? "-" : r == 1 ? "+" : "";
+}
+
+// One literal of the given kind: 0 char, 1 int, 2 float, 3 double,
+// 4 pseudo-literal, 5 malformed
+static std::string literal(int kind)
+{
+	static const char* pseudo[] = {"nan", "nanf", "+inf", "-inf", "+inff", "-inff"};
+	static const char noise[] = "0123456789+-.f'ae x";
+	std::string s;
+	
+	switch (kind)
+	{
+		case 0:
+			return std::string("'") + static_cast<char>(32 + nextRandom() % 95) + "'";
+		case 1:
+			return sign() + digits(1 + nextRandom() % 9);
+		case 2:
+			return sign() + digits(1 + nextRandom() % 5) + "." + digits(1 + nextRandom() % 6) + "f";
+		case 3:
+			return sign() + digits(1 + nextRandom() % 8) + "." + digits(1 + nextRandom() % 10);
+		case 4:
+			return pseudo[nextRandom() % 6];
+		default:
+			for (unsigned int n = 1 + nextRandom() % 8; n > 0; n--)
+				s += noise[nextRandom() % (sizeof(noise) - 1)];
+			return s;
+	}
+}
+
+// What convert prints for input, captured
+static std::string convertText(const std::string& input)
+{
+	std::ostringstream captured;
+	std::streambuf* saved = std::cout.rdbuf(captured.rdbuf());
+	ScalarConverter::convert(input);
+	std::cout.rdbuf(saved);
+	return captured.str();
+}
+
+static void timeKinds(size_t count)
+{
+	static const char* names[] = {"char", "int", "float", "double", "pseudo", "malformed"};
+	
+	std::printf("%-10s %14s %14s\n", "kind", "parse /s", "parse+text /s");
+	for (int kind = 0; kind < 6; kind++)
+	{
+		std::vector<std::string> inputs;
+		inputs.reserve(count);
+		for (size_t i = 0; i < count; i++)
+			inputs.push_back(literal(kind));
+		
+		ScalarConverter::Batch batch;
+		double start = nowMs();
+		ScalarConverter::convertBatch(inputs, batch);
+		double parsed = nowMs();
+		std::ostringstream text;
+		ScalarConverter::writeBatch(text, batch);
+		double written = nowMs();
+		std::printf("%-10s %14.0f %14.0f\n", names[kind], count / ((parsed - start) / 1000.0),
+			count / ((written - start) / 1000.0));
+	}
+}
+
+// Text of every corpus literal through the batch path, and the number of
+// literals whose convert output differs from it
+static std::string runCorpus(const std::vector<std::string>& inputs, size_t& pathDiffs)
+{
+	ScalarConverter::Batch batch;
+	ScalarConverter::convertBatch(inputs, batch);
+	std::string text;
+	pathDiffs = 0;
+	for (size_t i = 0; i < inputs.size(); i++)
+	{
+		ScalarConverter::Batch one;
+		std::vector<std::string> single(1, inputs[i]);
+		ScalarConverter::convertBatch(single, one);
+		std::ostringstream batched;
+		ScalarConverter::writeBatch(batched, one);
+		std::string direct = convertText(inputs[i]);
+		if (direct != batched.str())
+		{
+			if (pathDiffs++ < 5)
+				std::printf("  paths differ for [%s]\n", inputs[i].c_str());
+		}
+		text += direct;
+	}
+	return text;
+}
+
+// Compare line by line, showing the first few differences
+static size_t compareText(const std::string& expected, const std::string& actual)
+{
+	std::istringstream a(expected);
+	std::istringstream b(actual);
+	std::string x;
+	std::string y;
+	size_t line = 0;
+	size_t diffs = 0;
+	
+	while (true)
+	{
+		bool moreA = static_cast<bool>(std::getline(a, x));
+		bool moreB = static_cast<bool>(std::getline(b, y));
+		if (!moreA && !moreB)
+			break;
+		line++;
+		if (!moreA || !moreB || x != y)
+		{
+			if (diffs++ < 10)
+				std::printf("  line %lu: expected [%s], got [%s]\n", static_cast<unsigned long>(line),
+					moreA ? x.c_str() : "", moreB ? y.c_str() : "");
+		}
+	}
+	return diffs;
+}
+
+static std::string readFile(const char* name, bool& found)
+{
+	std::ifstream in(name);
+	std::ostringstream content;
+	found = static_cast<bool>(in);
+	content << in.rdbuf();
+	return content.str();
+}
+
+int main(int argc, char** argv)
+{
+	size_t count = 200000;
+	bool record = false;
+	for (int i = 1; i < argc; i++)
+	{
+		if (std::strcmp(argv[i], "--record") == 0)
+			record = true;
+		else
+			count = std::strtoul(argv[i], NULL, 10);
+	}
+	
+	timeKinds(count);
+	
+	// The corpus file, then random literals of every kind, the same ones
+	// each run
+	std::vector<std::string> corpus;
+	std::ifstream file("bench_corpus.txt");
+	std::string line;
+	while (std::getline(file, line))
+		corpus.push_back(line);
+	size_t fromFile = corpus.size();
+	g_seed = 2024;
+	for (int i = 0; i < 3000; i++)
+		corpus.push_back(literal(i % 6));
+	
+	size_t pathDiffs;
+	std::string actual = runCorpus(corpus, pathDiffs);
+	std::printf("corpus: %lu literals (%lu from bench_corpus.txt), convert and batch differ on %lu\n",
+		static_cast<unsigned long>(corpus.size()), static_cast<unsigned long>(fromFile),
+		static_cast<unsigned long>(pathDiffs));
+	
+	if (record)
+	{
+		std::ofstream out("bench_expected.txt");
+		out << actual;
+		std::printf("recorded bench_expected.txt\n");
+		return pathDiffs != 0;
+	}
+	bool found;
+	std::string expected = readFile("bench_expected.txt", found);
+	if (!found)
+	{
+		std::printf("no bench_expected.txt; run with --record to create it\n");
+		return 1;
+	}
+	size_t diffs = compareText(expected, actual);
+	std::printf("reference: %lu line(s) differ from bench_expected.txt\n", static_cast<unsigned long>(diffs));
+	return diffs != 0 || pathDiffs != 0;
+}
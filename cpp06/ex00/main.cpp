@@ -11,9 +11,17 @@ int main(int argc, char** argv)
 		std::cout << "  " << argv[0] << " 42.0f" << std::endl;
 		std::cout << "  " << argv[0] << " 42.0" << std::endl;
 		std::cout << "  " << argv[0] << " nanf" << std::endl;
+		std::cout << "  " << argv[0] << " - < literals.txt   (one literal per line)" << std::endl;
 		return 1;
 	}
-
+	
+	if (std::string(argv[1]) == "-")
+	{
+		ScalarConverter::Batch batch;
+		ScalarConverter::convertBatch(std::cin, batch);
+		ScalarConverter::writeBatch(std::cout, batch);
+		return 0;
+	}
 	ScalarConverter::convert(argv[1]);
 	return 0;
 }
@@ -1,11 +1,11 @@
 #include "Data.hpp"
 
-Data::Data() : id(0), name(""), value(0.0), active(false)
+Data::Data() : value(0.0), name(""), id(0), active(false)
 {
 }
 
 Data::Data(int id, const std::string& name, double value, bool active)
-	: id(id), name(name), value(value), active(active)
+	: value(value), name(name), id(id), active(active)
 {
 }
 
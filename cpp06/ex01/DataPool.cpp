@@ -0,0 +1,122 @@
+#include "DataPool.hpp"
+#include <new>
+
+// Each slot holds a Data while it is alive and a free-list link after
+static const size_t SLOT_SIZE = sizeof(Data) > sizeof(void*) ? sizeof(Data) : sizeof(void*);
+static const size_t FIRST_CHUNK = 64;
+static const size_t LAST_CHUNK = 65536;
+
+DataPool::DataPool() : _free(NULL), _nextChunk(FIRST_CHUNK), _live(0), _capacity(0)
+{
+}
+
+DataPool::DataPool(const DataPool& other) : _free(NULL), _nextChunk(FIRST_CHUNK), _live(0), _capacity(0)
+{
+	(void)other;
+}
+
+DataPool& DataPool::operator=(const DataPool& other)
+{
+	(void)other;
+	return *this;
+}
+
+DataPool::~DataPool()
+{
+	for (size_t i = 0; i < _chunks.size(); i++)
+		::operator delete(_chunks[i]);
+}
+
+// Add a chunk and thread its slots onto the free list, first slot first
+void DataPool::_grow()
+{
+	char* chunk = static_cast<char*>(::operator new(_nextChunk * SLOT_SIZE));
+	_chunks.push_back(chunk);
+	for (size_t i = _nextChunk; i > 0; i--)
+	{
+		FreeSlot* slot = reinterpret_cast<FreeSlot*>(chunk + (i - 1) * SLOT_SIZE);
+		slot->next = _free;
+		_free = slot;
+	}
+	_capacity += _nextChunk;
+	if (_nextChunk < LAST_CHUNK)
+		_nextChunk *= 2;
+}
+
+void* DataPool::_take()
+{
+	if (!_free)
+		_grow();
+	FreeSlot* slot = _free;
+	_free = slot->next;
+	return slot;
+}
+
+void DataPool::_give(void* place)
+{
+	FreeSlot* slot = static_cast<FreeSlot*>(place);
+	slot->next = _free;
+	_free = slot;
+}
+
+// Each create takes a slot, and gives it back if the constructor throws
+Data* DataPool::create()
+{
+	return create(Data());
+}
+
+Data* DataPool::create(const Data& data)
+{
+	void* slot = _take();
+	try
+	{
+		Data* record = new (slot) Data(data);
+		_live++;
+		return record;
+	}
+	catch (...)
+	{
+		_give(slot);
+		throw;
+	}
+}
+
+Data* DataPool::create(int id, const std::string& name, double value, bool active)
+{
+	void* slot = _take();
+	try
+	{
+		Data* record = new (slot) Data(id, name, value, active);
+		_live++;
+		return record;
+	}
+	catch (...)
+	{
+		_give(slot);
+		throw;
+	}
+}
+
+void DataPool::destroy(Data* data)
+{
+	if (!data)
+		return;
+	data->~Data();
+	_give(data);
+	_live--;
+}
+
+size_t DataPool::size() const
+{
+	return _live;
+}
+
+size_t DataPool::capacity() const
+{
+	return _capacity;
+}
+
+size_t DataPool::chunks() const
+{
+	return _chunks.size();
+}
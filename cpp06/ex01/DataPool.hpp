@@ -0,0 +1,51 @@
+#ifndef DATAPOOL_HPP
+#define DATAPOOL_HPP
+
+#include "Data.hpp"
+#include <vector>
+#include <cstddef>
+
+// Allocator of Data records carved out of large chunks: one call to the
+// system allocator serves a whole chunk, chunks grow from 64 to 65536
+// records, and a destroyed record's place is reused by the next create.
+// Records carry no allocator header, so a pooled record costs
+// sizeof(Data) bytes. Destroy every record before the pool goes away:
+// the pool frees its chunks but does not run the destructors of records
+// still alive in them
+class DataPool
+{
+private:
+	struct FreeSlot
+	{
+		FreeSlot*	next;
+	};
+	
+	std::vector<void*>	_chunks;
+	FreeSlot*			_free;
+	size_t				_nextChunk;	// records in the next chunk
+	size_t				_live;
+	size_t				_capacity;
+	
+	void	_grow();
+	void*	_take();
+	void	_give(void* slot);
+	
+	// A pool owns its chunks: no copies
+	DataPool(const DataPool& other);
+	DataPool& operator=(const DataPool& other);
+
+public:
+	DataPool();
+	~DataPool();
+	
+	Data*	create();
+	Data*	create(const Data& data);
+	Data*	create(int id, const std::string& name, double value, bool active);
+	void	destroy(Data* data);
+	
+	size_t	size() const;		// records alive
+	size_t	capacity() const;	// records the chunks can hold
+	size_t	chunks() const;		// allocator calls made
+};
+
+#endif
@@ -0,0 +1,144 @@
+#include "DataRegistry.hpp"
+
+DataRegistry::DataRegistry() : _free(NONE)
+{
+}
+
+DataRegistry::DataRegistry(const DataRegistry& other)
+	: _slots(other._slots), _records(other._records), _owners(other._owners), _free(other._free)
+{
+}
+
+DataRegistry& DataRegistry::operator=(const DataRegistry& other)
+{
+	if (this != &other)
+	{
+		_slots = other._slots;
+		_records = other._records;
+		_owners = other._owners;
+		_free = other._free;
+	}
+	return *this;
+}
+
+DataRegistry::~DataRegistry()
+{
+}
+
+const DataRegistry::Slot* DataRegistry::_find(Handle handle) const
+{
+	uint32_t index = static_cast<uint32_t>(handle);
+	uint32_t generation = static_cast<uint32_t>(handle >> 32);
+	
+	if (index >= _slots.size() || _slots[index].generation != generation || !(generation & 1))
+		return NULL;
+	return &_slots[index];
+}
+
+// End the generation of a slot and put it on the free list. A slot whose
+// generation would wrap is retired instead, so that no stale handle can
+// ever come back to life
+void DataRegistry::_release(uint32_t index)
+{
+	Slot& slot = _slots[index];
+	slot.generation++;
+	if (slot.generation != 0xFFFFFFFEu)
+	{
+		slot.index = _free;
+		_free = index;
+	}
+}
+
+DataRegistry::Handle DataRegistry::insert(const Data& data)
+{
+	uint32_t index;
+	
+	if (_free != NONE)
+	{
+		index = _free;
+		_free = _slots[index].index;
+	}
+	else
+	{
+		index = static_cast<uint32_t>(_slots.size());
+		Slot slot = {0, 0};
+		_slots.push_back(slot);
+	}
+	Slot& slot = _slots[index];
+	slot.generation++;
+	slot.index = static_cast<uint32_t>(_records.size());
+	_records.push_back(data);
+	_owners.push_back(index);
+	return static_cast<Handle>(slot.generation) << 32 | index;
+}
+
+bool DataRegistry::erase(Handle handle)
+{
+	if (!_find(handle))
+		return false;
+	uint32_t index = static_cast<uint32_t>(handle);
+	Slot& slot = _slots[index];
+	
+	// Move the last record into the hole
+	uint32_t last = static_cast<uint32_t>(_records.size() - 1);
+	if (slot.index != last)
+	{
+		_records[slot.index] = _records[last];
+		_owners[slot.index] = _owners[last];
+		_slots[_owners[last]].index = slot.index;
+	}
+	_records.pop_back();
+	_owners.pop_back();
+	
+	_release(index);
+	return true;
+}
+
+Data* DataRegistry::get(Handle handle)
+{
+	const Slot* slot = _find(handle);
+	return slot ? &_records[slot->index] : NULL;
+}
+
+const Data* DataRegistry::get(Handle handle) const
+{
+	const Slot* slot = _find(handle);
+	return slot ? &_records[slot->index] : NULL;
+}
+
+bool DataRegistry::contains(Handle handle) const
+{
+	return _find(handle) != NULL;
+}
+
+// Every live handle becomes stale; slots are kept for reuse
+void DataRegistry::clear()
+{
+	for (size_t i = 0; i < _owners.size(); i++)
+	{
+		_release(_owners[i]);
+	}
+	_records.clear();
+	_owners.clear();
+}
+
+size_t DataRegistry::size() const
+{
+	return _records.size();
+}
+
+Data* DataRegistry::data()
+{
+	return _records.empty() ? NULL : &_records[0];
+}
+
+const Data* DataRegistry::data() const
+{
+	return _records.empty() ? NULL : &_records[0];
+}
+
+DataRegistry::Handle DataRegistry::handleAt(size_t i) const
+{
+	uint32_t index = _owners[i];
+	return static_cast<Handle>(_slots[index].generation) << 32 | index;
+}
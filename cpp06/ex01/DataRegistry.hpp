@@ -0,0 +1,59 @@
+#ifndef DATAREGISTRY_HPP
+#define DATAREGISTRY_HPP
+
+#include "Data.hpp"
+#include <vector>
+#include <stdint.h>
+
+// Owner of Data records handing out handles instead of addresses. A
+// handle is the index of a slot in its low 32 bits and the slot's
+// generation in the high ones: erasing a record bumps the generation, so
+// an old handle is told apart from one to whatever reuses the slot, and
+// get returns NULL for it instead of a dangling pointer. Handle 0 is
+// never valid and can stand for none.
+// Records are kept contiguous, in no particular order, for fast scans;
+// a pointer from get is only good until the next insert or erase
+class DataRegistry
+{
+public:
+	typedef uint64_t	Handle;
+
+private:
+	struct Slot
+	{
+		uint32_t	generation;	// odd while the slot holds a record
+		uint32_t	index;		// into _records, or the next free slot
+	};
+	
+	static const uint32_t	NONE = 0xFFFFFFFFu;
+	
+	std::vector<Slot>		_slots;
+	std::vector<Data>		_records;
+	std::vector<uint32_t>	_owners;	// slot of each record
+	uint32_t				_free;		// first free slot, or NONE
+	
+	const Slot*	_find(Handle handle) const;
+	void		_release(uint32_t index);
+
+public:
+	DataRegistry();
+	DataRegistry(const DataRegistry& other);
+	DataRegistry& operator=(const DataRegistry& other);
+	~DataRegistry();
+	
+	Handle		insert(const Data& data);
+	bool		erase(Handle handle);
+	Data*		get(Handle handle);
+	const Data*	get(Handle handle) const;
+	bool		contains(Handle handle) const;
+	void		clear();
+	
+	size_t	size() const;
+	
+	// The records, for scans, and the handle of each
+	Data*		data();
+	const Data*	data() const;
+	Handle		handleAt(size_t i) const;
+};
+
+#endif
@@ -0,0 +1,325 @@
+#include "DataStream.hpp"
+#include "Serializer.hpp"
+#include "Encoding.hpp"
+#include <cerrno>
+#include <cstring>
+#include <unistd.h>
+#include <sys/uio.h>
+
+// Largest record a frame can carry, its payload length being 32-bit
+static const size_t RECORD_MAX = 0xFFFFFFFFu - FRAME_HEADER;
+// Free space the reader offers each read at least
+static const size_t READ_CHUNK = 65536;
+
+DataWriter::DataWriter(int fd, size_t frameBytes) :
+	_fd(fd), _frameBytes(frameBytes < RECORD_MAX ? frameBytes : RECORD_MAX), _front(0), _error(0), _frames(0)
+{
+	for (int i = 0; i < 2; i++)
+	{
+		_buffers[i].bytes.reserve(_frameBytes);
+		_reset(_buffers[i]);
+	}
+}
+
+DataWriter::DataWriter(const DataWriter& other) : _fd(-1), _frameBytes(0), _front(0), _error(0), _frames(0)
+{
+	(void)other;
+}
+
+DataWriter& DataWriter::operator=(const DataWriter& other)
+{
+	(void)other;
+	return *this;
+}
+
+DataWriter::~DataWriter()
+{
+}
+
+// The buffer records go to, or NULL when both are framed
+DataWriter::Buffer* DataWriter::_open()
+{
+	if (!_buffers[_front].framed)
+		return &_buffers[_front];
+	Buffer& back = _buffers[_front ^ 1];
+	return back.framed ? NULL : &back;
+}
+
+void DataWriter::_frame(Buffer& buffer)
+{
+	put32(&buffer.bytes[0], static_cast<uint32_t>(buffer.bytes.size() - FRAME_HEADER));
+	put32(&buffer.bytes[4], buffer.count);
+	buffer.framed = true;
+}
+
+// Keeps the capacity, so a buffer is allocated once
+void DataWriter::_reset(Buffer& buffer)
+{
+	buffer.bytes.resize(FRAME_HEADER);
+	buffer.count = 0;
+	buffer.sent = 0;
+	buffer.framed = false;
+}
+
+// Write the framed buffers, older first, until both are sent or the
+// descriptor would block
+StreamStatus DataWriter::_send()
+{
+	if (_error)
+		return STREAM_ERROR;
+	for (;;)
+	{
+		struct iovec iov[2];
+		int count = 0;
+		for (int i = 0; i < 2; i++)
+		{
+			Buffer& buffer = _buffers[_front ^ i];
+			if (!buffer.framed)
+				break;
+			iov[count].iov_base = &buffer.bytes[buffer.sent];
+			iov[count].iov_len = buffer.bytes.size() - buffer.sent;
+			count++;
+		}
+		if (count == 0)
+			return STREAM_OK;
+
+		ssize_t written = ::writev(_fd, iov, count);
+		if (written < 0 && errno == EINTR)
+			continue;
+		if (written < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return STREAM_BLOCKED;
+		if (written < 0)
+		{
+			_error = errno;
+			return STREAM_ERROR;
+		}
+
+		size_t left = static_cast<size_t>(written);
+		while (left)
+		{
+			Buffer& front = _buffers[_front];
+			size_t part = front.bytes.size() - front.sent;
+			if (part > left)
+				part = left;
+			front.sent += part;
+			left -= part;
+			if (front.sent == front.bytes.size())
+			{
+				_reset(front);
+				_front ^= 1;
+				_frames++;
+			}
+		}
+	}
+}
+
+StreamStatus DataWriter::push(const Data& data)
+{
+	if (_error)
+		return STREAM_ERROR;
+	size_t size = Serializer::encodedSize(data);
+	if (size > RECORD_MAX)
+		return STREAM_MALFORMED;
+
+	Buffer* open = _open();
+	if (open && open->count && open->bytes.size() + size > _frameBytes)
+	{
+		_frame(*open);
+		open = NULL;
+	}
+	if (!open)
+	{
+		if (_send() == STREAM_ERROR)
+			return STREAM_ERROR;
+		open = _open();
+		if (!open)
+			return STREAM_BLOCKED;
+	}
+
+	size_t at = open->bytes.size();
+	open->bytes.resize(at + size);
+	Serializer::encode(data, &open->bytes[at], size);
+	open->count++;
+
+	// A full buffer goes out at once, while the other one takes records
+	if (open->bytes.size() >= _frameBytes)
+	{
+		_frame(*open);
+		if (_send() == STREAM_ERROR)
+			return STREAM_ERROR;
+	}
+	return STREAM_OK;
+}
+
+StreamStatus DataWriter::flush()
+{
+	Buffer* open = _open();
+	if (open && open->count)
+		_frame(*open);
+	return _send();
+}
+
+bool DataWriter::pending() const
+{
+	return _buffers[0].count || _buffers[1].count;
+}
+
+size_t DataWriter::frames() const
+{
+	return _frames;
+}
+
+int DataWriter::error() const
+{
+	return _error;
+}
+
+DataReader::DataReader(int fd, size_t maxFrame) :
+	_fd(fd), _maxFrame(maxFrame), _start(0), _end(0), _frameEnd(0), _left(0), _status(STREAM_OK), _error(0),
+	_frames(0)
+{
+}
+
+DataReader::DataReader(const DataReader& other) :
+	_fd(-1), _maxFrame(0), _start(0), _end(0), _frameEnd(0), _left(0), _status(STREAM_OK), _error(0), _frames(0)
+{
+	(void)other;
+}
+
+DataReader& DataReader::operator=(const DataReader& other)
+{
+	(void)other;
+	return *this;
+}
+
+DataReader::~DataReader()
+{
+}
+
+// Start on the frame at _start if the buffer holds all of it; empty
+// frames are skipped whole
+bool DataReader::_nextFrame()
+{
+	while (_end - _start >= FRAME_HEADER)
+	{
+		size_t length = get32(&_buffer[_start]);
+		uint32_t count = get32(&_buffer[_start + 4]);
+		if (length > _maxFrame || (count == 0 && length != 0))
+		{
+			_status = STREAM_MALFORMED;
+			return false;
+		}
+		if (_end - _start - FRAME_HEADER < length)
+			return false;
+		_start += FRAME_HEADER;
+		_frameEnd = _start + length;
+		_left = count;
+		if (_left)
+			return true;
+		_frames++;
+	}
+	return false;
+}
+
+StreamStatus DataReader::next(DataView& view)
+{
+	if (_status == STREAM_ERROR || _status == STREAM_MALFORMED)
+		return _status;
+	if (!_left && !_nextFrame())
+	{
+		// Bytes left over once the stream ended are a cut frame
+		if (_status == STREAM_END && _end > _start)
+			_status = STREAM_MALFORMED;
+		return _status == STREAM_OK ? STREAM_BLOCKED : _status;
+	}
+
+	size_t size = view.bind(&_buffer[0] + _start, _frameEnd - _start);
+	// A record cut short by its frame, or a frame with bytes after its
+	// last record, means the lengths do not agree
+	if (!size || (_left == 1 && _start + size != _frameEnd))
+	{
+		_status = STREAM_MALFORMED;
+		return _status;
+	}
+	_start += size;
+	if (--_left == 0)
+		_frames++;
+	return STREAM_OK;
+}
+
+StreamStatus DataReader::receive()
+{
+	if (_status != STREAM_OK)
+		return _status;
+
+	// Room for the rest of the frame at _start, and at least READ_CHUNK;
+	// what was consumed is dropped first, before growing the buffer
+	size_t want = READ_CHUNK;
+	if (!_left && _end - _start >= FRAME_HEADER)
+	{
+		size_t length = get32(&_buffer[_start]);
+		if (length <= _maxFrame && FRAME_HEADER + length - (_end - _start) > want)
+			want = FRAME_HEADER + length - (_end - _start);
+	}
+	if (_buffer.size() - _end < want && _start > 0)
+	{
+		std::memmove(&_buffer[0], &_buffer[_start], _end - _start);
+		_end -= _start;
+		if (_left)
+			_frameEnd -= _start;
+		_start = 0;
+	}
+	if (_buffer.size() - _end < want)
+		_buffer.resize(_end + want);
+
+	for (;;)
+	{
+		ssize_t got = ::read(_fd, &_buffer[_end], _buffer.size() - _end);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+			return STREAM_BLOCKED;
+		if (got < 0)
+		{
+			_error = errno;
+			_status = STREAM_ERROR;
+			return _status;
+		}
+		if (got == 0)
+		{
+			_status = STREAM_END;
+			return _status;
+		}
+		_end += static_cast<size_t>(got);
+		return STREAM_OK;
+	}
+}
+
+StreamStatus DataReader::read(Data& data)
+{
+	DataView view;
+	for (;;)
+	{
+		StreamStatus status = next(view);
+		if (status == STREAM_OK)
+		{
+			view.copyTo(data);
+			return STREAM_OK;
+		}
+		if (status != STREAM_BLOCKED)
+			return status;
+		status = receive();
+		if (status == STREAM_BLOCKED || status == STREAM_ERROR)
+			return status;
+	}
+}
+
+size_t DataReader::frames() const
+{
+	return _frames;
+}
+
+int DataReader::error() const
+{
+	return _error;
+}
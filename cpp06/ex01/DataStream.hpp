@@ -0,0 +1,126 @@
+#ifndef DATASTREAM_HPP
+#define DATASTREAM_HPP
+
+#include "Data.hpp"
+#include "DataView.hpp"
+#include <stdint.h>
+#include <cstddef>
+#include <vector>
+
+// Records sent over a file descriptor, a pipe or a socket, in frames: an
+// 8-byte header of the payload length and the record count, both 32-bit
+// little-endian, then that many records as Serializer::encode writes
+// them. The descriptor may be blocking or not; on a non-blocking one a
+// call that would wait returns STREAM_BLOCKED instead, and is retried
+// once poll or select reports the descriptor ready
+enum StreamStatus
+{
+	STREAM_OK,
+	STREAM_BLOCKED,		// the descriptor would block; nothing was lost
+	STREAM_END,			// the other end closed the stream between frames
+	STREAM_ERROR,		// a system call failed, see error()
+	STREAM_MALFORMED	// a bad frame, or the stream ended inside one
+};
+
+static const size_t FRAME_HEADER = 8;
+
+// Writer of frames with two buffers: records are encoded into one while
+// the other, already framed, is being written, and a single writev sends
+// what is left of both. A buffer is framed once it holds frameBytes, or
+// on flush. When both are framed and unsent, push refuses the record
+// with STREAM_BLOCKED: that is the backpressure, bounding memory to two
+// frames however slow the reader is. Errors stick: once a call returned
+// STREAM_ERROR every later one does. Writing to a socket whose reader is
+// gone raises SIGPIPE, so servers should ignore that signal. The writer
+// does not own the descriptor, and its destructor sends nothing: flush
+// until it returns STREAM_OK first
+class DataWriter
+{
+private:
+	struct Buffer
+	{
+		std::vector<unsigned char>	bytes;	// header, then the records
+		uint32_t					count;
+		size_t						sent;
+		bool						framed;
+	};
+	
+	int		_fd;
+	size_t	_frameBytes;
+	Buffer	_buffers[2];
+	int		_front;		// the older buffer, written first
+	int		_error;
+	size_t	_frames;
+	
+	Buffer*			_open();
+	void			_frame(Buffer& buffer);
+	void			_reset(Buffer& buffer);
+	StreamStatus	_send();
+	
+	// A writer holds unsent bytes for its descriptor: no copies
+	DataWriter(const DataWriter& other);
+	DataWriter& operator=(const DataWriter& other);
+	
+public:
+	DataWriter(int fd, size_t frameBytes = 65536);
+	~DataWriter();
+	
+	// Add a record to the open frame, sending framed ones as the
+	// descriptor takes them. A record larger than frameBytes gets a frame
+	// of its own; one too large for a 32-bit length is STREAM_MALFORMED
+	StreamStatus	push(const Data& data);
+	// Frame what was pushed and send everything; STREAM_BLOCKED leaves the
+	// rest for the next call
+	StreamStatus	flush();
+	
+	bool	pending() const;	// bytes pushed but not yet sent
+	size_t	frames() const;		// frames sent whole
+	int		error() const;		// errno of the failed call, or 0
+};
+
+// Reader of the frames of a DataWriter, one record per call: reads take
+// whatever the descriptor has, frames are reassembled however the bytes
+// were split, and records are handed out only from complete frames. A
+// frame header announcing more than maxFrame bytes is STREAM_MALFORMED,
+// so a corrupt or hostile stream cannot make the reader allocate
+// gigabytes. Errors stick, as in DataWriter. The reader does not own the
+// descriptor
+class DataReader
+{
+private:
+	int							_fd;
+	size_t						_maxFrame;
+	std::vector<unsigned char>	_buffer;
+	size_t						_start;		// first byte not consumed
+	size_t						_end;		// first byte not filled
+	size_t						_frameEnd;	// of the frame being read, if _left
+	uint32_t					_left;		// records left in that frame
+	StreamStatus				_status;	// once it is not STREAM_OK
+	int							_error;
+	size_t						_frames;
+	
+	bool	_nextFrame();
+	
+	// No copies: two readers would split the stream between them
+	DataReader(const DataReader& other);
+	DataReader& operator=(const DataReader& other);
+	
+public:
+	DataReader(int fd, size_t maxFrame = 1 << 24);
+	~DataReader();
+	
+	// The next record into data, reusing the storage of its name, reading
+	// from the descriptor until a frame is complete
+	StreamStatus	read(Data& data);
+	// The next record in place, valid until the next call; never reads
+	// from the descriptor, STREAM_BLOCKED when no complete frame is left
+	StreamStatus	next(DataView& view);
+	// One read of whatever the descriptor has, for callers that poll it
+	// themselves and then take the records with next
+	StreamStatus	receive();
+	
+	size_t	frames() const;		// frames read whole
+	int		error() const;		// errno of the failed call, or 0
+};
+
+#endif
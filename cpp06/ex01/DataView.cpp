@@ -0,0 +1,100 @@
+#include "DataView.hpp"
+#include "Encoding.hpp"
+
+DataView::DataView() : _id(0), _name(NULL), _nameLength(0), _tail(NULL), _size(0)
+{
+}
+
+DataView::DataView(const DataView& other)
+	: _id(other._id), _name(other._name), _nameLength(other._nameLength), _tail(other._tail), _size(other._size)
+{
+}
+
+DataView& DataView::operator=(const DataView& other)
+{
+	_id = other._id;
+	_name = other._name;
+	_nameLength = other._nameLength;
+	_tail = other._tail;
+	_size = other._size;
+	return *this;
+}
+
+DataView::~DataView()
+{
+}
+
+size_t DataView::bind(const unsigned char* buffer, size_t length)
+{
+	const unsigned char* end = buffer + length;
+	const unsigned char* p = buffer;
+	uint32_t id;
+	uint32_t size;
+	size_t n;
+	
+	*this = DataView();
+	if ((n = getVarint(p, end, id)) == 0)
+		return 0;
+	p += n;
+	if ((n = getVarint(p, end, size)) == 0)
+		return 0;
+	p += n;
+	if (static_cast<size_t>(end - p) < static_cast<size_t>(size) + 8 + 1 || p[size + 8] > 1)
+		return 0;
+	_id = unzigzag(id);
+	_name = reinterpret_cast<const char*>(p);
+	_nameLength = size;
+	_tail = p + size;
+	_size = _tail + 8 + 1 - buffer;
+	return _size;
+}
+
+bool DataView::valid() const
+{
+	return _size != 0;
+}
+
+size_t DataView::size() const
+{
+	return _size;
+}
+
+int DataView::id() const
+{
+	return _id;
+}
+
+const char* DataView::name() const
+{
+	return _name;
+}
+
+size_t DataView::nameLength() const
+{
+	return _nameLength;
+}
+
+double DataView::value() const
+{
+	return _tail ? getDouble(_tail) : 0.0;
+}
+
+bool DataView::active() const
+{
+	return _tail && _tail[8] != 0;
+}
+
+void DataView::copyTo(Data& data) const
+{
+	data.id = _id;
+	data.name.assign(_name ? _name : "", _nameLength);
+	data.value = value();
+	data.active = active();
+}
+
+Data DataView::materialize() const
+{
+	Data data;
+	copyTo(data);
+	return data;
+}
@@ -0,0 +1,44 @@
+#ifndef DATAVIEW_HPP
+#define DATAVIEW_HPP
+
+#include "Data.hpp"
+#include <cstddef>
+
+// Read-only view of one record encoded by Serializer::encode, in place
+// in the buffer that holds it: nothing is copied or allocated, and the
+// view is only valid while the buffer is. Filter on the fields, then
+// build a Data for the records worth keeping
+class DataView
+{
+private:
+	int						_id;
+	const char*				_name;
+	size_t					_nameLength;
+	const unsigned char*	_tail;	// value and active
+	size_t					_size;
+
+public:
+	DataView();
+	DataView(const DataView& other);
+	DataView& operator=(const DataView& other);
+	~DataView();
+	
+	// View the record at the start of buffer; returns its size in bytes,
+	// to step to the next one, or 0 if it is cut short or malformed,
+	// leaving the view empty
+	size_t	bind(const unsigned char* buffer, size_t length);
+	
+	bool		valid() const;
+	size_t		size() const;
+	int			id() const;
+	const char*	name() const;	// not null-terminated
+	size_t		nameLength() const;
+	double		value() const;
+	bool		active() const;
+	
+	// Copy the record out, reusing the storage of data.name
+	void	copyTo(Data& data) const;
+	Data	materialize() const;
+};
+
+#endif
@@ -0,0 +1,94 @@
+#ifndef ENCODING_HPP
+#define ENCODING_HPP
+
+#include <stdint.h>
+#include <cstddef>
+#include <cstring>
+
+// Byte helpers of the Serializer encodings, shared with DataView.
+// Unsigned integers are written 7 bits per byte, low
+// bits first, with the top bit set on every byte but the last; the id is
+// zigzag-mapped first so that small negative ids stay short too
+static const size_t VARINT_MAX = 5;
+
+inline size_t putVarint(unsigned char* out, uint32_t value)
+{
+	size_t n = 0;
+	while (value >= 0x80)
+	{
+		out[n++] = static_cast<unsigned char>(value | 0x80);
+		value >>= 7;
+	}
+	out[n++] = static_cast<unsigned char>(value);
+	return n;
+}
+
+// Read a varint from [in, end); returns its length, or 0 if it runs past
+// end or is longer than a 32-bit value
+inline size_t getVarint(const unsigned char* in, const unsigned char* end, uint32_t& value)
+{
+	value = 0;
+	for (size_t n = 0; n < VARINT_MAX && in + n < end; n++)
+	{
+		value |= static_cast<uint32_t>(in[n] & 0x7F) << (7 * n);
+		if (!(in[n] & 0x80))
+			return n + 1;
+	}
+	return 0;
+}
+
+inline size_t varintSize(uint32_t value)
+{
+	size_t n = 1;
+	while (value >= 0x80)
+	{
+		value >>= 7;
+		n++;
+	}
+	return n;
+}
+
+inline uint32_t zigzag(int value)
+{
+	uint32_t bits = static_cast<uint32_t>(value);
+	return (bits << 1) ^ (value < 0 ? 0xFFFFFFFFu : 0u);
+}
+
+inline int unzigzag(uint32_t value)
+{
+	uint32_t bits = (value >> 1) ^ (0u - (value & 1));
+	return static_cast<int>(bits);
+}
+
+// The bits of a double, little-endian
+inline void putDouble(unsigned char* out, double value)
+{
+	uint64_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	for (int i = 0; i < 8; i++)
+		out[i] = static_cast<unsigned char>(bits >> (8 * i));
+}
+
+inline double getDouble(const unsigned char* in)
+{
+	uint64_t bits = 0;
+	for (int i = 0; i < 8; i++)
+		bits |= static_cast<uint64_t>(in[i]) << (8 * i);
+	double value;
+	std::memcpy(&value, &bits, sizeof(value));
+	return value;
+}
+
+inline void put32(unsigned char* out, uint32_t value)
+{
+	for (int i = 0; i < 4; i++)
+		out[i] = static_cast<unsigned char>(value >> (8 * i));
+}
+
+inline uint32_t get32(const unsigned char* in)
+{
+	return in[0] | static_cast<uint32_t>(in[1]) << 8 | static_cast<uint32_t>(in[2]) << 16
+		| static_cast<uint32_t>(in[3]) << 24;
+}
+
+#endif
@@ -1,4 +1,6 @@
 #include "Serializer.hpp"
+#include "Encoding.hpp"
+#include "DataView.hpp"
 
 // Private constructors (prevent instantiation)
 Serializer::Serializer() {}
@@ -16,3 +18,190 @@ Data* Serializer::deserialize(uintptr_t raw)
 {
 	return reinterpret_cast<Data*>(raw);
 }
+
+size_t Serializer::encodedSize(const Data& data)
+{
+	return varintSize(zigzag(data.id)) + varintSize(static_cast<uint32_t>(data.name.size()))
+		+ data.name.size() + 8 + 1;
+}
+
+size_t Serializer::encode(const Data& data, unsigned char* buffer, size_t capacity)
+{
+	if (data.name.size() > 0xFFFFFFFFu || encodedSize(data) > capacity)
+		return 0;
+	size_t n = putVarint(buffer, zigzag(data.id));
+	n += putVarint(buffer + n, static_cast<uint32_t>(data.name.size()));
+	std::memcpy(buffer + n, data.name.data(), data.name.size());
+	n += data.name.size();
+	putDouble(buffer + n, data.value);
+	n += 8;
+	buffer[n++] = data.active ? 1 : 0;
+	return n;
+}
+
+size_t Serializer::decode(const unsigned char* buffer, size_t length, Data& data)
+{
+	DataView view;
+	size_t size = view.bind(buffer, length);
+	if (size)
+		view.copyTo(data);
+	return size;
+}
+
+// Size of a block of count records with heap name bytes; the header is 8
+// bytes, so the values right after it stay 8-byte aligned in an aligned
+// buffer
+static size_t blockBytes(size_t count, size_t heap)
+{
+	return 8 + count * 8 + count * 4 + (count + 1) * 4 + (count + 7) / 8 + heap;
+}
+
+Serializer::Columns::Columns() : nameOffsets(1, 0)
+{
+}
+
+size_t Serializer::Columns::size() const
+{
+	return ids.size();
+}
+
+void Serializer::Columns::clear()
+{
+	ids.clear();
+	values.clear();
+	active.clear();
+	nameOffsets.assign(1, 0);
+	names.clear();
+}
+
+std::string Serializer::Columns::name(size_t i) const
+{
+	return names.substr(nameOffsets[i], nameOffsets[i + 1] - nameOffsets[i]);
+}
+
+Data Serializer::Columns::record(size_t i) const
+{
+	return Data(ids[i], name(i), values[i], active[i] != 0);
+}
+
+size_t Serializer::batchSize(const Data* records, size_t count)
+{
+	size_t heap = 0;
+	for (size_t i = 0; i < count; i++)
+		heap += records[i].name.size();
+	return blockBytes(count, heap);
+}
+
+size_t Serializer::encodeBatch(const Data* records, size_t count, unsigned char* buffer, size_t capacity)
+{
+	size_t heap = 0;
+	for (size_t i = 0; i < count; i++)
+		heap += records[i].name.size();
+	if (count > 0xFFFFFFFFu || heap > 0xFFFFFFFFu || blockBytes(count, heap) > capacity)
+		return 0;
+
+	unsigned char* values = buffer + 8;
+	unsigned char* ids = values + count * 8;
+	unsigned char* offsets = ids + count * 4;
+	unsigned char* bits = offsets + (count + 1) * 4;
+	unsigned char* names = bits + (count + 7) / 8;
+
+	put32(buffer, static_cast<uint32_t>(count));
+	put32(buffer + 4, static_cast<uint32_t>(heap));
+	std::memset(bits, 0, (count + 7) / 8);
+	uint32_t offset = 0;
+	for (size_t i = 0; i < count; i++)
+	{
+		const Data& data = records[i];
+		putDouble(values + i * 8, data.value);
+		put32(ids + i * 4, static_cast<uint32_t>(data.id));
+		put32(offsets + i * 4, offset);
+		if (data.active)
+			bits[i / 8] |= static_cast<unsigned char>(1 << (i % 8));
+		std::memcpy(names + offset, data.name.data(), data.name.size());
+		offset += static_cast<uint32_t>(data.name.size());
+	}
+	put32(offsets + count * 4, offset);
+	return names + heap - buffer;
+}
+
+size_t Serializer::decodeBatch(const unsigned char* buffer, size_t length, Columns& columns)
+{
+	if (length < 8)
+		return 0;
+	size_t count = get32(buffer);
+	size_t heap = get32(buffer + 4);
+	size_t size = blockBytes(count, heap);
+	if (size > length)
+		return 0;
+
+	const unsigned char* values = buffer + 8;
+	const unsigned char* ids = values + count * 8;
+	const unsigned char* offsets = ids + count * 4;
+	const unsigned char* bits = offsets + (count + 1) * 4;
+	const unsigned char* names = bits + (count + 7) / 8;
+
+	// Offsets must start at 0, never decrease and end at the heap size
+	uint32_t previous = 0;
+	for (size_t i = 0; i <= count; i++)
+	{
+		uint32_t offset = get32(offsets + i * 4);
+		if (offset < previous || (i == 0 && offset != 0))
+			return 0;
+		previous = offset;
+	}
+	if (previous != heap || columns.names.size() + heap > 0xFFFFFFFFu)
+		return 0;
+
+	size_t first = columns.size();
+	uint32_t base = static_cast<uint32_t>(columns.names.size());
+	columns.ids.resize(first + count);
+	columns.values.resize(first + count);
+	columns.active.resize(first + count);
+	columns.nameOffsets.resize(first + count + 1);
+	for (size_t i = 0; i < count; i++)
+	{
+		columns.values[first + i] = getDouble(values + i * 8);
+		columns.ids[first + i] = static_cast<int>(get32(ids + i * 4));
+		columns.active[first + i] = (bits[i / 8] >> (i % 8)) & 1;
+		columns.nameOffsets[first + i + 1] = base + get32(offsets + (i + 1) * 4);
+	}
+	columns.names.append(reinterpret_cast<const char*>(names), heap);
+	return size;
+}
+
+void Serializer::writeBatch(std::ostream& out, const Data* records, size_t count, size_t blockSize)
+{
+	std::vector<unsigned char> buffer;
+
+	if (blockSize == 0)
+		blockSize = 1;
+	for (size_t first = 0; first < count; first += blockSize)
+	{
+		size_t n = count - first < blockSize ? count - first : blockSize;
+		buffer.resize(batchSize(records + first, n));
+		encodeBatch(records + first, n, &buffer[0], buffer.size());
+		out.write(reinterpret_cast<const char*>(&buffer[0]), buffer.size());
+	}
+}
+
+bool Serializer::readBatch(std::istream& in, Columns& columns)
+{
+	unsigned char header[8];
+	if (!in.read(reinterpret_cast<char*>(header), 8))
+		return false;
+	size_t size = blockBytes(get32(header), get32(header + 4));
+
+	// Grow the buffer as the bytes arrive, so that a corrupt header on a
+	// short stream fails at its end instead of allocating gigabytes
+	std::vector<unsigned char> buffer(header, header + 8);
+	while (buffer.size() < size)
+	{
+		size_t have = buffer.size();
+		size_t chunk = size - have < (1u << 20) ? size - have : (1u << 20);
+		buffer.resize(have + chunk);
+		if (!in.read(reinterpret_cast<char*>(&buffer[have]), chunk))
+			return false;
+	}
+	return decodeBatch(&buffer[0], size, columns) == size;
+}
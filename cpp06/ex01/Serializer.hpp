@@ -3,6 +3,9 @@
 
 #include "Data.hpp"
 #include <stdint.h>
+#include <cstddef>
+#include <vector>
+#include <string>
 
 class Serializer
 {
@@ -17,6 +20,57 @@ public:
 	// Static methods for serialization/deserialization
 	static uintptr_t	serialize(Data* ptr);
 	static Data*		deserialize(uintptr_t raw);
+
+	// Binary encoding of a Data, for sending it to another process: id,
+	// name as a length and its bytes, value and active, in a byte order
+	// that does not depend on the machine. Integers are variable-length,
+	// so small ids and short names take a byte each.
+	// Bytes encode writes for data
+	static size_t	encodedSize(const Data& data);
+	// Write data to buffer; returns the bytes written, or 0 if more than
+	// capacity would be needed
+	static size_t	encode(const Data& data, unsigned char* buffer, size_t capacity);
+	// Read one record from buffer into data, reusing the storage of its
+	// name; returns the bytes read, or 0 if the record is cut short or
+	// malformed, leaving data unspecified
+	static size_t	decode(const unsigned char* buffer, size_t length, Data& data);
+
+	// Many records as columns: entry i of each array is record i, and the
+	// name of record i is names[nameOffsets[i], nameOffsets[i + 1]), so a
+	// scan of one column never touches the others
+	struct Columns
+	{
+		std::vector<int>			ids;
+		std::vector<double>			values;
+		std::vector<unsigned char>	active;			// 0 or 1
+		std::vector<uint32_t>		nameOffsets;	// size() + 1 entries
+		std::string					names;
+
+		Columns();
+
+		size_t		size() const;
+		void		clear();
+		std::string	name(size_t i) const;
+		Data		record(size_t i) const;
+	};
+
+	// Block encoding of count records: a header of the count and the name
+	// bytes, then the values, the ids, the name offsets, the active flags
+	// one bit each and the names, all fixed-width and little-endian
+	static size_t	batchSize(const Data* records, size_t count);
+	// Write a block to buffer; returns the bytes written, or 0 if more than
+	// capacity would be needed
+	static size_t	encodeBatch(const Data* records, size_t count, unsigned char* buffer, size_t capacity);
+	// Append the records of the block at buffer to columns; returns the
+	// bytes read, or 0 if the block is cut short or malformed, leaving
+	// columns as it was
+	static size_t	decodeBatch(const unsigned char* buffer, size_t length, Columns& columns);
+
+	// Streams of blocks, for more records than fit in memory twice: write
+	// them in blocks of blockSize, and read back one block per call,
+	// false at the end of the stream or on a malformed block
+	static void		writeBatch(std::ostream& out, const Data* records, size_t count, size_t blockSize = 4096);
+	static bool		readBatch(std::istream& in, Columns& columns);
 };
 
 #endif
@@ -1,7 +1,15 @@
 #include "Serializer.hpp"
 #include "Data.hpp"
+#include "DataView.hpp"
+#include "DataRegistry.hpp"
+#include "DataPool.hpp"
+#include "DataStream.hpp"
 #include <iostream>
 #include <iomanip>
+#include <sstream>
+#include <vector>
+#include <unistd.h>
+#include <fcntl.h>
 
 int main()
 {
@@ -121,6 +129,165 @@ int main()
 	std::cout << "sizeof(uintptr_t): " << sizeof(uintptr_t) << " bytes" << std::endl;
 	std::cout << "Data alignment: " << __alignof__(Data) << " bytes" << std::endl;
 
+	// Test 7: Binary encoding
+	std::cout << "\n--- Test 7: Binary encoding ---" << std::endl;
+	
+	unsigned char buffer[64];
+	Data sent(-7, "Encoded", 2.5, true);
+	size_t written = Serializer::encode(sent, buffer, sizeof(buffer));
+	std::cout << "Encoded " << written << " bytes:" << std::hex << std::setfill('0');
+	for (size_t i = 0; i < written; i++)
+		std::cout << " " << std::setw(2) << static_cast<int>(buffer[i]);
+	std::cout << std::dec << std::setfill(' ') << std::endl;
+	
+	Data received;
+	size_t read = Serializer::decode(buffer, written, received);
+	std::cout << "Decoded " << read << " bytes: ";
+	received.print();
+	std::cout << "Data content matches: " << (sent == received ? "YES" : "NO") << std::endl;
+	std::cout << "Too small a buffer: " << Serializer::encode(sent, buffer, 8) << " bytes" << std::endl;
+	std::cout << "Truncated record: " << Serializer::decode(buffer, written - 1, received) << " bytes" << std::endl;
+
+	// Test 8: Columnar batches
+	std::cout << "\n--- Test 8: Columnar batches ---" << std::endl;
+	
+	std::vector<Data> records;
+	for (int i = 0; i < 5; i++)
+		records.push_back(Data(i, std::string("Record") + static_cast<char>('A' + i), i * 1.5, i % 2 == 0));
+	std::vector<unsigned char> block(Serializer::batchSize(&records[0], records.size()));
+	size_t blockWritten = Serializer::encodeBatch(&records[0], records.size(), &block[0], block.size());
+	std::cout << "Block of " << records.size() << " records: " << blockWritten << " bytes" << std::endl;
+	
+	Serializer::Columns columns;
+	Serializer::decodeBatch(&block[0], blockWritten, columns);
+	double total = 0;
+	for (size_t i = 0; i < columns.size(); i++)
+		total += columns.values[i];
+	std::cout << "Sum of the value column: " << total << std::endl;
+	std::cout << "Record 3 rebuilt: ";
+	columns.record(3).print();
+	
+	std::stringstream stream;
+	Serializer::writeBatch(stream, &records[0], records.size(), 2);
+	Serializer::Columns streamed;
+	int blocks = 0;
+	while (Serializer::readBatch(stream, streamed))
+		blocks++;
+	bool same = streamed.size() == records.size();
+	for (size_t i = 0; same && i < streamed.size(); i++)
+		same = streamed.record(i) == records[i];
+	std::cout << "Streamed in " << blocks << " blocks, records match: " << (same ? "YES" : "NO") << std::endl;
+
+	// Test 9: Reading records in place
+	std::cout << "\n--- Test 9: Zero-copy views ---" << std::endl;
+	
+	unsigned char stream9[256];
+	size_t used = 0;
+	for (size_t i = 0; i < records.size(); i++)
+		used += Serializer::encode(records[i], stream9 + used, sizeof(stream9) - used);
+	DataView view;
+	for (size_t offset = 0; offset < used; offset += view.size())
+	{
+		if (!view.bind(stream9 + offset, used - offset))
+			break;
+		std::cout << "id " << view.id() << ", name ";
+		std::cout.write(view.name(), view.nameLength());
+		std::cout << " in place at offset " << (view.name() - reinterpret_cast<const char*>(stream9));
+		if (view.active() && view.value() > 2)
+		{
+			std::cout << ", kept: ";
+			view.materialize().print();
+		}
+		else
+			std::cout << ", skipped" << std::endl;
+	}
+
+	// Test 10: Handles instead of addresses
+	std::cout << "\n--- Test 10: Generational handles ---" << std::endl;
+	
+	DataRegistry registry;
+	DataRegistry::Handle first = registry.insert(Data(10, "Kept", 1.0, true));
+	DataRegistry::Handle second = registry.insert(Data(11, "Erased", 2.0, false));
+	std::cout << "Handles: 0x" << std::hex << first << ", 0x" << second << std::dec << std::endl;
+	registry.erase(second);
+	DataRegistry::Handle reused = registry.insert(Data(12, "Reused slot", 3.0, true));
+	std::cout << "Reused slot handle: 0x" << std::hex << reused << std::dec << std::endl;
+	std::cout << "Stale handle found: " << (registry.get(second) ? "YES" : "NO") << std::endl;
+	std::cout << "Live handles: ";
+	registry.get(first)->print();
+	std::cout << "              ";
+	registry.get(reused)->print();
+	std::cout << "Records stored: " << registry.size() << std::endl;
+
+	// Test 11: Pooled records
+	std::cout << "\n--- Test 11: Pooled allocation ---" << std::endl;
+	
+	DataPool pool;
+	std::vector<Data*> pooled;
+	for (int i = 0; i < 1000; i++)
+		pooled.push_back(pool.create(i, "Pooled", i * 0.5, true));
+	std::cout << "Records: " << pool.size() << ", chunks allocated: " << pool.chunks()
+			  << ", capacity: " << pool.capacity() << std::endl;
+	for (size_t i = 0; i < pooled.size(); i += 2)
+		pool.destroy(pooled[i]);
+	for (size_t i = 0; i < pooled.size(); i += 2)
+		pooled[i] = pool.create(static_cast<int>(i), "Reused", 0.0, false);
+	std::cout << "After replacing half: " << pool.size() << " records, chunks allocated: " << pool.chunks() << std::endl;
+	std::cout << "Record 500: ";
+	pooled[500]->print();
+	for (size_t i = 0; i < pooled.size(); i++)
+		pool.destroy(pooled[i]);
+
+	// Test 12: Framed records over a pipe
+	std::cout << "\n--- Test 12: Streaming over a pipe ---" << std::endl;
+	
+	int fds[2];
+	if (pipe(fds) == 0)
+	{
+		// Both ends non-blocking, so one process can play writer and reader
+		fcntl(fds[0], F_SETFL, fcntl(fds[0], F_GETFL) | O_NONBLOCK);
+		fcntl(fds[1], F_SETFL, fcntl(fds[1], F_GETFL) | O_NONBLOCK);
+		DataWriter writer(fds[1], 4096);
+		DataReader reader(fds[0]);
+		const int count = 50000;
+		int pushed = 0;
+		int received = 0;
+		bool blocked = false;
+		bool matches = true;
+		Data incoming;
+		while (received < count)
+		{
+			// Push until the pipe pushes back, then drain what arrived
+			while (pushed < count)
+			{
+				if (writer.push(Data(pushed, "Streamed", pushed * 0.5, pushed % 2 == 0)) != STREAM_OK)
+				{
+					blocked = true;
+					break;
+				}
+				pushed++;
+			}
+			if (pushed == count && writer.flush() == STREAM_OK && !writer.pending() && fds[1] >= 0)
+			{
+				close(fds[1]);
+				fds[1] = -1;
+			}
+			while (reader.read(incoming) == STREAM_OK)
+			{
+				matches = matches && incoming == Data(received, "Streamed", received * 0.5, received % 2 == 0);
+				received++;
+			}
+		}
+		std::cout << "Records sent: " << pushed << " in " << writer.frames() << " frames" << std::endl;
+		std::cout << "Writer held back by the pipe: " << (blocked ? "YES" : "NO") << std::endl;
+		std::cout << "Records received: " << received << " in " << reader.frames() << " frames, match: "
+				  << (matches ? "YES" : "NO") << std::endl;
+		std::cout << "Clean end of stream: " << (reader.read(incoming) == STREAM_END ? "YES" : "NO") << std::endl;
+		if (fds[1] >= 0)
+			close(fds[1]);
+		close(fds[0]);
+	}
+
 	std::cout << "\n=== ALL TESTS COMPLETED ===" << std::endl;
 	return 0;
 }
@@ -1,22 +1,107 @@
 #include "Base.hpp"
 #include <iostream>
 
+bool Base::_logging = true;
+
+Base::Base() : _kind(KIND_BASE)
+{
+}
+
+Base::Base(Kind kind) : _kind(kind)
+{
+}
+
+Base::Base(const Base& other) : _kind(KIND_BASE)
+{
+	(void)other;
+}
+
+Base& Base::operator=(const Base& other)
+{
+	(void)other;
+	return *this;
+}
+
 Base::~Base()
 {
-	std::cout << "Base destructor called" << std::endl;
+	if (_logging)
+		std::cout << "Base destructor called" << std::endl;
+}
+
+Base::Kind Base::kind() const
+{
+	return _kind;
+}
+
+void Base::setLogging(bool logging)
+{
+	_logging = logging;
+}
+
+bool Base::isLogging()
+{
+	return _logging;
+}
+
+A::A() : Base(KIND_A)
+{
+}
+
+A::A(const A& other) : Base(KIND_A)
+{
+	(void)other;
+}
+
+A& A::operator=(const A& other)
+{
+	Base::operator=(other);
+	return *this;
 }
 
 A::~A()
 {
-	std::cout << "A destructor called" << std::endl;
+	if (isLogging())
+		std::cout << "A destructor called" << std::endl;
+}
+
+B::B() : Base(KIND_B)
+{
+}
+
+B::B(const B& other) : Base(KIND_B)
+{
+	(void)other;
+}
+
+B& B::operator=(const B& other)
+{
+	Base::operator=(other);
+	return *this;
 }
 
 B::~B()
 {
-	std::cout << "B destructor called" << std::endl;
+	if (isLogging())
+		std::cout << "B destructor called" << std::endl;
+}
+
+C::C() : Base(KIND_C)
+{
+}
+
+C::C(const C& other) : Base(KIND_C)
+{
+	(void)other;
+}
+
+C& C::operator=(const C& other)
+{
+	Base::operator=(other);
+	return *this;
 }
 
 C::~C()
 {
-	std::cout << "C destructor called" << std::endl;
+	if (isLogging())
+		std::cout << "C destructor called" << std::endl;
 }
@@ -4,24 +4,62 @@
 class Base
 {
 public:
+	// The concrete class of an object, set once by its constructor, so
+	// that identifying it is one load instead of a chain of dynamic_casts
+	enum Kind
+	{
+		KIND_BASE,
+		KIND_A,
+		KIND_B,
+		KIND_C
+	};
+
+	Base();
+	Base(const Base& other);
+	Base& operator=(const Base& other);
 	virtual ~Base();
+
+	Kind	kind() const;
+
+	// Whether destructors and generate() print a line; on by default,
+	// off for load tests that make millions of objects
+	static void	setLogging(bool logging);
+	static bool	isLogging();
+
+protected:
+	explicit Base(Kind kind);
+
+private:
+	Kind		_kind;
+	static bool	_logging;
 };
 
+// Copies keep the kind of the class being built, and assignment leaves
+// it alone, so slicing an A into a Base gives a Base
 class A : public Base
 {
 public:
+	A();
+	A(const A& other);
+	A& operator=(const A& other);
 	virtual ~A();
 };
 
 class B : public Base
 {
 public:
+	B();
+	B(const B& other);
+	B& operator=(const B& other);
 	virtual ~B();
 };
 
 class C : public Base
 {
 public:
+	C();
+	C(const C& other);
+	C& operator=(const C& other);
 	virtual ~C();
 };
 
@@ -0,0 +1,108 @@
+#include "BaseVariant.hpp"
+
+BaseVariant::BaseVariant() : _kind(Base::KIND_BASE)
+{
+}
+
+BaseVariant::BaseVariant(const A& a) : _kind(Base::KIND_A)
+{
+	new (_bytes) A(a);
+}
+
+BaseVariant::BaseVariant(const B& b) : _kind(Base::KIND_B)
+{
+	new (_bytes) B(b);
+}
+
+BaseVariant::BaseVariant(const C& c) : _kind(Base::KIND_C)
+{
+	new (_bytes) C(c);
+}
+
+BaseVariant::BaseVariant(const BaseVariant& other) : _kind(Base::KIND_BASE)
+{
+	_copy(other);
+}
+
+BaseVariant& BaseVariant::operator=(const BaseVariant& other)
+{
+	if (this != &other)
+	{
+		_destroy();
+		_copy(other);
+	}
+	return *this;
+}
+
+BaseVariant::~BaseVariant()
+{
+	_destroy();
+}
+
+void BaseVariant::_destroy()
+{
+	switch (_kind)
+	{
+		case Base::KIND_A:
+			reinterpret_cast<A*>(_bytes)->A::~A();
+			break;
+		case Base::KIND_B:
+			reinterpret_cast<B*>(_bytes)->B::~B();
+			break;
+		case Base::KIND_C:
+			reinterpret_cast<C*>(_bytes)->C::~C();
+			break;
+		default:
+			break;
+	}
+	_kind = Base::KIND_BASE;
+}
+
+void BaseVariant::_copy(const BaseVariant& other)
+{
+	switch (other._kind)
+	{
+		case Base::KIND_A:
+			new (_bytes) A(*reinterpret_cast<const A*>(other._bytes));
+			break;
+		case Base::KIND_B:
+			new (_bytes) B(*reinterpret_cast<const B*>(other._bytes));
+			break;
+		case Base::KIND_C:
+			new (_bytes) C(*reinterpret_cast<const C*>(other._bytes));
+			break;
+		default:
+			break;
+	}
+	_kind = other._kind;
+}
+
+Base::Kind BaseVariant::kind() const
+{
+	return _kind;
+}
+
+bool BaseVariant::empty() const
+{
+	return _kind == Base::KIND_BASE;
+}
+
+// Through the exact class, so the Base part is found wherever the
+// compiler placed it
+Base& BaseVariant::base()
+{
+	switch (_kind)
+	{
+		case Base::KIND_A:
+			return *reinterpret_cast<A*>(_bytes);
+		case Base::KIND_B:
+			return *reinterpret_cast<B*>(_bytes);
+		default:
+			return *reinterpret_cast<C*>(_bytes);
+	}
+}
+
+const Base& BaseVariant::base() const
+{
+	return const_cast<BaseVariant*>(this)->base();
+}
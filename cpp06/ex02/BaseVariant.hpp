@@ -0,0 +1,86 @@
+#ifndef BASEVARIANT_HPP
+#define BASEVARIANT_HPP
+
+#include "Base.hpp"
+#include <new>
+
+// An A, a B or a C held by value: the closed set of classes as a tagged
+// union, so that arrays of them are contiguous and need neither new nor
+// RTTI. visit switches on the tag and calls the visitor with the exact
+// class, so the call is resolved at compile time and can be inlined.
+// A default one holds nothing, and its kind is KIND_BASE
+class BaseVariant
+{
+private:
+	static const unsigned int SIZE_AB = sizeof(A) > sizeof(B) ? sizeof(A) : sizeof(B);
+	static const unsigned int SIZE = SIZE_AB > sizeof(C) ? SIZE_AB : sizeof(C);
+	
+	Base::Kind	_kind;
+	union
+	{
+		void*	_align;	// the alignment of A, B and C: one pointer
+		char	_bytes[SIZE];
+	};
+	
+	void	_destroy();
+	void	_copy(const BaseVariant& other);
+
+public:
+	BaseVariant();
+	BaseVariant(const A& a);
+	BaseVariant(const B& b);
+	BaseVariant(const C& c);
+	BaseVariant(const BaseVariant& other);
+	BaseVariant& operator=(const BaseVariant& other);
+	~BaseVariant();
+	
+	Base::Kind	kind() const;
+	bool		empty() const;
+	
+	// The held object, for code that takes a Base; call only when not
+	// empty
+	Base&		base();
+	const Base&	base() const;
+	
+	// Call visitor(A&), visitor(B&) or visitor(C&) for the held object;
+	// nothing when empty
+	template <typename Visitor>
+	void visit(Visitor& visitor)
+	{
+		switch (_kind)
+		{
+			case Base::KIND_A:
+				visitor(*reinterpret_cast<A*>(_bytes));
+				break;
+			case Base::KIND_B:
+				visitor(*reinterpret_cast<B*>(_bytes));
+				break;
+			case Base::KIND_C:
+				visitor(*reinterpret_cast<C*>(_bytes));
+				break;
+			default:
+				break;
+		}
+	}
+	
+	template <typename Visitor>
+	void visit(Visitor& visitor) const
+	{
+		switch (_kind)
+		{
+			case Base::KIND_A:
+				visitor(*reinterpret_cast<const A*>(_bytes));
+				break;
+			case Base::KIND_B:
+				visitor(*reinterpret_cast<const B*>(_bytes));
+				break;
+			case Base::KIND_C:
+				visitor(*reinterpret_cast<const C*>(_bytes));
+				break;
+			default:
+				break;
+		}
+	}
+};
+
+#endif
@@ -2,7 +2,13 @@
 #include <iostream>
 #include <cstdlib>
 #include <ctime>
-#include <exception>
+
+static const char* const KIND_NAMES[] = {"Unknown type", "A", "B", "C"};
+
+const char* kindName(Base::Kind kind)
+{
+	return KIND_NAMES[kind];
+}
 
 Base* generate(void)
 {
@@ -19,13 +25,16 @@ Base* generate(void)
 	switch (choice)
 	{
 		case 0:
-			std::cout << "Generated: A" << std::endl;
+			if (Base::isLogging())
+				std::cout << "Generated: A" << std::endl;
 			return new A();
 		case 1:
-			std::cout << "Generated: B" << std::endl;
+			if (Base::isLogging())
+				std::cout << "Generated: B" << std::endl;
 			return new B();
 		case 2:
-			std::cout << "Generated: C" << std::endl;
+			if (Base::isLogging())
+				std::cout << "Generated: C" << std::endl;
 			return new C();
 		default:
 			return new A(); // Fallback (should never happen)
@@ -40,67 +49,14 @@ void identify(Base* p)
 		return;
 	}
 
-	// Use dynamic_cast to identify the type
-	// dynamic_cast returns NULL if the cast fails
-	
-	if (dynamic_cast<A*>(p) != NULL)
-	{
-		std::cout << "A" << std::endl;
-	}
-	else if (dynamic_cast<B*>(p) != NULL)
-	{
-		std::cout << "B" << std::endl;
-	}
-	else if (dynamic_cast<C*>(p) != NULL)
-	{
-		std::cout << "C" << std::endl;
-	}
-	else
-	{
-		std::cout << "Unknown type" << std::endl;
-	}
+	// The kind is stored in the object: one load and a table lookup
+	std::cout << kindName(p->kind()) << std::endl;
 }
 
 void identify(Base& p)
 {
 	// Cannot use pointers inside this function
-	// Use dynamic_cast with references - throws exception if cast fails
-	
-	try
-	{
-		A& a = dynamic_cast<A&>(p);
-		(void)a; // Suppress unused variable warning
-		std::cout << "A" << std::endl;
-		return;
-	}
-	catch (const std::exception& e)
-	{
-		// Cast failed, try next type
-	}
-	
-	try
-	{
-		B& b = dynamic_cast<B&>(p);
-		(void)b; // Suppress unused variable warning
-		std::cout << "B" << std::endl;
-		return;
-	}
-	catch (const std::exception& e)
-	{
-		// Cast failed, try next type
-	}
-	
-	try
-	{
-		C& c = dynamic_cast<C&>(p);
-		(void)c; // Suppress unused variable warning
-		std::cout << "C" << std::endl;
-		return;
-	}
-	catch (const std::exception& e)
-	{
-		// Cast failed, unknown type
-	}
-	
-	std::cout << "Unknown type" << std::endl;
+	// The stored kind answers without a cast, so no std::bad_cast is
+	// thrown and caught for the types that do not match
+	std::cout << kindName(p.kind()) << std::endl;
 }
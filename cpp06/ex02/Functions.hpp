@@ -8,4 +8,7 @@ Base*	generate(void);
 void	identify(Base* p);
 void	identify(Base& p);
 
+// "A", "B", "C", or "Unknown type" for a plain Base
+const char*	kindName(Base::Kind kind);
+
 #endif
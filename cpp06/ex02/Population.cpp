@@ -0,0 +1,69 @@
+#include "Population.hpp"
+
+Population::Population(size_t n, Random& random)
+{
+	std::vector<unsigned char> kinds(n);
+	size_t counts[3] = {0, 0, 0};
+	
+	for (size_t i = 0; i < n; i++)
+	{
+		kinds[i] = static_cast<unsigned char>(random.below(3));
+		counts[kinds[i]]++;
+	}
+	_a.resize(counts[0]);
+	_b.resize(counts[1]);
+	_c.resize(counts[2]);
+	
+	size_t next[3] = {0, 0, 0};
+	_objects.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		size_t k = kinds[i];
+		if (k == 0)
+			_objects[i] = &_a[next[0]++];
+		else if (k == 1)
+			_objects[i] = &_b[next[1]++];
+		else
+			_objects[i] = &_c[next[2]++];
+	}
+}
+
+Population::Population(const Population& other)
+{
+	(void)other;
+}
+
+Population& Population::operator=(const Population& other)
+{
+	(void)other;
+	return *this;
+}
+
+Population::~Population()
+{
+}
+
+size_t Population::size() const
+{
+	return _objects.size();
+}
+
+Base& Population::operator[](size_t i) const
+{
+	return *_objects[i];
+}
+
+size_t Population::count(Base::Kind kind) const
+{
+	switch (kind)
+	{
+		case Base::KIND_A:
+			return _a.size();
+		case Base::KIND_B:
+			return _b.size();
+		case Base::KIND_C:
+			return _c.size();
+		default:
+			return 0;
+	}
+}
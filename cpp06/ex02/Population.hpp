@@ -0,0 +1,36 @@
+#ifndef POPULATION_HPP
+#define POPULATION_HPP
+
+#include "Base.hpp"
+#include "Random.hpp"
+#include <vector>
+#include <cstddef>
+
+// n random objects made at once: the kinds are drawn first, then each
+// type gets one contiguous array sized to its count, so the whole batch
+// costs three allocations for the objects and one for the list of them,
+// and nothing is printed while building. The objects are reached in the
+// order they were drawn through operator[], and are destroyed with the
+// population
+class Population
+{
+private:
+	std::vector<A>		_a;
+	std::vector<B>		_b;
+	std::vector<C>		_c;
+	std::vector<Base*>	_objects;
+
+	// The objects point into the arrays: no copies
+	Population(const Population& other);
+	Population& operator=(const Population& other);
+
+public:
+	Population(size_t n, Random& random);
+	~Population();
+
+	size_t	size() const;
+	Base&	operator[](size_t i) const;
+	size_t	count(Base::Kind kind) const;
+};
+
+#endif
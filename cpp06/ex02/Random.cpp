@@ -0,0 +1,68 @@
+#include "Random.hpp"
+
+static uint32_t rotl(uint32_t x, int k)
+{
+	return (x << k) | (x >> (32 - k));
+}
+
+// The state is filled by a splitmix32 sequence from the seed, so that
+// close seeds give unrelated streams and the state is never all zero
+Random::Random(uint32_t seed)
+{
+	for (int i = 0; i < 4; i++)
+	{
+		seed += 0x9E3779B9u;
+		uint32_t z = seed;
+		z = (z ^ (z >> 16)) * 0x85EBCA6Bu;
+		z = (z ^ (z >> 13)) * 0xC2B2AE35u;
+		_state[i] = z ^ (z >> 16);
+	}
+}
+
+Random::Random(const Random& other)
+{
+	*this = other;
+}
+
+Random& Random::operator=(const Random& other)
+{
+	for (int i = 0; i < 4; i++)
+		_state[i] = other._state[i];
+	return *this;
+}
+
+Random::~Random()
+{
+}
+
+uint32_t Random::next()
+{
+	uint32_t result = rotl(_state[1] * 5, 7) * 9;
+	uint32_t t = _state[1] << 9;
+	
+	_state[2] ^= _state[0];
+	_state[3] ^= _state[1];
+	_state[1] ^= _state[2];
+	_state[0] ^= _state[3];
+	_state[2] ^= t;
+	_state[3] = rotl(_state[3], 11);
+	return result;
+}
+
+// Lemire's multiply and reject: the high half of next() * n is uniform
+// once the few low values that would favour some results are redrawn
+uint32_t Random::below(uint32_t n)
+{
+	uint64_t m = static_cast<uint64_t>(next()) * n;
+	uint32_t low = static_cast<uint32_t>(m);
+	if (low < n)
+	{
+		uint32_t threshold = (0u - n) % n;
+		while (low < threshold)
+		{
+			m = static_cast<uint64_t>(next()) * n;
+			low = static_cast<uint32_t>(m);
+		}
+	}
+	return static_cast<uint32_t>(m >> 32);
+}
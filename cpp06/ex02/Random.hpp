@@ -0,0 +1,25 @@
+#ifndef RANDOM_HPP
+#define RANDOM_HPP
+
+#include <stdint.h>
+
+// xoshiro128** generator: 16 bytes of state, a few instructions per
+// number and far better statistics than std::rand. Each user keeps a
+// generator of its own, so threads never share one
+class Random
+{
+private:
+	uint32_t	_state[4];
+
+public:
+	explicit Random(uint32_t seed = 0);
+	Random(const Random& other);
+	Random& operator=(const Random& other);
+	~Random();
+
+	uint32_t	next();
+	// Uniform in [0, n), without the bias of next() % n
+	uint32_t	below(uint32_t n);
+};
+
+#endif
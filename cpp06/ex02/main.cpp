@@ -1,9 +1,38 @@
 #include "Functions.hpp"
+#include "Population.hpp"
+#include "BaseVariant.hpp"
 #include <iostream>
 #include <vector>
 #include <cstdlib>
 #include <ctime>
 
+// Visitor for BaseVariant: one overload per class, chosen at compile time
+struct KindCounter
+{
+	size_t a;
+	size_t b;
+	size_t c;
+
+	KindCounter() : a(0), b(0), c(0)
+	{
+	}
+
+	void operator()(const A&)
+	{
+		a++;
+	}
+
+	void operator()(const B&)
+	{
+		b++;
+	}
+
+	void operator()(const C&)
+	{
+		c++;
+	}
+};
+
 int main()
 {
 	std::cout << "=== TYPE IDENTIFICATION TESTS ===" << std::endl;
@@ -135,10 +164,21 @@ int main()
 	{
 		Base* obj = generate();
 		
-		// Count types (using pointer version for efficiency)
-		if (dynamic_cast<A*>(obj) != NULL) countA++;
-		else if (dynamic_cast<B*>(obj) != NULL) countB++;
-		else if (dynamic_cast<C*>(obj) != NULL) countC++;
+		// Count types by their stored kind, without any cast
+		switch (obj->kind())
+		{
+			case Base::KIND_A:
+				countA++;
+				break;
+			case Base::KIND_B:
+				countB++;
+				break;
+			case Base::KIND_C:
+				countC++;
+				break;
+			default:
+				break;
+		}
 		
 		delete obj;
 	}
@@ -147,8 +187,54 @@ int main()
 			  << ", B: " << countB 
 			  << ", C: " << countC << std::endl;
 	
-	// Test 7: Base class direct instantiation (not allowed)
-	std::cout << "\n--- Test 7: Base class behavior ---" << std::endl;
+	// Test 7: Batch generation
+	std::cout << "\n--- Test 7: Batch generation ---" << std::endl;
+	
+	Base::setLogging(false);
+	{
+		Random random(static_cast<uint32_t>(std::time(NULL)));
+		Population population(1000000, random);
+		std::cout << "Generated " << population.size() << " objects in three arrays" << std::endl;
+		std::cout << "Distribution - A: " << population.count(Base::KIND_A)
+				  << ", B: " << population.count(Base::KIND_B)
+				  << ", C: " << population.count(Base::KIND_C) << std::endl;
+		std::cout << "First five: ";
+		for (size_t i = 0; i < 5; i++)
+			std::cout << kindName(population[i].kind()) << " ";
+		std::cout << std::endl;
+	}
+	Base::setLogging(true);
+	
+	// Test 8: Objects by value
+	std::cout << "\n--- Test 8: Tagged union values ---" << std::endl;
+	
+	Base::setLogging(false);
+	{
+		Random random(42);
+		std::vector<BaseVariant> values;
+		values.reserve(300000);
+		for (int i = 0; i < 300000; i++)
+		{
+			uint32_t k = random.below(3);
+			if (k == 0)
+				values.push_back(A());
+			else if (k == 1)
+				values.push_back(B());
+			else
+				values.push_back(C());
+		}
+		KindCounter counter;
+		for (size_t i = 0; i < values.size(); i++)
+			values[i].visit(counter);
+		std::cout << "sizeof(BaseVariant): " << sizeof(BaseVariant) << " bytes, in one array" << std::endl;
+		std::cout << "Distribution - A: " << counter.a << ", B: " << counter.b << ", C: " << counter.c << std::endl;
+		std::cout << "Identify value 0 by reference: ";
+		identify(values[0].base());
+	}
+	Base::setLogging(true);
+	
+	// Test 9: Base class direct instantiation (not allowed)
+	std::cout << "\n--- Test 9: Base class behavior ---" << std::endl;
 	std::cout << "Note: Base class has virtual destructor, so it's polymorphic" << std::endl;
 	std::cout << "Base class cannot be instantiated directly (has virtual destructor)" << std::endl;
 
@@ -18,5 +18,17 @@ int main(void)
 	std::cout << "min( c, d ) = " << ::min(c, d) << std::endl;
 	std::cout << "max( c, d ) = " << ::max(c, d) << std::endl;
 	
+	// Test equal values: the second one is returned
+	int e = 5;
+	int f = 5;
+	std::cout << "min( e, f ) is f: " << (&::min(e, f) == &f) << ", max( e, f ) is f: " << (&::max(e, f) == &f)
+	          << std::endl;
+	
+	// Test range reductions
+	int values[] = {4, 1, 7, 1, 9, 7, 3};
+	const int *end = values + sizeof(values) / sizeof(values[0]);
+	std::cout << "min_of = " << *::min_of(values, end) << " at " << ::min_of(values, end) - values
+	          << ", max_of = " << *::max_of(values, end) << " at " << ::max_of(values, end) - values << std::endl;
+	
 	return 0;
 }
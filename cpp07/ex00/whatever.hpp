@@ -1,29 +1,134 @@
 #ifndef WHATEVER_HPP
 #define WHATEVER_HPP
 
+#include <cstddef>
+#include <utility>
+
+// Whether T has a member void swap(T &), as std::string, the standard
+// containers and Array do: taking its address only compiles when it
+// exists, and a failed substitution falls back to the other test
+template <typename T>
+struct HasMemberSwap
+{
+	template <typename U, void (U::*)(U &)>
+	struct Check
+	{
+	};
+	
+	template <typename U>
+	static char test(Check<U, &U::swap> *);
+	
+	template <typename U>
+	static long test(...);
+	
+	static const bool value = sizeof(test<T>(0)) == sizeof(char);
+};
+
+template <bool Member>
+struct SwapWith
+{
+	template <typename T>
+	static void apply(T &a, T &b)
+	{
+		T temp = a;
+		a = b;
+		b = temp;
+	}
+};
+
+template <>
+struct SwapWith<true>
+{
+	template <typename T>
+	static void apply(T &a, T &b)
+	{
+		a.swap(b);
+	}
+};
+
 // swap: Swaps the values of two given parameters
+// A type with its own swap exchanges its internals, such as the buffer
+// pointers of a string, instead of being copied three times
 template <typename T>
 void swap(T &a, T &b)
 {
-	T temp = a;
-	a = b;
-	b = temp;
+	SwapWith<HasMemberSwap<T>::value>::apply(a, b);
 }
 
 // min: Returns the smallest of two values
 // If equal, returns the second one
+// Arguments and result are references, so nothing is copied
 template <typename T>
-T min(T a, T b)
+const T &min(const T &a, const T &b)
 {
-	return (b < a) ? b : a;
+	return (a < b) ? a : b;
 }
 
 // max: Returns the greatest of two values
 // If equal, returns the second one
 template <typename T>
-T max(T a, T b)
+const T &max(const T &a, const T &b)
+{
+	return (a > b) ? a : b;
+}
+
+// min_of: Points to the smallest value of [first, last), or is last when
+// the range is empty
+// If several are equal, points to the last of them, as min does
+// The minimum is found with four independent running minimums, a loop
+// the compiler vectorizes for arithmetic types; NaNs are not supported
+template <typename T>
+const T *min_of(const T *first, const T *last)
+{
+	if (first == last)
+		return last;
+	size_t n = last - first;
+	T m[4] = {first[0], first[0], first[0], first[0]};
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		for (int k = 0; k < 4; k++)
+			m[k] = first[i + k] < m[k] ? first[i + k] : m[k];
+	}
+	for (; i < n; i++)
+		m[0] = first[i] < m[0] ? first[i] : m[0];
+	const T &lo = ::min(::min(m[0], m[1]), ::min(m[2], m[3]));
+	const T *p = last;
+	while (*--p < lo || lo < *p)
+		;
+	return p;
+}
+
+// max_of: Points to the greatest value of [first, last), or is last when
+// the range is empty
+// If several are equal, points to the last of them, as max does
+template <typename T>
+const T *max_of(const T *first, const T *last)
+{
+	if (first == last)
+		return last;
+	size_t n = last - first;
+	T m[4] = {first[0], first[0], first[0], first[0]};
+	size_t i = 0;
+	for (; i + 4 <= n; i += 4)
+	{
+		for (int k = 0; k < 4; k++)
+			m[k] = first[i + k] > m[k] ? first[i + k] : m[k];
+	}
+	for (; i < n; i++)
+		m[0] = first[i] > m[0] ? first[i] : m[0];
+	const T &hi = ::max(::max(m[0], m[1]), ::max(m[2], m[3]));
+	const T *p = last;
+	while (*--p < hi || hi < *p)
+		;
+	return p;
+}
+
+// minmax_of: Both, as (min_of, max_of)
+template <typename T>
+std::pair<const T *, const T *> minmax_of(const T *first, const T *last)
 {
-	return (b > a) ? b : a;
+	return std::make_pair(::min_of(first, last), ::max_of(first, last));
 }
 
 #endif
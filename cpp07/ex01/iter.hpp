@@ -2,16 +2,354 @@
 #define ITER_HPP
 
 #include <iostream>
+#include <cstddef>
+#include <vector>
+#include "ThreadPool.hpp"
 
 // iter: Function template that applies a function to each element of an array
 // Supports both const and non-const function pointers/references
-template <typename T, typename F>
-void iter(T *array, int length, F function)
+// The length may be any integer type: a size_t length reaches arrays past
+// 2^31 elements, and the index counts in the same type so it cannot wrap
+template <typename T, typename Length, typename F>
+void iter(T *array, Length length, F function)
 {
-	for (int i = 0; i < length; i++)
+	for (Length i = 0; i < length; i++)
 	{
 		function(array[i]);
 	}
 }
 
+// Calls for Count consecutive elements, written out at compile time
+template <size_t Count>
+struct IterUnrolled
+{
+	template <typename T, typename F>
+	static void apply(T *array, F &function)
+	{
+		function(array[0]);
+		IterUnrolled<Count - 1>::apply(array + 1, function);
+	}
+};
+
+template <>
+struct IterUnrolled<0>
+{
+	template <typename T, typename F>
+	static void apply(T *, F &)
+	{
+	}
+};
+
+// iter for a C array whose length N is known at compile time: the calls
+// are unrolled in groups of 8 and the remainder is written out, so a
+// small array needs no loop at all and an inlined function leaves a
+// straight run of code
+template <typename T, size_t N, typename F>
+void iter(T (&array)[N], F function)
+{
+	const size_t GROUP = 8;
+	for (size_t i = 0; i + GROUP <= N; i += GROUP)
+	{
+		IterUnrolled<GROUP>::apply(array + i, function);
+	}
+	IterUnrolled<N % GROUP>::apply(array + N - N % GROUP, function);
+}
+
+// iterBlocks: like iter, but function is called with (pointer, count)
+// for consecutive blocks of up to blockSize elements, so it can run its
+// own loop over a block, which the compiler can vectorize, instead of
+// being called once per element. Every block is full except possibly the
+// last, which holds the remainder
+template <typename T, typename Length, typename F>
+void iterBlocks(T *array, Length length, F function, size_t blockSize = 256)
+{
+	if (blockSize == 0)
+		blockSize = 1;
+	for (Length i = 0; i < length; )
+	{
+		size_t remaining = length - i;
+		size_t count = remaining < blockSize ? remaining : blockSize;
+		function(array + i, count);
+		i += count;
+	}
+}
+
+// iterZip: iter over parallel arrays (structure-of-arrays columns) in
+// lockstep: function gets the i-th element of each. The columns may have
+// different types; each is indexed directly, so an inlined function
+// vectorizes as well as a loop written by hand. Two to four columns
+template <typename A, typename B, typename Length, typename F>
+void iterZip(A *a, B *b, Length length, F function)
+{
+	for (Length i = 0; i < length; i++)
+	{
+		function(a[i], b[i]);
+	}
+}
+
+template <typename A, typename B, typename C, typename Length, typename F>
+void iterZip(A *a, B *b, C *c, Length length, F function)
+{
+	for (Length i = 0; i < length; i++)
+	{
+		function(a[i], b[i], c[i]);
+	}
+}
+
+template <typename A, typename B, typename C, typename D, typename Length, typename F>
+void iterZip(A *a, B *b, C *c, D *d, Length length, F function)
+{
+	for (Length i = 0; i < length; i++)
+	{
+		function(a[i], b[i], c[i], d[i]);
+	}
+}
+
+// Selects the parallel iter: iter(bigArray, length, function, ParallelIter())
+// applies function on the threads of ThreadPool::shared()
+struct ParallelIter
+{
+};
+
+// Elements per parallel piece: about 256KiB of them, so a piece fits in the
+// cache of the core that runs it; an array of one piece or less stays on
+// the calling thread
+template <typename T>
+size_t iterGrain(void)
+{
+	const size_t CACHE_BYTES = 256 * 1024;
+	return sizeof(T) < CACHE_BYTES ? CACHE_BYTES / sizeof(T) : 1;
+}
+
+// Body of the parallel iter. Each piece calls its own copy of function,
+// so a function object with state is never shared between threads
+template <typename T, typename F>
+struct IterParallelJob
+{
+	T *array;
+	const F *function;
+	
+	void operator()(size_t first, size_t last) const
+	{
+		F call = *function;
+		for (size_t i = first; i < last; i++)
+		{
+			call(array[i]);
+		}
+	}
+};
+
+// iter on the thread pool: the elements are split into pieces of
+// iterGrain<T>() and the pieces run in parallel, in no particular order.
+// function must be safe to call from several threads at once on
+// different elements
+template <typename T, typename F>
+void iter(T *array, size_t length, F function, ParallelIter)
+{
+	size_t grain = iterGrain<T>();
+	if (length <= grain)
+	{
+		iter(array, length, function);
+		return;
+	}
+	IterParallelJob<T, F> job;
+	job.array = array;
+	job.function = &function;
+	ThreadPool::shared().parallelFor(0, length, grain, job);
+}
+
+// An iter that runs a piece at a time: each step() applies function to
+// the next elements and returns, so a caller can interleave the transform
+// with reading its next input instead of blocking on the whole array.
+// wait() finishes what is left. The array must outlive the task. IterAsync
+// below runs on the thread pool instead
+template <typename T, typename F>
+class IterTask
+{
+	private:
+		T *_array;
+		size_t _length;
+		size_t _done;
+		F _function;
+		
+	public:
+		// Constructor
+		IterTask(T *array, size_t length, F function) : _array(array), _length(length), _done(0),
+			_function(function)
+		{
+		}
+		
+		// Copy constructor
+		IterTask(const IterTask &other) : _array(other._array), _length(other._length), _done(other._done),
+			_function(other._function)
+		{
+		}
+		
+		// Assignment operator
+		IterTask &operator=(const IterTask &other)
+		{
+			_array = other._array;
+			_length = other._length;
+			_done = other._done;
+			_function = other._function;
+			return *this;
+		}
+		
+		// Destructor
+		~IterTask(void)
+		{
+		}
+		
+		// Apply function to up to count more elements; false once all are
+		// done
+		bool step(size_t count = 65536)
+		{
+			size_t stop = _length - _done < count ? _length : _done + count;
+			for (; _done < stop; _done++)
+			{
+				_function(_array[_done]);
+			}
+			return _done < _length;
+		}
+		
+		// Run to the end
+		void wait(void)
+		{
+			step(_length - _done);
+		}
+		
+		bool done(void) const
+		{
+			return _done == _length;
+		}
+		
+		// Elements processed so far, and as a fraction of the array
+		size_t completed(void) const
+		{
+			return _done;
+		}
+		
+		double progress(void) const
+		{
+			return _length ? static_cast<double>(_done) / _length : 1.0;
+		}
+		
+		// The function, with any state it gathered
+		const F &function(void) const
+		{
+			return _function;
+		}
+};
+
+// Start an IterTask over array; nothing runs until the first step()
+template <typename T, typename F>
+IterTask<T, F> iterTask(T *array, size_t length, F function)
+{
+	return IterTask<T, F>(array, length, function);
+}
+
+// iter in the background: the constructor submits the array to
+// ThreadPool::shared() in pieces of iterGrain<T>() and returns at once,
+// and the object is the handle. completed() and progress() count the
+// elements done so far, wait() blocks until all are, running queued
+// pieces meanwhile, and the destructor waits too. Each piece calls its
+// own copy of function, which must be safe to call from several threads.
+// The array must outlive the handle
+template <typename T, typename F>
+class IterAsync
+{
+	private:
+		// Elements a piece applies function to between progress updates
+		static const size_t STEP = 4096;
+		
+		class _Piece : public ThreadPool::Task
+		{
+			private:
+				IterAsync *_owner;
+				size_t _begin;
+				size_t _end;
+				
+			public:
+				_Piece(void) : _owner(NULL), _begin(0), _end(0)
+				{
+				}
+				
+				void set(IterAsync &owner, size_t begin, size_t end)
+				{
+					_owner = &owner;
+					_begin = begin;
+					_end = end;
+				}
+				
+				void run(void)
+				{
+					F call = _owner->_function;
+					for (size_t start = _begin; start < _end; )
+					{
+						size_t stop = _end - start < STEP ? _end : start + STEP;
+						for (size_t i = start; i < stop; i++)
+						{
+							call(_owner->_array[i]);
+						}
+						__sync_fetch_and_add(&_owner->_done, stop - start);
+						start = stop;
+					}
+				}
+		};
+		
+		T *_array;
+		size_t _length;
+		F _function;
+		volatile size_t _done;
+		std::vector<_Piece> _pieces;
+		ThreadPool::TaskGroup _group;
+		
+		// A handle owns running work: no copies
+		IterAsync(const IterAsync &other);
+		IterAsync &operator=(const IterAsync &other);
+		
+	public:
+		// Constructor: starts the work
+		IterAsync(T *array, size_t length, F function) : _array(array), _length(length), _function(function),
+			_done(0)
+		{
+			size_t grain = iterGrain<T>();
+			_pieces.resize(length ? (length - 1) / grain + 1 : 0);
+			for (size_t i = 0; i < _pieces.size(); i++)
+			{
+				size_t first = i * grain;
+				_pieces[i].set(*this, first, length - first < grain ? length : first + grain);
+				_group.run(_pieces[i]);
+			}
+		}
+		
+		// Destructor (waits for the pieces still running)
+		~IterAsync(void)
+		{
+			wait();
+		}
+		
+		// Return once every element is done
+		void wait(void)
+		{
+			_group.wait();
+		}
+		
+		bool done(void) const
+		{
+			return completed() == _length;
+		}
+		
+		// Elements processed so far, and as a fraction of the array
+		size_t completed(void) const
+		{
+			return __sync_fetch_and_add(const_cast<volatile size_t *>(&_done), 0);
+		}
+		
+		double progress(void) const
+		{
+			return _length ? static_cast<double>(completed()) / _length : 1.0;
+		}
+};
+
 #endif
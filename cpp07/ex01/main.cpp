@@ -1,4 +1,5 @@
 #include <iostream>
+#include <vector>
 #include "iter.hpp"
 
 // Test function for integers (non-const)
@@ -19,6 +20,42 @@ void incrementInt(int &value)
 	value++;
 }
 
+// Test block function: scales a whole block in one loop
+void doubleBlock(int *values, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		values[i] *= 2;
+}
+
+// Test function object: counts the elements equal to value
+struct CountValue
+{
+	int value;
+	size_t *count;
+	
+	CountValue(int v, size_t &c) : value(v), count(&c)
+	{
+	}
+	
+	void operator()(const int &element) const
+	{
+		if (element == value)
+			(*count)++;
+	}
+};
+
+// Test function for doubles (const)
+void printDouble(const double &value)
+{
+	std::cout << value << " ";
+}
+
+// Test zip function: one record spread over three columns
+void totalPrice(const int &quantity, const double &price, double &total)
+{
+	total = quantity * price;
+}
+
 // Test function for strings (const)
 void printString(const std::string &str)
 {
@@ -51,5 +88,59 @@ int main(void)
 	::iter(doubleArray, 3, printConstInt);
 	std::cout << std::endl;
 	
+	// Test with a size_t length
+	int bigArray[1000] = {0};
+	::iter(bigArray, sizeof(bigArray) / sizeof(bigArray[0]), incrementInt);
+	std::cout << "size_t length: last element " << bigArray[999] << std::endl;
+	
+	// Test with the length taken from the array type
+	std::cout << "Compile-time length: ";
+	::iter(intArray, printConstInt);
+	::iter(bigArray, incrementInt);
+	std::cout << "(last element now " << bigArray[999] << ")" << std::endl;
+	
+	// Test with blocks of elements
+	::iterBlocks(bigArray, 1000, doubleBlock, 64);
+	std::cout << "Blocks: first " << bigArray[0] << ", last " << bigArray[999] << std::endl;
+	
+	// Test the parallel iter on an array of many pieces
+	std::vector<int> many(1000000, 1);
+	::iter(&many[0], many.size(), incrementInt, ParallelIter());
+	size_t twos = 0;
+	::iter(&many[0], many.size(), CountValue(2, twos));
+	std::cout << "Parallel: " << twos << " of " << many.size() << " incremented" << std::endl;
+	::iter(intArray, 5, incrementInt, ParallelIter());
+	std::cout << "Parallel (small, serial): ";
+	::iter(intArray, 5, printConstInt);
+	std::cout << std::endl;
+	
+	// Test a transform run a step at a time, with other work in between
+	IterTask<int, void (*)(int &)> task = ::iterTask(bigArray, 1000, incrementInt);
+	int steps = 0;
+	while (task.step(300))
+		steps++;
+	std::cout << "Task: " << steps + 1 << " steps, progress " << task.progress() << ", last " << bigArray[999]
+	          << std::endl;
+	
+	// Test a transform in the background, polled until it finishes
+	{
+		IterAsync<int, void (*)(int &)> async(&many[0], many.size(), incrementInt);
+		double seen = async.progress();
+		async.wait();
+		twos = 0;
+		::iter(&many[0], many.size(), CountValue(3, twos));
+		std::cout << "Async: " << (seen <= 1.0 ? "progress in range" : "bad progress") << ", done "
+		          << async.done() << ", " << twos << " of " << many.size() << " incremented" << std::endl;
+	}
+	
+	// Test with parallel columns
+	int quantities[] = {1, 2, 3};
+	double prices[] = {1.5, 2.5, 10.0};
+	double totals[3];
+	::iterZip(quantities, prices, totals, 3, totalPrice);
+	std::cout << "Zipped totals: ";
+	::iter(totals, 3, printDouble);
+	std::cout << std::endl;
+	
 	return 0;
 }
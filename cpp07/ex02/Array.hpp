@@ -3,61 +3,265 @@
 
 #include <stdexcept>
 #include <iostream>
+#include <new>
+#include <cstring>
+#include "ArrayAllocation.hpp"
 
+// Whether a T can be moved to new storage by copying its bytes, with no
+// copy constructor or destructor run: true for built-in types and
+// pointers. Specialize it for plain structs to have them relocated as
+// fast
 template <typename T>
+struct ArrayRelocation
+{
+	static const bool bitwise = false;
+};
+
+template <typename T>
+struct ArrayRelocation<T *>
+{
+	static const bool bitwise = true;
+};
+
+#define ARRAY_BITWISE_RELOCATION(T) \
+	template <> \
+	struct ArrayRelocation<T> \
+	{ \
+		static const bool bitwise = true; \
+	};
+
+ARRAY_BITWISE_RELOCATION(bool)
+ARRAY_BITWISE_RELOCATION(char)
+ARRAY_BITWISE_RELOCATION(signed char)
+ARRAY_BITWISE_RELOCATION(unsigned char)
+ARRAY_BITWISE_RELOCATION(short)
+ARRAY_BITWISE_RELOCATION(unsigned short)
+ARRAY_BITWISE_RELOCATION(int)
+ARRAY_BITWISE_RELOCATION(unsigned int)
+ARRAY_BITWISE_RELOCATION(long)
+ARRAY_BITWISE_RELOCATION(unsigned long)
+ARRAY_BITWISE_RELOCATION(long long)
+ARRAY_BITWISE_RELOCATION(unsigned long long)
+ARRAY_BITWISE_RELOCATION(float)
+ARRAY_BITWISE_RELOCATION(double)
+ARRAY_BITWISE_RELOCATION(long double)
+
+#undef ARRAY_BITWISE_RELOCATION
+
+// Array of T. It can be sized once at construction, or grown like
+// std::vector with reserve, resize and push_back. Storage comes from Alloc (see ArrayAllocation.hpp):
+// Array<float, AlignedAllocation<64> > for SIMD loads, or
+// Array<double, HugePageAllocation> for very large arrays
+template <typename T, typename Alloc = NewAllocation>
 class Array
 {
 	private:
 		T *_data;
 		unsigned int _size;
+		unsigned int _capacity;
+
+		// Raw storage for n elements; nothing is constructed yet
+		static T *_allocate(unsigned int n)
+		{
+			return n > 0 ? static_cast<T *>(Alloc::allocate(n * sizeof(T))) : NULL;
+		}
+
+		// Destroy n built elements of storage for capacity and free it
+		static void _release(T *data, unsigned int n, unsigned int capacity)
+		{
+			for (unsigned int i = n; i > 0; i--)
+				data[i - 1].~T();
+			if (data)
+				Alloc::deallocate(data, capacity * sizeof(T));
+		}
+
+		// Build n elements at data, copies of source when it is not NULL,
+		// otherwise value-initialized, or default-initialized when
+		// uninitialized is set; if one throws, the ones already built are
+		// destroyed and the storage is freed
+		static void _construct(T *data, unsigned int n, const T *source, bool uninitialized = false)
+		{
+			unsigned int i = 0;
+			try
+			{
+				for (; i < n; i++)
+				{
+					if (source)
+						new (data + i) T(source[i]);
+					else if (uninitialized)
+						new (data + i) T;
+					else
+						new (data + i) T();
+				}
+			}
+			catch (...)
+			{
+				_release(data, i, n);
+				throw;
+			}
+		}
+
+		// Move n elements from one block to another, leaving from as raw
+		// storage: a byte copy where that is enough, otherwise copies and
+		// then destruction of the originals. If a copy throws, the copies
+		// made are destroyed and from is left as it was
+		static void _relocate(T *to, T *from, unsigned int n)
+		{
+			if (ArrayRelocation<T>::bitwise)
+			{
+				if (n > 0)
+					std::memcpy(static_cast<void *>(to), static_cast<const void *>(from), n * sizeof(T));
+				return;
+			}
+			unsigned int i = 0;
+			try
+			{
+				for (; i < n; i++)
+					new (to + i) T(from[i]);
+			}
+			catch (...)
+			{
+				while (i > 0)
+					to[--i].~T();
+				throw;
+			}
+			for (i = n; i > 0; i--)
+				from[i - 1].~T();
+		}
+
+		// Make room for at least minimum elements, doubling the capacity so
+		// n push_backs cost O(n) copies in total
+		void _grow(unsigned int minimum)
+		{
+			unsigned int doubled = _capacity > ~0u / 2 ? ~0u : _capacity * 2;
+			reserve(minimum > doubled ? minimum : doubled);
+		}
 
 	public:
 		// Constructor with no parameter: Creates an empty array
-		Array(void) : _data(NULL), _size(0)
+		Array(void) : _data(NULL), _size(0), _capacity(0)
 		{
 		}
 
 		// Constructor with unsigned int n: Creates an array of n elements
-		Array(unsigned int n) : _data(NULL), _size(n)
+		Array(unsigned int n) : _data(_allocate(n)), _size(n), _capacity(n)
 		{
-			if (n > 0)
-				_data = new T[n]();
+			_construct(_data, n, NULL);
 		}
 
-		// Copy constructor
-		Array(const Array &other) : _data(NULL), _size(other._size)
+		// Constructor for n elements that are about to be overwritten: no
+		// zeros are written for built-in types (see Uninitialized)
+		Array(unsigned int n, Uninitialized) : _data(_allocate(n)), _size(n), _capacity(n)
 		{
-			if (_size > 0)
-			{
-				_data = new T[_size]();
-				for (unsigned int i = 0; i < _size; i++)
-					_data[i] = other._data[i];
-			}
+			_construct(_data, n, NULL, true);
+		}
+
+		// Copy constructor: each element is copy-constructed in place from
+		// the source, not default-built and then assigned
+		Array(const Array &other) : _data(_allocate(other._size)), _size(other._size), _capacity(other._size)
+		{
+			_construct(_data, _size, other._data);
 		}
 
-		// Assignment operator
+		// Assignment operator: copy, then swap, so a throwing element copy
+		// leaves this array as it was
 		Array &operator=(const Array &other)
 		{
 			if (this != &other)
 			{
-				delete[] _data;
-				_size = other._size;
-				if (_size > 0)
-				{
-					_data = new T[_size]();
-					for (unsigned int i = 0; i < _size; i++)
-						_data[i] = other._data[i];
-				}
-				else
-					_data = NULL;
+				Array copy(other);
+				swap(copy);
 			}
 			return *this;
 		}
 
+		// Exchange contents in O(1) without copying any element. This is
+		// the move of C++98: a result is moved into an existing array with
+		// a.swap(result), and arrays returned by value are elided
+		void swap(Array &other)
+		{
+			T *data = _data;
+			unsigned int size = _size;
+			unsigned int capacity = _capacity;
+			_data = other._data;
+			_size = other._size;
+			_capacity = other._capacity;
+			other._data = data;
+			other._size = size;
+			other._capacity = capacity;
+		}
+
 		// Destructor
 		~Array(void)
 		{
-			delete[] _data;
+			_release(_data, _size, _capacity);
+		}
+
+		// Make room for capacity elements, so that growing up to it moves
+		// nothing; strong guarantee
+		void reserve(unsigned int capacity)
+		{
+			if (capacity <= _capacity)
+				return;
+			T *block = _allocate(capacity);
+			try
+			{
+				_relocate(block, _data, _size);
+			}
+			catch (...)
+			{
+				Alloc::deallocate(block, capacity * sizeof(T));
+				throw;
+			}
+			if (_data)
+				Alloc::deallocate(_data, _capacity * sizeof(T));
+			_data = block;
+			_capacity = capacity;
+		}
+
+		// Resize to n elements: new ones are copies of value, and shrinking
+		// destroys the tail in place, keeping the storage for regrowth
+		void resize(unsigned int n, const T &value = T())
+		{
+			while (_size > n)
+				_data[--_size].~T();
+			if (n <= _size)
+				return;
+			if (n > _capacity)
+			{
+				// value may live in this array, so copy it before moving
+				T copy(value);
+				_grow(n);
+				while (_size < n)
+				{
+					new (_data + _size) T(copy);
+					_size++;
+				}
+				return;
+			}
+			while (_size < n)
+			{
+				new (_data + _size) T(value);
+				_size++;
+			}
+		}
+
+		void push_back(const T &value)
+		{
+			if (_size == _capacity)
+			{
+				T copy(value);
+				_grow(_size + 1);
+				new (_data + _size) T(copy);
+			}
+			else
+				new (_data + _size) T(value);
+			_size++;
+		}
+
+		void pop_back(void)
+		{
+			_data[--_size].~T();
 		}
 
 		// Subscript operator with bounds checking
@@ -76,11 +280,60 @@ class Array
 			return _data[index];
 		}
 
+		// Unchecked access for loops and std algorithms: the elements are
+		// contiguous, so iterators are plain pointers that the compiler can
+		// vectorize over; operator[] stays the checked way in
+		typedef T *iterator;
+		typedef const T *const_iterator;
+
+		T *data(void)
+		{
+			return _data;
+		}
+
+		const T *data(void) const
+		{
+			return _data;
+		}
+
+		iterator begin(void)
+		{
+			return _data;
+		}
+
+		iterator end(void)
+		{
+			return _data + _size;
+		}
+
+		const_iterator begin(void) const
+		{
+			return _data;
+		}
+
+		const_iterator end(void) const
+		{
+			return _data + _size;
+		}
+
 		// Member function to get the size
 		unsigned int size(void) const
 		{
 			return _size;
 		}
+
+		// Elements there is storage for without moving
+		unsigned int capacity(void) const
+		{
+			return _capacity;
+		}
 };
 
+// Found by unqualified swap(a, b) calls, so generic code swaps in O(1)
+template <typename T, typename Alloc>
+void swap(Array<T, Alloc> &a, Array<T, Alloc> &b)
+{
+	a.swap(b);
+}
+
 #endif
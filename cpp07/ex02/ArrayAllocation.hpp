@@ -0,0 +1,81 @@
+#ifndef ARRAYALLOCATION_HPP
+#define ARRAYALLOCATION_HPP
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+
+// Allocation policies for Array: where its storage comes from. A policy
+// has static allocate(bytes), which returns raw memory or throws
+// std::bad_alloc, and deallocate(p, bytes), which gets back what allocate
+// gave. Array<T, Policy> holds no policy object, so none adds to its size
+
+// The default: ::operator new, aligned for any fundamental type
+struct NewAllocation
+{
+	static void *allocate(size_t bytes)
+	{
+		return ::operator new(bytes);
+	}
+
+	static void deallocate(void *p, size_t)
+	{
+		::operator delete(p);
+	}
+};
+
+// Storage aligned to Alignment bytes, a power of two that is a multiple
+// of sizeof(void *): 64 puts element 0 at the start of a cache line, as
+// aligned vector loads want
+template <size_t Alignment>
+struct AlignedAllocation
+{
+	static void *allocate(size_t bytes)
+	{
+		void *p = NULL;
+		if (posix_memalign(&p, Alignment, bytes ? bytes : 1) != 0)
+			throw std::bad_alloc();
+		return p;
+	}
+
+	static void deallocate(void *p, size_t)
+	{
+		free(p);
+	}
+};
+
+// For arrays of many megabytes: storage aligned to a 2 MiB huge page and,
+// where the system has transparent huge pages, marked for them, so the
+// array takes a fraction of the TLB entries. Pages are only touched when
+// the elements are built
+struct HugePageAllocation
+{
+	static const size_t PAGE = 2 * 1024 * 1024;
+
+	static void *allocate(size_t bytes)
+	{
+		void *p = AlignedAllocation<PAGE>::allocate(bytes);
+#ifdef MADV_HUGEPAGE
+		if (bytes >= PAGE)
+			madvise(p, bytes - bytes % PAGE, MADV_HUGEPAGE);
+#endif
+		return p;
+	}
+
+	static void deallocate(void *p, size_t bytes)
+	{
+		AlignedAllocation<PAGE>::deallocate(p, bytes);
+	}
+};
+
+// Tag for Array(n, Uninitialized()): elements are default-initialized
+// instead of value-initialized. Class types still run their default
+// constructor, but built-in types such as int or double are left as they
+// are, so no zero gets written and untouched pages stay unmapped. The
+// caller must write every element before reading it
+struct Uninitialized
+{
+};
+
+#endif
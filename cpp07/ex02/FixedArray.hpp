@@ -0,0 +1,129 @@
+#ifndef FIXEDARRAY_HPP
+#define FIXEDARRAY_HPP
+
+#include <stdexcept>
+#include <algorithm>
+#include "ArrayAllocation.hpp"
+
+// Array of exactly N elements of T, stored inline: no allocation, so a
+// FixedArray on the stack costs no more than a T[N] and short-lived
+// 4- to 16-element arrays in a loop never reach the heap. The size is a
+// compile-time constant, FixedArray<T, N>::SIZE, so it can size other
+// arrays or unroll loops; size() returns the same for code written
+// against Array. It cannot grow, and copying or swapping is O(N)
+template <typename T, unsigned int N>
+class FixedArray
+{
+	private:
+		// N must be at least 1: a zero-length member array is ill-formed
+		typedef char _nonEmpty[N > 0 ? 1 : -1];
+
+		T _data[N];
+
+	public:
+		static const unsigned int SIZE = N;
+
+		// Constructor: Creates N value-initialized elements
+		FixedArray(void) : _data()
+		{
+		}
+
+		// Constructor for elements that are about to be overwritten: no
+		// zeros are written for built-in types (see Uninitialized)
+		FixedArray(Uninitialized)
+		{
+		}
+
+		// Copy constructor
+		FixedArray(const FixedArray &other)
+		{
+			std::copy(other._data, other._data + N, _data);
+		}
+
+		// Assignment operator
+		FixedArray &operator=(const FixedArray &other)
+		{
+			if (this != &other)
+				std::copy(other._data, other._data + N, _data);
+			return *this;
+		}
+
+		// Exchange contents element by element
+		void swap(FixedArray &other)
+		{
+			std::swap_ranges(_data, _data + N, other._data);
+		}
+
+		// Destructor
+		~FixedArray(void)
+		{
+		}
+
+		// Subscript operator with bounds checking
+		T &operator[](unsigned int index)
+		{
+			if (index >= N)
+				throw std::out_of_range("Index out of bounds");
+			return _data[index];
+		}
+
+		// Const subscript operator with bounds checking
+		const T &operator[](unsigned int index) const
+		{
+			if (index >= N)
+				throw std::out_of_range("Index out of bounds");
+			return _data[index];
+		}
+
+		// Unchecked access, as in Array
+		typedef T *iterator;
+		typedef const T *const_iterator;
+
+		T *data(void)
+		{
+			return _data;
+		}
+
+		const T *data(void) const
+		{
+			return _data;
+		}
+
+		iterator begin(void)
+		{
+			return _data;
+		}
+
+		iterator end(void)
+		{
+			return _data + N;
+		}
+
+		const_iterator begin(void) const
+		{
+			return _data;
+		}
+
+		const_iterator end(void) const
+		{
+			return _data + N;
+		}
+
+		// Member function to get the size, always SIZE
+		unsigned int size(void) const
+		{
+			return N;
+		}
+};
+
+template <typename T, unsigned int N>
+const unsigned int FixedArray<T, N>::SIZE;
+
+// Found by unqualified swap(a, b) calls, like the one for Array
+template <typename T, unsigned int N>
+void swap(FixedArray<T, N> &a, FixedArray<T, N> &b)
+{
+	a.swap(b);
+}
+
+#endif
@@ -0,0 +1,193 @@
+#ifndef MAPPEDARRAY_HPP
+#define MAPPEDARRAY_HPP
+
+#include <stdexcept>
+#include <algorithm>
+#include <string>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+// Array of T whose storage is a file mapped into memory. Opening an
+// existing file is O(1): pages are read in when first touched, writes go
+// back to the file through the page cache, and read-only mappings of the
+// same file are shared between processes. The file holds the raw bytes of
+// the elements, so T must be a plain type such as int, double or a struct
+// of them, and the file is only meaningful on the machine that wrote it.
+// Copies are further views of the same file, not copies of the data
+template <typename T>
+class MappedArray
+{
+	private:
+		int _fd;
+		bool _writable;
+		T *_data;
+		unsigned int _size;
+
+		// Map size elements of _fd; nothing to map for an empty file
+		void _map(void)
+		{
+			if (_size == 0)
+				return;
+			int prot = _writable ? PROT_READ | PROT_WRITE : PROT_READ;
+			void *p = mmap(NULL, _size * sizeof(T), prot, MAP_SHARED, _fd, 0);
+			if (p == MAP_FAILED)
+			{
+				close(_fd);
+				throw std::runtime_error("MappedArray: cannot map file");
+			}
+			_data = static_cast<T *>(p);
+		}
+
+		// Private default constructor
+		MappedArray(void);
+
+	public:
+		enum Mode
+		{
+			READ_ONLY,
+			READ_WRITE
+		};
+
+		// Constructor: opens path, creating it if needed, sized to n
+		// elements; new bytes read as zero
+		MappedArray(const std::string &path, unsigned int n) : _fd(-1), _writable(true), _data(NULL), _size(n)
+		{
+			_fd = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+			if (_fd < 0)
+				throw std::runtime_error("MappedArray: cannot open " + path);
+			if (ftruncate(_fd, static_cast<off_t>(n) * sizeof(T)) != 0)
+			{
+				close(_fd);
+				throw std::runtime_error("MappedArray: cannot resize " + path);
+			}
+			_map();
+		}
+
+		// Constructor: maps an existing file as it is; trailing bytes short
+		// of a whole element are not part of the array
+		explicit MappedArray(const std::string &path, Mode mode = READ_ONLY) : _fd(-1),
+			_writable(mode == READ_WRITE), _data(NULL), _size(0)
+		{
+			_fd = open(path.c_str(), _writable ? O_RDWR : O_RDONLY);
+			if (_fd < 0)
+				throw std::runtime_error("MappedArray: cannot open " + path);
+			struct stat st;
+			if (fstat(_fd, &st) != 0)
+			{
+				close(_fd);
+				throw std::runtime_error("MappedArray: cannot stat " + path);
+			}
+			_size = st.st_size / sizeof(T);
+			_map();
+		}
+
+		// Copy constructor: another mapping of the same file
+		MappedArray(const MappedArray &other) : _fd(dup(other._fd)), _writable(other._writable), _data(NULL),
+			_size(other._size)
+		{
+			if (_fd < 0)
+				throw std::runtime_error("MappedArray: cannot share file");
+			_map();
+		}
+
+		// Assignment operator: copy, then swap
+		MappedArray &operator=(const MappedArray &other)
+		{
+			if (this != &other)
+			{
+				MappedArray copy(other);
+				swap(copy);
+			}
+			return *this;
+		}
+
+		void swap(MappedArray &other)
+		{
+			std::swap(_fd, other._fd);
+			std::swap(_writable, other._writable);
+			std::swap(_data, other._data);
+			std::swap(_size, other._size);
+		}
+
+		// Destructor: unmaps; the kernel still writes dirty pages back
+		~MappedArray(void)
+		{
+			if (_data)
+				munmap(_data, _size * sizeof(T));
+			close(_fd);
+		}
+
+		// Subscript operator with bounds checking; writing needs a
+		// writable mapping, or it faults
+		T &operator[](unsigned int index)
+		{
+			if (index >= _size)
+				throw std::out_of_range("Index out of bounds");
+			return _data[index];
+		}
+
+		// Const subscript operator with bounds checking
+		const T &operator[](unsigned int index) const
+		{
+			if (index >= _size)
+				throw std::out_of_range("Index out of bounds");
+			return _data[index];
+		}
+
+		// Unchecked access, as for Array
+		typedef T *iterator;
+		typedef const T *const_iterator;
+
+		T *data(void)
+		{
+			return _data;
+		}
+
+		const T *data(void) const
+		{
+			return _data;
+		}
+
+		iterator begin(void)
+		{
+			return _data;
+		}
+
+		iterator end(void)
+		{
+			return _data + _size;
+		}
+
+		const_iterator begin(void) const
+		{
+			return _data;
+		}
+
+		const_iterator end(void) const
+		{
+			return _data + _size;
+		}
+
+		// Block until every change so far is on disk, not just in the page
+		// cache; only needed to survive a crash of the machine
+		void sync(void)
+		{
+			if (_data && _writable && msync(_data, _size * sizeof(T), MS_SYNC) != 0)
+				throw std::runtime_error("MappedArray: cannot sync file");
+		}
+
+		bool isWritable(void) const
+		{
+			return _writable;
+		}
+
+		// Member function to get the size
+		unsigned int size(void) const
+		{
+			return _size;
+		}
+};
+
+#endif
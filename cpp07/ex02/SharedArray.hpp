@@ -0,0 +1,186 @@
+#ifndef SHAREDARRAY_HPP
+#define SHAREDARRAY_HPP
+
+#include <cstddef>
+#include "Array.hpp"
+
+// Array whose copies share one block of elements until one of them is
+// written to: copying is O(1), and the first non-const operator[], data()
+// or begin() on a shared copy detaches it with a copy of its own. Const
+// access never copies, so use a const reference for reading.
+// Once a non-const access has handed out a reference into the block, the
+// block is marked unshareable and later copies of this array are deep, so
+// that writing through the reference can never show up in a copy.
+// The count is atomic (GCC __sync builtins, full barriers), so copies
+// sharing a block may be made, read, written and destroyed on different
+// threads at once; as with the standard containers, one SharedArray
+// object still needs a lock to be used from several threads
+template <typename T, typename Alloc = NewAllocation>
+class SharedArray
+{
+	private:
+		struct Block
+		{
+			Array<T, Alloc> array;
+			volatile size_t refs;
+			bool shareable;		// only written while this copy holds the one reference
+
+			Block(const Array<T, Alloc> &a) : array(a), refs(1), shareable(true)
+			{
+			}
+
+			explicit Block(unsigned int n) : array(n), refs(1), shareable(true)
+			{
+			}
+		};
+
+		Block *_block;
+
+		// Share other's block if it may be shared, otherwise copy it
+		static Block *_share(Block *block)
+		{
+			if (!block->shareable)
+				return new Block(block->array);
+			__sync_fetch_and_add(&block->refs, 1);
+			return block;
+		}
+
+		// The last copy to let go deletes the block; the barrier orders its
+		// reads of the elements before the delete, and before the writes of
+		// a copy that finds itself the only one left
+		static void _release(Block *block)
+		{
+			if (__sync_sub_and_fetch(&block->refs, 1) == 0)
+				delete block;
+		}
+
+		static size_t _refs(const Block *block)
+		{
+			return __sync_fetch_and_add(const_cast<volatile size_t *>(&block->refs), 0);
+		}
+
+		// Before a write: take a copy of our own while shared, and stop
+		// sharing the block from now on
+		Array<T, Alloc> &_mutable(void)
+		{
+			if (_refs(_block) > 1)
+			{
+				Block *own = new Block(_block->array);
+				_release(_block);
+				_block = own;
+			}
+			_block->shareable = false;
+			return _block->array;
+		}
+
+	public:
+		typedef T *iterator;
+		typedef const T *const_iterator;
+
+		// Constructor with no parameter: Creates an empty array
+		SharedArray(void) : _block(new Block(0u))
+		{
+		}
+
+		// Constructor with unsigned int n: Creates an array of n elements
+		explicit SharedArray(unsigned int n) : _block(new Block(n))
+		{
+		}
+
+		// Constructor from an Array: copies it once, later copies share
+		explicit SharedArray(const Array<T, Alloc> &array) : _block(new Block(array))
+		{
+		}
+
+		// Copy constructor: shares the block, O(1)
+		SharedArray(const SharedArray &other) : _block(_share(other._block))
+		{
+		}
+
+		// Assignment operator: O(1) unless other's block is unshareable
+		SharedArray &operator=(const SharedArray &other)
+		{
+			if (this != &other)
+			{
+				Block *block = _share(other._block);
+				_release(_block);
+				_block = block;
+			}
+			return *this;
+		}
+
+		void swap(SharedArray &other)
+		{
+			Block *block = _block;
+			_block = other._block;
+			other._block = block;
+		}
+
+		// Destructor
+		~SharedArray(void)
+		{
+			_release(_block);
+		}
+
+		// Subscript operator with bounds checking; detaches when shared
+		T &operator[](unsigned int index)
+		{
+			return _mutable()[index];
+		}
+
+		// Const subscript operator with bounds checking; never copies
+		const T &operator[](unsigned int index) const
+		{
+			return _block->array[index];
+		}
+
+		T *data(void)
+		{
+			return _mutable().data();
+		}
+
+		const T *data(void) const
+		{
+			return _block->array.data();
+		}
+
+		iterator begin(void)
+		{
+			return _mutable().begin();
+		}
+
+		iterator end(void)
+		{
+			return _mutable().end();
+		}
+
+		const_iterator begin(void) const
+		{
+			return _block->array.begin();
+		}
+
+		const_iterator end(void) const
+		{
+			return _block->array.end();
+		}
+
+		// The elements as an Array, for code that takes one
+		const Array<T, Alloc> &array(void) const
+		{
+			return _block->array;
+		}
+
+		// True while another copy uses the same elements
+		bool isShared(void) const
+		{
+			return _refs(_block) > 1;
+		}
+
+		// Member function to get the size
+		unsigned int size(void) const
+		{
+			return _block->array.size();
+		}
+};
+
+#endif
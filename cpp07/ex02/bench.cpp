@@ -0,0 +1,127 @@
+#include "Array.hpp"
+#include "SharedArray.hpp"
+#include "FixedArray.hpp"
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+#include <time.h>
+
+// Benchmark harness for Array: times building, copying and reading an
+// Array of n ints, with value-initialized, uninitialized and huge-page
+// storage, the O(1) copies of SharedArray against the deep copy its
+// first write makes, and short-lived small arrays on the heap (Array)
+// against inline storage (FixedArray)
+
+// Monotonic wall clock in seconds
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static volatile unsigned long g_sink = 0;
+
+static void row(const std::string &label, double seconds, double items, const char *unit)
+{
+	std::cout << "  " << std::left << std::setw(30) << label << std::right << std::fixed << std::setprecision(3)
+	          << std::setw(12) << seconds * 1e3 << " ms" << std::setprecision(1) << std::setw(16)
+	          << (seconds > 0 ? items / seconds : 0) << " " << unit << "/s" << std::endl;
+}
+
+template <typename Alloc>
+static void runStorage(const std::string &name, unsigned int n)
+{
+	double start = now();
+	{
+		Array<int, Alloc> a(n);
+		g_sink += a[n - 1];
+	}
+	row(name + " Array(n)", now() - start, n, "elem");
+	
+	start = now();
+	Array<int, Alloc> a(n, Uninitialized());
+	int *p = a.data();
+	for (unsigned int i = 0; i < n; i++)
+		p[i] = static_cast<int>(i);
+	row(name + " uninitialized fill", now() - start, n, "elem");
+	
+	start = now();
+	unsigned long sum = 0;
+	for (unsigned int i = 0; i < n; i++)
+		sum += a[i];
+	g_sink += sum;
+	row(name + " operator[] sum", now() - start, n, "elem");
+	
+	start = now();
+	sum = 0;
+	for (const int *it = a.begin(); it != a.end(); ++it)
+		sum += *it;
+	g_sink += sum;
+	row(name + " iterator sum", now() - start, n, "elem");
+	
+	start = now();
+	Array<int, Alloc> copy(a);
+	g_sink += copy[n / 2];
+	row(name + " copy", now() - start, n, "elem");
+}
+
+static void runShared(unsigned int n, unsigned int copies)
+{
+	SharedArray<int> shared(n);
+	double start = now();
+	for (unsigned int i = 0; i < copies; i++)
+	{
+		SharedArray<int> copy(shared);
+		const SharedArray<int> &view = copy;
+		g_sink += view[i % n];
+	}
+	row("SharedArray copy and read", now() - start, copies, "copy");
+	
+	start = now();
+	unsigned int writes = copies / 10000 + 1;
+	for (unsigned int i = 0; i < writes; i++)
+	{
+		SharedArray<int> copy(shared);
+		copy[i % n] = 1;
+		g_sink += copy[i % n];
+	}
+	row("SharedArray copy and write", now() - start, writes, "copy");
+}
+
+// Build copies small arrays like make, each filled and summed once
+template <typename Small>
+static void runSmall(const std::string &name, Small make, unsigned int copies)
+{
+	double start = now();
+	unsigned long sum = 0;
+	for (unsigned int i = 0; i < copies; i++)
+	{
+		Small a(make);
+		for (unsigned int k = 0; k < a.size(); k++)
+			a[k] = i + k;
+		for (unsigned int k = 0; k < a.size(); k++)
+			sum += a[k];
+	}
+	g_sink += sum;
+	row(name, now() - start, copies, "array");
+}
+
+int main(int argc, char **argv)
+{
+	unsigned long n = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 1UL << 22;
+	unsigned long copies = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 100000;
+	if (n == 0 || n > 0xffffffffUL || copies == 0)
+	{
+		std::cerr << "Usage: " << argv[0] << " [elements] [copies]" << std::endl;
+		return 1;
+	}
+	
+	std::cout << n << " ints per Array" << std::endl;
+	runStorage<NewAllocation>("new", n);
+	runStorage<HugePageAllocation>("huge page", n);
+	runShared(n, copies);
+	runSmall("Array(8), short-lived", Array<int>(8), copies * 10);
+	runSmall("FixedArray<8>, short-lived", FixedArray<int, 8>(), copies * 10);
+	return 0;
+}
@@ -2,10 +2,33 @@
 #include <cstdlib>
 #include <ctime>
 #include <string>
+#include <numeric>
+#include <cstdio>
 #include "Array.hpp"
+#include "MappedArray.hpp"
+#include "SharedArray.hpp"
+#include "FixedArray.hpp"
+#include <pthread.h>
 
 #define MAX_VAL 750
 
+// Thread of the shared count test: copies and drops its own copy of the
+// array many times, reading and writing it
+static void *copyMany(void *arg)
+{
+	SharedArray<int> *mine = static_cast<SharedArray<int> *>(arg);
+	for (int i = 0; i < 10000; i++)
+	{
+		SharedArray<int> copy(*mine);
+		const SharedArray<int> &view = copy;
+		if (view[0] != view[0])
+			break;
+		if (i % 1000 == 0)
+			copy[1] = i;
+	}
+	return NULL;
+}
+
 int main(void)
 {
 	Array<int> numbers(MAX_VAL);
@@ -61,6 +84,21 @@ int main(void)
 		numbers[i] = rand();
 	}
 	
+	// Test unchecked iteration with a std algorithm
+	Array<int> squares(10);
+	int n = 0;
+	for (Array<int>::iterator it = squares.begin(); it != squares.end(); ++it, ++n)
+		*it = n * n;
+	std::cout << "Sum of squares: " << std::accumulate(squares.begin(), squares.end(), 0) << std::endl;
+	
+	// Test growth: built in place with push_back, no staging vector
+	Array<int> grown;
+	for (int i = 0; i < 1000; i++)
+		grown.push_back(i);
+	grown.resize(500);
+	std::cout << "Grown array: size " << grown.size() << ", capacity " << grown.capacity() << ", last "
+	          << grown[grown.size() - 1] << std::endl;
+	
 	// Test size() method
 	std::cout << "Array size: " << numbers.size() << std::endl;
 	
@@ -72,6 +110,74 @@ int main(void)
 	std::cout << "String array: " << strings[0] << " " << strings[1] << strings[2] << std::endl;
 	std::cout << "String array size: " << strings.size() << std::endl;
 	
+	// Test swap: contents change places without copying elements
+	Array<std::string> other(1);
+	other[0] = "swapped";
+	strings.swap(other);
+	std::cout << "After swap: " << strings.size() << " element(s), " << strings[0] << "; other has "
+	          << other.size() << std::endl;
+	
+	// Test allocation policies: aligned storage, and a large array that is
+	// written before it is read, so it skips the zero fill
+	Array<float, AlignedAllocation<64> > aligned(16);
+	std::cout << "Aligned to 64: " << (reinterpret_cast<size_t>(aligned.data()) % 64 == 0 ? "yes" : "no")
+	          << std::endl;
+	Array<int, HugePageAllocation> large(1 << 20, Uninitialized());
+	for (unsigned int i = 0; i < large.size(); i++)
+		large[i] = i % 7;
+	std::cout << "Large array sum: " << std::accumulate(large.begin(), large.end(), 0L) << std::endl;
+	
+	// Test a file-backed array: written through one mapping, then
+	// reopened read-only with nothing to deserialize
+	{
+		MappedArray<int> table("mapped_array.bin", 100);
+		for (unsigned int i = 0; i < table.size(); i++)
+			table[i] = i * 3;
+	}
+	{
+		const MappedArray<int> table("mapped_array.bin");
+		std::cout << "Mapped array: " << table.size() << " elements, last " << table[table.size() - 1]
+		          << std::endl;
+	}
+	std::remove("mapped_array.bin");
+	
+	// Test copy-on-write: the copy shares until it is written to
+	SharedArray<int> shared(numbers);
+	SharedArray<int> reader(shared);
+	std::cout << "Shared copy: " << (reader.isShared() ? "shares" : "owns") << " its elements";
+	reader[0] = -1;
+	std::cout << ", after a write " << (reader.isShared() ? "shares" : "owns") << " them" << std::endl;
+	
+	// Test copies of one block made and dropped on four threads at once
+	SharedArray<int> copies[4] = {shared, shared, shared, shared};
+	pthread_t threads[4];
+	for (int t = 0; t < 4; t++)
+		pthread_create(&threads[t], NULL, copyMany, &copies[t]);
+	for (int t = 0; t < 4; t++)
+		pthread_join(threads[t], NULL);
+	for (int t = 0; t < 4; t++)
+		copies[t] = SharedArray<int>();
+	std::cout << "After four threads of copies: " << (shared.isShared() ? "shares" : "owns")
+	          << " its elements" << std::endl;
+	
+	// Test inline storage: the size is known at compile time
+	FixedArray<int, 4> fixed;
+	int sizedByIt[FixedArray<int, 4>::SIZE];
+	for (unsigned int i = 0; i < fixed.size(); i++)
+		fixed[i] = sizedByIt[i] = i * i;
+	FixedArray<int, 4> fixedCopy(fixed);
+	fixedCopy[3] = -1;
+	std::cout << "Fixed array: " << sizeof(sizedByIt) / sizeof(int) << " elements, last " << fixed[3]
+	          << ", copy's last " << fixedCopy[3] << std::endl;
+	try
+	{
+		fixed[4] = 0;
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Fixed array exception: " << e.what() << std::endl;
+	}
+	
 	// Test empty array
 	Array<float> empty;
 	std::cout << "Empty array size: " << empty.size() << std::endl;
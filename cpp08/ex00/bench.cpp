@@ -0,0 +1,109 @@
+#include "easyfind.hpp"
+#include <iostream>
+#include <iomanip>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include <deque>
+#include <list>
+#include <time.h>
+
+// Benchmark harness for easyfind: times tryEasyfind on each container
+// kind over the same n numbers, for lookups of present values and of
+// misses, against a plain std::find on the vector and the parallel scan
+
+static unsigned int g_seed = 42;
+
+static unsigned int nextRandom(void)
+{
+	g_seed = g_seed * 1103515245u + 12345u;
+	return g_seed >> 1;
+}
+
+// Monotonic wall clock in seconds
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static volatile unsigned long g_sink = 0;
+
+static void row(const std::string &label, double seconds, double items, const char *unit)
+{
+	std::cout << "  " << std::left << std::setw(30) << label << std::right << std::fixed << std::setprecision(3)
+	          << std::setw(12) << seconds * 1e3 << " ms" << std::setprecision(1) << std::setw(16)
+	          << (seconds > 0 ? items / seconds : 0) << " " << unit << "/s" << std::endl;
+}
+
+template <typename Container>
+static void runLookups(const std::string &name, Container &container, const std::vector<int> &keys)
+{
+	double start = now();
+	for (size_t i = 0; i < keys.size(); i++)
+		g_sink += tryEasyfind(container, keys[i]) != container.end();
+	row(name + " tryEasyfind", now() - start, keys.size(), "lookup");
+}
+
+static void runStdFind(std::vector<int> &container, const std::vector<int> &keys)
+{
+	double start = now();
+	for (size_t i = 0; i < keys.size(); i++)
+		g_sink += std::find(container.begin(), container.end(), keys[i]) != container.end();
+	row("vector std::find", now() - start, keys.size(), "lookup");
+}
+
+static void runSorted(std::vector<int> &sorted, const std::vector<int> &keys)
+{
+	double start = now();
+	for (size_t i = 0; i < keys.size(); i++)
+		g_sink += tryEasyfind(sorted, keys[i], SortedRange()) != sorted.end();
+	row("sorted vector tryEasyfind", now() - start, keys.size(), "lookup");
+}
+
+static void runParallel(std::vector<int> &container, const std::vector<int> &keys)
+{
+	double start = now();
+	for (size_t i = 0; i < keys.size(); i++)
+		g_sink += tryEasyfind(container, keys[i], ParallelScan()) != container.end();
+	row("vector parallel tryEasyfind", now() - start, keys.size(), "lookup");
+}
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 100000;
+	size_t lookups = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 200;
+	if (n == 0 || lookups == 0)
+	{
+		std::cerr << "Usage: " << argv[0] << " [elements] [lookups]" << std::endl;
+		return 1;
+	}
+	
+	// Every number is even, so a present one plus one is a miss
+	std::vector<int> values(n);
+	for (size_t i = 0; i < n; i++)
+		values[i] = static_cast<int>(nextRandom() % (n * 4)) * 2;
+	std::deque<int> dq(values.begin(), values.end());
+	std::list<int> lst(values.begin(), values.end());
+	std::set<int> st(values.begin(), values.end());
+	std::vector<int> sorted(st.begin(), st.end());
+	
+	std::cout << n << " numbers, " << lookups << " lookups per row" << std::endl;
+	const char *kinds[2] = {"hits", "misses"};
+	for (int miss = 0; miss < 2; miss++)
+	{
+		std::vector<int> keys(lookups);
+		for (size_t i = 0; i < lookups; i++)
+			keys[i] = values[nextRandom() % n] + miss;
+		std::cout << kinds[miss] << std::endl;
+		runStdFind(values, keys);
+		runLookups("vector", values, keys);
+		runParallel(values, keys);
+		runLookups("deque", dq, keys);
+		runLookups("list", lst, keys);
+		runLookups("set", st, keys);
+		runSorted(sorted, keys);
+	}
+	return 0;
+}
@@ -3,6 +3,12 @@
 
 #include <algorithm>
 #include <exception>
+#include <vector>
+#include <set>
+#include <map>
+#include <utility>
+#include <cstddef>
+#include "ThreadPool.hpp"
 
 class NotFoundException : public std::exception
 {
@@ -13,15 +19,278 @@ class NotFoundException : public std::exception
 		}
 };
 
-// easyfind: Find first occurrence of integer in container
+// tryEasyfind: Find first occurrence of integer in container
+// Returns container.end() if value not found, for callers that expect
+// misses and should not pay for an exception each time
+template <typename T>
+typename T::iterator tryEasyfind(T &container, int value)
+{
+	return std::find(container.begin(), container.end(), value);
+}
+
+// Index of the first value in data[0, n), or n. Blocks of 16 are tested
+// with a branch-free OR of the comparisons, which the compiler turns into
+// vector compares, and only a block with a hit is searched element by
+// element
+inline size_t findInt(const int *data, size_t n, int value)
+{
+	const size_t BLOCK = 16;
+	size_t i = 0;
+	for (; i + BLOCK <= n; i += BLOCK)
+	{
+		int hit = 0;
+		for (size_t k = 0; k < BLOCK; k++)
+			hit |= data[i + k] == value;
+		if (hit)
+			break;
+	}
+	for (; i < n; i++)
+	{
+		if (data[i] == value)
+			return i;
+	}
+	return n;
+}
+
+// Vectors of int are contiguous, so they take the block scan above
+template <typename Alloc>
+typename std::vector<int, Alloc>::iterator tryEasyfind(std::vector<int, Alloc> &container, int value)
+{
+	size_t n = container.size();
+	return container.begin() + (n ? findInt(&container[0], n, value) : 0);
+}
+
+// Key of an element of an ordered container: the value for sets, the
+// key for maps
+template <typename K>
+const K &easyfindKey(const K &value)
+{
+	return value;
+}
+
+template <typename K, typename V>
+const K &easyfindKey(const std::pair<const K, V> &entry)
+{
+	return entry.first;
+}
+
+// Ordered containers search themselves in O(log n). lower_bound gives
+// the first of equal keys, which is the one iteration reaches first
+template <typename Ordered>
+typename Ordered::iterator tryEasyfindOrdered(Ordered &container, int value)
+{
+	typename Ordered::iterator it = container.lower_bound(value);
+	if (it != container.end() && container.key_comp()(value, easyfindKey(*it)))
+		return container.end();
+	return it;
+}
+
+template <typename Compare, typename Alloc>
+typename std::set<int, Compare, Alloc>::iterator tryEasyfind(std::set<int, Compare, Alloc> &container, int value)
+{
+	return tryEasyfindOrdered(container, value);
+}
+
+template <typename Compare, typename Alloc>
+typename std::multiset<int, Compare, Alloc>::iterator tryEasyfind(std::multiset<int, Compare, Alloc> &container,
+	int value)
+{
+	return tryEasyfindOrdered(container, value);
+}
+
+// Maps are searched by key
+template <typename V, typename Compare, typename Alloc>
+typename std::map<int, V, Compare, Alloc>::iterator tryEasyfind(std::map<int, V, Compare, Alloc> &container,
+	int value)
+{
+	return tryEasyfindOrdered(container, value);
+}
+
+template <typename V, typename Compare, typename Alloc>
+typename std::multimap<int, V, Compare, Alloc>::iterator tryEasyfind(
+	std::multimap<int, V, Compare, Alloc> &container, int value)
+{
+	return tryEasyfindOrdered(container, value);
+}
+
+// Tag for a container the caller knows to be sorted ascending: it is
+// binary searched, easyfind(sortedVector, 42, SortedRange())
+struct SortedRange
+{
+};
+
+template <typename T>
+typename T::iterator tryEasyfind(T &container, int value, SortedRange)
+{
+	typename T::iterator it = std::lower_bound(container.begin(), container.end(), value);
+	if (it != container.end() && value < *it)
+		return container.end();
+	return it;
+}
+
+// Tag for a parallel scan of a large random-access container on the
+// threads of ThreadPool::shared(): easyfind(bigVector, 42, ParallelScan()).
+// The result is still the first occurrence
+struct ParallelScan
+{
+};
+
+// Index of value in the n elements from first, or n; int pointers take
+// the block scan
+template <typename Iterator>
+size_t easyfindScan(Iterator first, size_t n, int value)
+{
+	return std::find(first, first + n, value) - first;
+}
+
+inline size_t easyfindScan(int *first, size_t n, int value)
+{
+	return findInt(first, n, value);
+}
+
+// Pieces of a parallel scan: PARALLEL_FIND_GRAIN elements per task,
+// scanned PARALLEL_FIND_STEP at a time; below two pieces the scan stays
+// on the calling thread
+static const size_t PARALLEL_FIND_GRAIN = 1 << 18;
+static const size_t PARALLEL_FIND_STEP = 1 << 14;
+
+// Body of the parallel scan. lowest is the smallest matching index
+// published so far: a piece stops at its own first match, or as soon as
+// lowest is before where it got to, since nothing it could find would
+// come first
+template <typename Iterator>
+struct ParallelFindJob
+{
+	Iterator first;
+	int value;
+	size_t *lowest;
+	
+	void operator()(size_t begin, size_t end) const
+	{
+		for (size_t i = begin; i < end; i += PARALLEL_FIND_STEP)
+		{
+			if (__sync_fetch_and_add(lowest, 0) < i)
+				return;
+			size_t len = end - i < PARALLEL_FIND_STEP ? end - i : PARALLEL_FIND_STEP;
+			size_t hit = easyfindScan(first + i, len, value);
+			if (hit < len)
+			{
+				// Atomic minimum: retried while a smaller index is not in
+				size_t seen = __sync_fetch_and_add(lowest, 0);
+				while (i + hit < seen)
+				{
+					size_t now = __sync_val_compare_and_swap(lowest, seen, i + hit);
+					if (now == seen)
+						break;
+					seen = now;
+				}
+				return;
+			}
+		}
+	}
+};
+
+template <typename Iterator>
+size_t parallelFindIndex(Iterator first, size_t n, int value)
+{
+	if (n < 2 * PARALLEL_FIND_GRAIN)
+		return easyfindScan(first, n, value);
+	size_t lowest = n;
+	ParallelFindJob<Iterator> job;
+	job.first = first;
+	job.value = value;
+	job.lowest = &lowest;
+	ThreadPool::shared().parallelFor(0, n, PARALLEL_FIND_GRAIN, job);
+	return lowest;
+}
+
+template <typename T>
+typename T::iterator tryEasyfind(T &container, int value, ParallelScan)
+{
+	return container.begin() + parallelFindIndex(container.begin(), container.size(), value);
+}
+
+template <typename Alloc>
+typename std::vector<int, Alloc>::iterator tryEasyfind(std::vector<int, Alloc> &container, int value, ParallelScan)
+{
+	size_t n = container.size();
+	return container.begin() + (n ? parallelFindIndex(&container[0], n, value) : 0);
+}
+
+// easyfind: Find first occurrence of integer in container, the same way
+// as tryEasyfind (every overload above is already declared here)
 // Throws NotFoundException if value not found
 template <typename T>
 typename T::iterator easyfind(T &container, int value)
 {
-	typename T::iterator it = std::find(container.begin(), container.end(), value);
+	typename T::iterator it = tryEasyfind(container, value);
+	if (it == container.end())
+		throw NotFoundException();
+	return it;
+}
+
+template <typename T>
+typename T::iterator easyfind(T &container, int value, SortedRange sorted)
+{
+	typename T::iterator it = tryEasyfind(container, value, sorted);
 	if (it == container.end())
 		throw NotFoundException();
 	return it;
 }
 
+template <typename T>
+typename T::iterator easyfind(T &container, int value, ParallelScan parallel)
+{
+	typename T::iterator it = tryEasyfind(container, value, parallel);
+	if (it == container.end())
+		throw NotFoundException();
+	return it;
+}
+
+// Find many values in one pass over the container: result[i] holds every
+// position of the i-th value, in container order, and is empty when the
+// value is not there, so misses cost no exception. The distinct values
+// are sorted into a probe list that each element is binary searched in;
+// a value asked for twice gets the same positions twice
+template <typename T, typename Values>
+std::vector<std::vector<typename T::iterator> > easyfindAll(T &container, const Values &values)
+{
+	typedef typename T::iterator Iterator;
+	
+	std::vector<std::pair<int, size_t> > probes;
+	for (typename Values::const_iterator v = values.begin(); v != values.end(); ++v)
+		probes.push_back(std::make_pair(static_cast<int>(*v), probes.size()));
+	std::sort(probes.begin(), probes.end());
+	std::vector<int> keys;
+	for (size_t i = 0; i < probes.size(); i++)
+	{
+		if (i == 0 || probes[i].first != probes[i - 1].first)
+			keys.push_back(probes[i].first);
+	}
+	
+	std::vector<std::vector<Iterator> > hits(keys.size());
+	for (Iterator it = container.begin(); it != container.end(); ++it)
+	{
+		int x = *it;
+		std::vector<int>::const_iterator k = std::lower_bound(keys.begin(), keys.end(), x);
+		if (k != keys.end() && *k == x)
+			hits[k - keys.begin()].push_back(it);
+	}
+	
+	// Sorted probes walk the keys in step; the last request of a key takes
+	// its positions without a copy
+	std::vector<std::vector<Iterator> > result(probes.size());
+	size_t key = 0;
+	for (size_t i = 0; i < probes.size(); i++)
+	{
+		if (i > 0 && probes[i].first != probes[i - 1].first)
+			key++;
+		if (i + 1 < probes.size() && probes[i + 1].first == probes[i].first)
+			result[probes[i].second] = hits[key];
+		else
+			result[probes[i].second].swap(hits[key]);
+	}
+	return result;
+}
+
 #endif
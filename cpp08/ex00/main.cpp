@@ -1,6 +1,8 @@
 #include <iostream>
 #include <vector>
 #include <list>
+#include <set>
+#include <map>
 #include "easyfind.hpp"
 
 int main(void)
@@ -81,5 +83,101 @@ int main(void)
 		std::cout << "Error: " << e.what() << std::endl;
 	}
 	
+	// Large vector: the block scan has to cross many blocks
+	std::vector<int> large(1000000, 0);
+	large[765432] = 42;
+	large[900000] = 42;
+	
+	std::cout << "\nLarge vector test:" << std::endl;
+	try
+	{
+		std::vector<int>::iterator it = easyfind(large, 42);
+		std::cout << "Found 42 at position: " << (it - large.begin()) << std::endl;
+		easyfind(large, 7);
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+	}
+	
+	// The same large vector, scanned in parallel: still the first 42
+	std::cout << "\nParallel scan test:" << std::endl;
+	try
+	{
+		std::vector<int>::iterator it = easyfind(large, 42, ParallelScan());
+		std::cout << "Found 42 at position: " << (it - large.begin()) << std::endl;
+		easyfind(large, 7, ParallelScan());
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+	}
+	
+	// Associative containers use their own lookup, maps by key
+	std::set<int> st;
+	st.insert(8);
+	st.insert(2);
+	std::map<int, std::string> names;
+	names[1] = "one";
+	names[2] = "two";
+	
+	std::cout << "\nAssociative test:" << std::endl;
+	try
+	{
+		std::cout << "Found in set: " << *easyfind(st, 8) << std::endl;
+		std::cout << "Found in map: " << easyfind(names, 2)->second << std::endl;
+		easyfind(names, 3);
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+	}
+	
+	// A sorted vector can be binary searched on request
+	std::cout << "\nSorted range test:" << std::endl;
+	try
+	{
+		std::vector<int>::iterator it = easyfind(vec, 4, SortedRange());
+		std::cout << "Found: " << *it << " at position " << (it - vec.begin()) << std::endl;
+		easyfind(vec, 6, SortedRange());
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Error: " << e.what() << std::endl;
+	}
+	
+	// Many values at once, every position of each; misses come back empty
+	std::cout << "\nBatch test:" << std::endl;
+	std::vector<int> wanted;
+	wanted.push_back(15);
+	wanted.push_back(7);
+	wanted.push_back(5);
+	wanted.push_back(15);
+	std::vector<std::vector<std::vector<int>::iterator> > found = easyfindAll(dupVec, wanted);
+	for (size_t i = 0; i < found.size(); i++)
+	{
+		if (found[i].empty())
+			std::cout << wanted[i] << ": not found";
+		else
+			std::cout << wanted[i] << ": position";
+		for (size_t k = 0; k < found[i].size(); k++)
+			std::cout << " " << (found[i][k] - dupVec.begin());
+		std::cout << std::endl;
+	}
+	std::list<int> dupList(dupVec.begin(), dupVec.end());
+	dupList.push_back(5);
+	std::vector<int> fives(1, 5);
+	std::cout << "5 in list: " << easyfindAll(dupList, fives)[0].size() << " matches" << std::endl;
+	
+	// Miss-heavy probing without exceptions
+	std::cout << "\nNon-throwing test:" << std::endl;
+	int hits = 0;
+	for (int probe = 0; probe < 100; probe++)
+	{
+		if (tryEasyfind(lst, probe) != lst.end())
+			hits++;
+	}
+	std::cout << "Probed 0..99 in list: " << hits << " hits" << std::endl;
+	
 	return 0;
 }
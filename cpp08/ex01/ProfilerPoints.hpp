@@ -0,0 +1,15 @@
+#ifndef PROFILERPOINTS_HPP
+#define PROFILERPOINTS_HPP
+
+// The phases and events span profiles, as X(NAME, "label") entries that
+// become Profiler::PHASE_NAME and Profiler::EVENT_NAME
+#define PROFILER_PHASES(X) \
+	X(SHORTEST_SPAN, "shortest span") \
+	X(LONGEST_SPAN, "longest span") \
+	X(SORT, "sort")
+
+#define PROFILER_EVENTS(X) \
+	X(CACHED_QUERIES, "cached queries") \
+	X(SORTED_VALUES, "sorted values")
+
+#endif
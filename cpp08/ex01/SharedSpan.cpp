@@ -0,0 +1,156 @@
+#include "SharedSpan.hpp"
+
+// Constructor
+SharedSpan::SharedSpan(unsigned int N) : _span(N), _maxSize(N), _reserved(0)
+{
+	pthread_mutex_init(&_lock, NULL);
+}
+
+// Destructor
+SharedSpan::~SharedSpan(void)
+{
+	pthread_mutex_destroy(&_lock);
+}
+
+// Take what is left when fewer than count slots are; retried when
+// another producer got in between
+unsigned int SharedSpan::_reserve(unsigned int count)
+{
+	unsigned int seen = _reservedNow();
+	for (;;)
+	{
+		unsigned int left = _maxSize - seen;
+		unsigned int take = count < left ? count : left;
+		if (take == 0)
+			return 0;
+		unsigned int now = __sync_val_compare_and_swap(&_reserved, seen, seen + take);
+		if (now == seen)
+			return take;
+		seen = now;
+	}
+}
+
+// An atomic read: adding 0 returns the value, made visible by any CAS
+unsigned int SharedSpan::_reservedNow(void) const
+{
+	return __sync_fetch_and_add(const_cast<volatile unsigned int *>(&_reserved), 0);
+}
+
+void SharedSpan::_release(unsigned int count)
+{
+	if (count)
+		__sync_fetch_and_sub(&_reserved, count);
+}
+
+// Cannot overflow the Span: every number had a slot
+void SharedSpan::_commit(const std::vector<int> &numbers)
+{
+	pthread_mutex_lock(&_lock);
+	_span.addNumbers(numbers.begin(), numbers.end());
+	pthread_mutex_unlock(&_lock);
+}
+
+// Queries run on the Span itself, under the lock: the answer is that of
+// one state, and the Span keeps its caches for the next query
+unsigned int SharedSpan::shortestSpan(void) const
+{
+	pthread_mutex_lock(&_lock);
+	try
+	{
+		unsigned int span = _span.shortestSpan();
+		pthread_mutex_unlock(&_lock);
+		return span;
+	}
+	catch (...)
+	{
+		pthread_mutex_unlock(&_lock);
+		throw;
+	}
+}
+
+unsigned int SharedSpan::longestSpan(void) const
+{
+	pthread_mutex_lock(&_lock);
+	try
+	{
+		unsigned int span = _span.longestSpan();
+		pthread_mutex_unlock(&_lock);
+		return span;
+	}
+	catch (...)
+	{
+		pthread_mutex_unlock(&_lock);
+		throw;
+	}
+}
+
+Span SharedSpan::snapshot(void) const
+{
+	pthread_mutex_lock(&_lock);
+	Span copy(_span);
+	pthread_mutex_unlock(&_lock);
+	return copy;
+}
+
+unsigned int SharedSpan::size(void) const
+{
+	pthread_mutex_lock(&_lock);
+	unsigned int n = _span.size();
+	pthread_mutex_unlock(&_lock);
+	return n;
+}
+
+unsigned int SharedSpan::reserved(void) const
+{
+	return _reservedNow();
+}
+
+unsigned int SharedSpan::getMaxSize(void) const
+{
+	return _maxSize;
+}
+
+// Producer constructor
+SharedSpan::Producer::Producer(SharedSpan &shared, size_t batch) : _shared(shared),
+	_batch(batch == 0 ? 1 : batch), _slots(0)
+{
+	_pending.reserve(_batch);
+}
+
+// Producer destructor
+SharedSpan::Producer::~Producer(void)
+{
+	flush();
+}
+
+// Buffer a number in a slot reserved for it
+void SharedSpan::Producer::addNumber(int number)
+{
+	if (_slots == 0)
+	{
+		_slots = _shared._reserve(static_cast<unsigned int>(_batch - _pending.size()));
+		if (_slots == 0)
+			throw SpanException();
+	}
+	_pending.push_back(number);
+	_slots--;
+	if (_pending.size() >= _batch)
+		flush();
+}
+
+// Hand the batch to the Span
+void SharedSpan::Producer::flush(void)
+{
+	_shared._release(_slots);
+	_slots = 0;
+	if (_pending.empty())
+		return;
+	_shared._commit(_pending);
+	_pending.clear();
+}
+
+// Getter for pending
+size_t SharedSpan::Producer::pending(void) const
+{
+	return _pending.size();
+}
@@ -0,0 +1,95 @@
+#ifndef SHAREDSPAN_HPP
+#define SHAREDSPAN_HPP
+
+#include <vector>
+#include <pthread.h>
+#include "Span.hpp"
+
+// Span shared by producer threads. Capacity is handed out before the
+// numbers are: a Producer reserves slots a batch at a time with one
+// atomic compare-and-swap, so _maxSize holds without a lock, and buffers
+// its numbers until the batch is full. Only then does it take the lock,
+// once per batch, to append them all. Queries take the same lock and see
+// every completed batch and none in progress
+class SharedSpan
+{
+	public:
+		// One per producer thread: a reservation and the numbers written
+		// into it. Its slots are returned, and its numbers flushed, by
+		// flush and by the destructor
+		class Producer
+		{
+			private:
+				SharedSpan &_shared;
+				size_t _batch;
+				std::vector<int> _pending;
+				unsigned int _slots;		// reserved, not yet filled
+				
+				// A reservation has one owner: no copies
+				Producer(const Producer &other);
+				Producer &operator=(const Producer &other);
+				
+			public:
+				// Constructor; reserves batch slots at a time (at least 1)
+				Producer(SharedSpan &shared, size_t batch);
+				
+				// Destructor (flushes)
+				~Producer(void);
+				
+				// Buffer a number, flushing when the batch is full; throws
+				// SpanException, buffering nothing, when no slot is left
+				void addNumber(int number);
+				
+				// Append the pending numbers and give back unused slots
+				void flush(void);
+				
+				// Numbers not yet in the Span
+				size_t pending(void) const;
+		};
+		
+	private:
+		mutable Span _span;
+		unsigned int _maxSize;
+		mutable pthread_mutex_t _lock;
+		
+		// Slots handed out to producers, filled or not; only changed by
+		// compare-and-swap
+		volatile unsigned int _reserved;
+		
+		// Reserve up to count slots; returns how many, 0 when full
+		unsigned int _reserve(unsigned int count);
+		unsigned int _reservedNow(void) const;
+		void _release(unsigned int count);
+		
+		// Append numbers that already have their slots
+		void _commit(const std::vector<int> &numbers);
+		
+		// Shared between threads: no copies
+		SharedSpan(const SharedSpan &other);
+		SharedSpan &operator=(const SharedSpan &other);
+		
+		// Private default constructor
+		SharedSpan(void);
+		
+	public:
+		// Constructor
+		SharedSpan(unsigned int N);
+		
+		// Destructor
+		~SharedSpan(void);
+		
+		// Queries over the numbers committed so far; SpanException with
+		// fewer than two
+		unsigned int shortestSpan(void) const;
+		unsigned int longestSpan(void) const;
+		
+		// Copy of the committed numbers, for several queries on one state
+		Span snapshot(void) const;
+		
+		// Numbers committed, and slots reserved by producers
+		unsigned int size(void) const;
+		unsigned int reserved(void) const;
+		unsigned int getMaxSize(void) const;
+};
+
+#endif
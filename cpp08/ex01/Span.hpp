@@ -2,8 +2,13 @@
 #define SPAN_HPP
 
 #include <vector>
+#include <set>
+#include <iterator>
+#include <algorithm>
 #include <exception>
 #include <iostream>
+#include "ThreadPool.hpp"
+#include "Profiler.hpp"
 
 class SpanException : public std::exception
 {
@@ -14,46 +19,287 @@ class SpanException : public std::exception
 		}
 };
 
-class Span
+// What a span of T values is measured in, and how: Result must hold
+// b - a for any a <= b. Signed integers use their unsigned counterpart,
+// whose wrapping difference is exact over the whole range; float widens
+// to double. Anything else, such as a fixed-point class, uses its own
+// subtraction
+template <typename T>
+struct SpanTraits
 {
+	typedef T Result;
+	
+	static Result gap(const T &a, const T &b)
+	{
+		return b - a;
+	}
+};
+
+template <>
+struct SpanTraits<int>
+{
+	typedef unsigned int Result;
+	
+	static Result gap(int a, int b)
+	{
+		return static_cast<Result>(b) - static_cast<Result>(a);
+	}
+};
+
+template <>
+struct SpanTraits<long>
+{
+	typedef unsigned long Result;
+	
+	static Result gap(long a, long b)
+	{
+		return static_cast<Result>(b) - static_cast<Result>(a);
+	}
+};
+
+template <>
+struct SpanTraits<long long>
+{
+	typedef unsigned long long Result;
+	
+	static Result gap(long long a, long long b)
+	{
+		return static_cast<Result>(b) - static_cast<Result>(a);
+	}
+};
+
+template <>
+struct SpanTraits<float>
+{
+	typedef double Result;
+	
+	static Result gap(float a, float b)
+	{
+		return static_cast<Result>(b) - static_cast<Result>(a);
+	}
+};
+
+// Span of up to N values of T; spans come back as SpanTraits<T>::Result.
+// Span is the int one
+template <typename T>
+class BasicSpan
+{
+	public:
+		typedef T Value;
+		typedef typename SpanTraits<T>::Result Result;
+	
 	private:
 		unsigned int _maxSize;
-		std::vector<int> _numbers;
+		std::vector<T> _numbers;
 		
-		// Private default constructor
-		Span(void);
+		// Running extremes of _numbers, valid when it is not empty
+		T _min;
+		T _max;
+		
+		// Incremental mode: every value in order, and the gap between each
+		// pair of neighbours in it, so the smallest gap is always first
+		bool _incremental;
+		std::multiset<T> _sorted;
+		std::multiset<Result> _gaps;
 		
+		// Sorted copy of the first _sortedCount numbers for shortestSpan
+		// in the default mode, and its answer; numbers added since are
+		// sorted on their own and merged in by the next query
+		std::vector<T> _sortedView;
+		size_t _sortedCount;
+		Result _shortest;
+		
+		// Bounded mode: one bit per value of _domainMin.._domainMax, set for
+		// the values added, and whether any value came twice. _sortedCount
+		// and _shortest cache the answer the same way as the sorted view
+		typedef unsigned long long Word;
+		static const size_t WORD_BITS = 64;
+		bool _bounded;
+		T _domainMin;
+		T _domainMax;
+		std::vector<Word> _bits;
+		bool _repeated;
+		
+		// Parallel mode: large passes are cut into PARALLEL_GRAIN pieces
+		// for the threads of ThreadPool::shared()
+		static const size_t PARALLEL_GRAIN = 1 << 16;
+		bool _parallel;
+		
+		// Distance b - a for a <= b (see SpanTraits)
+		static Result _gap(const T &a, const T &b)
+		{
+			return SpanTraits<T>::gap(a, b);
+		}
+		
+		static void _minMax(const T *values, size_t n, T &lo, T &hi);
+		static Result _minAdjacentGap(const T *sorted, size_t n);
+		
+		// Bodies of the parallel loops: piece first / PARALLEL_GRAIN writes
+		// its result to slot of that index
+		struct _MinMaxJob
+		{
+			const T *values;
+			T *lo;
+			T *hi;
+			
+			void operator()(size_t first, size_t last) const
+			{
+				size_t c = first / PARALLEL_GRAIN;
+				_minMax(values + first, last - first, lo[c], hi[c]);
+			}
+		};
+		
+		// Over the pairs of neighbours: pair j is sorted[j], sorted[j + 1]
+		struct _GapJob
+		{
+			const T *sorted;
+			Result *gaps;
+			
+			void operator()(size_t first, size_t last) const
+			{
+				gaps[first / PARALLEL_GRAIN] = _minAdjacentGap(sorted + first, last - first + 1);
+			}
+		};
+		
+		struct _SortJob
+		{
+			T *values;
+			
+			void operator()(size_t first, size_t last) const
+			{
+				std::sort(values + first, values + last);
+			}
+		};
+		
+		// Over the run pairs of one merge pass, each run width values long
+		struct _MergeJob
+		{
+			T *values;
+			size_t n;
+			size_t width;
+			
+			void operator()(size_t first, size_t last) const
+			{
+				for (size_t p = first; p < last; p++)
+				{
+					size_t start = p * 2 * width;
+					size_t mid = start + width < n ? start + width : n;
+					size_t end = start + 2 * width < n ? start + 2 * width : n;
+					std::inplace_merge(values + start, values + mid, values + end);
+				}
+			}
+		};
+		
+		// The kernels above, reduced over pieces on the thread pool in
+		// parallel mode once there are at least two pieces
+		void _extremes(const T *values, size_t n, T &lo, T &hi) const;
+		Result _smallestGap(const T *sorted, size_t n) const;
+		void _sortValues(T *values, size_t n) const;
+		
+		// Trailing and leading zero bits of a nonzero word
+		static unsigned int _ctz(Word x);
+		static unsigned int _clz(Word x);
+		
+		// Set the bit of number, noting a repeat when it was set already
+		void _insertBit(const T &number);
+		
+		// Smallest distance between set bits, one or more words at a time
+		size_t _scanBits(void) const;
+		
+		// Distance from bit i to the nearest other set bit, or limit when
+		// there is none closer; only the words within limit are read
+		size_t _gapAround(size_t i, size_t limit) const;
+		
+		// Answer of bounded mode for the numbers added since the last one
+		Result _boundedShortest(void);
+		
+		// Record number in _sorted and _gaps
+		void _insertSorted(const T &number);
+		
+		// Bring the extremes and the incremental sets up to date with
+		// _numbers[from..]; on failure the tail is removed again
+		void _appended(size_t from);
+		
+		// Forward ranges are counted, checked and inserted in one go
+		template <typename Iterator>
+		void _addRange(Iterator begin, Iterator end, std::forward_iterator_tag)
+		{
+			size_t count = std::distance(begin, end);
+			if (count > _maxSize - _numbers.size())
+				throw SpanException();
+			size_t from = _numbers.size();
+			_numbers.insert(_numbers.end(), begin, end);
+			_appended(from);
+		}
+		
+		// Single-pass ranges can only be counted by reading them, so they
+		// are read into a buffer first
+		template <typename Iterator>
+		void _addRange(Iterator begin, Iterator end, std::input_iterator_tag)
+		{
+			std::vector<T> buffer(begin, end);
+			_addRange(buffer.begin(), buffer.end(), std::forward_iterator_tag());
+		}
+		
+		// Private default constructor
+		BasicSpan(void);
+	
 	public:
 		// Constructor
-		Span(unsigned int N);
+		BasicSpan(unsigned int N);
 		
 		// Copy constructor
-		Span(const Span &other);
+		BasicSpan(const BasicSpan &other);
 		
 		// Assignment operator
-		Span &operator=(const Span &other);
+		BasicSpan &operator=(const BasicSpan &other);
 		
 		// Destructor
-		~Span(void);
+		~BasicSpan(void);
 		
 		// Add single number
-		void addNumber(int number);
+		void addNumber(const T &number);
 		
-		// Add numbers from iterator range
+		// Add numbers from iterator range; when they do not all fit, none
+		// are added and SpanException is thrown
 		template <typename Iterator>
 		void addNumbers(Iterator begin, Iterator end)
 		{
-			for (Iterator it = begin; it != end; ++it)
-			{
-				addNumber(*it);
-			}
+			_addRange(begin, end, typename std::iterator_traits<Iterator>::iterator_category());
 		}
 		
-		// Find shortest span
-		unsigned int shortestSpan(void);
+		// Find shortest span; repeated calls with no new numbers are O(1),
+		// and after k new ones cost O(k log k + n)
+		Result shortestSpan(void);
+		
+		// Find longest span: max - min, kept up to date by every insert
+		Result longestSpan(void);
 		
-		// Find longest span
-		unsigned int longestSpan(void);
+		// Incremental mode keeps the numbers ordered as they arrive, so that
+		// addNumber costs O(log n) and shortestSpan is O(1) instead of a sort
+		// per call. Off by default; enabling builds it from the numbers so far
+		void setIncremental(bool enabled);
+		bool isIncremental(void) const;
+		
+		// Bounded mode, for integer T known to stay in lo..hi: membership is
+		// kept in a bitset of hi - lo + 1 bits instead of a sorted view, so
+		// shortestSpan never sorts. A query scans the bitset, O((hi - lo) / 64),
+		// or after k new numbers just their neighbourhoods when that is
+		// cheaper. Numbers outside the domain throw SpanException. Setting a
+		// domain turns incremental mode off (and enabling incremental mode
+		// drops the domain); it throws, changing nothing, when lo > hi or a
+		// number already added falls outside
+		void setDomain(const T &lo, const T &hi);
+		void clearDomain(void);
+		bool isBounded(void) const;
+		
+		// Parallel mode: the passes over all the numbers (the extremes of a
+		// bulk insert, the sort and the gap scan of shortestSpan in the
+		// default mode) run on the shared thread pool, each piece of
+		// PARALLEL_GRAIN numbers reduced on its own and the pieces' results
+		// combined. Off by default; answers are the same either way
+		void setParallel(bool enabled);
+		bool isParallel(void) const;
 		
 		// Getter for size
 		unsigned int size(void) const;
@@ -62,4 +308,509 @@ class Span
 		unsigned int getMaxSize(void) const;
 };
 
+typedef BasicSpan<int> Span;
+
+// Smallest and largest of n > 0 values in one pass. Values are taken in
+// pairs, ordered against each other first, so each pair costs three
+// comparisons instead of four
+template <typename T>
+void BasicSpan<T>::_minMax(const T *values, size_t n, T &lo, T &hi)
+{
+	size_t i = n % 2;
+	lo = values[0];
+	hi = values[0];
+	for (; i + 1 < n; i += 2)
+	{
+		T a = values[i];
+		T b = values[i + 1];
+		if (b < a)
+		{
+			T t = a;
+			a = b;
+			b = t;
+		}
+		if (a < lo)
+			lo = a;
+		if (b > hi)
+			hi = b;
+	}
+}
+
+// Smallest difference between neighbours of n > 1 sorted values. Four
+// independent minimums keep the loop free of a serial chain the compiler
+// cannot unroll or vectorize. Stops early, a block at a time, once it
+// finds a 0
+template <typename T>
+typename BasicSpan<T>::Result BasicSpan<T>::_minAdjacentGap(const T *sorted, size_t n)
+{
+	const size_t BLOCK = 1024;
+	Result first = _gap(sorted[0], sorted[1]);
+	Result m[4] = {first, first, first, first};
+	size_t i = 0;
+	while (i + 4 < n)
+	{
+		size_t stop = n - i - 1 > BLOCK ? i + BLOCK : n - 4;
+		for (; i < stop; i += 4)
+		{
+			for (int k = 0; k < 4; k++)
+			{
+				Result d = _gap(sorted[i + k], sorted[i + k + 1]);
+				m[k] = d < m[k] ? d : m[k];
+			}
+		}
+		if (m[0] == Result() || m[1] == Result() || m[2] == Result() || m[3] == Result())
+			return Result();
+	}
+	for (; i + 1 < n; i++)
+	{
+		Result d = _gap(sorted[i], sorted[i + 1]);
+		m[0] = d < m[0] ? d : m[0];
+	}
+	Result a = m[0] < m[1] ? m[0] : m[1];
+	Result b = m[2] < m[3] ? m[2] : m[3];
+	return a < b ? a : b;
+}
+
+template <typename T>
+void BasicSpan<T>::_extremes(const T *values, size_t n, T &lo, T &hi) const
+{
+	if (!_parallel || n < 2 * PARALLEL_GRAIN)
+	{
+		_minMax(values, n, lo, hi);
+		return;
+	}
+	size_t pieces = (n - 1) / PARALLEL_GRAIN + 1;
+	std::vector<T> los(pieces);
+	std::vector<T> his(pieces);
+	_MinMaxJob job;
+	job.values = values;
+	job.lo = &los[0];
+	job.hi = &his[0];
+	ThreadPool::shared().parallelFor(0, n, PARALLEL_GRAIN, job);
+	lo = *std::min_element(los.begin(), los.end());
+	hi = *std::max_element(his.begin(), his.end());
+}
+
+// Pieces overlap by one value, so no pair of neighbours is left out
+template <typename T>
+typename BasicSpan<T>::Result BasicSpan<T>::_smallestGap(const T *sorted, size_t n) const
+{
+	if (!_parallel || n - 1 < 2 * PARALLEL_GRAIN)
+		return _minAdjacentGap(sorted, n);
+	size_t pieces = (n - 2) / PARALLEL_GRAIN + 1;
+	std::vector<Result> gaps(pieces);
+	_GapJob job;
+	job.sorted = sorted;
+	job.gaps = &gaps[0];
+	ThreadPool::shared().parallelFor(0, n - 1, PARALLEL_GRAIN, job);
+	return *std::min_element(gaps.begin(), gaps.end());
+}
+
+// Pieces sorted on their own, then merged pairwise in log2(pieces) passes
+template <typename T>
+void BasicSpan<T>::_sortValues(T *values, size_t n) const
+{
+	PROFILE_SCOPE(PHASE_SORT);
+	PROFILE_COUNT(EVENT_SORTED_VALUES, n);
+	if (!_parallel || n < 2 * PARALLEL_GRAIN)
+	{
+		std::sort(values, values + n);
+		return;
+	}
+	ThreadPool &pool = ThreadPool::shared();
+	_SortJob sortJob;
+	sortJob.values = values;
+	pool.parallelFor(0, n, PARALLEL_GRAIN, sortJob);
+	_MergeJob mergeJob;
+	mergeJob.values = values;
+	mergeJob.n = n;
+	for (size_t width = PARALLEL_GRAIN; width < n; width *= 2)
+	{
+		mergeJob.width = width;
+		pool.parallelFor(0, (n - 1) / (2 * width) + 1, 1, mergeJob);
+	}
+}
+
+// Constructor
+template <typename T>
+BasicSpan<T>::BasicSpan(unsigned int N) : _maxSize(N), _min(), _max(), _incremental(false), _sortedCount(0),
+	_shortest(), _bounded(false), _domainMin(), _domainMax(), _repeated(false), _parallel(false)
+{
+}
+
+// Copy constructor
+template <typename T>
+BasicSpan<T>::BasicSpan(const BasicSpan &other) : _maxSize(other._maxSize), _numbers(other._numbers),
+	_min(other._min), _max(other._max), _incremental(other._incremental), _sorted(other._sorted),
+	_gaps(other._gaps), _sortedView(other._sortedView), _sortedCount(other._sortedCount),
+	_shortest(other._shortest), _bounded(other._bounded), _domainMin(other._domainMin),
+	_domainMax(other._domainMax), _bits(other._bits), _repeated(other._repeated), _parallel(other._parallel)
+{
+}
+
+// Assignment operator
+template <typename T>
+BasicSpan<T> &BasicSpan<T>::operator=(const BasicSpan &other)
+{
+	if (this != &other)
+	{
+		_maxSize = other._maxSize;
+		_numbers = other._numbers;
+		_min = other._min;
+		_max = other._max;
+		_incremental = other._incremental;
+		_sorted = other._sorted;
+		_gaps = other._gaps;
+		_sortedView = other._sortedView;
+		_sortedCount = other._sortedCount;
+		_shortest = other._shortest;
+		_bounded = other._bounded;
+		_domainMin = other._domainMin;
+		_domainMax = other._domainMax;
+		_bits = other._bits;
+		_repeated = other._repeated;
+		_parallel = other._parallel;
+	}
+	return *this;
+}
+
+// Destructor
+template <typename T>
+BasicSpan<T>::~BasicSpan(void)
+{
+}
+
+// Add single number
+template <typename T>
+void BasicSpan<T>::addNumber(const T &number)
+{
+	if (_numbers.size() >= _maxSize)
+		throw SpanException();
+	if (_bounded && (number < _domainMin || number > _domainMax))
+		throw SpanException();
+	_numbers.push_back(number);
+	if (_numbers.size() == 1 || number < _min)
+		_min = number;
+	if (_numbers.size() == 1 || number > _max)
+		_max = number;
+	if (_incremental)
+		_insertSorted(number);
+	if (_bounded)
+		_insertBit(number);
+}
+
+// The new value splits the gap between its neighbours in two
+template <typename T>
+void BasicSpan<T>::_insertSorted(const T &number)
+{
+	typename std::multiset<T>::iterator it = _sorted.insert(number);
+	typename std::multiset<T>::iterator next = it;
+	++next;
+	bool hasPrev = it != _sorted.begin();
+	bool hasNext = next != _sorted.end();
+	if (hasPrev)
+	{
+		typename std::multiset<T>::iterator prev = it;
+		--prev;
+		if (hasNext)
+			_gaps.erase(_gaps.find(_gap(*prev, *next)));
+		_gaps.insert(_gap(*prev, number));
+	}
+	if (hasNext)
+		_gaps.insert(_gap(number, *next));
+}
+
+// Find shortest span
+template <typename T>
+typename BasicSpan<T>::Result BasicSpan<T>::shortestSpan(void)
+{
+	PROFILE_SCOPE(PHASE_SHORTEST_SPAN);
+	if (_numbers.size() <= 1)
+		throw SpanException();
+	if (_incremental)
+		return *_gaps.begin();
+	if (_bounded)
+		return _boundedShortest();
+	
+	if (_sortedCount == _numbers.size())
+	{
+		PROFILE_EVENT(EVENT_CACHED_QUERIES);
+		return _shortest;
+	}
+	
+	// Sort only what arrived since the last query, then merge it in
+	size_t middle = _sortedView.size();
+	_sortedView.insert(_sortedView.end(), _numbers.begin() + _sortedCount, _numbers.end());
+	_sortValues(&_sortedView[0] + middle, _sortedView.size() - middle);
+	std::inplace_merge(_sortedView.begin(), _sortedView.begin() + middle, _sortedView.end());
+	_sortedCount = _numbers.size();
+	_shortest = _smallestGap(&_sortedView[0], _sortedView.size());
+	return _shortest;
+}
+
+// Find longest span
+template <typename T>
+typename BasicSpan<T>::Result BasicSpan<T>::longestSpan(void)
+{
+	PROFILE_SCOPE(PHASE_LONGEST_SPAN);
+	if (_numbers.size() <= 1)
+		throw SpanException();
+	
+	return _gap(_min, _max);
+}
+
+// The new tail goes through the same bookkeeping as addNumber
+template <typename T>
+void BasicSpan<T>::_appended(size_t from)
+{
+	if (from == _numbers.size())
+		return;
+	T oldMin = _min;
+	T oldMax = _max;
+	T lo;
+	T hi;
+	_extremes(&_numbers[from], _numbers.size() - from, lo, hi);
+	if (_bounded && (lo < _domainMin || hi > _domainMax))
+	{
+		_numbers.resize(from);
+		throw SpanException();
+	}
+	if (from == 0 || lo < _min)
+		_min = lo;
+	if (from == 0 || hi > _max)
+		_max = hi;
+	if (_bounded)
+	{
+		for (size_t i = from; i < _numbers.size(); i++)
+			_insertBit(_numbers[i]);
+	}
+	if (!_incremental)
+		return;
+	try
+	{
+		for (size_t i = from; i < _numbers.size(); i++)
+			_insertSorted(_numbers[i]);
+	}
+	catch (...)
+	{
+		// Out of memory part way: put everything back as it was
+		_numbers.resize(from);
+		_min = oldMin;
+		_max = oldMax;
+		setIncremental(true);
+		throw;
+	}
+}
+
+// Turn incremental mode on or off
+template <typename T>
+void BasicSpan<T>::setIncremental(bool enabled)
+{
+	if (enabled)
+		clearDomain();
+	_incremental = enabled;
+	_sorted.clear();
+	_gaps.clear();
+	std::vector<T>().swap(_sortedView);
+	_sortedCount = 0;
+	if (_incremental)
+	{
+		for (size_t i = 0; i < _numbers.size(); i++)
+			_insertSorted(_numbers[i]);
+	}
+}
+
+template <typename T>
+bool BasicSpan<T>::isIncremental(void) const
+{
+	return _incremental;
+}
+
+// Build the bitset from the numbers so far
+template <typename T>
+void BasicSpan<T>::setDomain(const T &lo, const T &hi)
+{
+	if (hi < lo || (!_numbers.empty() && (_min < lo || _max > hi)))
+		throw SpanException();
+	std::vector<Word> bits(static_cast<size_t>(_gap(lo, hi)) / WORD_BITS + 1);
+	setIncremental(false);
+	_bits.swap(bits);
+	_bounded = true;
+	_domainMin = lo;
+	_domainMax = hi;
+	_repeated = false;
+	for (size_t i = 0; i < _numbers.size(); i++)
+		_insertBit(_numbers[i]);
+}
+
+template <typename T>
+void BasicSpan<T>::clearDomain(void)
+{
+	if (!_bounded)
+		return;
+	_bounded = false;
+	std::vector<Word>().swap(_bits);
+	_repeated = false;
+	_sortedCount = 0;
+}
+
+template <typename T>
+bool BasicSpan<T>::isBounded(void) const
+{
+	return _bounded;
+}
+
+template <typename T>
+void BasicSpan<T>::setParallel(bool enabled)
+{
+	_parallel = enabled;
+}
+
+template <typename T>
+bool BasicSpan<T>::isParallel(void) const
+{
+	return _parallel;
+}
+
+template <typename T>
+unsigned int BasicSpan<T>::_ctz(Word x)
+{
+#if defined(__GNUC__)
+	return __builtin_ctzll(x);
+#else
+	unsigned int n = 0;
+	for (; !(x & 1); x >>= 1)
+		n++;
+	return n;
+#endif
+}
+
+template <typename T>
+unsigned int BasicSpan<T>::_clz(Word x)
+{
+#if defined(__GNUC__)
+	return __builtin_clzll(x);
+#else
+	unsigned int n = 0;
+	for (; !(x >> (WORD_BITS - 1)); x <<= 1)
+		n++;
+	return n;
+#endif
+}
+
+template <typename T>
+void BasicSpan<T>::_insertBit(const T &number)
+{
+	size_t i = static_cast<size_t>(_gap(_domainMin, number));
+	Word bit = Word(1) << (i % WORD_BITS);
+	if (_bits[i / WORD_BITS] & bit)
+		_repeated = true;
+	_bits[i / WORD_BITS] |= bit;
+}
+
+// Each set bit is taken off its word with one ctz, so the scan costs a
+// step per word plus one per number; a gap of 1 is the least there is
+template <typename T>
+size_t BasicSpan<T>::_scanBits(void) const
+{
+	size_t best = static_cast<size_t>(-1);
+	size_t prev = 0;
+	bool seen = false;
+	for (size_t w = 0; w < _bits.size(); w++)
+	{
+		for (Word x = _bits[w]; x; x &= x - 1)
+		{
+			size_t pos = w * WORD_BITS + _ctz(x);
+			if (seen && pos - prev < best)
+			{
+				best = pos - prev;
+				if (best == 1)
+					return best;
+			}
+			prev = pos;
+			seen = true;
+		}
+	}
+	return best;
+}
+
+// The nearest bit above is the lowest one left after masking, found with
+// ctz; the nearest below the highest one, found with clz
+template <typename T>
+size_t BasicSpan<T>::_gapAround(size_t i, size_t limit) const
+{
+	size_t w = i / WORD_BITS;
+	Word x = _bits[w] & (~Word(0) << (i % WORD_BITS) << 1);
+	while (true)
+	{
+		if (x)
+		{
+			size_t d = w * WORD_BITS + _ctz(x) - i;
+			limit = d < limit ? d : limit;
+			break;
+		}
+		if (++w == _bits.size() || w * WORD_BITS - i >= limit)
+			break;
+		x = _bits[w];
+	}
+	w = i / WORD_BITS;
+	x = _bits[w] & ((Word(1) << (i % WORD_BITS)) - 1);
+	while (true)
+	{
+		if (x)
+		{
+			size_t d = i - (w * WORD_BITS + WORD_BITS - 1 - _clz(x));
+			limit = d < limit ? d : limit;
+			break;
+		}
+		if (w == 0 || i - (w * WORD_BITS - 1) >= limit)
+			break;
+		x = _bits[--w];
+	}
+	return limit;
+}
+
+// A new number can only shorten the answer with a neighbour closer than
+// it, so after a few new numbers only the words within the previous
+// answer around each are read; a full scan when that would cost more
+template <typename T>
+typename BasicSpan<T>::Result BasicSpan<T>::_boundedShortest(void)
+{
+	if (_repeated)
+		return Result();
+	if (_sortedCount == _numbers.size())
+	{
+		PROFILE_EVENT(EVENT_CACHED_QUERIES);
+		return _shortest;
+	}
+	
+	size_t best;
+	size_t added = _numbers.size() - _sortedCount;
+	if (_sortedCount >= 2 && added < _bits.size() / (2 * (static_cast<size_t>(_shortest) / WORD_BITS + 2)))
+	{
+		best = static_cast<size_t>(_shortest);
+		for (size_t i = _sortedCount; i < _numbers.size() && best > 1; i++)
+			best = _gapAround(static_cast<size_t>(_gap(_domainMin, _numbers[i])), best);
+	}
+	else
+		best = _scanBits();
+	_sortedCount = _numbers.size();
+	_shortest = static_cast<Result>(best);
+	return _shortest;
+}
+
+// Getter for size
+template <typename T>
+unsigned int BasicSpan<T>::size(void) const
+{
+	return _numbers.size();
+}
+
+// Getter for max size
+template <typename T>
+unsigned int BasicSpan<T>::getMaxSize(void) const
+{
+	return _maxSize;
+}
+
 #endif
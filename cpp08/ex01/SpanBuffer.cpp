@@ -0,0 +1,53 @@
+#include "SpanBuffer.hpp"
+
+// Constructor
+SpanBuffer::SpanBuffer(Span &span, size_t batch) : _span(&span), _batch(batch == 0 ? 1 : batch)
+{
+	_pending.reserve(_batch);
+}
+
+// Copy constructor
+SpanBuffer::SpanBuffer(const SpanBuffer &other) : _span(other._span), _batch(other._batch),
+	_pending(other._pending)
+{
+}
+
+// Assignment operator
+SpanBuffer &SpanBuffer::operator=(const SpanBuffer &other)
+{
+	if (this != &other)
+	{
+		_span = other._span;
+		_batch = other._batch;
+		_pending = other._pending;
+	}
+	return *this;
+}
+
+// Destructor
+SpanBuffer::~SpanBuffer(void)
+{
+}
+
+// Buffer a number
+void SpanBuffer::addNumber(int number)
+{
+	_pending.push_back(number);
+	if (_pending.size() >= _batch)
+		flush();
+}
+
+// Hand the batch to the Span
+void SpanBuffer::flush(void)
+{
+	if (_pending.empty())
+		return;
+	_span->addNumbers(_pending.begin(), _pending.end());
+	_pending.clear();
+}
+
+// Getter for pending
+size_t SpanBuffer::pending(void) const
+{
+	return _pending.size();
+}
@@ -0,0 +1,49 @@
+#ifndef SPANBUFFER_HPP
+#define SPANBUFFER_HPP
+
+#include <vector>
+#include "Span.hpp"
+
+// Producer-side buffer for a shared Span: numbers collect here and reach
+// the Span a batch at a time through one addNumbers call. With several
+// producers, each keeps its own buffer and only flush() has to hold the
+// lock that guards the Span, once per batch instead of once per number;
+// SharedSpan is that arrangement for threads, lock included. Call
+// flush() before the buffer goes away: pending numbers are not written
+// by the destructor
+class SpanBuffer
+{
+	private:
+		Span *_span;
+		size_t _batch;
+		std::vector<int> _pending;
+		
+		// Private default constructor
+		SpanBuffer(void);
+		
+	public:
+		// Constructor; flushes by itself every batch numbers (at least 1)
+		SpanBuffer(Span &span, size_t batch);
+		
+		// Copy constructor
+		SpanBuffer(const SpanBuffer &other);
+		
+		// Assignment operator
+		SpanBuffer &operator=(const SpanBuffer &other);
+		
+		// Destructor
+		~SpanBuffer(void);
+		
+		// Buffer a number, flushing when the batch is full
+		void addNumber(int number);
+		
+		// Add every pending number to the Span at once. When they do not
+		// all fit, none are added, they stay pending and SpanException is
+		// thrown (see Span::addNumbers)
+		void flush(void);
+		
+		// Numbers not yet in the Span
+		size_t pending(void) const;
+};
+
+#endif
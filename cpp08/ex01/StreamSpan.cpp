@@ -0,0 +1,125 @@
+#include "StreamSpan.hpp"
+
+// Constructor
+StreamSpan::StreamSpan(unsigned int window) : _window(window < 2 ? 2 : window), _seen(0)
+{
+}
+
+// Copy constructor
+StreamSpan::StreamSpan(const StreamSpan &other) : _window(other._window), _seen(other._seen),
+	_numbers(other._numbers), _sorted(other._sorted), _gaps(other._gaps)
+{
+}
+
+// Assignment operator
+StreamSpan &StreamSpan::operator=(const StreamSpan &other)
+{
+	if (this != &other)
+	{
+		_window = other._window;
+		_seen = other._seen;
+		_numbers = other._numbers;
+		_sorted = other._sorted;
+		_gaps = other._gaps;
+	}
+	return *this;
+}
+
+// Destructor
+StreamSpan::~StreamSpan(void)
+{
+}
+
+unsigned int StreamSpan::_gap(int a, int b)
+{
+	return static_cast<unsigned int>(b) - static_cast<unsigned int>(a);
+}
+
+// The new value splits the gap between its neighbours in two
+void StreamSpan::_insert(int number)
+{
+	std::multiset<int>::iterator it = _sorted.insert(number);
+	std::multiset<int>::iterator next = it;
+	++next;
+	bool hasPrev = it != _sorted.begin();
+	bool hasNext = next != _sorted.end();
+	if (hasPrev)
+	{
+		std::multiset<int>::iterator prev = it;
+		--prev;
+		if (hasNext)
+			_gaps.erase(_gaps.find(_gap(*prev, *next)));
+		_gaps.insert(_gap(*prev, number));
+	}
+	if (hasNext)
+		_gaps.insert(_gap(number, *next));
+}
+
+// The reverse: the two gaps around the value become one. Equal values
+// are interchangeable, so any copy of it will do
+void StreamSpan::_erase(int number)
+{
+	std::multiset<int>::iterator it = _sorted.find(number);
+	std::multiset<int>::iterator next = it;
+	++next;
+	bool hasPrev = it != _sorted.begin();
+	bool hasNext = next != _sorted.end();
+	if (hasPrev)
+	{
+		std::multiset<int>::iterator prev = it;
+		--prev;
+		_gaps.erase(_gaps.find(_gap(*prev, number)));
+		if (hasNext)
+			_gaps.insert(_gap(*prev, *next));
+	}
+	if (hasNext)
+		_gaps.erase(_gaps.find(_gap(number, *next)));
+	_sorted.erase(it);
+}
+
+// Add a number to the window
+void StreamSpan::addNumber(int number)
+{
+	if (_numbers.size() == _window)
+	{
+		_erase(_numbers.front());
+		_numbers.pop_front();
+	}
+	_numbers.push_back(number);
+	_insert(number);
+	_seen++;
+}
+
+// Find shortest span in the window
+unsigned int StreamSpan::shortestSpan(void) const
+{
+	if (_numbers.size() <= 1)
+		throw SpanException();
+	return *_gaps.begin();
+}
+
+// Find longest span in the window
+unsigned int StreamSpan::longestSpan(void) const
+{
+	if (_numbers.size() <= 1)
+		throw SpanException();
+	return _gap(*_sorted.begin(), *_sorted.rbegin());
+}
+
+// Getter for size
+unsigned int StreamSpan::size(void) const
+{
+	return _numbers.size();
+}
+
+// Getter for window
+unsigned int StreamSpan::getWindow(void) const
+{
+	return _window;
+}
+
+// Getter for seen
+unsigned long StreamSpan::getSeen(void) const
+{
+	return _seen;
+}
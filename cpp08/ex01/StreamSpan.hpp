@@ -0,0 +1,62 @@
+#ifndef STREAMSPAN_HPP
+#define STREAMSPAN_HPP
+
+#include <deque>
+#include <set>
+#include "Span.hpp"
+
+// Span over an unbounded stream: only the last window values are kept,
+// so memory stays bounded and addNumber never throws for being full.
+// Both spans are exact over the window
+class StreamSpan
+{
+	private:
+		unsigned int _window;
+		unsigned long _seen;
+		
+		// Window in arrival order, the same values in order, and the gaps
+		// between neighbours in that order
+		std::deque<int> _numbers;
+		std::multiset<int> _sorted;
+		std::multiset<unsigned int> _gaps;
+		
+		static unsigned int _gap(int a, int b);
+		
+		void _insert(int number);
+		void _erase(int number);
+		
+		// Private default constructor
+		StreamSpan(void);
+		
+	public:
+		// Constructor; a window of at least 2 numbers
+		StreamSpan(unsigned int window);
+		
+		// Copy constructor
+		StreamSpan(const StreamSpan &other);
+		
+		// Assignment operator
+		StreamSpan &operator=(const StreamSpan &other);
+		
+		// Destructor
+		~StreamSpan(void);
+		
+		// Add a number, dropping the oldest one once the window is full;
+		// O(log window)
+		void addNumber(int number);
+		
+		// Spans of the numbers in the window, O(1); SpanException with
+		// fewer than 2
+		unsigned int shortestSpan(void) const;
+		unsigned int longestSpan(void) const;
+		
+		// Numbers in the window
+		unsigned int size(void) const;
+		
+		unsigned int getWindow(void) const;
+		
+		// Numbers added since construction
+		unsigned long getSeen(void) const;
+};
+
+#endif
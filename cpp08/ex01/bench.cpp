@@ -0,0 +1,183 @@
+#include "Span.hpp"
+#include <iomanip>
+#include <cstdlib>
+#include <algorithm>
+#include <climits>
+#include <time.h>
+#include <sys/resource.h>
+
+// Benchmark harness for Span: fills Spans of 10^3 up to 10^max numbers
+// from several distributions and times addNumbers, the first queries and
+// a loop of small appends each followed by a query, for the default
+// (cached sorted view), incremental and bounded (bitset) modes against
+// sorting on every call. Reports throughput and the peak resident size of the process
+
+static unsigned int g_seed = 42;
+
+static unsigned int nextRandom(void)
+{
+	g_seed = g_seed * 1103515245u + 12345u;
+	return g_seed;
+}
+
+// Monotonic wall clock in seconds
+static double now(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+// Peak resident size so far, in MiB
+static double peakMiB(void)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss / 1024.0;
+}
+
+enum Distribution
+{
+	DIST_UNIFORM,
+	DIST_NARROW,
+	DIST_SORTED,
+	DIST_REVERSED,
+	DIST_COUNT
+};
+
+static const char *DIST_NAMES[DIST_COUNT] = {"uniform", "narrow", "sorted", "reversed"};
+
+static void fill(std::vector<int> &values, Distribution dist)
+{
+	for (size_t i = 0; i < values.size(); i++)
+	{
+		switch (dist)
+		{
+			case DIST_UNIFORM:
+				values[i] = static_cast<int>(nextRandom());
+				break;
+			case DIST_NARROW:
+				values[i] = static_cast<int>(nextRandom() % 1000);
+				break;
+			case DIST_SORTED:
+				values[i] = static_cast<int>(i * 3 - values.size());
+				break;
+			default:
+				values[i] = static_cast<int>(values.size() - i * 3);
+				break;
+		}
+	}
+}
+
+// shortestSpan as it was first written: copy, sort, scan on every call
+static unsigned int sortEveryCall(const std::vector<int> &numbers)
+{
+	std::vector<int> sorted = numbers;
+	std::sort(sorted.begin(), sorted.end());
+	unsigned int shortest = UINT_MAX;
+	for (size_t i = 0; i + 1 < sorted.size(); i++)
+	{
+		unsigned int diff = static_cast<unsigned int>(sorted[i + 1]) - static_cast<unsigned int>(sorted[i]);
+		if (diff < shortest)
+			shortest = diff;
+	}
+	return shortest;
+}
+
+static volatile unsigned long g_sink = 0;
+
+static void row(const char *label, double seconds, double items, const char *unit)
+{
+	std::cout << "  " << std::left << std::setw(30) << label << std::right << std::fixed << std::setprecision(3)
+	          << std::setw(12) << seconds * 1e3 << " ms" << std::setprecision(1) << std::setw(16)
+	          << (seconds > 0 ? items / seconds : 0) << " " << unit << "/s" << std::endl;
+}
+
+// The same work for one mode: bulk fill, first queries, then appends
+// of batch numbers each followed by both queries
+enum Mode
+{
+	MODE_CACHED,
+	MODE_INCREMENTAL,
+	MODE_BOUNDED
+};
+
+static void runMode(const char *mode, const std::vector<int> &values, size_t queries, size_t batch, Mode kind)
+{
+	size_t n = values.size() - queries * batch;
+	Span span(values.size());
+	span.setIncremental(kind == MODE_INCREMENTAL);
+	if (kind == MODE_BOUNDED)
+		span.setDomain(*std::min_element(values.begin(), values.end()),
+			*std::max_element(values.begin(), values.end()));
+	
+	double start = now();
+	span.addNumbers(values.begin(), values.begin() + n);
+	row((std::string(mode) + " addNumbers").c_str(), now() - start, n, "num");
+	
+	start = now();
+	g_sink += span.shortestSpan();
+	row((std::string(mode) + " first shortestSpan").c_str(), now() - start, 1, "query");
+	
+	start = now();
+	g_sink += span.longestSpan();
+	row((std::string(mode) + " first longestSpan").c_str(), now() - start, 1, "query");
+	
+	start = now();
+	for (size_t q = 0; q < queries; q++)
+	{
+		size_t from = n + q * batch;
+		span.addNumbers(values.begin() + from, values.begin() + from + batch);
+		g_sink += span.shortestSpan() + span.longestSpan();
+	}
+	row((std::string(mode) + " append+query loop").c_str(), now() - start, queries, "query");
+}
+
+int main(int argc, char **argv)
+{
+	int maxExponent = argc > 1 ? std::atoi(argv[1]) : 6;
+	size_t queries = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 100;
+	size_t batch = argc > 3 ? std::strtoul(argv[3], NULL, 10) : 10;
+	if (maxExponent < 3 || maxExponent > 9 || batch == 0)
+	{
+		std::cerr << "Usage: " << argv[0] << " [max exponent 3..9] [queries] [batch]" << std::endl;
+		return 1;
+	}
+	
+	std::cout << "Spans of 10^3 to 10^" << maxExponent << " numbers; " << queries << " queries after appends of "
+	          << batch << std::endl;
+	size_t n = 1000;
+	for (int e = 3; e <= maxExponent; e++, n *= 10)
+	{
+		for (int d = 0; d < DIST_COUNT; d++)
+		{
+			std::vector<int> values(n + queries * batch);
+			fill(values, static_cast<Distribution>(d));
+			std::cout << "n = " << n << ", " << DIST_NAMES[d] << std::endl;
+			
+			// The baseline only gets a few queries: each one is a full sort
+			size_t baselineQueries = queries < 5 ? queries : 5;
+			std::vector<int> numbers(values.begin(), values.begin() + n);
+			double start = now();
+			for (size_t q = 0; q < baselineQueries; q++)
+			{
+				numbers.insert(numbers.end(), values.begin() + n + q * batch, values.begin() + n + (q + 1) * batch);
+				g_sink += sortEveryCall(numbers);
+			}
+			row("sort every call, per query", (now() - start) / (baselineQueries ? baselineQueries : 1), 1, "query");
+			
+			// The incremental sets cost far more memory than the numbers
+			runMode("cached view", values, queries, batch, MODE_CACHED);
+			if (e <= 7)
+				runMode("incremental", values, queries, batch, MODE_INCREMENTAL);
+			
+			// One bit per value of the domain: only where it is a few bits per number
+			unsigned int domain = static_cast<unsigned int>(*std::max_element(values.begin(), values.end()))
+				- static_cast<unsigned int>(*std::min_element(values.begin(), values.end()));
+			if (domain / 64 <= values.size())
+				runMode("bounded", values, queries, batch, MODE_BOUNDED);
+			std::cout << "  peak memory " << std::setprecision(1) << peakMiB() << " MiB" << std::endl;
+		}
+	}
+	return 0;
+}
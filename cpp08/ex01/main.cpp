@@ -1,10 +1,30 @@
 #include <iostream>
 #include "Span.hpp"
+#include "StreamSpan.hpp"
+#include "SpanBuffer.hpp"
+#include "SharedSpan.hpp"
 #include <cstdlib>
 #include <ctime>
 
+// Producer thread for the shared span test: 2,500 numbers through its
+// own Producer
+static void *produce(void *arg)
+{
+	SharedSpan *shared = static_cast<SharedSpan *>(arg);
+	SharedSpan::Producer producer(*shared, 128);
+	unsigned int seed = static_cast<unsigned int>(reinterpret_cast<size_t>(&producer));
+	for (int i = 0; i < 2500; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		producer.addNumber(static_cast<int>(seed >> 8));
+	}
+	return NULL;
+}
+
 int main(void)
 {
+	PROFILE_PROGRAM();
+	
 	// Test basic example from subject
 	std::cout << "=== Basic Test ===" << std::endl;
 	Span sp = Span(5);
@@ -74,5 +94,134 @@ int main(void)
 	std::cout << "Shortest span: " << iter.shortestSpan() << std::endl;
 	std::cout << "Longest span: " << iter.longestSpan() << std::endl;
 	
+	// A range that does not fit adds nothing
+	Span small = Span(5);
+	try
+	{
+		small.addNumbers(arr, arr + 10);
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Range overflow exception caught: " << e.what() << ", size " << small.size() << std::endl;
+	}
+	
+	// Test incremental mode, querying after every insert
+	std::cout << "\n=== Incremental Test ===" << std::endl;
+	Span inc = Span(10000);
+	inc.setIncremental(true);
+	for (int i = 0; i < 10000; i++)
+	{
+		inc.addNumber(rand() % 100000);
+		if (i > 0)
+			inc.shortestSpan();
+	}
+	std::cout << "Added " << inc.size() << " numbers" << std::endl;
+	std::cout << "Shortest span: " << inc.shortestSpan() << std::endl;
+	std::cout << "Longest span: " << inc.longestSpan() << std::endl;
+	
+	// Test bounded mode: codes known to be in 0..2^20, kept as bits
+	std::cout << "\n=== Bounded Test (domain 0..2^20) ===" << std::endl;
+	Span codes = Span(10000);
+	codes.setDomain(0, 1 << 20);
+	for (int i = 0; i < 10000; i++)
+		codes.addNumber(rand() % (1 << 20));
+	std::cout << "Added " << codes.size() << " numbers" << std::endl;
+	std::cout << "Shortest span: " << codes.shortestSpan() << std::endl;
+	std::cout << "Longest span: " << codes.longestSpan() << std::endl;
+	try
+	{
+		codes.addNumber(-1);
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Out of domain exception caught: " << e.what() << std::endl;
+	}
+	
+	// Test parallel mode against the default one on the same numbers
+	std::cout << "\n=== Parallel Test ===" << std::endl;
+	std::vector<int> many(300000);
+	for (size_t i = 0; i < many.size(); i++)
+		many[i] = rand();
+	Span serial = Span(many.size());
+	Span parallel = Span(many.size());
+	parallel.setParallel(true);
+	serial.addNumbers(many.begin(), many.end());
+	parallel.addNumbers(many.begin(), many.end());
+	std::cout << "Added " << parallel.size() << " numbers" << std::endl;
+	std::cout << "Shortest span: " << parallel.shortestSpan()
+	          << (parallel.shortestSpan() == serial.shortestSpan() ? " (same)" : " (differs)") << std::endl;
+	std::cout << "Longest span: " << parallel.longestSpan()
+	          << (parallel.longestSpan() == serial.longestSpan() ? " (same)" : " (differs)") << std::endl;
+	
+	// Test other value types: 64-bit timestamps and float prices
+	std::cout << "\n=== Typed Test ===" << std::endl;
+	BasicSpan<long long> stamps = BasicSpan<long long>(3);
+	stamps.addNumber(-9000000000000000000LL);
+	stamps.addNumber(1700000000000LL);
+	stamps.addNumber(9000000000000000000LL);
+	std::cout << "int64 shortest span: " << stamps.shortestSpan() << std::endl;
+	std::cout << "int64 longest span: " << stamps.longestSpan() << std::endl;
+	BasicSpan<float> prices = BasicSpan<float>(4);
+	float ticks[] = {101.25f, 100.5f, 101.0f, 99.75f};
+	prices.addNumbers(ticks, ticks + 4);
+	std::cout << "float shortest span: " << prices.shortestSpan() << std::endl;
+	std::cout << "float longest span: " << prices.longestSpan() << std::endl;
+	
+	// Test streaming: far more numbers than the window holds
+	std::cout << "\n=== Stream Test (window of 1,000) ===" << std::endl;
+	StreamSpan stream = StreamSpan(1000);
+	for (int i = 0; i < 100000; i++)
+		stream.addNumber(rand() % 100000);
+	std::cout << "Seen " << stream.getSeen() << ", kept " << stream.size() << std::endl;
+	std::cout << "Shortest span: " << stream.shortestSpan() << std::endl;
+	std::cout << "Longest span: " << stream.longestSpan() << std::endl;
+	
+	// Test buffered producers sharing one Span
+	std::cout << "\n=== Buffer Test (3 producers) ===" << std::endl;
+	Span shared = Span(10000);
+	SpanBuffer producers[3] = {SpanBuffer(shared, 256), SpanBuffer(shared, 256), SpanBuffer(shared, 256)};
+	for (int i = 0; i < 9999; i++)
+		producers[i % 3].addNumber(rand() % 100000);
+	std::cout << "Before flush: " << shared.size() << " numbers" << std::endl;
+	for (int p = 0; p < 3; p++)
+		producers[p].flush();
+	std::cout << "After flush: " << shared.size() << " numbers" << std::endl;
+	std::cout << "Shortest span: " << shared.shortestSpan() << std::endl;
+	try
+	{
+		for (int i = 0; i < 2; i++)
+			producers[0].addNumber(i);
+		producers[0].flush();
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Full span exception caught: " << e.what() << ", pending "
+		          << producers[0].pending() << std::endl;
+	}
+	
+	// Test producer threads sharing one span, each with its own buffer
+	std::cout << "\n=== Shared Test (4 threads) ===" << std::endl;
+	SharedSpan readings(10000);
+	pthread_t threads[4];
+	for (int t = 0; t < 4; t++)
+		pthread_create(&threads[t], NULL, produce, &readings);
+	for (int t = 0; t < 4; t++)
+		pthread_join(threads[t], NULL);
+	Span copy = readings.snapshot();
+	std::cout << "Added " << readings.size() << " numbers, reserved " << readings.reserved() << std::endl;
+	std::cout << "Shortest span: " << readings.shortestSpan()
+	          << (readings.shortestSpan() == copy.shortestSpan() ? " (same as snapshot)" : " (differs)") << std::endl;
+	std::cout << "Longest span: " << readings.longestSpan()
+	          << (readings.longestSpan() == copy.longestSpan() ? " (same as snapshot)" : " (differs)") << std::endl;
+	try
+	{
+		SharedSpan::Producer late(readings, 16);
+		late.addNumber(0);
+	}
+	catch (const std::exception &e)
+	{
+		std::cout << "Full shared span exception caught: " << e.what() << std::endl;
+	}
+	
 	return 0;
 }
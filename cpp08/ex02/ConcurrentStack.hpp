@@ -0,0 +1,194 @@
+#ifndef CONCURRENTSTACK_HPP
+#define CONCURRENTSTACK_HPP
+
+#include <cstddef>
+#include <vector>
+#include "MutantStack.hpp"
+
+// Lock-free stack for producer and consumer threads: a Treiber stack, a
+// linked list from the top down whose head is only ever changed by
+// compare-and-swap (GCC __sync builtins, full barriers). A node's next
+// never changes once pushed, so the list below any head read is a
+// consistent stack, and snapshot() copies it into a MutantStack to
+// iterate bottom to top like any other. Popped nodes are freed by the
+// last thread to leave pop or snapshot: while any is inside, they wait on
+// a pending list, so no thread ever reads a freed node and no address is
+// reused under a compare-and-swap in progress (no ABA). Under constant
+// overlap the pending list only shrinks once the threads drain out
+template <typename T>
+class ConcurrentStack
+{
+	private:
+		struct Node
+		{
+			T value;
+			Node *next;
+			Node *pendingNext;	// the pending list; next stays as it was for readers still on it
+			
+			Node(const T &v) : value(v), next(NULL), pendingNext(NULL)
+			{
+			}
+		};
+		
+		Node *volatile _head;
+		volatile size_t _size;
+		
+		// Threads inside pop or snapshot, and the nodes popped while more
+		// than one was
+		volatile size_t _readers;
+		Node *volatile _pending;
+		
+		// Atomic reads: a compare-and-swap that changes nothing
+		static Node *_load(Node *volatile &p)
+		{
+			return __sync_val_compare_and_swap(&p, static_cast<Node *>(NULL), static_cast<Node *>(NULL));
+		}
+		
+		static size_t _load(const volatile size_t &n)
+		{
+			return __sync_fetch_and_add(const_cast<volatile size_t *>(&n), 0);
+		}
+		
+		static void _deleteList(Node *node, Node *Node::*link)
+		{
+			while (node)
+			{
+				Node *next = node->*link;
+				delete node;
+				node = next;
+			}
+		}
+		
+		// Put the chain first..last on the pending list
+		void _defer(Node *first, Node *last)
+		{
+			Node *seen = _load(_pending);
+			for (;;)
+			{
+				last->pendingNext = seen;
+				Node *now = __sync_val_compare_and_swap(&_pending, seen, first);
+				if (now == seen)
+					return;
+				seen = now;
+			}
+		}
+		
+		void _deferList(Node *list)
+		{
+			if (!list)
+				return;
+			Node *last = list;
+			while (last->pendingNext)
+				last = last->pendingNext;
+			_defer(list, last);
+		}
+		
+		void _enter(void) const
+		{
+			__sync_fetch_and_add(const_cast<volatile size_t *>(&_readers), 1);
+		}
+		
+		// Leave pop or snapshot, freeing node (NULL for none) and whatever
+		// is pending when no other thread is inside. A thread that enters
+		// after the pending list was taken only sees nodes off the stack
+		void _leave(Node *node)
+		{
+			if (_load(_readers) == 1)
+			{
+				Node *list = __sync_lock_test_and_set(&_pending, static_cast<Node *>(NULL));
+				__sync_synchronize();
+				if (__sync_sub_and_fetch(&_readers, 1) == 0)
+					_deleteList(list, &Node::pendingNext);
+				else
+					_deferList(list);
+				delete node;
+			}
+			else
+			{
+				if (node)
+					_defer(node, node);
+				__sync_sub_and_fetch(&_readers, 1);
+			}
+		}
+		
+		// Atomic head and counters cannot be copied: no copies
+		ConcurrentStack(const ConcurrentStack &other);
+		ConcurrentStack &operator=(const ConcurrentStack &other);
+		
+	public:
+		// Constructor
+		ConcurrentStack(void) : _head(NULL), _size(0), _readers(0), _pending(NULL)
+		{
+		}
+		
+		// Destructor; no thread may still be using the stack
+		~ConcurrentStack(void)
+		{
+			_deleteList(_head, &Node::next);
+			_deleteList(_pending, &Node::pendingNext);
+		}
+		
+		void push(const T &value)
+		{
+			Node *node = new Node(value);
+			Node *seen = _load(_head);
+			for (;;)
+			{
+				node->next = seen;
+				Node *now = __sync_val_compare_and_swap(&_head, seen, node);
+				if (now == seen)
+					break;
+				seen = now;
+			}
+			__sync_fetch_and_add(&_size, 1);
+		}
+		
+		// Take the top element into value; false when the stack is empty
+		bool pop(T &value)
+		{
+			_enter();
+			Node *node = _load(_head);
+			for (;;)
+			{
+				if (!node)
+					break;
+				Node *now = __sync_val_compare_and_swap(&_head, node, node->next);
+				if (now == node)
+					break;
+				node = now;
+			}
+			if (node)
+			{
+				value = node->value;
+				__sync_fetch_and_sub(&_size, 1);
+			}
+			_leave(node);
+			return node != NULL;
+		}
+		
+		// The stack at one instant, bottom first like MutantStack::begin()
+		MutantStack<T> snapshot(void)
+		{
+			_enter();
+			std::vector<T> values;
+			for (Node *node = _load(_head); node; node = node->next)
+				values.push_back(node->value);
+			_leave(NULL);
+			MutantStack<T> copy;
+			copy.push_range(values.rbegin(), values.rend());
+			return copy;
+		}
+		
+		// Counts as of some instant during the call
+		bool empty(void) const
+		{
+			return _load(const_cast<Node *volatile &>(_head)) == NULL;
+		}
+		
+		size_t size(void) const
+		{
+			return _load(_size);
+		}
+};
+
+#endif
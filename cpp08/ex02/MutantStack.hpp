@@ -2,26 +2,73 @@
 #define MUTANTSTACK_HPP
 
 #include <stack>
+#include <deque>
+#include <iterator>
+#include <algorithm>
+#include "SmallVector.hpp"
 
-template <typename T>
-class MutantStack : public std::stack<T>
+// Iterable stack. Container is any sequence std::stack accepts that also
+// iterates: std::deque (the default), std::vector, std::list, or
+// SmallVector to keep shallow stacks off the heap. Like the standard
+// containers it is not thread-safe: a stack shared between threads needs
+// a lock around every call, or ConcurrentStack, the lock-free variant
+// whose snapshots are MutantStacks
+template <typename T, typename Container = std::deque<T> >
+class MutantStack : public std::stack<T, Container>
 {
 	public:
 		// Using inherited constructor
-		MutantStack(void) : std::stack<T>()
+		MutantStack(void) : std::stack<T, Container>()
 		{
 		}
 		
+		// Copy constructor
+		MutantStack(const MutantStack &other) : std::stack<T, Container>(other)
+		{
+		}
+		
+		// Assignment operator
+		MutantStack &operator=(const MutantStack &other)
+		{
+			std::stack<T, Container>::operator=(other);
+			return *this;
+		}
+		
 		// Destructor
 		~MutantStack(void)
 		{
 		}
 		
+		// Push every element of [first, last) in order, so *(last - 1) ends
+		// on top, with one range insert into the container instead of one
+		// push per element
+		template <typename Iterator>
+		void push_range(Iterator first, Iterator last)
+		{
+			this->c.insert(this->c.end(), first, last);
+		}
+		
+		// Pop up to n elements (all of them when there are fewer), writing
+		// them to out in the order single pops would return them, top first;
+		// the container then drops them with one erase
+		template <typename OutputIterator>
+		OutputIterator pop_n(size_t n, OutputIterator out)
+		{
+			if (n > this->c.size())
+				n = this->c.size();
+			typename Container::iterator first = this->c.end();
+			std::advance(first, -static_cast<typename Container::difference_type>(n));
+			out = std::copy(typename Container::reverse_iterator(this->c.end()),
+				typename Container::reverse_iterator(first), out);
+			this->c.erase(first, this->c.end());
+			return out;
+		}
+		
 		// Define iterator types using the underlying container
-		typedef typename std::stack<T>::container_type::iterator iterator;
-		typedef typename std::stack<T>::container_type::const_iterator const_iterator;
-		typedef typename std::stack<T>::container_type::reverse_iterator reverse_iterator;
-		typedef typename std::stack<T>::container_type::const_reverse_iterator const_reverse_iterator;
+		typedef typename Container::iterator iterator;
+		typedef typename Container::const_iterator const_iterator;
+		typedef typename Container::reverse_iterator reverse_iterator;
+		typedef typename Container::const_reverse_iterator const_reverse_iterator;
 		
 		// Iterator methods
 		iterator begin(void)
@@ -63,6 +110,60 @@ class MutantStack : public std::stack<T>
 		{
 			return this->c.rend();
 		}
+		
+		// The elements between two iterators, for a loop over begin()..end()
+		template <typename Iterator>
+		class Range
+		{
+			private:
+				Iterator _first;
+				Iterator _last;
+				
+			public:
+				Range(Iterator first, Iterator last) : _first(first), _last(last)
+				{
+				}
+				
+				Iterator begin(void) const
+				{
+					return _first;
+				}
+				
+				Iterator end(void) const
+				{
+					return _last;
+				}
+				
+				size_t size(void) const
+				{
+					return std::distance(_first, _last);
+				}
+		};
+		
+		// The stack from the top down, in the order pops would return it
+		Range<reverse_iterator> top_down(void)
+		{
+			return Range<reverse_iterator>(this->c.rbegin(), this->c.rend());
+		}
+		
+		Range<const_reverse_iterator> top_down(void) const
+		{
+			return Range<const_reverse_iterator>(this->c.rbegin(), this->c.rend());
+		}
+		
+		// The element k below the top, from_top(0) being top(); k must be
+		// less than size(). O(1) on random-access containers (std::deque,
+		// std::vector, SmallVector); only those have it, since the index
+		// goes straight to the container's operator[]
+		typename Container::reference from_top(size_t k)
+		{
+			return this->c[this->c.size() - 1 - k];
+		}
+		
+		typename Container::const_reference from_top(size_t k) const
+		{
+			return this->c[this->c.size() - 1 - k];
+		}
 };
 
 #endif
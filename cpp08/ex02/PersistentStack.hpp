@@ -0,0 +1,268 @@
+#ifndef PERSISTENTSTACK_HPP
+#define PERSISTENTSTACK_HPP
+
+#include <cstddef>
+#include <vector>
+
+// Iterable stack whose copies share structure: the elements form an
+// immutable linked spine from the top down, and a copy only takes a new
+// reference to the top node. Copying or snapshotting is O(1), and pushing
+// or popping on one copy never changes another: it moves that copy's top
+// while shared nodes stay as they were. Nodes are reference counted and
+// freed when the last stack using them lets go. Elements cannot be
+// modified in place, since other copies may see them
+template <typename T>
+class PersistentStack
+{
+	private:
+		struct Node
+		{
+			T value;
+			Node *next;
+			size_t refs;
+			
+			Node(const T &v, Node *n) : value(v), next(n), refs(1)
+			{
+			}
+		};
+		
+		Node *_top;
+		size_t _size;
+		
+		// Bottom-to-top node list for begin()/end(), built on first use and
+		// dropped by push and pop
+		mutable std::vector<const Node *> _order;
+		
+		static Node *_acquire(Node *node)
+		{
+			if (node)
+				node->refs++;
+			return node;
+		}
+		
+		// Drop one reference; a node that hits 0 releases its next, looping
+		// instead of recursing so long spines cannot overflow the stack
+		static void _release(Node *node)
+		{
+			while (node && --node->refs == 0)
+			{
+				Node *next = node->next;
+				delete node;
+				node = next;
+			}
+		}
+		
+		const std::vector<const Node *> &_bottomUp(void) const
+		{
+			if (_order.size() != _size)
+			{
+				_order.resize(_size);
+				size_t i = _size;
+				for (const Node *n = _top; n; n = n->next)
+					_order[--i] = n;
+			}
+			return _order;
+		}
+	
+	public:
+		// Iterates bottom to top, like MutantStack; invalidated by push and
+		// pop on the same stack
+		class const_iterator
+		{
+			private:
+				const Node *const *_at;
+			
+			public:
+				const_iterator(void) : _at(NULL)
+				{
+				}
+				
+				explicit const_iterator(const Node *const *at) : _at(at)
+				{
+				}
+				
+				const T &operator*(void) const
+				{
+					return (*_at)->value;
+				}
+				
+				const T *operator->(void) const
+				{
+					return &(*_at)->value;
+				}
+				
+				const_iterator &operator++(void)
+				{
+					++_at;
+					return *this;
+				}
+				
+				const_iterator operator++(int)
+				{
+					const_iterator old = *this;
+					++_at;
+					return old;
+				}
+				
+				const_iterator &operator--(void)
+				{
+					--_at;
+					return *this;
+				}
+				
+				const_iterator operator--(int)
+				{
+					const_iterator old = *this;
+					--_at;
+					return old;
+				}
+				
+				bool operator==(const const_iterator &other) const
+				{
+					return _at == other._at;
+				}
+				
+				bool operator!=(const const_iterator &other) const
+				{
+					return _at != other._at;
+				}
+		};
+		
+		// Iterates top to bottom straight down the spine, with no setup
+		class const_reverse_iterator
+		{
+			private:
+				const Node *_node;
+			
+			public:
+				const_reverse_iterator(void) : _node(NULL)
+				{
+				}
+				
+				explicit const_reverse_iterator(const Node *node) : _node(node)
+				{
+				}
+				
+				const T &operator*(void) const
+				{
+					return _node->value;
+				}
+				
+				const T *operator->(void) const
+				{
+					return &_node->value;
+				}
+				
+				const_reverse_iterator &operator++(void)
+				{
+					_node = _node->next;
+					return *this;
+				}
+				
+				const_reverse_iterator operator++(int)
+				{
+					const_reverse_iterator old = *this;
+					_node = _node->next;
+					return old;
+				}
+				
+				bool operator==(const const_reverse_iterator &other) const
+				{
+					return _node == other._node;
+				}
+				
+				bool operator!=(const const_reverse_iterator &other) const
+				{
+					return _node != other._node;
+				}
+		};
+		
+		typedef const_iterator iterator;
+		typedef const_reverse_iterator reverse_iterator;
+		
+		// Constructor
+		PersistentStack(void) : _top(NULL), _size(0)
+		{
+		}
+		
+		// Copy constructor: shares every node, O(1)
+		PersistentStack(const PersistentStack &other) : _top(_acquire(other._top)), _size(other._size)
+		{
+		}
+		
+		// Assignment operator: O(1) plus freeing nodes no one else uses
+		PersistentStack &operator=(const PersistentStack &other)
+		{
+			Node *top = _acquire(other._top);
+			_release(_top);
+			_top = top;
+			_size = other._size;
+			_order.clear();
+			return *this;
+		}
+		
+		// Destructor
+		~PersistentStack(void)
+		{
+			_release(_top);
+		}
+		
+		void push(const T &value)
+		{
+			_top = new Node(value, _top);
+			_size++;
+			_order.clear();
+		}
+		
+		void pop(void)
+		{
+			Node *old = _top;
+			_top = _acquire(old->next);
+			_release(old);
+			_size--;
+			_order.clear();
+		}
+		
+		const T &top(void) const
+		{
+			return _top->value;
+		}
+		
+		size_t size(void) const
+		{
+			return _size;
+		}
+		
+		bool empty(void) const
+		{
+			return _size == 0;
+		}
+		
+		// A snapshot is just a copy
+		PersistentStack snapshot(void) const
+		{
+			return *this;
+		}
+		
+		const_iterator begin(void) const
+		{
+			return const_iterator(_size ? &_bottomUp()[0] : NULL);
+		}
+		
+		const_iterator end(void) const
+		{
+			return const_iterator(_size ? &_bottomUp()[0] + _size : NULL);
+		}
+		
+		const_reverse_iterator rbegin(void) const
+		{
+			return const_reverse_iterator(_top);
+		}
+		
+		const_reverse_iterator rend(void) const
+		{
+			return const_reverse_iterator(NULL);
+		}
+};
+
+#endif
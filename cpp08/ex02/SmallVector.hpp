@@ -0,0 +1,305 @@
+#ifndef SMALLVECTOR_HPP
+#define SMALLVECTOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <iterator>
+#include <algorithm>
+#include <memory>
+
+// Vector that keeps its first N elements (N >= 1) inside the object, so a
+// container that never grows past N never allocates. Beyond N it moves
+// to the heap and grows by doubling like std::vector. Storage is always
+// one contiguous block, so iterators are plain pointers. Provides what
+// std::stack needs from its container, plus iteration and reserve
+template <typename T, size_t N>
+class SmallVector
+{
+	public:
+		typedef T value_type;
+		typedef T &reference;
+		typedef const T &const_reference;
+		typedef T *pointer;
+		typedef const T *const_pointer;
+		typedef T *iterator;
+		typedef const T *const_iterator;
+		typedef std::reverse_iterator<iterator> reverse_iterator;
+		typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+	
+	private:
+		// Raw bytes for N elements, aligned for any fundamental type
+		union InlineStorage
+		{
+			char bytes[N * sizeof(T)];
+			long double alignLongDouble;
+			long long alignLongLong;
+			void *alignPointer;
+		};
+		
+		InlineStorage _inline;
+		T *_data;
+		size_t _size;
+		size_t _capacity;
+		
+		T *_inlineData(void)
+		{
+			return reinterpret_cast<T *>(_inline.bytes);
+		}
+		
+		// Destroy count elements from p
+		static void _destroy(T *p, size_t count)
+		{
+			for (size_t i = 0; i < count; i++)
+				p[i].~T();
+		}
+		
+		// Copy-construct count elements from src into raw memory at dst;
+		// if one throws, the ones already built are destroyed
+		static void _copyConstruct(T *dst, const T *src, size_t count)
+		{
+			size_t i = 0;
+			try
+			{
+				for (; i < count; i++)
+					new (dst + i) T(src[i]);
+			}
+			catch (...)
+			{
+				_destroy(dst, i);
+				throw;
+			}
+		}
+		
+		// Move to a heap block of capacity elements; strong guarantee
+		void _reallocate(size_t capacity)
+		{
+			T *block = static_cast<T *>(::operator new(capacity * sizeof(T)));
+			try
+			{
+				_copyConstruct(block, _data, _size);
+			}
+			catch (...)
+			{
+				::operator delete(block);
+				throw;
+			}
+			_destroy(_data, _size);
+			if (_data != _inlineData())
+				::operator delete(_data);
+			_data = block;
+			_capacity = capacity;
+		}
+		
+		template <typename Iterator>
+		void _append(Iterator first, Iterator last, std::forward_iterator_tag)
+		{
+			size_t count = std::distance(first, last);
+			if (_size + count > _capacity)
+				_reallocate(std::max(_size + count, _capacity * 2));
+			std::uninitialized_copy(first, last, _data + _size);
+			_size += count;
+		}
+		
+		template <typename Iterator>
+		void _append(Iterator first, Iterator last, std::input_iterator_tag)
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+		}
+	
+	public:
+		// Constructor: empty, inline
+		SmallVector(void) : _data(_inlineData()), _size(0), _capacity(N)
+		{
+		}
+		
+		// Copy constructor: inline again when the copy fits
+		SmallVector(const SmallVector &other) : _data(_inlineData()), _size(0), _capacity(N)
+		{
+			reserve(other._size);
+			_copyConstruct(_data, other._data, other._size);
+			_size = other._size;
+		}
+		
+		// Assignment operator
+		SmallVector &operator=(const SmallVector &other)
+		{
+			if (this != &other)
+			{
+				clear();
+				reserve(other._size);
+				_copyConstruct(_data, other._data, other._size);
+				_size = other._size;
+			}
+			return *this;
+		}
+		
+		// Destructor
+		~SmallVector(void)
+		{
+			_destroy(_data, _size);
+			if (_data != _inlineData())
+				::operator delete(_data);
+		}
+		
+		void push_back(const T &value)
+		{
+			if (_size == _capacity)
+			{
+				// value may live in this vector, so copy it before moving
+				T copy(value);
+				_reallocate(_capacity * 2);
+				new (_data + _size) T(copy);
+			}
+			else
+				new (_data + _size) T(value);
+			_size++;
+		}
+		
+		void pop_back(void)
+		{
+			_size--;
+			_data[_size].~T();
+		}
+		
+		// Make room for capacity elements without further allocation
+		void reserve(size_t capacity)
+		{
+			if (capacity > _capacity)
+				_reallocate(capacity);
+		}
+		
+		// Insert [first, last) before pos. Forward ranges are counted and
+		// the storage grown at most once; elements are copied with the
+		// standard algorithms, which become block copies for plain types
+		template <typename Iterator>
+		iterator insert(iterator pos, Iterator first, Iterator last)
+		{
+			size_t offset = pos - _data;
+			if (pos != end())
+			{
+				// Set the tail aside, append, put the tail back
+				SmallVector tail;
+				tail.insert(tail.end(), pos, end());
+				erase(pos, end());
+				insert(end(), first, last);
+				insert(end(), tail.begin(), tail.end());
+				return _data + offset;
+			}
+			_append(first, last, typename std::iterator_traits<Iterator>::iterator_category());
+			return _data + offset;
+		}
+		
+		// Remove [first, last), moving the rest down
+		iterator erase(iterator first, iterator last)
+		{
+			iterator kept = std::copy(last, end(), first);
+			_destroy(kept, end() - kept);
+			_size = kept - _data;
+			return first;
+		}
+		
+		void clear(void)
+		{
+			_destroy(_data, _size);
+			_size = 0;
+		}
+		
+		reference back(void)
+		{
+			return _data[_size - 1];
+		}
+		
+		const_reference back(void) const
+		{
+			return _data[_size - 1];
+		}
+		
+		reference operator[](size_t i)
+		{
+			return _data[i];
+		}
+		
+		const_reference operator[](size_t i) const
+		{
+			return _data[i];
+		}
+		
+		size_t size(void) const
+		{
+			return _size;
+		}
+		
+		bool empty(void) const
+		{
+			return _size == 0;
+		}
+		
+		size_t capacity(void) const
+		{
+			return _capacity;
+		}
+		
+		// True while the elements are still in the object itself
+		bool isInline(void) const
+		{
+			return _capacity == N;
+		}
+		
+		iterator begin(void)
+		{
+			return _data;
+		}
+		
+		iterator end(void)
+		{
+			return _data + _size;
+		}
+		
+		const_iterator begin(void) const
+		{
+			return _data;
+		}
+		
+		const_iterator end(void) const
+		{
+			return _data + _size;
+		}
+		
+		reverse_iterator rbegin(void)
+		{
+			return reverse_iterator(end());
+		}
+		
+		reverse_iterator rend(void)
+		{
+			return reverse_iterator(begin());
+		}
+		
+		const_reverse_iterator rbegin(void) const
+		{
+			return const_reverse_iterator(end());
+		}
+		
+		const_reverse_iterator rend(void) const
+		{
+			return const_reverse_iterator(begin());
+		}
+};
+
+// Element-wise comparisons, as std::stack's operators expect
+template <typename T, size_t N>
+bool operator==(const SmallVector<T, N> &a, const SmallVector<T, N> &b)
+{
+	return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
+
+template <typename T, size_t N>
+bool operator<(const SmallVector<T, N> &a, const SmallVector<T, N> &b)
+{
+	return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+#endif
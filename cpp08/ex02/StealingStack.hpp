@@ -0,0 +1,365 @@
+#ifndef STEALINGSTACK_HPP
+#define STEALINGSTACK_HPP
+
+#include <cstddef>
+#include <iterator>
+#include "MutantStack.hpp"
+
+// Task stack for a work-stealing scheduler, a Chase-Lev deque: the owner
+// thread pushes and pops at the top like any MutantStack, while idle
+// threads steal from the bottom, where the oldest (and usually largest)
+// tasks are. The tasks sit in a circular buffer between two indices; the
+// owner alone moves the top, thieves take the bottom by compare-and-swap
+// (GCC __sync builtins, full barriers), and only a pop of the last task
+// races them for it. A full buffer is copied into one twice the size;
+// the old one is freed at once when no thief is inside steal, otherwise
+// by the last one to leave, as ConcurrentStack frees its nodes. T should
+// be a plain value such as a task pointer or index: a thief copies a
+// slot before its compare-and-swap, and the copy is thrown away when
+// the swap fails because the slot was taken and written again
+template <typename T>
+class StealingStack
+{
+	private:
+		struct Buffer
+		{
+			long mask;				// capacity - 1, the capacity a power of two
+			T *slots;
+			Buffer *pendingNext;	// the pending list
+			
+			explicit Buffer(long capacity) : mask(capacity - 1), slots(new T[capacity]), pendingNext(NULL)
+			{
+			}
+			
+			~Buffer(void)
+			{
+				delete[] slots;
+			}
+			
+			T &at(long index)
+			{
+				return slots[index & mask];
+			}
+		};
+		
+		// Tasks are at [_bottom, _top); the buffer only ever grows
+		volatile long _top;
+		volatile long _bottom;
+		Buffer *volatile _buffer;
+		
+		// Threads inside steal, and the buffers replaced while any was
+		volatile size_t _readers;
+		Buffer *volatile _pending;
+		
+		// Atomic reads: a compare-and-swap that changes nothing
+		static long _load(const volatile long &n)
+		{
+			return __sync_fetch_and_add(const_cast<volatile long *>(&n), 0);
+		}
+		
+		static size_t _load(const volatile size_t &n)
+		{
+			return __sync_fetch_and_add(const_cast<volatile size_t *>(&n), 0);
+		}
+		
+		static Buffer *_load(Buffer *const volatile &p)
+		{
+			Buffer *volatile *q = const_cast<Buffer *volatile *>(&p);
+			return __sync_val_compare_and_swap(q, static_cast<Buffer *>(NULL), static_cast<Buffer *>(NULL));
+		}
+		
+		// Atomic writes of a value only the calling thread changes, so seen
+		// is the current one and the compare-and-swap always succeeds
+		template <typename V>
+		static void _store(volatile V &target, V seen, V value)
+		{
+			__sync_bool_compare_and_swap(&target, seen, value);
+		}
+		
+		static void _deleteList(Buffer *buffer)
+		{
+			while (buffer)
+			{
+				Buffer *next = buffer->pendingNext;
+				delete buffer;
+				buffer = next;
+			}
+		}
+		
+		// Put the chain first..last on the pending list
+		void _defer(Buffer *first, Buffer *last)
+		{
+			Buffer *seen = _load(_pending);
+			for (;;)
+			{
+				last->pendingNext = seen;
+				Buffer *now = __sync_val_compare_and_swap(&_pending, seen, first);
+				if (now == seen)
+					return;
+				seen = now;
+			}
+		}
+		
+		void _deferList(Buffer *list)
+		{
+			if (!list)
+				return;
+			Buffer *last = list;
+			while (last->pendingNext)
+				last = last->pendingNext;
+			_defer(list, last);
+		}
+		
+		void _enter(void)
+		{
+			__sync_fetch_and_add(&_readers, 1);
+		}
+		
+		// Leave steal, freeing whatever is pending when no other thief is
+		// inside. A thief that enters after the list was taken only sees
+		// the current buffer
+		void _leave(void)
+		{
+			if (_load(_readers) == 1)
+			{
+				Buffer *list = __sync_lock_test_and_set(&_pending, static_cast<Buffer *>(NULL));
+				__sync_synchronize();
+				if (__sync_sub_and_fetch(&_readers, 1) == 0)
+					_deleteList(list);
+				else
+					_deferList(list);
+			}
+			else
+				__sync_sub_and_fetch(&_readers, 1);
+		}
+		
+		// Owner only: move the tasks [bottom, top) to a buffer twice the
+		// size. A thief counted in _readers may still read the old one; one
+		// that enters after the count was read loads the new one
+		Buffer *_grow(Buffer *old, long bottom, long top)
+		{
+			Buffer *bigger = new Buffer(2 * (old->mask + 1));
+			for (long i = bottom; i < top; i++)
+				bigger->at(i) = old->at(i);
+			_store(_buffer, old, bigger);
+			if (_load(_readers) == 0)
+				delete old;
+			else
+				_defer(old, old);
+			return bigger;
+		}
+		
+		// Atomic indices and buffers cannot be copied: no copies
+		StealingStack(const StealingStack &other);
+		StealingStack &operator=(const StealingStack &other);
+		
+	public:
+		// Read-only walk from the bottom task to the top one, for
+		// diagnostics on the owner thread between its own calls; a steal
+		// meanwhile leaves the walk on tasks already taken
+		class const_iterator
+		{
+			private:
+				Buffer *_in;
+				long _index;
+				
+			public:
+				typedef std::bidirectional_iterator_tag iterator_category;
+				typedef T value_type;
+				typedef long difference_type;
+				typedef const T *pointer;
+				typedef const T &reference;
+				
+				const_iterator(void) : _in(NULL), _index(0)
+				{
+				}
+				
+				const_iterator(Buffer *in, long index) : _in(in), _index(index)
+				{
+				}
+				
+				const T &operator*(void) const
+				{
+					return _in->at(_index);
+				}
+				
+				const T *operator->(void) const
+				{
+					return &_in->at(_index);
+				}
+				
+				const_iterator &operator++(void)
+				{
+					_index++;
+					return *this;
+				}
+				
+				const_iterator operator++(int)
+				{
+					const_iterator before = *this;
+					_index++;
+					return before;
+				}
+				
+				const_iterator &operator--(void)
+				{
+					_index--;
+					return *this;
+				}
+				
+				const_iterator operator--(int)
+				{
+					const_iterator before = *this;
+					_index--;
+					return before;
+				}
+				
+				bool operator==(const const_iterator &other) const
+				{
+					return _index == other._index;
+				}
+				
+				bool operator!=(const const_iterator &other) const
+				{
+					return _index != other._index;
+				}
+		};
+		
+		// Tasks cannot be written in place while thieves may read them
+		typedef const_iterator iterator;
+		
+		// Constructor
+		StealingStack(void) : _top(0), _bottom(0), _buffer(new Buffer(32)), _readers(0), _pending(NULL)
+		{
+		}
+		
+		// Destructor; no thread may still be using the stack
+		~StealingStack(void)
+		{
+			delete _buffer;
+			_deleteList(_pending);
+		}
+		
+		// Owner only
+		void push(const T &task)
+		{
+			long top = _load(_top);
+			long bottom = _load(_bottom);
+			Buffer *buffer = _load(_buffer);
+			if (top - bottom > buffer->mask)
+				buffer = _grow(buffer, bottom, top);
+			buffer->at(top) = task;
+			_store(_top, top, top + 1);
+		}
+		
+		// Owner only: take the top task; false when the stack is empty.
+		// The top is lowered before the bottom is read, so a thief either
+		// sees the task gone or leaves it to the compare-and-swap below
+		bool pop(T &task)
+		{
+			long top = _load(_top) - 1;
+			_store(_top, top + 1, top);
+			long bottom = _load(_bottom);
+			if (bottom > top)
+			{
+				_store(_top, top, bottom);
+				return false;
+			}
+			T value = _load(_buffer)->at(top);
+			if (bottom < top)
+			{
+				task = value;
+				return true;
+			}
+			
+			// The last task: whoever moves the bottom past it has it
+			bool won = __sync_bool_compare_and_swap(&_bottom, bottom, bottom + 1);
+			_store(_top, top, bottom + 1);
+			if (won)
+				task = value;
+			return won;
+		}
+		
+		// Owner only: the task pop would take, which a thief may take first
+		const T &top(void) const
+		{
+			return _load(_buffer)->at(_load(_top) - 1);
+		}
+		
+		// Any thread: take the bottom task; false when there is none
+		bool steal(T &task)
+		{
+			_enter();
+			bool taken = false;
+			for (;;)
+			{
+				long bottom = _load(_bottom);
+				long top = _load(_top);
+				if (bottom >= top)
+					break;
+				// Loaded after the top, so the buffer holds every task below it
+				T value = _load(_buffer)->at(bottom);
+				if (__sync_bool_compare_and_swap(&_bottom, bottom, bottom + 1))
+				{
+					task = value;
+					taken = true;
+					break;
+				}
+			}
+			_leave();
+			return taken;
+		}
+		
+		// Called by the owner of thief: steal the bottom half (rounded up)
+		// of this stack onto thief, oldest first so they keep their order
+		// there; returns how many moved, fewer when others steal meanwhile
+		size_t stealHalf(StealingStack &thief)
+		{
+			if (&thief == this)
+				return 0;
+			size_t count = (size() + 1) / 2;
+			size_t moved = 0;
+			T task;
+			while (moved < count && steal(task))
+			{
+				thief.push(task);
+				moved++;
+			}
+			return moved;
+		}
+		
+		// Tasks as of some instant during the call
+		size_t size(void) const
+		{
+			long bottom = _load(_bottom);
+			long top = _load(_top);
+			return top > bottom ? static_cast<size_t>(top - bottom) : 0;
+		}
+		
+		bool empty(void) const
+		{
+			return size() == 0;
+		}
+		
+		// Owner only, see const_iterator
+		const_iterator begin(void) const
+		{
+			return const_iterator(_load(_buffer), _load(_bottom));
+		}
+		
+		const_iterator end(void) const
+		{
+			return const_iterator(_load(_buffer), _load(_top));
+		}
+		
+		// The stack at one instant for the owner, bottom first like
+		// MutantStack::begin()
+		MutantStack<T> snapshot(void) const
+		{
+			MutantStack<T> copy;
+			copy.push_range(begin(), end());
+			return copy;
+		}
+};
+
+#endif
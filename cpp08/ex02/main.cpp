@@ -1,6 +1,61 @@
 #include <iostream>
 #include <list>
+#include <vector>
 #include "MutantStack.hpp"
+#include "StealingStack.hpp"
+#include "PersistentStack.hpp"
+#include "ConcurrentStack.hpp"
+#include <pthread.h>
+
+// Threads of the concurrent stack test: producers push 10,000 tasks
+// each, consumers keep popping until they have taken 5,000 each
+static void *produce(void *arg)
+{
+	ConcurrentStack<int> *tasks = static_cast<ConcurrentStack<int> *>(arg);
+	for (int i = 0; i < 10000; i++)
+		tasks->push(i);
+	return NULL;
+}
+
+static void *consume(void *arg)
+{
+	ConcurrentStack<int> *tasks = static_cast<ConcurrentStack<int> *>(arg);
+	long taken = 0;
+	int task;
+	while (taken < 5000)
+	{
+		if (tasks->pop(task))
+			taken++;
+	}
+	return reinterpret_cast<void *>(taken);
+}
+
+// Thieves of the stealing test: steal until the owner is done and the
+// stack is empty, adding up what they took
+struct Stolen
+{
+	StealingStack<int> *tasks;
+	volatile int *done;
+	long count;
+	long long sum;
+};
+
+static void *thieve(void *arg)
+{
+	Stolen *self = static_cast<Stolen *>(arg);
+	int task;
+	for (;;)
+	{
+		if (self->tasks->steal(task))
+		{
+			self->count++;
+			self->sum += task;
+		}
+		else if (__sync_fetch_and_add(self->done, 0))
+			break;
+	}
+	return NULL;
+}
 
 int main(void)
 {
@@ -76,5 +131,149 @@ int main(void)
 		std::cout << *dit << std::endl;
 	}
 	
+	// Test with a small-buffer container: inline up to 8 elements
+	std::cout << "\n=== SmallVector Stack Test ===" << std::endl;
+	MutantStack<int, SmallVector<int, 8> > sstack;
+	for (int i = 0; i < 8; i++)
+		sstack.push(i * i);
+	std::cout << "8 elements, top " << sstack.top() << std::endl;
+	for (MutantStack<int, SmallVector<int, 8> >::reverse_iterator rit = sstack.rbegin(); rit != sstack.rend(); ++rit)
+		std::cout << *rit << " ";
+	std::cout << std::endl;
+	for (int i = 8; i < 20; i++)
+		sstack.push(i * i);
+	MutantStack<int, SmallVector<int, 8> > scopy(sstack);
+	while (scopy.size() > 3)
+		scopy.pop();
+	std::cout << "Copy popped to " << scopy.size() << ", top " << scopy.top() << std::endl;
+	std::cout << "Original size " << sstack.size() << ", top " << sstack.top() << std::endl;
+	
+	// Test bulk push and pop
+	std::cout << "\n=== Bulk Test ===" << std::endl;
+	MutantStack<int, std::vector<int> > work;
+	int batch[] = {10, 20, 30, 40, 50};
+	work.push_range(batch, batch + 5);
+	std::cout << "Pushed " << work.size() << ", top " << work.top() << std::endl;
+	int taken[3];
+	work.pop_n(3, taken);
+	std::cout << "Popped " << taken[0] << " " << taken[1] << " " << taken[2] << ", left " << work.size()
+	          << ", top " << work.top() << std::endl;
+	
+	// Test reading below the top without popping
+	std::cout << "\n=== Inspection Test ===" << std::endl;
+	MutantStack<int> deep;
+	for (int i = 0; i < 1000; i++)
+		deep.push(i);
+	std::cout << "from_top(0) " << deep.from_top(0) << ", from_top(999) " << deep.from_top(999) << std::endl;
+	const MutantStack<int, std::vector<int> > &view = work;
+	std::cout << "Top down (" << view.top_down().size() << "):";
+	MutantStack<int, std::vector<int> >::Range<MutantStack<int, std::vector<int> >::const_reverse_iterator> down
+		= view.top_down();
+	for (MutantStack<int, std::vector<int> >::const_reverse_iterator vit = down.begin(); vit != down.end(); ++vit)
+		std::cout << " " << *vit;
+	std::cout << std::endl;
+	
+	// Test stealing from the bottom while the owner works at the top
+	std::cout << "\n=== Stealing Test ===" << std::endl;
+	StealingStack<int> owner;
+	StealingStack<int> idle;
+	for (int task = 1; task <= 8; task++)
+		owner.push(task);
+	int stolen;
+	owner.steal(stolen);
+	std::cout << "Stolen " << stolen << ", owner top " << owner.top() << std::endl;
+	std::cout << "Moved " << owner.stealHalf(idle) << " to idle worker:";
+	for (StealingStack<int>::iterator sit = idle.begin(); sit != idle.end(); ++sit)
+		std::cout << " " << *sit;
+	std::cout << std::endl << "Owner keeps:";
+	for (StealingStack<int>::iterator sit = owner.begin(); sit != owner.end(); ++sit)
+		std::cout << " " << *sit;
+	std::cout << std::endl;
+	
+	// Test an owner pushing and popping while three threads steal:
+	// every task is taken exactly once
+	std::cout << "\n=== Stealing Test (owner, 3 thieves) ===" << std::endl;
+	StealingStack<int> shared;
+	volatile int done = 0;
+	Stolen thieves[3];
+	pthread_t thieveThreads[3];
+	for (int t = 0; t < 3; t++)
+	{
+		thieves[t].tasks = &shared;
+		thieves[t].done = &done;
+		thieves[t].count = 0;
+		thieves[t].sum = 0;
+		pthread_create(&thieveThreads[t], NULL, thieve, &thieves[t]);
+	}
+	long popped = 0;
+	long long total = 0;
+	for (int task = 1; task <= 100000; task++)
+	{
+		shared.push(task);
+		int mine;
+		if (task % 3 == 0 && shared.pop(mine))
+		{
+			popped++;
+			total += mine;
+		}
+	}
+	int mine;
+	while (shared.pop(mine))
+	{
+		popped++;
+		total += mine;
+	}
+	__sync_lock_test_and_set(&done, 1);
+	long stolenCount = 0;
+	for (int t = 0; t < 3; t++)
+	{
+		pthread_join(thieveThreads[t], NULL);
+		stolenCount += thieves[t].count;
+		total += thieves[t].sum;
+	}
+	std::cout << "Taken " << popped + stolenCount << " of 100000, "
+	          << (total == 100000LL * 100001 / 2 ? "each once" : "lost or repeated") << std::endl;
+	
+	// Test snapshots that share their elements
+	std::cout << "\n=== Persistent Stack Test ===" << std::endl;
+	PersistentStack<int> history;
+	history.push(1);
+	history.push(2);
+	history.push(3);
+	PersistentStack<int> checkpoint = history.snapshot();
+	history.pop();
+	history.push(42);
+	std::cout << "Checkpoint:";
+	for (PersistentStack<int>::iterator pit = checkpoint.begin(); pit != checkpoint.end(); ++pit)
+		std::cout << " " << *pit;
+	std::cout << std::endl << "Current:";
+	for (PersistentStack<int>::iterator pit = history.begin(); pit != history.end(); ++pit)
+		std::cout << " " << *pit;
+	std::cout << std::endl;
+	
+	// Test producers and consumers on one lock-free stack
+	std::cout << "\n=== Concurrent Stack Test (2 producers, 2 consumers) ===" << std::endl;
+	ConcurrentStack<int> tasks;
+	pthread_t threads[4];
+	for (int t = 0; t < 2; t++)
+		pthread_create(&threads[t], NULL, produce, &tasks);
+	long counts[2] = {0, 0};
+	for (int t = 0; t < 2; t++)
+		pthread_create(&threads[2 + t], NULL, consume, &tasks);
+	for (int t = 0; t < 4; t++)
+	{
+		void *taken;
+		pthread_join(threads[t], &taken);
+		if (t >= 2)
+			counts[t - 2] = reinterpret_cast<long>(taken);
+	}
+	MutantStack<int> left = tasks.snapshot();
+	std::cout << "Consumed " << counts[0] + counts[1] << ", left " << tasks.size() << ", snapshot of "
+	          << left.size() << std::endl;
+	int drained;
+	while (tasks.pop(drained))
+		;
+	std::cout << "Drained, empty " << tasks.empty() << std::endl;
+	
 	return 0;
 }
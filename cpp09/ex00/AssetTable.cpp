@@ -0,0 +1,140 @@
+#include "AssetTable.hpp"
+#include <algorithm>
+#include <cstring>
+
+AssetTable::AssetTable(void)
+{
+}
+
+AssetTable::AssetTable(const AssetTable &other) : _dates(other._dates), _names(other._names),
+	_columns(other._columns)
+{
+}
+
+AssetTable &AssetTable::operator=(const AssetTable &other)
+{
+	if (this != &other)
+	{
+		_dates = other._dates;
+		_names = other._names;
+		_columns = other._columns;
+	}
+	return *this;
+}
+
+AssetTable::~AssetTable(void)
+{
+}
+
+void AssetTable::setAssets(const std::vector<std::string> &names)
+{
+	_dates.clear();
+	_names = names;
+	_columns.assign(names.size(), std::vector<float>());
+}
+
+size_t AssetTable::assetCount(void) const
+{
+	return _names.size();
+}
+
+const std::string &AssetTable::assetName(size_t asset) const
+{
+	return _names[asset];
+}
+
+int AssetTable::assetIndex(const char *name, size_t len) const
+{
+	// A few dozen short names; a linear scan beats anything fancier
+	for (size_t i = 0; i < _names.size(); i++)
+	{
+		if (_names[i].size() == len && std::memcmp(_names[i].data(), name, len) == 0)
+			return static_cast<int>(i);
+	}
+	return -1;
+}
+
+int AssetTable::assetIndex(const std::string &name) const
+{
+	return assetIndex(name.data(), name.size());
+}
+
+void AssetTable::insertRow(int date, const float *rates)
+{
+	size_t n = _columns.size();
+	
+	// Sorted input only ever appends
+	if (_dates.empty() || date > _dates.back())
+	{
+		_dates.push_back(date);
+		for (size_t a = 0; a < n; a++)
+			_columns[a].push_back(rates[a]);
+		return;
+	}
+	
+	std::vector<int>::iterator it = std::lower_bound(_dates.begin(), _dates.end(), date);
+	size_t pos = it - _dates.begin();
+	if (it != _dates.end() && *it == date)
+	{
+		for (size_t a = 0; a < n; a++)
+		{
+			if (rates[a] == rates[a])
+				_columns[a][pos] = rates[a];
+		}
+		return;
+	}
+	_dates.insert(it, date);
+	for (size_t a = 0; a < n; a++)
+		_columns[a].insert(_columns[a].begin() + pos, rates[a]);
+}
+
+size_t AssetTable::upperIndex(int date) const
+{
+	return std::upper_bound(_dates.begin(), _dates.end(), date) - _dates.begin();
+}
+
+bool AssetTable::rateBefore(size_t upper, size_t asset, float &rate) const
+{
+	// Skip rows where this asset had no price (NaN is the only value != itself)
+	const std::vector<float> &column = _columns[asset];
+	while (upper > 0 && column[upper - 1] != column[upper - 1])
+		upper--;
+	if (upper == 0)
+		return false;
+	rate = column[upper - 1];
+	return true;
+}
+
+bool AssetTable::find(int date, size_t asset, float &rate) const
+{
+	return rateBefore(upperIndex(date), asset, rate);
+}
+
+void AssetTable::swap(AssetTable &other)
+{
+	_dates.swap(other._dates);
+	_names.swap(other._names);
+	_columns.swap(other._columns);
+}
+
+void AssetTable::clear(void)
+{
+	_dates.clear();
+	for (size_t a = 0; a < _columns.size(); a++)
+		_columns[a].clear();
+}
+
+size_t AssetTable::size(void) const
+{
+	return _dates.size();
+}
+
+bool AssetTable::empty(void) const
+{
+	return _dates.empty();
+}
+
+int AssetTable::dateAt(size_t row) const
+{
+	return _dates[row];
+}
@@ -0,0 +1,61 @@
+#ifndef ASSETTABLE_HPP
+#define ASSETTABLE_HPP
+
+#include <vector>
+#include <string>
+#include <cstddef>
+
+// Columnar price store for many assets: one sorted date column (packed as
+// in PriceTable) shared by one rate column per asset. A NaN cell means the
+// row had no price for that asset; lookups then fall back to earlier rows
+class AssetTable
+{
+	private:
+		std::vector<int> _dates;
+		std::vector<std::string> _names;
+		std::vector<std::vector<float> > _columns;
+		
+	public:
+		// Constructor
+		AssetTable(void);
+		
+		// Copy constructor
+		AssetTable(const AssetTable &other);
+		
+		// Assignment operator
+		AssetTable &operator=(const AssetTable &other);
+		
+		// Destructor
+		~AssetTable(void);
+		
+		// Start over with the given asset columns and no rows
+		void setAssets(const std::vector<std::string> &names);
+		
+		size_t assetCount(void) const;
+		const std::string &assetName(size_t asset) const;
+		
+		// Column of the named asset, or -1
+		int assetIndex(const char *name, size_t len) const;
+		int assetIndex(const std::string &name) const;
+		
+		// Insert one row of assetCount() rates, keeping dates sorted; an
+		// existing date is overwritten cell by cell, except for NaN cells
+		void insertRow(int date, const float *rates);
+		
+		// Number of dates <= date; one search serves every asset
+		size_t upperIndex(int date) const;
+		
+		// Latest known rate of asset in the rows before upper (an upperIndex result)
+		bool rateBefore(size_t upper, size_t asset, float &rate) const;
+		
+		// Rate of asset at the latest date <= date
+		bool find(int date, size_t asset, float &rate) const;
+		
+		void swap(AssetTable &other);
+		void clear(void);
+		size_t size(void) const;
+		bool empty(void) const;
+		int dateAt(size_t row) const;
+};
+
+#endif
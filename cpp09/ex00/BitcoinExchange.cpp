@@ -1,15 +1,24 @@
 #include "BitcoinExchange.hpp"
+#include "Decimal.hpp"
+#include "Profiler.hpp"
+#include "MappedFile.hpp"
+#include "ThreadPool.hpp"
 #include <fstream>
 #include <sstream>
 #include <cstdlib>
-#include <cctype>
 #include <iomanip>
+#include <cstring>
+#include <algorithm>
+#include <limits>
+#include <stdint.h>
 
-BitcoinExchange::BitcoinExchange(void)
+BitcoinExchange::BitcoinExchange(void) : _storeMode(STORE_MAP), _fixedPoint(false), _dbOffset(0), _errorLog(NULL)
 {
 }
 
-BitcoinExchange::BitcoinExchange(const BitcoinExchange &other) : _prices(other._prices)
+BitcoinExchange::BitcoinExchange(const BitcoinExchange &other) : _prices(other._prices), _table(other._table), _storeMode(other._storeMode),
+	_packed(other._packed), _fixedPoint(other._fixedPoint),
+	_assets(other._assets), _ticks(other._ticks), _dbFile(other._dbFile), _dbOffset(other._dbOffset), _cache(other._cache), _errorLog(other._errorLog)
 {
 }
 
@@ -18,6 +27,16 @@ BitcoinExchange &BitcoinExchange::operator=(const BitcoinExchange &other)
 	if (this != &other)
 	{
 		_prices = other._prices;
+		_table = other._table;
+		_storeMode = other._storeMode;
+		_packed = other._packed;
+		_fixedPoint = other._fixedPoint;
+		_assets = other._assets;
+		_ticks = other._ticks;
+		_dbFile = other._dbFile;
+		_dbOffset = other._dbOffset;
+		_cache = other._cache;
+		_errorLog = other._errorLog;
 	}
 	return *this;
 }
@@ -26,51 +45,257 @@ BitcoinExchange::~BitcoinExchange(void)
 {
 }
 
-bool BitcoinExchange::_isValidDate(const std::string &date)
+void BitcoinExchange::setStoreMode(StoreMode mode)
 {
-	if (date.length() != 10)
-		return false;
-	if (date[4] != '-' || date[7] != '-')
-		return false;
+	if (mode == _storeMode)
+		return;
 	
-	// Check YYYY
-	for (int i = 0; i < 4; i++)
-		if (!std::isdigit(date[i]))
-			return false;
+	_cache.invalidate();
 	
-	// Check MM
-	for (int i = 5; i < 7; i++)
-		if (!std::isdigit(date[i]))
-			return false;
+	// The packed store is only ever built from the flat one and unpacked to it
+	if (_storeMode == STORE_PACKED)
+	{
+		_packed.unpack(_table);
+		_packed.clear();
+		_storeMode = STORE_FLAT;
+		if (mode == STORE_FLAT)
+			return;
+	}
+	if (mode == STORE_PACKED)
+	{
+		setStoreMode(STORE_FLAT);
+		_storeMode = STORE_PACKED;
+		_packStore();
+		
+		// Exact rates live in the flat store only
+		_fixedPoint = false;
+		return;
+	}
 	
-	// Check DD
-	for (int i = 8; i < 10; i++)
-		if (!std::isdigit(date[i]))
-			return false;
+	if (mode == STORE_FLAT)
+	{
+		// Map iteration is already in date order, so every insert appends
+		_table.clear();
+		_table.reserve(_prices.size());
+		for (std::map<std::string, float>::const_iterator it = _prices.begin(); it != _prices.end(); ++it)
+		{
+			int key;
+			if (PriceTable::packDate(it->first.c_str(), it->first.length(), key))
+				_table.insert(key, it->second);
+		}
+		_prices.clear();
+	}
+	else
+	{
+		char buf[11];
+		_prices.clear();
+		for (size_t i = 0; i < _table.size(); i++)
+		{
+			PriceTable::unpackDate(_table.dateAt(i), buf);
+			_prices.insert(_prices.end(), std::make_pair(std::string(buf, 10), _table.rateAt(i)));
+		}
+		_table.clear();
+		
+		// Exact rates live in the flat store only
+		_fixedPoint = false;
+	}
+	_storeMode = mode;
+}
+
+void BitcoinExchange::setFixedPoint(bool enabled)
+{
+	if (enabled)
+	{
+		setStoreMode(STORE_FLAT);
+		_table.enableScaled();
+	}
+	_fixedPoint = enabled;
+}
+
+bool BitcoinExchange::isFixedPoint(void) const
+{
+	return _fixedPoint;
+}
+
+void BitcoinExchange::setInterpolationSearch(bool enabled)
+{
+	_table.setInterpolation(enabled);
+}
+
+bool BitcoinExchange::isInterpolationSearch(void) const
+{
+	return _table.isInterpolated();
+}
+
+void BitcoinExchange::setCacheSize(size_t slots)
+{
+	_cache.resize(slots);
+}
+
+const RateCache &BitcoinExchange::getCache(void) const
+{
+	return _cache;
+}
+
+void BitcoinExchange::setErrorLog(ErrorLog *log)
+{
+	_errorLog = log;
+}
+
+ErrorLog *BitcoinExchange::getErrorLog(void) const
+{
+	return _errorLog;
+}
+
+BitcoinExchange::StoreMode BitcoinExchange::getStoreMode(void) const
+{
+	return _storeMode;
+}
+
+// Loads and inserts go through the flat table; in packed mode, the rows
+// are unpacked into it before and packed again after
+void BitcoinExchange::_unpackStore(void)
+{
+	if (_storeMode != STORE_PACKED)
+		return;
+	_packed.unpack(_table);
+	_packed.clear();
+}
+
+void BitcoinExchange::_packStore(void)
+{
+	if (_storeMode != STORE_PACKED)
+		return;
+	_packed.build(_table);
+	// Swapped out rather than cleared, so the flat columns free their memory
+	PriceTable().swap(_table);
+}
+
+void BitcoinExchange::_storeRate(const std::string &date, float price)
+{
+	_cache.invalidate();
+	if (_storeMode == STORE_MAP)
+	{
+		_prices[date] = price;
+		return;
+	}
+	
+	int key;
+	if (PriceTable::packDate(date.c_str(), date.length(), key))
+		_table.insert(key, price);
+}
+
+// Rate for the given date, or for the closest earlier date
+bool BitcoinExchange::_findRate(const std::string &date, float &rate) const
+{
+	return _findRate(date.data(), date.length(), rate);
+}
+
+bool BitcoinExchange::_findRate(const char *date, size_t len, float &rate) const
+{
+	// The map still answers dates that do not pack, just not through the cache
+	int key = 0;
+	if (!PriceTable::packDate(date, len, key))
+		return _storeMode == STORE_MAP && _searchRate(key, date, len, rate);
+	return _findRate(key, date, len, rate);
+}
+
+// Cached lookup on the packed key; the key identifies the date in both stores
+bool BitcoinExchange::_findRate(int key, const char *date, size_t len, float &rate) const
+{
+	if (!_cache.enabled())
+		return _searchRate(key, date, len, rate);
+	
+	bool found;
+	if (_cache.lookup(key, rate, found))
+		return found;
+	found = _searchRate(key, date, len, rate);
+	_cache.store(key, found ? rate : 0.0f, found);
+	return found;
+}
+
+// The flat store searches on the packed key, the map on the date text
+bool BitcoinExchange::_searchRate(int key, const char *date, size_t len, float &rate) const
+{
+	PROFILE_SCOPE(PHASE_LOOKUP);
+	if (_storeMode == STORE_FLAT)
+		return _table.find(key, rate);
+	if (_storeMode == STORE_PACKED)
+		return _packed.find(key, rate);
 	
-	int year = std::atoi(date.substr(0, 4).c_str());
-	int month = std::atoi(date.substr(5, 2).c_str());
-	int day = std::atoi(date.substr(8, 2).c_str());
+	// "YYYY-MM-DD" fits the small-string buffer, so this does not allocate
+	std::string text(date, len);
+	std::map<std::string, float>::const_iterator it = _prices.lower_bound(text);
 	
-	if (month < 1 || month > 12)
+	// If exact date exists, use it; otherwise use the one before
+	if (it != _prices.end() && it->first == text)
+	{
+		rate = it->second;
+		return true;
+	}
+	if (it == _prices.begin())
 		return false;
-	if (day < 1 || day > 31)
+	--it;
+	rate = it->second;
+	return true;
+}
+
+bool BitcoinExchange::_isValidDate(const std::string &date) const
+{
+	return _isValidDate(date.data(), date.length());
+}
+
+bool BitcoinExchange::_isValidDate(const char *date, size_t len) const
+{
+	int key;
+	return _isValidDate(date, len, key);
+}
+
+// First and last day accepted in queries, as packed keys
+static const int FIRST_DAY = 14245;	// 2009-01-01
+static const int LAST_DAY = 47481;	// 2099-12-31
+
+bool BitcoinExchange::_isValidDate(const char *date, size_t len, int &key) const
+{
+	PROFILE_SCOPE(PHASE_VALIDATE);
+	if (!PriceTable::packDate(date, len, key))
 		return false;
-	if (year < 2009 || year > 2099)
+	return key >= FIRST_DAY && key <= LAST_DAY;
+}
+
+bool BitcoinExchange::_isValidTimestamp(const char *stamp, size_t len, int &day, int &second) const
+{
+	if (!TickTable::packTimestamp(stamp, len, day, second))
 		return false;
-	
-	return true;
+	return day >= FIRST_DAY && day <= LAST_DAY;
 }
 
-bool BitcoinExchange::_isValidValue(const std::string &valueStr, float &value)
+bool BitcoinExchange::_isValidValue(const char *valueStr, size_t len, float &value) const
 {
-	if (valueStr.empty())
+	value = 0;
+	if (len == 0)
 		return false;
 	
+	// strtof needs a terminated string; short values are copied to the stack
+	char small[64];
+	std::string large;
+	const char *str;
+	if (len < sizeof(small))
+	{
+		std::memcpy(small, valueStr, len);
+		small[len] = '\0';
+		str = small;
+	}
+	else
+	{
+		large.assign(valueStr, len);
+		str = large.c_str();
+	}
+	
 	char *endptr;
-	value = std::strtof(valueStr.c_str(), &endptr);
+	value = std::strtof(str, &endptr);
 	
-	if (*endptr != '\0')
+	if (endptr != str + len)
 		return false;
 	
 	if (value < 0)
@@ -82,37 +307,73 @@ bool BitcoinExchange::_isValidValue(const std::string &valueStr, float &value)
 	return true;
 }
 
-bool BitcoinExchange::_parseLine(const std::string &line, std::string &date, float &value)
+bool BitcoinExchange::_isValidValue(const char *valueStr, size_t len, long long &value) const
 {
-	size_t pipePos = line.find('|');
-	if (pipePos == std::string::npos)
+	value = 0;
+	const char *end = valueStr + len;
+	if (Decimal::parse(valueStr, end, value) != end || len == 0)
 		return false;
+	return value >= 0 && value <= 1000 * Decimal::scale();
+}
+
+static bool isBlank(char c)
+{
+	return c == ' ' || c == '\t';
+}
+
+void BitcoinExchange::_splitLine(const char *line, size_t len, const char *pipe, const char *&date, size_t &dateLen,
+	const char *&valueStr, size_t &valueLen) const
+{
+	const char *end = line + len;
 	
-	// Extract date
-	date = line.substr(0, pipePos);
-	
-	// Trim spaces from date (right)
-	while (!date.empty() && (date[date.length() - 1] == ' ' || date[date.length() - 1] == '\t'))
-		date = date.substr(0, date.length() - 1);
-	// Trim spaces from date (left)
-	while (!date.empty() && (date[0] == ' ' || date[0] == '\t'))
-		date = date.substr(1);
-	
-	// Extract value
-	std::string valueStr = line.substr(pipePos + 1);
-	
-	// Trim spaces from value (left)
-	while (!valueStr.empty() && (valueStr[0] == ' ' || valueStr[0] == '\t'))
-		valueStr = valueStr.substr(1);
-	// Trim spaces from value (right)
-	while (!valueStr.empty() && (valueStr[valueStr.length() - 1] == ' ' || valueStr[valueStr.length() - 1] == '\t'))
-		valueStr = valueStr.substr(0, valueStr.length() - 1);
+	// Trim the date view
+	const char *dBegin = line;
+	const char *dEnd = pipe;
+	while (dEnd > dBegin && isBlank(dEnd[-1]))
+		dEnd--;
+	while (dBegin < dEnd && isBlank(*dBegin))
+		dBegin++;
+	date = dBegin;
+	dateLen = dEnd - dBegin;
 	
-	return _isValidValue(valueStr, value);
+	// Trim the value view
+	const char *vBegin = pipe + 1;
+	const char *vEnd = end;
+	while (vBegin < vEnd && isBlank(*vBegin))
+		vBegin++;
+	while (vEnd > vBegin && isBlank(vEnd[-1]))
+		vEnd--;
+	valueStr = vBegin;
+	valueLen = vEnd - vBegin;
+}
+
+bool BitcoinExchange::_parseLine(const char *line, size_t len, const char *&date, size_t &dateLen, float &value) const
+{
+	PROFILE_SCOPE(PHASE_PARSE);
+	const char *pipe = static_cast<const char *>(std::memchr(line, '|', len));
+	if (!pipe)
+		return false;
+	const char *valueStr;
+	size_t valueLen;
+	_splitLine(line, len, pipe, date, dateLen, valueStr, valueLen);
+	return _isValidValue(valueStr, valueLen, value);
+}
+
+bool BitcoinExchange::_parseLine(const char *line, size_t len, const char *&date, size_t &dateLen, long long &value) const
+{
+	PROFILE_SCOPE(PHASE_PARSE);
+	const char *pipe = static_cast<const char *>(std::memchr(line, '|', len));
+	if (!pipe)
+		return false;
+	const char *valueStr;
+	size_t valueLen;
+	_splitLine(line, len, pipe, date, dateLen, valueStr, valueLen);
+	return _isValidValue(valueStr, valueLen, value);
 }
 
 bool BitcoinExchange::loadDatabase(const std::string &filename)
 {
+	PROFILE_SCOPE(PHASE_LOAD);
 	std::ifstream file(filename.c_str());
 	if (!file.is_open())
 	{
@@ -123,9 +384,14 @@ bool BitcoinExchange::loadDatabase(const std::string &filename)
 	std::string line;
 	// Skip header
 	std::getline(file, line);
+	size_t offset = file.eof() ? line.size() : line.size() + 1;
 	
+	_unpackStore();
+	_table.beginBulk();
 	while (std::getline(file, line))
 	{
+		if (!file.eof())
+			offset += line.size() + 1;
 		if (line.empty())
 			continue;
 		
@@ -137,81 +403,977 @@ bool BitcoinExchange::loadDatabase(const std::string &filename)
 		std::string priceStr = line.substr(commaPos + 1);
 		
 		float price = std::strtof(priceStr.c_str(), NULL);
-		_prices[date] = price;
+		_storeRate(date, price);
 	}
+	_table.endBulk();
+	_packStore();
 	
 	file.close();
+	_dbFile = filename;
+	_dbOffset = offset;
 	return true;
 }
 
-void BitcoinExchange::processFile(const std::string &filename)
+// Read the file from offset to its end into one buffer, terminated by a '\0' sentinel
+bool BitcoinExchange::_readWholeFile(const std::string &filename, std::vector<char> &buffer, size_t offset)
 {
-	std::ifstream file(filename.c_str());
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
 	if (!file.is_open())
+		return false;
+	
+	file.seekg(0, std::ios::end);
+	std::streamoff size = file.tellg();
+	if (size < 0 || static_cast<size_t>(size) < offset)
+		return false;
+	size -= offset;
+	file.seekg(offset, std::ios::beg);
+	
+	buffer.resize(static_cast<size_t>(size) + 1);
+	if (size > 0)
+		file.read(&buffer[0], size);
+	buffer[static_cast<size_t>(file.gcount())] = '\0';
+	buffer.resize(static_cast<size_t>(file.gcount()) + 1);
+	file.close();
+	return true;
+}
+
+// strtof of the cell [cell, cellEnd) and nothing after it, as
+// loadDatabase reads it from its own line: strtof skips leading blanks,
+// newlines included, so straight out of the buffer an empty cell would
+// read the next row. Short cells are copied to the stack
+static float cellRate(const char *cell, const char *cellEnd)
+{
+	char small[64];
+	std::string large;
+	const char *str;
+	size_t len = cellEnd - cell;
+	if (len < sizeof(small))
+	{
+		std::memcpy(small, cell, len);
+		small[len] = '\0';
+		str = small;
+	}
+	else
+	{
+		large.assign(cell, len);
+		str = large.c_str();
+	}
+	return std::strtof(str, NULL);
+}
+
+// Insert the "date,rate" rows of [p, end) into the current store.
+// Returns the number of bytes up to and including the last newline
+size_t BitcoinExchange::_loadRows(const char *p, const char *end)
+{
+	const char *start = p;
+	size_t complete = 0;
+	_cache.invalidate();
+	
+	// One key string reused for every row; "YYYY-MM-DD" fits the small-string buffer
+	std::string date;
+	std::map<std::string, float>::iterator hint = _prices.end();
+	
+	// Flat rows are sorted and deduplicated once at the end, whatever their order
+	_unpackStore();
+	_table.beginBulk();
+	while (p < end)
+	{
+		const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+		const char *lineEnd = eol ? eol : end;
+		
+		const char *comma = static_cast<const char *>(std::memchr(p, ',', lineEnd - p));
+		if (comma)
+		{
+			if (_fixedPoint)
+			{
+				// Exact decimal parse; no strtof on this path
+				int key;
+				long long scaled = 0;
+				Decimal::parse(comma + 1, lineEnd, scaled);
+				if (PriceTable::packDate(p, comma - p, key))
+					_table.insert(key, static_cast<float>(scaled) / Decimal::scale(), scaled);
+				if (eol)
+					complete = eol + 1 - start;
+				p = lineEnd + 1;
+				continue;
+			}
+			
+			float price = cellRate(comma + 1, lineEnd);
+			if (_storeMode != STORE_MAP)
+			{
+				// Packed straight from the buffer; sorted rows append
+				int key;
+				if (PriceTable::packDate(p, comma - p, key))
+					_table.insert(key, price);
+			}
+			else
+			{
+				date.assign(p, comma - p);
+				
+				// The CSV is sorted, so inserting at the back is amortized O(1)
+				hint = _prices.insert(hint, std::make_pair(date, price));
+				hint->second = price;
+			}
+		}
+		if (eol)
+			complete = eol + 1 - start;
+		p = lineEnd + 1;
+	}
+	_table.endBulk();
+	_packStore();
+	return complete;
+}
+
+bool BitcoinExchange::loadDatabaseInPlace(const std::string &filename)
+{
+	PROFILE_SCOPE(PHASE_LOAD);
+	// Rows are parsed straight out of the page cache; the mapping ends in
+	// a '\0', as the buffer of _readWholeFile does
+	MappedFile file;
+	if (!file.open(filename))
 	{
 		std::cerr << "Error: could not open file." << std::endl;
-		return;
+		return false;
 	}
+	file.adviseSequential();
+	
+	const char *p = file.data();
+	const char *end = p + file.size();
 	
-	std::string line;
 	// Skip header
-	std::getline(file, line);
+	const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+	p = eol ? eol + 1 : end;
 	
-	while (std::getline(file, line))
+	_dbFile = filename;
+	_dbOffset = (p - file.data()) + _loadRows(p, end);
+	return true;
+}
+
+bool BitcoinExchange::appendRows(const std::string &rows)
+{
+	_loadRows(rows.data(), rows.data() + rows.size());
+	return true;
+}
+
+bool BitcoinExchange::appendDatabase(const std::string &filename)
+{
+	// A different file, or nothing loaded yet: load it from the start
+	if (filename != _dbFile)
+		return loadDatabaseInPlace(filename);
+	
+	MappedFile file;
+	if (!file.open(filename) || file.size() < _dbOffset)
 	{
-		if (line.empty())
-			continue;
-		
-		std::string date;
-		float value;
+		std::cerr << "Error: could not open file." << std::endl;
+		return false;
+	}
+	
+	// Only the pages past the old end are touched. A trailing line without
+	// newline is read again next time, once complete
+	_dbOffset += _loadRows(file.data() + _dbOffset, file.data() + file.size());
+	return true;
+}
+
+bool BitcoinExchange::reloadDatabase(const std::string &filename)
+{
+	// Build the new table on the side; the live one keeps answering until the swap
+	BitcoinExchange fresh;
+	fresh.setStoreMode(_storeMode);
+	fresh.setFixedPoint(_fixedPoint);
+	fresh.setInterpolationSearch(isInterpolationSearch());
+	if (!fresh.loadDatabaseInPlace(filename))
+		return false;
+	
+	_prices.swap(fresh._prices);
+	_table.swap(fresh._table);
+	_packed.swap(fresh._packed);
+	_dbFile.swap(fresh._dbFile);
+	_dbOffset = fresh._dbOffset;
+	_cache.invalidate();
+	return true;
+}
+
+bool BitcoinExchange::loadSnapshot(const std::string &filename)
+{
+	PriceTable table;
+	if (_fixedPoint)
+		table.enableScaled();
+	if (!table.loadSnapshot(filename))
+	{
+		std::cerr << "Error: could not open file." << std::endl;
+		return false;
+	}
+	_prices.clear();
+	_packed.clear();
+	_table.swap(table);
+	_storeMode = STORE_FLAT;
+	_dbFile.clear();
+	_dbOffset = 0;
+	_cache.invalidate();
+	return true;
+}
+
+bool BitcoinExchange::saveSnapshot(const std::string &filename) const
+{
+	if (_storeMode == STORE_FLAT)
+		return _table.saveSnapshot(filename);
+	
+	BitcoinExchange flat(*this);
+	flat.setStoreMode(STORE_FLAT);
+	return flat._table.saveSnapshot(filename);
+}
+
+unsigned int BitcoinExchange::valuate(const float *values, const float *rates, size_t n,
+	float *amounts, unsigned char *errors)
+{
+	// Range checks run on the IEEE bit patterns as integer compares and the
+	// result is masked rather than selected, so the loop has no branches and
+	// vectorizes without relaxed FP semantics: a negative float has the sign
+	// bit set (-0.0 excluded), and positive floats order like their bits
+	static const float limit = 1000.0f;
+	uint32_t limitBits;
+	std::memcpy(&limitBits, &limit, sizeof(limitBits));
+	
+	unsigned int failed = 0;
+	for (size_t i = 0; i < n; i++)
+	{
+		uint32_t bits;
+		std::memcpy(&bits, &values[i], sizeof(bits));
+		float product = values[i] * rates[i];
+		uint32_t productBits;
+		std::memcpy(&productBits, &product, sizeof(productBits));
 		
-		// First check if it's a valid date format
-		size_t pipePos = line.find('|');
-		if (pipePos != std::string::npos)
+		uint32_t negative = (bits >> 31) & (bits != 0x80000000u);
+		uint32_t tooLarge = (bits >> 31 == 0) & (bits > limitBits);
+		uint32_t error = negative | (tooLarge << 1);
+		errors[i] = static_cast<unsigned char>(error);
+		productBits &= (error != 0) - 1u;
+		std::memcpy(&amounts[i], &productBits, sizeof(productBits));
+		failed += error != 0;
+	}
+	return failed;
+}
+
+bool BitcoinExchange::rangeStats(const std::string &from, const std::string &to,
+	PriceTable::RangeStats &stats) const
+{
+	int first;
+	int last;
+	if (!PriceTable::packDate(from.c_str(), from.length(), first)
+		|| !PriceTable::packDate(to.c_str(), to.length(), last))
+		return false;
+	if (_storeMode == STORE_FLAT)
+		return _table.rangeStats(first, last, stats);
+	if (_storeMode == STORE_PACKED)
+		return _packed.rangeStats(first, last, stats);
+	
+	// "YYYY-MM-DD" keys order like their dates
+	std::map<std::string, float>::const_iterator it = _prices.lower_bound(from);
+	std::map<std::string, float>::const_iterator end = _prices.upper_bound(to);
+	if (first > last || it == end)
+		return false;
+	stats.count = 0;
+	stats.min = it->second;
+	stats.max = it->second;
+	double sum = 0.0;
+	for (; it != end; ++it)
+	{
+		stats.count++;
+		stats.min = std::min(stats.min, it->second);
+		stats.max = std::max(stats.max, it->second);
+		sum += it->second;
+	}
+	stats.mean = sum / stats.count;
+	return true;
+}
+
+void BitcoinExchange::evaluateBatch(const std::vector<Query> &queries, std::vector<Result> &results) const
+{
+	size_t n = queries.size();
+	results.resize(n);
+	if (n == 0)
+		return;
+	
+	// Resolve every rate first, as columns
+	std::vector<float> values(n);
+	std::vector<float> rates(n);
+	std::vector<char> found(n);
+	for (size_t i = 0; i < n; i++)
+		values[i] = queries[i].value;
+	
+	if (_storeMode == STORE_MAP)
+	{
+		char buf[11];
+		for (size_t i = 0; i < n; i++)
 		{
-			// Has pipe, try to parse
-			if (!_parseLine(line, date, value))
+			PriceTable::unpackDate(queries[i].date, buf);
+			rates[i] = 0.0f;
+			found[i] = _findRate(std::string(buf, 10), rates[i]);
+		}
+	}
+	else
+	{
+		std::vector<int> dates(n);
+		for (size_t i = 0; i < n; i++)
+			dates[i] = queries[i].date;
+		if (_storeMode == STORE_PACKED)
+		{
+			for (size_t i = 0; i < n; i++)
 			{
-				if (!_isValidDate(date))
-					std::cout << "Error: bad input => " << date << std::endl;
-				else if (value < 0)
-					std::cout << "Error: not a positive number." << std::endl;
-				else if (value > 1000)
-					std::cout << "Error: too large a number." << std::endl;
-				else
-					std::cout << "Error: bad input => " << line << std::endl;
-				continue;
+				rates[i] = 0.0f;
+				found[i] = _packed.find(dates[i], rates[i]);
 			}
 		}
 		else
+			_table.findBatch(dates, rates, found);
+	}
+	
+	// Then validate and multiply the whole batch in one kernel pass
+	std::vector<float> amounts(n);
+	std::vector<unsigned char> errors(n);
+	valuate(&values[0], &rates[0], n, &amounts[0], &errors[0]);
+	
+	for (size_t i = 0; i < n; i++)
+	{
+		results[i].found = found[i] != 0;
+		results[i].rate = rates[i];
+		results[i].amount = found[i] ? amounts[i] : 0.0f;
+		results[i].error = errors[i];
+	}
+}
+
+// Handle one input line; returns true when a result line was written
+bool BitcoinExchange::_processLine(const char *line, size_t len, size_t lineNo, OutputBuffer &out,
+	ErrorLog *errors, bool cached) const
+{
+	PROFILE_EVENT(EVENT_LINES);
+	const char *date = line;
+	size_t dateLen = 0;
+	float value = 0;
+	long long exact = 0;
+	
+	// First check if it's a valid date format
+	if (std::memchr(line, '|', len))
+	{
+		// Has pipe, try to parse
+		bool parsed = _fixedPoint ? _parseLine(line, len, date, dateLen, exact)
+			: _parseLine(line, len, date, dateLen, value);
+		if (!parsed)
 		{
-			// No pipe, it's a bad date
-			std::cout << "Error: bad input => " << line << std::endl;
-			continue;
+			bool negative = _fixedPoint ? exact < 0 : value < 0;
+			bool tooLarge = _fixedPoint ? exact > 1000 * Decimal::scale() : value > 1000;
+			if (!_isValidDate(date, dateLen))
+				_reportError(errors, lineNo, ErrorLog::BAD_DATE, date, dateLen, out);
+			else if (negative)
+				_reportError(errors, lineNo, ErrorLog::NOT_POSITIVE, NULL, 0, out);
+			else if (tooLarge)
+				_reportError(errors, lineNo, ErrorLog::TOO_LARGE, NULL, 0, out);
+			else
+				_reportError(errors, lineNo, ErrorLog::BAD_FORMAT, line, len, out);
+			return false;
 		}
+	}
+	else
+	{
+		// No pipe, it's a bad date
+		_reportError(errors, lineNo, ErrorLog::BAD_FORMAT, line, len, out);
+		return false;
+	}
+	
+	// Validate and pack the date once; the key feeds the lookup directly
+	int key;
+	float rate;
+	long long exactRate;
+	long long product;
+	bool validDate = _isValidDate(date, dateLen, key);
+	if (validDate && _fixedPoint && _table.findScaled(key, exactRate) && Decimal::multiply(exact, exactRate, product))
+	{
+		PROFILE_SCOPE(PHASE_OUTPUT);
+		PROFILE_EVENT(EVENT_RESULTS);
 		
-		// Find the price for this date
-		std::map<std::string, float>::iterator it = _prices.lower_bound(date);
+		// Exact: value and rate at 10^DIGITS, product at 10^(2 * DIGITS)
+		char buf[48];
+		out.append(date, dateLen);
+		out.append(" => ");
+		out.append(buf, Decimal::format(exact, Decimal::DIGITS, out.isFixed() ? 2 : -1, buf));
+		out.append(" = ");
+		out.setFixed(true);
+		out.append(buf, Decimal::format(product, 2 * Decimal::DIGITS, 2, buf));
+		out.put('\n');
+		return true;
+	}
+	else if (validDate && (cached ? _findRate(key, date, dateLen, rate) : _searchRate(key, date, dateLen, rate)))
+	{
+		PROFILE_SCOPE(PHASE_OUTPUT);
+		PROFILE_EVENT(EVENT_RESULTS);
 		
-		// If exact date exists, use it; otherwise use the one before
-		if (it != _prices.end() && it->first == date)
+		if (_fixedPoint)
+			value = static_cast<float>(exact) / Decimal::scale();
+		float result = value * rate;
+		out.append(date, dateLen);
+		out.append(" => ");
+		out.appendFloat(value);
+		out.append(" = ");
+		// The result switches the output to fixed, two decimals, from here on
+		out.setFixed(true);
+		out.appendFixed2(result);
+		out.put('\n');
+		return true;
+	}
+	_reportError(errors, lineNo, validDate ? ErrorLog::NO_RATE : ErrorLog::BAD_DATE, date, dateLen, out);
+	return false;
+}
+
+// Either one compact record in the error log, or the classic message in
+// the output; echo is the text shown after "bad input =>"
+void BitcoinExchange::_reportError(ErrorLog *errors, size_t lineNo, ErrorLog::Code code,
+	const char *echo, size_t echoLen, OutputBuffer &out) const
+{
+	PROFILE_EVENT(EVENT_ERRORS);
+	if (errors)
+	{
+		errors->record(lineNo, code);
+		return;
+	}
+	if (code == ErrorLog::NOT_POSITIVE)
+		out.append("Error: not a positive number.\n");
+	else if (code == ErrorLog::TOO_LARGE)
+		out.append("Error: too large a number.\n");
+	else
+	{
+		out.append("Error: bad input => ");
+		out.append(echo, echoLen);
+		out.put('\n');
+	}
+}
+
+void BitcoinExchange::processFile(const std::string &filename)
+{
+	std::ifstream file(filename.c_str(), std::ios::in | std::ios::binary);
+	if (!file.is_open())
+	{
+		std::cerr << "Error: could not open file." << std::endl;
+		return;
+	}
+	
+	// Large reads straight into our block; sequential reads of this size
+	// also keep the kernel read-ahead one block in front of the parser
+	_processBlocks(*file.rdbuf(), true, false);
+	file.close();
+}
+
+void BitcoinExchange::processStream(std::istream &in, bool skipHeader)
+{
+	_processBlocks(*in.rdbuf(), skipHeader, true);
+}
+
+// Shared line loop over a stream buffer. Interactive sources take whatever
+// has arrived and flush per batch; files fill a whole block per read
+void BitcoinExchange::_processBlocks(std::streambuf &sb, bool skipHeader, bool interactive)
+{
+	std::vector<char> buffer(interactive ? 1 << 16 : 1 << 20);
+	size_t filled = 0;
+	bool header = skipHeader;
+	size_t lineNo = 0;
+	OutputBuffer out(std::cout);
+	
+	for (;;)
+	{
+		// Interactive: block for at least one byte, then take whatever is
+		// already buffered, so a slow producer never waits for a full block
+		if (filled == buffer.size())
+			buffer.resize(buffer.size() * 2);
+		std::streamsize room = static_cast<std::streamsize>(buffer.size() - filled);
+		std::streamsize want = room;
+		if (interactive)
 		{
-			// Exact match
-			float result = value * it->second;
-			std::cout << date << " => " << value << " = " << std::fixed << std::setprecision(2) << result << std::endl;
+			if (sb.sgetc() == std::char_traits<char>::eof())
+				break;
+			std::streamsize avail = sb.in_avail();
+			want = avail < 1 ? 1 : (avail < room ? avail : room);
 		}
-		else if (it != _prices.begin())
+		std::streamsize got = sb.sgetn(&buffer[filled], want);
+		if (got <= 0)
+			break;
+		filled += static_cast<size_t>(got);
+		
+		// Handle every complete line; the partial tail moves to the front
+		const char *p = &buffer[0];
+		const char *end = p + filled;
+		const char *eol;
+		while ((eol = static_cast<const char *>(std::memchr(p, '\n', end - p))) != NULL)
+		{
+			lineNo++;
+			if (header)
+				header = false;
+			else if (eol != p)
+				_processLine(p, eol - p, lineNo, out, _errorLog);
+			p = eol + 1;
+		}
+		filled = end - p;
+		if (filled > 0 && p != &buffer[0])
+			std::memmove(&buffer[0], p, filled);
+		
+		// Results leave as soon as their block is done
+		if (interactive && sb.in_avail() <= 0)
 		{
-			// Use the previous date
-			--it;
-			float result = value * it->second;
-			std::cout << date << " => " << value << " = " << std::fixed << std::setprecision(2) << result << std::endl;
+			out.flush();
+			if (_errorLog)
+				_errorLog->flush();
+		}
+	}
+	
+	// Last line without a newline
+	if (filled > 0 && !header)
+		_processLine(&buffer[0], filled, lineNo + 1, out, _errorLog);
+	out.flush();
+	if (_errorLog)
+		_errorLog->flush();
+}
+
+// Process the newline-aligned byte range [begin, end) into chunk.out.
+// A const pass over read-only state, so ranges are independent of each other
+void BitcoinExchange::_processRange(Chunk &chunk, bool cached) const
+{
+	OutputBuffer out;
+	ErrorLog *errors = _errorLog ? &chunk.errors : NULL;
+	const char *begin = chunk.begin;
+	const char *end = chunk.end;
+	size_t lineNo = chunk.lineNo;
+	
+	chunk.hasResult = false;
+	while (begin < end)
+	{
+		const char *eol = static_cast<const char *>(std::memchr(begin, '\n', end - begin));
+		const char *lineEnd = eol ? eol : end;
+		
+		if (lineEnd != begin)
+		{
+			size_t start = out.str().size();
+			if (_processLine(begin, lineEnd - begin, lineNo, out, errors, cached) && !chunk.hasResult)
+			{
+				// Remember the first result line and how it looks once
+				// std::fixed is in effect, which is the case if any earlier range printed one
+				chunk.hasResult = true;
+				chunk.firstStart = start;
+				chunk.firstEnd = out.str().size();
+				OutputBuffer alt;
+				alt.setFixed(true);
+				_processLine(begin, lineEnd - begin, lineNo, alt, NULL, cached);
+				chunk.firstFixed = alt.str();
+			}
+		}
+		begin = lineEnd + 1;
+		lineNo++;
+	}
+	chunk.out = out.str();
+}
+
+void BitcoinExchange::ChunkJob::operator()(size_t first, size_t last) const
+{
+	for (size_t i = first; i < last; i++)
+		btc->_processRange((*chunks)[i], cached);
+}
+
+void BitcoinExchange::processFileChunked(const std::string &filename, size_t chunkCount)
+{
+	MappedFile file;
+	if (!file.open(filename))
+	{
+		std::cerr << "Error: could not open file." << std::endl;
+		return;
+	}
+	if (chunkCount == 0)
+		chunkCount = 1;
+	
+	const char *p = file.data();
+	const char *end = p + file.size();
+	
+	// Skip header
+	const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+	p = eol ? eol + 1 : end;
+	
+	// Split the rest into ranges that each end just after a newline
+	std::vector<const char *> bounds;
+	bounds.push_back(p);
+	size_t step = (end - p) / chunkCount + 1;
+	for (size_t i = 1; i < chunkCount; i++)
+	{
+		const char *cut = bounds.back() + step;
+		if (cut >= end)
+			break;
+		eol = static_cast<const char *>(std::memchr(cut, '\n', end - cut));
+		if (!eol)
+			break;
+		bounds.push_back(eol + 1);
+	}
+	bounds.push_back(end);
+	
+	// Each range numbers its lines from where the previous one stopped;
+	// the numbers are only reported to the error log
+	std::vector<Chunk> chunks(bounds.size() - 1);
+	size_t lineNo = 2;
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		chunks[i].begin = bounds[i];
+		chunks[i].end = bounds[i + 1];
+		chunks[i].lineNo = lineNo;
+		if (_errorLog)
+		{
+			chunks[i].errors = ErrorLog(true);
+			lineNo += std::count(bounds[i], bounds[i + 1], '\n');
+		}
+	}
+	
+	// One task per range; the ranges write only to their own chunk
+	ChunkJob job;
+	job.btc = this;
+	job.chunks = &chunks;
+	job.cached = chunks.size() == 1;
+	ThreadPool::shared().parallelFor(0, chunks.size(), 1, job);
+	
+	// Write in input order, reproducing the std::cout formatting state
+	// that a line-by-line run would have had
+	OutputBuffer out(std::cout);
+	for (size_t i = 0; i < chunks.size(); i++)
+	{
+		const Chunk &c = chunks[i];
+		if (c.hasResult && out.isFixed())
+		{
+			out.append(c.out.data(), c.firstStart);
+			out.append(c.firstFixed);
+			out.append(c.out.data() + c.firstEnd, c.out.size() - c.firstEnd);
 		}
 		else
+			out.append(c.out);
+		if (c.hasResult)
+			out.setFixed(true);
+		if (_errorLog)
+			_errorLog->merge(c.errors);
+	}
+	out.flush();
+	if (_errorLog)
+		_errorLog->flush();
+}
+
+bool BitcoinExchange::loadAssetDatabase(const std::string &filename)
+{
+	std::vector<char> buffer;
+	if (!_readWholeFile(filename, buffer))
+	{
+		std::cerr << "Error: could not open file." << std::endl;
+		return false;
+	}
+	
+	const char *p = &buffer[0];
+	const char *end = p + buffer.size() - 1;
+	
+	// Header: the first column is the date, every other one names an asset
+	const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+	const char *lineEnd = eol ? eol : end;
+	std::vector<std::string> names;
+	const char *comma = static_cast<const char *>(std::memchr(p, ',', lineEnd - p));
+	while (comma)
+	{
+		const char *next = static_cast<const char *>(std::memchr(comma + 1, ',', lineEnd - comma - 1));
+		const char *cellEnd = next ? next : lineEnd;
+		if (cellEnd > comma + 1 && cellEnd[-1] == '\r')
+			cellEnd--;
+		names.push_back(std::string(comma + 1, cellEnd));
+		comma = next;
+	}
+	
+	AssetTable table;
+	table.setAssets(names);
+	std::vector<float> row(names.size());
+	const float missing = std::numeric_limits<float>::quiet_NaN();
+	
+	p = lineEnd + 1;
+	while (p < end && !names.empty())
+	{
+		eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+		lineEnd = eol ? eol : end;
+		comma = static_cast<const char *>(std::memchr(p, ',', lineEnd - p));
+		
+		int key;
+		if (comma && PriceTable::packDate(p, comma - p, key))
 		{
-			std::cout << "Error: bad input => " << date << std::endl;
+			const char *cell = comma + 1;
+			for (size_t a = 0; a < row.size(); a++)
+			{
+				const char *next = static_cast<const char *>(std::memchr(cell, ',', lineEnd - cell));
+				const char *cellEnd = next ? next : lineEnd;
+				
+				// Cells are copied so strtof cannot run into the next line
+				char small[64];
+				size_t len = cellEnd - cell;
+				row[a] = missing;
+				if (len > 0 && len < sizeof(small))
+				{
+					std::memcpy(small, cell, len);
+					small[len] = '\0';
+					char *stop;
+					float rate = std::strtof(small, &stop);
+					if (stop != small)
+						row[a] = rate;
+				}
+				cell = next ? next + 1 : lineEnd;
+			}
+			table.insertRow(key, &row[0]);
 		}
+		p = lineEnd + 1;
+	}
+	
+	_assets.swap(table);
+	return true;
+}
+
+const AssetTable &BitcoinExchange::getAssets(void) const
+{
+	return _assets;
+}
+
+bool BitcoinExchange::_processAssetLine(const char *line, size_t len, size_t lineNo, OutputBuffer &out,
+	ErrorLog *errors) const
+{
+	const char *pipe = static_cast<const char *>(std::memchr(line, '|', len));
+	if (!pipe)
+	{
+		_reportError(errors, lineNo, ErrorLog::BAD_FORMAT, line, len, out);
+		return false;
+	}
+	
+	// "date | asset | value": split off the date, then split the rest again
+	const char *date;
+	size_t dateLen;
+	const char *rest;
+	size_t restLen;
+	_splitLine(line, len, pipe, date, dateLen, rest, restLen);
+	const char *pipe2 = static_cast<const char *>(std::memchr(rest, '|', restLen));
+	if (!pipe2)
+	{
+		_reportError(errors, lineNo, ErrorLog::BAD_FORMAT, line, len, out);
+		return false;
+	}
+	const char *asset;
+	size_t assetLen;
+	const char *valueStr;
+	size_t valueLen;
+	_splitLine(rest, restLen, pipe2, asset, assetLen, valueStr, valueLen);
+	
+	int key;
+	if (!_isValidDate(date, dateLen, key))
+	{
+		_reportError(errors, lineNo, ErrorLog::BAD_DATE, date, dateLen, out);
+		return false;
+	}
+	int column = _assets.assetIndex(asset, assetLen);
+	if (column < 0)
+	{
+		_reportError(errors, lineNo, ErrorLog::UNKNOWN_ASSET, line, len, out);
+		return false;
+	}
+	float value;
+	if (!_isValidValue(valueStr, valueLen, value))
+	{
+		ErrorLog::Code code = value < 0 ? ErrorLog::NOT_POSITIVE
+			: (value > 1000 ? ErrorLog::TOO_LARGE : ErrorLog::BAD_FORMAT);
+		_reportError(errors, lineNo, code, line, len, out);
+		return false;
+	}
+	float rate;
+	if (!_assets.find(key, column, rate))
+	{
+		_reportError(errors, lineNo, ErrorLog::NO_RATE, date, dateLen, out);
+		return false;
+	}
+	
+	out.append(date, dateLen);
+	out.append(" => ");
+	out.append(asset, assetLen);
+	out.put(' ');
+	out.appendFloat(value);
+	out.append(" = ");
+	out.setFixed(true);
+	out.appendFixed2(value * rate);
+	out.put('\n');
+	return true;
+}
+
+void BitcoinExchange::processAssetFile(const std::string &filename)
+{
+	std::ifstream file(filename.c_str());
+	if (!file.is_open())
+	{
+		std::cerr << "Error: could not open file." << std::endl;
+		return;
+	}
+	
+	std::string line;
+	// Skip header
+	std::getline(file, line);
+	
+	OutputBuffer out(std::cout);
+	size_t lineNo = 1;
+	while (std::getline(file, line))
+	{
+		lineNo++;
+		if (line.empty())
+			continue;
+		_processAssetLine(line.data(), line.size(), lineNo, out, _errorLog);
+	}
+	out.flush();
+	if (_errorLog)
+		_errorLog->flush();
+	
+	file.close();
+}
+
+void BitcoinExchange::evaluatePortfolio(int date, const std::vector<float> &holdings,
+	std::vector<Result> &results) const
+{
+	size_t n = holdings.size() < _assets.assetCount() ? holdings.size() : _assets.assetCount();
+	results.resize(n);
+	if (n == 0)
+		return;
+	
+	// The date search runs once; every asset reads its column at that row
+	size_t upper = _assets.upperIndex(date);
+	std::vector<float> rates(n);
+	std::vector<char> found(n);
+	for (size_t a = 0; a < n; a++)
+	{
+		rates[a] = 0.0f;
+		found[a] = _assets.rateBefore(upper, a, rates[a]);
+	}
+	
+	std::vector<float> amounts(n);
+	std::vector<unsigned char> errors(n);
+	valuate(&holdings[0], &rates[0], n, &amounts[0], &errors[0]);
+	for (size_t a = 0; a < n; a++)
+	{
+		results[a].rate = rates[a];
+		results[a].found = found[a] != 0;
+		results[a].error = errors[a];
+		results[a].amount = found[a] ? amounts[a] : 0.0f;
+	}
+}
+
+bool BitcoinExchange::loadTickDatabase(const std::string &filename)
+{
+	PROFILE_SCOPE(PHASE_LOAD);
+	std::vector<char> buffer;
+	if (!_readWholeFile(filename, buffer))
+	{
+		std::cerr << "Error: could not open file." << std::endl;
+		return false;
+	}
+	
+	const char *p = &buffer[0];
+	const char *end = p + buffer.size() - 1;
+	
+	// Skip header
+	const char *eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+	p = eol ? eol + 1 : end;
+	
+	TickTable table;
+	while (p < end)
+	{
+		eol = static_cast<const char *>(std::memchr(p, '\n', end - p));
+		const char *lineEnd = eol ? eol : end;
+		const char *comma = static_cast<const char *>(std::memchr(p, ',', lineEnd - p));
+		
+		int day;
+		int second;
+		long long scaled;
+		if (comma && TickTable::packTimestamp(p, comma - p, day, second) && Decimal::parse(comma + 1, lineEnd, scaled))
+			table.append(day, second, scaled);
+		p = lineEnd + 1;
+	}
+	
+	table.shrink();
+	_ticks.swap(table);
+	return true;
+}
+
+const TickTable &BitcoinExchange::getTicks(void) const
+{
+	return _ticks;
+}
+
+bool BitcoinExchange::_processTickLine(const char *line, size_t len, size_t lineNo, OutputBuffer &out,
+	ErrorLog *errors) const
+{
+	const char *pipe = static_cast<const char *>(std::memchr(line, '|', len));
+	if (!pipe)
+	{
+		_reportError(errors, lineNo, ErrorLog::BAD_FORMAT, line, len, out);
+		return false;
+	}
+	
+	const char *stamp;
+	size_t stampLen;
+	const char *valueStr;
+	size_t valueLen;
+	_splitLine(line, len, pipe, stamp, stampLen, valueStr, valueLen);
+	
+	int day;
+	int second;
+	if (!_isValidTimestamp(stamp, stampLen, day, second))
+	{
+		_reportError(errors, lineNo, ErrorLog::BAD_DATE, stamp, stampLen, out);
+		return false;
+	}
+	float value;
+	if (!_isValidValue(valueStr, valueLen, value))
+	{
+		ErrorLog::Code code = value < 0 ? ErrorLog::NOT_POSITIVE
+			: (value > 1000 ? ErrorLog::TOO_LARGE : ErrorLog::BAD_FORMAT);
+		_reportError(errors, lineNo, code, line, len, out);
+		return false;
+	}
+	float rate;
+	if (!_ticks.find(day, second, rate))
+	{
+		_reportError(errors, lineNo, ErrorLog::NO_RATE, stamp, stampLen, out);
+		return false;
+	}
+	
+	out.append(stamp, stampLen);
+	out.append(" => ");
+	out.appendFloat(value);
+	out.append(" = ");
+	out.setFixed(true);
+	out.appendFixed2(value * rate);
+	out.put('\n');
+	return true;
+}
+
+void BitcoinExchange::processTickFile(const std::string &filename)
+{
+	std::ifstream file(filename.c_str());
+	if (!file.is_open())
+	{
+		std::cerr << "Error: could not open file." << std::endl;
+		return;
+	}
+	
+	std::string line;
+	// Skip header
+	std::getline(file, line);
+	
+	OutputBuffer out(std::cout);
+	size_t lineNo = 1;
+	while (std::getline(file, line))
+	{
+		lineNo++;
+		if (line.empty())
+			continue;
+		_processTickLine(line.data(), line.size(), lineNo, out, _errorLog);
 	}
+	out.flush();
+	if (_errorLog)
+		_errorLog->flush();
 	
 	file.close();
 }
@@ -3,17 +3,133 @@
 
 #include <string>
 #include <map>
+#include <vector>
 #include <iostream>
+#include "PriceTable.hpp"
+#include "PackedTable.hpp"
+#include "AssetTable.hpp"
+#include "TickTable.hpp"
+#include "OutputBuffer.hpp"
+#include "RateCache.hpp"
+#include "ErrorLog.hpp"
 
 class BitcoinExchange
 {
+	public:
+		// Where loaded prices are kept
+		enum StoreMode
+		{
+			STORE_MAP,
+			STORE_FLAT,
+			STORE_PACKED	// the flat store compressed (see PackedTable)
+		};
+		
+		// One batch query: a packed date (see PriceTable::packDate) and an amount
+		struct Query
+		{
+			int date;
+			float value;
+		};
+		
+		// Error bits reported by valuate
+		enum ValueError
+		{
+			VALUE_OK = 0,
+			VALUE_NEGATIVE = 1,
+			VALUE_TOO_LARGE = 2
+		};
+		
+		// Outcome of one batch query; rate and amount are set only when found,
+		// and amount is 0 when error holds ValueError bits
+		struct Result
+		{
+			float rate;
+			float amount;
+			bool found;
+			unsigned char error;
+		};
+		
 	private:
+		// Output of one input range in chunked mode
+		struct Chunk
+		{
+			std::string out;
+			bool hasResult;
+			size_t firstStart;
+			size_t firstEnd;
+			std::string firstFixed;
+			ErrorLog errors;
+			
+			// Where the range is, and the number of its first line
+			const char *begin;
+			const char *end;
+			size_t lineNo;
+		};
+		
+		// Body of the parallel loop over the chunks of processFileChunked
+		struct ChunkJob
+		{
+			const BitcoinExchange *btc;
+			std::vector<Chunk> *chunks;
+			bool cached;
+			
+			void operator()(size_t first, size_t last) const;
+		};
+		
 		std::map<std::string, float> _prices;
+		PriceTable _table;
+		StoreMode _storeMode;
+		
+		// Rows of the packed store; _table is empty then, except while loading
+		PackedTable _packed;
+		
+		// Exact decimal prices and amounts instead of float (flat store only)
+		bool _fixedPoint;
+		
+		// Wide multi-asset database, separate from the single-rate store
+		AssetTable _assets;
+		
+		// Intraday ticks by timestamp, separate from the daily store
+		TickTable _ticks;
+		
+		// CSV the store was loaded from, and how far it has been read
+		std::string _dbFile;
+		size_t _dbOffset;
+		
+		// Lookup results by packed date; filled from const lookups, hence mutable
+		mutable RateCache _cache;
+		
+		// Where bad lines go instead of the output, when set (not owned)
+		ErrorLog *_errorLog;
 		
 		// Private helper functions
-		bool _isValidDate(const std::string &date);
-		bool _isValidValue(const std::string &valueStr, float &value);
-		bool _parseLine(const std::string &line, std::string &date, float &value);
+		bool _isValidDate(const std::string &date) const;
+		bool _isValidDate(const char *date, size_t len) const;
+		bool _isValidDate(const char *date, size_t len, int &key) const;
+		bool _isValidTimestamp(const char *stamp, size_t len, int &day, int &second) const;
+		bool _isValidValue(const char *valueStr, size_t len, float &value) const;
+		bool _isValidValue(const char *valueStr, size_t len, long long &value) const;
+		void _splitLine(const char *line, size_t len, const char *pipe, const char *&date, size_t &dateLen,
+			const char *&valueStr, size_t &valueLen) const;
+		bool _parseLine(const char *line, size_t len, const char *&date, size_t &dateLen, float &value) const;
+		bool _parseLine(const char *line, size_t len, const char *&date, size_t &dateLen, long long &value) const;
+		bool _processLine(const char *line, size_t len, size_t lineNo, OutputBuffer &out, ErrorLog *errors,
+			bool cached = true) const;
+		void _reportError(ErrorLog *errors, size_t lineNo, ErrorLog::Code code, const char *echo, size_t echoLen,
+			OutputBuffer &out) const;
+		void _unpackStore(void);
+		void _packStore(void);
+		void _storeRate(const std::string &date, float price);
+		bool _findRate(const std::string &date, float &rate) const;
+		bool _findRate(const char *date, size_t len, float &rate) const;
+		bool _findRate(int key, const char *date, size_t len, float &rate) const;
+		bool _searchRate(int key, const char *date, size_t len, float &rate) const;
+		bool _readWholeFile(const std::string &filename, std::vector<char> &buffer, size_t offset = 0);
+		size_t _loadRows(const char *p, const char *end);
+		void _processRange(Chunk &chunk, bool cached) const;
+		void _processBlocks(std::streambuf &sb, bool skipHeader, bool interactive);
+		bool _processAssetLine(const char *line, size_t len, size_t lineNo, OutputBuffer &out, ErrorLog *errors) const;
+		bool _processTickLine(const char *line, size_t len, size_t lineNo, OutputBuffer &out, ErrorLog *errors) const;
 		
 	public:
 		// Constructors
@@ -26,11 +142,102 @@ class BitcoinExchange
 		// Destructor
 		~BitcoinExchange(void);
 		
+		// Select the price store; already loaded prices are moved over. The
+		// packed store is read-mostly: each load or append unpacks it into
+		// the flat table and packs the result again
+		void setStoreMode(StoreMode mode);
+		StoreMode getStoreMode(void) const;
+		
+		// Exact fixed-point mode: prices and amounts are parsed as scaled integers
+		// (see Decimal) and results are printed from the exact product. Selects
+		// the flat store; plain decimals only ("1e2" is bad input here)
+		void setFixedPoint(bool enabled);
+		bool isFixedPoint(void) const;
+		
+		// Look dates up in the flat store by interpolation instead of bisection
+		void setInterpolationSearch(bool enabled);
+		bool isInterpolationSearch(void) const;
+		
+		// Direct-mapped result cache in front of the date search (float rates
+		// only); slots is rounded down to a power of two and 0 turns it off
+		void setCacheSize(size_t slots);
+		const RateCache &getCache(void) const;
+		
+		// Send bad lines to log as counted records instead of printing an
+		// error message for each; NULL restores the messages. The log must
+		// outlive the processing calls
+		void setErrorLog(ErrorLog *log);
+		ErrorLog *getErrorLog(void) const;
+		
 		// Load price database from CSV file
 		bool loadDatabase(const std::string &filename);
 		
+		// Load price database by mapping the file and scanning it in place; a
+		// file that cannot be mapped, such as a pipe, is read into one buffer
+		bool loadDatabaseInPlace(const std::string &filename);
+		
+		// Add "date,rate" rows (no header); later rows overwrite earlier dates
+		bool appendRows(const std::string &rows);
+		
+		// Read only what was appended to the loaded CSV since the last load or append
+		bool appendDatabase(const std::string &filename);
+		
+		// Load the CSV into a new table, then swap it in for the current one
+		bool reloadDatabase(const std::string &filename);
+		
+		// Load or write a binary snapshot (see PriceTable); loading selects the flat store
+		bool loadSnapshot(const std::string &filename);
+		bool saveSnapshot(const std::string &filename) const;
+		
+		// Valuation kernel over columns: amounts[i] = values[i] * rates[i] where
+		// 0 <= values[i] <= 1000, otherwise errors[i] gets ValueError bits.
+		// Returns how many entries failed
+		static unsigned int valuate(const float *values, const float *rates, size_t n,
+			float *amounts, unsigned char *errors);
+		
+		// Count, min, max and mean of the rates of the database rows dated
+		// from..to ("YYYY-MM-DD", both included); false on a bad date or when
+		// no row falls in the interval. O(1) on the flat store, the headers
+		// and two blocks on the packed one, a scan of the rows in the
+		// interval on the map
+		bool rangeStats(const std::string &from, const std::string &to, PriceTable::RangeStats &stats) const;
+		
+		// Resolve a batch of queries; sorted batches take one merge pass
+		void evaluateBatch(const std::vector<Query> &queries, std::vector<Result> &results) const;
+		
 		// Process input file with dates and values
 		void processFile(const std::string &filename);
+		
+		// Same output as processFile, reading lines from a stream (a pipe, std::cin)
+		// in blocks as they arrive instead of from a named file
+		void processStream(std::istream &in, bool skipHeader = true);
+		
+		// Same output as processFile, computed over chunkCount independent
+		// newline-aligned ranges of the input on the threads of the shared
+		// ThreadPool. Workers only read the price store; with more than one
+		// range they bypass the result cache, whose slots are not shared
+		void processFileChunked(const std::string &filename, size_t chunkCount);
+		
+		// Load a wide CSV, "date,<asset>,<asset>,..." with one rate per asset
+		// per row; an empty cell means no price for that asset on that date
+		bool loadAssetDatabase(const std::string &filename);
+		const AssetTable &getAssets(void) const;
+		
+		// Process "date | asset | value" lines against the asset database
+		void processAssetFile(const std::string &filename);
+		
+		// Value holdings[i] of asset i at date with a single date search;
+		// entries past assetCount() are ignored
+		void evaluatePortfolio(int date, const std::vector<float> &holdings, std::vector<Result> &results) const;
+		
+		// Load a tick CSV, "YYYY-MM-DD HH:MM:SS,price" rows in time order;
+		// rows earlier than the one before them are skipped
+		bool loadTickDatabase(const std::string &filename);
+		const TickTable &getTicks(void) const;
+		
+		// Process "YYYY-MM-DD HH:MM:SS | value" lines against the latest
+		// tick at or before each timestamp
+		void processTickFile(const std::string &filename);
 };
 
 #endif
@@ -0,0 +1,129 @@
+#include "Decimal.hpp"
+
+static const long long MAX_SCALED = 9223372036854775807LL;
+
+long long Decimal::scale(void)
+{
+	return 10000;
+}
+
+const char *Decimal::parse(const char *str, const char *end, long long &scaled)
+{
+	const char *p = str;
+	bool negative = false;
+	if (p < end && (*p == '+' || *p == '-'))
+	{
+		negative = *p == '-';
+		p++;
+	}
+	
+	long long whole = 0;
+	const char *digits = p;
+	while (p < end && *p >= '0' && *p <= '9')
+	{
+		if (whole > (MAX_SCALED / scale() - 9) / 10)
+			return NULL;
+		whole = whole * 10 + (*p - '0');
+		p++;
+	}
+	bool hasWhole = p != digits;
+	
+	long long frac = 0;
+	int fracDigits = 0;
+	bool roundUp = false;
+	bool hasFrac = false;
+	if (p < end && *p == '.')
+	{
+		p++;
+		while (p < end && *p >= '0' && *p <= '9')
+		{
+			if (fracDigits < DIGITS)
+			{
+				frac = frac * 10 + (*p - '0');
+				fracDigits++;
+			}
+			else if (fracDigits == DIGITS)
+			{
+				roundUp = *p >= '5';
+				fracDigits++;
+			}
+			hasFrac = true;
+			p++;
+		}
+	}
+	if (!hasWhole && !hasFrac)
+		return NULL;
+	
+	for (int i = fracDigits; i < DIGITS; i++)
+		frac *= 10;
+	scaled = whole * scale() + frac + (roundUp ? 1 : 0);
+	if (negative)
+		scaled = -scaled;
+	return p;
+}
+
+bool Decimal::multiply(long long a, long long b, long long &product)
+{
+	long long ua = a < 0 ? -a : a;
+	long long ub = b < 0 ? -b : b;
+	if (ua != 0 && ub > MAX_SCALED / ua)
+		return false;
+	product = a * b;
+	return true;
+}
+
+size_t Decimal::format(long long value, int scaleDigits, int decimals, char *out)
+{
+	bool negative = value < 0;
+	unsigned long long v = negative ? -static_cast<unsigned long long>(value) : value;
+	
+	// Round away the digits that are not printed
+	int keep = decimals < 0 ? scaleDigits : decimals;
+	if (keep > scaleDigits)
+		keep = scaleDigits;
+	unsigned long long div = 1;
+	for (int i = keep; i < scaleDigits; i++)
+		div *= 10;
+	v = (v + div / 2) / div;
+	
+	unsigned long long unit = 1;
+	for (int i = 0; i < keep; i++)
+		unit *= 10;
+	unsigned long long whole = v / unit;
+	unsigned long long frac = v % unit;
+	
+	if (decimals < 0)
+	{
+		// Drop trailing zeros, and the point with them
+		while (keep > 0 && frac % 10 == 0)
+		{
+			frac /= 10;
+			keep--;
+		}
+	}
+	
+	// Digits are written right to left
+	char tmp[48];
+	char *p = tmp + sizeof(tmp);
+	for (int i = keep; i < decimals; i++)
+		*--p = '0';
+	for (int i = 0; i < keep; i++)
+	{
+		*--p = '0' + frac % 10;
+		frac /= 10;
+	}
+	if (keep > 0 || decimals > 0)
+		*--p = '.';
+	do
+	{
+		*--p = '0' + whole % 10;
+		whole /= 10;
+	} while (whole);
+	if (negative && v != 0)
+		*--p = '-';
+	
+	size_t len = tmp + sizeof(tmp) - p;
+	for (size_t i = 0; i < len; i++)
+		out[i] = p[i];
+	return len;
+}
@@ -0,0 +1,36 @@
+#ifndef DECIMAL_HPP
+#define DECIMAL_HPP
+
+#include <cstddef>
+
+// Exact decimal fixed-point helpers: numbers are 64-bit integers holding
+// value * 10^DIGITS, so "7.1" is kept as 71000 with no binary rounding
+class Decimal
+{
+	private:
+		// Private constructor to prevent instantiation
+		Decimal(void);
+		Decimal(const Decimal &other);
+		Decimal &operator=(const Decimal &other);
+		~Decimal(void);
+		
+	public:
+		// Digits kept after the decimal point
+		static const int DIGITS = 4;
+		
+		// 10^DIGITS
+		static long long scale(void);
+		
+		// Parse [+-]digits[.digits] from [str, end); extra decimals are rounded half up.
+		// Returns the end of the number, or NULL when there is none or it overflows
+		static const char *parse(const char *str, const char *end, long long &scaled);
+		
+		// a * b, both at 10^DIGITS, giving a product at 10^(2 * DIGITS); false on overflow
+		static bool multiply(long long a, long long b, long long &product);
+		
+		// Write value / 10^scaleDigits with the given decimals (rounded half up);
+		// decimals < 0 drops trailing zeros instead. out needs 32 bytes
+		static size_t format(long long value, int scaleDigits, int decimals, char *out);
+};
+
+#endif
@@ -0,0 +1,119 @@
+#include "ErrorLog.hpp"
+
+ErrorLog::ErrorLog(void) : _keepRecords(false)
+{
+	for (int i = 0; i < CODE_COUNT; i++)
+		_counts[i] = 0;
+}
+
+ErrorLog::ErrorLog(std::ostream &out) : _records(out), _keepRecords(true)
+{
+	for (int i = 0; i < CODE_COUNT; i++)
+		_counts[i] = 0;
+}
+
+ErrorLog::ErrorLog(bool keepRecords) : _keepRecords(keepRecords)
+{
+	for (int i = 0; i < CODE_COUNT; i++)
+		_counts[i] = 0;
+}
+
+ErrorLog::ErrorLog(const ErrorLog &other) : _records(other._records), _keepRecords(other._keepRecords)
+{
+	for (int i = 0; i < CODE_COUNT; i++)
+		_counts[i] = other._counts[i];
+}
+
+ErrorLog &ErrorLog::operator=(const ErrorLog &other)
+{
+	if (this != &other)
+	{
+		_records = other._records;
+		_keepRecords = other._keepRecords;
+		for (int i = 0; i < CODE_COUNT; i++)
+			_counts[i] = other._counts[i];
+	}
+	return *this;
+}
+
+ErrorLog::~ErrorLog(void)
+{
+}
+
+void ErrorLog::record(size_t line, Code code)
+{
+	_counts[code]++;
+	if (!_keepRecords)
+		return;
+	_records.appendUnsigned(line);
+	_records.put(' ');
+	_records.put(static_cast<char>('0' + code));
+	_records.put('\n');
+}
+
+void ErrorLog::merge(const ErrorLog &other)
+{
+	for (int i = 0; i < CODE_COUNT; i++)
+		_counts[i] += other._counts[i];
+	if (_keepRecords)
+		_records.append(other._records.str());
+}
+
+unsigned long ErrorLog::count(Code code) const
+{
+	return _counts[code];
+}
+
+unsigned long ErrorLog::total(void) const
+{
+	unsigned long sum = 0;
+	for (int i = 1; i < CODE_COUNT; i++)
+		sum += _counts[i];
+	return sum;
+}
+
+const std::string &ErrorLog::records(void) const
+{
+	return _records.str();
+}
+
+void ErrorLog::summary(std::ostream &out) const
+{
+	out << "errors: " << total();
+	for (int i = 1; i < CODE_COUNT; i++)
+		out << ", " << codeName(static_cast<Code>(i)) << " " << _counts[i];
+	out << std::endl;
+}
+
+void ErrorLog::flush(void)
+{
+	_records.flush();
+}
+
+void ErrorLog::clear(void)
+{
+	_records.clear();
+	for (int i = 0; i < CODE_COUNT; i++)
+		_counts[i] = 0;
+}
+
+const char *ErrorLog::codeName(Code code)
+{
+	switch (code)
+	{
+		case BAD_FORMAT:
+			return "bad format";
+		case BAD_DATE:
+			return "bad date";
+		case NOT_POSITIVE:
+			return "not positive";
+		case TOO_LARGE:
+			return "too large";
+		case NO_RATE:
+			return "no rate";
+		case UNKNOWN_ASSET:
+			return "unknown asset";
+		default:
+			return "unknown";
+	}
+}
@@ -0,0 +1,67 @@
+#ifndef ERRORLOG_HPP
+#define ERRORLOG_HPP
+
+#include <ostream>
+#include <cstddef>
+#include "OutputBuffer.hpp"
+
+// Error accounting for input lines: counts per category, plus one compact
+// "<line> <code>\n" record per bad line instead of a formatted message
+class ErrorLog
+{
+	public:
+		enum Code
+		{
+			BAD_FORMAT = 1,		// no '|' or an unparsable value
+			BAD_DATE = 2,		// malformed or impossible date
+			NOT_POSITIVE = 3,	// negative amount
+			TOO_LARGE = 4,		// amount above 1000
+			NO_RATE = 5,		// date before the first known price
+			UNKNOWN_ASSET = 6,	// asset column not in the database
+			CODE_COUNT = 7
+		};
+		
+	private:
+		OutputBuffer _records;
+		bool _keepRecords;
+		unsigned long _counts[CODE_COUNT];
+		
+	public:
+		// Count only, no records
+		ErrorLog(void);
+		
+		// Records written to out in large blocks
+		ErrorLog(std::ostream &out);
+		
+		// Memory-only records, read back through records()
+		explicit ErrorLog(bool keepRecords);
+		
+		// Copy constructor
+		ErrorLog(const ErrorLog &other);
+		
+		// Assignment operator
+		ErrorLog &operator=(const ErrorLog &other);
+		
+		// Destructor (flushes)
+		~ErrorLog(void);
+		
+		// line is the 1-based line number in the input, header included
+		void record(size_t line, Code code);
+		
+		// Add other's counts and append its records after ours
+		void merge(const ErrorLog &other);
+		
+		unsigned long count(Code code) const;
+		unsigned long total(void) const;
+		const std::string &records(void) const;
+		
+		// One line: total, then the count of every category
+		void summary(std::ostream &out) const;
+		
+		void flush(void);
+		void clear(void);
+		
+		static const char *codeName(Code code);
+};
+
+#endif
@@ -0,0 +1,138 @@
+#include "MappedFile.hpp"
+#include <algorithm>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+static const char EMPTY[1] = { '\0' };
+
+MappedFile::MappedFile(void) : _data(EMPTY), _size(0), _map(NULL), _mapSize(0)
+{
+}
+
+MappedFile::MappedFile(const MappedFile &other) : _data(EMPTY), _size(0), _map(NULL), _mapSize(0)
+{
+	(void)other;
+}
+
+MappedFile &MappedFile::operator=(const MappedFile &other)
+{
+	(void)other;
+	return *this;
+}
+
+MappedFile::~MappedFile(void)
+{
+	close();
+}
+
+bool MappedFile::open(const std::string &filename)
+{
+	close();
+	int fd = ::open(filename.c_str(), O_RDONLY);
+	if (fd < 0)
+		return false;
+	
+	struct stat st;
+	bool ok = fstat(fd, &st) == 0;
+	bool mapped = ok && S_ISREG(st.st_mode) && st.st_size > 0 && _mapFd(fd, static_cast<size_t>(st.st_size));
+	if (ok && !mapped)
+		ok = _readFd(fd);
+	::close(fd);
+	if (!ok)
+		close();
+	return ok;
+}
+
+// Reserve the file size plus one byte, rounded up to pages, as zeroed
+// anonymous memory, then map the file over its start: whatever follows
+// the last file byte reads as zero
+bool MappedFile::_mapFd(int fd, size_t size)
+{
+	size_t page = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+	size_t total = (size + 1 + page - 1) / page * page;
+	void *region = mmap(NULL, total, PROT_READ, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (region == MAP_FAILED)
+		return false;
+	if (mmap(region, size, PROT_READ, MAP_PRIVATE | MAP_FIXED, fd, 0) == MAP_FAILED)
+	{
+		munmap(region, total);
+		return false;
+	}
+	_map = region;
+	_mapSize = total;
+	_data = static_cast<const char *>(region);
+	_size = size;
+	return true;
+}
+
+// Read until end of file, for what cannot be mapped
+bool MappedFile::_readFd(int fd)
+{
+	std::vector<char> copy(1 << 16);
+	size_t used = 0;
+	for (;;)
+	{
+		if (copy.size() - used < (1 << 15))
+			copy.resize(copy.size() * 2);
+		ssize_t got = read(fd, &copy[used], copy.size() - used - 1);
+		if (got < 0 && errno == EINTR)
+			continue;
+		if (got < 0)
+			return false;
+		if (got == 0)
+			break;
+		used += static_cast<size_t>(got);
+	}
+	copy[used] = '\0';
+	copy.resize(used + 1);
+	_copy.swap(copy);
+	_data = &_copy[0];
+	_size = used;
+	return true;
+}
+
+void MappedFile::close(void)
+{
+	if (_map)
+		munmap(_map, _mapSize);
+	_map = NULL;
+	_mapSize = 0;
+	std::vector<char>().swap(_copy);
+	_data = EMPTY;
+	_size = 0;
+}
+
+void MappedFile::adviseSequential(void) const
+{
+	if (_map)
+		madvise(_map, _mapSize, MADV_SEQUENTIAL);
+}
+
+void MappedFile::swap(MappedFile &other)
+{
+	std::swap(_data, other._data);
+	std::swap(_size, other._size);
+	std::swap(_map, other._map);
+	std::swap(_mapSize, other._mapSize);
+	
+	// The copies keep their addresses through a vector swap
+	_copy.swap(other._copy);
+}
+
+const char *MappedFile::data(void) const
+{
+	return _data;
+}
+
+size_t MappedFile::size(void) const
+{
+	return _size;
+}
+
+bool MappedFile::isMapped(void) const
+{
+	return _map != NULL;
+}
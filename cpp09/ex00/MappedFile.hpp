@@ -0,0 +1,54 @@
+#ifndef MAPPEDFILE_HPP
+#define MAPPEDFILE_HPP
+
+#include <string>
+#include <vector>
+#include <cstddef>
+
+// A whole file in memory, mapped read-only where the system allows it and
+// read into a buffer otherwise (pipes, empty files, a failed mmap). Either
+// way data()[size()] is a '\0' sentinel, so scans such as strtof stop at
+// the end: a file that fills its last page exactly gets a zero page mapped
+// after it. The bytes stay valid until close, open or the destructor
+class MappedFile
+{
+	private:
+		const char *_data;
+		size_t _size;
+		
+		// The mapping, file pages and sentinel page together
+		void *_map;
+		size_t _mapSize;
+		
+		// The fallback copy, size() bytes and the sentinel
+		std::vector<char> _copy;
+		
+		bool _mapFd(int fd, size_t size);
+		bool _readFd(int fd);
+		
+		// A mapping has one owner: no copies
+		MappedFile(const MappedFile &other);
+		MappedFile &operator=(const MappedFile &other);
+		
+	public:
+		// Constructor: nothing open, an empty file
+		MappedFile(void);
+		
+		// Destructor
+		~MappedFile(void);
+		
+		// Map filename, dropping what was open; false if it cannot be opened
+		bool open(const std::string &filename);
+		void close(void);
+		
+		// Tell the kernel the bytes are read front to back (madvise)
+		void adviseSequential(void) const;
+		
+		void swap(MappedFile &other);
+		
+		const char *data(void) const;
+		size_t size(void) const;
+		bool isMapped(void) const;
+};
+
+#endif
@@ -0,0 +1,161 @@
+#include "OutputBuffer.hpp"
+#include "Profiler.hpp"
+#include <sstream>
+#include <iomanip>
+#include <cmath>
+#include <cstring>
+
+OutputBuffer::OutputBuffer(void) : _out(NULL), _blockSize(0), _fixed(false)
+{
+}
+
+OutputBuffer::OutputBuffer(std::ostream &out, size_t blockSize)
+	: _out(&out), _blockSize(blockSize), _fixed((out.flags() & std::ios::fixed) != 0)
+{
+	_buf.reserve(blockSize + 128);
+}
+
+OutputBuffer::OutputBuffer(const OutputBuffer &other)
+	: _out(other._out), _buf(other._buf), _blockSize(other._blockSize), _fixed(other._fixed)
+{
+}
+
+OutputBuffer &OutputBuffer::operator=(const OutputBuffer &other)
+{
+	if (this != &other)
+	{
+		_out = other._out;
+		_buf = other._buf;
+		_blockSize = other._blockSize;
+		_fixed = other._fixed;
+	}
+	return *this;
+}
+
+OutputBuffer::~OutputBuffer(void)
+{
+	flush();
+}
+
+void OutputBuffer::put(char c)
+{
+	_buf += c;
+	if (_out && _buf.size() >= _blockSize)
+		flush();
+}
+
+void OutputBuffer::append(const char *str, size_t len)
+{
+	_buf.append(str, len);
+	if (_out && _buf.size() >= _blockSize)
+		flush();
+}
+
+void OutputBuffer::append(const std::string &str)
+{
+	append(str.data(), str.size());
+}
+
+void OutputBuffer::append(const char *str)
+{
+	append(str, std::strlen(str));
+}
+
+void OutputBuffer::appendUnsigned(unsigned long n)
+{
+	char tmp[24];
+	char *p = tmp + sizeof(tmp);
+	do
+	{
+		*--p = '0' + n % 10;
+		n /= 10;
+	} while (n);
+	append(p, tmp + sizeof(tmp) - p);
+}
+
+void OutputBuffer::appendFixed2(double x)
+{
+	// x * 100 is exact for any float operand, so rounding it half-to-even
+	// gives the same digits as printf("%.2f"); very large values fall back
+	double scaled = x * 100.0;
+	if (!(std::fabs(scaled) < 9.0e15))
+	{
+		std::ostringstream oss;
+		oss << std::fixed << std::setprecision(2) << x;
+		append(oss.str());
+		return;
+	}
+	
+	bool negative = x < 0 || (x == 0 && 1.0 / x < 0);
+	double whole = std::floor(std::fabs(scaled));
+	double frac = std::fabs(scaled) - whole;
+	unsigned long long cents = static_cast<unsigned long long>(whole);
+	if (frac > 0.5 || (frac == 0.5 && (cents & 1)))
+		cents++;
+	
+	char tmp[32];
+	char *p = tmp + sizeof(tmp);
+	*--p = '0' + cents % 10;
+	cents /= 10;
+	*--p = '0' + cents % 10;
+	cents /= 10;
+	*--p = '.';
+	do
+	{
+		*--p = '0' + cents % 10;
+		cents /= 10;
+	} while (cents);
+	if (negative)
+		*--p = '-';
+	append(p, tmp + sizeof(tmp) - p);
+}
+
+void OutputBuffer::appendFloat(float x)
+{
+	if (_fixed)
+	{
+		appendFixed2(x);
+		return;
+	}
+	std::ostringstream oss;
+	oss << x;
+	append(oss.str());
+}
+
+void OutputBuffer::setFixed(bool fixed)
+{
+	_fixed = fixed;
+}
+
+bool OutputBuffer::isFixed(void) const
+{
+	return _fixed;
+}
+
+void OutputBuffer::flush(void)
+{
+	if (!_out)
+		return;
+	if (!_buf.empty())
+	{
+		PROFILE_SCOPE(PHASE_OUTPUT);
+		PROFILE_EVENT(EVENT_FLUSHES);
+		_out->write(_buf.data(), _buf.size());
+		_buf.clear();
+	}
+	
+	// Leave the stream in the state a line-by-line writer would have
+	if (_fixed)
+		*_out << std::fixed << std::setprecision(2);
+	_out->flush();
+}
+
+const std::string &OutputBuffer::str(void) const
+{
+	return _buf;
+}
+
+void OutputBuffer::clear(void)
+{
+	_buf.clear();
+}
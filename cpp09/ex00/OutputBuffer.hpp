@@ -0,0 +1,61 @@
+#ifndef OUTPUTBUFFER_HPP
+#define OUTPUTBUFFER_HPP
+
+#include <string>
+#include <ostream>
+#include <cstddef>
+
+// Output sink that collects formatted text in one reusable buffer and
+// writes it to the target stream in large blocks
+class OutputBuffer
+{
+	private:
+		std::ostream *_out;
+		std::string _buf;
+		size_t _blockSize;
+		
+		// Mirrors the sticky std::fixed/setprecision(2) state of a stream
+		bool _fixed;
+		
+	public:
+		// Memory-only buffer, read back through str()
+		OutputBuffer(void);
+		
+		// Buffer flushing to out every blockSize bytes
+		OutputBuffer(std::ostream &out, size_t blockSize = 1 << 16);
+		
+		// Copy constructor
+		OutputBuffer(const OutputBuffer &other);
+		
+		// Assignment operator
+		OutputBuffer &operator=(const OutputBuffer &other);
+		
+		// Destructor (flushes)
+		~OutputBuffer(void);
+		
+		void put(char c);
+		void append(const char *str, size_t len);
+		void append(const std::string &str);
+		void append(const char *str);
+		
+		// Decimal digits of n, without going through a stream
+		void appendUnsigned(unsigned long n);
+		
+		// Same text as `os << std::fixed << std::setprecision(2) << x`
+		void appendFixed2(double x);
+		
+		// Same text as `os << x` given the current fixed state
+		void appendFloat(float x);
+		
+		void setFixed(bool fixed);
+		bool isFixed(void) const;
+		
+		// Write pending bytes to the target stream
+		void flush(void);
+		
+		// Pending bytes (all of them for a memory-only buffer)
+		const std::string &str(void) const;
+		void clear(void);
+};
+
+#endif
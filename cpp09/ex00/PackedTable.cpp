@@ -0,0 +1,356 @@
+#include "PackedTable.hpp"
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+PackedTable::PackedTable(void) : _size(0), _bitCount(0)
+{
+}
+
+PackedTable::PackedTable(const PackedTable &other) : _blocks(other._blocks), _checks(other._checks), _bits(other._bits),
+	_size(other._size), _bitCount(other._bitCount)
+{
+}
+
+PackedTable &PackedTable::operator=(const PackedTable &other)
+{
+	if (this != &other)
+	{
+		_blocks = other._blocks;
+		_checks = other._checks;
+		_bits = other._bits;
+		_size = other._size;
+		_bitCount = other._bitCount;
+	}
+	return *this;
+}
+
+PackedTable::~PackedTable(void)
+{
+}
+
+static uint32_t floatBits(float value)
+{
+	uint32_t bits;
+	std::memcpy(&bits, &value, sizeof(bits));
+	return bits;
+}
+
+// Bits go in low first; a value may straddle two words. The stream keeps a
+// spare word at its end, so a read never needs a bounds check
+void PackedTable::_write(uint64_t value, unsigned int n)
+{
+	if (n == 0)
+		return;
+	if (n < 64)
+		value &= (static_cast<uint64_t>(1) << n) - 1;
+	size_t word = _bitCount >> 6;
+	unsigned int shift = _bitCount & 63;
+	if (word + 1 >= _bits.size())
+		_bits.resize(word + 2, 0);
+	_bits[word] |= value << shift;
+	if (shift + n > 64)
+		_bits[word + 1] |= value >> (64 - shift);
+	_bitCount += n;
+}
+
+uint64_t PackedTable::_read(size_t &pos, unsigned int n) const
+{
+	if (n == 0)
+		return 0;
+	size_t word = pos >> 6;
+	unsigned int shift = pos & 63;
+	uint64_t value = _bits[word] >> shift;
+	if (shift + n > 64)
+		value |= _bits[word + 1] << (64 - shift);
+	pos += n;
+	return n < 64 ? value & ((static_cast<uint64_t>(1) << n) - 1) : value;
+}
+
+void PackedTable::_encodeBlock(const PriceTable &table, size_t begin, size_t end)
+{
+	Block block;
+	block.offset = _bitCount;
+	block.check = _checks.size();
+	block.count = static_cast<unsigned int>(end - begin);
+	block.first = table.dateAt(begin);
+	block.last = table.dateAt(end - 1);
+	block.lastRate = table.rateAt(end - 1);
+	block.min = table.rateAt(begin);
+	block.max = block.min;
+	block.sum = 0.0;
+	uint32_t widest = 0;
+	for (size_t i = begin; i < end; i++)
+	{
+		float rate = table.rateAt(i);
+		block.min = std::min(block.min, rate);
+		block.max = std::max(block.max, rate);
+		block.sum += rate;
+		if (i > begin)
+			widest |= static_cast<uint32_t>(table.dateAt(i) - table.dateAt(i - 1) - 1);
+	}
+	block.width = 0;
+	while (block.width < 32 && (widest >> block.width))
+		block.width++;
+	
+	// Dates are unique and sorted, so every gap is at least 1 and stored less 1
+	for (size_t i = begin + 1; i < end; i++)
+		_write(static_cast<uint32_t>(table.dateAt(i) - table.dateAt(i - 1) - 1), block.width);
+	
+	// Rates: a 0 bit when unchanged; else 1, then 0 and the XOR's bits in
+	// the previous window of meaningful bits when they fit it, or 1, the
+	// count of leading zeros (5 bits), the length less 1 (5 bits) and the bits
+	uint32_t previous = floatBits(table.rateAt(begin));
+	unsigned int lead = 0;
+	unsigned int trail = 0;
+	bool window = false;
+	for (size_t i = begin; i < end; i++)
+	{
+		if (i > begin)
+		{
+			uint32_t current = floatBits(table.rateAt(i));
+			uint32_t x = current ^ previous;
+			previous = current;
+			if (x == 0)
+				_write(0, 1);
+			else
+			{
+				unsigned int leading = 0;
+				while (!(x & (0x80000000u >> leading)))
+					leading++;
+				unsigned int trailing = 0;
+				while (!(x & (1u << trailing)))
+					trailing++;
+				if (window && leading >= lead && trailing >= trail)
+					_write(1, 2);
+				else
+				{
+					lead = leading;
+					trail = trailing;
+					window = true;
+					_write(3, 2);
+					_write(lead, 5);
+					_write(31 - lead - trail, 5);
+				}
+				_write(x >> trail, 32 - lead - trail);
+			}
+		}
+		if ((i - begin) % RUN_ROWS == 0)
+		{
+			Check check;
+			check.offset = static_cast<uint32_t>(_bitCount - block.offset);
+			check.date = table.dateAt(i);
+			check.rate = table.rateAt(i);
+			check.lead = static_cast<unsigned char>(lead);
+			check.trail = static_cast<unsigned char>(trail);
+			_checks.push_back(check);
+		}
+	}
+	_blocks.push_back(block);
+}
+
+struct CheckDateLess
+{
+	template <typename Check>
+	bool operator()(int date, const Check &check) const
+	{
+		return date < check.date;
+	}
+};
+
+// Run holding the latest date <= date, for a date not before the block
+size_t PackedTable::_runOf(const Block &block, int date) const
+{
+	std::vector<Check>::const_iterator first = _checks.begin() + block.check;
+	size_t runs = (block.count + RUN_ROWS - 1) / RUN_ROWS;
+	return std::upper_bound(first, first + runs, date, CheckDateLess()) - first - 1;
+}
+
+// Dates of count rows from row, the first row of a run
+void PackedTable::_decodeDates(const Block &block, size_t row, size_t count, int *dates) const
+{
+	size_t pos = block.offset + row * block.width;
+	dates[0] = _checks[block.check + row / RUN_ROWS].date;
+	for (size_t i = 1; i < count; i++)
+		dates[i] = dates[i - 1] + 1 + static_cast<int>(_read(pos, block.width));
+}
+
+// Rates of count rows from row, the first row of a run
+void PackedTable::_decodeRates(const Block &block, size_t row, size_t count, float *rates) const
+{
+	const Check &check = _checks[block.check + row / RUN_ROWS];
+	size_t pos = block.offset + check.offset;
+	uint32_t value = floatBits(check.rate);
+	unsigned int lead = check.lead;
+	unsigned int trail = check.trail;
+	rates[0] = check.rate;
+	for (size_t i = 1; i < count; i++)
+	{
+		if (_read(pos, 1))
+		{
+			if (_read(pos, 1))
+			{
+				lead = static_cast<unsigned int>(_read(pos, 5));
+				trail = 31 - lead - static_cast<unsigned int>(_read(pos, 5));
+			}
+			value ^= static_cast<uint32_t>(_read(pos, 32 - lead - trail)) << trail;
+		}
+		std::memcpy(&rates[i], &value, sizeof(value));
+	}
+}
+
+void PackedTable::build(const PriceTable &table)
+{
+	clear();
+	for (size_t begin = 0; begin < table.size(); begin += BLOCK_ROWS)
+		_encodeBlock(table, begin, std::min(begin + BLOCK_ROWS, table.size()));
+	_size = table.size();
+	std::vector<Block>(_blocks).swap(_blocks);
+	std::vector<Check>(_checks).swap(_checks);
+	std::vector<uint64_t>(_bits).swap(_bits);
+}
+
+void PackedTable::unpack(PriceTable &table) const
+{
+	int dates[BLOCK_ROWS];
+	float rates[BLOCK_ROWS];
+	table.reserve(table.size() + _size);
+	for (size_t b = 0; b < _blocks.size(); b++)
+	{
+		_decodeDates(_blocks[b], 0, _blocks[b].count, dates);
+		_decodeRates(_blocks[b], 0, _blocks[b].count, rates);
+		for (unsigned int i = 0; i < _blocks[b].count; i++)
+			table.insert(dates[i], rates[i]);
+	}
+}
+
+struct BlockFirstLess
+{
+	template <typename Block>
+	bool operator()(int date, const Block &block) const
+	{
+		return date < block.first;
+	}
+};
+
+struct BlockLastLess
+{
+	template <typename Block>
+	bool operator()(const Block &block, int date) const
+	{
+		return block.last < date;
+	}
+};
+
+bool PackedTable::find(int date, float &rate) const
+{
+	if (_blocks.empty() || date < _blocks[0].first)
+		return false;
+	const Block &block = *--std::upper_bound(_blocks.begin(), _blocks.end(), date, BlockFirstLess());
+	if (date >= block.last)
+	{
+		rate = block.lastRate;
+		return true;
+	}
+	
+	// Row of the latest date <= date, in its run and before the last row
+	size_t first = _runOf(block, date) * RUN_ROWS;
+	size_t end = std::min(first + RUN_ROWS, static_cast<size_t>(block.count));
+	size_t pos = block.offset + first * block.width;
+	int at = _checks[block.check + first / RUN_ROWS].date;
+	size_t row = first;
+	for (; row + 1 < end; row++)
+	{
+		int next = at + 1 + static_cast<int>(_read(pos, block.width));
+		if (next > date)
+			break;
+		at = next;
+	}
+	float rates[RUN_ROWS];
+	_decodeRates(block, first, row - first + 1, rates);
+	rate = rates[row - first];
+	return true;
+}
+
+bool PackedTable::rangeStats(int from, int to, PriceTable::RangeStats &stats) const
+{
+	if (from > to)
+		return false;
+	stats.count = 0;
+	stats.min = std::numeric_limits<float>::max();
+	stats.max = -std::numeric_limits<float>::max();
+	double sum = 0.0;
+	
+	int dates[RUN_ROWS];
+	float rates[RUN_ROWS];
+	std::vector<Block>::const_iterator it = std::lower_bound(_blocks.begin(), _blocks.end(), from, BlockLastLess());
+	for (; it != _blocks.end() && it->first <= to; ++it)
+	{
+		if (it->first >= from && it->last <= to)
+		{
+			stats.count += it->count;
+			stats.min = std::min(stats.min, it->min);
+			stats.max = std::max(stats.max, it->max);
+			sum += it->sum;
+			continue;
+		}
+		
+		// A block at an end of the interval: decode its runs from the one
+		// holding from, until one starts past to
+		size_t run = it->first < from ? _runOf(*it, from) : 0;
+		for (size_t row = run * RUN_ROWS; row < it->count; row += RUN_ROWS)
+		{
+			if (_checks[it->check + row / RUN_ROWS].date > to)
+				break;
+			size_t n = std::min(static_cast<size_t>(RUN_ROWS), it->count - row);
+			_decodeDates(*it, row, n, dates);
+			_decodeRates(*it, row, n, rates);
+			for (size_t i = 0; i < n; i++)
+			{
+				if (dates[i] < from || dates[i] > to)
+					continue;
+				stats.count++;
+				stats.min = std::min(stats.min, rates[i]);
+				stats.max = std::max(stats.max, rates[i]);
+				sum += rates[i];
+			}
+		}
+	}
+	if (stats.count == 0)
+		return false;
+	stats.mean = sum / stats.count;
+	return true;
+}
+
+void PackedTable::swap(PackedTable &other)
+{
+	_blocks.swap(other._blocks);
+	_checks.swap(other._checks);
+	_bits.swap(other._bits);
+	std::swap(_size, other._size);
+	std::swap(_bitCount, other._bitCount);
+}
+
+void PackedTable::clear(void)
+{
+	_blocks.clear();
+	_checks.clear();
+	_bits.clear();
+	_size = 0;
+	_bitCount = 0;
+}
+
+size_t PackedTable::size(void) const
+{
+	return _size;
+}
+
+bool PackedTable::empty(void) const
+{
+	return _size == 0;
+}
+
+size_t PackedTable::memoryUsage(void) const
+{
+	return _blocks.capacity() * sizeof(Block) + _checks.capacity() * sizeof(Check) + _bits.capacity() * sizeof(uint64_t);
+}
@@ -0,0 +1,95 @@
+#ifndef PACKEDTABLE_HPP
+#define PACKEDTABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <stdint.h>
+#include "PriceTable.hpp"
+
+// Compressed read-only copy of a PriceTable, in blocks of BLOCK_ROWS rows.
+// A block keeps its first date and rate whole; the gaps between its dates
+// are bit-packed at the narrowest width that holds them (0 bits for daily
+// rows), and each rate after the first is XOR-ed with the one before and
+// stored as its meaningful bits, as in Gorilla. Each block header holds
+// the date range and the min, max and sum of its rates, so a lookup
+// decodes one block and range statistics read whole blocks off the headers.
+// Within a block, a checkpoint every RUN_ROWS rows holds the date, rate
+// and XOR window there, so a lookup decodes only the one run it lands in
+class PackedTable
+{
+	public:
+		static const unsigned int BLOCK_ROWS = 1024;
+		static const unsigned int RUN_ROWS = 64;
+		
+	private:
+		struct Block
+		{
+			size_t offset;			// first bit of the date gaps; the rates follow
+			size_t check;			// first checkpoint
+			int first;				// first and last dates
+			int last;
+			float lastRate;
+			float min;
+			float max;
+			double sum;
+			unsigned int count;
+			unsigned int width;		// bits per date gap
+		};
+		
+		// State at the first row of a run
+		struct Check
+		{
+			uint32_t offset;		// bit after that row's rate, from the block offset
+			int date;
+			float rate;
+			unsigned char lead;		// XOR window in force there
+			unsigned char trail;
+		};
+		
+		std::vector<Block> _blocks;
+		std::vector<Check> _checks;
+		std::vector<uint64_t> _bits;
+		size_t _size;
+		size_t _bitCount;
+		
+		void _write(uint64_t value, unsigned int n);
+		uint64_t _read(size_t &pos, unsigned int n) const;
+		void _encodeBlock(const PriceTable &table, size_t begin, size_t end);
+		size_t _runOf(const Block &block, int date) const;
+		void _decodeDates(const Block &block, size_t row, size_t count, int *dates) const;
+		void _decodeRates(const Block &block, size_t row, size_t count, float *rates) const;
+		
+	public:
+		// Constructor
+		PackedTable(void);
+		
+		// Copy constructor
+		PackedTable(const PackedTable &other);
+		
+		// Assignment operator
+		PackedTable &operator=(const PackedTable &other);
+		
+		// Destructor
+		~PackedTable(void);
+		
+		// Replace the contents with the rows of table, which must not be in bulk
+		void build(const PriceTable &table);
+		
+		// Append every row to table, as sorted inserts
+		void unpack(PriceTable &table) const;
+		
+		// Find the rate of the latest date <= date
+		bool find(int date, float &rate) const;
+		
+		// As PriceTable::rangeStats; blocks inside the interval cost nothing
+		// to decode, so only the runs of the two blocks at its ends are read
+		bool rangeStats(int from, int to, PriceTable::RangeStats &stats) const;
+		
+		void swap(PackedTable &other);
+		void clear(void);
+		size_t size(void) const;
+		bool empty(void) const;
+		size_t memoryUsage(void) const;
+};
+
+#endif
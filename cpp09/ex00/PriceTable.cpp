@@ -0,0 +1,686 @@
+#include "PriceTable.hpp"
+#include <algorithm>
+#include <fstream>
+#include <cstring>
+#include <cmath>
+#include <cstdio>
+#include "Decimal.hpp"
+#include "ThreadPool.hpp"
+
+PriceTable::PriceTable(void) : _dateView(NULL), _rateView(NULL), _count(0), _hasScaled(false),
+	_interpolate(false), _bulk(false), _bulkSorted(true), _bulkStart(0), _rangeValid(false)
+{
+}
+
+// A copy owns its columns, even when other reads a mapped snapshot
+PriceTable::PriceTable(const PriceTable &other) : _dates(other._dateView, other._dateView + other._count),
+	_rates(other._rateView, other._rateView + other._count), _dateView(NULL), _rateView(NULL), _count(0),
+	_scaled(other._scaled), _hasScaled(other._hasScaled), _interpolate(other._interpolate),
+	_bulk(other._bulk), _bulkSorted(other._bulkSorted), _bulkStart(other._bulkStart),
+	_range(other._range), _rangeValid(other._rangeValid)
+{
+	_sync();
+}
+
+PriceTable &PriceTable::operator=(const PriceTable &other)
+{
+	if (this != &other)
+	{
+		_snapshot.close();
+		_dates.assign(other._dateView, other._dateView + other._count);
+		_rates.assign(other._rateView, other._rateView + other._count);
+		_sync();
+		_scaled = other._scaled;
+		_hasScaled = other._hasScaled;
+		_interpolate = other._interpolate;
+		_bulk = other._bulk;
+		_bulkSorted = other._bulkSorted;
+		_bulkStart = other._bulkStart;
+		_range = other._range;
+		_rangeValid = other._rangeValid;
+	}
+	return *this;
+}
+
+PriceTable::~PriceTable(void)
+{
+}
+
+// Copy a mapped snapshot into the vectors before they change
+void PriceTable::_detach(void)
+{
+	if (!_snapshot.size())
+		return;
+	std::vector<int>(_dateView, _dateView + _count).swap(_dates);
+	std::vector<float>(_rateView, _rateView + _count).swap(_rates);
+	_snapshot.close();
+	_sync();
+}
+
+// Point the views at the vectors again, after they may have moved
+void PriceTable::_sync(void)
+{
+	_dateView = _dates.empty() ? NULL : &_dates[0];
+	_rateView = _rates.empty() ? NULL : &_rates[0];
+	_count = _dates.size();
+}
+
+static long long toScaled(float rate)
+{
+	double scaled = std::floor(static_cast<double>(rate) * Decimal::scale() + 0.5);
+	return static_cast<long long>(scaled);
+}
+
+void PriceTable::insert(int date, float rate)
+{
+	insert(date, rate, _hasScaled ? toScaled(rate) : 0);
+}
+
+void PriceTable::insert(int date, float rate, long long scaled)
+{
+	_detach();
+	_rangeValid = false;
+	// Sorted input only ever appends, and so does a bulk load
+	if (_bulk || _dates.empty() || date > _dates.back())
+	{
+		if (_bulk && !_dates.empty() && date <= _dates.back())
+			_bulkSorted = false;
+		_dates.push_back(date);
+		_rates.push_back(rate);
+		if (_hasScaled)
+			_scaled.push_back(scaled);
+		_sync();
+		return;
+	}
+	
+	std::vector<int>::iterator it = std::lower_bound(_dates.begin(), _dates.end(), date);
+	size_t pos = it - _dates.begin();
+	if (it != _dates.end() && *it == date)
+	{
+		_rates[pos] = rate;
+		if (_hasScaled)
+			_scaled[pos] = scaled;
+		return;
+	}
+	_dates.insert(it, date);
+	_rates.insert(_rates.begin() + pos, rate);
+	if (_hasScaled)
+		_scaled.insert(_scaled.begin() + pos, scaled);
+	_sync();
+}
+
+bool PriceTable::find(int date, float &rate) const
+{
+	// First date strictly after the query; the one before it is the answer
+	size_t pos = upperIndex(date);
+	if (pos == 0)
+		return false;
+	rate = _rateView[pos - 1];
+	return true;
+}
+
+bool PriceTable::findScaled(int date, long long &scaled) const
+{
+	size_t pos = upperIndex(date);
+	if (pos == 0 || !_hasScaled)
+		return false;
+	scaled = _scaled[pos - 1];
+	return true;
+}
+
+void PriceTable::enableScaled(void)
+{
+	if (_hasScaled)
+		return;
+	_scaled.resize(_count);
+	for (size_t i = 0; i < _count; i++)
+		_scaled[i] = toScaled(_rateView[i]);
+	_hasScaled = true;
+}
+
+bool PriceTable::hasScaled(void) const
+{
+	return _hasScaled;
+}
+
+void PriceTable::setInterpolation(bool enabled)
+{
+	_interpolate = enabled;
+}
+
+bool PriceTable::isInterpolated(void) const
+{
+	return _interpolate;
+}
+
+size_t PriceTable::upperIndex(int date) const
+{
+	if (_interpolate)
+		return _interpolationIndex(date);
+	return std::upper_bound(_dateView, _dateView + _count, date) - _dateView;
+}
+
+size_t PriceTable::_interpolationIndex(int date) const
+{
+	// Answer is in [lo, hi]; every date before lo is <= date, every date from hi on is > date
+	size_t lo = 0;
+	size_t hi = _count;
+	
+	// A few probes handle evenly spaced data; gaps in the history degrade
+	// interpolation badly, so whatever range is left goes to binary search
+	for (int round = 0; round < 3 && hi - lo > 8; round++)
+	{
+		int first = _dateView[lo];
+		int last = _dateView[hi - 1];
+		if (date < first)
+			return lo;
+		if (date >= last)
+			return hi;
+		
+		size_t probe = lo + static_cast<size_t>(static_cast<long long>(date - first) * (hi - 1 - lo) / (last - first));
+		if (_dateView[probe] <= date)
+			lo = probe + 1;
+		else
+			hi = probe;
+		
+		// Dates are unique, so the answer is usually one step either side
+		if (lo < hi && _dateView[lo] > date)
+			return lo;
+		if (lo < hi && _dateView[hi - 1] <= date)
+			return hi;
+	}
+	return std::upper_bound(_dateView + lo, _dateView + hi, date) - _dateView;
+}
+
+size_t PriceTable::upperIndexFrom(int date, size_t hint) const
+{
+	size_t n = _count;
+	if (hint > n)
+		hint = n;
+	
+	size_t lo;
+	size_t hi;
+	if (hint < n && _dateView[hint] <= date)
+	{
+		// Answer lies after hint: double the step until we overshoot
+		size_t step = 1;
+		lo = hint + 1;
+		hi = lo;
+		while (hi < n && _dateView[hi] <= date)
+		{
+			lo = hi + 1;
+			hi += step;
+			step *= 2;
+		}
+		if (hi > n)
+			hi = n;
+	}
+	else if (hint > 0 && _dateView[hint - 1] > date)
+	{
+		// Answer lies before hint: same thing, walking backwards
+		size_t step = 1;
+		hi = hint - 1;
+		lo = hi;
+		while (lo > 0 && _dateView[lo - 1] > date)
+		{
+			hi = lo - 1;
+			lo = (lo > step) ? lo - step : 0;
+			step *= 2;
+		}
+	}
+	else
+		return hint;
+	
+	return std::upper_bound(_dateView + lo, _dateView + hi, date) - _dateView;
+}
+
+bool PriceTable::rangeStats(int from, int to, RangeStats &stats) const
+{
+	if (from > to)
+		return false;
+	size_t first = std::lower_bound(_dateView, _dateView + _count, from) - _dateView;
+	size_t last = upperIndex(to);
+	if (first >= last)
+		return false;
+	if (!_rangeValid)
+	{
+		_range.build(_rateView, _count);
+		_rangeValid = true;
+	}
+	stats.count = last - first;
+	stats.min = _range.min(first, last);
+	stats.max = _range.max(first, last);
+	stats.mean = _range.sum(first, last) / stats.count;
+	return true;
+}
+
+void PriceTable::findBatch(const std::vector<int> &dates, std::vector<float> &rates, std::vector<char> &found) const
+{
+	size_t m = dates.size();
+	rates.resize(m);
+	found.resize(m);
+	
+	bool sorted = true;
+	for (size_t i = 1; i < m && sorted; i++)
+		sorted = dates[i - 1] <= dates[i];
+	
+	size_t n = _count;
+	size_t pos = 0;
+	for (size_t i = 0; i < m; i++)
+	{
+		if (sorted)
+		{
+			// One linear merge pass over both sorted sequences
+			while (pos < n && _dateView[pos] <= dates[i])
+				pos++;
+		}
+		else
+			pos = upperIndexFrom(dates[i], pos);
+		
+		found[i] = pos > 0;
+		rates[i] = pos > 0 ? _rateView[pos - 1] : 0.0f;
+	}
+}
+
+void PriceTable::beginBulk(void)
+{
+	if (_bulk)
+		return;
+	_detach();
+	_bulk = true;
+	_bulkSorted = true;
+	_bulkStart = _dates.size();
+}
+
+void PriceTable::endBulk(void)
+{
+	if (!_bulk)
+		return;
+	_bulk = false;
+	_rangeValid = false;
+	
+	// Rows that arrived in strictly increasing order are already in place
+	if (_bulkSorted)
+		return;
+	_sortTail();
+	_mergeTail();
+	_sync();
+}
+
+bool PriceTable::inBulk(void) const
+{
+	return _bulk;
+}
+
+// Keys of a bulk sort per run; a run is sorted by one task of the pool
+static const size_t SORT_RUN = 1 << 16;
+
+// Sort the runs of SORT_RUN keys of a parallel loop
+struct KeyRunJob
+{
+	unsigned long long *keys;
+	size_t n;
+	
+	void operator()(size_t first, size_t last) const
+	{
+		for (size_t r = first; r < last; r++)
+		{
+			size_t start = r * SORT_RUN;
+			std::sort(keys + start, keys + std::min(start + SORT_RUN, n));
+		}
+	}
+};
+
+// Merge pairs of runs of width keys from one buffer into the other
+struct KeyMergeJob
+{
+	const unsigned long long *from;
+	unsigned long long *to;
+	size_t n;
+	size_t width;
+	
+	void operator()(size_t first, size_t last) const
+	{
+		for (size_t p = first; p < last; p++)
+		{
+			size_t start = p * 2 * width;
+			size_t mid = std::min(start + width, n);
+			size_t end = std::min(start + 2 * width, n);
+			std::merge(from + start, from + mid, from + mid, from + end, to + start);
+		}
+	}
+};
+
+// std::sort for the keys of a small bulk; a large one is sorted in runs
+// on the shared ThreadPool, whose sorted runs are then merged pairwise,
+// pass after pass, as MergeInsertion::sortSharded does. The keys are
+// unique, so the result is the one std::sort gives
+static void sortKeys(std::vector<unsigned long long> &keys)
+{
+	size_t n = keys.size();
+	if (n <= SORT_RUN)
+	{
+		std::sort(keys.begin(), keys.end());
+		return;
+	}
+	
+	ThreadPool &pool = ThreadPool::shared();
+	KeyRunJob runJob;
+	runJob.keys = &keys[0];
+	runJob.n = n;
+	pool.parallelFor(0, (n - 1) / SORT_RUN + 1, 1, runJob);
+	
+	// Runs double in width each pass, ping-ponging between two buffers
+	std::vector<unsigned long long> buffer(n);
+	KeyMergeJob mergeJob;
+	mergeJob.from = &keys[0];
+	mergeJob.to = &buffer[0];
+	mergeJob.n = n;
+	bool swapped = false;
+	for (size_t width = SORT_RUN; width < n; width *= 2)
+	{
+		mergeJob.width = width;
+		pool.parallelFor(0, (n - 1) / (2 * width) + 1, 1, mergeJob);
+		unsigned long long *from = mergeJob.to;
+		mergeJob.to = const_cast<unsigned long long *>(mergeJob.from);
+		mergeJob.from = from;
+		swapped = !swapped;
+	}
+	if (swapped)
+		keys.swap(buffer);
+}
+
+void PriceTable::_sortTail(void)
+{
+	// One integer sort on (date, arrival) keys: the date, biased so negative
+	// days order correctly, in the high half and the row index in the low half
+	size_t m = _dates.size() - _bulkStart;
+	std::vector<unsigned long long> keys(m);
+	for (size_t i = 0; i < m; i++)
+	{
+		unsigned long long date = static_cast<unsigned int>(_dates[_bulkStart + i]) ^ 0x80000000u;
+		keys[i] = (date << 32) | i;
+	}
+	sortKeys(keys);
+	
+	// Gather the last arrival of every date
+	std::vector<int> dates;
+	std::vector<float> rates;
+	std::vector<long long> scaled;
+	dates.reserve(m);
+	rates.reserve(m);
+	if (_hasScaled)
+		scaled.reserve(m);
+	for (size_t i = 0; i < m; i++)
+	{
+		if (i + 1 < m && (keys[i] >> 32) == (keys[i + 1] >> 32))
+			continue;
+		size_t row = _bulkStart + static_cast<size_t>(keys[i] & 0xffffffffu);
+		dates.push_back(_dates[row]);
+		rates.push_back(_rates[row]);
+		if (_hasScaled)
+			scaled.push_back(_scaled[row]);
+	}
+	
+	_dates.resize(_bulkStart);
+	_rates.resize(_bulkStart);
+	_dates.insert(_dates.end(), dates.begin(), dates.end());
+	_rates.insert(_rates.end(), rates.begin(), rates.end());
+	if (_hasScaled)
+	{
+		_scaled.resize(_bulkStart);
+		_scaled.insert(_scaled.end(), scaled.begin(), scaled.end());
+	}
+}
+
+void PriceTable::_mergeTail(void)
+{
+	// Both halves are sorted and unique now; on equal dates the tail wins
+	size_t mid = _bulkStart;
+	size_t n = _dates.size();
+	if (mid == 0 || mid == n || _dates[mid - 1] < _dates[mid])
+		return;
+	
+	std::vector<int> dates;
+	std::vector<float> rates;
+	std::vector<long long> scaled;
+	dates.reserve(n);
+	rates.reserve(n);
+	if (_hasScaled)
+		scaled.reserve(n);
+	size_t i = 0;
+	size_t j = mid;
+	while (i < mid || j < n)
+	{
+		size_t row;
+		if (j == n || (i < mid && _dates[i] < _dates[j]))
+			row = i++;
+		else
+		{
+			if (i < mid && _dates[i] == _dates[j])
+				i++;
+			row = j++;
+		}
+		dates.push_back(_dates[row]);
+		rates.push_back(_rates[row]);
+		if (_hasScaled)
+			scaled.push_back(_scaled[row]);
+	}
+	_dates.swap(dates);
+	_rates.swap(rates);
+	if (_hasScaled)
+		_scaled.swap(scaled);
+}
+
+void PriceTable::swap(PriceTable &other)
+{
+	// Vector and mapping swaps keep the addresses the views point to
+	_dates.swap(other._dates);
+	_rates.swap(other._rates);
+	_snapshot.swap(other._snapshot);
+	std::swap(_dateView, other._dateView);
+	std::swap(_rateView, other._rateView);
+	std::swap(_count, other._count);
+	_scaled.swap(other._scaled);
+	std::swap(_hasScaled, other._hasScaled);
+	std::swap(_bulk, other._bulk);
+	std::swap(_bulkSorted, other._bulkSorted);
+	std::swap(_bulkStart, other._bulkStart);
+	_range.clear();
+	other._range.clear();
+	_rangeValid = false;
+	other._rangeValid = false;
+}
+
+void PriceTable::clear(void)
+{
+	_snapshot.close();
+	_dates.clear();
+	_rates.clear();
+	_sync();
+	_scaled.clear();
+	_bulkSorted = true;
+	_bulkStart = 0;
+	_range.clear();
+	_rangeValid = false;
+}
+
+void PriceTable::reserve(size_t n)
+{
+	_detach();
+	_dates.reserve(n);
+	_rates.reserve(n);
+	_sync();
+	if (_hasScaled)
+		_scaled.reserve(n);
+}
+
+size_t PriceTable::size(void) const
+{
+	return _count;
+}
+
+bool PriceTable::empty(void) const
+{
+	return _count == 0;
+}
+
+int PriceTable::dateAt(size_t i) const
+{
+	return _dateView[i];
+}
+
+float PriceTable::rateAt(size_t i) const
+{
+	return _rateView[i];
+}
+
+// Snapshot header; dates are int32 and rates float32 on every supported target
+struct SnapshotHeader
+{
+	char magic[4];
+	unsigned int version;
+	unsigned int count;
+	unsigned int reserved;
+};
+
+static const char SNAPSHOT_MAGIC[4] = { 'B', 'T', 'C', 'S' };
+static const unsigned int SNAPSHOT_VERSION = 1;
+
+// Written beside the target and renamed over it: truncating the file in
+// place would pull the pages from under a table that maps it
+bool PriceTable::saveSnapshot(const std::string &filename) const
+{
+	std::string temp = filename + ".tmp";
+	std::ofstream file(temp.c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!file.is_open())
+		return false;
+	
+	SnapshotHeader header;
+	std::memcpy(header.magic, SNAPSHOT_MAGIC, 4);
+	header.version = SNAPSHOT_VERSION;
+	header.count = static_cast<unsigned int>(_count);
+	header.reserved = 0;
+	
+	file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+	if (_count > 0)
+	{
+		file.write(reinterpret_cast<const char *>(_dateView), _count * sizeof(int));
+		file.write(reinterpret_cast<const char *>(_rateView), _count * sizeof(float));
+	}
+	file.close();
+	if (!file || std::rename(temp.c_str(), filename.c_str()) != 0)
+	{
+		std::remove(temp.c_str());
+		return false;
+	}
+	return true;
+}
+
+bool PriceTable::loadSnapshot(const std::string &filename)
+{
+	MappedFile file;
+	if (!file.open(filename))
+		return false;
+	
+	SnapshotHeader header;
+	if (file.size() < sizeof(header))
+		return false;
+	std::memcpy(&header, file.data(), sizeof(header));
+	if (std::memcmp(header.magic, SNAPSHOT_MAGIC, 4) != 0 || header.version != SNAPSHOT_VERSION)
+		return false;
+	size_t count = header.count;
+	if ((file.size() - sizeof(header)) / (sizeof(int) + sizeof(float)) < count)
+		return false;
+	
+	// The columns are used where they lie: the header keeps the date
+	// column 4-byte aligned in a page-aligned mapping, and so the rates
+	const int *dates = reinterpret_cast<const int *>(file.data() + sizeof(header));
+	const float *rates = reinterpret_cast<const float *>(dates + count);
+	
+	// A hand-edited file must not break the binary search
+	for (size_t i = 1; i < count; i++)
+		if (dates[i - 1] >= dates[i])
+			return false;
+	
+	std::vector<int>().swap(_dates);
+	std::vector<float>().swap(_rates);
+	_snapshot.swap(file);
+	_dateView = dates;
+	_rateView = rates;
+	_count = count;
+	_bulk = false;
+	_bulkStart = 0;
+	_range.clear();
+	_rangeValid = false;
+	if (_hasScaled)
+	{
+		_hasScaled = false;
+		enableScaled();
+	}
+	return true;
+}
+
+bool PriceTable::packDate(const char *str, size_t len, int &key)
+{
+	if (len != 10)
+		return false;
+	
+	// Digits and separators checked in one pass, with a single branch at the end
+	const unsigned char *s = reinterpret_cast<const unsigned char *>(str);
+	unsigned int bad = (s[4] ^ '-') | (s[7] ^ '-');
+	bad |= (static_cast<unsigned char>(s[0] - '0') > 9) | (static_cast<unsigned char>(s[1] - '0') > 9);
+	bad |= (static_cast<unsigned char>(s[2] - '0') > 9) | (static_cast<unsigned char>(s[3] - '0') > 9);
+	bad |= (static_cast<unsigned char>(s[5] - '0') > 9) | (static_cast<unsigned char>(s[6] - '0') > 9);
+	bad |= (static_cast<unsigned char>(s[8] - '0') > 9) | (static_cast<unsigned char>(s[9] - '0') > 9);
+	if (bad)
+		return false;
+	
+	int y = (s[0] - '0') * 1000 + (s[1] - '0') * 100 + (s[2] - '0') * 10 + (s[3] - '0');
+	int m = (s[5] - '0') * 10 + (s[6] - '0');
+	int d = (s[8] - '0') * 10 + (s[9] - '0');
+	
+	// Days per month, with a second row for leap years
+	static const unsigned char monthDays[2][13] = {
+		{ 0, 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 },
+		{ 0, 31, 29, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 }
+	};
+	int leap = (y % 4 == 0 && y % 100 != 0) || y % 400 == 0;
+	if (m < 1 || m > 12 || d < 1 || d > monthDays[leap][m])
+		return false;
+	
+	// Days from civil date (proleptic Gregorian, March-based year)
+	y -= m <= 2;
+	int era = (y >= 0 ? y : y - 399) / 400;
+	int yoe = y - era * 400;
+	int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+	int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	key = era * 146097 + doe - 719468;
+	return true;
+}
+
+void PriceTable::unpackDate(int key, char *out)
+{
+	// Civil date from days (inverse of packDate)
+	int z = key + 719468;
+	int era = (z >= 0 ? z : z - 146096) / 146097;
+	int doe = z - era * 146097;
+	int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	int mp = (5 * doy + 2) / 153;
+	int d = doy - (153 * mp + 2) / 5 + 1;
+	int m = mp < 10 ? mp + 3 : mp - 9;
+	int y = yoe + era * 400 + (m <= 2);
+	
+	out[0] = '0' + (y / 1000) % 10;
+	out[1] = '0' + (y / 100) % 10;
+	out[2] = '0' + (y / 10) % 10;
+	out[3] = '0' + y % 10;
+	out[4] = '-';
+	out[5] = '0' + m / 10;
+	out[6] = '0' + m % 10;
+	out[7] = '-';
+	out[8] = '0' + d / 10;
+	out[9] = '0' + d % 10;
+	out[10] = '\0';
+}
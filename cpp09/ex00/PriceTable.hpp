@@ -0,0 +1,135 @@
+#ifndef PRICETABLE_HPP
+#define PRICETABLE_HPP
+
+#include <vector>
+#include <cstddef>
+#include <string>
+#include "RangeIndex.hpp"
+#include "MappedFile.hpp"
+
+// Flat price store: sorted dates packed as days since 1970-01-01,
+// with the exchange rates in a parallel array. A loaded snapshot is used
+// where it is mapped; the first change copies it into the vectors
+class PriceTable
+{
+	public:
+		// Rates of the rows in a date interval
+		struct RangeStats
+		{
+			size_t count;
+			float min;
+			float max;
+			double mean;
+		};
+		
+	private:
+		std::vector<int> _dates;
+		std::vector<float> _rates;
+		
+		// The columns lookups read: the snapshot mapping while one is open,
+		// the vectors otherwise
+		MappedFile _snapshot;
+		const int *_dateView;
+		const float *_rateView;
+		size_t _count;
+		
+		// Optional exact rates at 10^Decimal::DIGITS, parallel to _rates
+		std::vector<long long> _scaled;
+		bool _hasScaled;
+		
+		// Search policy for upperIndex; not part of the data, so swap keeps it
+		bool _interpolate;
+		
+		// Bulk load: rows from _bulkStart on are raw, in arrival order
+		bool _bulk;
+		bool _bulkSorted;
+		size_t _bulkStart;
+		
+		// Built from _rates by the first range query after a change
+		mutable RangeIndex _range;
+		mutable bool _rangeValid;
+		
+		size_t _interpolationIndex(int date) const;
+		void _detach(void);
+		void _sync(void);
+		void _sortTail(void);
+		void _mergeTail(void);
+		
+	public:
+		// Constructor
+		PriceTable(void);
+		
+		// Copy constructor
+		PriceTable(const PriceTable &other);
+		
+		// Assignment operator
+		PriceTable &operator=(const PriceTable &other);
+		
+		// Destructor
+		~PriceTable(void);
+		
+		// Insert a rate, keeping dates sorted; an existing date is overwritten
+		void insert(int date, float rate);
+		
+		// Insert with an exact scaled rate as well (see enableScaled)
+		void insert(int date, float rate, long long scaled);
+		
+		// Bulk load for rows in any order: inserts just append until
+		// endBulk(), which sorts them by date, in runs on the shared
+		// ThreadPool when there are many, and keeps the last row written
+		// for each date. Lookups are not valid in between
+		void beginBulk(void);
+		void endBulk(void);
+		bool inBulk(void) const;
+		
+		// Find the rate of the latest date <= date
+		bool find(int date, float &rate) const;
+		bool findScaled(int date, long long &scaled) const;
+		
+		// Keep the exact scaled column; existing rates are converted once
+		void enableScaled(void);
+		bool hasScaled(void) const;
+		
+		// Daily dates are close to evenly spaced, so interpolation search
+		// usually lands within a few slots of the answer in one or two probes
+		void setInterpolation(bool enabled);
+		bool isInterpolated(void) const;
+		
+		// Number of dates <= date (the upper_bound index)
+		size_t upperIndex(int date) const;
+		
+		// Same as upperIndex, galloping outward from a previous answer
+		size_t upperIndexFrom(int date, size_t hint) const;
+		
+		// Count, min, max and mean of the rates dated from..to, both
+		// included, in O(1) once the range index is built; false when no
+		// row falls in the interval
+		bool rangeStats(int from, int to, RangeStats &stats) const;
+		
+		// Resolve many dates at once; rates[i] is valid only where found[i] is set
+		void findBatch(const std::vector<int> &dates, std::vector<float> &rates, std::vector<char> &found) const;
+		
+		void swap(PriceTable &other);
+		void clear(void);
+		void reserve(size_t n);
+		size_t size(void) const;
+		bool empty(void) const;
+		
+		// Raw column access
+		int dateAt(size_t i) const;
+		float rateAt(size_t i) const;
+		
+		// Binary snapshot: header, then the date column, then the rate column,
+		// all in native byte order so loading is a straight read
+		bool saveSnapshot(const std::string &filename) const;
+		bool loadSnapshot(const std::string &filename);
+		
+		// Pack "YYYY-MM-DD" into days since epoch; false on malformed input
+		// or on a day that does not exist (leap years included)
+		static bool packDate(const char *str, size_t len, int &key);
+		
+		// Write a packed date back as "YYYY-MM-DD" (out needs 11 bytes)
+		static void unpackDate(int key, char *out);
+};
+
+#endif
@@ -0,0 +1,19 @@
+#ifndef PROFILERPOINTS_HPP
+#define PROFILERPOINTS_HPP
+
+// The phases and events btc profiles, as X(NAME, "label") entries that
+// become Profiler::PHASE_NAME and Profiler::EVENT_NAME
+#define PROFILER_PHASES(X) \
+	X(LOAD, "load") \
+	X(PARSE, "parse") \
+	X(VALIDATE, "validate") \
+	X(LOOKUP, "lookup") \
+	X(OUTPUT, "output")
+
+#define PROFILER_EVENTS(X) \
+	X(LINES, "lines") \
+	X(RESULTS, "results") \
+	X(ERRORS, "errors") \
+	X(FLUSHES, "flushes")
+
+#endif
@@ -0,0 +1,115 @@
+#include "RangeIndex.hpp"
+
+RangeIndex::RangeIndex(void) : _size(0)
+{
+}
+
+RangeIndex::RangeIndex(const RangeIndex &other) : _prefix(other._prefix), _min(other._min), _max(other._max),
+	_size(other._size)
+{
+}
+
+RangeIndex &RangeIndex::operator=(const RangeIndex &other)
+{
+	if (this != &other)
+	{
+		_prefix = other._prefix;
+		_min = other._min;
+		_max = other._max;
+		_size = other._size;
+	}
+	return *this;
+}
+
+RangeIndex::~RangeIndex(void)
+{
+}
+
+// floor(log2(length)) for length >= 1
+unsigned int RangeIndex::_level(size_t length)
+{
+	unsigned int k = 0;
+	while (length >>= 1)
+		k++;
+	return k;
+}
+
+void RangeIndex::build(const float *values, size_t n)
+{
+	_size = n;
+	_prefix.resize(n + 1);
+	_prefix[0] = 0.0;
+	for (size_t i = 0; i < n; i++)
+		_prefix[i + 1] = _prefix[i] + values[i];
+	
+	unsigned int levels = n ? _level(n) + 1 : 0;
+	_min.resize(levels * n);
+	_max.resize(levels * n);
+	for (size_t i = 0; i < n; i++)
+	{
+		_min[i] = values[i];
+		_max[i] = values[i];
+	}
+	
+	// A run of 2^k is two runs of 2^(k-1); the loops have no dependency
+	// between iterations, so they vectorize
+	for (unsigned int k = 1; k < levels; k++)
+	{
+		size_t half = static_cast<size_t>(1) << (k - 1);
+		const float *lowMin = &_min[(k - 1) * n];
+		const float *lowMax = &_max[(k - 1) * n];
+		float *levelMin = &_min[k * n];
+		float *levelMax = &_max[k * n];
+		size_t count = n - 2 * half + 1;
+		for (size_t i = 0; i < count; i++)
+		{
+			float a = lowMin[i];
+			float b = lowMin[i + half];
+			levelMin[i] = b < a ? b : a;
+			float c = lowMax[i];
+			float d = lowMax[i + half];
+			levelMax[i] = d > c ? d : c;
+		}
+	}
+}
+
+void RangeIndex::clear(void)
+{
+	_prefix.clear();
+	_min.clear();
+	_max.clear();
+	_size = 0;
+}
+
+size_t RangeIndex::size(void) const
+{
+	return _size;
+}
+
+double RangeIndex::sum(size_t first, size_t last) const
+{
+	return _prefix[last] - _prefix[first];
+}
+
+float RangeIndex::min(size_t first, size_t last) const
+{
+	unsigned int k = _level(last - first);
+	const float *level = &_min[k * _size];
+	float a = level[first];
+	float b = level[last - (static_cast<size_t>(1) << k)];
+	return b < a ? b : a;
+}
+
+float RangeIndex::max(size_t first, size_t last) const
+{
+	unsigned int k = _level(last - first);
+	const float *level = &_max[k * _size];
+	float a = level[first];
+	float b = level[last - (static_cast<size_t>(1) << k)];
+	return b > a ? b : a;
+}
+
+size_t RangeIndex::memoryUsage(void) const
+{
+	return _prefix.capacity() * sizeof(double) + (_min.capacity() + _max.capacity()) * sizeof(float);
+}
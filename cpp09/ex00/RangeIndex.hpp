@@ -0,0 +1,48 @@
+#ifndef RANGEINDEX_HPP
+#define RANGEINDEX_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Sum, minimum and maximum of a column over any index range [first, last)
+// in O(1): prefix sums in double for the sum, and sparse tables for the
+// extremes, where level k holds the extreme of every run of 2^k values so
+// that two overlapping runs cover any range. Built once in O(n log n)
+// time and space (about 160 MiB per million rows); the column changing means
+// building it again
+class RangeIndex
+{
+	private:
+		std::vector<double> _prefix;	// _prefix[i]: sum of values [0, i)
+		std::vector<float> _min;		// level k at k * n, run starting at i
+		std::vector<float> _max;
+		size_t _size;
+		
+		static unsigned int _level(size_t length);
+		
+	public:
+		// Constructor
+		RangeIndex(void);
+		
+		// Copy constructor
+		RangeIndex(const RangeIndex &other);
+		
+		// Assignment operator
+		RangeIndex &operator=(const RangeIndex &other);
+		
+		// Destructor
+		~RangeIndex(void);
+		
+		void build(const float *values, size_t n);
+		void clear(void);
+		size_t size(void) const;
+		
+		// For first < last <= size()
+		double sum(size_t first, size_t last) const;
+		float min(size_t first, size_t last) const;
+		float max(size_t first, size_t last) const;
+		
+		size_t memoryUsage(void) const;
+};
+
+#endif
@@ -0,0 +1,108 @@
+#include "RateCache.hpp"
+
+RateCache::RateCache(void) : _mask(0), _epoch(1), _hits(0), _misses(0)
+{
+}
+
+RateCache::RateCache(const RateCache &other) : _slots(other._slots), _mask(other._mask),
+	_epoch(other._epoch), _hits(other._hits), _misses(other._misses)
+{
+}
+
+RateCache &RateCache::operator=(const RateCache &other)
+{
+	if (this != &other)
+	{
+		_slots = other._slots;
+		_mask = other._mask;
+		_epoch = other._epoch;
+		_hits = other._hits;
+		_misses = other._misses;
+	}
+	return *this;
+}
+
+RateCache::~RateCache(void)
+{
+}
+
+void RateCache::resize(size_t slots)
+{
+	size_t size = 0;
+	if (slots > 0)
+	{
+		size = 1;
+		while (size * 2 <= slots)
+			size *= 2;
+	}
+	
+	Slot empty = { 0, 0, 0.0f, false };
+	_slots.assign(size, empty);
+	_mask = size > 0 ? size - 1 : 0;
+	_epoch = 1;
+	resetCounters();
+}
+
+size_t RateCache::capacity(void) const
+{
+	return _slots.size();
+}
+
+bool RateCache::enabled(void) const
+{
+	return !_slots.empty();
+}
+
+bool RateCache::lookup(int key, float &rate, bool &found)
+{
+	// Consecutive days land in consecutive slots
+	const Slot &slot = _slots[static_cast<unsigned int>(key) & _mask];
+	if (slot.epoch == _epoch && slot.key == key)
+	{
+		rate = slot.rate;
+		found = slot.found;
+		_hits++;
+		return true;
+	}
+	_misses++;
+	return false;
+}
+
+void RateCache::store(int key, float rate, bool found)
+{
+	Slot &slot = _slots[static_cast<unsigned int>(key) & _mask];
+	slot.key = key;
+	slot.epoch = _epoch;
+	slot.rate = rate;
+	slot.found = found;
+}
+
+void RateCache::invalidate(void)
+{
+	if (_slots.empty())
+		return;
+	
+	// On wrap-around old epochs could match again, so wipe for real
+	if (++_epoch == 0)
+	{
+		Slot empty = { 0, 0, 0.0f, false };
+		_slots.assign(_slots.size(), empty);
+		_epoch = 1;
+	}
+}
+
+unsigned long RateCache::hits(void) const
+{
+	return _hits;
+}
+
+unsigned long RateCache::misses(void) const
+{
+	return _misses;
+}
+
+void RateCache::resetCounters(void)
+{
+	_hits = 0;
+	_misses = 0;
+}
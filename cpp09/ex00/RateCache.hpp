@@ -0,0 +1,61 @@
+#ifndef RATECACHE_HPP
+#define RATECACHE_HPP
+
+#include <vector>
+#include <cstddef>
+
+// Direct-mapped cache of lookup results keyed on the packed date; a slot
+// remembers whether the date resolved at all, so misses before the first
+// price are cached too
+class RateCache
+{
+	private:
+		struct Slot
+		{
+			int key;
+			unsigned int epoch;
+			float rate;
+			bool found;
+		};
+		
+		std::vector<Slot> _slots;
+		size_t _mask;
+		
+		// Slots from an older epoch are empty; clearing is a counter bump
+		unsigned int _epoch;
+		
+		unsigned long _hits;
+		unsigned long _misses;
+		
+	public:
+		// Constructor (disabled, no slots)
+		RateCache(void);
+		
+		// Copy constructor
+		RateCache(const RateCache &other);
+		
+		// Assignment operator
+		RateCache &operator=(const RateCache &other);
+		
+		// Destructor
+		~RateCache(void);
+		
+		// Resize to the largest power of two <= slots; 0 disables the cache.
+		// Contents and counters are reset
+		void resize(size_t slots);
+		size_t capacity(void) const;
+		bool enabled(void) const;
+		
+		// True on a hit, with the cached outcome in rate and found
+		bool lookup(int key, float &rate, bool &found);
+		void store(int key, float rate, bool found);
+		
+		// Forget every entry (prices changed); counters are kept
+		void invalidate(void);
+		
+		unsigned long hits(void) const;
+		unsigned long misses(void) const;
+		void resetCounters(void);
+};
+
+#endif
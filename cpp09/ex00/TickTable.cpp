@@ -0,0 +1,282 @@
+#include "TickTable.hpp"
+#include "PriceTable.hpp"
+#include "Decimal.hpp"
+#include <algorithm>
+
+TickTable::TickTable(void) : _ticks(0), _lastOffset(0), _lastSecond(0)
+{
+}
+
+TickTable::TickTable(const TickTable &other) : _days(other._days), _dayBlocks(other._dayBlocks),
+	_dayClose(other._dayClose), _blocks(other._blocks), _stream(other._stream), _ticks(other._ticks),
+	_lastOffset(other._lastOffset), _lastSecond(other._lastSecond)
+{
+}
+
+TickTable &TickTable::operator=(const TickTable &other)
+{
+	if (this != &other)
+	{
+		_days = other._days;
+		_dayBlocks = other._dayBlocks;
+		_dayClose = other._dayClose;
+		_blocks = other._blocks;
+		_stream = other._stream;
+		_ticks = other._ticks;
+		_lastOffset = other._lastOffset;
+		_lastSecond = other._lastSecond;
+	}
+	return *this;
+}
+
+TickTable::~TickTable(void)
+{
+}
+
+static bool twoDigits(const char *s, int limit, int &value)
+{
+	unsigned int hi = static_cast<unsigned char>(s[0] - '0');
+	unsigned int lo = static_cast<unsigned char>(s[1] - '0');
+	if (hi > 9 || lo > 9)
+		return false;
+	value = static_cast<int>(hi * 10 + lo);
+	return value < limit;
+}
+
+bool TickTable::packTimestamp(const char *str, size_t len, int &day, int &second)
+{
+	if (len != 19 || (str[10] != ' ' && str[10] != 'T') || str[13] != ':' || str[16] != ':')
+		return false;
+	int h;
+	int m;
+	int s;
+	if (!twoDigits(str + 11, 24, h) || !twoDigits(str + 14, 60, m) || !twoDigits(str + 17, 60, s))
+		return false;
+	if (!PriceTable::packDate(str, 10, day))
+		return false;
+	second = h * 3600 + m * 60 + s;
+	return true;
+}
+
+void TickTable::unpackTimestamp(int day, int second, char *out)
+{
+	PriceTable::unpackDate(day, out);
+	int h = second / 3600;
+	int m = second / 60 % 60;
+	int s = second % 60;
+	out[10] = ' ';
+	out[11] = '0' + h / 10;
+	out[12] = '0' + h % 10;
+	out[13] = ':';
+	out[14] = '0' + m / 10;
+	out[15] = '0' + m % 10;
+	out[16] = ':';
+	out[17] = '0' + s / 10;
+	out[18] = '0' + s % 10;
+	out[19] = '\0';
+}
+
+// Gap byte, then the zigzag price change in 7-bit groups, low first, with
+// the high bit set on every byte but the last
+void TickTable::_encode(int gap, unsigned long long delta)
+{
+	_stream.push_back(static_cast<unsigned char>(gap));
+	unsigned long long zigzag = (delta << 1) ^ (0 - (delta >> 63));
+	while (zigzag >= 0x80)
+	{
+		_stream.push_back(static_cast<unsigned char>(zigzag | 0x80));
+		zigzag >>= 7;
+	}
+	_stream.push_back(static_cast<unsigned char>(zigzag));
+}
+
+const unsigned char *TickTable::_decode(const unsigned char *p, int &gap, unsigned long long &delta)
+{
+	gap = *p++;
+	unsigned long long zigzag = 0;
+	unsigned int shift = 0;
+	while (*p & 0x80)
+	{
+		zigzag |= static_cast<unsigned long long>(*p++ & 0x7f) << shift;
+		shift += 7;
+	}
+	zigzag |= static_cast<unsigned long long>(*p++) << shift;
+	delta = (zigzag >> 1) ^ (0 - (zigzag & 1));
+	return p;
+}
+
+bool TickTable::append(int day, int second, long long scaled)
+{
+	if (second < 0 || second >= DAY_SECONDS)
+		return false;
+	bool sameDay = !_days.empty() && day == _days.back();
+	if (!_days.empty() && (day < _days.back() || (sameDay && second < _lastSecond)))
+		return false;
+	
+	if (sameDay && second == _lastSecond)
+	{
+		// Same timestamp: re-encode the last tick against the one before it
+		Block &block = _blocks.back();
+		if (block.count == 1)
+			block.price = scaled;
+		else
+		{
+			int gap;
+			unsigned long long delta;
+			_decode(&_stream[_lastOffset], gap, delta);
+			unsigned long long previous = static_cast<unsigned long long>(_dayClose.back()) - delta;
+			_stream.resize(_lastOffset);
+			_encode(gap, static_cast<unsigned long long>(scaled) - previous);
+		}
+		_dayClose.back() = scaled;
+		return true;
+	}
+	
+	if (!sameDay)
+	{
+		if (_dayBlocks.empty())
+			_dayBlocks.push_back(0);
+		_days.push_back(day);
+		_dayClose.push_back(scaled);
+		_dayBlocks.push_back(_blocks.size());
+	}
+	
+	// A block ends at BLOCK_TICKS, at the end of a day, or at a gap too
+	// long for its byte
+	int gap = second - _lastSecond;
+	if (!sameDay || _blocks.back().count >= BLOCK_TICKS || gap > 0xff)
+	{
+		Block block;
+		block.offset = _stream.size();
+		block.second = second;
+		block.count = 1;
+		block.price = scaled;
+		_blocks.push_back(block);
+		_dayBlocks.back() = _blocks.size();
+	}
+	else
+	{
+		_lastOffset = _stream.size();
+		_encode(gap, static_cast<unsigned long long>(scaled) - static_cast<unsigned long long>(_dayClose.back()));
+		_blocks.back().count++;
+	}
+	_lastSecond = second;
+	_dayClose.back() = scaled;
+	_ticks++;
+	return true;
+}
+
+struct BlockSecondLess
+{
+	template <typename Block>
+	bool operator()(int second, const Block &block) const
+	{
+		return second < block.second;
+	}
+};
+
+bool TickTable::find(int day, int second, long long &scaled) const
+{
+	size_t d = std::upper_bound(_days.begin(), _days.end(), day) - _days.begin();
+	if (d == 0)
+		return false;
+	d--;
+	if (_days[d] < day)
+	{
+		scaled = _dayClose[d];
+		return true;
+	}
+	
+	// Search the day's block starts, then decode within the one block
+	std::vector<Block>::const_iterator first = _blocks.begin() + _dayBlocks[d];
+	std::vector<Block>::const_iterator it = std::upper_bound(first, _blocks.begin() + _dayBlocks[d + 1],
+		second, BlockSecondLess());
+	if (it == first)
+	{
+		// Before the first tick of the day
+		if (d == 0)
+			return false;
+		scaled = _dayClose[d - 1];
+		return true;
+	}
+	const Block &block = *--it;
+	unsigned long long price = static_cast<unsigned long long>(block.price);
+	int at = block.second;
+	const unsigned char *p = block.count > 1 ? &_stream[block.offset] : NULL;
+	for (unsigned int i = 1; i < block.count; i++)
+	{
+		int gap;
+		unsigned long long delta;
+		p = _decode(p, gap, delta);
+		if (at + gap > second)
+			break;
+		at += gap;
+		price += delta;
+	}
+	scaled = static_cast<long long>(price);
+	return true;
+}
+
+bool TickTable::find(int day, int second, float &rate) const
+{
+	long long scaled;
+	if (!find(day, second, scaled))
+		return false;
+	rate = static_cast<float>(scaled) / Decimal::scale();
+	return true;
+}
+
+void TickTable::shrink(void)
+{
+	std::vector<int>(_days).swap(_days);
+	std::vector<size_t>(_dayBlocks).swap(_dayBlocks);
+	std::vector<long long>(_dayClose).swap(_dayClose);
+	std::vector<Block>(_blocks).swap(_blocks);
+	std::vector<unsigned char>(_stream).swap(_stream);
+}
+
+void TickTable::swap(TickTable &other)
+{
+	_days.swap(other._days);
+	_dayBlocks.swap(other._dayBlocks);
+	_dayClose.swap(other._dayClose);
+	_blocks.swap(other._blocks);
+	_stream.swap(other._stream);
+	std::swap(_ticks, other._ticks);
+	std::swap(_lastOffset, other._lastOffset);
+	std::swap(_lastSecond, other._lastSecond);
+}
+
+void TickTable::clear(void)
+{
+	_days.clear();
+	_dayBlocks.clear();
+	_dayClose.clear();
+	_blocks.clear();
+	_stream.clear();
+	_ticks = 0;
+	_lastOffset = 0;
+	_lastSecond = 0;
+}
+
+size_t TickTable::size(void) const
+{
+	return _ticks;
+}
+
+bool TickTable::empty(void) const
+{
+	return _ticks == 0;
+}
+
+size_t TickTable::dayCount(void) const
+{
+	return _days.size();
+}
+
+size_t TickTable::memoryUsage(void) const
+{
+	return _days.capacity() * sizeof(int) + _dayBlocks.capacity() * sizeof(size_t)
+		+ _dayClose.capacity() * sizeof(long long) + _blocks.capacity() * sizeof(Block)
+		+ _stream.capacity();
+}
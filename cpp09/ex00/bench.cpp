@@ -0,0 +1,412 @@
+#include "BitcoinExchange.hpp"
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <cstdlib>
+#include <cstdio>
+#include <sys/time.h>
+#include <sys/resource.h>
+
+// Benchmark harness for btc: generates a price history and a query file,
+// then times each loading and lookup mode of BitcoinExchange
+
+static const int FIRST_DAY = 14245;	// 2009-01-01
+static const int LAST_DAY = 47481;	// 2099-12-31
+
+static unsigned int g_seed = 42;
+
+static unsigned int nextRandom(void)
+{
+	g_seed = g_seed * 1103515245u + 12345u;
+	return (g_seed >> 8) & 0xffffff;
+}
+
+// Wall clock in milliseconds
+static double nowMs(void)
+{
+	struct timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec * 1000.0 + tv.tv_usec / 1000.0;
+}
+
+// Peak resident set size of the process so far, in KiB
+static long peakRssKb(void)
+{
+	struct rusage usage;
+	getrusage(RUSAGE_SELF, &usage);
+	return usage.ru_maxrss;
+}
+
+static int spanDays(void)
+{
+	return LAST_DAY - FIRST_DAY + 1;
+}
+
+static void writeDate(std::ostream &out, int key)
+{
+	char buf[11];
+	PriceTable::unpackDate(key, buf);
+	out.write(buf, 10);
+}
+
+// Rows are spread evenly over the accepted date range; past one row per
+// day the dates repeat, which the loaders resolve as overwrites
+static void generatePrices(const std::string &filename, size_t rows)
+{
+	std::ofstream out(filename.c_str());
+	out << "date,exchange_rate\n";
+	for (size_t i = 0; i < rows; i++)
+	{
+		int key = FIRST_DAY + static_cast<int>((i * static_cast<unsigned long long>(spanDays())) / rows);
+		writeDate(out, key);
+		out << ',' << (nextRandom() % 6000000) / 100.0 << '\n';
+	}
+}
+
+// order: "sorted", "random" or "mostly" (sorted with 5% random dates)
+static void generateQueries(const std::string &filename, size_t count, const std::string &order)
+{
+	std::ofstream out(filename.c_str());
+	out << "date | value\n";
+	for (size_t i = 0; i < count; i++)
+	{
+		int key;
+		if (order == "random" || (order == "mostly" && nextRandom() % 100 < 5))
+			key = FIRST_DAY + static_cast<int>(nextRandom() % spanDays());
+		else
+			key = FIRST_DAY + static_cast<int>((i * static_cast<unsigned long long>(spanDays())) / count);
+		
+		// About 2% of lines are malformed or out of range
+		unsigned int kind = nextRandom() % 100;
+		if (kind == 0)
+			out << "not a line\n";
+		else if (kind == 1)
+		{
+			writeDate(out, key);
+			out << " | " << 1000 + nextRandom() % 1000 << '\n';
+		}
+		else
+		{
+			writeDate(out, key);
+			out << " | " << (nextRandom() % 100000) / 100.0 << '\n';
+		}
+	}
+}
+
+static size_t countLines(const std::string &filename)
+{
+	std::ifstream in(filename.c_str());
+	std::string line;
+	size_t n = 0;
+	while (std::getline(in, line))
+		n++;
+	return n > 0 ? n - 1 : 0;
+}
+
+static void report(const std::string &label, double ms, size_t lines)
+{
+	std::cout << std::left << std::setw(34) << label << std::right
+	          << std::fixed << std::setprecision(2) << std::setw(10) << ms << " ms"
+	          << std::setw(14) << std::setprecision(0) << (ms > 0 ? lines / (ms / 1000.0) : 0) << " lines/s"
+	          << std::setw(10) << peakRssKb() << " KiB peak" << std::endl;
+}
+
+enum Loader
+{
+	LOAD_GETLINE,
+	LOAD_IN_PLACE,
+	LOAD_SNAPSHOT
+};
+
+static double timeLoad(BitcoinExchange &btc, Loader loader, const std::string &csv, const std::string &snap)
+{
+	double start = nowMs();
+	if (loader == LOAD_GETLINE)
+		btc.loadDatabase(csv);
+	else if (loader == LOAD_IN_PLACE)
+		btc.loadDatabaseInPlace(csv);
+	else
+		btc.loadSnapshot(snap);
+	return nowMs() - start;
+}
+
+// Time processFile (chunks == 0) or processFileChunked with output discarded
+static double timeProcess(BitcoinExchange &btc, const std::string &input, size_t chunks)
+{
+	std::ofstream sink("/dev/null");
+	std::streambuf *saved = std::cout.rdbuf(sink.rdbuf());
+	double start = nowMs();
+	if (chunks == 0)
+		btc.processFile(input);
+	else
+		btc.processFileChunked(input, chunks);
+	double ms = nowMs() - start;
+	std::cout.rdbuf(saved);
+	std::cout.copyfmt(std::ios(NULL));
+	return ms;
+}
+
+// Time evaluateBatch over queries read from the generated file
+static double timeBatch(BitcoinExchange &btc, const std::string &input)
+{
+	std::vector<BitcoinExchange::Query> queries;
+	std::ifstream in(input.c_str());
+	std::string line;
+	std::getline(in, line);
+	while (std::getline(in, line))
+	{
+		BitcoinExchange::Query q;
+		if (line.size() < 10 || !PriceTable::packDate(line.data(), 10, q.date))
+			continue;
+		q.value = 1.0f;
+		queries.push_back(q);
+	}
+	
+	std::vector<BitcoinExchange::Result> results;
+	double start = nowMs();
+	btc.evaluateBatch(queries, results);
+	return nowMs() - start;
+}
+
+// One tick a second from 2021-01-01 (day 18628), as a random walk in cents
+static void generateTicks(const std::string &filename, size_t rows)
+{
+	std::ofstream out(filename.c_str());
+	out << "timestamp,price\n";
+	long long cents = 3000000;
+	char stamp[20];
+	for (size_t i = 0; i < rows; i++)
+	{
+		cents += static_cast<long long>(nextRandom() % 1001) - 500;
+		cents = cents < 100 ? 100 : cents;
+		TickTable::unpackTimestamp(18628 + static_cast<int>(i / TickTable::DAY_SECONDS),
+			static_cast<int>(i % TickTable::DAY_SECONDS), stamp);
+		out << stamp << ',' << cents / 100 << '.' << std::setw(2) << std::setfill('0') << cents % 100
+		    << std::setfill(' ') << '\n';
+	}
+}
+
+// Random timestamps over the span of the ticks
+static void generateTickQueries(const std::string &filename, size_t count, size_t rows)
+{
+	std::ofstream out(filename.c_str());
+	out << "timestamp | value\n";
+	char stamp[20];
+	for (size_t i = 0; i < count; i++)
+	{
+		size_t at = ((static_cast<unsigned long long>(nextRandom()) << 16) ^ nextRandom()) % rows;
+		TickTable::unpackTimestamp(18628 + static_cast<int>(at / TickTable::DAY_SECONDS),
+			static_cast<int>(at % TickTable::DAY_SECONDS), stamp);
+		out << stamp << " | " << (nextRandom() % 100000) / 100.0 << '\n';
+	}
+}
+
+// Time processTickFile with output discarded
+static double timeTicks(BitcoinExchange &btc, const std::string &input)
+{
+	std::ofstream sink("/dev/null");
+	std::streambuf *saved = std::cout.rdbuf(sink.rdbuf());
+	double start = nowMs();
+	btc.processTickFile(input);
+	double ms = nowMs() - start;
+	std::cout.rdbuf(saved);
+	std::cout.copyfmt(std::ios(NULL));
+	return ms;
+}
+
+// Random intervals of up to a year, as "YYYY-MM-DD" pairs
+static void generateRanges(std::vector<std::pair<std::string, std::string> > &ranges, size_t count)
+{
+	char from[11];
+	char to[11];
+	ranges.clear();
+	for (size_t i = 0; i < count; i++)
+	{
+		int first = FIRST_DAY + static_cast<int>(nextRandom() % spanDays());
+		PriceTable::unpackDate(first, from);
+		PriceTable::unpackDate(first + static_cast<int>(nextRandom() % 366), to);
+		ranges.push_back(std::make_pair(std::string(from, 10), std::string(to, 10)));
+	}
+}
+
+// Time rangeStats over the first count intervals
+static double timeRanges(BitcoinExchange &btc, const std::vector<std::pair<std::string, std::string> > &ranges,
+	size_t count)
+{
+	PriceTable::RangeStats stats;
+	double checksum = 0.0;
+	double start = nowMs();
+	for (size_t i = 0; i < count; i++)
+	{
+		if (btc.rangeStats(ranges[i].first, ranges[i].second, stats))
+			checksum += stats.mean;
+	}
+	double ms = nowMs() - start;
+	// Keeps the loop from being optimized out
+	if (checksum < 0.0)
+		std::cout << checksum << std::endl;
+	return ms;
+}
+
+// Empty and blank price cells read as 0 in every loader, as in
+// loadDatabase, instead of running on into the next row
+static void checkBlankCells(const std::string &filename)
+{
+	const std::string rows = "2011-01-03,\n2011-01-04,5\n2011-01-05, \n2011-01-06,7\n2011-01-07,\t\n2011-01-08,9\n";
+	{
+		std::ofstream out(filename.c_str());
+		out << "date,exchange_rate\n" << rows;
+	}
+	
+	BitcoinExchange reference;
+	reference.loadDatabase(filename);
+	BitcoinExchange map;
+	map.loadDatabaseInPlace(filename);
+	BitcoinExchange flat;
+	flat.setStoreMode(BitcoinExchange::STORE_FLAT);
+	flat.loadDatabaseInPlace(filename);
+	BitcoinExchange appended;
+	appended.setStoreMode(BitcoinExchange::STORE_FLAT);
+	appended.appendRows(rows);
+	
+	BitcoinExchange *loaded[] = {&reference, &map, &flat, &appended};
+	const char *names[] = {"loadDatabase", "in place, map", "in place, flat", "appendRows, flat"};
+	for (size_t i = 0; i < 4; i++)
+	{
+		PriceTable::RangeStats stats;
+		loaded[i]->rangeStats("2011-01-03", "2011-01-08", stats);
+		std::cout << "  " << std::left << std::setw(20) << names[i] << std::right << stats.count << " rows, min "
+		          << stats.min << ", max " << stats.max << std::endl;
+	}
+	std::remove(filename.c_str());
+}
+
+int main(int argc, char **argv)
+{
+	size_t rows = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 1000000;
+	size_t queries = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 1000000;
+	std::string order = argc > 3 ? argv[3] : "mostly";
+	if (rows == 0 || queries == 0 || (order != "sorted" && order != "random" && order != "mostly"))
+	{
+		std::cerr << "Usage: " << argv[0] << " [rows] [queries] [sorted|random|mostly]" << std::endl;
+		return 1;
+	}
+	
+	const std::string csv = "bench_data.csv";
+	const std::string snap = "bench_data.snap";
+	const std::string input = "bench_input.txt";
+	
+	std::cout << "Generating " << rows << " price rows and " << queries << " " << order << " queries..." << std::endl;
+	generatePrices(csv, rows);
+	generateQueries(input, queries, order);
+	size_t queryLines = countLines(input);
+	{
+		BitcoinExchange btc;
+		btc.setStoreMode(BitcoinExchange::STORE_FLAT);
+		btc.loadDatabaseInPlace(csv);
+		btc.saveSnapshot(snap);
+	}
+	
+	std::cout << "-- blank price cells" << std::endl;
+	checkBlankCells("bench_blank.csv");
+	
+	std::cout << "-- load" << std::endl;
+	{
+		BitcoinExchange btc;
+		report("getline, map", timeLoad(btc, LOAD_GETLINE, csv, snap), rows);
+	}
+	{
+		BitcoinExchange btc;
+		report("in place, map", timeLoad(btc, LOAD_IN_PLACE, csv, snap), rows);
+	}
+	{
+		BitcoinExchange btc;
+		btc.setStoreMode(BitcoinExchange::STORE_FLAT);
+		report("in place, flat", timeLoad(btc, LOAD_IN_PLACE, csv, snap), rows);
+	}
+	{
+		BitcoinExchange btc;
+		report("snapshot, flat", timeLoad(btc, LOAD_SNAPSHOT, csv, snap), rows);
+	}
+	{
+		PriceTable flat;
+		flat.loadSnapshot(snap);
+		PackedTable packed;
+		double start = nowMs();
+		packed.build(flat);
+		report("pack, from flat", nowMs() - start, flat.size());
+		std::cout << "  packed: " << flat.size() << " rows, " << std::fixed << std::setprecision(2)
+		          << static_cast<double>(packed.memoryUsage()) / flat.size() << " bytes a row (flat: "
+		          << sizeof(int) + sizeof(float) << ")" << std::endl;
+		std::cout.copyfmt(std::ios(NULL));
+	}
+	
+	std::cout << "-- lookup" << std::endl;
+	{
+		BitcoinExchange btc;
+		btc.loadDatabaseInPlace(csv);
+		report("processFile, map", timeProcess(btc, input, 0), queryLines);
+		btc.setStoreMode(BitcoinExchange::STORE_FLAT);
+		report("processFile, flat", timeProcess(btc, input, 0), queryLines);
+		btc.setInterpolationSearch(true);
+		report("processFile, flat interpolated", timeProcess(btc, input, 0), queryLines);
+		btc.setInterpolationSearch(false);
+		btc.setCacheSize(4096);
+		report("processFile, flat cached 4096", timeProcess(btc, input, 0), queryLines);
+		std::cout << "  cache: " << btc.getCache().hits() << " hits, " << btc.getCache().misses() << " misses" << std::endl;
+		btc.setCacheSize(0);
+		{
+			std::ofstream records("/dev/null");
+			ErrorLog log(records);
+			btc.setErrorLog(&log);
+			report("processFile, flat error log", timeProcess(btc, input, 0), queryLines);
+			btc.setErrorLog(NULL);
+			std::cout << "  ";
+			log.summary(std::cout);
+		}
+		report("processFileChunked x8, flat", timeProcess(btc, input, 8), queryLines);
+		report("evaluateBatch, flat", timeBatch(btc, input), queryLines);
+		btc.setStoreMode(BitcoinExchange::STORE_PACKED);
+		report("processFile, packed", timeProcess(btc, input, 0), queryLines);
+		report("evaluateBatch, packed", timeBatch(btc, input), queryLines);
+	}
+	
+	std::cout << "-- range" << std::endl;
+	{
+		std::vector<std::pair<std::string, std::string> > ranges;
+		generateRanges(ranges, queries);
+		// The map scans every row of an interval, so it gets fewer of them
+		size_t scanned = std::min(queries, static_cast<size_t>(10000));
+		BitcoinExchange btc;
+		btc.loadDatabaseInPlace(csv);
+		report("rangeStats, map", timeRanges(btc, ranges, scanned), scanned);
+		btc.setStoreMode(BitcoinExchange::STORE_FLAT);
+		report("rangeStats, flat (first, builds)", timeRanges(btc, ranges, 1), 1);
+		report("rangeStats, flat", timeRanges(btc, ranges, queries), queries);
+		btc.setStoreMode(BitcoinExchange::STORE_PACKED);
+		report("rangeStats, packed", timeRanges(btc, ranges, queries), queries);
+	}
+	
+	std::cout << "-- ticks" << std::endl;
+	{
+		const std::string ticks = "bench_ticks.csv";
+		generateTicks(ticks, rows);
+		generateTickQueries(input, queries, rows);
+		BitcoinExchange btc;
+		double start = nowMs();
+		btc.loadTickDatabase(ticks);
+		report("loadTickDatabase", nowMs() - start, rows);
+		report("processTickFile", timeTicks(btc, input), queries);
+		const TickTable &table = btc.getTicks();
+		std::cout << "  ticks: " << table.size() << " in " << table.dayCount() << " days, "
+		          << std::fixed << std::setprecision(2)
+		          << static_cast<double>(table.memoryUsage()) / table.size() << " bytes a tick" << std::endl;
+		std::remove(ticks.c_str());
+	}
+	
+	std::remove(csv.c_str());
+	std::remove(snap.c_str());
+	std::remove(input.c_str());
+	return 0;
+}
@@ -1,4 +1,6 @@
 #include "BitcoinExchange.hpp"
+#include "Profiler.hpp"
+#include <cstdlib>
 
 int main(int argc, char **argv)
 {
@@ -8,14 +10,22 @@ int main(int argc, char **argv)
 		return 1;
 	}
 	
+	PROFILE_PROGRAM();
+	
 	BitcoinExchange btc;
+	btc.setStoreMode(BitcoinExchange::STORE_FLAT);
 	
 	// Load the price database
-	if (!btc.loadDatabase("data.csv"))
+	if (!btc.loadDatabaseInPlace("data.csv"))
 		return 1;
 	
-	// Process the input file
-	btc.processFile(argv[1]);
-	
+	// Process the input file, or standard input when given "-"
+	if (std::string(argv[1]) == "-")
+	{
+		std::ios::sync_with_stdio(false);
+		btc.processStream(std::cin);
+	}
+	else
+		btc.processFile(argv[1]);
 	return 0;
 }
@@ -0,0 +1,23 @@
+#include "BitcoinExchange.hpp"
+
+// Convert a price CSV into a binary snapshot for BitcoinExchange::loadSnapshot
+int main(int argc, char **argv)
+{
+	if (argc != 3)
+	{
+		std::cerr << "Usage: " << argv[0] << " <data.csv> <output.snap>" << std::endl;
+		return 1;
+	}
+	
+	BitcoinExchange btc;
+	btc.setStoreMode(BitcoinExchange::STORE_FLAT);
+	if (!btc.loadDatabaseInPlace(argv[1]))
+		return 1;
+	
+	if (!btc.saveSnapshot(argv[2]))
+	{
+		std::cerr << "Error: could not write snapshot." << std::endl;
+		return 1;
+	}
+	return 0;
+}
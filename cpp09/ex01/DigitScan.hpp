@@ -0,0 +1,93 @@
+#ifndef DIGITSCAN_HPP
+#define DIGITSCAN_HPP
+
+#include <cstddef>
+#include <cstring>
+
+// Eight digits at a time on little-endian GCC and Clang targets
+#if defined(__GNUC__) && defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+# define DIGITSCAN_SWAR 1
+#else
+# define DIGITSCAN_SWAR 0
+#endif
+
+// Decimal digit runs read a 64-bit word at a time (SWAR, SIMD within a
+// register): one load tests eight bytes for digits and three multiplies
+// convert them, where a plain loop takes a compare and a multiply per
+// byte. Words are loaded with memcpy, so any alignment is fine; the
+// last bytes before end, and every byte on other targets, go through
+// the plain loop
+class DigitScan
+{
+	private:
+		typedef unsigned long long Word;
+		
+		static Word _load(const char *p)
+		{
+			Word w;
+			std::memcpy(&w, p, sizeof(w));
+			return w;
+		}
+		
+		// High bit set in each byte that is not '0'..'9': digits become
+		// 0..9 once xored with '0', and adding 0x76 to the low seven bits
+		// carries into the high bit exactly for 10 and up
+		static Word _nonDigits(Word w)
+		{
+			const Word ones = 0x0101010101010101ULL;
+			Word x = w ^ (ones * '0');
+			return (((x & (ones * 0x7f)) + ones * 0x76) | x) & (ones * 0x80);
+		}
+		
+		// Value of eight digit bytes, the first loaded one the most
+		// significant: pairs, then quads, then the whole word are combined
+		// with one multiply each
+		static Word _eight(Word w)
+		{
+			w = ((w & 0x0f0f0f0f0f0f0f0fULL) * 2561) >> 8;
+			w = ((w & 0x00ff00ff00ff00ffULL) * 6553601) >> 16;
+			return ((w & 0x0000ffff0000ffffULL) * 42949672960001ULL) >> 32;
+		}
+		
+		// Private constructors: static functions only
+		DigitScan(void);
+		DigitScan(const DigitScan &other);
+		DigitScan &operator=(const DigitScan &other);
+		
+	public:
+		// Read the digits at p into value, leaving p after them (at p when
+		// there are none, with value 0). False as soon as value passes
+		// limit, which must be below 10^11 so no step overflows
+		static bool parse(const char *&p, const char *end, unsigned long long limit, unsigned long long &value)
+		{
+			value = 0;
+#if DIGITSCAN_SWAR
+			static const Word pow10[9] = {1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000};
+			while (end - p >= 8)
+			{
+				Word w = _load(p);
+				Word bad = _nonDigits(w);
+				size_t n = bad ? __builtin_ctzll(bad) / 8 : 8;
+				if (n == 0)
+					return true;
+				// The n digits are shifted to the top, so the bytes below
+				// read as leading zeros
+				value = value * pow10[n] + _eight(w << (64 - 8 * n));
+				p += n;
+				if (value > limit)
+					return false;
+				if (n < 8)
+					return true;
+			}
+#endif
+			for (; p < end && static_cast<unsigned char>(*p - '0') <= 9; p++)
+			{
+				value = value * 10 + (*p - '0');
+				if (value > limit)
+					return false;
+			}
+			return true;
+		}
+};
+
+#endif
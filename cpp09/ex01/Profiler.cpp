@@ -0,0 +1,213 @@
+#include "Profiler.hpp"
+#include <iostream>
+#include <ctime>
+#include <cstring>
+#include <cstdlib>
+#include <pthread.h>
+#ifdef __linux__
+# include <linux/perf_event.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+Profiler::Totals *volatile Profiler::_threads = NULL;
+int Profiler::_counters[COUNTER_COUNT] = { -1, -1, -1, -1 };
+
+static pthread_key_t totalsKey;
+static pthread_once_t totalsOnce = PTHREAD_ONCE_INIT;
+
+// Relaxed atomics: plain loads and stores, but a reader on another thread
+// sees each total whole
+static unsigned long long load(const unsigned long long &slot)
+{
+	return __atomic_load_n(&slot, __ATOMIC_RELAXED);
+}
+
+static void store(unsigned long long &slot, unsigned long long value)
+{
+	__atomic_store_n(&slot, value, __ATOMIC_RELAXED);
+}
+
+Profiler::Scope::Scope(Phase phase) : _phase(phase), _start(Profiler::now())
+{
+}
+
+Profiler::Scope::~Scope(void)
+{
+	Profiler::add(_phase, Profiler::now() - _start);
+}
+
+void Profiler::_createKey(void)
+{
+	pthread_key_create(&totalsKey, NULL);
+}
+
+// The totals of the calling thread, made and linked in on its first use
+Profiler::Totals &Profiler::_mine(void)
+{
+	pthread_once(&totalsOnce, _createKey);
+	Totals *mine = static_cast<Totals *>(pthread_getspecific(totalsKey));
+	if (mine)
+		return *mine;
+	mine = new Totals();
+	Totals *seen = __atomic_load_n(&_threads, __ATOMIC_ACQUIRE);
+	for (;;)
+	{
+		mine->next = seen;
+		Totals *now = __sync_val_compare_and_swap(&_threads, seen, mine);
+		if (now == seen)
+			break;
+		seen = now;
+	}
+	pthread_setspecific(totalsKey, mine);
+	return *mine;
+}
+
+template <int N>
+unsigned long long Profiler::_sum(unsigned long long (Totals::*field)[N], int index)
+{
+	unsigned long long total = 0;
+	for (Totals *t = __atomic_load_n(&_threads, __ATOMIC_ACQUIRE); t; t = t->next)
+		total += load((t->*field)[index]);
+	return total;
+}
+
+unsigned long long Profiler::now(void)
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	return __builtin_ia32_rdtsc();
+#else
+	return static_cast<unsigned long long>(std::clock());
+#endif
+}
+
+void Profiler::add(Phase phase, unsigned long long ticks)
+{
+	Totals &mine = _mine();
+	store(mine.ticks[phase], load(mine.ticks[phase]) + ticks);
+	store(mine.calls[phase], load(mine.calls[phase]) + 1);
+}
+
+void Profiler::count(Event event, unsigned long long amount)
+{
+	Totals &mine = _mine();
+	store(mine.events[event], load(mine.events[event]) + amount);
+}
+
+unsigned long long Profiler::ticks(Phase phase)
+{
+	return _sum(&Totals::ticks, phase);
+}
+
+unsigned long long Profiler::calls(Phase phase)
+{
+	return _sum(&Totals::calls, phase);
+}
+
+unsigned long long Profiler::events(Event event)
+{
+	return _sum(&Totals::events, event);
+}
+
+bool Profiler::startCounters(void)
+{
+	stopCounters();
+	bool started = false;
+#ifdef __linux__
+	static const unsigned long long configs[COUNTER_COUNT] = {
+		PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CACHE_MISSES, PERF_COUNT_HW_BRANCH_MISSES
+	};
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		struct perf_event_attr attr;
+		std::memset(&attr, 0, sizeof(attr));
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.size = sizeof(attr);
+		attr.config = configs[i];
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.inherit = 1;
+		long fd = syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0);
+		_counters[i] = static_cast<int>(fd);
+		started = started || fd >= 0;
+	}
+#endif
+	return started;
+}
+
+bool Profiler::readCounter(Counter counter, unsigned long long &value)
+{
+#ifdef __linux__
+	if (_counters[counter] >= 0)
+		return read(_counters[counter], &value, sizeof(value)) == static_cast<ssize_t>(sizeof(value));
+#else
+	(void)value;
+#endif
+	return false;
+}
+
+void Profiler::stopCounters(void)
+{
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+#ifdef __linux__
+		if (_counters[i] >= 0)
+			close(_counters[i]);
+#endif
+		_counters[i] = -1;
+	}
+}
+
+void Profiler::_reportAtExit(void)
+{
+	report(std::cerr);
+}
+
+void Profiler::startProgram(void)
+{
+	if (std::getenv("PROFILE_COUNTERS") && !startCounters())
+		std::cerr << "profile: no hardware counters on this system" << std::endl;
+	std::atexit(_reportAtExit);
+}
+
+void Profiler::report(std::ostream &out)
+{
+#define PROFILER_LABEL(name, label) label,
+	static const char *phases[PHASE_COUNT] = { PROFILER_PHASES(PROFILER_LABEL) };
+	static const char *events[EVENT_COUNT] = { PROFILER_EVENTS(PROFILER_LABEL) };
+#undef PROFILER_LABEL
+	static const char *counters[COUNTER_COUNT] = { "cycles", "instructions", "cache misses", "branch misses" };
+	
+	for (int i = 0; i < PHASE_COUNT; i++)
+	{
+		unsigned long long total = ticks(static_cast<Phase>(i));
+		unsigned long long n = calls(static_cast<Phase>(i));
+		out << "phase " << phases[i] << ": " << total << " ticks in " << n << " calls";
+		if (n > 0)
+			out << " (" << total / n << " per call)";
+		out << std::endl;
+	}
+	for (int i = 0; i < EVENT_COUNT; i++)
+		out << "event " << events[i] << ": " << Profiler::events(static_cast<Event>(i)) << std::endl;
+	for (int i = 0; i < COUNTER_COUNT; i++)
+	{
+		unsigned long long value;
+		if (readCounter(static_cast<Counter>(i), value))
+			out << "counter " << counters[i] << ": " << value << std::endl;
+	}
+}
+
+void Profiler::reset(void)
+{
+	for (Totals *t = __atomic_load_n(&_threads, __ATOMIC_ACQUIRE); t; t = t->next)
+	{
+		for (int i = 0; i < PHASE_COUNT; i++)
+		{
+			store(t->ticks[i], 0);
+			store(t->calls[i], 0);
+		}
+		for (int i = 0; i < EVENT_COUNT; i++)
+			store(t->events[i], 0);
+	}
+}
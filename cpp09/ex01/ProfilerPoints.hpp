@@ -0,0 +1,15 @@
+#ifndef PROFILERPOINTS_HPP
+#define PROFILERPOINTS_HPP
+
+// The phases and events RPN profiles, as X(NAME, "label") entries that
+// become Profiler::PHASE_NAME and Profiler::EVENT_NAME
+#define PROFILER_PHASES(X) \
+	X(CALCULATE, "calculate") \
+	X(EVALUATE, "evaluate")
+
+#define PROFILER_EVENTS(X) \
+	X(EXPRESSIONS, "expressions") \
+	X(CACHE_HITS, "cache hits") \
+	X(SYNTAX_ERRORS, "syntax errors")
+
+#endif
@@ -1,13 +1,65 @@
 #include "RPN.hpp"
-#include <sstream>
-#include <cmath>
-#include <cstdlib>
+#include "RPNNumeric.hpp"
+#include "DigitScan.hpp"
+
+// Byte classes for the tokenizer: blank (the characters isspace accepts in
+// the C locale), digit, operator, letter or underscore, anything else
+enum
+{
+	BLANK,
+	DIGIT,
+	OPER,
+	NAME,
+	OTHER
+};
+
+static const unsigned char BYTE_CLASS[256] =
+{
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, BLANK, BLANK, BLANK, BLANK, BLANK, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	BLANK, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OPER, OPER, OTHER, OPER, OTHER, OPER,
+	DIGIT, DIGIT, DIGIT, DIGIT, DIGIT, DIGIT, DIGIT, DIGIT,
+	DIGIT, DIGIT, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, NAME, NAME, NAME, NAME, NAME, NAME, NAME,
+	NAME, NAME, NAME, NAME, NAME, NAME, NAME, NAME,
+	NAME, NAME, NAME, NAME, NAME, NAME, NAME, NAME,
+	NAME, NAME, NAME, OTHER, OTHER, OTHER, OTHER, NAME,
+	OTHER, NAME, NAME, NAME, NAME, NAME, NAME, NAME,
+	NAME, NAME, NAME, NAME, NAME, NAME, NAME, NAME,
+	NAME, NAME, NAME, NAME, NAME, NAME, NAME, NAME,
+	NAME, NAME, NAME, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER,
+	OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER, OTHER
+};
+
+static unsigned char classOf(char c)
+{
+	return BYTE_CLASS[static_cast<unsigned char>(c)];
+}
 
 RPN::RPN(void)
 {
 }
 
-RPN::RPN(const RPN &other) : _stack(other._stack)
+RPN::RPN(const RPN &other) : _stack(other._stack), _doubleStack(other._doubleStack),
+	_intStack(other._intStack), _blocks(other._blocks), _cache(other._cache)
 {
 }
 
@@ -16,111 +68,396 @@ RPN &RPN::operator=(const RPN &other)
 	if (this != &other)
 	{
 		_stack = other._stack;
+		_doubleStack = other._doubleStack;
+		_intStack = other._intStack;
+		_blocks = other._blocks;
+		_cache = other._cache;
 	}
 	return *this;
 }
 
 RPN::~RPN(void)
 {
-	while (!_stack.empty())
-		_stack.pop();
 }
 
-bool RPN::_isNumber(const std::string &str)
+const char *RPN::statusMessage(Status status)
 {
-	if (str.empty())
-		return false;
+	switch (status)
+	{
+		case RPN_OK:
+			return "OK";
+		case RPN_SYNTAX_ERROR:
+			return "Syntax error";
+		case RPN_DIVISION_BY_ZERO:
+			return "Division by zero";
+		default:
+			return "Overflow";
+	}
+}
+
+void RPN::_nextToken(const char *&p, const char *end, Token &token)
+{
+	while (p < end && classOf(*p) == BLANK)
+		p++;
+	token.begin = p;
+	if (p == end)
+	{
+		token.kind = TOKEN_END;
+		return;
+	}
 	
-	for (size_t i = 0; i < str.length(); i++)
+	unsigned char first = classOf(*p);
+	token.kind = TOKEN_INVALID;
+	if (first == OPER)
 	{
-		if (!std::isdigit(str[i]))
+		token.op = *p++;
+		token.kind = TOKEN_OPERATOR;
+	}
+	else if (first == DIGIT)
+	{
+		// Digit values are built while scanning instead of by atof after,
+		// eight digits at a time; runs past 11 digits, rare, are redone
+		// one digit at a time in a double
+		const char *start = p;
+		unsigned long long whole;
+		double n;
+		if (DigitScan::parse(p, end, 99999999999ULL, whole))
+			n = static_cast<double>(whole);
+		else
+		{
+			p = start;
+			n = 0;
+			while (p < end && classOf(*p) == DIGIT)
+				n = n * 10 + (*p++ - '0');
+		}
+		token.value = n;
+		token.kind = TOKEN_NUMBER;
+	}
+	else if (first == NAME)
+	{
+		while (p < end && (classOf(*p) == NAME || classOf(*p) == DIGIT))
+			p++;
+		token.kind = TOKEN_NAME;
+	}
+	
+	// A token runs to the next blank; anything left over makes it invalid
+	if (p < end && classOf(*p) != BLANK)
+	{
+		token.kind = TOKEN_INVALID;
+		while (p < end && classOf(*p) != BLANK)
+			p++;
+	}
+	token.len = p - token.begin;
+}
+
+bool RPN::_validate(const char *begin, const char *end, size_t &maxDepth) const
+{
+	const char *p = begin;
+	Token token;
+	size_t depth = 0;
+	
+	maxDepth = 0;
+	for (;;)
+	{
+		_nextToken(p, end, token);
+		if (token.kind == TOKEN_END)
+			break;
+		if (token.kind == TOKEN_NUMBER)
+		{
+			if (++depth > maxDepth)
+				maxDepth = depth;
+		}
+		else if (token.kind == TOKEN_OPERATOR)
+		{
+			// Need at least 2 operands
+			if (depth < 2)
+				return false;
+			depth--;
+		}
+		else
 			return false;
 	}
-	return true;
+	
+	// Final stack should have exactly 1 element
+	return depth == 1;
 }
 
-bool RPN::_isOperator(const std::string &str)
+RPN::Status RPN::tryCalculate(const std::string &expression, float &result)
 {
-	return (str == "+" || str == "-" || str == "*" || str == "/");
+	return tryCalculate(expression.data(), expression.data() + expression.size(), result);
 }
 
-float RPN::_applyOperator(float a, float b, char op)
+RPN::Status RPN::tryCalculate(const char *begin, const char *end, float &result)
 {
-	switch (op)
+	if (_cache.capacity() == 0)
+		return tryCalculate<FloatMode>(begin, end, result);
+	
+	// Every expression tryCalculate accepts is constant, so the outcome is
+	// all there is to keep, failures included
+	RPNCache::Entry *entry = _cache.find(begin, end - begin, false);
+	if (entry && entry->hasResult)
 	{
-		case '+':
-			return a + b;
-		case '-':
-			return a - b;
-		case '*':
-			return a * b;
-		case '/':
-			if (b == 0)
-				throw std::runtime_error("Division by zero");
-			return a / b;
-		default:
-			throw std::runtime_error("Unknown operator");
+		PROFILE_EVENT(EVENT_CACHE_HITS);
+		result = entry->result;
+		return static_cast<Status>(entry->status);
 	}
+	Status status = tryCalculate<FloatMode>(begin, end, result);
+	if (!entry)
+		entry = _cache.insert(begin, end - begin);
+	entry->hasResult = true;
+	entry->status = status;
+	entry->result = status == RPN_OK ? result : 0;
+	return status;
 }
 
 bool RPN::calculate(const std::string &expression, float &result)
 {
-	// Clear the stack
-	while (!_stack.empty())
-		_stack.pop();
+	PROFILE_SCOPE(PHASE_CALCULATE);
+	if (tryCalculate(expression, result) != RPN_OK)
+	{
+		std::cerr << "Error" << std::endl;
+		return false;
+	}
+	return true;
+}
+
+float *RPN::_operands(float *local, size_t depth)
+{
+	if (depth <= INLINE_DEPTH)
+		return local;
+	if (_stack.size() < depth)
+		_stack.resize(depth);
+	return &_stack[0];
+}
+
+double *RPN::_operands(double *local, size_t depth)
+{
+	if (depth <= INLINE_DEPTH)
+		return local;
+	if (_doubleStack.size() < depth)
+		_doubleStack.resize(depth);
+	return &_doubleStack[0];
+}
+
+long long *RPN::_operands(long long *local, size_t depth)
+{
+	if (depth <= INLINE_DEPTH)
+		return local;
+	if (_intStack.size() < depth)
+		_intStack.resize(depth);
+	return &_intStack[0];
+}
+
+bool RPN::compile(const std::string &expression, RPNProgram &program)
+{
+	const char *begin = expression.data();
+	const char *end = begin + expression.size();
+	RPNCache::Entry *entry = NULL;
+	bool ok;
+	if (_cache.capacity() > 0)
+		entry = _cache.find(begin, end - begin, true);
+	if (entry && entry->hasProgram)
+	{
+		program = entry->program;
+		ok = program.size() > 0;
+	}
+	else
+	{
+		ok = _compile(begin, end, program);
+		if (_cache.capacity() > 0)
+		{
+			if (!entry)
+				entry = _cache.insert(begin, end - begin);
+			entry->hasProgram = true;
+			entry->program = program;
+		}
+	}
+	if (!ok)
+		std::cerr << "Error" << std::endl;
+	return ok;
+}
+
+bool RPN::_compile(const char *begin, const char *end, RPNProgram &program)
+{
+	const char *p = begin;
+	Token token;
+	size_t depth = 0;
+	size_t maxDepth = 0;
+	
+	program.clear();
+	for (;;)
+	{
+		_nextToken(p, end, token);
+		if (token.kind == TOKEN_END)
+			break;
+		if (token.kind == TOKEN_NUMBER || token.kind == TOKEN_NAME)
+		{
+			if (token.kind == TOKEN_NUMBER)
+				program.emitConstant(static_cast<float>(token.value));
+			else
+				program.emitVariable(token.begin, token.len);
+			if (++depth > maxDepth)
+				maxDepth = depth;
+		}
+		else if (token.kind == TOKEN_OPERATOR && depth >= 2)
+		{
+			program.emitOperator(token.op);
+			depth--;
+		}
+		else
+			break;
+	}
 	
-	std::istringstream iss(expression);
-	std::string token;
+	// Stopped early or not exactly 1 element left
+	if (token.kind != TOKEN_END || depth != 1)
+	{
+		program.clear();
+		return false;
+	}
+	program.setMaxDepth(maxDepth);
+	return true;
+}
+
+void RPN::setCacheCapacity(size_t entries)
+{
+	_cache.setCapacity(entries);
+}
+
+const RPNCache &RPN::cache(void) const
+{
+	return _cache;
+}
+
+bool RPN::evaluate(const RPNProgram &program, const float *bindings, float &result)
+{
+	size_t n = program.size();
+	if (n == 0)
+		return false;
 	
-	while (iss >> token)
+	float local[INLINE_DEPTH];
+	float *stack = _operands(local, program.maxDepth());
+	size_t top = 0;
+	for (size_t i = 0; i < n; i++)
 	{
-		if (_isNumber(token))
+		const RPNProgram::Instruction &in = program[i];
+		switch (in.op)
 		{
-			// Push number to stack
-			_stack.push(std::atof(token.c_str()));
+			case RPNProgram::OP_CONST:
+				stack[top++] = in.value;
+				break;
+			case RPNProgram::OP_VAR:
+				stack[top++] = bindings[in.var];
+				break;
+			case RPNProgram::OP_ADD:
+				top--;
+				stack[top - 1] = stack[top - 1] + stack[top];
+				break;
+			case RPNProgram::OP_SUB:
+				top--;
+				stack[top - 1] = stack[top - 1] - stack[top];
+				break;
+			case RPNProgram::OP_MUL:
+				top--;
+				stack[top - 1] = stack[top - 1] * stack[top];
+				break;
+			default:
+				top--;
+				if (stack[top] == 0)
+					return false;
+				stack[top - 1] = stack[top - 1] / stack[top];
+				break;
 		}
-		else if (_isOperator(token))
+	}
+	result = stack[0];
+	return true;
+}
+
+bool RPN::evaluate(const RPNProgram &program, const std::vector<float> &bindings, float &result)
+{
+	if (bindings.size() < program.variableCount())
+		return false;
+	return evaluate(program, bindings.empty() ? NULL : &bindings[0], result);
+}
+
+size_t RPN::evaluateBatch(const RPNProgram &program, const float *const *columns, size_t rows,
+	float *results, unsigned char *errors)
+{
+	size_t n = program.size();
+	if (n == 0 || rows == 0)
+		return 0;
+	
+	// One block of BATCH_BLOCK rows per stack slot
+	size_t slots = program.maxDepth() * BATCH_BLOCK;
+	if (_blocks.size() < slots)
+		_blocks.resize(slots);
+	float *blocks = &_blocks[0];
+	unsigned char failed[BATCH_BLOCK];
+	size_t failures = 0;
+	
+	for (size_t first = 0; first < rows; first += BATCH_BLOCK)
+	{
+		size_t count = rows - first < BATCH_BLOCK ? rows - first : BATCH_BLOCK;
+		for (size_t r = 0; r < count; r++)
+			failed[r] = 0;
+		
+		// Each instruction is one loop over the block, with no per-row dispatch
+		size_t top = 0;
+		for (size_t i = 0; i < n; i++)
 		{
-			// Need at least 2 operands
-			if (_stack.size() < 2)
+			const RPNProgram::Instruction &in = program[i];
+			if (in.op == RPNProgram::OP_CONST || in.op == RPNProgram::OP_VAR)
 			{
-				std::cerr << "Error" << std::endl;
-				return false;
+				float *dst = blocks + top * BATCH_BLOCK;
+				if (in.op == RPNProgram::OP_CONST)
+					for (size_t r = 0; r < count; r++)
+						dst[r] = in.value;
+				else
+				{
+					const float *src = columns[in.var] + first;
+					for (size_t r = 0; r < count; r++)
+						dst[r] = src[r];
+				}
+				top++;
+				continue;
 			}
 			
-			// Pop two operands
-			float b = _stack.top();
-			_stack.pop();
-			float a = _stack.top();
-			_stack.pop();
-			
-			// Apply operator
-			try
-			{
-				float res = _applyOperator(a, b, token[0]);
-				_stack.push(res);
-			}
-			catch (const std::exception &e)
+			top--;
+			float *a = blocks + (top - 1) * BATCH_BLOCK;
+			const float *b = blocks + top * BATCH_BLOCK;
+			switch (in.op)
 			{
-				std::cerr << "Error" << std::endl;
-				return false;
+				case RPNProgram::OP_ADD:
+					for (size_t r = 0; r < count; r++)
+						a[r] = a[r] + b[r];
+					break;
+				case RPNProgram::OP_SUB:
+					for (size_t r = 0; r < count; r++)
+						a[r] = a[r] - b[r];
+					break;
+				case RPNProgram::OP_MUL:
+					for (size_t r = 0; r < count; r++)
+						a[r] = a[r] * b[r];
+					break;
+				default:
+					// A zero divisor marks the row and divides by 1 instead
+					for (size_t r = 0; r < count; r++)
+					{
+						unsigned char zero = b[r] == 0;
+						failed[r] |= zero;
+						a[r] = a[r] / (zero ? 1.0f : b[r]);
+					}
+					break;
 			}
 		}
-		else
+		
+		for (size_t r = 0; r < count; r++)
 		{
-			// Invalid token
-			std::cerr << "Error" << std::endl;
-			return false;
+			results[first + r] = failed[r] ? 0.0f : blocks[r];
+			failures += failed[r];
 		}
+		if (errors)
+			for (size_t r = 0; r < count; r++)
+				errors[first + r] = failed[r];
 	}
-	
-	// Final stack should have exactly 1 element
-	if (_stack.size() != 1)
-	{
-		std::cerr << "Error" << std::endl;
-		return false;
-	}
-	
-	result = _stack.top();
-	return true;
+	return failures;
 }
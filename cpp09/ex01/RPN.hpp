@@ -2,22 +2,76 @@
 #define RPN_HPP
 
 #include <string>
-#include <stack>
+#include <vector>
 #include <iostream>
+#include "RPNProgram.hpp"
+#include "RPNCache.hpp"
+#include "Profiler.hpp"
 
 class RPN
 {
+	public:
+		// Outcome of tryCalculate
+		enum Status
+		{
+			RPN_OK,
+			RPN_SYNTAX_ERROR,
+			RPN_DIVISION_BY_ZERO,
+			RPN_OVERFLOW
+		};
+		
 	private:
-		std::stack<float> _stack;
+		// Operand stacks for expressions deeper than INLINE_DEPTH, one per
+		// value type; sized by the validation pass and kept between calls
+		std::vector<float> _stack;
+		std::vector<double> _doubleStack;
+		std::vector<long long> _intStack;
+		
+		static const size_t INLINE_DEPTH = 32;
+		
+		// Stack of row blocks for evaluateBatch, kept between calls
+		std::vector<float> _blocks;
+		
+		static const size_t BATCH_BLOCK = 256;
+		
+		// Expressions seen before, when enabled with setCacheCapacity
+		RPNCache _cache;
+		
+		// What _nextToken found
+		enum TokenKind
+		{
+			TOKEN_END,
+			TOKEN_NUMBER,
+			TOKEN_OPERATOR,
+			TOKEN_NAME,
+			TOKEN_INVALID
+		};
+		
+		// One token; value is set for numbers, op for operators
+		struct Token
+		{
+			TokenKind kind;
+			const char *begin;
+			size_t len;
+			double value;
+			char op;
+		};
+		
+		// Classify the next blank-separated token in [p, end) in one pass over
+		// its bytes, without copying it
+		static void _nextToken(const char *&p, const char *end, Token &token);
 		
-		// Helper function to check if string is a number
-		bool _isNumber(const std::string &str);
+		// Check every token and the operand counts without evaluating;
+		// maxDepth gets the deepest the stack will go
+		bool _validate(const char *begin, const char *end, size_t &maxDepth) const;
 		
-		// Helper function to check if string is an operator
-		bool _isOperator(const std::string &str);
+		// compile without the cache or the "Error" message
+		bool _compile(const char *begin, const char *end, RPNProgram &program);
 		
-		// Helper function to apply operator
-		float _applyOperator(float a, float b, char op);
+		// Operand storage for depth values: local when it is big enough
+		float *_operands(float *local, size_t depth);
+		double *_operands(double *local, size_t depth);
+		long long *_operands(long long *local, size_t depth);
 		
 	public:
 		// Constructor
@@ -32,8 +86,89 @@ class RPN
 		// Destructor
 		~RPN(void);
 		
-		// Process RPN expression
+		// Process RPN expression; prints "Error" on failure
 		bool calculate(const std::string &expression, float &result);
+		
+		// Same evaluation without printing or throwing: failures come back
+		// as a status for the caller to report (see statusMessage)
+		Status tryCalculate(const std::string &expression, float &result);
+		Status tryCalculate(const char *begin, const char *end, float &result);
+		static const char *statusMessage(Status status);
+		
+		// Same grammar in another numeric mode (see RPNNumeric.hpp), e.g.
+		// tryCalculate<Int64Mode>(begin, end, value); float is FloatMode
+		template <typename Mode>
+		Status tryCalculate(const char *begin, const char *end, typename Mode::Value &result);
+		
+		// Compile an expression once for many evaluations. Operands may also
+		// be names (a letter or '_', then letters, digits or '_'), bound at
+		// evaluation time. Bad expressions print "Error" here, once
+		bool compile(const std::string &expression, RPNProgram &program);
+		
+		// Keep up to entries expressions (0, the default, turns it off) so
+		// that float tryCalculate, calculate and compile answer repeated
+		// text from the cache without tokenizing it again: the result for
+		// an evaluation, the program for compile. cache() has the hit rate
+		void setCacheCapacity(size_t entries);
+		const RPNCache &cache(void) const;
+		
+		// Run a compiled program with bindings[i] as the value of variable i
+		// (see RPNProgram::variableIndex); false on division by zero, on an
+		// empty program or, for the vector form, on missing bindings
+		bool evaluate(const RPNProgram &program, const float *bindings, float &result);
+		bool evaluate(const RPNProgram &program, const std::vector<float> &bindings, float &result);
+		
+		// Run a program over rows of columnar input: variable i of row r is
+		// columns[i][r]. Rows are taken a block at a time and each
+		// instruction is applied to the whole block. results[r] gets the
+		// value, or 0 where the row divided by zero; errors[r] (when not
+		// NULL) is 1 for those rows and 0 otherwise. Returns how many failed
+		size_t evaluateBatch(const RPNProgram &program, const float *const *columns, size_t rows,
+			float *results, unsigned char *errors);
 };
 
+template <typename Mode>
+RPN::Status RPN::tryCalculate(const char *begin, const char *end, typename Mode::Value &result)
+{
+	PROFILE_SCOPE(PHASE_EVALUATE);
+	PROFILE_EVENT(EVENT_EXPRESSIONS);
+	size_t maxDepth;
+	if (!_validate(begin, end, maxDepth))
+	{
+		PROFILE_EVENT(EVENT_SYNTAX_ERRORS);
+		return RPN_SYNTAX_ERROR;
+	}
+	
+	// Short expressions run on the C++ stack; deeper ones reuse a member
+	typename Mode::Value local[INLINE_DEPTH];
+	typename Mode::Value *stack = _operands(local, maxDepth);
+	
+	const char *p = begin;
+	Token token;
+	size_t top = 0;
+	for (;;)
+	{
+		_nextToken(p, end, token);
+		if (token.kind == TOKEN_END)
+			break;
+		Status status;
+		if (token.kind == TOKEN_NUMBER)
+		{
+			status = Mode::parse(token.begin, token.len, stack[top]);
+			top++;
+		}
+		else
+		{
+			// Apply operator to the top two operands
+			status = Mode::apply(stack[top - 2], stack[top - 1], token.op, stack[top - 2]);
+			top--;
+		}
+		if (status != RPN_OK)
+			return status;
+	}
+	
+	result = stack[0];
+	return RPN_OK;
+}
+
 #endif
@@ -0,0 +1,159 @@
+#include "RPNCache.hpp"
+#include <cstring>
+
+RPNCache::RPNCache(size_t capacity) : _capacity(capacity), _hits(0), _misses(0)
+{
+	_rebuildIndex();
+}
+
+RPNCache::RPNCache(const RPNCache &other)
+	: _entries(other._entries), _capacity(other._capacity), _hits(other._hits), _misses(other._misses)
+{
+	_rebuildIndex();
+}
+
+RPNCache &RPNCache::operator=(const RPNCache &other)
+{
+	if (this != &other)
+	{
+		_entries = other._entries;
+		_capacity = other._capacity;
+		_hits = other._hits;
+		_misses = other._misses;
+		_rebuildIndex();
+	}
+	return *this;
+}
+
+RPNCache::~RPNCache(void)
+{
+}
+
+RPNCache::Bucket &RPNCache::_bucket(unsigned long hash)
+{
+	return _buckets[hash & (_buckets.size() - 1)];
+}
+
+// Buckets hold iterators into _entries, so a copied list or a new bucket
+// count needs them all again
+void RPNCache::_rebuildIndex(void)
+{
+	size_t count = 1;
+	while (count < _capacity)
+		count *= 2;
+	_buckets.assign(count, Bucket());
+	for (EntryList::iterator it = _entries.begin(); it != _entries.end(); ++it)
+		_bucket(it->hash).push_back(it);
+}
+
+// Evict least recently used entries until at most keep are left
+void RPNCache::_trim(size_t keep)
+{
+	while (_entries.size() > keep)
+	{
+		EntryList::iterator last = --_entries.end();
+		Bucket &bucket = _bucket(last->hash);
+		for (size_t i = 0; i < bucket.size(); i++)
+		{
+			if (bucket[i] == last)
+			{
+				bucket[i] = bucket.back();
+				bucket.pop_back();
+				break;
+			}
+		}
+		_entries.erase(last);
+	}
+}
+
+void RPNCache::setCapacity(size_t capacity)
+{
+	_capacity = capacity;
+	_trim(_capacity);
+	_rebuildIndex();
+}
+
+size_t RPNCache::capacity(void) const
+{
+	return _capacity;
+}
+
+size_t RPNCache::size(void) const
+{
+	return _entries.size();
+}
+
+void RPNCache::clear(void)
+{
+	_entries.clear();
+	_rebuildIndex();
+	_hits = 0;
+	_misses = 0;
+}
+
+// FNV-1a
+unsigned long RPNCache::hash(const char *text, size_t len)
+{
+	unsigned long h = 2166136261UL;
+	for (size_t i = 0; i < len; i++)
+	{
+		h ^= static_cast<unsigned char>(text[i]);
+		h *= 16777619UL;
+	}
+	return h;
+}
+
+RPNCache::Entry *RPNCache::find(const char *text, size_t len, bool wantProgram)
+{
+	Bucket &bucket = _bucket(hash(text, len));
+	for (size_t i = 0; i < bucket.size(); i++)
+	{
+		Entry &entry = *bucket[i];
+		if (entry.expression.size() != len || std::memcmp(entry.expression.data(), text, len) != 0)
+			continue;
+		
+		// Splicing keeps every iterator in the buckets valid
+		_entries.splice(_entries.begin(), _entries, bucket[i]);
+		if (wantProgram ? entry.hasProgram : entry.hasResult)
+			_hits++;
+		else
+			_misses++;
+		return &entry;
+	}
+	_misses++;
+	return NULL;
+}
+
+RPNCache::Entry *RPNCache::insert(const char *text, size_t len)
+{
+	if (_capacity == 0)
+		return NULL;
+	_trim(_capacity - 1);
+	
+	Entry entry;
+	entry.expression.assign(text, len);
+	entry.hash = hash(text, len);
+	entry.hasResult = false;
+	entry.status = 0;
+	entry.result = 0;
+	entry.hasProgram = false;
+	_entries.push_front(entry);
+	_bucket(entry.hash).push_back(_entries.begin());
+	return &_entries.front();
+}
+
+size_t RPNCache::hits(void) const
+{
+	return _hits;
+}
+
+size_t RPNCache::misses(void) const
+{
+	return _misses;
+}
+
+double RPNCache::hitRate(void) const
+{
+	size_t lookups = _hits + _misses;
+	return lookups == 0 ? 0 : static_cast<double>(_hits) / lookups;
+}
@@ -0,0 +1,88 @@
+#ifndef RPNCACHE_HPP
+#define RPNCACHE_HPP
+
+#include <string>
+#include <list>
+#include <vector>
+#include "RPNProgram.hpp"
+
+// Bounded least-recently-used cache of expression text, for callers that
+// send the same expressions again and again. Entries are found by a hash
+// of the text and then compared in full, so a collision only costs a
+// compare. An entry keeps the outcome of an evaluation (constant
+// expressions), the compiled program (see RPN::compile), or both
+class RPNCache
+{
+	public:
+		struct Entry
+		{
+			std::string expression;
+			unsigned long hash;
+			
+			// Set by tryCalculate: status is an RPN::Status
+			bool hasResult;
+			int status;
+			float result;
+			
+			// Set by compile; an empty program means it did not compile
+			bool hasProgram;
+			RPNProgram program;
+		};
+	
+	private:
+		typedef std::list<Entry> EntryList;
+		typedef std::vector<EntryList::iterator> Bucket;
+		
+		// Most recently used first, found through buckets by hash; there
+		// are as many buckets as the capacity rounded up to a power of two
+		EntryList _entries;
+		std::vector<Bucket> _buckets;
+		size_t _capacity;
+		size_t _hits;
+		size_t _misses;
+		
+		Bucket &_bucket(unsigned long hash);
+		void _rebuildIndex(void);
+		void _trim(size_t keep);
+	
+	public:
+		// Constructor; a capacity of 0 keeps nothing
+		RPNCache(size_t capacity = 0);
+		
+		// Copy constructor
+		RPNCache(const RPNCache &other);
+		
+		// Assignment operator
+		RPNCache &operator=(const RPNCache &other);
+		
+		// Destructor
+		~RPNCache(void);
+		
+		// Change the bound, dropping the least recently used entries
+		void setCapacity(size_t capacity);
+		size_t capacity(void) const;
+		size_t size(void) const;
+		
+		// Drop every entry and reset the counters
+		void clear(void);
+		
+		static unsigned long hash(const char *text, size_t len);
+		
+		// The entry for the text, moved to the front, or NULL. wantProgram
+		// says what the caller needs: an entry without it counts as a miss
+		// but is still returned to be filled in
+		Entry *find(const char *text, size_t len, bool wantProgram);
+		
+		// A new empty entry for the text at the front, evicting the least
+		// recently used one when full; NULL when the capacity is 0
+		Entry *insert(const char *text, size_t len);
+		
+		// Lookups that found what they wanted, and those that did not
+		size_t hits(void) const;
+		size_t misses(void) const;
+		
+		// hits / (hits + misses), 0 before any lookup
+		double hitRate(void) const;
+};
+
+#endif
@@ -0,0 +1,237 @@
+#ifndef RPNCONSTANT_HPP
+#define RPNCONSTANT_HPP
+
+// Compile-time RPN: RPNConstant<'3', ' ', '4', ' ', '+'> is evaluated by
+// the compiler, the characters of the expression given one by one (C++98
+// takes no string literal as a template argument). The grammar is the
+// one of RPN::calculate with single-digit operands: digits and + - * /,
+// separated by blanks, up to 32 characters. Values are kept as exact
+// fractions in lowest terms, so numerator and denominator are integral
+// constant expressions, usable in array bounds and other templates, and
+// value() is the float RPN::calculate would print for the fraction (a
+// long chain of inexact float steps may round its last bit differently).
+// A malformed expression fails to compile with RPNError_Syntax in the
+// message, and a division by zero with RPNError_DivisionByZero. At most
+// 16 tokens fit in 32 characters, which keeps every fraction, before it
+// is reduced too, far inside long
+
+// Defined only for false, so that naming one with true stops compilation
+template <bool Fails>
+struct RPNError_Syntax;
+
+template <>
+struct RPNError_Syntax<false>
+{
+};
+
+template <bool Fails>
+struct RPNError_DivisionByZero;
+
+template <>
+struct RPNError_DivisionByZero<false>
+{
+};
+
+// true, but only known once T is, so an error base naming it is checked
+// when the template is used instead of where it is defined
+template <typename T>
+struct RPNFailsFor
+{
+	static const bool value = true;
+};
+
+// Greatest common divisor of A, B >= 0
+template <long A, long B>
+struct RPNGcd
+{
+	static const long value = RPNGcd<B, A % B>::value;
+};
+
+template <long A>
+struct RPNGcd<A, 0>
+{
+	static const long value = A;
+};
+
+// N / D in lowest terms with a positive denominator; D != 0
+template <long N, long D>
+struct RPNFraction
+{
+	private:
+		static const long _sign = D < 0 ? -1 : 1;
+		static const long _gcd = RPNGcd<(N < 0 ? -N : N), (D < 0 ? -D : D)>::value;
+		
+	public:
+		static const long numerator = _sign * N / _gcd;
+		static const long denominator = _sign * D / _gcd;
+};
+
+// The operand stack, top first
+struct RPNEmpty
+{
+};
+
+template <long N, long D, typename Rest>
+struct RPNStack
+{
+};
+
+// Where evaluation stands: the stack, and whether the last character
+// ended a token (so the next one must be a blank)
+template <typename Stack, bool InToken>
+struct RPNState
+{
+};
+
+// a op b for fractions a = AN / AD and b = BN / BD
+template <long AN, long AD, long BN, long BD, char Op>
+struct RPNApply;
+
+template <long AN, long AD, long BN, long BD>
+struct RPNApply<AN, AD, BN, BD, '+'> : RPNFraction<AN * BD + BN * AD, AD * BD>
+{
+};
+
+template <long AN, long AD, long BN, long BD>
+struct RPNApply<AN, AD, BN, BD, '-'> : RPNFraction<AN * BD - BN * AD, AD * BD>
+{
+};
+
+template <long AN, long AD, long BN, long BD>
+struct RPNApply<AN, AD, BN, BD, '*'> : RPNFraction<AN * BN, AD * BD>
+{
+};
+
+// A zero divisor is reported here, and 1 stands in for it so the
+// fraction itself can still be formed
+template <long AN, long AD, long BN, long BD>
+struct RPNApply<AN, AD, BN, BD, '/'> : RPNError_DivisionByZero<BN == 0>,
+	RPNFraction<AN * BD, (BN == 0 ? 1 : AD * BN)>
+{
+};
+
+// What a character is
+enum RPNCharKind
+{
+	RPN_CHAR_END,
+	RPN_CHAR_BLANK,
+	RPN_CHAR_DIGIT,
+	RPN_CHAR_OPERATOR,
+	RPN_CHAR_BAD
+};
+
+template <char C>
+struct RPNKind
+{
+	static const RPNCharKind value = C == '\0' ? RPN_CHAR_END
+		: C == ' ' || C == '\t' ? RPN_CHAR_BLANK
+		: C >= '0' && C <= '9' ? RPN_CHAR_DIGIT
+		: C == '+' || C == '-' || C == '*' || C == '/' ? RPN_CHAR_OPERATOR
+		: RPN_CHAR_BAD;
+};
+
+// The state after one more character. Anything not matched by the
+// specializations below is a syntax error: a bad character, a token
+// right after another, or an operator with fewer than two operands
+template <typename State, char C, RPNCharKind Kind = RPNKind<C>::value>
+struct RPNStep : RPNError_Syntax<RPNFailsFor<State>::value>
+{
+};
+
+// The padding after the expression changes nothing
+template <typename State, char C>
+struct RPNStep<State, C, RPN_CHAR_END>
+{
+	typedef State type;
+};
+
+template <typename Stack, bool InToken, char C>
+struct RPNStep<RPNState<Stack, InToken>, C, RPN_CHAR_BLANK>
+{
+	typedef RPNState<Stack, false> type;
+};
+
+template <typename Stack, char C>
+struct RPNStep<RPNState<Stack, false>, C, RPN_CHAR_DIGIT>
+{
+	typedef RPNState<RPNStack<C - '0', 1, Stack>, true> type;
+};
+
+template <long BN, long BD, long AN, long AD, typename Rest, char C>
+struct RPNStep<RPNState<RPNStack<BN, BD, RPNStack<AN, AD, Rest> >, false>, C, RPN_CHAR_OPERATOR>
+{
+	private:
+		typedef RPNApply<AN, AD, BN, BD, C> _result;
+		
+	public:
+		typedef RPNState<RPNStack<_result::numerator, _result::denominator, Rest>, true> type;
+};
+
+// The value left once every character is read: exactly one operand
+template <typename State>
+struct RPNResult : RPNError_Syntax<RPNFailsFor<State>::value>
+{
+};
+
+template <long N, long D, bool InToken>
+struct RPNResult<RPNState<RPNStack<N, D, RPNEmpty>, InToken> >
+{
+	static const long numerator = N;
+	static const long denominator = D;
+};
+
+template <char C0, char C1 = 0, char C2 = 0, char C3 = 0, char C4 = 0, char C5 = 0, char C6 = 0, char C7 = 0,
+	char C8 = 0, char C9 = 0, char C10 = 0, char C11 = 0, char C12 = 0, char C13 = 0, char C14 = 0, char C15 = 0,
+	char C16 = 0, char C17 = 0, char C18 = 0, char C19 = 0, char C20 = 0, char C21 = 0, char C22 = 0, char C23 = 0,
+	char C24 = 0, char C25 = 0, char C26 = 0, char C27 = 0, char C28 = 0, char C29 = 0, char C30 = 0, char C31 = 0>
+class RPNConstant
+{
+	private:
+		typedef RPNState<RPNEmpty, false> _s0;
+		typedef typename RPNStep<_s0, C0>::type _s1;
+		typedef typename RPNStep<_s1, C1>::type _s2;
+		typedef typename RPNStep<_s2, C2>::type _s3;
+		typedef typename RPNStep<_s3, C3>::type _s4;
+		typedef typename RPNStep<_s4, C4>::type _s5;
+		typedef typename RPNStep<_s5, C5>::type _s6;
+		typedef typename RPNStep<_s6, C6>::type _s7;
+		typedef typename RPNStep<_s7, C7>::type _s8;
+		typedef typename RPNStep<_s8, C8>::type _s9;
+		typedef typename RPNStep<_s9, C9>::type _s10;
+		typedef typename RPNStep<_s10, C10>::type _s11;
+		typedef typename RPNStep<_s11, C11>::type _s12;
+		typedef typename RPNStep<_s12, C12>::type _s13;
+		typedef typename RPNStep<_s13, C13>::type _s14;
+		typedef typename RPNStep<_s14, C14>::type _s15;
+		typedef typename RPNStep<_s15, C15>::type _s16;
+		typedef typename RPNStep<_s16, C16>::type _s17;
+		typedef typename RPNStep<_s17, C17>::type _s18;
+		typedef typename RPNStep<_s18, C18>::type _s19;
+		typedef typename RPNStep<_s19, C19>::type _s20;
+		typedef typename RPNStep<_s20, C20>::type _s21;
+		typedef typename RPNStep<_s21, C21>::type _s22;
+		typedef typename RPNStep<_s22, C22>::type _s23;
+		typedef typename RPNStep<_s23, C23>::type _s24;
+		typedef typename RPNStep<_s24, C24>::type _s25;
+		typedef typename RPNStep<_s25, C25>::type _s26;
+		typedef typename RPNStep<_s26, C26>::type _s27;
+		typedef typename RPNStep<_s27, C27>::type _s28;
+		typedef typename RPNStep<_s28, C28>::type _s29;
+		typedef typename RPNStep<_s29, C29>::type _s30;
+		typedef typename RPNStep<_s30, C30>::type _s31;
+		typedef typename RPNStep<_s31, C31>::type _s32;
+		typedef RPNResult<_s32> _result;
+		
+	public:
+		static const long numerator = _result::numerator;
+		static const long denominator = _result::denominator;
+		static const bool integral = denominator == 1;
+		
+		// The result as RPN::calculate returns it; folded by the compiler
+		static float value(void)
+		{
+			return static_cast<float>(static_cast<double>(numerator) / denominator);
+		}
+};
+
+#endif
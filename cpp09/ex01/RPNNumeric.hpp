@@ -0,0 +1,317 @@
+#ifndef RPNNUMERIC_HPP
+#define RPNNUMERIC_HPP
+
+#include "RPN.hpp"
+#include <cstdio>
+#include <cmath>
+
+// Numeric modes for RPN::tryCalculate<Mode>. Each mode is a type with a
+// Value and three static functions:
+//   parse(digits, len, value)   a number token (digits only)
+//   apply(a, b, op, result)     one of + - * /
+//   format(value, buf)          text for main, into 64 bytes
+// so every mode is its own instantiation of the evaluator
+
+// Digits of the magnitude of v, sign first, at buf; returns the end
+inline char *formatInteger(long long v, char *buf)
+{
+	unsigned long long n = v < 0 ? 0ULL - static_cast<unsigned long long>(v) : static_cast<unsigned long long>(v);
+	char tmp[24];
+	char *p = tmp + sizeof(tmp);
+	do
+	{
+		*--p = static_cast<char>('0' + n % 10);
+		n /= 10;
+	} while (n);
+	if (v < 0)
+		*buf++ = '-';
+	while (p < tmp + sizeof(tmp))
+		*buf++ = *p++;
+	*buf = '\0';
+	return buf;
+}
+
+// The original mode: single precision, integers printed whole and
+// anything else with two decimals
+struct FloatMode
+{
+	typedef float Value;
+	
+	static RPN::Status parse(const char *digits, size_t len, Value &value)
+	{
+		double n = 0;
+		for (size_t i = 0; i < len; i++)
+			n = n * 10 + (digits[i] - '0');
+		value = static_cast<Value>(n);
+		return RPN::RPN_OK;
+	}
+	
+	static RPN::Status apply(Value a, Value b, char op, Value &result)
+	{
+		switch (op)
+		{
+			case '+':
+				result = a + b;
+				return RPN::RPN_OK;
+			case '-':
+				result = a - b;
+				return RPN::RPN_OK;
+			case '*':
+				result = a * b;
+				return RPN::RPN_OK;
+			case '/':
+				if (b == 0)
+					return RPN::RPN_DIVISION_BY_ZERO;
+				result = a / b;
+				return RPN::RPN_OK;
+			default:
+				return RPN::RPN_SYNTAX_ERROR;
+		}
+	}
+	
+	static void format(Value value, char *buf)
+	{
+		if (value == (int)value)
+			formatInteger((int)value, buf);
+		else
+			std::sprintf(buf, "%.2f", value);
+	}
+};
+
+// Double precision; integral results that fit a long long print whole
+struct DoubleMode
+{
+	typedef double Value;
+	
+	static RPN::Status parse(const char *digits, size_t len, Value &value)
+	{
+		// Up to 19 digits are exact in an integer, then rounded once
+		unsigned long long whole = 0;
+		size_t i = 0;
+		for (; i < len && i < 19; i++)
+			whole = whole * 10 + (digits[i] - '0');
+		value = static_cast<Value>(whole);
+		for (; i < len; i++)
+			value = value * 10 + (digits[i] - '0');
+		return RPN::RPN_OK;
+	}
+	
+	static RPN::Status apply(Value a, Value b, char op, Value &result)
+	{
+		switch (op)
+		{
+			case '+':
+				result = a + b;
+				return RPN::RPN_OK;
+			case '-':
+				result = a - b;
+				return RPN::RPN_OK;
+			case '*':
+				result = a * b;
+				return RPN::RPN_OK;
+			case '/':
+				if (b == 0)
+					return RPN::RPN_DIVISION_BY_ZERO;
+				result = a / b;
+				return RPN::RPN_OK;
+			default:
+				return RPN::RPN_SYNTAX_ERROR;
+		}
+	}
+	
+	static void format(Value value, char *buf)
+	{
+		if (std::fabs(value) < 9.2e18 && value == static_cast<Value>(static_cast<long long>(value)))
+			formatInteger(static_cast<long long>(value), buf);
+		else
+			std::sprintf(buf, "%.2f", value);
+	}
+};
+
+// Exact 64-bit integers: any result outside the long long range is an
+// overflow error, and division truncates toward zero
+struct Int64Mode
+{
+	typedef long long Value;
+	
+	static const long long MAX = 0x7fffffffffffffffLL;
+	static const long long MIN = -MAX - 1;
+	
+	static RPN::Status parse(const char *digits, size_t len, Value &value)
+	{
+		value = 0;
+		for (size_t i = 0; i < len; i++)
+		{
+			int d = digits[i] - '0';
+			if (value > (MAX - d) / 10)
+				return RPN::RPN_OVERFLOW;
+			value = value * 10 + d;
+		}
+		return RPN::RPN_OK;
+	}
+	
+	static RPN::Status apply(Value a, Value b, char op, Value &result)
+	{
+		switch (op)
+		{
+			case '+':
+				if ((b > 0 && a > MAX - b) || (b < 0 && a < MIN - b))
+					return RPN::RPN_OVERFLOW;
+				result = a + b;
+				return RPN::RPN_OK;
+			case '-':
+				if ((b < 0 && a > MAX + b) || (b > 0 && a < MIN + b))
+					return RPN::RPN_OVERFLOW;
+				result = a - b;
+				return RPN::RPN_OK;
+			case '*':
+				return multiply(a, b, result);
+			case '/':
+				if (b == 0)
+					return RPN::RPN_DIVISION_BY_ZERO;
+				if (a == MIN && b == -1)
+					return RPN::RPN_OVERFLOW;
+				result = a / b;
+				return RPN::RPN_OK;
+			default:
+				return RPN::RPN_SYNTAX_ERROR;
+		}
+	}
+	
+	static RPN::Status multiply(Value a, Value b, Value &result)
+	{
+		if (a != 0 && b != 0)
+		{
+			if (a > 0 ? (b > 0 ? a > MAX / b : b < MIN / a)
+			          : (b > 0 ? a < MIN / b : b < MAX / a))
+				return RPN::RPN_OVERFLOW;
+		}
+		result = a * b;
+		return RPN::RPN_OK;
+	}
+	
+	static void format(Value value, char *buf)
+	{
+		formatInteger(value, buf);
+	}
+};
+
+// Decimal fixed point: long long counts of 1/SCALE, exact for + and -,
+// truncated toward zero at the last digit for * and /, errors on overflow.
+// Prints up to four decimals, trailing zeros removed
+struct FixedMode
+{
+	typedef long long Value;
+	
+	static const long long SCALE = 10000;
+	
+	static RPN::Status parse(const char *digits, size_t len, Value &value)
+	{
+		Value whole;
+		RPN::Status status = Int64Mode::parse(digits, len, whole);
+		if (status != RPN::RPN_OK)
+			return status;
+		return Int64Mode::multiply(whole, SCALE, value);
+	}
+	
+	// |a| * |b| as a 128-bit hi:lo pair, from 32-bit halves
+	static void multiply128(unsigned long long a, unsigned long long b,
+		unsigned long long &hi, unsigned long long &lo)
+	{
+		unsigned long long aLo = a & 0xffffffffULL;
+		unsigned long long aHi = a >> 32;
+		unsigned long long bLo = b & 0xffffffffULL;
+		unsigned long long bHi = b >> 32;
+		unsigned long long ll = aLo * bLo;
+		unsigned long long lh = aLo * bHi;
+		unsigned long long hl = aHi * bLo;
+		unsigned long long mid = (ll >> 32) + (lh & 0xffffffffULL) + (hl & 0xffffffffULL);
+		lo = (ll & 0xffffffffULL) | (mid << 32);
+		hi = aHi * bHi + (lh >> 32) + (hl >> 32) + (mid >> 32);
+	}
+	
+	// hi:lo / d bit by bit; false when the quotient needs more than 64 bits.
+	// d is at most 2^63, so the remainder always fits after a shift
+	static bool divide128(unsigned long long hi, unsigned long long lo, unsigned long long d,
+		unsigned long long &quotient)
+	{
+		if (hi >= d)
+			return false;
+		unsigned long long rem = hi;
+		quotient = 0;
+		for (int bit = 63; bit >= 0; bit--)
+		{
+			rem = (rem << 1) | ((lo >> bit) & 1);
+			quotient <<= 1;
+			if (rem >= d)
+			{
+				rem -= d;
+				quotient |= 1;
+			}
+		}
+		return true;
+	}
+	
+	static unsigned long long magnitude(Value v)
+	{
+		return v < 0 ? 0ULL - static_cast<unsigned long long>(v) : static_cast<unsigned long long>(v);
+	}
+	
+	// sign * q as a Value, or overflow
+	static RPN::Status signedResult(bool negative, unsigned long long q, Value &result)
+	{
+		unsigned long long limit = negative ? 0x8000000000000000ULL : 0x7fffffffffffffffULL;
+		if (q > limit)
+			return RPN::RPN_OVERFLOW;
+		result = negative ? static_cast<Value>(0ULL - q) : static_cast<Value>(q);
+		return RPN::RPN_OK;
+	}
+	
+	static RPN::Status apply(Value a, Value b, char op, Value &result)
+	{
+		unsigned long long hi;
+		unsigned long long lo;
+		unsigned long long q;
+		bool negative = (a < 0) != (b < 0);
+		switch (op)
+		{
+			case '+':
+			case '-':
+				return Int64Mode::apply(a, b, op, result);
+			case '*':
+				multiply128(magnitude(a), magnitude(b), hi, lo);
+				if (!divide128(hi, lo, SCALE, q))
+					return RPN::RPN_OVERFLOW;
+				return signedResult(negative, q, result);
+			case '/':
+				if (b == 0)
+					return RPN::RPN_DIVISION_BY_ZERO;
+				multiply128(magnitude(a), SCALE, hi, lo);
+				if (!divide128(hi, lo, magnitude(b), q))
+					return RPN::RPN_OVERFLOW;
+				return signedResult(negative, q, result);
+			default:
+				return RPN::RPN_SYNTAX_ERROR;
+		}
+	}
+	
+	static void format(Value value, char *buf)
+	{
+		unsigned long long n = magnitude(value);
+		if (value < 0)
+			*buf++ = '-';
+		buf = formatInteger(static_cast<long long>(n / SCALE), buf);
+		unsigned long long frac = n % SCALE;
+		if (frac == 0)
+			return;
+		*buf++ = '.';
+		for (long long unit = SCALE / 10; unit > 0 && frac > 0; unit /= 10)
+		{
+			*buf++ = static_cast<char>('0' + frac / unit);
+			frac %= unit;
+		}
+		*buf = '\0';
+	}
+};
+
+#endif
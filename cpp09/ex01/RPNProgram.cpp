@@ -0,0 +1,214 @@
+#include "RPNProgram.hpp"
+
+RPNProgram::RPNProgram(void) : _maxDepth(0)
+{
+}
+
+RPNProgram::RPNProgram(const RPNProgram &other)
+	: _code(other._code), _variables(other._variables), _maxDepth(other._maxDepth)
+{
+}
+
+RPNProgram &RPNProgram::operator=(const RPNProgram &other)
+{
+	if (this != &other)
+	{
+		_code = other._code;
+		_variables = other._variables;
+		_maxDepth = other._maxDepth;
+	}
+	return *this;
+}
+
+RPNProgram::~RPNProgram(void)
+{
+}
+
+void RPNProgram::clear(void)
+{
+	_code.clear();
+	_variables.clear();
+	_maxDepth = 0;
+}
+
+void RPNProgram::emitConstant(float value)
+{
+	Instruction in;
+	in.op = OP_CONST;
+	in.var = 0;
+	in.value = value;
+	_code.push_back(in);
+}
+
+void RPNProgram::emitVariable(const char *name, size_t len)
+{
+	Instruction in;
+	in.op = OP_VAR;
+	in.value = 0;
+	
+	// Variables are few, so a linear search is enough
+	size_t index = 0;
+	while (index < _variables.size() && _variables[index].compare(0, std::string::npos, name, len) != 0)
+		index++;
+	if (index == _variables.size())
+		_variables.push_back(std::string(name, len));
+	in.var = static_cast<unsigned int>(index);
+	_code.push_back(in);
+}
+
+void RPNProgram::emitOperator(char op)
+{
+	Instruction in;
+	in.var = 0;
+	in.value = 0;
+	switch (op)
+	{
+		case '+':
+			in.op = OP_ADD;
+			break;
+		case '-':
+			in.op = OP_SUB;
+			break;
+		case '*':
+			in.op = OP_MUL;
+			break;
+		default:
+			in.op = OP_DIV;
+			break;
+	}
+	_code.push_back(in);
+}
+
+void RPNProgram::setMaxDepth(size_t depth)
+{
+	_maxDepth = depth;
+}
+
+size_t RPNProgram::size(void) const
+{
+	return _code.size();
+}
+
+const RPNProgram::Instruction &RPNProgram::operator[](size_t i) const
+{
+	return _code[i];
+}
+
+size_t RPNProgram::maxDepth(void) const
+{
+	return _maxDepth;
+}
+
+size_t RPNProgram::variableCount(void) const
+{
+	return _variables.size();
+}
+
+const std::string &RPNProgram::variableName(size_t index) const
+{
+	return _variables[index];
+}
+
+long RPNProgram::variableIndex(const std::string &name) const
+{
+	for (size_t i = 0; i < _variables.size(); i++)
+	{
+		if (_variables[i] == name)
+			return static_cast<long>(i);
+	}
+	return -1;
+}
+
+// Value of a constant operator application, as evaluation would compute it
+static float fold(unsigned char op, float a, float b)
+{
+	switch (op)
+	{
+		case RPNProgram::OP_ADD:
+			return a + b;
+		case RPNProgram::OP_SUB:
+			return a - b;
+		case RPNProgram::OP_MUL:
+			return a * b;
+		default:
+			return a / b;
+	}
+}
+
+// Whether "x c op" gives x for the constant right operand c
+static bool rightIdentity(unsigned char op, float c)
+{
+	return ((op == RPNProgram::OP_ADD || op == RPNProgram::OP_SUB) && c == 0)
+		|| ((op == RPNProgram::OP_MUL || op == RPNProgram::OP_DIV) && c == 1);
+}
+
+// Whether "c x op" gives x for the constant left operand c
+static bool leftIdentity(unsigned char op, float c)
+{
+	return (op == RPNProgram::OP_ADD && c == 0) || (op == RPNProgram::OP_MUL && c == 1);
+}
+
+bool RPNProgram::optimize(void)
+{
+	// Where each stack entry's code starts in the output, and whether it is
+	// a single constant
+	std::vector<size_t> starts;
+	std::vector<bool> constant;
+	std::vector<Instruction> out;
+	out.reserve(_code.size());
+	
+	for (size_t i = 0; i < _code.size(); i++)
+	{
+		const Instruction &in = _code[i];
+		if (in.op == OP_CONST || in.op == OP_VAR)
+		{
+			starts.push_back(out.size());
+			constant.push_back(in.op == OP_CONST);
+			out.push_back(in);
+			continue;
+		}
+		
+		size_t bStart = starts.back();
+		bool bConst = constant.back();
+		starts.pop_back();
+		constant.pop_back();
+		size_t aStart = starts.back();
+		bool aConst = constant.back();
+		
+		if (bConst && in.op == OP_DIV && out[bStart].value == 0)
+			return false;
+		if (aConst && bConst)
+		{
+			out[aStart].value = fold(in.op, out[aStart].value, out[bStart].value);
+			out.pop_back();
+		}
+		else if (bConst && rightIdentity(in.op, out[bStart].value))
+			out.pop_back();
+		else if (aConst && leftIdentity(in.op, out[aStart].value))
+		{
+			out.erase(out.begin() + aStart);
+			constant.back() = false;
+		}
+		else
+		{
+			out.push_back(in);
+			constant.back() = false;
+		}
+	}
+	_code.swap(out);
+	
+	// Folding only lowers the stack, so its depth is worked out again
+	size_t depth = 0;
+	_maxDepth = 0;
+	for (size_t i = 0; i < _code.size(); i++)
+	{
+		if (_code[i].op == OP_CONST || _code[i].op == OP_VAR)
+		{
+			if (++depth > _maxDepth)
+				_maxDepth = depth;
+		}
+		else
+			depth--;
+	}
+	return true;
+}
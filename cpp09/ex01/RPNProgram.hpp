@@ -0,0 +1,75 @@
+#ifndef RPNPROGRAM_HPP
+#define RPNPROGRAM_HPP
+
+#include <string>
+#include <vector>
+
+// A compiled RPN expression: a flat instruction array run by RPN::evaluate
+// without any parsing. Named operands are numbered in order of first use,
+// and evaluation takes their values by that number
+class RPNProgram
+{
+	public:
+		enum Opcode
+		{
+			OP_CONST,
+			OP_VAR,
+			OP_ADD,
+			OP_SUB,
+			OP_MUL,
+			OP_DIV
+		};
+		
+		// Constants carry their value, variables their number
+		struct Instruction
+		{
+			unsigned char op;
+			unsigned int var;
+			float value;
+		};
+	
+	private:
+		std::vector<Instruction> _code;
+		std::vector<std::string> _variables;
+		size_t _maxDepth;
+	
+	public:
+		// Constructor
+		RPNProgram(void);
+		
+		// Copy constructor
+		RPNProgram(const RPNProgram &other);
+		
+		// Assignment operator
+		RPNProgram &operator=(const RPNProgram &other);
+		
+		// Destructor
+		~RPNProgram(void);
+		
+		// Building (see RPN::compile)
+		void clear(void);
+		void emitConstant(float value);
+		void emitVariable(const char *name, size_t len);
+		void emitOperator(char op);
+		void setMaxDepth(size_t depth);
+		
+		size_t size(void) const;
+		const Instruction &operator[](size_t i) const;
+		
+		// Deepest the operand stack goes while the program runs
+		size_t maxDepth(void) const;
+		
+		size_t variableCount(void) const;
+		const std::string &variableName(size_t index) const;
+		
+		// Number of the named variable, or -1 when the program does not use it
+		long variableIndex(const std::string &name) const;
+		
+		// Fold operators on constants ("3 4 *" becomes 12) and drop identities
+		// (x 1 *, 1 x *, x 1 /, x 0 +, 0 x +, x 0 -); results are those of the
+		// unoptimized program. False, with the program unchanged, when a
+		// division by a constant zero means it can never succeed
+		bool optimize(void);
+};
+
+#endif
@@ -0,0 +1,400 @@
+#include "RPN.hpp"
+#include "RPNNumeric.hpp"
+#include "RPNConstant.hpp"
+#include <stack>
+#include <sstream>
+#include <fstream>
+#include <iomanip>
+#include <cstdlib>
+#include <cstring>
+#include <stdexcept>
+#include <time.h>
+
+// Benchmark harness for RPN: generates random valid and invalid
+// expressions, times every evaluator over them and reports expressions
+// per second and ns per token. With a baseline file the run fails when
+// any row is slower than the baseline by more than the threshold
+
+static unsigned int g_seed = 42;
+
+static unsigned int nextRandom(void)
+{
+	g_seed = g_seed * 1103515245u + 12345u;
+	return (g_seed >> 8) & 0xffffff;
+}
+
+// Monotonic wall clock in nanoseconds
+static double nowNs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+// The evaluator as it was first written, kept as the reference row:
+// std::stack, istringstream tokens, atof, exceptions on division by zero
+static bool legacyCalculate(const std::string &expression, float &result)
+{
+	std::stack<float> stack;
+	std::istringstream iss(expression);
+	std::string token;
+	while (iss >> token)
+	{
+		bool number = !token.empty();
+		for (size_t i = 0; i < token.size() && number; i++)
+			number = token[i] >= '0' && token[i] <= '9';
+		if (number)
+			stack.push(std::atof(token.c_str()));
+		else if (token == "+" || token == "-" || token == "*" || token == "/")
+		{
+			if (stack.size() < 2)
+				return false;
+			float b = stack.top();
+			stack.pop();
+			float a = stack.top();
+			stack.pop();
+			try
+			{
+				if (token[0] == '/' && b == 0)
+					throw std::runtime_error("Division by zero");
+				stack.push(token[0] == '+' ? a + b : token[0] == '-' ? a - b : token[0] == '*' ? a * b : a / b);
+			}
+			catch (const std::exception &e)
+			{
+				return false;
+			}
+		}
+		else
+			return false;
+	}
+	if (stack.size() != 1)
+		return false;
+	result = stack.top();
+	return true;
+}
+
+// About length tokens: single digits (or names from vars) and operators
+// from ops, kept valid by tracking the depth; invalid expressions get one
+// token replaced by a bad one
+static std::string generate(size_t length, const std::string &ops, bool invalid, const char *vars)
+{
+	std::string out;
+	size_t depth = 0;
+	size_t tokens = 0;
+	while (tokens < length || depth > 1)
+	{
+		if (!out.empty())
+			out += ' ';
+		if (depth >= 2 && (tokens >= length || nextRandom() % 100 < 45))
+		{
+			out += ops[nextRandom() % ops.size()];
+			depth--;
+		}
+		else
+		{
+			if (vars && nextRandom() % 2)
+				out += vars[nextRandom() % std::strlen(vars)];
+			else
+				out += static_cast<char>('0' + nextRandom() % 10);
+			depth++;
+		}
+		tokens++;
+	}
+	if (invalid)
+		out[(nextRandom() % (out.size() / 2 + 1)) * 2] = "x(."[nextRandom() % 3];
+	return out;
+}
+
+static size_t countTokens(const std::vector<std::string> &exprs)
+{
+	size_t n = 0;
+	for (size_t i = 0; i < exprs.size(); i++)
+		n += exprs[i].size() / 2 + 1;
+	return n;
+}
+
+struct Row
+{
+	std::string label;
+	double nsPerToken;
+};
+
+static std::vector<Row> g_rows;
+
+// Results are summed here so no evaluation can be skipped
+static volatile unsigned long g_sink = 0;
+
+static void report(const std::string &label, double ns, size_t items, size_t tokens, const char *unit)
+{
+	Row row;
+	row.label = label;
+	row.nsPerToken = ns / tokens;
+	g_rows.push_back(row);
+	std::cout << std::left << std::setw(26) << label << std::right << std::fixed
+	          << std::setprecision(0) << std::setw(14) << items / (ns / 1e9) << " " << unit << "/s"
+	          << std::setprecision(2) << std::setw(10) << row.nsPerToken << " ns/token" << std::endl;
+}
+
+// Best of trials runs of one evaluator over every expression
+template <typename Eval>
+static double timeBest(Eval eval, const std::vector<std::string> &exprs, size_t trials)
+{
+	double best = 0;
+	for (size_t t = 0; t < trials; t++)
+	{
+		double start = nowNs();
+		unsigned long ok = 0;
+		for (size_t i = 0; i < exprs.size(); i++)
+			ok += eval(exprs[i]);
+		double ns = nowNs() - start;
+		if (t == 0 || ns < best)
+			best = ns;
+		g_sink += ok;
+	}
+	return best;
+}
+
+static RPN g_rpn;
+
+static bool runLegacy(const std::string &e)
+{
+	float r;
+	return legacyCalculate(e, r);
+}
+
+static bool runFloat(const std::string &e)
+{
+	float r;
+	return g_rpn.tryCalculate(e, r) == RPN::RPN_OK;
+}
+
+// Sized for every expression, so after the first trial all of them hit
+static RPN g_cached;
+
+static bool runCached(const std::string &e)
+{
+	float r;
+	return g_cached.tryCalculate(e, r) == RPN::RPN_OK;
+}
+
+template <typename Mode>
+static bool runMode(const std::string &e)
+{
+	typename Mode::Value r;
+	return g_rpn.tryCalculate<Mode>(e.data(), e.data() + e.size(), r) == RPN::RPN_OK;
+}
+
+// Rows are kept as "label ns_per_token" lines
+static void saveBaseline(const std::string &filename)
+{
+	std::ofstream out(filename.c_str());
+	for (size_t i = 0; i < g_rows.size(); i++)
+		out << g_rows[i].label << '\t' << g_rows[i].nsPerToken << '\n';
+}
+
+static int checkBaseline(std::ifstream &in, double threshold)
+{
+	int regressions = 0;
+	std::string line;
+	while (std::getline(in, line))
+	{
+		size_t tab = line.find('\t');
+		if (tab == std::string::npos)
+			continue;
+		std::string label = line.substr(0, tab);
+		double before = std::strtod(line.c_str() + tab + 1, NULL);
+		for (size_t i = 0; i < g_rows.size(); i++)
+		{
+			if (g_rows[i].label != label || before <= 0)
+				continue;
+			double change = (g_rows[i].nsPerToken / before - 1) * 100;
+			if (change > threshold)
+			{
+				std::cout << "REGRESSION " << label << ": " << std::setprecision(1) << change
+				          << "% slower than baseline" << std::endl;
+				regressions++;
+			}
+		}
+	}
+	return regressions;
+}
+
+int main(int argc, char **argv)
+{
+	size_t count = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 20000;
+	size_t length = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 15;
+	std::string ops = argc > 3 ? argv[3] : "+-*/";
+	size_t invalidPercent = argc > 4 ? std::strtoul(argv[4], NULL, 10) : 10;
+	std::string baseline = argc > 5 ? argv[5] : "";
+	double threshold = argc > 6 ? std::strtod(argv[6], NULL) : 20;
+	if (count == 0 || length == 0 || ops.empty() || ops.find_first_not_of("+-*/") != std::string::npos
+		|| invalidPercent > 100)
+	{
+		std::cerr << "Usage: " << argv[0] << " [expressions] [tokens] [operators] [invalid%] [baseline [threshold%]]"
+		          << std::endl << "A missing baseline file is written; an existing one is checked" << std::endl;
+		return 1;
+	}
+	
+	std::vector<std::string> exprs;
+	for (size_t i = 0; i < count; i++)
+		exprs.push_back(generate(length, ops, nextRandom() % 100 < invalidPercent, NULL));
+	size_t tokens = countTokens(exprs);
+	std::cout << count << " expressions, " << tokens << " tokens, operators \"" << ops << "\", "
+	          << invalidPercent << "% invalid; best of 5" << std::endl;
+	
+	std::cout << "-- text" << std::endl;
+	report("legacy std::stack", timeBest(runLegacy, exprs, 5), count, tokens, "expr");
+	report("tryCalculate float", timeBest(runFloat, exprs, 5), count, tokens, "expr");
+	report("tryCalculate double", timeBest(runMode<DoubleMode>, exprs, 5), count, tokens, "expr");
+	report("tryCalculate int64", timeBest(runMode<Int64Mode>, exprs, 5), count, tokens, "expr");
+	report("tryCalculate fixed", timeBest(runMode<FixedMode>, exprs, 5), count, tokens, "expr");
+	g_cached.setCacheCapacity(count);
+	report("tryCalculate cached", timeBest(runCached, exprs, 5), count, tokens, "expr");
+	std::cout << "  cache hit rate " << std::setprecision(1) << g_cached.cache().hitRate() * 100 << "%" << std::endl;
+	
+	// One expression known at build time, parsed on every call against
+	// the folded constant
+	std::cout << "-- constant" << std::endl;
+	{
+		typedef RPNConstant<'8', ' ', '9', ' ', '*', ' ', '9', ' ', '-', ' ', '9', ' ', '-', ' ', '9', ' ', '-',
+			' ', '4', ' ', '-', ' ', '1', ' ', '+'> Subject;
+		const std::string text = "8 9 * 9 - 9 - 9 - 4 - 1 +";
+		size_t constantTokens = count * (text.size() / 2 + 1);
+		for (int pass = 0; pass < 2; pass++)
+		{
+			double best = 0;
+			for (size_t t = 0; t < 5; t++)
+			{
+				double start = nowNs();
+				float r = 0;
+				for (size_t i = 0; i < count; i++)
+				{
+					if (pass == 0)
+						g_rpn.tryCalculate(text, r);
+					else
+						r = Subject::value();
+					g_sink += static_cast<unsigned long>(r);
+				}
+				double ns = nowNs() - start;
+				if (t == 0 || ns < best)
+					best = ns;
+			}
+			report(pass == 0 ? "tryCalculate literal" : "RPNConstant", best, count, constantTokens, "expr");
+		}
+	}
+	
+	// Compiled once, then evaluated; invalid expressions do not compile
+	std::cout << "-- compiled" << std::endl;
+	{
+		std::ofstream sink("/dev/null");
+		std::streambuf *saved = std::cerr.rdbuf(sink.rdbuf());
+		std::vector<RPNProgram> programs;
+		std::vector<RPNProgram> optimized;
+		size_t programTokens = 0;
+		size_t optimizedTokens = 0;
+		for (size_t i = 0; i < exprs.size(); i++)
+		{
+			// A bad token "x" compiles as a variable; those are left out
+			RPNProgram p;
+			if (!g_rpn.compile(exprs[i], p) || p.variableCount() > 0)
+				continue;
+			programs.push_back(p);
+			programTokens += p.size();
+			size_t before = p.size();
+			if (p.optimize())
+			{
+				optimized.push_back(p);
+				optimizedTokens += before;
+			}
+		}
+		std::cerr.rdbuf(saved);
+		
+		// Both rows count the tokens of the source, so the optimized one
+		// shows what folding saves
+		for (int pass = 0; pass < 2; pass++)
+		{
+			const std::vector<RPNProgram> &set = pass == 0 ? programs : optimized;
+			double best = 0;
+			for (size_t t = 0; t < 5; t++)
+			{
+				double start = nowNs();
+				unsigned long ok = 0;
+				float r;
+				for (size_t i = 0; i < set.size(); i++)
+					ok += g_rpn.evaluate(set[i], static_cast<const float *>(NULL), r);
+				double ns = nowNs() - start;
+				if (t == 0 || ns < best)
+					best = ns;
+				g_sink += ok;
+			}
+			report(pass == 0 ? "evaluate" : "evaluate optimized", best, set.size(),
+				pass == 0 ? programTokens : optimizedTokens, "expr");
+		}
+	}
+	
+	// One program with variables over columns, against a row loop
+	std::cout << "-- columns" << std::endl;
+	{
+		RPNProgram program;
+		g_rpn.compile(generate(length, ops, false, "abc"), program);
+		size_t rows = count * 10;
+		std::vector<std::vector<float> > columns(program.variableCount(), std::vector<float>(rows));
+		std::vector<const float *> pointers;
+		for (size_t v = 0; v < columns.size(); v++)
+		{
+			for (size_t r = 0; r < rows; r++)
+				columns[v][r] = static_cast<float>(nextRandom() % 10);
+			pointers.push_back(&columns[v][0]);
+		}
+		std::vector<float> results(rows);
+		std::vector<unsigned char> errors(rows);
+		std::vector<float> bindings(columns.size());
+		
+		double best = 0;
+		for (size_t t = 0; t < 5; t++)
+		{
+			double start = nowNs();
+			float r;
+			for (size_t row = 0; row < rows; row++)
+			{
+				for (size_t v = 0; v < columns.size(); v++)
+					bindings[v] = columns[v][row];
+				g_sink += g_rpn.evaluate(program, bindings.empty() ? NULL : &bindings[0], r);
+			}
+			double ns = nowNs() - start;
+			if (t == 0 || ns < best)
+				best = ns;
+		}
+		report("evaluate per row", best, rows, rows * program.size(), "row");
+		
+		double bestBatch = 0;
+		for (size_t t = 0; t < 5; t++)
+		{
+			double start = nowNs();
+			g_sink += g_rpn.evaluateBatch(program, pointers.empty() ? NULL : &pointers[0], rows,
+				&results[0], &errors[0]);
+			double ns = nowNs() - start;
+			if (t == 0 || ns < bestBatch)
+				bestBatch = ns;
+		}
+		report("evaluateBatch", bestBatch, rows, rows * program.size(), "row");
+	}
+	
+	if (baseline.empty())
+		return 0;
+	std::ifstream in(baseline.c_str());
+	if (!in.is_open())
+	{
+		saveBaseline(baseline);
+		std::cout << "Baseline written to " << baseline << std::endl;
+		return 0;
+	}
+	int regressions = checkBaseline(in, threshold);
+	if (regressions > 0)
+	{
+		std::cout << regressions << " row(s) regressed by more than " << threshold << "%" << std::endl;
+		return 1;
+	}
+	std::cout << "No row regressed by more than " << threshold << "%" << std::endl;
+	return 0;
+}
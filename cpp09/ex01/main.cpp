@@ -1,8 +1,177 @@
 #include "RPN.hpp"
-#include <iomanip>
+#include "RPNNumeric.hpp"
+#include "ThreadPool.hpp"
+#include <fstream>
+#include <cstring>
+#include <cstdlib>
 
-int main(int argc, char **argv)
+static const size_t BLOCK_SIZE = 64 * 1024;
+
+// Evaluate the lines of [begin, end), the last one possibly unterminated,
+// appending one output line each; true if any failed
+template <typename Mode>
+static bool evaluateLines(RPN &rpn, const char *begin, const char *end, std::string &out)
+{
+	bool failed = false;
+	const char *p = begin;
+	while (p < end)
+	{
+		const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+		const char *lineEnd = nl ? nl : end;
+		typename Mode::Value result;
+		if (rpn.tryCalculate<Mode>(p, lineEnd, result) == RPN::RPN_OK)
+		{
+			char text[64];
+			Mode::format(result, text);
+			out += text;
+			out += '\n';
+		}
+		else
+		{
+			out += "Error\n";
+			failed = true;
+		}
+		p = nl ? nl + 1 : end;
+	}
+	return failed;
+}
+
+// Newline-aligned piece of a block, with the evaluator that runs it
+struct Shard
+{
+	const char *begin;
+	const char *end;
+	std::string out;
+	bool failed;
+};
+
+// Body of the parallel loop over the shards; shard i uses evaluator i
+template <typename Mode>
+struct ShardJob
+{
+	std::vector<Shard> *shards;
+	std::vector<RPN> *evaluators;
+	
+	void operator()(size_t first, size_t last) const
+	{
+		for (size_t i = first; i < last; i++)
+		{
+			Shard &shard = (*shards)[i];
+			shard.out.clear();
+			shard.failed = evaluateLines<Mode>((*evaluators)[i], shard.begin, shard.end, shard.out);
+		}
+	}
+};
+
+// One expression per line, one output line each ("Error" for a bad one),
+// output written a block at a time. With threads > 1 the lines of each
+// block are cut into that many shards, evaluated on the shared ThreadPool
+// by one RPN each and written back in input order
+template <typename Mode>
+static int batch(std::istream &in, size_t threads)
+{
+	std::vector<RPN> evaluators(threads);
+	std::vector<Shard> shards(threads);
+	ShardJob<Mode> job;
+	job.shards = &shards;
+	job.evaluators = &evaluators;
+	
+	std::streambuf *sb = in.rdbuf();
+	std::vector<char> buffer(BLOCK_SIZE * threads);
+	size_t kept = 0;
+	bool failed = false;
+	
+	for (;;)
+	{
+		if (kept == buffer.size())
+			buffer.resize(buffer.size() * 2);
+		std::streamsize got = sb->sgetn(&buffer[kept], buffer.size() - kept);
+		size_t filled = kept + (got > 0 ? static_cast<size_t>(got) : 0);
+		bool last = got <= 0;
+		
+		// Every complete line; at the end also the unterminated rest
+		const char *p = &buffer[0];
+		const char *end = p + filled;
+		const char *stop = end;
+		if (!last)
+		{
+			while (stop > p && stop[-1] != '\n')
+				stop--;
+		}
+		
+		// Shards of about equal size, each ending after a newline
+		size_t step = (stop - p) / threads + 1;
+		const char *from = p;
+		for (size_t i = 0; i < threads; i++)
+		{
+			const char *cut = stop;
+			if (i + 1 < threads && static_cast<size_t>(stop - from) > step)
+			{
+				const char *nl = static_cast<const char *>(std::memchr(from + step, '\n', stop - from - step));
+				cut = nl ? nl + 1 : stop;
+			}
+			shards[i].begin = from;
+			shards[i].end = cut;
+			from = cut;
+		}
+		if (threads == 1)
+			job(0, 1);
+		else
+			ThreadPool::shared().parallelFor(0, threads, 1, job);
+		for (size_t i = 0; i < threads; i++)
+		{
+			std::cout.write(shards[i].out.data(), shards[i].out.size());
+			failed = failed || shards[i].failed;
+		}
+		
+		if (last)
+			break;
+		kept = end - stop;
+		std::memmove(&buffer[0], stop, kept);
+	}
+	std::cout.flush();
+	return failed ? 1 : 0;
+}
+
+// Evaluate argv[1] or a batch (from standard input with "-", from a file
+// with "-f file") in one numeric mode; "-j N" before a batch runs it on N
+// shards at a time
+template <typename Mode>
+static int run(int argc, char **argv)
 {
+	size_t threads = 1;
+	if (argc > 3 && std::strcmp(argv[1], "-j") == 0)
+	{
+		char *end;
+		long n = std::strtol(argv[2], &end, 10);
+		if (*end != '\0' || n < 1 || n > 256)
+		{
+			std::cerr << "Error" << std::endl;
+			return 1;
+		}
+		threads = static_cast<size_t>(n);
+		argc -= 2;
+		argv += 2;
+		if (std::strcmp(argv[1], "-") != 0 && std::strcmp(argv[1], "-f") != 0)
+		{
+			std::cerr << "Error" << std::endl;
+			return 1;
+		}
+	}
+	
+	if (argc == 2 && std::strcmp(argv[1], "-") == 0)
+		return batch<Mode>(std::cin, threads);
+	if (argc == 3 && std::strcmp(argv[1], "-f") == 0)
+	{
+		std::ifstream file(argv[2], std::ios::in | std::ios::binary);
+		if (!file.is_open())
+		{
+			std::cerr << "Error" << std::endl;
+			return 1;
+		}
+		return batch<Mode>(file, threads);
+	}
+	
 	if (argc != 2)
 	{
 		std::cerr << "Error" << std::endl;
@@ -10,17 +179,30 @@ int main(int argc, char **argv)
 	}
 	
 	RPN rpn;
-	float result;
-	
-	if (rpn.calculate(argv[1], result))
+	typename Mode::Value result;
+	if (rpn.tryCalculate<Mode>(argv[1], argv[1] + std::strlen(argv[1]), result) != RPN::RPN_OK)
 	{
-		// Check if result is integer or float
-		if (result == (int)result)
-			std::cout << (int)result << std::endl;
-		else
-			std::cout << std::fixed << std::setprecision(2) << result << std::endl;
-		return 0;
+		std::cerr << "Error" << std::endl;
+		return 1;
 	}
 	
-	return 1;
+	// Integers print whole; otherwise as the mode formats them
+	char text[64];
+	Mode::format(result, text);
+	std::cout << text << std::endl;
+	return 0;
+}
+
+int main(int argc, char **argv)
+{
+	PROFILE_PROGRAM();
+	
+	// An optional numeric mode comes first; float is the default
+	if (argc > 2 && std::strcmp(argv[1], "-int") == 0)
+		return run<Int64Mode>(argc - 1, argv + 1);
+	if (argc > 2 && std::strcmp(argv[1], "-double") == 0)
+		return run<DoubleMode>(argc - 1, argv + 1);
+	if (argc > 2 && std::strcmp(argv[1], "-fixed") == 0)
+		return run<FixedMode>(argc - 1, argv + 1);
+	return run<FloatMode>(argc, argv);
 }
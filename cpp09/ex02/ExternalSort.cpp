@@ -0,0 +1,220 @@
+#include "ExternalSort.hpp"
+#include "PmergeMe.hpp"
+#include <fstream>
+#include <sstream>
+#include <queue>
+#include <cstdio>
+
+ExternalSort::ExternalSort(size_t chunkElements, const std::string &runPrefix)
+	: _chunkElements(chunkElements ? chunkElements : 1), _shardSize(4096), _runPrefix(runPrefix)
+{
+}
+
+ExternalSort::ExternalSort(const ExternalSort &other) : _chunkElements(other._chunkElements),
+	_shardSize(other._shardSize), _runPrefix(other._runPrefix)
+{
+}
+
+ExternalSort &ExternalSort::operator=(const ExternalSort &other)
+{
+	if (this != &other)
+	{
+		_chunkElements = other._chunkElements;
+		_shardSize = other._shardSize;
+		_runPrefix = other._runPrefix;
+	}
+	return *this;
+}
+
+ExternalSort::~ExternalSort(void)
+{
+	_removeRuns();
+}
+
+void ExternalSort::setShardSize(size_t shardSize)
+{
+	_shardSize = shardSize;
+}
+
+size_t ExternalSort::runCount(void) const
+{
+	return _runs.size();
+}
+
+// Sort one chunk and write it as a run of native-order ints
+bool ExternalSort::_spill(std::vector<int> &chunk)
+{
+	if (chunk.empty())
+		return true;
+	
+	PmergeMe pm;
+	pm.setShardSize(_shardSize);
+	pm.sortVector(chunk);
+	
+	std::ostringstream name;
+	name << _runPrefix << _runs.size();
+	std::ofstream run(name.str().c_str(), std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!run.is_open())
+		return false;
+	_runs.push_back(name.str());
+	run.write(reinterpret_cast<const char *>(&chunk[0]), chunk.size() * sizeof(int));
+	chunk.clear();
+	return run.good();
+}
+
+// Buffered sequential reader over one run file
+struct RunReader
+{
+	std::ifstream file;
+	std::vector<int> block;
+	size_t pos;
+	size_t len;
+	
+	bool next(int &value)
+	{
+		if (pos == len)
+		{
+			file.read(reinterpret_cast<char *>(&block[0]), block.size() * sizeof(int));
+			len = static_cast<size_t>(file.gcount()) / sizeof(int);
+			pos = 0;
+			if (len == 0)
+				return false;
+		}
+		value = block[pos++];
+		return true;
+	}
+};
+
+// Smallest head first; ties go to the lower run so equal values keep run order
+struct HeadGreater
+{
+	bool operator()(const std::pair<int, size_t> &a, const std::pair<int, size_t> &b) const
+	{
+		return a.first > b.first || (a.first == b.first && a.second > b.second);
+	}
+};
+
+static void appendNumber(std::string &out, int value)
+{
+	char tmp[16];
+	char *p = tmp + sizeof(tmp);
+	*--p = '\n';
+	unsigned int n = static_cast<unsigned int>(value);
+	do
+	{
+		*--p = static_cast<char>('0' + n % 10);
+		n /= 10;
+	} while (n);
+	out.append(p, tmp + sizeof(tmp) - p);
+}
+
+bool ExternalSort::_merge(std::ostream &out)
+{
+	size_t k = _runs.size();
+	
+	// Readers are heap-allocated since an ifstream cannot be copied into a vector
+	std::vector<RunReader *> readers(k, static_cast<RunReader *>(NULL));
+	std::priority_queue<std::pair<int, size_t>, std::vector<std::pair<int, size_t> >, HeadGreater> heads;
+	bool ok = true;
+	for (size_t i = 0; i < k && ok; i++)
+	{
+		readers[i] = new RunReader();
+		readers[i]->file.open(_runs[i].c_str(), std::ios::in | std::ios::binary);
+		readers[i]->block.resize(16384);
+		readers[i]->pos = 0;
+		readers[i]->len = 0;
+		int value;
+		if (!readers[i]->file.is_open())
+			ok = false;
+		else if (readers[i]->next(value))
+			heads.push(std::make_pair(value, i));
+	}
+	
+	std::string buffer;
+	buffer.reserve((1 << 20) + 16);
+	while (ok && !heads.empty())
+	{
+		std::pair<int, size_t> head = heads.top();
+		heads.pop();
+		appendNumber(buffer, head.first);
+		if (buffer.size() >= (1 << 20))
+		{
+			out.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
+		int value;
+		if (readers[head.second]->next(value))
+			heads.push(std::make_pair(value, head.second));
+	}
+	out.write(buffer.data(), buffer.size());
+	
+	for (size_t i = 0; i < k; i++)
+		delete readers[i];
+	return ok && out.good();
+}
+
+void ExternalSort::_removeRuns(void)
+{
+	for (size_t i = 0; i < _runs.size(); i++)
+		std::remove(_runs[i].c_str());
+	_runs.clear();
+}
+
+bool ExternalSort::sort(std::istream &in, std::ostream &out)
+{
+	_removeRuns();
+	
+	std::vector<int> chunk;
+	chunk.reserve(_chunkElements);
+	std::vector<char> text(1 << 20);
+	std::vector<int> parsed;
+	size_t carry = 0;
+	std::streambuf *sb = in.rdbuf();
+	bool ok = true;
+	
+	for (;;)
+	{
+		std::streamsize got = sb->sgetn(&text[carry], text.size() - carry);
+		size_t filled = carry + (got > 0 ? static_cast<size_t>(got) : 0);
+		bool last = got <= 0;
+		
+		// Parse up to the last blank; a token cut by the block end waits for the next read
+		size_t cut = filled;
+		if (!last)
+		{
+			while (cut > 0 && text[cut - 1] != ' ' && text[cut - 1] != '\n' && text[cut - 1] != '\t'
+				&& text[cut - 1] != '\r')
+				cut--;
+			if (cut == 0)
+			{
+				// One token filling the whole block cannot be a valid int
+				ok = false;
+				break;
+			}
+		}
+		
+		// Parse the block, then move its numbers into the chunk, spilling
+		// whenever it fills up
+		parsed.clear();
+		ok = PmergeMe::parseNumbers(&text[0], &text[0] + cut, parsed);
+		for (size_t i = 0; i < parsed.size() && ok; i++)
+		{
+			chunk.push_back(parsed[i]);
+			if (chunk.size() == _chunkElements)
+				ok = _spill(chunk);
+		}
+		if (!ok || last)
+			break;
+		
+		carry = filled - cut;
+		for (size_t i = 0; i < carry; i++)
+			text[i] = text[cut + i];
+	}
+	
+	if (ok)
+		ok = _spill(chunk);
+	if (ok)
+		ok = _merge(out);
+	_removeRuns();
+	return ok;
+}
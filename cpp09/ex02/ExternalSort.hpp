@@ -0,0 +1,52 @@
+#ifndef EXTERNALSORT_HPP
+#define EXTERNALSORT_HPP
+
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <cstddef>
+
+// Sorts more integers than fit in memory: the input is read in chunks of
+// a fixed element count, each chunk is sorted with the merge-insertion
+// engine and spilled to a binary run file, then all runs are k-way merged
+// into the output with buffered reads
+class ExternalSort
+{
+	private:
+		size_t _chunkElements;
+		size_t _shardSize;
+		std::string _runPrefix;
+		std::vector<std::string> _runs;
+		
+		bool _spill(std::vector<int> &chunk);
+		bool _merge(std::ostream &out);
+		void _removeRuns(void);
+		
+		// Private default constructor
+		ExternalSort(void);
+		
+	public:
+		// Runs are named runPrefix + index and removed when the sort ends
+		ExternalSort(size_t chunkElements, const std::string &runPrefix);
+		
+		// Copy constructor
+		ExternalSort(const ExternalSort &other);
+		
+		// Assignment operator
+		ExternalSort &operator=(const ExternalSort &other);
+		
+		// Destructor (removes leftover runs)
+		~ExternalSort(void);
+		
+		// Shard size used for each chunk (see MergeInsertion::sortSharded)
+		void setShardSize(size_t shardSize);
+		
+		// Read blank-separated positive integers from in and write them
+		// sorted to out, one per line; false on bad input or I/O failure
+		bool sort(std::istream &in, std::ostream &out);
+		
+		size_t runCount(void) const;
+};
+
+#endif
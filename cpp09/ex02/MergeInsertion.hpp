@@ -0,0 +1,523 @@
+#ifndef MERGEINSERTION_HPP
+#define MERGEINSERTION_HPP
+
+#include <vector>
+#include <list>
+#include <functional>
+#include <algorithm>
+#include <cstddef>
+#include <climits>
+#include <iterator>
+#include "ThreadPool.hpp"
+
+// Receives the comparison count of every finished sort
+class SortObserver
+{
+	public:
+		virtual ~SortObserver(void) {}
+		virtual void onSort(size_t elements, unsigned long comparisons) = 0;
+};
+
+// Ford-Johnson merge-insertion over any element type and strict weak
+// ordering. It is meant for comparators that cost far more than moving
+// data around: elements are only reached through pointers while sorting,
+// and each one is copied once at the end
+template <typename T, typename Compare = std::less<T> >
+class MergeInsertion
+{
+	private:
+		Compare _compare;
+		unsigned long _comparisons;
+		SortObserver *_observer;
+		
+		// Elements being sorted, valid for the duration of a sort
+		const T *const *_keys;
+		
+		// Order equal keys by position, for sortStable
+		bool _stable;
+		
+		// a and b are positions into _keys
+		bool _less(size_t a, size_t b)
+		{
+			_comparisons++;
+			if (_compare(*_keys[a], *_keys[b]))
+				return true;
+			// Ties go to the earlier position; only a before b can be a tie
+			// that turns the answer, so only then is the second call made
+			if (!_stable || a > b)
+				return false;
+			_comparisons++;
+			return !_compare(*_keys[b], *_keys[a]);
+		}
+		
+		bool _lessValue(const T &a, const T &b)
+		{
+			_comparisons++;
+			return _compare(a, b);
+		}
+		
+		// Stable merge of the sorted runs [a, mid) and [mid, end) into out
+		void _mergeRuns(const T *a, const T *mid, const T *end, T *out)
+		{
+			const T *b = mid;
+			while (a != mid && b != end)
+			{
+				if (_lessValue(*b, *a))
+					*out++ = *b++;
+				else
+					*out++ = *a++;
+			}
+			out = std::copy(a, mid, out);
+			std::copy(b, end, out);
+		}
+		
+		// Up to 4 elements, binary insertion needs 0, 1, 3 and 5 comparisons
+		// in the worst case: the information bound, same as merge-insertion,
+		// without the pairing, recursion and chain bookkeeping
+		static const size_t SMALL_LEVEL = 4;
+		
+		template <typename Index>
+		void _sortSmall(const Index *elems, size_t m, Index *out)
+		{
+			for (size_t i = 0; i < m; i++)
+			{
+				size_t lo = 0;
+				size_t hi = i;
+				while (lo < hi)
+				{
+					size_t mid = lo + (hi - lo) / 2;
+					if (_less(elems[i], elems[out[mid]]))
+						hi = mid;
+					else
+						lo = mid + 1;
+				}
+				for (size_t j = i; j > lo; j--)
+					out[j] = out[j - 1];
+				out[lo] = static_cast<Index>(i);
+			}
+		}
+		
+		// Sort elems[0, m), indices into _keys; out receives positions into
+		// elems in sorted order. Every level works in scratch, which needs
+		// 3m / 2 entries for this level plus its recursion: 3m in all.
+		// Index is size_t, or unsigned int for the 4-byte arena of sortStable
+		template <typename Index>
+		void _sortLevel(const Index *elems, size_t m, Index *out, Index *scratch)
+		{
+			if (m <= SMALL_LEVEL)
+			{
+				_sortSmall(elems, m, out);
+				return;
+			}
+			
+			// Pair up neighbours 2p and 2p + 1 with one comparison each; a
+			// pair only records where its larger element is, the smaller one
+			// is the other position (bigPos ^ 1)
+			size_t half = m / 2;
+			Index *bigs = scratch;
+			Index *bigPos = scratch + half;
+			Index *sub = scratch + 2 * half;
+			for (size_t p = 0; p < half; p++)
+			{
+				size_t big = 2 * p + 1;
+				if (_less(elems[big], elems[big - 1]))
+					big--;
+				bigs[p] = elems[big];
+				bigPos[p] = static_cast<Index>(big);
+			}
+			_sortLevel(bigs, half, sub, scratch + 3 * half);
+			
+			// Main chain: the partner of the smallest large element, then all large elements
+			Index *chain = out;
+			size_t len = 0;
+			chain[len++] = bigPos[sub[0]] ^ 1;
+			for (size_t r = 0; r < half; r++)
+				chain[len++] = bigPos[sub[r]];
+			
+			// Pending elements b_2..b_half, plus the odd one out as b_(half + 1).
+			// Each group ends at a Jacobsthal number (3, 5, 11, 21...) and is
+			// inserted from its end down, so b_k is searched in at most
+			// 2^j - 1 elements before a_k
+			size_t pend = (m % 2) ? half + 1 : half;
+			size_t inserted = 1;
+			size_t previous = 1;
+			size_t current = 3;
+			size_t done = 1;
+			while (done < pend)
+			{
+				size_t last = current < pend ? current : pend;
+				for (size_t k = last; k > done; k--)
+				{
+					// b_k is 1-based; its partner a_k sits at most k + inserted - 1 into the chain
+					size_t r = k - 1;
+					size_t pos;
+					size_t bound;
+					if (r < half)
+					{
+						Index partner = bigPos[sub[r]];
+						pos = partner ^ 1;
+						bound = r + inserted;
+						while (chain[bound] != partner)
+							bound--;
+					}
+					else
+					{
+						pos = m - 1;
+						bound = len;
+					}
+					
+					// Binary insertion into chain[0, bound)
+					size_t lo = 0;
+					size_t hi = bound;
+					while (lo < hi)
+					{
+						size_t mid = lo + (hi - lo) / 2;
+						if (_less(elems[pos], elems[chain[mid]]))
+							hi = mid;
+						else
+							lo = mid + 1;
+					}
+					std::copy_backward(chain + lo, chain + len, chain + len + 1);
+					chain[lo] = static_cast<Index>(pos);
+					len++;
+					inserted++;
+				}
+				done = last;
+				size_t next = current + 2 * previous;
+				previous = current;
+				current = next;
+			}
+		}
+		
+		// Sorted order of keys[0, n) in one arena: the identity input, the
+		// result and all recursion scratch. Returns a pointer into arena
+		template <typename Index>
+		Index *_sortKeys(const std::vector<const T *> &keys, std::vector<Index> &arena)
+		{
+			size_t n = keys.size();
+			arena.resize(5 * n);
+			Index *elems = &arena[0];
+			Index *out = elems + n;
+			for (size_t i = 0; i < n; i++)
+				elems[i] = static_cast<Index>(i);
+			_keys = &keys[0];
+			_sortLevel(elems, n, out, out + n);
+			_keys = NULL;
+			return out;
+		}
+		
+		// Element i of a random-access range
+		template <typename Iterator>
+		struct RangeSlots
+		{
+			Iterator first;
+			RangeSlots(Iterator it) : first(it) {}
+			T &operator()(size_t i) const { return first[i]; }
+		};
+		
+		// Element i of a bidirectional range, through a handle per element
+		template <typename Iterator>
+		struct HandleSlots
+		{
+			const std::vector<Iterator> *handles;
+			HandleSlots(const std::vector<Iterator> &h) : handles(&h) {}
+			T &operator()(size_t i) const { return *(*handles)[i]; }
+		};
+		
+		// Move the element at order[i] into slot i by following the
+		// permutation's cycles: one temporary, each element copied once.
+		// Finished slots are marked in order itself
+		template <typename Slots, typename Index>
+		static void _permute(Slots slot, Index *order, size_t n)
+		{
+			for (size_t start = 0; start < n; start++)
+			{
+				if (order[start] == start)
+					continue;
+				T saved = slot(start);
+				size_t hole = start;
+				while (order[hole] != start)
+				{
+					size_t from = order[hole];
+					slot(hole) = slot(from);
+					order[hole] = static_cast<Index>(hole);
+					hole = from;
+				}
+				slot(hole) = saved;
+				order[hole] = static_cast<Index>(hole);
+			}
+		}
+		
+		// Merge-insertion of whole shards, one engine per shard so that
+		// shards sort on different threads; counts[s] gets the comparisons
+		struct _ShardJob
+		{
+			const Compare *compare;
+			T *items;
+			size_t n;
+			size_t shardSize;
+			unsigned long *counts;
+			
+			void operator()(size_t first, size_t last) const
+			{
+				for (size_t s = first; s < last; s++)
+				{
+					size_t start = s * shardSize;
+					size_t end = start + shardSize < n ? start + shardSize : n;
+					MergeInsertion engine(*compare);
+					engine.sort(items + start, items + end);
+					counts[s] = engine._comparisons;
+				}
+			}
+		};
+		
+		// Merge pairs of runs of one merge pass, likewise
+		struct _MergeJob
+		{
+			const Compare *compare;
+			const T *from;
+			T *to;
+			size_t n;
+			size_t width;
+			unsigned long *counts;
+			
+			void operator()(size_t first, size_t last) const
+			{
+				for (size_t p = first; p < last; p++)
+				{
+					size_t start = p * 2 * width;
+					size_t mid = start + width < n ? start + width : n;
+					size_t end = start + 2 * width < n ? start + 2 * width : n;
+					MergeInsertion engine(*compare);
+					engine._mergeRuns(from + start, from + mid, from + end, to + start);
+					counts[p] = engine._comparisons;
+				}
+			}
+		};
+		
+		void _finish(size_t n)
+		{
+			if (_observer)
+				_observer->onSort(n, _comparisons);
+		}
+		
+		template <typename Iterator>
+		void _sortRange(Iterator first, Iterator last, std::random_access_iterator_tag)
+		{
+			_comparisons = 0;
+			size_t n = last - first;
+			if (n > 1)
+			{
+				std::vector<const T *> keys(n);
+				for (size_t i = 0; i < n; i++)
+					keys[i] = &first[i];
+				std::vector<size_t> arena;
+				_permute(RangeSlots<Iterator>(first), _sortKeys(keys, arena), n);
+			}
+			_finish(n);
+		}
+		
+		template <typename Iterator, typename Index>
+		void _sortStable(Iterator first, size_t n)
+		{
+			std::vector<const T *> keys(n);
+			for (size_t i = 0; i < n; i++)
+				keys[i] = &first[i];
+			std::vector<Index> arena;
+			_stable = true;
+			Index *order = _sortKeys(keys, arena);
+			_stable = false;
+			_permute(RangeSlots<Iterator>(first), order, n);
+		}
+		
+		template <typename Iterator>
+		void _sortRange(Iterator first, Iterator last, std::bidirectional_iterator_tag)
+		{
+			_comparisons = 0;
+			std::vector<Iterator> handles;
+			std::vector<const T *> keys;
+			for (Iterator it = first; it != last; ++it)
+			{
+				handles.push_back(it);
+				keys.push_back(&*it);
+			}
+			size_t n = keys.size();
+			if (n > 1)
+			{
+				std::vector<size_t> arena;
+				_permute(HandleSlots<Iterator>(handles), _sortKeys(keys, arena), n);
+			}
+			_finish(n);
+		}
+		
+	public:
+		// Constructor
+		MergeInsertion(const Compare &compare = Compare())
+			: _compare(compare), _comparisons(0), _observer(NULL), _keys(NULL), _stable(false)
+		{
+		}
+		
+		// Copy constructor
+		MergeInsertion(const MergeInsertion &other)
+			: _compare(other._compare), _comparisons(other._comparisons), _observer(other._observer),
+			_keys(NULL), _stable(false)
+		{
+		}
+		
+		// Assignment operator
+		MergeInsertion &operator=(const MergeInsertion &other)
+		{
+			if (this != &other)
+			{
+				_compare = other._compare;
+				_comparisons = other._comparisons;
+				_observer = other._observer;
+			}
+			return *this;
+		}
+		
+		// Destructor
+		~MergeInsertion(void)
+		{
+		}
+		
+		// Called after every sort; NULL for none (not owned)
+		void setObserver(SortObserver *observer)
+		{
+			_observer = observer;
+		}
+		
+		// Comparisons made by the last sort
+		unsigned long getComparisonCount(void) const
+		{
+			return _comparisons;
+		}
+		
+		// Sort any bidirectional range of T in place: a vector, a deque, a
+		// plain T * buffer (cpp07's Array<T> through &a[0], &a[0] + a.size())
+		template <typename Iterator>
+		void sort(Iterator first, Iterator last)
+		{
+			_sortRange(first, last, typename std::iterator_traits<Iterator>::iterator_category());
+		}
+		
+		void sort(std::vector<T> &items)
+		{
+			sort(items.begin(), items.end());
+		}
+		
+		// Stable sort of a random-access range, for records sorted by a key
+		// that is a small part of them: merge-insertion orders a permutation
+		// of 4-byte indices, then each record moves once, by following the
+		// permutation's cycles in place. Equal keys are ordered by position,
+		// which costs a second comparison when the first one fails with the
+		// left element first: about a quarter more comparisons on random
+		// keys, and up to twice as many on reversed input
+		template <typename Iterator>
+		void sortStable(Iterator first, Iterator last)
+		{
+			_comparisons = 0;
+			size_t n = last - first;
+			if (n > UINT_MAX)
+				_sortStable<Iterator, size_t>(first, n);
+			else if (n > 1)
+				_sortStable<Iterator, unsigned int>(first, n);
+			_finish(n);
+		}
+		
+		void sortStable(std::vector<T> &items)
+		{
+			sortStable(items.begin(), items.end());
+		}
+		
+		// Merge-insertion within shards of shardSize elements, then bottom-up
+		// merging of the sorted shards. Shards are independent of each other,
+		// and chain insertion no longer shifts across the whole input, at the
+		// price of merge comparisons above the merge-insertion minimum. The
+		// shards, then the run pairs of each merge pass, are spread over the
+		// threads of ThreadPool::shared(), each with its own copy of the
+		// comparator; the comparison count is the same as on one thread
+		void sortSharded(std::vector<T> &items, size_t shardSize)
+		{
+			size_t n = items.size();
+			if (shardSize == 0 || shardSize >= n)
+			{
+				sort(items);
+				return;
+			}
+			
+			ThreadPool &pool = ThreadPool::shared();
+			size_t shards = (n - 1) / shardSize + 1;
+			std::vector<unsigned long> counts(shards);
+			_ShardJob sortJob;
+			sortJob.compare = &_compare;
+			sortJob.items = &items[0];
+			sortJob.n = n;
+			sortJob.shardSize = shardSize;
+			sortJob.counts = &counts[0];
+			pool.parallelFor(0, shards, 1, sortJob);
+			unsigned long total = 0;
+			for (size_t s = 0; s < shards; s++)
+				total += counts[s];
+			
+			// Runs double in width each pass, ping-ponging between two
+			// buffers; the last passes have fewer pairs than threads
+			std::vector<T> buffer(items);
+			_MergeJob mergeJob;
+			mergeJob.compare = &_compare;
+			mergeJob.from = &items[0];
+			mergeJob.to = &buffer[0];
+			mergeJob.n = n;
+			mergeJob.counts = &counts[0];
+			bool swapped = false;
+			for (size_t width = shardSize; width < n; width *= 2)
+			{
+				size_t pairs = (n - 1) / (2 * width) + 1;
+				mergeJob.width = width;
+				pool.parallelFor(0, pairs, 1, mergeJob);
+				for (size_t p = 0; p < pairs; p++)
+					total += counts[p];
+				
+				T *from = mergeJob.to;
+				mergeJob.to = const_cast<T *>(mergeJob.from);
+				mergeJob.from = from;
+				swapped = !swapped;
+			}
+			if (swapped)
+				items.swap(buffer);
+			_comparisons = total;
+			_finish(n);
+		}
+		
+		// Same comparisons for a list; the nodes are relinked into sorted
+		// order with splice, so no value is copied and no node reallocated
+		template <typename Alloc>
+		void sort(std::list<T, Alloc> &items)
+		{
+			typedef typename std::list<T, Alloc>::iterator Node;
+			
+			_comparisons = 0;
+			size_t n = items.size();
+			if (n > 1)
+			{
+				std::vector<const T *> keys;
+				std::vector<Node> nodes;
+				keys.reserve(n);
+				nodes.reserve(n);
+				for (Node it = items.begin(); it != items.end(); ++it)
+				{
+					keys.push_back(&*it);
+					nodes.push_back(it);
+				}
+				std::vector<size_t> arena;
+				const size_t *order = _sortKeys(keys, arena);
+				
+				// Moving each node to the back in order leaves them sorted
+				for (size_t i = 0; i < n; i++)
+					items.splice(items.end(), items, nodes[order[i]]);
+			}
+			_finish(n);
+		}
+};
+
+#endif
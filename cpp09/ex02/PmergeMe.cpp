@@ -1,19 +1,30 @@
 #include "PmergeMe.hpp"
+#include "DigitScan.hpp"
+#include "Profiler.hpp"
 #include <algorithm>
+#include <cmath>
+#include <climits>
 
-PmergeMe::PmergeMe(void)
+PmergeMe::PmergeMe(void) : _countComparisons(false), _comparisons(0), _shardSize(0), _adaptive(false),
+	_detectRuns(false)
 {
 }
 
-PmergeMe::PmergeMe(const PmergeMe &other)
+PmergeMe::PmergeMe(const PmergeMe &other) : _countComparisons(other._countComparisons),
+	_comparisons(other._comparisons), _shardSize(other._shardSize), _adaptive(other._adaptive),
+	_detectRuns(other._detectRuns)
 {
-	(void)other;
 }
 
 PmergeMe &PmergeMe::operator=(const PmergeMe &other)
 {
 	if (this != &other)
 	{
+		_countComparisons = other._countComparisons;
+		_comparisons = other._comparisons;
+		_shardSize = other._shardSize;
+		_adaptive = other._adaptive;
+		_detectRuns = other._detectRuns;
 	}
 	return *this;
 }
@@ -22,118 +33,579 @@ PmergeMe::~PmergeMe(void)
 {
 }
 
-// Simple insertion sort for vector
-void PmergeMe::_insertionSortVec(std::vector<int> &arr, int n)
+void PmergeMe::_account(const MergeInsertion<int> &engine)
 {
-	for (int i = 1; i < n; i++)
+	_account(engine.getComparisonCount());
+}
+
+void PmergeMe::_account(unsigned long comparisons)
+{
+	if (_countComparisons)
+		_comparisons += comparisons;
+}
+
+// Below this many values merge-insertion is as fast as the key sorts
+static const size_t ADAPTIVE_MIN = 64;
+
+// Counting sort is used while max - min + 1 is at most this many times n
+static const long long DENSE_FACTOR = 4;
+
+// Radix keys keep the order of the ints they came from
+static unsigned int radixKey(int value)
+{
+	return static_cast<unsigned int>(value) ^ 0x80000000u;
+}
+
+static void countingSort(std::vector<int> &values, int low, size_t range)
+{
+	std::vector<size_t> counts(range, 0);
+	for (size_t i = 0; i < values.size(); i++)
+		counts[static_cast<size_t>(static_cast<long long>(values[i]) - low)]++;
+	size_t out = 0;
+	for (size_t v = 0; v < range; v++)
+		for (size_t c = counts[v]; c > 0; c--)
+			values[out++] = static_cast<int>(low + static_cast<long long>(v));
+}
+
+// LSD radix sort, one byte per pass; a byte all keys share takes no pass
+static void radixSort(std::vector<int> &values)
+{
+	size_t n = values.size();
+	std::vector<unsigned int> keys(n);
+	std::vector<unsigned int> scratch(n);
+	std::vector<size_t> counts(4 * 256, 0);
+	for (size_t i = 0; i < n; i++)
 	{
-		int key = arr[i];
-		int j = i - 1;
-		
-		while (j >= 0 && arr[j] > key)
+		keys[i] = radixKey(values[i]);
+		for (int pass = 0; pass < 4; pass++)
+			counts[pass * 256 + ((keys[i] >> (pass * 8)) & 0xff)]++;
+	}
+	
+	for (int pass = 0; pass < 4; pass++)
+	{
+		size_t *count = &counts[pass * 256];
+		if (count[(keys[0] >> (pass * 8)) & 0xff] == n)
+			continue;
+		size_t offset = 0;
+		for (int b = 0; b < 256; b++)
 		{
-			arr[j + 1] = arr[j];
-			j--;
+			size_t c = count[b];
+			count[b] = offset;
+			offset += c;
 		}
-		arr[j + 1] = key;
+		for (size_t i = 0; i < n; i++)
+			scratch[count[(keys[i] >> (pass * 8)) & 0xff]++] = keys[i];
+		keys.swap(scratch);
 	}
+	for (size_t i = 0; i < n; i++)
+		values[i] = static_cast<int>(keys[i] ^ 0x80000000u);
 }
 
-// Simple insertion sort for list
-void PmergeMe::_insertionSortList(std::list<int> &lst, int n)
+// Sort [first, last) by key instead of by comparison: counting sort when
+// the values are dense, radix sort otherwise. Values are written back
+// through the iterators, so list nodes stay where they are. False (and
+// nothing done) when the range is too short to be worth it
+template <typename Iterator>
+static bool sortByKey(Iterator first, Iterator last, size_t n)
 {
-	std::list<int>::iterator it = lst.begin();
-	std::advance(it, 1);
+	if (n < ADAPTIVE_MIN)
+		return false;
 	
-	for (int i = 1; i < n; i++, ++it)
+	std::vector<int> values(first, last);
+	int low = values[0];
+	int high = values[0];
+	for (size_t i = 1; i < n; i++)
 	{
-		int key = *it;
-		std::list<int>::iterator jit = it;
-		--jit;
-		
-		while (jit != lst.begin() && *jit > key)
+		if (values[i] < low)
+			low = values[i];
+		else if (values[i] > high)
+			high = values[i];
+	}
+	long long range = static_cast<long long>(high) - low + 1;
+	if (range <= DENSE_FACTOR * static_cast<long long>(n))
+		countingSort(values, low, static_cast<size_t>(range));
+	else
+		radixSort(values);
+	std::copy(values.begin(), values.end(), first);
+	return true;
+}
+
+// A run of equal adjacent values, sorted as one item
+struct Cluster
+{
+	int value;
+	size_t count;
+};
+
+struct ClusterLess
+{
+	bool operator()(const Cluster &a, const Cluster &b) const
+	{
+		return a.value < b.value;
+	}
+};
+
+// Collapse equal neighbours when that removes at least 1/8 of the items
+static bool worthCollapsing(size_t clusters, size_t n)
+{
+	return clusters * 8 <= n * 7;
+}
+
+// One pass over adjacent pairs (one or two comparisons each): whether any
+// pair ascends or descends, and how many runs of equal values there are
+template <typename Iterator>
+static size_t scanRuns(Iterator first, Iterator last, bool &ascends, bool &descends, unsigned long &comparisons)
+{
+	ascends = false;
+	descends = false;
+	size_t clusters = 1;
+	Iterator prev = first;
+	for (Iterator it = ++first; it != last; prev = it, ++it)
+	{
+		comparisons++;
+		if (*prev < *it)
 		{
-			std::list<int>::iterator next_jit = jit;
-			++next_jit;
-			*next_jit = *jit;
-			--jit;
+			ascends = true;
+			clusters++;
+			continue;
 		}
-		
-		if (*jit > key)
+		comparisons++;
+		if (*it < *prev)
 		{
-			std::list<int>::iterator next_jit = jit;
-			++next_jit;
-			*next_jit = *jit;
-			*jit = key;
+			descends = true;
+			clusters++;
 		}
+	}
+	return clusters;
+}
+
+// Merge-insertion over the runs of equal values; each run is written back
+// count times, through the iterators so list nodes stay where they are
+template <typename Iterator>
+static void sortClusters(Iterator first, Iterator last, size_t clusters, size_t shardSize,
+	unsigned long &comparisons)
+{
+	std::vector<Cluster> items;
+	items.reserve(clusters);
+	for (Iterator it = first; it != last; ++it)
+	{
+		if (!items.empty() && items.back().value == *it)
+			items.back().count++;
 		else
 		{
-			std::list<int>::iterator next_jit = jit;
-			++next_jit;
-			*next_jit = key;
+			Cluster c;
+			c.value = *it;
+			c.count = 1;
+			items.push_back(c);
 		}
 	}
+	
+	MergeInsertion<Cluster, ClusterLess> engine;
+	engine.sortSharded(items, shardSize);
+	comparisons += engine.getComparisonCount();
+	
+	Iterator out = first;
+	for (size_t i = 0; i < items.size(); i++)
+		for (size_t c = items[i].count; c > 0; c--)
+			*out++ = items[i].value;
+}
+
+// Run pre-pass: true when [first, last) is sorted on return, which it is
+// if it already was, was non-increasing (then reversed in place) or had
+// enough equal neighbours to be sorted as clusters. Comparisons made are
+// added to comparisons either way
+template <typename Iterator>
+static bool presort(Iterator first, Iterator last, size_t n, size_t shardSize, unsigned long &comparisons)
+{
+	if (n <= 1)
+		return true;
+	bool ascends;
+	bool descends;
+	size_t clusters = scanRuns(first, last, ascends, descends, comparisons);
+	if (!descends)
+		return true;
+	if (!ascends)
+	{
+		std::reverse(first, last);
+		return true;
+	}
+	if (!worthCollapsing(clusters, n))
+		return false;
+	sortClusters(first, last, clusters, shardSize, comparisons);
+	return true;
+}
+
+// An element of the deque engine; tag tells apart the items of one level,
+// where values may repeat
+struct DequeItem
+{
+	int value;
+	size_t tag;
+};
+
+// Ford-Johnson straight on deques: each level pairs its items, sorts the
+// larger ones recursively (tagged with their pair), then inserts the
+// smaller ones into that main chain with deque random access. b_k is
+// searched only in the chain before its partner a_k, and the pend items
+// go in Jacobsthal groups (3, 5, 11, 21...) from each group's end down, so
+// that bound never exceeds 2^j - 1 items
+static void mergeInsertDeque(std::deque<DequeItem> &items, unsigned long &comparisons)
+{
+	size_t m = items.size();
+	if (m <= 1)
+		return;
+	
+	size_t half = m / 2;
+	std::deque<DequeItem> bigs(half);
+	std::deque<DequeItem> larger(half);
+	std::deque<DequeItem> smaller(half);
+	for (size_t p = 0; p < half; p++)
+	{
+		const DequeItem &a = items[2 * p];
+		const DequeItem &b = items[2 * p + 1];
+		comparisons++;
+		bool swapped = b.value < a.value;
+		larger[p] = swapped ? a : b;
+		smaller[p] = swapped ? b : a;
+		bigs[p].value = larger[p].value;
+		bigs[p].tag = p;
+	}
+	mergeInsertDeque(bigs, comparisons);
+	
+	// Main chain: b_1, then a_1..a_half in sorted order
+	std::deque<DequeItem> chain;
+	chain.push_back(smaller[bigs[0].tag]);
+	for (size_t r = 0; r < half; r++)
+		chain.push_back(larger[bigs[r].tag]);
+	
+	size_t pend = (m % 2) ? half + 1 : half;
+	size_t inserted = 1;
+	size_t previous = 1;
+	size_t current = 3;
+	size_t done = 1;
+	while (done < pend)
+	{
+		size_t last = current < pend ? current : pend;
+		for (size_t k = last; k > done; k--)
+		{
+			// b_k is 1-based; a_k sits at most k + inserted - 1 into the chain
+			size_t r = k - 1;
+			const DequeItem *item;
+			size_t bound;
+			if (r < half)
+			{
+				const DequeItem &partner = larger[bigs[r].tag];
+				item = &smaller[bigs[r].tag];
+				bound = r + inserted;
+				while (chain[bound].tag != partner.tag)
+					bound--;
+			}
+			else
+			{
+				item = &items[m - 1];
+				bound = chain.size();
+			}
+			
+			size_t lo = 0;
+			size_t hi = bound;
+			while (lo < hi)
+			{
+				size_t mid = lo + (hi - lo) / 2;
+				comparisons++;
+				if (item->value < chain[mid].value)
+					hi = mid;
+				else
+					lo = mid + 1;
+			}
+			chain.insert(chain.begin() + lo, *item);
+			inserted++;
+		}
+		done = last;
+		size_t next = current + 2 * previous;
+		previous = current;
+		current = next;
+	}
+	items.swap(chain);
 }
 
 void PmergeMe::_mergeInsertVec(std::vector<int> &arr)
 {
-	// Simple merge-insert: first insertion sort, then we could merge
-	// For this simple implementation, we use insertion sort which is part of the algorithm
 	if (arr.size() <= 1)
 		return;
+	if (_adaptive && sortByKey(arr.begin(), arr.end(), arr.size()))
+		return;
 	
-	// Use STL sort (which is efficient merge sort internally)
-	std::sort(arr.begin(), arr.end());
+	unsigned long comparisons = 0;
+	bool sorted = _detectRuns && presort(arr.begin(), arr.end(), arr.size(), _shardSize, comparisons);
+	_account(comparisons);
+	if (sorted)
+		return;
+	
+	MergeInsertion<int> engine;
+	engine.sortSharded(arr, _shardSize);
+	_account(engine);
 }
 
-void PmergeMe::_mergeInsertList(std::list<int> &lst)
+template <typename List>
+void PmergeMe::_mergeInsertList(List &lst)
 {
 	if (lst.size() <= 1)
 		return;
+	if (_adaptive && sortByKey(lst.begin(), lst.end(), lst.size()))
+		return;
 	
-	// For list, we need a different approach
-	// Convert to vector, sort, convert back
-	std::vector<int> temp(lst.begin(), lst.end());
-	std::sort(temp.begin(), temp.end());
+	unsigned long comparisons = 0;
+	bool sorted = _detectRuns && presort(lst.begin(), lst.end(), lst.size(), _shardSize, comparisons);
+	_account(comparisons);
+	if (sorted)
+		return;
 	
-	lst.clear();
-	for (size_t i = 0; i < temp.size(); i++)
+	// Sorted in place by relinking nodes; no temporary copy of the values
+	MergeInsertion<int> engine;
+	engine.sort(lst);
+	_account(engine);
+}
+
+void PmergeMe::setCountComparisons(bool enabled)
+{
+	_countComparisons = enabled;
+	_comparisons = 0;
+}
+
+unsigned long PmergeMe::getComparisonCount(void) const
+{
+	return _comparisons;
+}
+
+unsigned long PmergeMe::maxComparisons(size_t n)
+{
+	// ceil(log2(3k / 4)) is the smallest c with 2^(c + 2) >= 3k
+	unsigned long total = 0;
+	for (size_t k = 1; k <= n; k++)
 	{
-		lst.push_back(temp[i]);
+		unsigned long c = 0;
+		while ((static_cast<unsigned long long>(4) << c) < 3ULL * k)
+			c++;
+		total += c;
 	}
+	return total;
+}
+
+unsigned long PmergeMe::minComparisons(size_t n)
+{
+	double bits = 0;
+	for (size_t k = 2; k <= n; k++)
+		bits += std::log(static_cast<double>(k)) / std::log(2.0);
+	return static_cast<unsigned long>(std::ceil(bits - 1e-9));
+}
+
+void PmergeMe::setShardSize(size_t shardSize)
+{
+	_shardSize = shardSize;
+}
+
+size_t PmergeMe::getShardSize(void) const
+{
+	return _shardSize;
+}
+
+void PmergeMe::setAdaptive(bool enabled)
+{
+	_adaptive = enabled;
+}
+
+bool PmergeMe::isAdaptive(void) const
+{
+	return _adaptive;
+}
+
+void PmergeMe::setRunDetection(bool enabled)
+{
+	_detectRuns = enabled;
+}
+
+bool PmergeMe::isRunDetection(void) const
+{
+	return _detectRuns;
 }
 
 void PmergeMe::sortVector(std::vector<int> &arr)
 {
+	PROFILE_SCOPE(PHASE_SORT_VECTOR);
+	PROFILE_COUNT(EVENT_VECTOR_ELEMENTS, arr.size());
 	_mergeInsertVec(arr);
 }
 
 void PmergeMe::sortList(std::list<int> &lst)
 {
+	PROFILE_SCOPE(PHASE_SORT_LIST);
+	PROFILE_COUNT(EVENT_LIST_ELEMENTS, lst.size());
+	_mergeInsertList(lst);
+}
+
+void PmergeMe::sortList(PoolList &lst)
+{
+	PROFILE_SCOPE(PHASE_SORT_LIST);
+	PROFILE_COUNT(EVENT_LIST_ELEMENTS, lst.size());
 	_mergeInsertList(lst);
 }
 
-void PmergeMe::displayVector(const std::vector<int> &arr, const std::string &label)
+static bool isSpace(char c)
+{
+	return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+bool PmergeMe::parseNumbers(const char *begin, const char *end, std::vector<int> &out)
 {
-	std::cout << label;
-	for (size_t i = 0; i < arr.size(); i++)
+	// Count the tokens first so the vector grows once
+	size_t tokens = 0;
+	bool inToken = false;
+	for (const char *p = begin; p < end; p++)
 	{
-		if (i > 0)
-			std::cout << " ";
-		std::cout << arr[i];
+		bool space = isSpace(*p);
+		if (!space && !inToken)
+			tokens++;
+		inToken = !space;
 	}
-	std::cout << std::endl;
+	out.reserve(out.size() + tokens);
+	
+	const char *p = begin;
+	while (p < end)
+	{
+		while (p < end && isSpace(*p))
+			p++;
+		if (p == end)
+			break;
+		
+		// Digits only, eight at a time (see DigitScan); the running value
+		// is checked against INT_MAX as it grows
+		unsigned long long value;
+		const char *start = p;
+		if (!DigitScan::parse(p, end, INT_MAX, value))
+			return false;
+		if (p == start || value == 0 || (p < end && !isSpace(*p)))
+			return false;
+		out.push_back(static_cast<int>(value));
+	}
+	return true;
+}
+
+void PmergeMe::sortDeque(std::deque<int> &dq)
+{
+	if (_adaptive && sortByKey(dq.begin(), dq.end(), dq.size()))
+		return;
+	unsigned long comparisons = 0;
+	bool sorted = _detectRuns && presort(dq.begin(), dq.end(), dq.size(), _shardSize, comparisons);
+	_account(comparisons);
+	if (sorted)
+		return;
+	
+	// The deque engine, rather than MergeInsertion through iterators:
+	// same comparisons, with the chain itself a deque
+	std::deque<DequeItem> items(dq.size());
+	for (size_t i = 0; i < dq.size(); i++)
+	{
+		items[i].value = dq[i];
+		items[i].tag = i;
+	}
+	comparisons = 0;
+	mergeInsertDeque(items, comparisons);
+	_account(comparisons);
+	for (size_t i = 0; i < items.size(); i++)
+		dq[i] = items[i].value;
 }
 
-void PmergeMe::displayList(const std::list<int> &lst, const std::string &label)
+void PmergeMe::sortRange(int *first, int *last)
 {
-	std::cout << label;
-	size_t i = 0;
-	for (std::list<int>::const_iterator it = lst.begin(); it != lst.end(); ++it, ++i)
+	if (_adaptive && sortByKey(first, last, static_cast<size_t>(last - first)))
+		return;
+	unsigned long comparisons = 0;
+	bool sorted = _detectRuns && presort(first, last, static_cast<size_t>(last - first), _shardSize, comparisons);
+	_account(comparisons);
+	if (sorted)
+		return;
+	MergeInsertion<int> engine;
+	engine.sort(first, last);
+	_account(engine);
+}
+
+// "00".."99": two digits per division when formatting
+static const char DIGIT_PAIRS[] =
+	"0001020304050607080910111213141516171819"
+	"2021222324252627282930313233343536373839"
+	"4041424344454647484950515253545556575859"
+	"6061626364656667686970717273747576777879"
+	"8081828384858687888990919293949596979899";
+
+static const size_t DISPLAY_BLOCK = 1 << 20;
+
+// Write value ending just before end; returns where its first digit went
+static char *formatNumber(int value, char *end)
+{
+	unsigned int n = static_cast<unsigned int>(value);
+	bool negative = value < 0;
+	if (negative)
+		n = 0u - n;
+	while (n >= 100)
+	{
+		unsigned int pair = (n % 100) * 2;
+		n /= 100;
+		*--end = DIGIT_PAIRS[pair + 1];
+		*--end = DIGIT_PAIRS[pair];
+	}
+	if (n >= 10)
+	{
+		*--end = DIGIT_PAIRS[n * 2 + 1];
+		*--end = DIGIT_PAIRS[n * 2];
+	}
+	else
+		*--end = static_cast<char>('0' + n);
+	if (negative)
+		*--end = '-';
+	return end;
+}
+
+// Print label and up to limit values (all when limit is 0) from one buffer,
+// written out a block at a time; a cut-off sequence ends with " [...]"
+template <typename Iterator>
+static void displayRange(Iterator first, Iterator last, size_t size, const std::string &label, size_t limit)
+{
+	size_t shown = (limit == 0 || limit > size) ? size : limit;
+	std::string buffer;
+	buffer.reserve(std::min(shown * 12, DISPLAY_BLOCK) + label.size() + 32);
+	buffer = label;
+	
+	char tmp[16];
+	for (size_t i = 0; i < shown && first != last; ++i, ++first)
 	{
 		if (i > 0)
-			std::cout << " ";
-		std::cout << *it;
+			buffer += ' ';
+		char *digits = formatNumber(*first, tmp + sizeof(tmp));
+		buffer.append(digits, tmp + sizeof(tmp) - digits);
+		if (buffer.size() >= DISPLAY_BLOCK)
+		{
+			std::cout.write(buffer.data(), buffer.size());
+			buffer.clear();
+		}
 	}
-	std::cout << std::endl;
+	if (shown < size)
+		buffer += shown > 0 ? " [...]" : "[...]";
+	buffer += '\n';
+	std::cout.write(buffer.data(), buffer.size());
+	std::cout.flush();
+}
+
+void PmergeMe::displayVector(const std::vector<int> &arr, const std::string &label, size_t limit)
+{
+	displayRange(arr.begin(), arr.end(), arr.size(), label, limit);
+}
+
+void PmergeMe::displayList(const std::list<int> &lst, const std::string &label, size_t limit)
+{
+	displayRange(lst.begin(), lst.end(), lst.size(), label, limit);
+}
+
+void PmergeMe::displayList(const PoolList &lst, const std::string &label, size_t limit)
+{
+	displayRange(lst.begin(), lst.end(), lst.size(), label, limit);
 }
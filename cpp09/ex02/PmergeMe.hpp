@@ -3,23 +3,42 @@
 
 #include <vector>
 #include <list>
+#include <deque>
 #include <iostream>
 #include <ctime>
+#include "MergeInsertion.hpp"
+#include "PoolAlloc.hpp"
 
 class PmergeMe
 {
+	public:
+		// List whose nodes come from contiguous slabs (see PoolAlloc)
+		typedef std::list<int, PoolAlloc<int> > PoolList;
+		
 	private:
+		// Comparison accounting (off by default)
+		bool _countComparisons;
+		unsigned long _comparisons;
+		
+		// Vector shard size for sortVector; 0 sorts the input as one piece
+		size_t _shardSize;
+		
+		// Sort ints by key (counting or radix sort) when that is faster
+		bool _adaptive;
+		
+		// O(n) pre-pass for sorted, reversed and duplicate-heavy inputs
+		bool _detectRuns;
+		
 		// Helper functions for vector
 		void _mergeInsertVec(std::vector<int> &arr);
-		void _insertionSortVec(std::vector<int> &arr, int n);
 		
-		// Helper functions for list
-		void _mergeInsertList(std::list<int> &lst);
-		void _insertionSortList(std::list<int> &lst, int n);
+		// Helper functions for list (std::list<int> or PoolList)
+		template <typename List>
+		void _mergeInsertList(List &lst);
 		
-		// Helper to get median
-		int _getMedian(std::vector<int> &arr, size_t start, size_t end);
-		int _getMedianList(std::list<int> &lst, size_t start, size_t end);
+		// Adds the engine's count when counting is on
+		void _account(const MergeInsertion<int> &engine);
+		void _account(unsigned long comparisons);
 		
 	public:
 		// Constructor
@@ -34,17 +53,64 @@ class PmergeMe
 		// Destructor
 		~PmergeMe(void);
 		
-		// Sort using vector
+		// Count element comparisons made by the sorts; enabling resets the count
+		void setCountComparisons(bool enabled);
+		unsigned long getComparisonCount(void) const;
+		
+		// Worst case of merge-insertion for n elements: sum of ceil(log2(3k / 4))
+		static unsigned long maxComparisons(size_t n);
+		
+		// Information-theoretic lower bound ceil(log2(n!)); merge-insertion
+		// meets it for n <= 11 and stays within a few percent beyond
+		static unsigned long minComparisons(size_t n);
+		
+		// Split large vector sorts into independently sorted shards that are
+		// then merged (see MergeInsertion::sortSharded)
+		void setShardSize(size_t shardSize);
+		size_t getShardSize(void) const;
+		
+		// Adaptive mode: inputs of 64 or more values are sorted without
+		// comparisons, by counting sort when max - min + 1 <= 4n and by LSD
+		// radix sort otherwise. Off by default; merge-insertion stays the
+		// engine that minimizes comparisons, and counts none in this mode
+		void setAdaptive(bool enabled);
+		bool isAdaptive(void) const;
+		
+		// Run detection: before merge-insertion, one pass over neighbours
+		// (up to 2(n - 1) comparisons, counted) returns at once for sorted
+		// input, reverses non-increasing input in place, and sorts runs of
+		// equal neighbours as single items when that removes 1/8 of them.
+		// Off by default, since the pass can push a sort past maxComparisons
+		void setRunDetection(bool enabled);
+		bool isRunDetection(void) const;
+		
+		// Sort using vector (Ford-Johnson merge-insertion)
 		void sortVector(std::vector<int> &arr);
 		
 		// Sort using list
 		void sortList(std::list<int> &lst);
+		void sortList(PoolList &lst);
+		
+		// Sort using deque: merge-insertion with the main chain kept as a
+		// deque, each pend element inserted by binary search bounded by its
+		// partner's position
+		void sortDeque(std::deque<int> &dq);
+		
+		// Same engine as sortVector, sorted where the data already lives
+		void sortRange(int *first, int *last);
+		
+		// Append the positive integers in [begin, end), separated by blanks.
+		// Capacity is reserved up front; false on anything else, including
+		// zero, signs and values above INT_MAX
+		static bool parseNumbers(const char *begin, const char *end, std::vector<int> &out);
 		
-		// Display vector
-		static void displayVector(const std::vector<int> &arr, const std::string &label);
+		// Display vector; with a limit only the first limit values are
+		// printed, followed by "[...]"
+		static void displayVector(const std::vector<int> &arr, const std::string &label, size_t limit = 0);
 		
-		// Display list
-		static void displayList(const std::list<int> &lst, const std::string &label);
+		// Display list, same format
+		static void displayList(const std::list<int> &lst, const std::string &label, size_t limit = 0);
+		static void displayList(const PoolList &lst, const std::string &label, size_t limit = 0);
 };
 
 #endif
@@ -0,0 +1,105 @@
+#include "PoolAlloc.hpp"
+
+// Every chunk is rounded to this, which covers the alignment of any scalar
+static const size_t ALIGN = 16;
+
+static size_t roundUp(size_t bytes)
+{
+	return (bytes + ALIGN - 1) & ~(ALIGN - 1);
+}
+
+Pool::Pool(size_t slabBytes) : _slabBytes(roundUp(slabBytes < 4 * ALIGN ? 4 * ALIGN : slabBytes)),
+	_used(0), _next(NULL), _end(NULL), _chunkBytes(0), _freeList(NULL), _refs(1)
+{
+}
+
+Pool::~Pool(void)
+{
+	for (size_t i = 0; i < _slabs.size(); i++)
+		::operator delete(_slabs[i]);
+}
+
+void *Pool::allocate(size_t bytes)
+{
+	bytes = roundUp(bytes ? bytes : 1);
+	if (bytes > _slabBytes / 4)
+		return ::operator new(bytes);
+	
+	if (_chunkBytes == 0)
+		_chunkBytes = bytes;
+	if (bytes == _chunkBytes && _freeList)
+	{
+		void *p = _freeList;
+		_freeList = *static_cast<void **>(p);
+		return p;
+	}
+	
+	if (static_cast<size_t>(_end - _next) < bytes)
+	{
+		// Slabs left over from before a rewind come first
+		if (_used == _slabs.size())
+		{
+			_slabs.reserve(_slabs.size() + 1);
+			_slabs.push_back(static_cast<char *>(::operator new(_slabBytes)));
+		}
+		char *slab = _slabs[_used++];
+		_next = slab;
+		_end = slab + _slabBytes;
+	}
+	void *p = _next;
+	_next += bytes;
+	return p;
+}
+
+void Pool::deallocate(void *p, size_t bytes)
+{
+	if (!p)
+		return;
+	bytes = roundUp(bytes ? bytes : 1);
+	if (bytes > _slabBytes / 4)
+		::operator delete(p);
+	else if (bytes == _chunkBytes)
+	{
+		*static_cast<void **>(p) = _freeList;
+		_freeList = p;
+	}
+}
+
+Pool::Mark Pool::mark(void) const
+{
+	Mark m;
+	m.used = _used;
+	m.next = _next;
+	return m;
+}
+
+void Pool::rewind(const Mark &m)
+{
+	_used = m.used;
+	_next = m.next;
+	_end = _used ? _slabs[_used - 1] + _slabBytes : NULL;
+	_freeList = NULL;
+}
+
+void Pool::reset(void)
+{
+	Mark start;
+	start.used = 0;
+	start.next = NULL;
+	rewind(start);
+}
+
+void Pool::retain(void)
+{
+	_refs++;
+}
+
+bool Pool::release(void)
+{
+	return --_refs == 0;
+}
+
+size_t Pool::slabCount(void) const
+{
+	return _slabs.size();
+}
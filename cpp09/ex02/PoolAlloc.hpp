@@ -0,0 +1,214 @@
+#ifndef POOLALLOC_HPP
+#define POOLALLOC_HPP
+
+#include <cstddef>
+#include <vector>
+#include <new>
+
+// Bump allocator over contiguous slabs. Freed chunks of the most common
+// size are kept on a free list for reuse; everything else is released only
+// when the pool itself goes, all slabs at once, or by rewinding it to a
+// mark, which keeps the slabs for the allocations that follow. Shared by
+// reference count between PoolAlloc copies
+class Pool
+{
+	public:
+		// A point to rewind to: how far through the slabs allocation was
+		struct Mark
+		{
+			size_t used;
+			char *next;
+		};
+	
+	private:
+		size_t _slabBytes;
+		std::vector<char *> _slabs;
+		size_t _used;	// slabs allocated from so far, the last one partly
+		char *_next;
+		char *_end;
+		
+		// Chunk size served from the free list (the first single-object size)
+		size_t _chunkBytes;
+		void *_freeList;
+		
+		size_t _refs;
+		
+		// Pools are shared through PoolAlloc, never copied
+		Pool(const Pool &other);
+		Pool &operator=(const Pool &other);
+	
+	public:
+		// Allocations above a quarter slab go straight to operator new
+		explicit Pool(size_t slabBytes);
+		~Pool(void);
+		
+		void *allocate(size_t bytes);
+		void deallocate(void *p, size_t bytes);
+		
+		Mark mark(void) const;
+		// Release everything allocated since m at once; nothing allocated
+		// after it may be in use any more. Chunks on the free list are
+		// dropped with it, not reused, until the next reset
+		void rewind(const Mark &m);
+		// Rewind to the state of a new pool, keeping every slab
+		void reset(void);
+		
+		void retain(void);
+		// True when that was the last reference
+		bool release(void);
+		
+		size_t slabCount(void) const;
+};
+
+// Standard allocator handing out memory from a Pool, so that
+// std::list<int, PoolAlloc<int> > takes its nodes from a few slabs instead
+// of one heap block each. A default-constructed allocator owns a new pool;
+// copies and rebinds share it
+template <typename T>
+class PoolAlloc
+{
+	template <typename U> friend class PoolAlloc;
+	
+	private:
+		Pool *_pool;
+	
+	public:
+		typedef T value_type;
+		typedef T *pointer;
+		typedef const T *const_pointer;
+		typedef T &reference;
+		typedef const T &const_reference;
+		typedef size_t size_type;
+		typedef ptrdiff_t difference_type;
+		
+		template <typename U>
+		struct rebind
+		{
+			typedef PoolAlloc<U> other;
+		};
+		
+		static const size_t DEFAULT_SLAB = 64 * 1024;
+		
+		// Constructor
+		explicit PoolAlloc(size_t slabBytes = DEFAULT_SLAB) : _pool(new Pool(slabBytes))
+		{
+		}
+		
+		// Copy constructor
+		PoolAlloc(const PoolAlloc &other) : _pool(other._pool)
+		{
+			_pool->retain();
+		}
+		
+		// Same pool for another type (the list's node type)
+		template <typename U>
+		PoolAlloc(const PoolAlloc<U> &other) : _pool(other._pool)
+		{
+			_pool->retain();
+		}
+		
+		// Assignment operator
+		PoolAlloc &operator=(const PoolAlloc &other)
+		{
+			if (_pool != other._pool)
+			{
+				other._pool->retain();
+				if (_pool->release())
+					delete _pool;
+				_pool = other._pool;
+			}
+			return *this;
+		}
+		
+		// Destructor
+		~PoolAlloc(void)
+		{
+			if (_pool->release())
+				delete _pool;
+		}
+		
+		pointer address(reference x) const
+		{
+			return &x;
+		}
+		
+		const_pointer address(const_reference x) const
+		{
+			return &x;
+		}
+		
+		pointer allocate(size_type n, const void * = 0)
+		{
+			if (n > max_size())
+				throw std::bad_alloc();
+			return static_cast<pointer>(_pool->allocate(n * sizeof(T)));
+		}
+		
+		void deallocate(pointer p, size_type n)
+		{
+			_pool->deallocate(p, n * sizeof(T));
+		}
+		
+		size_type max_size(void) const
+		{
+			return static_cast<size_type>(-1) / sizeof(T);
+		}
+		
+		void construct(pointer p, const T &value)
+		{
+			new (static_cast<void *>(p)) T(value);
+		}
+		
+		void destroy(pointer p)
+		{
+			p->~T();
+		}
+		
+		size_t slabCount(void) const
+		{
+			return _pool->slabCount();
+		}
+		
+		// See Pool::reset; every container using the pool must be empty
+		void reset(void)
+		{
+			_pool->reset();
+		}
+		
+		// Scoped reset: the pool goes back to where it was when the frame
+		// was made once the frame goes, so containers built inside the
+		// frame must go first. Frames nest
+		class Frame
+		{
+			private:
+				PoolAlloc _alloc;
+				Pool::Mark _mark;
+				
+				Frame(const Frame &other);
+				Frame &operator=(const Frame &other);
+			
+			public:
+				explicit Frame(const PoolAlloc &alloc) : _alloc(alloc), _mark(alloc._pool->mark())
+				{
+				}
+				
+				~Frame(void)
+				{
+					_alloc._pool->rewind(_mark);
+				}
+		};
+		
+		template <typename U>
+		bool operator==(const PoolAlloc<U> &other) const
+		{
+			return _pool == other._pool;
+		}
+		
+		template <typename U>
+		bool operator!=(const PoolAlloc<U> &other) const
+		{
+			return _pool != other._pool;
+		}
+};
+
+#endif
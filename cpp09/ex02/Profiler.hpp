@@ -0,0 +1,131 @@
+#ifndef PROFILER_HPP
+#define PROFILER_HPP
+
+#include <ostream>
+#include "ProfilerPoints.hpp"
+
+// Per-phase tick totals and event counters for the hot paths, and the
+// CPU's own counters for the whole run where Linux makes them available.
+// The phases and events are the ones ProfilerPoints.hpp lists for this
+// program. Each thread adds into totals of its own, with relaxed atomic
+// stores that compile to plain ones, and reading sums the totals of every
+// thread, so the threads of a pool are profiled without a lock and
+// without sharing a cache line. The PROFILE_* macros below compile to
+// nothing unless PROFILER_ENABLED is defined (see the profile target in
+// the Makefile). The same header is copied into each exercise that uses
+// it, next to a ProfilerPoints.hpp of its own
+class Profiler
+{
+	public:
+#define PROFILER_ENUM_PHASE(name, label) PHASE_##name,
+#define PROFILER_ENUM_EVENT(name, label) EVENT_##name,
+		enum Phase
+		{
+			PROFILER_PHASES(PROFILER_ENUM_PHASE)
+			PHASE_COUNT
+		};
+		
+		enum Event
+		{
+			PROFILER_EVENTS(PROFILER_ENUM_EVENT)
+			EVENT_COUNT
+		};
+#undef PROFILER_ENUM_PHASE
+#undef PROFILER_ENUM_EVENT
+
+		// Hardware counters, through perf_event_open, of this process in
+		// user space only: the kernel lets a process count itself at the
+		// default perf_event_paranoid level
+		enum Counter
+		{
+			COUNTER_CYCLES,
+			COUNTER_INSTRUCTIONS,
+			COUNTER_CACHE_MISSES,
+			COUNTER_BRANCH_MISSES,
+			COUNTER_COUNT
+		};
+		
+		// Times the enclosing block into one phase
+		class Scope
+		{
+			private:
+				Phase _phase;
+				unsigned long long _start;
+				
+				Scope(const Scope &other);
+				Scope &operator=(const Scope &other);
+				
+			public:
+				explicit Scope(Phase phase);
+				~Scope(void);
+		};
+		
+	private:
+		// The totals of one thread, kept after it exits
+		struct Totals
+		{
+			unsigned long long ticks[PHASE_COUNT];
+			unsigned long long calls[PHASE_COUNT];
+			unsigned long long events[EVENT_COUNT];
+			Totals *next;
+		};
+		
+		static Totals *volatile _threads;		// every thread's totals, newest first
+		static int _counters[COUNTER_COUNT];	// descriptors, -1 when not open
+		
+		static Totals &_mine(void);
+		static void _createKey(void);
+		static void _reportAtExit(void);
+		template <int N>
+		static unsigned long long _sum(unsigned long long (Totals::*field)[N], int index);
+		
+		// Private constructor to prevent instantiation
+		Profiler(void);
+		Profiler(const Profiler &other);
+		Profiler &operator=(const Profiler &other);
+		~Profiler(void);
+		
+	public:
+		// CPU timestamp counter where there is one, clock() ticks otherwise
+		static unsigned long long now(void);
+		
+		static void add(Phase phase, unsigned long long ticks);
+		static void count(Event event, unsigned long long amount = 1);
+		
+		// Totals over every thread so far
+		static unsigned long long ticks(Phase phase);
+		static unsigned long long calls(Phase phase);
+		static unsigned long long events(Event event);
+		
+		// Start counting from now; a counter the system does not have (no
+		// PMU in a VM, perf events disabled) stays closed. True when at
+		// least one counter runs
+		static bool startCounters(void);
+		// The value of a counter so far, false when it is not running
+		static bool readCounter(Counter counter, unsigned long long &value);
+		static void stopCounters(void);
+		
+		// For main: starts the hardware counters when the environment has
+		// PROFILE_COUNTERS set, so a profile binary runs with or without
+		// them, and reports to standard error at exit
+		static void startProgram(void);
+		
+		// One line per phase, per event and per running counter
+		static void report(std::ostream &out);
+		// Zero the totals; no thread may be profiling meanwhile
+		static void reset(void);
+};
+
+#ifdef PROFILER_ENABLED
+# define PROFILE_SCOPE(phase) Profiler::Scope profileScope_(Profiler::phase)
+# define PROFILE_EVENT(event) Profiler::count(Profiler::event)
+# define PROFILE_COUNT(event, amount) Profiler::count(Profiler::event, amount)
+# define PROFILE_PROGRAM() Profiler::startProgram()
+#else
+# define PROFILE_SCOPE(phase) ((void)0)
+# define PROFILE_EVENT(event) ((void)0)
+# define PROFILE_COUNT(event, amount) ((void)0)
+# define PROFILE_PROGRAM() ((void)0)
+#endif
+
+#endif
@@ -0,0 +1,14 @@
+#ifndef PROFILERPOINTS_HPP
+#define PROFILERPOINTS_HPP
+
+// The phases and events PmergeMe profiles, as X(NAME, "label") entries
+// that become Profiler::PHASE_NAME and Profiler::EVENT_NAME
+#define PROFILER_PHASES(X) \
+	X(SORT_VECTOR, "sort vector") \
+	X(SORT_LIST, "sort list")
+
+#define PROFILER_EVENTS(X) \
+	X(VECTOR_ELEMENTS, "vector elements") \
+	X(LIST_ELEMENTS, "list elements")
+
+#endif
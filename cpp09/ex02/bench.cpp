@@ -0,0 +1,308 @@
+#include "PmergeMe.hpp"
+#include <iomanip>
+#include <cstdlib>
+#include <new>
+#include <algorithm>
+#include <cstring>
+#include <time.h>
+
+// Benchmark harness for PmergeMe: times every container backend over
+// several input distributions with warm-up runs and repeated trials, and
+// reports min/median/p99 wall time with comparison and allocation counts
+
+static unsigned long g_allocations = 0;
+
+// GCC 11 and later take the malloc in operator new and the free in
+// operator delete below for a mismatched pair once they are inlined
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+// Every allocation in the process goes through here, so the count
+// covers the containers and the engine's own buffers
+void *operator new(size_t size) throw(std::bad_alloc)
+{
+	g_allocations++;
+	void *p = std::malloc(size ? size : 1);
+	if (!p)
+		throw std::bad_alloc();
+	return p;
+}
+
+void *operator new[](size_t size) throw(std::bad_alloc)
+{
+	return operator new(size);
+}
+
+void operator delete(void *p) throw()
+{
+	std::free(p);
+}
+
+void operator delete[](void *p) throw()
+{
+	operator delete(p);
+}
+
+static unsigned int g_seed = 42;
+
+static unsigned int nextRandom(void)
+{
+	g_seed = g_seed * 1103515245u + 12345u;
+	return (g_seed >> 1) & 0x7fffffff;
+}
+
+// Monotonic wall clock in microseconds
+static double nowUs(void)
+{
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec * 1000000.0 + ts.tv_nsec / 1000.0;
+}
+
+enum Distribution
+{
+	DIST_RANDOM,
+	DIST_SORTED,
+	DIST_REVERSED,
+	DIST_FEW_UNIQUE,
+	DIST_COUNT
+};
+
+static const char *distributionName(Distribution dist)
+{
+	static const char *names[DIST_COUNT] = { "random", "sorted", "reversed", "few-unique" };
+	return names[dist];
+}
+
+static void generate(Distribution dist, size_t n, std::vector<int> &out)
+{
+	out.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		if (dist == DIST_RANDOM)
+			out[i] = 1 + static_cast<int>(nextRandom() % 2000000000u);
+		else if (dist == DIST_SORTED)
+			out[i] = static_cast<int>(i + 1);
+		else if (dist == DIST_REVERSED)
+			out[i] = static_cast<int>(n - i);
+		else
+			out[i] = 1 + static_cast<int>(nextRandom() % 16);
+	}
+}
+
+struct Sample
+{
+	double us;
+	unsigned long comparisons;
+	unsigned long allocations;
+};
+
+// Value at quantile q of sorted samples (nearest rank)
+static double quantile(const std::vector<double> &sorted, double q)
+{
+	size_t rank = static_cast<size_t>(q * (sorted.size() - 1) + 0.5);
+	return sorted[rank];
+}
+
+static Sample runVector(const std::vector<int> &input)
+{
+	std::vector<int> data(input);
+	PmergeMe pm;
+	pm.setCountComparisons(true);
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	pm.sortVector(data);
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = pm.getComparisonCount();
+	return s;
+}
+
+static Sample runList(const std::vector<int> &input)
+{
+	std::list<int> data(input.begin(), input.end());
+	PmergeMe pm;
+	pm.setCountComparisons(true);
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	pm.sortList(data);
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = pm.getComparisonCount();
+	return s;
+}
+
+// Same list sort with the nodes taken from a slab pool
+static Sample runPoolList(const std::vector<int> &input)
+{
+	PmergeMe::PoolList data(input.begin(), input.end());
+	PmergeMe pm;
+	pm.setCountComparisons(true);
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	pm.sortList(data);
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = pm.getComparisonCount();
+	return s;
+}
+
+static Sample runDeque(const std::vector<int> &input)
+{
+	std::deque<int> data(input.begin(), input.end());
+	PmergeMe pm;
+	pm.setCountComparisons(true);
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	pm.sortDeque(data);
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = pm.getComparisonCount();
+	return s;
+}
+
+// Same vector sort with the counting/radix fast path on
+static Sample runAdaptive(const std::vector<int> &input)
+{
+	std::vector<int> data(input);
+	PmergeMe pm;
+	pm.setCountComparisons(true);
+	pm.setAdaptive(true);
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	pm.sortVector(data);
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = pm.getComparisonCount();
+	return s;
+}
+
+// Same vector sort with the run pre-pass on
+static Sample runDetected(const std::vector<int> &input)
+{
+	std::vector<int> data(input);
+	PmergeMe pm;
+	pm.setCountComparisons(true);
+	pm.setRunDetection(true);
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	pm.sortVector(data);
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = pm.getComparisonCount();
+	return s;
+}
+
+// A plain int buffer, as a raw arena or cpp07's Array<int> would hold it
+static Sample runBuffer(const std::vector<int> &input)
+{
+	int *data = new int[input.size()];
+	std::copy(input.begin(), input.end(), data);
+	PmergeMe pm;
+	pm.setCountComparisons(true);
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	pm.sortRange(data, data + input.size());
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = pm.getComparisonCount();
+	delete[] data;
+	return s;
+}
+
+// 100-byte records keyed by the input values
+struct Record
+{
+	int key;
+	char payload[96];
+};
+
+struct RecordLess
+{
+	bool operator()(const Record &a, const Record &b) const
+	{
+		return a.key < b.key;
+	}
+};
+
+// Stable record sort: the engine orders 4-byte indices, then every
+// record moves once
+static Sample runRecords(const std::vector<int> &input)
+{
+	std::vector<Record> data(input.size());
+	for (size_t i = 0; i < input.size(); i++)
+	{
+		data[i].key = input[i];
+		std::memset(data[i].payload, static_cast<int>(i & 0xff), sizeof(data[i].payload));
+	}
+	MergeInsertion<Record, RecordLess> engine;
+	unsigned long allocations = g_allocations;
+	double start = nowUs();
+	engine.sortStable(data);
+	Sample s;
+	s.us = nowUs() - start;
+	s.allocations = g_allocations - allocations;
+	s.comparisons = engine.getComparisonCount();
+	return s;
+}
+
+static void report(const std::string &label, Sample (*run)(const std::vector<int> &),
+	const std::vector<int> &input, size_t warmups, size_t trials)
+{
+	for (size_t i = 0; i < warmups; i++)
+		run(input);
+	
+	std::vector<double> times;
+	Sample last;
+	for (size_t i = 0; i < trials; i++)
+	{
+		last = run(input);
+		times.push_back(last.us);
+	}
+	std::sort(times.begin(), times.end());
+	
+	std::cout << std::left << std::setw(22) << label << std::right << std::fixed << std::setprecision(1)
+	          << " min " << std::setw(10) << times.front()
+	          << " med " << std::setw(10) << quantile(times, 0.5)
+	          << " p99 " << std::setw(10) << quantile(times, 0.99) << " us"
+	          << std::setw(12) << last.comparisons << " cmp"
+	          << std::setw(8) << last.allocations << " allocs" << std::endl;
+}
+
+int main(int argc, char **argv)
+{
+	size_t n = argc > 1 ? std::strtoul(argv[1], NULL, 10) : 3000;
+	size_t trials = argc > 2 ? std::strtoul(argv[2], NULL, 10) : 20;
+	if (n == 0 || trials == 0)
+	{
+		std::cerr << "Usage: " << argv[0] << " [elements] [trials]" << std::endl;
+		return 1;
+	}
+	
+	std::cout << n << " elements, 2 warm-ups and " << trials << " trials per row; "
+	          << PmergeMe::maxComparisons(n) << " cmp worst case, "
+	          << PmergeMe::minComparisons(n) << " lower bound" << std::endl;
+	std::vector<int> input;
+	for (int d = 0; d < DIST_COUNT; d++)
+	{
+		Distribution dist = static_cast<Distribution>(d);
+		generate(dist, n, input);
+		report(std::string("vector ") + distributionName(dist), runVector, input, 2, trials);
+		report(std::string("list ") + distributionName(dist), runList, input, 2, trials);
+		report(std::string("pool list ") + distributionName(dist), runPoolList, input, 2, trials);
+		report(std::string("deque ") + distributionName(dist), runDeque, input, 2, trials);
+		report(std::string("int[] ") + distributionName(dist), runBuffer, input, 2, trials);
+		report(std::string("adaptive ") + distributionName(dist), runAdaptive, input, 2, trials);
+		report(std::string("runs ") + distributionName(dist), runDetected, input, 2, trials);
+		report(std::string("records ") + distributionName(dist), runRecords, input, 2, trials);
+	}
+	return 0;
+}
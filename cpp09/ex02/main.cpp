@@ -1,44 +1,131 @@
 #include "PmergeMe.hpp"
+#include "ExternalSort.hpp"
+#include "Profiler.hpp"
 #include <cstdlib>
+#include <cstring>
+#include <fstream>
 #include <sstream>
 #include <iomanip>
 
+// Read all of in into buffer in large blocks
+static void readAll(std::istream &in, std::vector<char> &buffer)
+{
+	std::streambuf *sb = in.rdbuf();
+	size_t filled = 0;
+	buffer.resize(1 << 16);
+	for (;;)
+	{
+		if (filled == buffer.size())
+			buffer.resize(buffer.size() * 2);
+		std::streamsize got = sb->sgetn(&buffer[filled], buffer.size() - filled);
+		if (got <= 0)
+			break;
+		filled += static_cast<size_t>(got);
+	}
+	buffer.resize(filled);
+}
+
+// Numbers come from the arguments, from a file ("-f file") or from standard input ("-")
+static bool readInput(int argc, char **argv, std::vector<int> &numbers)
+{
+	if (argc == 2 && std::strcmp(argv[1], "-") == 0)
+	{
+		std::vector<char> buffer;
+		readAll(std::cin, buffer);
+		return !buffer.empty() && PmergeMe::parseNumbers(&buffer[0], &buffer[0] + buffer.size(), numbers);
+	}
+	if (argc == 3 && std::strcmp(argv[1], "-f") == 0)
+	{
+		std::ifstream file(argv[2], std::ios::in | std::ios::binary);
+		if (!file.is_open())
+			return false;
+		std::vector<char> buffer;
+		readAll(file, buffer);
+		return !buffer.empty() && PmergeMe::parseNumbers(&buffer[0], &buffer[0] + buffer.size(), numbers);
+	}
+	
+	numbers.reserve(argc - 1);
+	for (int i = 1; i < argc; i++)
+	{
+		size_t before = numbers.size();
+		if (!PmergeMe::parseNumbers(argv[i], argv[i] + std::strlen(argv[i]), numbers) || numbers.size() == before)
+			return false;
+	}
+	return true;
+}
+
+// "-x input output [chunk]": external sort of a file too large for memory
+static int externalSort(int argc, char **argv)
+{
+	size_t chunk = argc > 4 ? std::strtoul(argv[4], NULL, 10) : 1 << 22;
+	std::ifstream in(argv[2], std::ios::in | std::ios::binary);
+	std::ofstream out(argv[3], std::ios::out | std::ios::binary | std::ios::trunc);
+	if (!in.is_open() || !out.is_open() || chunk == 0)
+	{
+		std::cerr << "Error" << std::endl;
+		return 1;
+	}
+	ExternalSort sorter(chunk, std::string(argv[3]) + ".run");
+	if (!sorter.sort(in, out))
+	{
+		std::cerr << "Error" << std::endl;
+		return 1;
+	}
+	return 0;
+}
+
+// Values shown by each line in preview mode ("-p ...")
+static const size_t PREVIEW = 5;
+
 int main(int argc, char **argv)
 {
+	PROFILE_PROGRAM();
+	
+	// Flags in front of any input form: "-p" prints only the start of each
+	// sequence, "-a" lets both sorts switch to counting or radix sort, "-r"
+	// turns on run detection
+	size_t limit = 0;
+	bool adaptive = false;
+	bool runs = false;
+	while (argc > 2 && (std::strcmp(argv[1], "-p") == 0 || std::strcmp(argv[1], "-a") == 0
+		|| std::strcmp(argv[1], "-r") == 0))
+	{
+		if (argv[1][1] == 'p')
+			limit = PREVIEW;
+		else if (argv[1][1] == 'a')
+			adaptive = true;
+		else
+			runs = true;
+		argv++;
+		argc--;
+	}
 	if (argc < 2)
 	{
 		std::cerr << "Error" << std::endl;
 		return 1;
 	}
+	if ((argc == 4 || argc == 5) && std::strcmp(argv[1], "-x") == 0)
+		return externalSort(argc, argv);
 	
+	// Parse every number once, then fill the list from the vector; its
+	// nodes come from a pool so the list timing is not mostly malloc
 	std::vector<int> vecData;
-	std::list<int> listData;
-	
-	// Parse arguments as integers
-	for (int i = 1; i < argc; i++)
+	if (!readInput(argc, argv, vecData) || vecData.empty())
 	{
-		int num = std::atoi(argv[i]);
-		
-		// Check if conversion was successful and value is positive
-		if (num <= 0 || (num == 0 && argv[i][0] != '0'))
-		{
-			std::cerr << "Error" << std::endl;
-			return 1;
-		}
-		
-		vecData.push_back(num);
-		listData.push_back(num);
+		std::cerr << "Error" << std::endl;
+		return 1;
 	}
+	PmergeMe::PoolList listData(vecData.begin(), vecData.end());
+	std::deque<int> dequeData(vecData.begin(), vecData.end());
 	
 	// Display unsorted
-	PmergeMe::displayVector(vecData, "Before: ");
-	
-	// Create copy for list display
-	std::list<int> listDataCopy(listData.begin(), listData.end());
+	PmergeMe::displayVector(vecData, "Before: ", limit);
 	
 	// Measure time and sort vector
 	clock_t startVec = clock();
 	PmergeMe pmVec;
+	pmVec.setAdaptive(adaptive);
+	pmVec.setRunDetection(runs);
 	pmVec.sortVector(vecData);
 	clock_t endVec = clock();
 	double timeVec = (double)(endVec - startVec) / CLOCKS_PER_SEC * 1000000; // microseconds
@@ -46,18 +133,31 @@ int main(int argc, char **argv)
 	// Measure time and sort list
 	clock_t startList = clock();
 	PmergeMe pmList;
+	pmList.setAdaptive(adaptive);
+	pmList.setRunDetection(runs);
 	pmList.sortList(listData);
 	clock_t endList = clock();
 	double timeList = (double)(endList - startList) / CLOCKS_PER_SEC * 1000000; // microseconds
 	
+	// Measure time and sort deque
+	clock_t startDeque = clock();
+	PmergeMe pmDeque;
+	pmDeque.setAdaptive(adaptive);
+	pmDeque.setRunDetection(runs);
+	pmDeque.sortDeque(dequeData);
+	clock_t endDeque = clock();
+	double timeDeque = (double)(endDeque - startDeque) / CLOCKS_PER_SEC * 1000000; // microseconds
+	
 	// Display sorted (after vector sort)
-	PmergeMe::displayVector(vecData, "After:\n");
+	PmergeMe::displayVector(vecData, "After:\n", limit);
 	
 	// Display timing information
 	std::cout << "Time to process a range of " << vecData.size() << " elements with std::vector : " 
 	          << std::fixed << std::setprecision(5) << timeVec << " us" << std::endl;
 	std::cout << "Time to process a range of " << listData.size() << " elements with std::list : " 
 	          << std::fixed << std::setprecision(5) << timeList << " us" << std::endl;
+	std::cout << "Time to process a range of " << dequeData.size() << " elements with std::deque : " 
+	          << std::fixed << std::setprecision(5) << timeDeque << " us" << std::endl;
 	
 	return 0;
 }